@@ -0,0 +1,127 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/AsyncFileService.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::IO;
+
+    struct PhaseResult
+    {
+        double seconds = 0.0;
+        Drama::Bench::LatencySummary latency{};
+        size_t peakQueued = 0;
+        size_t peakInFlightBytes = 0;
+        uint64_t failed = 0;
+    };
+
+    /// @brief 全ファイルを1バッチで投げ、完了を待つ
+    PhaseResult RunPhase(AsyncFileService& io, IoOp op, const std::vector<std::string>& paths, size_t fileSize)
+    {
+        using namespace Drama;
+
+        std::vector<uint64_t> latencies;
+        latencies.reserve(paths.size());
+        uint64_t failed = 0;
+
+        std::vector<IoRequest> batch;
+        batch.reserve(paths.size());
+        for (const std::string& p : paths)
+        {
+            IoRequest r{};
+            r.op = op;
+            r.path = p;
+            r.sizeHint = fileSize;
+            if (op != IoOp::Read)
+            {
+                r.data.assign(fileSize, 0x5A);
+            }
+            r.onComplete = [&latencies, &failed](IoCompletion& c)
+                {
+                    latencies.push_back(c.endNs - c.submitNs);
+                    failed += (c.status == IoStatus::Completed) ? 0 : 1;
+                };
+            batch.push_back(std::move(r));
+        }
+
+        const AsyncFileStats before = io.Stats();
+        const auto begin = Bench::Clock::now();
+        io.SubmitBatch(std::move(batch));
+        io.WaitIdle();
+        const auto end = Bench::Clock::now();
+        io.DispatchCompletions();
+        const AsyncFileStats after = io.Stats();
+
+        PhaseResult result{};
+        result.seconds = static_cast<double>(Bench::ElapsedNs(begin, end)) * 1e-9;
+        result.latency = Bench::Summarize(latencies);
+        result.peakQueued = std::max(before.peakQueued, after.peakQueued);
+        result.peakInFlightBytes = after.peakInFlightBytes;
+        result.failed = failed;
+        return result;
+    }
+
+    void Print(const char* name, uint32_t workers, size_t files, size_t fileSize, const PhaseResult& r)
+    {
+        const double mb = static_cast<double>(files * fileSize) / (1024.0 * 1024.0);
+        std::printf("%-6s workers=%u  %9.1f MB/s %9.0f req/s  lat p50=%9.1fus p99=%9.1fus  peakQueue=%zu peakInFlight=%zuKB failed=%llu\n",
+            name, workers, mb / r.seconds, static_cast<double>(files) / r.seconds,
+            r.latency.p50 * 1e-3, r.latency.p99 * 1e-3, r.peakQueued, r.peakInFlightBytes / 1024,
+            static_cast<unsigned long long>(r.failed));
+    }
+}
+
+namespace Drama::Bench
+{
+    // AsyncFileService の書き込み・読み込みを I/Oスレッド数ごとに比べる。
+    // 引数: --files=ファイル数(既定256) --size=1ファイルのバイト数(既定256KB)
+    //       --cap=実行中バイト上限(既定64MB) --maxworkers=最大スレッド数(既定8)
+    int RunAsyncFileServiceBench(Args args)
+    {
+        const size_t files = static_cast<size_t>(ArgU64(args, "files", 256));
+        const size_t fileSize = static_cast<size_t>(ArgU64(args, "size", 256 * 1024));
+        const size_t cap = static_cast<size_t>(ArgU64(args, "cap", 64ull * 1024 * 1024));
+        const uint32_t maxWorkers = static_cast<uint32_t>(ArgU64(args, "maxworkers", 8));
+
+        const std::string dir = TempDirectory() + "asyncio/";
+        FileSystem().CreateDirectories(dir);
+        std::vector<std::string> paths;
+        paths.reserve(files);
+        for (size_t i = 0; i < files; ++i)
+        {
+            paths.push_back(dir + "file_" + std::to_string(i) + ".bin");
+        }
+
+        int result = 0;
+        for (uint32_t workers = 1; workers <= maxWorkers; workers *= 2)
+        {
+            AsyncFileDesc desc{};
+            desc.workerCount = workers;
+            desc.maxInFlightBytes = cap;
+            AsyncFileService io;
+            if (!io.Start(FileSystem(), desc))
+            {
+                return 1;
+            }
+
+            const PhaseResult w = RunPhase(io, IoOp::Write, paths, fileSize);
+            const PhaseResult r = RunPhase(io, IoOp::Read, paths, fileSize);
+            io.Stop();
+
+            Print("write", workers, files, fileSize, w);
+            Print("read", workers, files, fileSize, r);
+            if (w.failed != 0 || r.failed != 0)
+            {
+                result = 1;
+            }
+        }
+        return result;
+    }
+}
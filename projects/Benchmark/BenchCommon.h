@@ -0,0 +1,104 @@
+#pragma once
+// C++ standard library includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Core/include/IFileSystem.h"
+#include "Core/include/IFileWatcher.h"
+
+namespace Drama::Bench
+{
+    using Args = std::span<const std::string_view>;
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief 計測値の要約(ナノ秒)
+    struct LatencySummary
+    {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+    };
+
+    /// @brief サンプル列を要約する(samplesは並べ替えられる)
+    inline LatencySummary Summarize(std::vector<uint64_t>& samples)
+    {
+        LatencySummary s{};
+        if (samples.empty())
+        {
+            return s;
+        }
+        std::sort(samples.begin(), samples.end());
+        const auto at = [&samples](double p)
+            {
+                const size_t i = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+                return static_cast<double>(samples[i]);
+            };
+        s.p50 = at(0.50);
+        s.p99 = at(0.99);
+        s.max = static_cast<double>(samples.back());
+        double sum = 0.0;
+        for (uint64_t v : samples)
+        {
+            sum += static_cast<double>(v);
+        }
+        s.mean = sum / static_cast<double>(samples.size());
+        return s;
+    }
+
+    /// @brief 2時点間のナノ秒
+    inline uint64_t ElapsedNs(Clock::time_point begin, Clock::time_point end) noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+    }
+
+    /// @brief "--key=value" 形式の数値引数を取り出す
+    inline uint64_t ArgU64(Args args, std::string_view key, uint64_t fallback)
+    {
+        for (std::string_view a : args)
+        {
+            if (a.size() > key.size() + 3 && a.substr(0, 2) == "--" &&
+                a.substr(2, key.size()) == key && a[key.size() + 2] == '=')
+            {
+                return std::strtoull(std::string(a.substr(key.size() + 3)).c_str(), nullptr, 10);
+            }
+        }
+        return fallback;
+    }
+
+    /// @brief ベンチ用のファイルシステム(プラットフォームごとの実装)
+    Core::IO::IFileSystem& FileSystem();
+    /// @brief プラットフォームごとのファイル監視を作る
+    std::unique_ptr<Core::IO::IFileWatcher> CreateFileWatcher(const Core::IO::FileWatchDesc& desc);
+    /// @brief ベンチが一時ファイルを置くディレクトリ(末尾'/'付き)
+    std::string TempDirectory();
+
+    // 各ベンチマーク。成功なら0を返す。
+    int RunLogAssertBench(Args args);
+    int RunMappedFileBench(Args args);
+    int RunAsyncFileServiceBench(Args args);
+    int RunPackBench(Args args);
+    int RunCompressionBench(Args args);
+    int RunFileWatcherBench(Args args);
+    int RunJobSystemBench(Args args);
+    int RunFiberBench(Args args);
+    int RunFramePipelineBench(Args args);
+    int RunFrameClockBench(Args args);
+    int RunClockBench(Args args);
+    int RunProfilerBench(Args args);
+    int RunFrameAllocatorBench(Args args);
+    int RunHandlePoolBench(Args args);
+    int RunMemoryTrackerBench(Args args);
+    int RunEcsBench(Args args);
+    int RunMathBench(Args args);
+    int RunTransformHierarchyBench(Args args);
+    int RunFrustumCullingBench(Args args);
+    int RunDynamicBvhBench(Args args);
+}
@@ -0,0 +1,94 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Platform/include/Timer.h"
+#include "Platform/include/TscClock.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using Drama::Platform::SteadyClock;
+    using Drama::Platform::TscClock;
+
+    volatile uint64_t g_Sink = 0;
+
+    /// @brief fn を calls 回呼び、1回あたりの ns を返す(reps 回計って最小値)
+    template <class F>
+    double PerCall(uint64_t calls, uint32_t reps, F&& fn)
+    {
+        double best = 1e300;
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            uint64_t acc = 0;
+            const auto s = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i)
+            {
+                acc += fn();
+            }
+            const double ns = static_cast<double>(ElapsedNs(s, Clock::now())) / static_cast<double>(calls);
+            g_Sink = g_Sink + acc;
+            best = std::min(best, ns);
+        }
+        return best;
+    }
+}
+
+namespace Drama::Bench
+{
+    // 時刻取得1回あたりの費用。steady_clock / TscClock の生カウント / 変換込み / タイマーの Start+Stop を比べる。
+    // 引数: --calls=各計測の呼び出し回数(既定5000000) --reps=繰り返し(既定5)
+    int RunClockBench(Args args)
+    {
+        const uint64_t calls = std::max<uint64_t>(1, ArgU64(args, "calls", 5000000));
+        const uint32_t reps = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "reps", 5)));
+
+        const TscClock::Calibration& c = TscClock::Params();
+        std::printf("TscClock: %s  %.3f GHz\n", c.useTsc ? "invariant TSC" : "steady_clock fallback", c.ticksPerSecond * 1e-9);
+
+        std::printf("steady_clock::now()        %6.2f ns/call\n",
+            PerCall(calls, reps, []() { return static_cast<uint64_t>(SteadyClock::now().time_since_epoch().count()); }));
+        std::printf("TscClock::Ticks()          %6.2f ns/call\n",
+            PerCall(calls, reps, []() { return TscClock::Ticks(); }));
+        std::printf("TscClock::TicksOrdered()   %6.2f ns/call\n",
+            PerCall(calls, reps, []() { return TscClock::TicksOrdered(); }));
+        std::printf("TscClock::now()            %6.2f ns/call\n",
+            PerCall(calls, reps, []() { return static_cast<uint64_t>(TscClock::now().time_since_epoch().count()); }));
+        std::printf("Timer Start+Stop           %6.2f ns/pair\n",
+            PerCall(calls, reps, []()
+                {
+                    Platform::Timer t;
+                    t.Start();
+                    t.Stop();
+                    return static_cast<uint64_t>(t.IsRunning());
+                }));
+        std::printf("TscTimer Start+Stop        %6.2f ns/pair\n",
+            PerCall(calls, reps, []()
+                {
+                    Platform::TscTimer t;
+                    t.Start();
+                    t.Stop();
+                    return static_cast<uint64_t>(t.IsRunning());
+                }));
+
+        // 生カウントを貯めてから後でまとめて変換する場合の、変換1回の費用
+        std::vector<uint64_t> ticks(1 << 16);
+        for (uint64_t& t : ticks)
+        {
+            t = TscClock::Ticks();
+        }
+        size_t index = 0;
+        std::printf("TicksToNanoseconds (batch) %6.2f ns/value\n",
+            PerCall(calls, reps, [&]()
+                {
+                    index = (index + 1) & (ticks.size() - 1);
+                    return static_cast<uint64_t>(TscClock::TicksToNanoseconds(ticks[index]));
+                }));
+        return 0;
+    }
+}
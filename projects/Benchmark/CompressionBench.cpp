@@ -0,0 +1,228 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/CompressedBlob.h"
+#include "Core/include/CompressedFileSystem.h"
+#include "Core/include/JobSystem.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace Drama;
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+
+    /// @brief ログ風のテキスト
+    std::vector<uint8_t> MakeText(size_t size)
+    {
+        std::vector<uint8_t> data;
+        data.reserve(size + 128);
+        uint32_t x = 12345;
+        char line[128];
+        for (uint32_t frame = 0; data.size() < size; ++frame)
+        {
+            x = x * 1664525u + 1013904223u;
+            const int n = std::snprintf(line, sizeof(line), "[%08u] INFO  Render: drew %u batches, %u triangles (%u.%02u ms)\n",
+                frame, 100 + (x >> 28), 20000 + ((x >> 12) & 0xFFF), 4 + (x >> 30), (x >> 4) & 63);
+            data.insert(data.end(), line, line + n);
+        }
+        data.resize(size);
+        return data;
+    }
+
+    /// @brief 頂点データ風のバイナリ(少しずつ変わる float の並び)
+    std::vector<uint8_t> MakeVertices(size_t size)
+    {
+        std::vector<uint8_t> data(size);
+        uint32_t x = 777;
+        const size_t count = size / sizeof(float);
+        for (size_t i = 0; i < count; ++i)
+        {
+            x = x * 1664525u + 1013904223u;
+            const float v = static_cast<float>(i % 4096) * 0.25f + ((i % 8 == 7) ? static_cast<float>(x >> 28) : 0.0f);
+            std::memcpy(data.data() + i * sizeof(float), &v, sizeof(float));
+        }
+        return data;
+    }
+
+    std::vector<uint8_t> MakeRandom(size_t size)
+    {
+        std::vector<uint8_t> data(size);
+        uint32_t x = 99;
+        for (uint8_t& b : data)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            b = static_cast<uint8_t>(x);
+        }
+        return data;
+    }
+
+    double GBps(uint64_t bytes, uint64_t ns)
+    {
+        return static_cast<double>(bytes) / static_cast<double>(ns);
+    }
+
+    /// @brief 1種類のデータについて圧縮率・圧縮速度・スレッド数ごとの展開速度を出す
+    bool RunDataset(const char* name, const std::vector<uint8_t>& raw, uint32_t blockSize, uint32_t maxThreads)
+    {
+        std::vector<uint8_t> blob;
+        auto s = Clock::now();
+        Core::IO::Blob::Encode(raw, blockSize, nullptr, blob);
+        const uint64_t encodeNs = ElapsedNs(s, Clock::now());
+
+        Core::IO::Blob::BlobIndex index;
+        if (!Core::IO::Blob::ReadIndex(blob, index))
+        {
+            std::printf("%s: failed to read index\n", name);
+            return false;
+        }
+        std::printf("%-8s raw=%6.1fMB  stored=%6.1fMB  ratio=%5.2fx  blocks=%zu  compress(1T)=%6.2f GB/s\n",
+            name, static_cast<double>(raw.size()) / (1024.0 * 1024.0), static_cast<double>(blob.size()) / (1024.0 * 1024.0),
+            static_cast<double>(raw.size()) / static_cast<double>(blob.size()), index.blocks.size(), GBps(raw.size(), encodeNs));
+
+        std::vector<uint8_t> out(raw.size());
+        uint64_t singleNs = 0;
+        for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            // ワーカーの起動は計らない
+            Core::Job::JobSystem jobs;
+            Core::Job::JobSystemDesc jobDesc;
+            jobDesc.threadCount = threads;
+            if (threads > 1 && !jobs.Start(jobDesc))
+            {
+                std::printf("%s: failed to start jobs\n", name);
+                return false;
+            }
+
+            // 3回の最良値(初回はページフォールトが乗るので捨てる)
+            uint64_t best = UINT64_MAX;
+            for (int rep = 0; rep < 4; ++rep)
+            {
+                s = Clock::now();
+                const bool ok = Core::IO::Blob::Decode(blob, index, out.data(), (threads > 1) ? &jobs : nullptr);
+                const uint64_t ns = ElapsedNs(s, Clock::now());
+                if (!ok)
+                {
+                    std::printf("%s: decode failed\n", name);
+                    return false;
+                }
+                if (rep > 0)
+                {
+                    best = std::min(best, ns);
+                }
+            }
+            if (threads == 1)
+            {
+                singleNs = best;
+            }
+            std::printf("  decode threads=%-2u %7.2f GB/s  speedup=%4.2fx\n",
+                threads, GBps(raw.size(), best), static_cast<double>(singleNs) / static_cast<double>(best));
+        }
+        if (out != raw)
+        {
+            std::printf("%s: round trip mismatch\n", name);
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace Drama::Bench
+{
+    // 圧縮率、展開速度とスレッド数による伸び、圧縮ファイルのランダム読みの遅延を測る。
+    // 引数: --size=データのMB(既定64) --block=ブロックのKB(既定128) --threads=最大スレッド数(既定ハードウェアスレッド数)
+    //       --reads=ランダム読みの回数(既定2000)
+    int RunCompressionBench(Args args)
+    {
+        const size_t size = static_cast<size_t>(ArgU64(args, "size", 64)) * 1024 * 1024;
+        const uint32_t blockSize = static_cast<uint32_t>(ArgU64(args, "block", Core::IO::Blob::kDefaultBlockSize / 1024) * 1024);
+        const uint32_t maxThreads = static_cast<uint32_t>(ArgU64(args, "threads", std::max(1u, std::thread::hardware_concurrency())));
+        const size_t reads = static_cast<size_t>(ArgU64(args, "reads", 2000));
+
+        const std::vector<uint8_t> text = MakeText(size);
+        if (!RunDataset("text", text, blockSize, maxThreads) ||
+            !RunDataset("vertex", MakeVertices(size), blockSize, maxThreads) ||
+            !RunDataset("random", MakeRandom(size), blockSize, maxThreads))
+        {
+            return 1;
+        }
+
+        // 圧縮ファイルから 4KB をランダムに読む(触れたブロックだけ展開する)
+        Core::IO::IFileSystem& fs = FileSystem();
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc jobDesc;
+        jobDesc.threadCount = maxThreads;
+        if (!jobs.Start(jobDesc))
+        {
+            std::printf("failed to start jobs\n");
+            return 1;
+        }
+        Core::IO::CompressionDesc desc;
+        desc.blockSize = blockSize;
+        desc.jobSystem = &jobs;
+        Core::IO::CompressedFileSystem cfs(fs, desc);
+        const std::string dir = TempDirectory() + "compression/";
+        fs.CreateDirectories(dir);
+        const std::string path = dir + "text.bin";
+
+        auto s = Clock::now();
+        if (!cfs.WriteAllBytes(path, text.data(), text.size()))
+        {
+            std::printf("failed to write %s\n", path.c_str());
+            return 1;
+        }
+        const uint64_t writeNs = ElapsedNs(s, Clock::now());
+
+        std::vector<uint8_t> out;
+        s = Clock::now();
+        if (!cfs.ReadAllBytes(path, out) || out != text)
+        {
+            std::printf("failed to read back %s\n", path.c_str());
+            return 1;
+        }
+        const uint64_t readNs = ElapsedNs(s, Clock::now());
+        std::printf("file     WriteAllBytes=%7.2fms  ReadAllBytes=%7.2fms (%u threads)\n",
+            static_cast<double>(writeNs) * 1e-6, static_cast<double>(readNs) * 1e-6, maxThreads);
+
+        std::unique_ptr<Core::IO::IFileReader> reader;
+        if (!cfs.OpenRead(path, reader))
+        {
+            std::printf("failed to open %s\n", path.c_str());
+            return 1;
+        }
+        constexpr size_t kReadSize = 4096;
+        uint8_t buf[kReadSize];
+        std::vector<uint64_t> samples;
+        samples.reserve(reads);
+        uint32_t x = 4242;
+        for (size_t i = 0; i < reads; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            const uint64_t offset = x % (text.size() - kReadSize);
+            size_t n = 0;
+            s = Clock::now();
+            reader->ReadAt(offset, buf, kReadSize, n);
+            samples.push_back(ElapsedNs(s, Clock::now()));
+            if (n != kReadSize || std::memcmp(buf, text.data() + offset, kReadSize) != 0)
+            {
+                std::printf("random read mismatch at %llu\n", static_cast<unsigned long long>(offset));
+                return 1;
+            }
+        }
+        const LatencySummary lat = Summarize(samples);
+        std::printf("random 4KB ReadAt  p50=%7.1fus  p99=%7.1fus  max=%7.1fus\n", lat.p50 * 1e-3, lat.p99 * 1e-3, lat.max * 1e-3);
+        return 0;
+    }
+}
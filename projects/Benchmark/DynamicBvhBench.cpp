@@ -0,0 +1,232 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/DynamicBvh.h"
+#include "Core/include/JobSystem.h"
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using namespace Drama::Core::Math;
+    using namespace Drama::Core::Scene;
+
+    volatile uint32_t g_Sink = 0;
+
+    double Ms(Clock::time_point begin) noexcept
+    {
+        return static_cast<double>(ElapsedNs(begin, Clock::now())) / 1e6;
+    }
+
+    // 比較用の総当たり(配列をそのまま全部見る)
+    RayHit BruteRaycast(const std::vector<Aabb>& boxes, const Ray& ray) noexcept
+    {
+        RayHit hit{};
+        hit.t = ray.maxT;
+        const Float3 inv{ 1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z };
+        for (uint32_t i = 0; i < boxes.size(); ++i)
+        {
+            const Float3 t0 = (boxes[i].min - ray.origin) * inv;
+            const Float3 t1 = (boxes[i].max - ray.origin) * inv;
+            const Float3 lo = Min(t0, t1);
+            const Float3 hi = Max(t0, t1);
+            const float tEnter = std::max({ lo.x, lo.y, lo.z, 0.0f });
+            const float tExit = std::min({ hi.x, hi.y, hi.z, hit.t });
+            if (tEnter <= tExit && (tEnter < hit.t || !hit.IsHit()))
+            {
+                hit.t = tEnter;
+                hit.item = i;
+            }
+        }
+        return hit;
+    }
+
+    uint32_t BruteOverlap(const std::vector<Aabb>& boxes, const Aabb& query) noexcept
+    {
+        uint32_t count = 0;
+        for (const Aabb& box : boxes)
+        {
+            count += Overlaps(box, query) ? 1 : 0;
+        }
+        return count;
+    }
+
+    NearestHit BruteNearest(const std::vector<Aabb>& boxes, Float3 p) noexcept
+    {
+        NearestHit hit{};
+        hit.distanceSq = 3.4e38f;
+        for (uint32_t i = 0; i < boxes.size(); ++i)
+        {
+            const Float3 d = Max(Max(boxes[i].min - p, p - boxes[i].max), Float3{ 0, 0, 0 });
+            const float dsq = Dot(d, d);
+            if (dsq < hit.distanceSq)
+            {
+                hit.distanceSq = dsq;
+                hit.item = i;
+            }
+        }
+        return hit;
+    }
+
+    /// @brief 1問い合わせあたりのナノ秒
+    template <class F>
+    double NsPerQuery(uint32_t queries, F&& fn)
+    {
+        const auto s = Clock::now();
+        for (uint32_t q = 0; q < queries; ++q)
+        {
+            fn(q);
+        }
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / queries;
+    }
+}
+
+namespace Drama::Bench
+{
+    // 動的 AABB 木の構築・更新と、4分木(WideBvh)での問い合わせを 10k / 100k / 1M 個で測る。
+    // 物は密度が一定になるよう個数に合わせた立方体へ散らす。
+    //  構築: 1個ずつ Create(SAH + 回転) / Rebuild(上から SAH) / WideBvh::Build
+    //  更新: 全部を少し動かす Move / 全部の箱を SetBounds して Refit
+    //  問い合わせ: 光線・箱の重なり・最近傍を、総当たり、木(2分木)、WideBvh 1スレッド、WideBvh のまとめた問い合わせ(並列)で比べる
+    // 引数: --max=一番大きい物の数(既定1000000) --queries=問い合わせの数(既定20000) --threads=スレッド数(既定4)
+    int RunDynamicBvhBench(Args args)
+    {
+        const uint32_t largest = static_cast<uint32_t>(std::clamp<uint64_t>(ArgU64(args, "max", 1000000), 10000, 1u << 24));
+        const uint32_t queryCount = static_cast<uint32_t>(std::clamp<uint64_t>(ArgU64(args, "queries", 20000), 100, 1u << 22));
+        const uint32_t threads = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "threads", 4)));
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc jobDesc{};
+        jobDesc.threadCount = threads;
+        if (!jobs.Start(jobDesc))
+        {
+            return 1;
+        }
+
+        for (uint32_t count = 10000; count <= largest; count *= 10)
+        {
+            std::mt19937 rng(17);
+            const float side = 4.0f * std::cbrt(static_cast<float>(count));
+            std::uniform_real_distribution<float> pos(-side, side);
+            std::uniform_real_distribution<float> size(0.25f, 1.5f);
+            std::uniform_real_distribution<float> jitter(-0.15f, 0.15f);
+            std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+            std::vector<Aabb> boxes(count);
+            for (Aabb& box : boxes)
+            {
+                const Float3 c{ pos(rng), pos(rng), pos(rng) };
+                const Float3 e{ size(rng), size(rng), size(rng) };
+                box = Aabb{ c - e, c + e };
+            }
+            std::printf("--- %u objects ---\n", count);
+
+            // 構築
+            DynamicAabbTree tree;
+            std::vector<BvhProxy> proxies(count);
+            auto s = Clock::now();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                proxies[i] = tree.Create(boxes[i], i);
+            }
+            const double insertMs = Ms(s);
+            const float insertRatio = tree.AreaRatio();
+            const uint32_t insertHeight = tree.Height();
+            s = Clock::now();
+            tree.Rebuild();
+            const double rebuildMs = Ms(s);
+            WideBvh bvh;
+            s = Clock::now();
+            bvh.Build(tree);
+            const double wideMs = Ms(s);
+            std::printf("build   insert %8.2f ms (height %u, area ratio %.0f) | rebuild %8.2f ms (height %u, area ratio %.0f) | wide %6.2f ms (%u nodes, depth %u)\n",
+                insertMs, insertHeight, insertRatio, rebuildMs, tree.Height(), tree.AreaRatio(), wideMs, bvh.NodeCount(), bvh.Depth());
+
+            // 更新(全部を少し動かす)
+            for (Aabb& box : boxes)
+            {
+                const Float3 d{ jitter(rng), jitter(rng), jitter(rng) };
+                box = Aabb{ box.min + d, box.max + d };
+            }
+            s = Clock::now();
+            uint32_t reinserted = 0;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                reinserted += tree.Move(proxies[i], boxes[i]) ? 1 : 0;
+            }
+            const double moveMs = Ms(s);
+            s = Clock::now();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                tree.SetBounds(proxies[i], boxes[i]);
+            }
+            tree.Refit();
+            const double refitMs = Ms(s);
+            s = Clock::now();
+            bvh.Build(tree);
+            const double wideAgainMs = Ms(s);
+            std::printf("update  move all %7.2f ms (%u reinserted) | set bounds + refit all %7.2f ms | wide rebuild %6.2f ms\n",
+                moveMs, reinserted, refitMs, wideAgainMs);
+
+            // 問い合わせ(総当たりは遅いので数を減らす)
+            std::vector<Ray> rays(queryCount);
+            std::vector<Aabb> queries(queryCount);
+            std::vector<Float3> points(queryCount);
+            for (uint32_t q = 0; q < queryCount; ++q)
+            {
+                rays[q] = Ray{ Float3{ pos(rng), pos(rng), pos(rng) }, Float3{ dir(rng), dir(rng), dir(rng) } };
+                const Float3 c{ pos(rng), pos(rng), pos(rng) };
+                queries[q] = Aabb{ c - Float3{ 4, 4, 4 }, c + Float3{ 4, 4, 4 } };
+                points[q] = Float3{ pos(rng), pos(rng), pos(rng) };
+            }
+            const uint32_t bruteCount = static_cast<uint32_t>(std::clamp<uint64_t>(200000000ull / count, 5, queryCount));
+
+            const double rayBrute = NsPerQuery(bruteCount, [&](uint32_t q) { g_Sink = g_Sink + BruteRaycast(boxes, rays[q]).item; });
+            const double rayWide = NsPerQuery(queryCount, [&](uint32_t q) { g_Sink = g_Sink + bvh.Raycast(rays[q]).item; });
+            std::vector<RayHit> rayHits(queryCount);
+            s = Clock::now();
+            bvh.RaycastBatch(rays, rayHits, &jobs);
+            const double rayBatch = static_cast<double>(ElapsedNs(s, Clock::now())) / queryCount;
+
+            const double overlapBrute = NsPerQuery(bruteCount, [&](uint32_t q) { g_Sink = g_Sink + BruteOverlap(boxes, queries[q]); });
+            const double overlapTree = NsPerQuery(queryCount, [&](uint32_t q)
+                {
+                    uint32_t n = 0;
+                    tree.QueryOverlap(queries[q], [&](uint32_t, BvhProxy) { ++n; return true; });
+                    g_Sink = g_Sink + n;
+                });
+            std::vector<uint32_t> found;
+            const double overlapWide = NsPerQuery(queryCount, [&](uint32_t q) { found.clear(); g_Sink = g_Sink + bvh.Overlap(queries[q], found); });
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> items;
+            s = Clock::now();
+            bvh.OverlapBatch(queries, offsets, items, &jobs);
+            const double overlapBatch = static_cast<double>(ElapsedNs(s, Clock::now())) / queryCount;
+
+            const double nearestBrute = NsPerQuery(bruteCount, [&](uint32_t q) { g_Sink = g_Sink + BruteNearest(boxes, points[q]).item; });
+            const double nearestWide = NsPerQuery(queryCount, [&](uint32_t q) { g_Sink = g_Sink + bvh.Nearest(points[q]).item; });
+            std::vector<NearestHit> nearestHits(queryCount);
+            s = Clock::now();
+            bvh.NearestBatch(points, 3.4e38f, nearestHits, &jobs);
+            const double nearestBatch = static_cast<double>(ElapsedNs(s, Clock::now())) / queryCount;
+
+            std::printf("raycast brute %10.0f ns | wide %7.0f ns (x%.0f) | batch %u threads %7.0f ns\n",
+                rayBrute, rayWide, rayBrute / rayWide, threads, rayBatch);
+            std::printf("overlap brute %10.0f ns | tree %7.0f ns | wide %7.0f ns (x%.0f) | batch %u threads %7.0f ns (%.1f hits/query)\n",
+                overlapBrute, overlapTree, overlapWide, overlapBrute / overlapWide, threads, overlapBatch,
+                static_cast<double>(items.size()) / queryCount);
+            std::printf("nearest brute %10.0f ns | wide %7.0f ns (x%.0f) | batch %u threads %7.0f ns\n",
+                nearestBrute, nearestWide, nearestBrute / nearestWide, threads, nearestBatch);
+        }
+
+        jobs.Stop();
+        return 0;
+    }
+}
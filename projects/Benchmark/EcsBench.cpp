@@ -0,0 +1,191 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/Ecs.h"
+#include "Core/include/JobSystem.h"
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using Drama::Core::Ecs::CommandBuffer;
+    using Drama::Core::Ecs::Entity;
+    using Drama::Core::Ecs::World;
+
+    struct Position
+    {
+        float x, y, z;
+    };
+    struct Velocity
+    {
+        float x, y, z;
+    };
+    struct Health
+    {
+        float value;
+    };
+
+    /// @brief 比較用: 1個ずつヒープに置くゲームオブジェクト(更新に使わないメンバも一緒に載る)
+    struct GameObject
+    {
+        virtual ~GameObject() = default;
+        virtual void Update(float dt) noexcept
+        {
+            position.x += velocity.x * dt;
+            position.y += velocity.y * dt;
+            position.z += velocity.z * dt;
+        }
+        Position position{};
+        Velocity velocity{};
+        Health health{};
+        uint8_t otherState[64]{};
+    };
+
+    volatile float g_Sink = 0.0f;
+
+    /// @brief pass を reps 回流し、1エンティティあたりの ns
+    template <class F>
+    double PerEntity(uint32_t count, uint32_t reps, F&& pass)
+    {
+        const auto s = Clock::now();
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            pass();
+        }
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / (static_cast<double>(count) * reps);
+    }
+
+    void Integrate(std::span<const Entity>, std::span<Position> p, std::span<const Velocity> v)
+    {
+        constexpr float dt = 0.016f;
+        for (size_t i = 0; i < p.size(); ++i)
+        {
+            p[i].x += v[i].x * dt;
+            p[i].y += v[i].y * dt;
+            p[i].z += v[i].z * dt;
+        }
+    }
+}
+
+namespace Drama::Bench
+{
+    // ECS の走査と構造の変更の速さを 10k / 100k / 1M エンティティで測る。
+    // 走査は unique_ptr で1個ずつ置いたオブジェクト(ヒープを散らした状態)と比べる。
+    // 引数: --max=最大のエンティティ数(既定1000000) --threads=並列走査のスレッド数(既定4)
+    int RunEcsBench(Args args)
+    {
+        const uint32_t maxCount = static_cast<uint32_t>(std::clamp<uint64_t>(ArgU64(args, "max", 1000000), 1000, 1u << 24));
+        const uint32_t threads = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "threads", 4)));
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc jobDesc{};
+        jobDesc.threadCount = threads;
+        if (!jobs.Start(jobDesc))
+        {
+            return 1;
+        }
+
+        for (uint32_t count = 10000; count <= maxCount; count *= 10)
+        {
+            const uint32_t reps = std::max<uint32_t>(1, 10000000 / count);
+            std::printf("--- %u entities ---\n", count);
+
+            // 走査: 生成順を混ぜ、間に別の確保を挟んで unique_ptr の置き場を散らす
+            std::vector<std::unique_ptr<GameObject>> objects(count);
+            {
+                std::vector<uint32_t> order(count);
+                std::iota(order.begin(), order.end(), 0u);
+                std::shuffle(order.begin(), order.end(), std::mt19937(42));
+                std::vector<std::unique_ptr<uint8_t[]>> noise;
+                for (const uint32_t i : order)
+                {
+                    objects[i] = std::make_unique<GameObject>();
+                    objects[i]->velocity = Velocity{ 1, 2, 3 };
+                    noise.push_back(std::make_unique<uint8_t[]>(16 + (i * 37) % 200));
+                }
+            }
+            World world;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                world.Create(Position{}, Velocity{ 1, 2, 3 }, Health{ 100 });
+            }
+
+            const double ptrNs = PerEntity(count, reps, [&]()
+                {
+                    for (auto& o : objects)
+                    {
+                        o->Update(0.016f);
+                    }
+                    g_Sink = g_Sink + objects[0]->position.x;
+                });
+            const double ecsNs = PerEntity(count, reps, [&]()
+                {
+                    world.ForEachChunk<Position, const Velocity>(&Integrate);
+                });
+            const double parallelNs = PerEntity(count, reps, [&]()
+                {
+                    world.ParallelForEachChunk<Position, const Velocity>(jobs, &Integrate);
+                });
+            std::printf("iterate          unique_ptr %6.2f ns | ForEachChunk %6.2f ns  x%.1f | parallel(%u) %6.2f ns  x%.1f\n",
+                ptrNs, ecsNs, ptrNs / ecsNs, threads, parallelNs, ptrNs / parallelNs);
+
+            // 構造の変更: 全エンティティに型を足して外す(アーキタイプ間の移動)
+            std::vector<Entity> entities;
+            entities.reserve(count);
+            world.ForEachChunk<>([&](std::span<const Entity> e) { entities.insert(entities.end(), e.begin(), e.end()); });
+            struct Tag
+            {
+                uint32_t value;
+            };
+            auto s = Clock::now();
+            for (const Entity e : entities)
+            {
+                world.Add(e, Tag{ e.index });
+            }
+            const double addNs = static_cast<double>(ElapsedNs(s, Clock::now())) / count;
+            s = Clock::now();
+            for (const Entity e : entities)
+            {
+                world.Remove<Tag>(e);
+            }
+            const double removeNs = static_cast<double>(ElapsedNs(s, Clock::now())) / count;
+
+            // CommandBuffer 経由(積む + Playback)
+            CommandBuffer commands;
+            s = Clock::now();
+            for (const Entity e : entities)
+            {
+                commands.Add(e, Tag{ e.index });
+            }
+            world.Playback(commands);
+            const double deferredNs = static_cast<double>(ElapsedNs(s, Clock::now())) / count;
+
+            // 作成と破棄(空いたチャンクと番号は使い回される)
+            s = Clock::now();
+            for (const Entity e : entities)
+            {
+                world.Destroy(e);
+            }
+            const double destroyNs = static_cast<double>(ElapsedNs(s, Clock::now())) / count;
+            s = Clock::now();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                world.Create(Position{}, Velocity{ 1, 2, 3 }, Health{ 100 });
+            }
+            const double createNs = static_cast<double>(ElapsedNs(s, Clock::now())) / count;
+            std::printf("structural       add %6.1f ns | remove %6.1f ns | deferred add %6.1f ns | destroy %6.1f ns | create %6.1f ns  (%zu chunks)\n",
+                addNs, removeNs, deferredNs, destroyNs, createNs, world.ChunkCount());
+        }
+        jobs.Stop();
+        return 0;
+    }
+}
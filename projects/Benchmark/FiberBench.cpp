@@ -0,0 +1,171 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/Fiber.h"
+#include "Core/include/JobSystem.h"
+
+// === C++ standard library includes ===
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using namespace Drama::Core::Job;
+
+    /// @brief ピンポンの相手(切り替えてきた側へすぐ切り替え返すだけのファイバー)
+    struct PingPong
+    {
+        Fiber main;
+        Fiber* partner = nullptr;
+        uint64_t count = 0;
+    };
+
+    void PongEntry(void* arg) noexcept
+    {
+        auto* p = static_cast<PingPong*>(arg);
+        for (;;)
+        {
+            ++p->count;
+            Fiber::Switch(*p->partner, p->main);
+        }
+    }
+
+    /// @brief 生の Fiber::Switch の往復。1回の切り替え(片道)あたりの ns を返す
+    double MeasureSwitch(uint64_t rounds)
+    {
+        PingPong p;
+        FiberPool pool;
+        if (!p.main.InitFromThread() || !pool.Init(1, 64 * 1024, &PongEntry, &p))
+        {
+            return -1.0;
+        }
+        p.partner = pool.Acquire();
+        const auto s = Clock::now();
+        for (uint64_t i = 0; i < rounds; ++i)
+        {
+            Fiber::Switch(p.main, *p.partner);
+        }
+        const double ns = static_cast<double>(ElapsedNs(s, Clock::now()));
+        // 相手は切り替え待ちのまま止めておけばよい(エントリは戻らない)
+        pool.Release(p.partner);
+        pool.Shutdown();
+        p.main.ReleaseFromThread();
+        return ns / static_cast<double>(rounds * 2);
+    }
+
+    /// @brief ジョブの中で子ジョブを1つ積んで Wait する、を rounds 回。1回あたりの ns を返す
+    /// @note ファイバーありでは Wait ごとに退避と再開が起きる。なしでは待ち側がその場で子を実行する
+    double MeasureWaitInJob(JobSystem& jobs, uint64_t rounds)
+    {
+        JobCounter outer;
+        const auto s = Clock::now();
+        jobs.Run(outer, [&jobs, rounds]()
+            {
+                for (uint64_t i = 0; i < rounds; ++i)
+                {
+                    JobCounter inner;
+                    jobs.Run(inner, []() {});
+                    jobs.Wait(inner);
+                }
+            });
+        jobs.Wait(outer);
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / static_cast<double>(rounds);
+    }
+
+    /// @brief 比較用: 2スレッドが mutex + 条件変数で交互に手番を渡す。1回の受け渡しあたりの ns を返す
+    double MeasureThreadHandoff(uint64_t rounds)
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        uint64_t turn = 0;
+        std::thread other([&]()
+            {
+                for (uint64_t i = 0; i < rounds; ++i)
+                {
+                    std::unique_lock lock(mutex);
+                    cv.wait(lock, [&]() { return turn == i * 2 + 1; });
+                    ++turn;
+                    cv.notify_one();
+                }
+            });
+        const auto s = Clock::now();
+        for (uint64_t i = 0; i < rounds; ++i)
+        {
+            std::unique_lock lock(mutex);
+            ++turn;
+            cv.notify_one();
+            cv.wait(lock, [&]() { return turn == i * 2 + 2; });
+        }
+        const double ns = static_cast<double>(ElapsedNs(s, Clock::now()));
+        other.join();
+        return ns / static_cast<double>(rounds * 2);
+    }
+}
+
+namespace Drama::Bench
+{
+    // 文脈切り替えの遅延を比べる: 生のファイバー切り替え / JobSystem の Wait(ファイバーあり・なし) /
+    // スレッド間の条件変数による受け渡し。
+    // 引数: --rounds=切り替えの往復数(既定1000000) --waits=Wait の回数(既定100000)
+    //       --handoffs=スレッド受け渡しの往復数(既定20000) --reps=各計測の繰り返し(既定5)
+    int RunFiberBench(Args args)
+    {
+        const uint64_t rounds = std::max<uint64_t>(1, ArgU64(args, "rounds", 1000000));
+        const uint64_t waits = std::max<uint64_t>(1, ArgU64(args, "waits", 100000));
+        const uint64_t handoffs = std::max<uint64_t>(1, ArgU64(args, "handoffs", 20000));
+        const uint32_t reps = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "reps", 5)));
+
+        double best[4] = { 1e300, 1e300, 1e300, 1e300 };
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            const double ns = MeasureSwitch(rounds);
+            if (ns < 0.0)
+            {
+                std::printf("failed to create fibers\n");
+                return 1;
+            }
+            best[0] = std::min(best[0], ns);
+        }
+
+        // 1スレッドにして、Wait のたびに必ず退避(または待ち側での実行)が起きるようにする
+        uint64_t parks = 0;
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            JobSystem jobs;
+            JobSystemDesc desc;
+            desc.threadCount = 1;
+            desc.fiberCount = (mode == 0) ? 16 : 0;
+            desc.fiberStackSize = 64 * 1024;
+            if (!jobs.Start(desc))
+            {
+                std::printf("failed to start the job system\n");
+                return 1;
+            }
+            for (uint32_t r = 0; r < reps; ++r)
+            {
+                best[1 + mode] = std::min(best[1 + mode], MeasureWaitInJob(jobs, waits));
+            }
+            if (mode == 0)
+            {
+                parks = jobs.Stats().parks;
+            }
+            jobs.Stop();
+        }
+
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            best[3] = std::min(best[3], MeasureThreadHandoff(handoffs));
+        }
+
+        std::printf("fiber switch            %8.1f ns/switch\n", best[0]);
+        std::printf("job Wait (fiber park)   %8.1f ns/wait  (parks=%llu)\n", best[1], static_cast<unsigned long long>(parks));
+        std::printf("job Wait (help inline)  %8.1f ns/wait\n", best[2]);
+        std::printf("thread handoff (cv)     %8.1f ns/handoff\n", best[3]);
+        return 0;
+    }
+}
@@ -0,0 +1,147 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/FrameAllocator.h"
+
+// === C++ standard library includes ===
+#include <barrier>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using Drama::Core::Memory::FrameAllocator;
+    using Drama::Core::Memory::FrameMemoryResource;
+
+    constexpr uint32_t kFrameSlots = 3;
+
+    struct ChurnParams
+    {
+        uint32_t threads = 4;
+        uint32_t frames = 200;
+        uint32_t allocsPerFrame = 2000; ///< 1スレッド・1フレームあたり
+    };
+
+    /// @brief 16〜527 バイトの散らばった大きさ
+    inline size_t NextSize(uint32_t& state) noexcept
+    {
+        state = state * 1664525u + 1013904223u;
+        return 16 + ((state >> 8) & 511);
+    }
+
+    /// @brief 全スレッドがフレームごとに allocsPerFrame 回確保し、フレームの終わりで全部捨てる。1確保あたりの ns
+    /// @param body (スレッド番号, フレーム番号, 乱数状態) を受けて1フレーム分を行う
+    template <class Body, class EndFrame>
+    double Churn(const ChurnParams& p, Body&& body, EndFrame&& endFrame)
+    {
+        uint64_t frame = 0;
+        std::barrier sync(static_cast<std::ptrdiff_t>(p.threads), [&]() noexcept
+            {
+                endFrame(frame);
+                ++frame;
+            });
+        std::vector<std::thread> threads;
+        const auto s = Clock::now();
+        for (uint32_t t = 0; t < p.threads; ++t)
+        {
+            threads.emplace_back([&, t]()
+                {
+                    uint32_t state = 0x9E3779B9u * (t + 1);
+                    for (uint32_t f = 0; f < p.frames; ++f)
+                    {
+                        body(t, frame, state);
+                        sync.arrive_and_wait();
+                    }
+                });
+        }
+        for (std::thread& th : threads)
+        {
+            th.join();
+        }
+        const double total = static_cast<double>(p.threads) * p.frames * p.allocsPerFrame;
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / total;
+    }
+}
+
+namespace Drama::Bench
+{
+    // フレーム用確保器と malloc/free の比較(複数スレッドが毎フレーム大量に確保して捨てる)。
+    // 引数: --threads=スレッド数(既定4) --frames=フレーム数(既定200) --allocs=1スレッド1フレームの確保数(既定2000)
+    int RunFrameAllocatorBench(Args args)
+    {
+        ChurnParams p;
+        p.threads = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "threads", 4)));
+        p.frames = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "frames", 200)));
+        p.allocsPerFrame = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "allocs", 2000)));
+
+        // malloc: フレーム内で確保し、フレームの終わりに各自 free する
+        std::vector<std::vector<void*>> live(p.threads);
+        const double mallocNs = Churn(p, [&](uint32_t t, uint64_t, uint32_t& state)
+            {
+                std::vector<void*>& mine = live[t];
+                mine.clear();
+                for (uint32_t i = 0; i < p.allocsPerFrame; ++i)
+                {
+                    void* m = std::malloc(NextSize(state));
+                    static_cast<char*>(m)[0] = 1;
+                    mine.push_back(m);
+                }
+                for (void* m : mine)
+                {
+                    std::free(m);
+                }
+            }, [](uint64_t) {});
+
+        // フレーム用確保器: 各自スレッドの区画から切り出し、次に同じ枠を使うフレームの頭で枠ごと戻す
+        FrameAllocator frameAllocator;
+        frameAllocator.Init(kFrameSlots);
+        const double frameNs = Churn(p, [&](uint32_t, uint64_t frame, uint32_t& state)
+            {
+                for (uint32_t i = 0; i < p.allocsPerFrame; ++i)
+                {
+                    void* m = frameAllocator.Allocate(frame, NextSize(state), 16);
+                    static_cast<char*>(m)[0] = 1;
+                }
+            }, [&](uint64_t frame) { frameAllocator.Reset(frame + 1); });
+
+        // 標準コンテナ: 小さな一時リストを毎フレームたくさん作って捨てる(std::allocator と pmr 経由の比較)
+        const uint32_t lists = std::max<uint32_t>(1, p.allocsPerFrame / 8);
+        constexpr uint32_t kListLength = 24; // 伸びるたびに確保し直すので1本あたり6回確保する
+        const auto buildLists = [&](auto makeVector, uint32_t& state)
+            {
+                for (uint32_t l = 0; l < lists; ++l)
+                {
+                    auto v = makeVector();
+                    for (uint32_t i = 0; i < kListLength; ++i)
+                    {
+                        v.push_back(state + i);
+                    }
+                    state += v.back();
+                }
+            };
+        const double vectorNs = Churn(p, [&](uint32_t, uint64_t, uint32_t& state)
+            {
+                buildLists([]() { return std::vector<uint32_t>(); }, state);
+            }, [](uint64_t) {}) * p.allocsPerFrame / lists;
+        const double pmrNs = Churn(p, [&](uint32_t, uint64_t frame, uint32_t& state)
+            {
+                FrameMemoryResource resource(frameAllocator, frame);
+                buildLists([&resource]() { return std::pmr::vector<uint32_t>(&resource); }, state);
+            }, [&](uint64_t frame) { frameAllocator.Reset(frame + 1); }) * p.allocsPerFrame / lists;
+
+        std::printf("threads=%u frames=%u allocs/frame/thread=%u\n", p.threads, p.frames, p.allocsPerFrame);
+        std::printf("malloc/free        %7.2f ns/alloc\n", mallocNs);
+        std::printf("FrameAllocator     %7.2f ns/alloc  x%.1f\n", frameNs, mallocNs / frameNs);
+        std::printf("std::vector x%u    %7.2f ns/list\n", kListLength, vectorNs);
+        std::printf("pmr::vector x%u    %7.2f ns/list  x%.1f\n", kListLength, pmrNs, vectorNs / pmrNs);
+        const auto stats = frameAllocator.Stats(0);
+        std::printf("slot0: peak %.1f KB reserved %.1f KB blocks %llu threads %u\n",
+            static_cast<double>(stats.peakBytes) / 1024.0, static_cast<double>(stats.reservedBytes) / 1024.0,
+            static_cast<unsigned long long>(stats.blockAllocations), stats.threads);
+        return 0;
+    }
+}
@@ -0,0 +1,56 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Platform/include/FrameClock.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+
+namespace
+{
+    using Drama::Platform::FrameClock;
+    using Drama::Platform::FrameClockDesc;
+    using Drama::Platform::FrameTimeStats;
+
+    FrameTimeStats RunLimiter(double fps, double spinSeconds, uint32_t frames)
+    {
+        FrameClockDesc desc;
+        desc.targetFps = fps;
+        desc.spinSeconds = spinSeconds;
+        FrameClock clock(desc);
+        for (uint32_t i = 0; i <= frames; ++i)
+        {
+            clock.BeginFrame();
+            while (clock.StepFixed())
+            {
+            }
+            clock.WaitForNextFrame();
+        }
+        return clock.Stats();
+    }
+}
+
+namespace Drama::Bench
+{
+    // フレームリミッタの正確さ。眠るだけ(spin=0)と、眠ってから回る(既定)とでフレーム間隔のずれを比べる。
+    // 引数: --frames=各計測のフレーム数(既定300) --spin=回る時間us(既定1000)
+    int RunFrameClockBench(Args args)
+    {
+        const uint32_t frames = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "frames", 300)));
+        const double spin = static_cast<double>(ArgU64(args, "spin", 1000)) * 1e-6;
+        const double rates[] = { 60.0, 144.0, 240.0 };
+        for (double fps : rates)
+        {
+            for (int mode = 0; mode < 2; ++mode)
+            {
+                const FrameTimeStats s = RunLimiter(fps, mode == 0 ? 0.0 : spin, frames);
+                std::printf("%5.0fHz %-12s avg %8.3fms | jitter avg %7.1fus max %8.1fus%s\n",
+                    fps, mode == 0 ? "sleep" : "sleep+spin", s.averageSeconds * 1e3,
+                    s.jitterAverageSeconds * 1e6, s.jitterMaxSeconds * 1e6,
+                    (mode == 1 && s.jitterAverageSeconds < 100e-6) ? "  (<100us)" : "");
+            }
+        }
+        return 0;
+    }
+}
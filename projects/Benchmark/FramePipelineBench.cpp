@@ -0,0 +1,145 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/FramePipeline.h"
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using namespace Drama::Core::Frame;
+
+    /// @brief ベンチ用のスナップショット(描画要求の代わりに数値の列を載せる)
+    struct BenchSnapshot
+    {
+        uint64_t frame = 0;
+        Clock::time_point updateBegin{};
+        std::vector<uint32_t> items;
+    };
+
+    /// @brief us マイクロ秒だけ CPU を回す(Update / Render の処理の代わり)
+    void BusyFor(uint64_t us)
+    {
+        const auto end = Clock::now() + std::chrono::microseconds(us);
+        while (Clock::now() < end)
+        {
+        }
+    }
+
+    struct FrameResult
+    {
+        double fps = 0.0;
+        double latencyAvgMs = 0.0; ///< Update 開始から Render 終了まで
+        double latencyP99Ms = 0.0;
+    };
+
+    void WriteSnapshot(BenchSnapshot& s, uint64_t frame, size_t items, uint64_t updateUs)
+    {
+        s.frame = frame;
+        s.updateBegin = Clock::now();
+        BusyFor(updateUs);
+        s.items.clear();
+        for (size_t i = 0; i < items; ++i)
+        {
+            s.items.push_back(static_cast<uint32_t>(frame + i));
+        }
+    }
+
+    FrameResult Summarize(std::vector<double>& latencies, uint64_t frames, uint64_t totalNs)
+    {
+        FrameResult r;
+        r.fps = static_cast<double>(frames) * 1e9 / static_cast<double>(totalNs);
+        double sum = 0.0;
+        for (double l : latencies)
+        {
+            sum += l;
+        }
+        r.latencyAvgMs = sum / static_cast<double>(latencies.size()) * 1e-6;
+        std::sort(latencies.begin(), latencies.end());
+        r.latencyP99Ms = latencies[latencies.size() * 99 / 100] * 1e-6;
+        return r;
+    }
+
+    /// @brief slots = 0 なら1スレッドで Update → Render を順に、それ以外は描画スレッドを立てて重ねる
+    FrameResult RunFrames(uint32_t slots, uint64_t frames, size_t items, uint64_t updateUs, uint64_t renderUs)
+    {
+        FramePipeline<BenchSnapshot> pipeline;
+        pipeline.Init(std::max(1u, slots));
+        std::vector<double> latencies;
+        latencies.reserve(frames);
+        auto renderOne = [&](const BenchSnapshot& s)
+            {
+                BusyFor(renderUs);
+                latencies.push_back(static_cast<double>(ElapsedNs(s.updateBegin, Clock::now())));
+            };
+
+        const auto start = Clock::now();
+        std::thread render;
+        if (slots > 0)
+        {
+            render = std::thread([&]()
+                {
+                    while (const BenchSnapshot* s = pipeline.BeginRender())
+                    {
+                        renderOne(*s);
+                        pipeline.EndRender();
+                    }
+                });
+        }
+        for (uint64_t f = 0; f < frames; ++f)
+        {
+            WriteSnapshot(*pipeline.BeginUpdate(), f, items, updateUs);
+            pipeline.EndUpdate();
+            if (slots == 0)
+            {
+                renderOne(*pipeline.BeginRender());
+                pipeline.EndRender();
+            }
+        }
+        pipeline.Stop();
+        if (render.joinable())
+        {
+            render.join();
+        }
+        return Summarize(latencies, frames, ElapsedNs(start, Clock::now()));
+    }
+}
+
+namespace Drama::Bench
+{
+    // GPU 無しで、Update と Render を重ねたときのフレームの速さと遅延を比べる。
+    // Update / Render の中身は指定時間 CPU を回すだけ(2コア以上ないと重ねても速くならない)。
+    // 引数: --frames=フレーム数(既定600) --update=Update の時間us(既定4000) --render=Render の時間us(既定4000)
+    //       --items=1フレームの描画要求数(既定10000)
+    int RunFramePipelineBench(Args args)
+    {
+        const uint64_t frames = std::max<uint64_t>(1, ArgU64(args, "frames", 600));
+        const uint64_t updateUs = ArgU64(args, "update", 4000);
+        const uint64_t renderUs = ArgU64(args, "render", 4000);
+        const size_t items = static_cast<size_t>(ArgU64(args, "items", 10000));
+        std::printf("hardware threads=%u  update=%lluus render=%lluus\n", std::thread::hardware_concurrency(),
+            static_cast<unsigned long long>(updateUs), static_cast<unsigned long long>(renderUs));
+
+        for (uint32_t slots = 0; slots <= kMaxFrameSlots; ++slots)
+        {
+            const FrameResult r = RunFrames(slots, frames, items, updateUs, renderUs);
+            if (slots == 0)
+            {
+                std::printf("serial         ");
+            }
+            else
+            {
+                std::printf("pipelined x%u   ", slots);
+            }
+            std::printf("%8.1f fps | latency avg %7.2fms p99 %7.2fms\n", r.fps, r.latencyAvgMs, r.latencyP99Ms);
+        }
+        return 0;
+    }
+}
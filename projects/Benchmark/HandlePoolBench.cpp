@@ -0,0 +1,183 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/HandlePool.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using Drama::Core::Memory::HandlePool;
+    using Drama::Core::Memory::HandlePoolDesc;
+
+    /// @brief ゲームオブジェクトくらいの大きさ(64 バイト)
+    struct Particle
+    {
+        float position[3];
+        float velocity[3];
+        float life;
+        uint32_t flags;
+        uint8_t payload[32];
+    };
+
+    volatile float g_Sink = 0.0f;
+
+    /// @brief threads 本が churn 回ずつ作って壊す。1組あたりの ns
+    template <class Body>
+    double Throughput(uint32_t threads, uint64_t churn, Body&& body)
+    {
+        std::vector<std::thread> workers;
+        const auto s = Clock::now();
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&body, churn]() { body(churn); });
+        }
+        for (std::thread& w : workers)
+        {
+            w.join();
+        }
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / static_cast<double>(churn * threads);
+    }
+}
+
+namespace Drama::Bench
+{
+    // HandlePool と make_unique の比較(確保・解放の速さと、全オブジェクトを舐める速さ)。
+    // 引数: --count=オブジェクト数(既定100000) --threads=確保のスレッド数(既定4) --churn=1スレッドの作って壊す回数(既定1000000)
+    int RunHandlePoolBench(Args args)
+    {
+        const uint32_t count = static_cast<uint32_t>(std::clamp<uint64_t>(ArgU64(args, "count", 100000), 1, 1u << 20));
+        const uint32_t threads = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "threads", 4)));
+        const uint64_t churn = std::max<uint64_t>(1, ArgU64(args, "churn", 1000000));
+
+        // 確保と解放: 1スレッドあたり 64 個を持ち回して作って壊す
+        const double uniqueNs = Throughput(threads, churn, [](uint64_t n)
+            {
+                std::unique_ptr<Particle> live[64];
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    live[i & 63] = std::make_unique<Particle>();
+                }
+            });
+        HandlePool<Particle> pool;
+        HandlePoolDesc desc;
+        desc.maxObjects = std::max<uint32_t>(count, threads * 64 + 1024);
+        pool.Init(desc);
+        const double poolNs = Throughput(threads, churn, [&pool](uint64_t n)
+            {
+                HandlePool<Particle>::Handle live[64] = {};
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    pool.Destroy(live[i & 63]);
+                    live[i & 63] = pool.Create();
+                }
+                for (auto& h : live)
+                {
+                    pool.Destroy(h);
+                }
+            });
+        std::printf("create+destroy (%u threads)  make_unique %6.1f ns | HandlePool %6.1f ns  x%.1f\n",
+            threads, uniqueNs, poolNs, uniqueNs / poolNs);
+
+        // 走査: 別の確保を挟んでヒープを散らした unique_ptr の列と、プールの ForEach / ハンドル経由
+        std::vector<std::unique_ptr<Particle>> objects;
+        std::vector<std::unique_ptr<uint8_t[]>> noise;
+        std::vector<HandlePool<Particle>::Handle> handles;
+        objects.reserve(count);
+        handles.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            objects.push_back(std::make_unique<Particle>());
+            objects.back()->velocity[1] = static_cast<float>(i & 7);
+            noise.push_back(std::make_unique<uint8_t[]>(16 + (i * 37) % 200));
+            handles.push_back(pool.Create());
+            Particle* p = pool.Get(handles.back());
+            if (!p)
+            {
+                std::printf("HandlePool::Create failed at %u of %u\n", i, count);
+                return 1;
+            }
+            p->velocity[1] = static_cast<float>(i & 7);
+        }
+        noise.clear();
+
+        constexpr int kReps = 20;
+        const auto timePass = [count](auto&& pass)
+            {
+                const auto s = Clock::now();
+                for (int r = 0; r < kReps; ++r)
+                {
+                    pass();
+                }
+                return static_cast<double>(ElapsedNs(s, Clock::now())) / (static_cast<double>(count) * kReps);
+            };
+        const auto report = [&](const char* label)
+            {
+                const double ptrNs = timePass([&]()
+                    {
+                        for (auto& p : objects)
+                        {
+                            p->position[1] += p->velocity[1] * 0.016f;
+                        }
+                        g_Sink = g_Sink + objects[0]->position[1];
+                    });
+                const double forEachNs = timePass([&]()
+                    {
+                        pool.ForEach([](HandlePool<Particle>::Handle, Particle& p) { p.position[1] += p.velocity[1] * 0.016f; });
+                        g_Sink = g_Sink + pool.Get(handles[0])->position[1];
+                    });
+                const double handleNs = timePass([&]()
+                    {
+                        for (const auto& h : handles)
+                        {
+                            Particle* p = pool.Get(h);
+                            p->position[1] += p->velocity[1] * 0.016f;
+                        }
+                        g_Sink = g_Sink + pool.Get(handles[0])->position[1];
+                    });
+                std::printf("iterate %u objects %-7s unique_ptr %6.2f ns | ForEach %6.2f ns  x%.1f | Get(handle) %6.2f ns  x%.1f\n",
+                    count, label, ptrNs, forEachNs, ptrNs / forEachNs, handleNs, ptrNs / handleNs);
+            };
+        report("(fresh)");
+
+        // 半分を順不同に破棄し、別の順で作り直した後: ヒープは解放された穴へばらばらに置き直すので
+        // 配列の順とメモリの順がずれるが、プールの ForEach は常にスラブの並び順に回る
+        std::vector<uint32_t> order(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            order[i] = i;
+        }
+        uint32_t state = 12345;
+        const auto shuffle = [&order, &state]()
+            {
+                for (size_t i = order.size(); i > 1; --i)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    std::swap(order[i - 1], order[(state >> 8) % i]);
+                }
+            };
+        shuffle();
+        for (uint32_t i = 0; i < count / 2; ++i)
+        {
+            objects[order[i]].reset();
+            pool.Destroy(handles[order[i]]);
+        }
+        // 破棄した順とは別の順で作り直す
+        shuffle();
+        for (uint32_t victim : order)
+        {
+            if (!objects[victim])
+            {
+                objects[victim] = std::make_unique<Particle>();
+                handles[victim] = pool.Create();
+            }
+        }
+        report("(churn)");
+        return 0;
+    }
+}
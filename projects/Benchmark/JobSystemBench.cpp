@@ -0,0 +1,156 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/JobSystem.h"
+
+// === C++ standard library includes ===
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using namespace Drama::Core::Job;
+
+    std::atomic<uint64_t> g_Sink{ 0 };
+
+    /// @brief 最適化で消えない程度の計算(iterations 回の xorshift)
+    uint64_t Spin(uint64_t seed, uint32_t iterations) noexcept
+    {
+        uint64_t x = seed | 1;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        return x;
+    }
+
+    /// @brief 細粒度: 要素ごとに数十ns の処理を ParallelFor(自動粒度)で回す
+    void FineGraph(JobSystem& jobs, std::vector<uint64_t>& data, uint32_t work)
+    {
+        jobs.ParallelFor(data.size(), [&data, work](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    data[i] = Spin(data[i] + i, work);
+                }
+            });
+    }
+
+    /// @brief 細粒度: 2分木にジョブを積み、各節で子を Wait する(入れ子の待ちと盗みの性能)
+    uint64_t TreeGraph(JobSystem& jobs, uint32_t depth, uint32_t work)
+    {
+        if (depth == 0)
+        {
+            return Spin(depth + 1, work);
+        }
+        JobCounter counter;
+        uint64_t left = 0;
+        jobs.Run(counter, [&jobs, &left, depth, work]() { left = TreeGraph(jobs, depth - 1, work); });
+        const uint64_t right = TreeGraph(jobs, depth - 1, work);
+        jobs.Wait(counter);
+        return left ^ right;
+    }
+
+    /// @brief 粗粒度: 段ごとに tasks 個の重い処理を並べ、RunAfter で前段の完了を待つ(フレームの処理段の模型)
+    void CoarseGraph(JobSystem& jobs, uint32_t stages, uint32_t tasks, uint32_t work)
+    {
+        std::vector<JobCounter> counters(stages);
+        for (uint32_t s = 0; s < stages; ++s)
+        {
+            for (uint32_t t = 0; t < tasks; ++t)
+            {
+                auto body = [s, t, work]() { g_Sink.fetch_xor(Spin(s * 131 + t, work), std::memory_order_relaxed); };
+                if (s == 0)
+                {
+                    jobs.Run(counters[s], body);
+                }
+                else
+                {
+                    jobs.RunAfter(counters[s - 1], counters[s], body);
+                }
+            }
+        }
+        jobs.Wait(counters[stages - 1]);
+    }
+}
+
+namespace Drama::Bench
+{
+    // 1..N スレッドで同じタスクグラフを流し、1スレッドに対する速度比を出す。
+    // 引数: --threads=最大スレッド数(既定コア数) --reps=各計測の繰り返し(既定5)
+    //       --items=細粒度の要素数(既定1000000) --depth=木の深さ(既定16)
+    //       --stages=粗粒度の段数(既定4) --tasks=1段のタスク数(既定64) --work=粗粒度1タスクの反復数(既定200000)
+    int RunJobSystemBench(Args args)
+    {
+        const uint32_t hw = std::max(1u, std::thread::hardware_concurrency());
+        const uint32_t maxThreads = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "threads", hw)));
+        const uint32_t reps = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "reps", 5)));
+        const size_t items = static_cast<size_t>(ArgU64(args, "items", 1000000));
+        const uint32_t depth = static_cast<uint32_t>(ArgU64(args, "depth", 16));
+        const uint32_t stages = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "stages", 4)));
+        const uint32_t tasks = static_cast<uint32_t>(ArgU64(args, "tasks", 64));
+        const uint32_t work = static_cast<uint32_t>(ArgU64(args, "work", 200000));
+        std::printf("hardware threads=%u  (speedup is relative to 1 thread; it cannot exceed the core count)\n", hw);
+
+        std::vector<uint32_t> counts;
+        for (uint32_t n = 1; n < maxThreads; n *= 2)
+        {
+            counts.push_back(n);
+        }
+        counts.push_back(maxThreads);
+
+        std::vector<uint64_t> data(items, 1);
+        double base[3] = {};
+        for (uint32_t n : counts)
+        {
+            JobSystem jobs;
+            JobSystemDesc desc;
+            desc.threadCount = n;
+            if (!jobs.Start(desc))
+            {
+                std::printf("failed to start %u threads\n", n);
+                return 1;
+            }
+
+            double best[3] = { 1e300, 1e300, 1e300 };
+            for (uint32_t r = 0; r < reps; ++r)
+            {
+                auto s = Clock::now();
+                FineGraph(jobs, data, 16);
+                best[0] = std::min(best[0], static_cast<double>(ElapsedNs(s, Clock::now())));
+
+                s = Clock::now();
+                g_Sink.fetch_xor(TreeGraph(jobs, depth, 64), std::memory_order_relaxed);
+                best[1] = std::min(best[1], static_cast<double>(ElapsedNs(s, Clock::now())));
+
+                s = Clock::now();
+                CoarseGraph(jobs, stages, tasks, work);
+                best[2] = std::min(best[2], static_cast<double>(ElapsedNs(s, Clock::now())));
+            }
+            const JobSystemStats stats = jobs.Stats();
+            jobs.Stop();
+
+            if (n == 1)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    base[i] = best[i];
+                }
+            }
+            std::printf("threads=%2u  fine(ParallelFor %zu) %8.2fms x%4.2f | tree(2^%u) %8.2fms x%4.2f | coarse(%ux%u) %8.2fms x%4.2f | jobs=%llu stolen=%llu heap=%llu\n",
+                n, items, best[0] * 1e-6, base[0] / best[0], depth, best[1] * 1e-6, base[1] / best[1],
+                stages, tasks, best[2] * 1e-6, base[2] / best[2],
+                static_cast<unsigned long long>(stats.executed), static_cast<unsigned long long>(stats.stolen),
+                static_cast<unsigned long long>(stats.heapJobs));
+        }
+        std::printf("(sink=%llu)\n", static_cast<unsigned long long>(g_Sink.load()));
+        return 0;
+    }
+}
@@ -0,0 +1,103 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/LogAssert.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Scenario
+    {
+        const char* name;
+        bool isAsync;
+        Drama::Core::LogOverflowPolicy overflow;
+    };
+
+    void RunScenario(const Scenario& sc, uint32_t threadCount, uint32_t linesPerThread)
+    {
+        using namespace Drama;
+
+        const std::string path = Bench::TempDirectory() + "log_bench.txt";
+        const size_t total = static_cast<size_t>(threadCount) * linesPerThread;
+
+        // 既定のローテーション設定(セグメント切り替えも含めた実運用の経路)で比べる
+        Core::LogAssert::Init(Bench::FileSystem(), path, Core::LogRotationDesc{});
+        if (sc.isAsync)
+        {
+            Core::AsyncLogDesc desc{};
+            desc.overflow = sc.overflow;
+            Core::LogAssert::EnableAsync(desc);
+        }
+
+        std::vector<std::vector<uint64_t>> latencies(threadCount);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+
+        const auto begin = Bench::Clock::now();
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([t, linesPerThread, &latencies]()
+                {
+                    std::vector<uint64_t>& lat = latencies[t];
+                    lat.reserve(linesPerThread);
+                    std::string line;
+                    for (uint32_t i = 0; i < linesPerThread; ++i)
+                    {
+                        line = "[bench] thread=" + std::to_string(t) + " seq=" + std::to_string(i) +
+                            " payload=0123456789abcdef0123456789abcdef";
+                        const auto s = Bench::Clock::now();
+                        Core::LogAssert::WriteLine(line);
+                        lat.push_back(Bench::ElapsedNs(s, Bench::Clock::now()));
+                    }
+                });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        Core::LogAssert::Flush();
+        const auto end = Bench::Clock::now();
+        const uint64_t dropped = Core::LogAssert::DroppedLines();
+        Core::LogAssert::Shutdown();
+
+        std::vector<uint64_t> all;
+        all.reserve(total);
+        for (auto& v : latencies)
+        {
+            all.insert(all.end(), v.begin(), v.end());
+        }
+        const Bench::LatencySummary s = Bench::Summarize(all);
+        const double seconds = static_cast<double>(Bench::ElapsedNs(begin, end)) * 1e-9;
+
+        std::printf("%-12s threads=%u lines=%zu  %12.0f lines/s  p50=%8.0fns p99=%10.0fns max=%10.0fns dropped=%llu\n",
+            sc.name, threadCount, total, static_cast<double>(total) / seconds,
+            s.p50, s.p99, s.max, static_cast<unsigned long long>(dropped));
+    }
+}
+
+namespace Drama::Bench
+{
+    // 同期書き込みと非同期(Drop/Block)で、スループットと呼び出し側のレイテンシを比べる
+    int RunLogAssertBench(Args args)
+    {
+        const uint32_t threadCount = static_cast<uint32_t>(ArgU64(args, "threads", 4));
+        const uint32_t lines = static_cast<uint32_t>(ArgU64(args, "lines", 20000));
+
+        const Scenario scenarios[] = {
+            { "sync", false, Core::LogOverflowPolicy::Drop },
+            { "async-drop", true, Core::LogOverflowPolicy::Drop },
+            { "async-block", true, Core::LogOverflowPolicy::Block },
+        };
+        for (const Scenario& sc : scenarios)
+        {
+            RunScenario(sc, threadCount, lines);
+        }
+        return 0;
+    }
+}
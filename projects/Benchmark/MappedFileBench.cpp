@@ -0,0 +1,143 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/MappedFile.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // 読んだ結果を捨てさせないための書き込み先
+    volatile uint64_t g_Sink = 0;
+
+    /// @brief 全バイトに触れる
+    uint64_t Touch(std::span<const uint8_t> bytes) noexcept
+    {
+        uint64_t sum = 0;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t))
+        {
+            uint64_t v = 0;
+            std::memcpy(&v, bytes.data() + i, sizeof(v));
+            sum += v;
+        }
+        for (; i < bytes.size(); ++i)
+        {
+            sum += bytes[i];
+        }
+        return sum;
+    }
+
+    bool MakeFile(const std::string& path, uint64_t size)
+    {
+        using namespace Drama;
+
+        // 1MB単位で追記して、巨大なバッファを一度に確保しない
+        std::vector<uint8_t> chunk(static_cast<size_t>(std::min<uint64_t>(size, 1u << 20)));
+        for (size_t i = 0; i < chunk.size(); ++i)
+        {
+            chunk[i] = static_cast<uint8_t>(i * 131u);
+        }
+        if (!Bench::FileSystem().WriteAllBytes(path, nullptr, 0))
+        {
+            return false;
+        }
+        uint64_t written = 0;
+        while (written < size)
+        {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(chunk.size(), size - written));
+            if (!Bench::FileSystem().AppendAllBytes(path, chunk.data(), n))
+            {
+                return false;
+            }
+            written += n;
+        }
+        return true;
+    }
+
+    void PrintSize(uint64_t bytes)
+    {
+        if (bytes >= (1ull << 30))
+        {
+            std::printf("%6llu GB", static_cast<unsigned long long>(bytes >> 30));
+        }
+        else if (bytes >= (1ull << 20))
+        {
+            std::printf("%6llu MB", static_cast<unsigned long long>(bytes >> 20));
+        }
+        else
+        {
+            std::printf("%6llu KB", static_cast<unsigned long long>(bytes >> 10));
+        }
+    }
+}
+
+namespace Drama::Bench
+{
+    // ReadAllBytes(コピー) と MapReadOnly(ゼロコピー) で、ファイル全体を読んで全バイトに触れるまでの時間を比べる。
+    // どちらもページキャッシュに載った状態(2回目以降の読み込み)での比較。
+    // 引数: --min=バイト(既定4KB) --max=バイト(既定1GB) --budget=1サイズあたりの総読み込みバイト(既定256MB)
+    int RunMappedFileBench(Args args)
+    {
+        const uint64_t minSize = ArgU64(args, "min", 4ull << 10);
+        const uint64_t maxSize = ArgU64(args, "max", 1ull << 30);
+        const uint64_t budget = ArgU64(args, "budget", 256ull << 20);
+        const std::string path = TempDirectory() + "mmap_bench.bin";
+
+        std::printf("    size    read p50      map p50     read MB/s     map MB/s  mapped\n");
+        for (uint64_t size = minSize; size <= maxSize; size *= 4)
+        {
+            if (!MakeFile(path, size))
+            {
+                std::printf("failed to create %s\n", path.c_str());
+                return 1;
+            }
+
+            const uint64_t iterations = std::max<uint64_t>(3, std::min<uint64_t>(1000, budget / size));
+            std::vector<uint64_t> readNs;
+            std::vector<uint64_t> mapNs;
+            bool isMapped = false;
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                {
+                    const auto s = Clock::now();
+                    std::vector<uint8_t> bytes;
+                    if (!FileSystem().ReadAllBytes(path, bytes))
+                    {
+                        return 1;
+                    }
+                    g_Sink = g_Sink + Touch(bytes);
+                    readNs.push_back(ElapsedNs(s, Clock::now()));
+                }
+                {
+                    const auto s = Clock::now();
+                    Core::IO::MappedFile mapped;
+                    if (!FileSystem().MapReadOnly(path, mapped))
+                    {
+                        return 1;
+                    }
+                    g_Sink = g_Sink + Touch(mapped.Bytes());
+                    isMapped = mapped.IsMapped();
+                    mapped.Reset(); // 解放まで計測に含める
+                    mapNs.push_back(ElapsedNs(s, Clock::now()));
+                }
+            }
+
+            const LatencySummary r = Summarize(readNs);
+            const LatencySummary m = Summarize(mapNs);
+            const double mb = static_cast<double>(size) / (1024.0 * 1024.0);
+            PrintSize(size);
+            std::printf("  %10.1fus  %10.1fus  %12.1f %12.1f  %s\n",
+                r.p50 * 1e-3, m.p50 * 1e-3, mb / (r.mean * 1e-9), mb / (m.mean * 1e-9),
+                isMapped ? "yes" : "no");
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,105 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/MathBatch.h"
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using namespace Drama::Core::Math;
+
+    volatile float g_Sink = 0.0f;
+
+    /// @brief pass を reps 回流し、1要素あたりの ns
+    template <class F>
+    double PerItem(size_t count, uint32_t reps, F&& pass)
+    {
+        pass(); // 温める
+        const auto s = Clock::now();
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            pass();
+        }
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / (static_cast<double>(count) * reps);
+    }
+}
+
+namespace Drama::Bench
+{
+    // バッチ演算の速さを、この CPU で使える実装(Scalar / SSE2 / AVX2 / NEON)ごとに測る。
+    // 4096 要素は L1/L2 に収まる場合、--count の要素数はメモリ帯域が効く場合を見る。
+    // 引数: --count=大きい方の要素数(既定1000000)
+    int RunMathBench(Args args)
+    {
+        const size_t large = static_cast<size_t>(std::clamp<uint64_t>(ArgU64(args, "count", 1000000), 4096, 1u << 24));
+        std::printf("compiled level: %s\n", SimdLevelName(CompiledSimdLevel()));
+
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+        const Float4x4 m = Compose(Float3{ 2, 2, 2 }, Normalize(Quaternion{ 0.1f, 0.7f, 0.2f, 0.6f }), Float3{ 5, 6, 7 });
+
+        for (const size_t count : { size_t{ 4096 }, large })
+        {
+            const uint32_t reps = static_cast<uint32_t>(std::max<size_t>(1, 20000000 / count));
+            std::vector<float> px(count), py(count), pz(count), ox(count), oy(count), oz(count);
+            std::vector<float> qx(count), qy(count), qz(count), qw(count);
+            std::vector<Float4x4> ma(count), mb(count), mo(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                px[i] = d(rng);
+                py[i] = d(rng);
+                pz[i] = d(rng);
+                qx[i] = d(rng);
+                qy[i] = d(rng);
+                qz[i] = d(rng);
+                qw[i] = d(rng) + 2.0f;
+                ma[i] = Translation(Float3{ d(rng), d(rng), d(rng) });
+                mb[i] = m;
+            }
+            std::printf("--- %zu items ---\n", count);
+
+            double scalarNs[3] = {};
+            for (uint8_t l = 0; l < static_cast<uint8_t>(SimdLevel::Count); ++l)
+            {
+                const BatchKernels* k = KernelsFor(static_cast<SimdLevel>(l));
+                if (!k)
+                {
+                    continue;
+                }
+                const double pointNs = PerItem(count, reps, [&]()
+                    {
+                        k->transformPoints(m, ConstFloat3Stream(px.data(), py.data(), pz.data()), Float3Stream{ ox.data(), oy.data(), oz.data() }, count);
+                        g_Sink = g_Sink + ox[count - 1];
+                    });
+                const double matrixNs = PerItem(count, std::max<uint32_t>(1, reps / 4), [&]()
+                    {
+                        k->multiplyMatrices(ma.data(), mb.data(), mo.data(), count);
+                        g_Sink = g_Sink + mo[count - 1].r[3].x;
+                    });
+                const double quatNs = PerItem(count, reps, [&]()
+                    {
+                        // 2回目以降は長さ1の値を正規化し直すことになるが、処理の量は変わらない
+                        k->normalizeQuaternions(QuaternionStream{ qx.data(), qy.data(), qz.data(), qw.data() }, count);
+                        g_Sink = g_Sink + qw[count - 1];
+                    });
+                if (k->level == SimdLevel::Scalar)
+                {
+                    scalarNs[0] = pointNs;
+                    scalarNs[1] = matrixNs;
+                    scalarNs[2] = quatNs;
+                }
+                std::printf("%-7s transform points %6.3f ns (x%4.1f) | multiply matrices %6.3f ns (x%4.1f) | normalize quaternions %6.3f ns (x%4.1f)\n",
+                    SimdLevelName(k->level), pointNs, scalarNs[0] / pointNs, matrixNs, scalarNs[1] / matrixNs, quatNs, scalarNs[2] / quatNs);
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,97 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/MemoryTracker.h"
+
+// === C++ standard library includes ===
+#include <atomic>
+#include <cstdio>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using Drama::Core::Memory::MemoryTag;
+    using Drama::Core::Memory::MemoryTracker;
+
+    /// @brief 比較用: 全スレッドで1組の atomic を共有して足す素直な実装
+    struct alignas(64) SharedCounters
+    {
+        std::atomic<int64_t> bytes{ 0 };
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> frees{ 0 };
+    };
+    SharedCounters g_Shared;
+
+    /// @brief threads 本が count 回ずつ確保と解放を記録する。1組あたりの ns(全スレッドの合計スループット)
+    template <class Body>
+    double Throughput(uint32_t threads, uint64_t count, Body&& body)
+    {
+        std::vector<std::thread> workers;
+        const auto s = Clock::now();
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&body, count]() { body(count); });
+        }
+        for (std::thread& w : workers)
+        {
+            w.join();
+        }
+        return static_cast<double>(ElapsedNs(s, Clock::now())) / static_cast<double>(count * threads);
+    }
+}
+
+namespace Drama::Bench
+{
+    // 確保1組(確保+解放)にかかる追跡の費用。記録だけの費用を、スレッドごとのカウンタ(MemoryTracker)と
+    // 共有 atomic で比べ、ヒープ確保と合わせたときの上乗せも見る。DRAMA_MEMORY_TRACKING=0 では記録が消える。
+    // 引数: --count=1スレッドあたりの組数(既定2000000) --threads=最大スレッド数(既定8)
+    int RunMemoryTrackerBench(Args args)
+    {
+        const uint64_t count = std::max<uint64_t>(1, ArgU64(args, "count", 2000000));
+        const uint32_t maxThreads = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "threads", 8)));
+        std::printf("DRAMA_MEMORY_TRACKING=%d\n", DRAMA_MEMORY_TRACKING);
+
+        for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            const double perThread = Throughput(threads, count, [](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    MemoryTracker::RecordAllocation(MemoryTag::Job, nullptr, 64);
+                    MemoryTracker::RecordFree(MemoryTag::Job, nullptr, 64);
+                }
+            });
+            const double shared = Throughput(threads, count, [](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    g_Shared.bytes.fetch_add(64, std::memory_order_relaxed);
+                    g_Shared.allocations.fetch_add(1, std::memory_order_relaxed);
+                    g_Shared.bytes.fetch_sub(64, std::memory_order_relaxed);
+                    g_Shared.frees.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            const double heap = Throughput(threads, count, [](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    void* p = ::operator new(64);
+                    ::operator delete(p);
+                }
+            });
+            const double tracked = Throughput(threads, count, [](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    void* p = Core::Memory::TrackedAllocate(MemoryTag::Job, 64);
+                    Core::Memory::TrackedFree(MemoryTag::Job, p, 64);
+                }
+            });
+            std::printf("threads=%u  record: per-thread %6.2f ns  shared atomic %6.2f ns | new/delete %6.2f ns  tracked %6.2f ns\n",
+                threads, perThread, shared, heap, tracked);
+        }
+        MemoryTracker::Update(0);
+        return 0;
+    }
+}
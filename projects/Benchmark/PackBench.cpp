@@ -0,0 +1,126 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/ArchiveFileSystem.h"
+#include "Core/include/PackBuilder.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void PrintRow(const char* name, size_t files, uint64_t ns, uint64_t bytes)
+    {
+        std::printf("%-18s files=%zu  total=%9.2fms  per file=%7.2fus  %9.1f MB/s\n",
+            name, files, static_cast<double>(ns) * 1e-6, static_cast<double>(ns) * 1e-3 / static_cast<double>(files),
+            static_cast<double>(bytes) / (1024.0 * 1024.0) / (static_cast<double>(ns) * 1e-9));
+    }
+}
+
+namespace Drama::Bench
+{
+    // 小さいファイルを大量に開いて読む時間を、実ファイルとパックで比べる。
+    // 引数: --files=ファイル数(既定10000) --minsize / --maxsize=1ファイルのバイト数(既定256〜4096)
+    int RunPackBench(Args args)
+    {
+        const size_t files = static_cast<size_t>(ArgU64(args, "files", 10000));
+        const uint64_t minSize = ArgU64(args, "minsize", 256);
+        const uint64_t maxSize = std::max(minSize, ArgU64(args, "maxsize", 4096));
+
+        Core::IO::IFileSystem& fs = FileSystem();
+        const std::string dir = TempDirectory() + "pack/";
+        const std::string looseDir = dir + "loose/";
+        fs.CreateDirectories(looseDir);
+
+        // 素材を作る(サイズは決まった乱数で散らす)
+        std::vector<std::string> names;
+        names.reserve(files);
+        Core::IO::PackBuilder builder;
+        std::vector<uint8_t> data(static_cast<size_t>(maxSize));
+        uint32_t x = 12345;
+        uint64_t totalBytes = 0;
+        for (size_t i = 0; i < files; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            const size_t size = static_cast<size_t>(minSize + x % (maxSize - minSize + 1));
+            for (size_t b = 0; b < size; ++b)
+            {
+                data[b] = static_cast<uint8_t>(i + b);
+            }
+            names.push_back("asset_" + std::to_string(i) + ".bin");
+            if (!fs.WriteAllBytes(looseDir + names.back(), data.data(), size))
+            {
+                std::printf("failed to write %s\n", names.back().c_str());
+                return 1;
+            }
+            builder.Add(names.back(), looseDir + names.back());
+            totalBytes += size;
+        }
+        const std::string packPath = dir + "bench.pak";
+        if (!builder.Build(fs, packPath))
+        {
+            std::printf("failed to build %s\n", packPath.c_str());
+            return 1;
+        }
+
+        std::vector<uint8_t> out;
+        uint64_t check = 0;
+
+        // 実ファイル: 1ファイル1回の open + read
+        {
+            const auto s = Clock::now();
+            for (const std::string& name : names)
+            {
+                fs.ReadAllBytes(looseDir + name, out);
+                check += out.size();
+            }
+            PrintRow("loose ReadAll", files, ElapsedNs(s, Clock::now()), totalBytes);
+        }
+
+        // パック: 開く時間も含める
+        {
+            const auto s = Clock::now();
+            Core::IO::ArchiveFileSystem archive;
+            if (!archive.Open(fs, packPath))
+            {
+                return 1;
+            }
+            for (const std::string& name : names)
+            {
+                archive.ReadAllBytes(name, out);
+                check += out.size();
+            }
+            PrintRow("pack ReadAll", files, ElapsedNs(s, Clock::now()), totalBytes);
+        }
+
+        // パック: コピーせずにビューだけ受け取る(ファイル検索の分だけのコスト)
+        {
+            const auto s = Clock::now();
+            Core::IO::ArchiveFileSystem archive;
+            if (!archive.Open(fs, packPath))
+            {
+                return 1;
+            }
+            Core::IO::MappedFile view;
+            for (const std::string& name : names)
+            {
+                archive.MapReadOnly(name, view);
+                check += view.Size();
+            }
+            PrintRow("pack MapReadOnly", files, ElapsedNs(s, Clock::now()), totalBytes);
+        }
+
+        // 3通りとも同じ量を読めていること
+        if (check < totalBytes * 3)
+        {
+            std::printf("read size mismatch\n");
+            return 1;
+        }
+        return 0;
+    }
+}
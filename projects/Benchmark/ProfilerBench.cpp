@@ -0,0 +1,116 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Platform/include/Profiler.h"
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using Drama::Platform::Profile::CaptureDesc;
+    using Drama::Platform::Profile::Profiler;
+    using Drama::Platform::Profile::Zone;
+    using Drama::Platform::TscClock;
+
+    volatile uint64_t g_Sink = 0;
+
+    /// @brief 空の区間を zones 個開いて閉じる。1区間あたりの ns(reps 回の最小値)
+    double PerZone(uint64_t zones, uint32_t reps, bool capture, bool nested)
+    {
+        double best = 1e300;
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            if (capture)
+            {
+                CaptureDesc desc;
+                desc.maxEventsPerThread = zones;
+                Profiler::Start(desc);
+            }
+            const auto s = Clock::now();
+            if (nested)
+            {
+                for (uint64_t i = 0; i < zones; i += 4)
+                {
+                    Zone a("Level0");
+                    g_Sink = g_Sink + 1;
+                    Zone b("Level1");
+                    g_Sink = g_Sink + 1;
+                    Zone c("Level2");
+                    g_Sink = g_Sink + 1;
+                    Zone d("Level3");
+                    g_Sink = g_Sink + 1;
+                }
+            }
+            else
+            {
+                for (uint64_t i = 0; i < zones; ++i)
+                {
+                    Zone zone("Flat");
+                    g_Sink = g_Sink + 1;
+                }
+            }
+            best = std::min(best, static_cast<double>(ElapsedNs(s, Clock::now())) / static_cast<double>(zones));
+            Profiler::Stop();
+        }
+        return best;
+    }
+
+    /// @brief 区間の両端で読む時刻2回分の ns(区間の費用のうち記録以外の部分)
+    double PerClockPair(uint64_t zones, uint32_t reps)
+    {
+        double best = 1e300;
+        for (uint32_t r = 0; r < reps; ++r)
+        {
+            const auto s = Clock::now();
+            for (uint64_t i = 0; i < zones; ++i)
+            {
+                g_Sink = g_Sink + TscClock::Ticks();
+                g_Sink = g_Sink + TscClock::Ticks();
+            }
+            best = std::min(best, static_cast<double>(ElapsedNs(s, Clock::now())) / static_cast<double>(zones));
+        }
+        return best;
+    }
+}
+
+namespace Drama::Bench
+{
+    // 区間1つを記録する費用と、書き出しの速さ。区間の費用が予算を超えたら失敗にする。
+    // 引数: --zones=1回の計測の区間数(既定1000000) --reps=繰り返し(既定5) --budget=1区間の予算ns(既定50)
+    int RunProfilerBench(Args args)
+    {
+        const uint64_t zones = std::max<uint64_t>(4, ArgU64(args, "zones", 1000000));
+        const uint32_t reps = std::max<uint32_t>(1, static_cast<uint32_t>(ArgU64(args, "reps", 5)));
+        const double budget = static_cast<double>(ArgU64(args, "budget", 50));
+
+        // 初回の較正とバッファ確保を計測の外で済ませる
+        PerZone(zones, 1, true, false);
+
+        const double off = PerZone(zones, reps, false, false);
+        const double clock = PerClockPair(zones, reps);
+        const double flat = PerZone(zones, reps, true, false);
+        const double nested = PerZone(zones, reps, true, true);
+        std::printf("not capturing    %6.2f ns/zone\n", off);
+        std::printf("clock reads (x2) %6.2f ns/zone\n", clock);
+        std::printf("flat zones       %6.2f ns/zone%s\n", flat, flat < budget ? "" : "  (over budget)");
+        std::printf("nested (depth 4) %6.2f ns/zone%s\n", nested, nested < budget ? "" : "  (over budget)");
+
+        std::string json;
+        const auto s = Clock::now();
+        Profiler::ExportChromeTrace(json);
+        const double ms = static_cast<double>(ElapsedNs(s, Clock::now())) * 1e-6;
+        std::printf("export           %6.1f ms for %llu zones (%.1f MB JSON)\n",
+            ms, static_cast<unsigned long long>(Profiler::Stats().events), static_cast<double>(json.size()) / (1024.0 * 1024.0));
+        if (flat >= budget || nested >= budget)
+        {
+            std::printf("zone cost is over the %.0f ns budget\n", budget);
+            return 1;
+        }
+        return 0;
+    }
+}
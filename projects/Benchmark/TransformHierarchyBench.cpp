@@ -0,0 +1,197 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#include "Core/include/JobSystem.h"
+#include "Core/include/TransformHierarchy.h"
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Drama::Bench::Clock;
+    using Drama::Bench::ElapsedNs;
+    using namespace Drama::Core::Math;
+    using Drama::Core::Scene::TransformHierarchy;
+    using Drama::Core::Scene::TransformNode;
+
+    /// @brief 比較用: 1個ずつヒープに置き、子をポインタで持つよくあるシーングラフ
+    struct SceneNode
+    {
+        Float4x4 local = Identity();
+        Float4x4 world = Identity();
+        std::vector<SceneNode*> children;
+    };
+
+    void UpdateRecursive(SceneNode& node, const Float4x4& parentWorld)
+    {
+        node.world = Multiply(node.local, parentWorld);
+        for (SceneNode* child : node.children)
+        {
+            UpdateRecursive(*child, node.world);
+        }
+    }
+
+    volatile float g_Sink = 0.0f;
+}
+
+namespace Drama::Bench
+{
+    // 変換の階層の更新を 1M ノード(既定)で測る。毎フレーム 1% のノードのローカル行列を変え、
+    // 変わった部分木だけを計算し直す場合と、全ノードを計算する場合(ポインタのシーングラフを再帰でたどるもの)を比べる。
+    // 引数: --nodes=ノード数(既定1000000) --dirty=1フレームで変えるノードの割合[%](既定1) --threads=スレッド数(既定4) --frames=(既定20)
+    int RunTransformHierarchyBench(Args args)
+    {
+        const uint32_t count = static_cast<uint32_t>(std::clamp<uint64_t>(ArgU64(args, "nodes", 1000000), 1000, 1u << 24));
+        const uint32_t dirtyPercent = static_cast<uint32_t>(std::clamp<uint64_t>(ArgU64(args, "dirty", 1), 1, 100));
+        const uint32_t threads = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "threads", 4)));
+        const uint32_t frames = static_cast<uint32_t>(std::max<uint64_t>(1, ArgU64(args, "frames", 20)));
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc jobDesc{};
+        jobDesc.threadCount = threads;
+        if (!jobs.Start(jobDesc))
+        {
+            return 1;
+        }
+
+        // 1000 本の根の下に、それまでに作ったノードから親を無作為に選んでぶら下げる(深さは平均 10 段ほど)
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+        auto randomLocal = [&]()
+            {
+                return Compose(Float3{ 1, 1, 1 }, FromAxisAngle(Float3{ 0, 1, 0 }, d(rng)), Float3{ d(rng), d(rng), d(rng) });
+            };
+        std::vector<uint32_t> parents(count);
+        std::vector<Float4x4> locals(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            parents[i] = i < 1000 ? UINT32_MAX : static_cast<uint32_t>(rng() % i);
+            locals[i] = randomLocal();
+        }
+
+        TransformHierarchy hierarchy;
+        std::vector<TransformNode> nodes(count);
+        auto s = Clock::now();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            nodes[i] = hierarchy.Create(parents[i] == UINT32_MAX ? TransformNode{} : nodes[parents[i]], locals[i]);
+        }
+        const double createNs = static_cast<double>(ElapsedNs(s, Clock::now())) / count;
+        s = Clock::now();
+        hierarchy.Update(jobs);
+        const double firstUpdateMs = static_cast<double>(ElapsedNs(s, Clock::now())) / 1e6;
+        std::printf("%u nodes, %u levels | create %.1f ns/node | first update (all dirty) %.2f ms\n",
+            count, hierarchy.LevelCount(), createNs, firstUpdateMs);
+
+        // 比較用のポインタのシーングラフ(作成順を混ぜてヒープ上に散らす)
+        std::vector<std::unique_ptr<SceneNode>> sceneNodes(count);
+        {
+            std::vector<uint32_t> order(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), std::mt19937(2));
+            for (const uint32_t i : order)
+            {
+                sceneNodes[i] = std::make_unique<SceneNode>();
+                sceneNodes[i]->local = locals[i];
+            }
+        }
+        std::vector<SceneNode*> roots;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (parents[i] == UINT32_MAX)
+            {
+                roots.push_back(sceneNodes[i].get());
+            }
+            else
+            {
+                sceneNodes[parents[i]]->children.push_back(sceneNodes[i].get());
+            }
+        }
+        s = Clock::now();
+        for (uint32_t f = 0; f < frames; ++f)
+        {
+            for (SceneNode* root : roots)
+            {
+                UpdateRecursive(*root, Identity());
+            }
+            g_Sink = g_Sink + roots[0]->world.r[3].x;
+        }
+        const double recursiveMs = static_cast<double>(ElapsedNs(s, Clock::now())) / 1e6 / frames;
+
+        // 全ノードを変えた場合(根を全部変える)
+        auto allDirty = [&](bool parallel)
+            {
+                const auto start = Clock::now();
+                for (uint32_t f = 0; f < frames; ++f)
+                {
+                    for (uint32_t i = 0; i < 1000; ++i)
+                    {
+                        hierarchy.SetLocal(nodes[i], locals[i]);
+                    }
+                    parallel ? hierarchy.Update(jobs) : hierarchy.Update();
+                }
+                return static_cast<double>(ElapsedNs(start, Clock::now())) / 1e6 / frames;
+            };
+        const double allSerialMs = allDirty(false);
+        const double allParallelMs = allDirty(true);
+        std::printf("all dirty        recursive pointer graph %7.2f ms | hierarchy %7.2f ms  x%.1f | parallel(%u) %7.2f ms  x%.1f\n",
+            recursiveMs, allSerialMs, recursiveMs / allSerialMs, threads, allParallelMs, recursiveMs / allParallelMs);
+
+        // 毎フレーム dirty% のノードを変える(変えたノードの子孫も計算し直す)
+        const uint32_t dirtyCount = std::max<uint32_t>(1, static_cast<uint32_t>(static_cast<uint64_t>(count) * dirtyPercent / 100));
+        auto partial = [&](bool parallel, uint64_t& updated)
+            {
+                updated = 0;
+                uint64_t ns = 0;
+                for (uint32_t f = 0; f < frames; ++f)
+                {
+                    for (uint32_t i = 0; i < dirtyCount; ++i)
+                    {
+                        const uint32_t n = static_cast<uint32_t>(rng() % count);
+                        hierarchy.SetLocal(nodes[n], locals[n]);
+                    }
+                    const auto start = Clock::now();
+                    parallel ? hierarchy.Update(jobs) : hierarchy.Update();
+                    ns += ElapsedNs(start, Clock::now());
+                    updated += hierarchy.LastUpdatedCount();
+                }
+                updated /= frames;
+                return static_cast<double>(ns) / 1e6 / frames;
+            };
+        uint64_t updatedSerial = 0;
+        uint64_t updatedParallel = 0;
+        const double partialSerialMs = partial(false, updatedSerial);
+        const double partialParallelMs = partial(true, updatedParallel);
+        std::printf("%u%% dirty (%u)   recursive pointer graph %7.2f ms | hierarchy %7.2f ms  x%.1f | parallel(%u) %7.2f ms  x%.1f  (%llu nodes recomputed/frame)\n",
+            dirtyPercent, dirtyCount, recursiveMs, partialSerialMs, recursiveMs / partialSerialMs, threads, partialParallelMs, recursiveMs / partialParallelMs,
+            static_cast<unsigned long long>(updatedSerial));
+
+        // 付け替え(深さが変わると部分木ごと段を移す)
+        uint32_t moved = 0;
+        s = Clock::now();
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            const TransformNode node = nodes[1000 + rng() % (count - 1000)];
+            const TransformNode parent = nodes[rng() % count];
+            moved += hierarchy.SetParent(node, parent) ? 1 : 0;
+        }
+        const double reparentNs = static_cast<double>(ElapsedNs(s, Clock::now())) / std::max<uint32_t>(1, moved);
+        s = Clock::now();
+        hierarchy.Update(jobs);
+        const double afterReparentMs = static_cast<double>(ElapsedNs(s, Clock::now())) / 1e6;
+        std::printf("reparent         %u moves, %.0f ns/move | update afterwards %.2f ms (%u nodes) | levels %u\n",
+            moved, reparentNs, afterReparentMs, hierarchy.LastUpdatedCount(), hierarchy.LevelCount());
+
+        jobs.Stop();
+        return 0;
+    }
+}
@@ -0,0 +1,115 @@
+// === Benchmark includes ===
+#include "BenchCommon.h"
+
+// === Drama Engine includes ===
+#if defined(_WIN32)
+#include "Platform/include/WinFileSystem.h"
+#include "Platform/include/WinFileWatcher.h"
+#else
+#include "Platform/include/PosixFileSystem.h"
+#include "Platform/include/LinuxFileWatcher.h"
+#endif
+
+// === C++ standard library includes ===
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    struct BenchEntry
+    {
+        std::string_view name;
+        int (*func)(Drama::Bench::Args);
+    };
+
+    constexpr BenchEntry kBenches[] = {
+        { "log", &Drama::Bench::RunLogAssertBench },
+        { "mmap", &Drama::Bench::RunMappedFileBench },
+        { "asyncio", &Drama::Bench::RunAsyncFileServiceBench },
+        { "pack", &Drama::Bench::RunPackBench },
+        { "compress", &Drama::Bench::RunCompressionBench },
+        { "watch", &Drama::Bench::RunFileWatcherBench },
+        { "jobs", &Drama::Bench::RunJobSystemBench },
+        { "fiber", &Drama::Bench::RunFiberBench },
+        { "frames", &Drama::Bench::RunFramePipelineBench },
+        { "frameclock", &Drama::Bench::RunFrameClockBench },
+        { "clock", &Drama::Bench::RunClockBench },
+        { "profiler", &Drama::Bench::RunProfilerBench },
+        { "framealloc", &Drama::Bench::RunFrameAllocatorBench },
+        { "pool", &Drama::Bench::RunHandlePoolBench },
+        { "memtrack", &Drama::Bench::RunMemoryTrackerBench },
+        { "ecs", &Drama::Bench::RunEcsBench },
+        { "math", &Drama::Bench::RunMathBench },
+        { "transforms", &Drama::Bench::RunTransformHierarchyBench },
+        { "culling", &Drama::Bench::RunFrustumCullingBench },
+        { "bvh", &Drama::Bench::RunDynamicBvhBench },
+    };
+}
+
+namespace Drama::Bench
+{
+    Core::IO::IFileSystem& FileSystem()
+    {
+#if defined(_WIN32)
+        static Platform::IO::WinFileSystem fs;
+#else
+        static Platform::IO::PosixFileSystem fs;
+#endif
+        return fs;
+    }
+
+    std::unique_ptr<Core::IO::IFileWatcher> CreateFileWatcher(const Core::IO::FileWatchDesc& desc)
+    {
+#if defined(_WIN32)
+        return std::make_unique<Platform::IO::WinFileWatcher>(desc);
+#else
+        return std::make_unique<Platform::IO::LinuxFileWatcher>(desc);
+#endif
+    }
+
+    std::string TempDirectory()
+    {
+        return FileSystem().currentPath() + "/temp/bench/";
+    }
+}
+
+// 使い方: Benchmark [名前] [--key=value ...]
+// 名前を省略すると全て実行する
+int main(int argc, char** argv)
+{
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    std::string_view only;
+    if (!args.empty() && args.front().substr(0, 2) != "--")
+    {
+        only = args.front();
+        args.erase(args.begin());
+    }
+
+    Drama::Bench::FileSystem().CreateDirectories(Drama::Bench::TempDirectory());
+
+    int result = 0;
+    bool isFound = false;
+    for (const BenchEntry& e : kBenches)
+    {
+        if (!only.empty() && e.name != only)
+        {
+            continue;
+        }
+        isFound = true;
+        std::printf("=== %.*s ===\n", static_cast<int>(e.name.size()), e.name.data());
+        if (e.func(args) != 0)
+        {
+            std::printf("[%.*s] FAILED\n", static_cast<int>(e.name.size()), e.name.data());
+            result = 1;
+        }
+    }
+
+    if (!isFound)
+    {
+        std::printf("unknown benchmark: %.*s\n", static_cast<int>(only.size()), only.data());
+        return 1;
+    }
+    return result;
+}
@@ -0,0 +1,57 @@
+#pragma once
+// C++ standard library includes
+#include <span>
+#include <string>
+#include <string_view>
+#include "Core/include/IFileSystem.h"
+#include "Core/include/PackFormat.h"
+
+namespace Drama::Core::IO
+{
+    /// @brief パックファイル(PackBuilderで作成)を読み取り専用の IFileSystem として見せる
+    /// @note パック全体をマップして持ち、読み込みはそこからのコピーか部分ビューで返す(ファイルごとのopenが無い)。
+    ///       パスはパック内の相対パス。書き込み系は全て AccessDenied。
+    class ArchiveFileSystem final : public IFileSystem
+    {
+    public:
+        /// @brief パックを開く
+        /// @param fs パックファイルがある実ファイルシステム
+        FsResult Open(IFileSystem& fs, std::string_view archivePath) noexcept;
+        void Close() noexcept;
+
+        bool IsOpen() const noexcept { return m_Entries != nullptr; }
+        size_t EntryCount() const noexcept { return m_EntryCount; }
+        /// @brief パス文字列を返す(列挙用。i は 0..EntryCount-1)
+        std::string_view EntryPath(size_t i) const noexcept;
+
+        /// @brief パス→中身。無ければ空で false
+        bool Find(std::string_view path, std::span<const uint8_t>& out) const noexcept;
+
+        FsResult Exists(std::string_view path) noexcept override;
+        FsResult CreateDirectories(std::string_view path) noexcept override;
+
+        FsResult WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept override;
+        /// @brief パック内の部分ビューを返す(コピーしない)
+        /// @note 返したビューはこの ArchiveFileSystem を閉じるまで有効
+        FsResult MapReadOnly(std::string_view path, MappedFile& out) noexcept override;
+        FsResult AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult Remove(std::string_view path) noexcept override;
+        FsResult OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept override;
+        FsResult OpenWrite(std::string_view path, FileWriteMode mode, std::unique_ptr<IFileWriter>& out) noexcept override;
+        FsResult CopyAllBytes(std::string_view src, std::string_view dst) noexcept override;
+
+        /// @brief パックのパス(読み取り専用なので作業ディレクトリの概念は無い)
+        std::string currentPath() noexcept override { return m_ArchivePath; }
+
+    private:
+        const Pack::PackEntry* FindEntry(std::string_view path) const noexcept;
+
+        MappedFile m_Image;
+        std::string m_ArchivePath;
+        const Pack::PackEntry* m_Entries = nullptr;
+        size_t m_EntryCount = 0;
+        const char* m_Strings = nullptr;
+    };
+}
@@ -0,0 +1,175 @@
+#pragma once
+// C++ standard library includes
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Core/include/IFileSystem.h"
+
+namespace Drama::Core::IO
+{
+    /// @brief 要求の優先度(数値が小さいほど先に処理する)
+    enum class IoPriority : uint8_t
+    {
+        High,   ///< フレームを止めている読み込みなど
+        Normal,
+        Low,    ///< 先読み・キャッシュ保存など
+        Count,
+    };
+
+    enum class IoOp : uint8_t
+    {
+        Read,        ///< ReadAllBytes
+        Write,       ///< WriteAllBytes
+        Append,      ///< AppendAllBytes
+        WriteAtomic, ///< WriteAllBytesAtomic
+    };
+
+    enum class IoStatus : uint8_t
+    {
+        Completed, ///< IFileSystem の呼び出しが成功
+        Failed,    ///< IFileSystem の呼び出しが失敗(result に詳細)
+        Cancelled, ///< 実行前に取り消された
+    };
+
+    using IoRequestId = uint64_t;
+
+    struct IoCompletion;
+
+    /// @brief 1件の読み書き要求
+    struct IoRequest
+    {
+        IoOp op = IoOp::Read;
+        std::string path;
+        std::vector<uint8_t> data;  ///< 書き込み内容(読み込みでは空)
+        size_t sizeHint = 0;        ///< 読み込みの予想サイズ。実行中バイト数の上限判定に使う(0なら受付時にファイルサイズを調べる)
+        IoPriority priority = IoPriority::Normal;
+        uint64_t userData = 0;
+        /// @brief 完了時に DispatchCompletions を呼んだスレッドで呼ばれる
+        std::function<void(IoCompletion&)> onComplete;
+    };
+
+    /// @brief 完了通知
+    struct IoCompletion
+    {
+        IoRequestId id = 0;
+        IoOp op = IoOp::Read;
+        IoStatus status = IoStatus::Completed;
+        FsResult result{};
+        std::string path;
+        std::vector<uint8_t> data; ///< 読み込み結果(書き込みでは空)
+        uint64_t userData = 0;
+        uint64_t submitNs = 0;     ///< 受付時刻(steady_clock)
+        uint64_t startNs = 0;      ///< 実行開始時刻(取り消しでは0)
+        uint64_t endNs = 0;        ///< 完了時刻
+    };
+
+    /// @brief 非同期I/Oの設定
+    struct AsyncFileDesc
+    {
+        uint32_t workerCount = 2;                 ///< I/Oスレッド数
+        size_t maxInFlightBytes = 64 * 1024 * 1024; ///< 同時に実行中にできるバイト数の上限
+    };
+
+    /// @brief 計測用の統計
+    struct AsyncFileStats
+    {
+        size_t queued = 0;           ///< 待機中の要求数
+        size_t running = 0;          ///< 実行中の要求数
+        size_t inFlightBytes = 0;    ///< 実行中のバイト数
+        size_t peakQueued = 0;       ///< 待機数の最大
+        size_t peakInFlightBytes = 0;
+        uint64_t completed = 0;      ///< 完了通知を出した件数(取り消し含む)
+        uint64_t cancelled = 0;
+    };
+
+    /// @brief IFileSystem の呼び出しをI/Oスレッドで実行し、完了をキューで返す
+    /// @note fs は複数スレッドから同時に呼ばれる(WinFileSystem / PosixFileSystem は状態を持たないので可)。
+    ///       完了通知はメインループから DispatchCompletions で1フレームに1回取り出す想定。
+    class AsyncFileService final
+    {
+    public:
+        AsyncFileService() = default;
+        ~AsyncFileService();
+        AsyncFileService(const AsyncFileService&) = delete;
+        AsyncFileService& operator=(const AsyncFileService&) = delete;
+
+        /// @brief I/Oスレッド開始
+        /// @return 成功ならtrue
+        bool Start(IFileSystem& fs, const AsyncFileDesc& desc = {});
+        /// @brief 待機中の要求を取り消し、実行中のものを待ってからスレッド停止
+        /// @note 停止後も DispatchCompletions で残りの通知を受け取れる
+        void Stop() noexcept;
+
+        /// @brief 1件受け付ける
+        /// @return 要求ID。停止中なら0
+        IoRequestId Submit(IoRequest&& request);
+        /// @brief まとめて受け付ける(ロックと起床は1回)
+        /// @return 先頭の要求ID(以降は連番)。停止中なら0
+        IoRequestId SubmitBatch(std::vector<IoRequest>&& requests);
+
+        /// @brief 実行前なら取り消す
+        /// @return 取り消せたらtrue。実行中・完了済みならfalse
+        bool Cancel(IoRequestId id);
+
+        /// @brief 完了通知を呼び出しスレッドで処理する
+        /// @param maxCount 1回で処理する最大件数(フレーム内の処理量を抑える)
+        /// @return 処理した件数
+        size_t DispatchCompletions(size_t maxCount = SIZE_MAX);
+
+        /// @brief 待機中・実行中の要求が無くなるまで待つ
+        void WaitIdle();
+
+        AsyncFileStats Stats() const;
+        bool IsRunning() const noexcept { return m_IsRunning.load(std::memory_order_acquire); }
+
+    private:
+        struct Pending
+        {
+            IoRequestId id = 0;
+            IoRequest request;
+            uint64_t submitNs = 0;
+        };
+
+        void WorkerMain();
+        /// @brief 上限を守って次に実行する要求を取り出す(m_Mutex 保持中)
+        bool PopNext_NoLock(Pending& out, size_t& bytes);
+        void PushCompletion(IoCompletion&& completion, std::function<void(IoCompletion&)>&& callback);
+        static size_t CostOf(const IoRequest& request) noexcept;
+
+        IFileSystem* m_Fs = nullptr;
+        AsyncFileDesc m_Desc{};
+        std::vector<std::thread> m_Workers;
+        std::atomic<bool> m_IsRunning{ false };
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_WorkCv; ///< 要求追加・実行枠の解放・停止
+        std::condition_variable m_IdleCv; ///< WaitIdle 用
+        std::array<std::deque<Pending>, static_cast<size_t>(IoPriority::Count)> m_Queues;
+        bool m_IsStopRequested = false;
+        IoRequestId m_NextId = 1;
+        size_t m_Queued = 0;
+        size_t m_Running = 0;
+        size_t m_InFlightBytes = 0;
+        size_t m_PeakQueued = 0;
+        size_t m_PeakInFlightBytes = 0;
+        uint64_t m_Cancelled = 0;
+
+        struct Done
+        {
+            IoCompletion completion;
+            std::function<void(IoCompletion&)> callback;
+        };
+        mutable std::mutex m_DoneMutex;
+        std::vector<Done> m_Done;
+        std::vector<Done> m_Dispatching;
+        uint64_t m_Completed = 0;
+    };
+}
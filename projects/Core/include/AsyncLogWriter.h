@@ -0,0 +1,118 @@
+#pragma once
+// C++ standard library includes
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "Core/include/MemoryTracker.h"
+#include "Core/include/MpscRingBuffer.h"
+
+namespace Drama::Core
+{
+    /// @brief リングバッファが満杯のときの振る舞い
+    enum class LogOverflowPolicy : uint8_t
+    {
+        Drop,  ///< 破棄して件数だけ数える(呼び出し側は待たない)
+        Block, ///< 空きが出るまで呼び出し側が待つ
+    };
+
+    /// @brief PushLine の結果
+    enum class LogPushResult : uint8_t
+    {
+        Queued,  ///< 積めた
+        Dropped, ///< Drop方針で満杯だったので破棄した(件数に数える)
+        Stopped, ///< 書き込みスレッドが動いていない(呼び出し側で同期書き込みする)
+        Rejected, ///< リングバッファより大きいレコード(呼び出し側で同期書き込みする)
+    };
+
+    /// @brief 非同期ログの設定
+    struct AsyncLogDesc
+    {
+        size_t slotCount = 4096;                            ///< リングバッファのスロット数(メモリ上限 = slotCount * 256B)
+        LogOverflowPolicy overflow = LogOverflowPolicy::Drop; ///< 満杯時の方針
+        uint32_t idleWaitMs = 5;                            ///< 書き込みスレッドの最大待機時間
+        bool isFramed = false; ///< PushRecord で長さ付きレコードを積む(バッチはレコードの境目で切れ、破棄件数の行は書かない)
+    };
+
+    /// @brief 生産者からの行をリングバッファに溜め、専用スレッドでまとめて書き出す
+    class AsyncLogWriter final
+    {
+    public:
+        /// @brief バッチ書き込み先
+        /// @param data 連結済みの行(isFramed なら [u32 長さ][レコード] の並び)
+        /// @param size バイト数
+        /// @param lines 含まれる行数(isFramed ならレコード数)
+        using Sink = std::function<bool(const char* data, size_t size, size_t lines)>;
+
+        AsyncLogWriter() = default;
+        ~AsyncLogWriter();
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+        /// @brief 書き込みスレッド開始
+        /// @note 再開時、スロット数が同じならリングバッファを確保し直さず使い回す
+        /// @return 成功ならtrue
+        bool Start(const AsyncLogDesc& desc, Sink sink);
+        /// @brief 受付を止め、積みかけの生産者を待ってから残りを書き出してスレッド停止
+        void Stop() noexcept;
+
+        /// @brief 1行積む(末尾に '\n' を付ける)
+        LogPushResult PushLine(std::string_view line) noexcept;
+        /// @brief 長さ付きレコードをそのまま積む(isFramed 用)
+        /// @param data 先頭4バイトにそれ以降のバイト数(u32)を持つこと
+        LogPushResult PushRecord(const void* data, size_t size) noexcept;
+
+        /// @brief ここまでに積まれた行が書き出されるまで待つ
+        /// @return 書き込みが全て成功していればtrue
+        bool Flush() noexcept;
+
+        bool IsRunning() const noexcept { return m_IsRunning.load(std::memory_order_acquire); }
+        /// @brief 破棄された行数の累計
+        uint64_t DroppedCount() const noexcept { return m_DroppedTotal.load(std::memory_order_relaxed); }
+
+    private:
+        void ThreadMain();
+        /// @brief 生産者として入る。受け付けていなければ入らずにfalse
+        bool EnterProducer() noexcept;
+        void LeaveProducer() noexcept;
+        LogPushResult PushBytes(const void* data, size_t size) noexcept;
+        /// @brief 溜めたバイト列のうち、最後まで揃ったレコードの終わり
+        size_t CompleteFramesEnd(size_t& records) const noexcept;
+        /// @brief 取り出せるだけ取り出して1回で書く
+        /// @return 何か取り出したらtrue
+        bool DrainAndWrite();
+        void Wake() noexcept;
+        /// @brief PushLine の途中にいる生産者がいなくなるまで待つ
+        void WaitProducers() const noexcept;
+
+        MpscRingBuffer m_Ring;
+        Sink m_Sink;
+        AsyncLogDesc m_Desc{};
+        std::thread m_Thread;
+
+        std::atomic<bool> m_IsRunning{ false };
+        std::atomic<uint32_t> m_Producers{ 0 }; ///< PushLine の途中にいる生産者の数
+        std::atomic<bool> m_IsSinkOk{ true };
+        std::atomic<uint64_t> m_DroppedPending{ 0 };
+        std::atomic<uint64_t> m_DroppedTotal{ 0 };
+        std::atomic<uint64_t> m_WrittenPos{ 0 };
+
+        std::mutex m_WakeMutex;
+        std::condition_variable m_WakeCv;
+        std::condition_variable m_DoneCv;
+        bool m_IsStopRequested = false;
+        bool m_IsFlushRequested = false;
+
+        // 書き込みスレッド専用のバッチバッファ(使い回す)
+        // isFramed では途中までしか公開されていないレコードを次のバッチへ持ち越す。
+        // リングと同じくログ用として MemoryTracker に数える(m_Batch より先に作り、後で壊す)
+        Memory::TrackingMemoryResource m_BatchMemory{ Memory::MemoryTag::Log };
+        std::pmr::string m_Batch{ &m_BatchMemory };
+    };
+}
@@ -0,0 +1,176 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Core/include/LogLevel.h"
+
+namespace Drama::Core::BinaryLog
+{
+    /// @brief バイナリログの構成
+    /// @note ファイル先頭に FileHeader、以降はレコードの並び。
+    ///       書式文字列はIDで参照し、初出時にだけ FormatDef レコードとして本文を書く。
+    ///       ローテーションで分かれたファイルはそれぞれ単独で復号でき、
+    ///       FileHeader の (記録開始時刻, セグメント番号) で並べ直せる。
+    ///       引数は型タグ付きの生の値で保存し、文字列化は復号時に行う。
+    constexpr uint32_t kFileMagic = 0x42474C44; // "DLGB"
+    constexpr uint16_t kFileVersion = 1;
+
+    enum class RecordKind : uint8_t
+    {
+        FormatDef = 1, ///< id(u64) len(u32) bytes
+        Message = 2,   ///< id(u64) level(u8) timeNs(u64) argc(u8) args...
+    };
+
+    enum class ArgType : uint8_t
+    {
+        I64 = 1,
+        U64,
+        F64,
+        Bool,
+        Char,
+        String,  ///< len(u32) bytes
+        Pointer, ///< u64
+    };
+
+    /// @brief FNV-1a(64bit)。書式文字列のIDに使う
+    constexpr uint64_t HashFormat(std::string_view s) noexcept
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : s)
+        {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    /// @brief 書式文字列とそのID。IDの計算と書式の検証はコンパイル時に済ませる
+    template <class... Args>
+    struct Format
+    {
+        template <class S>
+            requires std::is_convertible_v<const S&, std::string_view>
+        consteval Format(const S& s)
+            : str(s), id(HashFormat(std::string_view(s)))
+        {
+            // 引数と書式の不一致はここでコンパイルエラーになる
+            [[maybe_unused]] std::format_string<Args...> check(s);
+        }
+
+        std::string_view str;
+        uint64_t id;
+    };
+
+    namespace Detail
+    {
+        template <class T>
+        void Put(std::vector<uint8_t>& out, const T& v)
+        {
+            const size_t at = out.size();
+            out.resize(at + sizeof(T));
+            std::memcpy(out.data() + at, &v, sizeof(T));
+        }
+
+        inline void PutString(std::vector<uint8_t>& out, std::string_view s)
+        {
+            const uint32_t len = static_cast<uint32_t>(s.size());
+            Put(out, len);
+            out.insert(out.end(), s.begin(), s.begin() + len);
+        }
+
+        template <class T>
+        void PutArg(std::vector<uint8_t>& out, const T& v)
+        {
+            using U = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<U, bool>)
+            {
+                Put(out, ArgType::Bool);
+                Put(out, static_cast<uint8_t>(v ? 1 : 0));
+            }
+            else if constexpr (std::is_same_v<U, char>)
+            {
+                Put(out, ArgType::Char);
+                Put(out, v);
+            }
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+            {
+                Put(out, ArgType::I64);
+                Put(out, static_cast<int64_t>(v));
+            }
+            else if constexpr (std::is_integral_v<U>)
+            {
+                Put(out, ArgType::U64);
+                Put(out, static_cast<uint64_t>(v));
+            }
+            else if constexpr (std::is_floating_point_v<U>)
+            {
+                Put(out, ArgType::F64);
+                Put(out, static_cast<double>(v));
+            }
+            else if constexpr (std::is_convertible_v<const U&, std::string_view>)
+            {
+                Put(out, ArgType::String);
+                PutString(out, std::string_view(v));
+            }
+            else if constexpr (std::is_pointer_v<U>)
+            {
+                Put(out, ArgType::Pointer);
+                Put(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(v)));
+            }
+            else
+            {
+                // 独自のformatterを持つ型だけはここで文字列化する
+                Put(out, ArgType::String);
+                PutString(out, std::format("{}", v));
+            }
+        }
+    }
+
+    /// @brief ファイルヘッダを追加
+    /// @param startTimeNs 記録開始時刻(system_clock, UNIXエポックからのナノ秒)
+    /// @param segment 同じ記録の中で何番目のファイルか
+    inline void AppendFileHeader(std::vector<uint8_t>& out, uint64_t startTimeNs, uint16_t segment = 0)
+    {
+        Detail::Put(out, kFileMagic);
+        Detail::Put(out, kFileVersion);
+        Detail::Put(out, segment);
+        Detail::Put(out, startTimeNs);
+    }
+
+    /// @brief ファイルヘッダを読む
+    /// @return 先頭がバイナリログのヘッダならtrue
+    bool ReadFileHeader(const uint8_t* data, size_t size, uint64_t& startTimeNs, uint16_t& segment) noexcept;
+
+    /// @brief 書式定義レコードを追加
+    inline void AppendFormatDef(std::vector<uint8_t>& out, uint64_t id, std::string_view fmt)
+    {
+        Detail::Put(out, RecordKind::FormatDef);
+        Detail::Put(out, id);
+        Detail::PutString(out, fmt);
+    }
+
+    /// @brief メッセージレコードを追加(書式化はしない)
+    /// @param timeNs 記録開始からの経過ナノ秒
+    template <class... Args>
+    void AppendMessage(std::vector<uint8_t>& out, uint64_t id, LogLevel level, uint64_t timeNs, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= 255, "too many log arguments");
+        Detail::Put(out, RecordKind::Message);
+        Detail::Put(out, id);
+        Detail::Put(out, level);
+        Detail::Put(out, timeNs);
+        Detail::Put(out, static_cast<uint8_t>(sizeof...(Args)));
+        (Detail::PutArg(out, args), ...);
+    }
+
+    /// @brief バイナリログをテキストに復号する
+    /// @param out 1レコード1行で追記される
+    /// @return 最後まで読めたらtrue。途中で壊れていた場合はそこまでを出力してfalse
+    bool DecodeToText(const uint8_t* data, size_t size, std::string& out);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/include/MathTypes.h"
+
+namespace Drama::Core::Scene
+{
+    /// @brief 境界球
+    struct BoundingSphere
+    {
+        Math::Float3 center;
+        float radius = 0.0f;
+    };
+
+    /// @brief 軸に沿った箱
+    struct Aabb
+    {
+        Math::Float3 min;
+        Math::Float3 max;
+    };
+
+    /// @brief a と b を囲む箱
+    constexpr Aabb Union(const Aabb& a, const Aabb& b) noexcept { return { Math::Min(a.min, b.min), Math::Max(a.max, b.max) }; }
+    /// @brief 表面積の半分(SAH の比較にしか使わないので 2 倍しない)
+    constexpr float HalfArea(const Aabb& a) noexcept
+    {
+        const Math::Float3 d = a.max - a.min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+    /// @brief inner が outer にすっぽり入るか
+    constexpr bool Contains(const Aabb& outer, const Aabb& inner) noexcept
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+            inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+    /// @brief 接していれば重なりとみなす
+    constexpr bool Overlaps(const Aabb& a, const Aabb& b) noexcept
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+    /// @brief 各辺を margin ずつ広げる
+    constexpr Aabb Expand(const Aabb& a, float margin) noexcept
+    {
+        return { a.min - Math::Float3{ margin, margin, margin }, a.max + Math::Float3{ margin, margin, margin } };
+    }
+}
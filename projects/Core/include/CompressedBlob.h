@@ -0,0 +1,92 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "Core/include/LzCodec.h"
+
+namespace Drama::Core::Job
+{
+    class JobSystem;
+}
+
+namespace Drama::Core::IO::Blob
+{
+    /// @brief ブロック圧縮ファイルの構成
+    /// @note [BlobHeader][圧縮ブロック...][BlockEntry × blockCount]
+    ///       ブロックは互いに独立して展開できるので、範囲読みは触れるブロックだけを展開すればよい。
+    ///       索引を末尾に置くのは、ストリーム書き込みや追記で索引の位置をずらさずにブロックを足すため。
+    ///       追記は確定済みの範囲を上書きせずに後ろへ足し、最後にヘッダを書き換えて確定する。
+    ///       途中の古いブロックや索引の残骸はヘッダの indexOffset からは辿られないので無害。
+    constexpr uint32_t kMagic = 0x5A424344; // "DCBZ"
+    /// @brief ブロック圧縮ファイルに付ける拡張子("a.bin" は "a.bin.dcbz" に置く)
+    /// @note 圧縮かどうかは中身ではなく名前で決める(たまたま "DCBZ" で始まる生のファイルを展開しないように)。
+    ///       kMagic は壊れていないかの確認にだけ使う
+    constexpr std::string_view kFileExtension = ".dcbz";
+    constexpr uint16_t kVersion = 1;
+    constexpr uint32_t kMinBlockSize = 64 * 1024;
+    constexpr uint32_t kDefaultBlockSize = 128 * 1024;
+    constexpr uint32_t kMaxBlockSize = 256 * 1024;
+
+    /// @brief 圧縮しても小さくならなかったブロックはそのまま格納する
+    constexpr uint32_t kBlockStored = 1u << 0;
+
+    struct BlobHeader
+    {
+        uint32_t magic = kMagic;
+        uint16_t version = kVersion;
+        uint16_t flags = 0;
+        uint32_t blockSize = kDefaultBlockSize; ///< 書き込み時のブロックの大きさ(最後や Flush 直後のブロックはこれより小さい)
+        uint32_t blockCount = 0;
+        uint64_t rawSize = 0;
+        uint64_t indexOffset = 0;
+    };
+    static_assert(sizeof(BlobHeader) == 32, "BlobHeader layout changed");
+
+    struct BlockEntry
+    {
+        uint64_t offset = 0;     ///< ファイル先頭からの位置
+        uint32_t storedSize = 0; ///< ファイル上のバイト数
+        uint32_t rawSize = 0;    ///< 展開後のバイト数
+        uint32_t flags = 0;
+        uint32_t reserved = 0;
+    };
+    static_assert(sizeof(BlockEntry) == 24, "BlockEntry layout changed");
+
+    /// @brief 検査済みの索引
+    struct BlobIndex
+    {
+        BlobHeader header{};
+        std::vector<BlockEntry> blocks;
+        std::vector<uint64_t> rawOffsets; ///< 各ブロックの展開後の開始位置。末尾に rawSize を足して blockCount+1 個
+    };
+
+    /// @brief 先頭がブロック圧縮ファイルのヘッダか
+    bool IsBlob(std::span<const uint8_t> head) noexcept;
+
+    /// @brief 範囲・大きさを検査して索引を作る(壊れたファイルで範囲外を読まないように)
+    bool BuildIndex(const BlobHeader& header, std::span<const BlockEntry> blocks, uint64_t fileSize, BlobIndex& out);
+
+    /// @brief 展開後の位置を含むブロック番号(rawSize 以上なら blockCount)
+    size_t FindBlock(const BlobIndex& index, uint64_t rawOffset) noexcept;
+
+    /// @brief 1ブロック圧縮する。小さくならなければそのまま格納して kBlockStored を立てる
+    void CompressBlock(const uint8_t* raw, size_t size, std::vector<uint8_t>& stored, uint32_t& flags,
+        Compression::CompressScratch& scratch);
+
+    /// @brief 1ブロック展開する(dst は entry.rawSize バイト)
+    bool DecompressBlock(const BlockEntry& entry, const uint8_t* stored, uint8_t* dst) noexcept;
+
+    /// @brief 全体を圧縮して out に書く
+    /// @param jobs ブロックを分け合うジョブシステム。nullptr か止まっていれば呼び出しスレッドだけで処理する
+    void Encode(std::span<const uint8_t> raw, uint32_t blockSize, Job::JobSystem* jobs, std::vector<uint8_t>& out);
+
+    /// @brief ファイル全体のバイト列から索引を読む
+    bool ReadIndex(std::span<const uint8_t> blob, BlobIndex& out);
+
+    /// @brief 全ブロックを展開する(dst は index.header.rawSize バイト)
+    /// @param jobs ブロックを分け合うジョブシステム。nullptr か止まっていれば呼び出しスレッドだけで処理する
+    bool Decode(std::span<const uint8_t> blob, const BlobIndex& index, uint8_t* dst, Job::JobSystem* jobs);
+}
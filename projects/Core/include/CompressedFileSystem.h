@@ -0,0 +1,69 @@
+#pragma once
+// C++ standard library includes
+#include <functional>
+#include <span>
+#include <string>
+#include "Core/include/CompressedBlob.h"
+#include "Core/include/IFileSystem.h"
+
+namespace Drama::Core::IO
+{
+    struct CompressionDesc
+    {
+        uint32_t blockSize = Blob::kDefaultBlockSize; ///< 64KB〜256KB に丸める
+        Job::JobSystem* jobSystem = nullptr;          ///< 大きなファイルの圧縮・展開を分け合う先(nullptrなら呼び出しスレッドだけ)
+        uint64_t parallelThreshold = 1024 * 1024;     ///< 展開後がこれ以上ならジョブに分ける(分ける手間の方が高くつかない大きさ)
+        /// @brief 圧縮して書くパスか(空なら全て)。ログのように細かく追記するものは外しておく
+        std::function<bool(std::string_view)> filter;
+    };
+
+    /// @brief 書き込みをブロック圧縮し、読み込みで透過的に展開する IFileSystem のデコレータ
+    /// @note 圧縮したファイルは下の IFileSystem に "パス + Blob::kFileExtension" で置き、読み込みはそれがあれば展開、
+    ///       無ければ元のパスをそのまま返す。圧縮前に書かれたファイルや filter で外したファイルも同じように読め、
+    ///       生のファイルの中身が偶然ヘッダに見えても取り違えない。書き込むともう一方の形式のファイルは消す。
+    ///       OpenRead の ReadAt は触れるブロックだけを展開する。MapReadOnly は展開したコピーになる。
+    ///       圧縮したファイルへの追記は最後の半端なブロックだけを作り直し、確定済みの範囲は上書きしない。
+    ///       書き込みストリームの WriteAt はまだ書き出していない最後のブロックの範囲だけ書き換えられる。
+    class CompressedFileSystem final : public IFileSystem
+    {
+    public:
+        explicit CompressedFileSystem(IFileSystem& inner, CompressionDesc desc = {});
+
+        FsResult Exists(std::string_view path) noexcept override;
+        FsResult CreateDirectories(std::string_view path) noexcept override;
+        FsResult Remove(std::string_view path) noexcept override;
+
+        FsResult WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept override;
+        FsResult MapReadOnly(std::string_view path, MappedFile& out) noexcept override;
+        FsResult AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept override;
+        FsResult OpenWrite(std::string_view path, FileWriteMode mode, std::unique_ptr<IFileWriter>& out) noexcept override;
+        /// @brief 格納形式のままコピーする(展開・再圧縮しない)
+        FsResult CopyAllBytes(std::string_view srcPath, std::string_view dstPath) noexcept override;
+
+        std::string currentPath() noexcept override { return m_Inner.currentPath(); }
+
+        const CompressionDesc& Desc() const noexcept { return m_Desc; }
+
+    private:
+        bool ShouldCompress(std::string_view path) const;
+        /// @brief 圧縮したファイルの置き場所
+        static std::string StoredPath(std::string_view path);
+        /// @brief もう一方の形式のファイルを消す(無いのは成功)
+        FsResult RemoveStale(std::string_view path) noexcept;
+        /// @brief 展開後の大きさに応じて分け合う先(小さければ nullptr)
+        Job::JobSystem* JobsFor(uint64_t rawSize) const noexcept;
+        /// @brief 格納形式のバイト列を展開する
+        FsResult Decode(std::span<const uint8_t> stored, std::vector<uint8_t>& out) noexcept;
+        /// @brief 残骸を除いて詰め直す(置き換えは原子的)
+        FsResult Compact(const std::string& stored) noexcept;
+        /// @brief 既存の圧縮ファイルの続きから書くストリームを作る
+        FsResult ResumeAppend(const std::string& stored, std::unique_ptr<IFileReader> existing,
+            std::unique_ptr<IFileWriter>& out) noexcept;
+
+        IFileSystem& m_Inner;
+        CompressionDesc m_Desc;
+    };
+}
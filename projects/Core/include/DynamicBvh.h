@@ -0,0 +1,228 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Core/include/Bounds.h"
+
+namespace Drama::Core::Job
+{
+    class JobSystem;
+}
+
+namespace Drama::Core::Scene
+{
+    /// @brief DynamicAabbTree に入れた物のハンドル(generation が 0 なら無効)
+    struct BvhProxy
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        constexpr bool IsValid() const noexcept { return generation != 0; }
+        friend constexpr bool operator==(BvhProxy a, BvhProxy b) noexcept { return a.index == b.index && a.generation == b.generation; }
+    };
+
+    /// @brief DynamicAabbTree の設定
+    struct DynamicAabbTreeDesc
+    {
+        float margin = 0.1f; ///< 葉の箱を各辺この分だけ広げて持つ(少し動いただけなら木を組み替えない)
+    };
+
+    /// @brief 物の出し入れと移動に追従する2分木の AABB 木
+    /// @note 足すときは SAH(表面積の増え方)で兄弟を選び、親をたどって箱を直しながら、
+    ///       子と孫を入れ替えると表面積が減る所では回転する。葉の箱は margin だけ太らせて持ち、
+    ///       その中で動く間は Move しても木を触らない。多くの物が毎フレーム動く場合は SetBounds でまとめて箱を変え、
+    ///       Refit で変わった所の祖先だけを直す。問い合わせを大量に行う場合は WideBvh に写してから使う。
+    ///       ハンドルの番号は葉の節点の番号で、回転や作り直しでは変わらない。スレッドセーフではない
+    class DynamicAabbTree
+    {
+    public:
+        explicit DynamicAabbTree(const DynamicAabbTreeDesc& desc = {}) noexcept : m_Margin(desc.margin) {}
+        DynamicAabbTree(const DynamicAabbTree&) = delete;
+        DynamicAabbTree& operator=(const DynamicAabbTree&) = delete;
+
+        /// @brief 物を足す
+        /// @param userData 問い合わせで返す値
+        BvhProxy Create(const Aabb& box, uint32_t userData);
+        /// @return 破棄済みなら false
+        bool Destroy(BvhProxy proxy);
+        bool IsAlive(BvhProxy proxy) const noexcept;
+
+        /// @brief 箱を変える。太らせた箱からはみ出したときだけ木から抜いて入れ直す
+        /// @return 入れ直したら true(破棄済みでも false)
+        bool Move(BvhProxy proxy, const Aabb& box);
+        /// @brief 木の形を変えずに箱だけを変え、次の Refit で祖先の箱を直す(太らせない)
+        /// @return 破棄済みなら false
+        bool SetBounds(BvhProxy proxy, const Aabb& box) noexcept;
+        /// @brief SetBounds で変えた葉の祖先の箱を直す(変わっていない部分木は触らない)
+        /// @param rotate true なら直した節点で回転も試す
+        void Refit(bool rotate = true);
+        /// @brief 内側の節点をすべて捨て、葉から上から下へ SAH で作り直す(ハンドルはそのまま)
+        void Rebuild();
+        void Clear() noexcept;
+
+        /// @return 破棄済みなら nullptr
+        const Aabb* Bounds(BvhProxy proxy) const noexcept;
+        /// @return 破棄済みなら nullptr
+        const Aabb* FatBounds(BvhProxy proxy) const noexcept;
+        /// @return 破棄済みなら UINT32_MAX
+        uint32_t UserData(BvhProxy proxy) const noexcept;
+
+        /// @brief box と重なる物ごとに fn(userData, proxy) を呼ぶ(太らせた箱で判定する)。fn が false を返したら打ち切る
+        template <class F>
+        void QueryOverlap(const Aabb& box, F&& fn) const
+        {
+            if (m_Root == kNone)
+            {
+                return;
+            }
+            m_QueryStack.clear();
+            m_QueryStack.push_back(m_Root);
+            while (!m_QueryStack.empty())
+            {
+                const uint32_t index = m_QueryStack.back();
+                m_QueryStack.pop_back();
+                const Node& node = m_Nodes[index];
+                if (!Overlaps(node.box, box))
+                {
+                    continue;
+                }
+                if (node.child1 == kNone)
+                {
+                    if (!fn(node.userData, BvhProxy{ index, node.generation }))
+                    {
+                        return;
+                    }
+                    continue;
+                }
+                m_QueryStack.push_back(node.child1);
+                m_QueryStack.push_back(node.child2);
+            }
+        }
+
+        uint32_t LeafCount() const noexcept { return m_LeafCount; }
+        /// @brief 根の高さ(葉だけなら 0、空なら 0)
+        uint32_t Height() const noexcept;
+        /// @brief 内側の節点の表面積の合計 / 根の表面積(SAH の目安。小さいほど問い合わせが速い)
+        float AreaRatio() const noexcept;
+        /// @brief 親子の対応、高さ、箱の包含が正しいか(テスト用。節点数に比例して遅い)
+        bool Validate() const;
+
+    private:
+        friend class WideBvh;
+
+        static constexpr uint32_t kNone = UINT32_MAX;
+
+        struct Node
+        {
+            Aabb box;                  ///< 葉は太らせた箱、内側は子の箱を囲む箱
+            Aabb tight;                ///< 葉の実際の箱
+            uint32_t parent = kNone;   ///< 空きなら次の空き
+            uint32_t child1 = kNone;   ///< 葉なら kNone
+            uint32_t child2 = kNone;
+            uint32_t userData = 0;
+            uint32_t generation = 1;
+            uint16_t height = 0;
+            bool allocated = false;
+            bool dirty = false;        ///< Refit で箱を直す
+        };
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t index) noexcept;
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf) noexcept;
+        /// @brief index から根まで箱と高さを直し、回転を試す
+        void RefitAncestors(uint32_t index) noexcept;
+        /// @brief index の子と孫を入れ替えて表面積が減るなら入れ替える
+        void Rotate(uint32_t index) noexcept;
+        void UpdateNode(uint32_t index) noexcept;
+        const Node* Resolve(BvhProxy proxy) const noexcept;
+
+        std::vector<Node> m_Nodes;
+        uint32_t m_Root = kNone;
+        uint32_t m_FreeList = kNone;
+        uint32_t m_LeafCount = 0;
+        float m_Margin;
+        std::vector<uint32_t> m_DirtyLeaves;
+        std::vector<uint32_t> m_Scratch;
+        mutable std::vector<uint32_t> m_QueryStack;
+    };
+
+    /// @brief 光線(direction は正規化しなくてよい。t は direction の長さを単位にした距離)
+    struct Ray
+    {
+        Math::Float3 origin;
+        Math::Float3 direction;
+        float maxT = 3.4e38f;
+    };
+
+    /// @brief 光線が最初に入る箱
+    struct RayHit
+    {
+        uint32_t item = UINT32_MAX; ///< userData(当たらなければ UINT32_MAX)
+        float t = 0.0f;             ///< 箱に入る位置(始点が箱の中なら 0)
+
+        constexpr bool IsHit() const noexcept { return item != UINT32_MAX; }
+    };
+
+    /// @brief 点に一番近い箱
+    struct NearestHit
+    {
+        uint32_t item = UINT32_MAX; ///< userData(範囲内に無ければ UINT32_MAX)
+        float distanceSq = 0.0f;    ///< 箱までの距離の2乗(点が箱の中なら 0)
+
+        constexpr bool IsHit() const noexcept { return item != UINT32_MAX; }
+    };
+
+    /// @brief 問い合わせ用の4分木(DynamicAabbTree を写したもの)
+    /// @note 1つの節点に4つの子の箱を SoA で持ち、4つまとめて SIMD で判定する。節点は深さ優先の順に並べる。
+    ///       葉の箱は太らせていない実際の箱、内側の箱はそれを囲む箱にする。
+    ///       Build の後に元の木を変えても追従しないので、フレームに1回など、問い合わせの前に作り直す。
+    ///       Build 以外は const で、複数のスレッドから同時に問い合わせてよい
+    class WideBvh
+    {
+    public:
+        /// @brief tree を写す(前の内容は捨てる。容量は使い回す)
+        void Build(const DynamicAabbTree& tree);
+        void Clear() noexcept;
+
+        /// @brief 光線が最初に入る箱
+        RayHit Raycast(const Ray& ray) const;
+        /// @brief box と重なる物の userData を out の後ろに足す
+        /// @return 足した個数
+        uint32_t Overlap(const Aabb& box, std::vector<uint32_t>& out) const;
+        /// @brief point に一番近い箱(maxDistance より遠いものは無視する)
+        NearestHit Nearest(Math::Float3 point, float maxDistance = 3.4e38f) const;
+
+        // まとめて問い合わせる。jobs が nullptr なら呼び出したスレッドだけで行う
+        /// @param hits rays と同じ長さ
+        void RaycastBatch(std::span<const Ray> rays, std::span<RayHit> hits, Job::JobSystem* jobs = nullptr) const;
+        /// @param hits points と同じ長さ
+        void NearestBatch(std::span<const Math::Float3> points, float maxDistance, std::span<NearestHit> hits, Job::JobSystem* jobs = nullptr) const;
+        /// @brief 問い合わせ q の結果を items[offsets[q], offsets[q + 1]) に書く
+        void OverlapBatch(std::span<const Aabb> boxes, std::vector<uint32_t>& offsets, std::vector<uint32_t>& items, Job::JobSystem* jobs = nullptr) const;
+
+        uint32_t NodeCount() const noexcept { return static_cast<uint32_t>(m_Nodes.size()); }
+        uint32_t LeafCount() const noexcept { return static_cast<uint32_t>(m_Items.size()); }
+        /// @brief 根から一番深い節点までの段数
+        uint32_t Depth() const noexcept { return m_Depth; }
+
+    private:
+        static constexpr uint32_t kEmpty = UINT32_MAX;     ///< 使っていない子
+        static constexpr uint32_t kLeafBit = 0x80000000u;  ///< 立っていれば下位が m_Items の番号
+        /// @brief まとめて問い合わせるときの1ジョブ分
+        static constexpr uint32_t kBatchGrain = 64;
+
+        struct alignas(16) Node
+        {
+            float minX[4], minY[4], minZ[4];
+            float maxX[4], maxY[4], maxZ[4];
+            uint32_t child[4];
+        };
+
+        std::vector<Node> m_Nodes;
+        std::vector<uint32_t> m_Items; ///< 葉の userData
+        uint32_t m_Depth = 0;          ///< 辿るときの積み荷の大きさを決める
+    };
+}
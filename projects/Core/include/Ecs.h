@@ -0,0 +1,450 @@
+#pragma once
+// C++ standard library includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Core/include/FrameAllocator.h"
+#include "Core/include/JobSystem.h"
+
+namespace Drama::Core::Ecs
+{
+    constexpr uint32_t kMaxComponentTypes = 64;       ///< 登録できるコンポーネントの型の数(マスクが 64bit)
+    constexpr uint32_t kInvalidComponent = kMaxComponentTypes;
+    constexpr size_t kChunkSize = 16 * 1024;          ///< 1チャンクの大きさ(同じアーキタイプのエンティティをこの単位で並べる)
+    using ComponentMask = uint64_t;
+
+    /// @brief エンティティ(番号と世代)
+    /// @note 世代 0 は無効。破棄すると番号の世代が進むので、古いハンドルは IsAlive で弾ける
+    struct Entity
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        constexpr bool IsValid() const noexcept { return generation != 0; }
+        friend constexpr bool operator==(Entity a, Entity b) noexcept { return a.index == b.index && a.generation == b.generation; }
+    };
+
+    /// @brief コンポーネントの型の情報(チャンク間の移動と破棄に使う)
+    struct ComponentTypeInfo
+    {
+        size_t size = 0;
+        size_t align = 0;
+        void (*relocate)(void* dst, void* src) noexcept = nullptr; ///< src から dst へ移して src を破棄する(nullptr なら memcpy で足りる)
+        void (*destroy)(void* p) noexcept = nullptr;               ///< nullptr なら破棄は不要
+    };
+
+    namespace Detail
+    {
+        /// @brief 型を登録して番号を振る
+        /// @return 上限を超えたら kInvalidComponent
+        uint32_t RegisterComponentType(const ComponentTypeInfo& info) noexcept;
+
+        template <class T>
+        ComponentTypeInfo MakeTypeInfo() noexcept
+        {
+            static_assert(std::is_nothrow_move_constructible_v<T>, "components are moved between chunks and must not throw");
+            ComponentTypeInfo info{};
+            info.size = sizeof(T);
+            info.align = alignof(T);
+            if constexpr (!std::is_trivially_copyable_v<T>)
+            {
+                info.relocate = [](void* dst, void* src) noexcept
+                    {
+                        ::new (dst) T(std::move(*static_cast<T*>(src)));
+                        static_cast<T*>(src)->~T();
+                    };
+            }
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                info.destroy = [](void* p) noexcept { static_cast<T*>(p)->~T(); };
+            }
+            return info;
+        }
+    }
+
+    /// @brief 番号の型の情報
+    const ComponentTypeInfo& ComponentType(uint32_t id) noexcept;
+
+    namespace Detail
+    {
+        template <class T>
+        uint32_t TypeIdOf() noexcept
+        {
+            static const uint32_t id = RegisterComponentType(MakeTypeInfo<T>());
+            return id;
+        }
+    }
+
+    /// @brief 型の番号(初めて使ったときに振る。const と参照の有無は同じ型として数える)
+    template <class T>
+    uint32_t ComponentTypeId() noexcept
+    {
+        return Detail::TypeIdOf<std::remove_cvref_t<T>>();
+    }
+
+    /// @brief 型の組のマスク
+    /// @return 登録できなかった型が含まれていれば 0
+    template <class... Ts>
+    ComponentMask MaskOf() noexcept
+    {
+        ComponentMask mask = 0;
+        bool valid = true;
+        ((valid = valid && ComponentTypeId<Ts>() != kInvalidComponent,
+          mask |= valid ? (ComponentMask{ 1 } << ComponentTypeId<Ts>()) : 0), ...);
+        return valid ? mask : 0;
+    }
+
+    /// @brief 同じコンポーネントの組を持つエンティティの集まり
+    /// @note 16KB のチャンクに、エンティティの配列とコンポーネントごとの配列を並べて置く(SoA)。
+    ///       末尾のチャンク以外は常に満杯で、抜けた穴には末尾のエンティティを詰める
+    class Archetype final
+    {
+    public:
+        ComponentMask Mask() const noexcept { return m_Mask; }
+        uint32_t ChunkCapacity() const noexcept { return m_Capacity; }
+        size_t ChunkCount() const noexcept { return m_Chunks.size(); }
+        uint32_t EntityCount() const noexcept { return m_EntityCount; }
+
+    private:
+        friend class World;
+
+        struct Chunk
+        {
+            std::byte* data = nullptr;
+            uint32_t count = 0;
+        };
+
+        Entity* Entities(const Chunk& chunk) const noexcept { return reinterpret_cast<Entity*>(chunk.data); }
+        void* Component(const Chunk& chunk, uint32_t id, uint32_t row) const noexcept
+        {
+            return chunk.data + m_Offsets[id] + static_cast<size_t>(row) * ComponentType(id).size;
+        }
+
+        ComponentMask m_Mask = 0;
+        uint32_t m_Capacity = 0;                            ///< 1チャンクのエンティティ数
+        std::vector<uint32_t> m_Components;                 ///< 番号の昇順
+        std::array<uint32_t, kMaxComponentTypes> m_Offsets{}; ///< チャンク先頭からの配列の位置(持つ型だけ有効)
+        std::vector<Chunk> m_Chunks;
+        uint32_t m_EntityCount = 0;
+        std::array<Archetype*, kMaxComponentTypes> m_AddEdges{};    ///< 型を1つ足した先(使ったときに覚える)
+        std::array<Archetype*, kMaxComponentTypes> m_RemoveEdges{}; ///< 型を1つ外した先
+    };
+
+    /// @brief 構造の変更(作成・破棄・型の追加と削除)を貯めておき、World::Playback でまとめて反映する
+    /// @note クエリで回している間やシステムの並列実行中は World の構造を変えられないので、こちらに積む。
+    ///       1つのバッファは1スレッドから使う(並列ジョブからはジョブごとに別のバッファを使う)。
+    ///       積んだ値はバッファ内のブロックに置かれ、Playback でチャンクへ移される
+    class CommandBuffer final
+    {
+    public:
+        explicit CommandBuffer(size_t blockSize = 16 * 1024) noexcept;
+        ~CommandBuffer();
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        /// @brief コンポーネントを持ったエンティティを作る
+        template <class... Ts>
+        void Create(Ts&&... components)
+        {
+            Payload* payloads = m_Arena.AllocateArray<Payload>(sizeof...(Ts));
+            if (!payloads)
+            {
+                return;
+            }
+            uint32_t i = 0;
+            ((payloads[i++] = Payload{ ComponentTypeId<Ts>(), Store(std::forward<Ts>(components)) }), ...);
+            m_Commands.push_back(Command{ Op::Create, kInvalidComponent, static_cast<uint32_t>(sizeof...(Ts)), {}, payloads });
+        }
+        /// @brief エンティティを破棄する
+        void Destroy(Entity entity);
+        /// @brief コンポーネントを足す(既にあれば値を置き換える)
+        template <class T>
+        void Add(Entity entity, T&& value)
+        {
+            m_Commands.push_back(Command{ Op::Add, ComponentTypeId<T>(), 1, entity, Store(std::forward<T>(value)) });
+        }
+        /// @brief コンポーネントを外す
+        template <class T>
+        void Remove(Entity entity)
+        {
+            m_Commands.push_back(Command{ Op::Remove, ComponentTypeId<T>(), 0, entity, nullptr });
+        }
+
+        bool Empty() const noexcept { return m_Commands.empty(); }
+        size_t Size() const noexcept { return m_Commands.size(); }
+        /// @brief 反映せずに捨てる(積んだ値は破棄する)
+        void Clear() noexcept;
+
+    private:
+        friend class World;
+
+        enum class Op : uint8_t
+        {
+            Create,
+            Destroy,
+            Add,
+            Remove,
+        };
+        struct Payload
+        {
+            uint32_t component;
+            void* data; ///< 確保できなければ nullptr(その型は付かない)
+        };
+        struct Command
+        {
+            Op op;
+            uint32_t component; ///< Add / Remove の型
+            uint32_t count;     ///< Create の型の数
+            Entity entity;
+            void* payload;      ///< Create なら Payload[count]、Add なら値
+        };
+
+        template <class T>
+        void* Store(T&& value)
+        {
+            using U = std::decay_t<T>;
+            void* p = m_Arena.Allocate(sizeof(U), alignof(U));
+            if (p)
+            {
+                ::new (p) U(std::forward<T>(value));
+            }
+            return p;
+        }
+        /// @brief 反映済みとして空にする(値はチャンクへ移したので破棄しない)
+        void Consumed() noexcept;
+
+        std::vector<Command> m_Commands;
+        Memory::LinearArena m_Arena;
+    };
+
+    /// @brief エンティティとコンポーネントの置き場
+    /// @note コンポーネントはアーキタイプ(型の組)ごとに 16KB のチャンクへ SoA で詰めて置く。
+    ///       クエリはチャンクごとに型ごとの連続した配列(span)を渡すので、1個ずつヒープに置いたオブジェクトを
+    ///       ポインタで辿るのと違い、頭から順に舐めればキャッシュとプリフェッチがよく効く。
+    ///       構造の変更(Create / Destroy / Add / Remove)はエンティティをチャンク間で移すので、
+    ///       それまでに得たポインタと span は使えなくなる。構造の変更は1スレッドから行い、
+    ///       クエリ中や並列実行中は CommandBuffer に積んで後から Playback する。
+    ///       クエリ(ForEach 系)と Get は、構造を変えない限り複数のスレッドから同時に呼べる
+    class World final
+    {
+    public:
+        World() noexcept = default;
+        ~World();
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        /// @brief コンポーネントを持ったエンティティを作る(同じ型を2つ渡さないこと)
+        /// @return 型が登録できないかメモリが無ければ無効なエンティティ
+        template <class... Ts>
+        Entity Create(Ts&&... components)
+        {
+            const ComponentMask mask = MaskOf<std::decay_t<Ts>...>();
+            if (mask == 0 && sizeof...(Ts) != 0)
+            {
+                return {};
+            }
+            Entity entity{};
+            Archetype* archetype = nullptr;
+            const Archetype::Chunk* chunk = nullptr;
+            uint32_t row = 0;
+            if (!CreateEntity(mask, entity, archetype, chunk, row))
+            {
+                return {};
+            }
+            ((::new (archetype->Component(*chunk, ComponentTypeId<Ts>(), row)) std::decay_t<Ts>(std::forward<Ts>(components))), ...);
+            return entity;
+        }
+        /// @brief エンティティを破棄する
+        /// @return 破棄済みなら false
+        bool Destroy(Entity entity) noexcept;
+        bool IsAlive(Entity entity) const noexcept
+        {
+            return entity.index < m_Entities.size() && entity.IsValid() && m_Entities[entity.index].generation == entity.generation;
+        }
+
+        /// @brief コンポーネントを足す(既にあれば値を置き換える)
+        /// @return 破棄済みかメモリが無ければ false
+        template <class T>
+        bool Add(Entity entity, T&& value)
+        {
+            using U = std::decay_t<T>;
+            bool existed = false;
+            void* p = AddComponent(entity, ComponentTypeId<U>(), existed);
+            if (!p)
+            {
+                return false;
+            }
+            if (existed)
+            {
+                *static_cast<U*>(p) = std::forward<T>(value);
+            }
+            else
+            {
+                ::new (p) U(std::forward<T>(value));
+            }
+            return true;
+        }
+        /// @brief コンポーネントを外す
+        /// @return 持っていなければ false
+        template <class T>
+        bool Remove(Entity entity) noexcept
+        {
+            return RemoveComponent(entity, ComponentTypeId<T>());
+        }
+        /// @brief コンポーネント(持っていなければ nullptr)
+        template <class T>
+        T* Get(Entity entity) noexcept
+        {
+            return static_cast<T*>(GetComponent(entity, ComponentTypeId<T>()));
+        }
+        template <class T>
+        const T* Get(Entity entity) const noexcept
+        {
+            return static_cast<const T*>(GetComponent(entity, ComponentTypeId<T>()));
+        }
+        template <class T>
+        bool Has(Entity entity) const noexcept
+        {
+            return GetComponent(entity, ComponentTypeId<T>()) != nullptr;
+        }
+
+        /// @brief Ts をすべて持つエンティティをチャンクごとに回る fn(std::span<const Entity>, std::span<Ts>...)
+        /// @note const を付けた型は読むだけの意味で const の span になる
+        template <class... Ts, class F>
+        void ForEachChunk(F&& fn)
+        {
+            const ComponentMask mask = MaskOf<Ts...>();
+            if (mask == 0 && sizeof...(Ts) != 0)
+            {
+                return;
+            }
+            const std::array<uint32_t, sizeof...(Ts)> ids{ ComponentTypeId<Ts>()... };
+            for (Archetype* archetype : m_Archetypes)
+            {
+                if ((archetype->m_Mask & mask) != mask)
+                {
+                    continue;
+                }
+                for (const Archetype::Chunk& chunk : archetype->m_Chunks)
+                {
+                    InvokeChunk<Ts...>(fn, *archetype, chunk, ids, std::index_sequence_for<Ts...>{});
+                }
+            }
+        }
+
+        /// @brief Ts をすべて持つエンティティを1つずつ回る fn(Ts&...) または fn(Entity, Ts&...)
+        template <class... Ts, class F>
+        void ForEach(F&& fn)
+        {
+            ForEachChunk<Ts...>([&fn](std::span<const Entity> entities, std::span<Ts>... columns)
+                {
+                    for (size_t i = 0; i < entities.size(); ++i)
+                    {
+                        if constexpr (std::is_invocable_v<F&, Entity, Ts&...>)
+                        {
+                            fn(entities[i], columns[i]...);
+                        }
+                        else
+                        {
+                            fn(columns[i]...);
+                        }
+                    }
+                });
+        }
+
+        /// @brief ForEachChunk をチャンク単位でジョブに分けて並列に回し、終わるまで待つ
+        /// @note fn は複数のスレッドから同時に呼ばれる。構造の変更はジョブごとの CommandBuffer に積むこと
+        template <class... Ts, class F>
+        void ParallelForEachChunk(Job::JobSystem& jobs, F&& fn)
+        {
+            const ComponentMask mask = MaskOf<Ts...>();
+            if (mask == 0 && sizeof...(Ts) != 0)
+            {
+                return;
+            }
+            struct ChunkRef
+            {
+                const Archetype* archetype;
+                const Archetype::Chunk* chunk;
+            };
+            std::vector<ChunkRef> chunks;
+            for (Archetype* archetype : m_Archetypes)
+            {
+                if ((archetype->m_Mask & mask) == mask)
+                {
+                    for (const Archetype::Chunk& chunk : archetype->m_Chunks)
+                    {
+                        chunks.push_back(ChunkRef{ archetype, &chunk });
+                    }
+                }
+            }
+            const std::array<uint32_t, sizeof...(Ts)> ids{ ComponentTypeId<Ts>()... };
+            jobs.ParallelFor(chunks.size(), [&](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        InvokeChunk<Ts...>(fn, *chunks[i].archetype, *chunks[i].chunk, ids, std::index_sequence_for<Ts...>{});
+                    }
+                });
+        }
+
+        /// @brief 積んだ構造の変更を積んだ順に反映し、バッファを空にする(破棄済みのエンティティへの変更は捨てる)
+        void Playback(CommandBuffer& commands);
+
+        /// @brief すべてのエンティティを破棄する(チャンクは次に使うまで残す)
+        void Clear() noexcept;
+
+        uint32_t EntityCount() const noexcept { return m_Alive; }
+        size_t ArchetypeCount() const noexcept { return m_Archetypes.size(); }
+        /// @brief 使用中のチャンク数
+        size_t ChunkCount() const noexcept;
+
+    private:
+        struct EntityRecord
+        {
+            Archetype* archetype = nullptr;
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+            uint32_t generation = 1;
+        };
+
+        template <class... Ts, class F, size_t... I>
+        static void InvokeChunk(F& fn, const Archetype& archetype, const Archetype::Chunk& chunk,
+            const std::array<uint32_t, sizeof...(Ts)>& ids, std::index_sequence<I...>)
+        {
+            fn(std::span<const Entity>(archetype.Entities(chunk), chunk.count),
+                std::span<Ts>(reinterpret_cast<Ts*>(chunk.data + archetype.m_Offsets[ids[I]]), chunk.count)...);
+        }
+
+        bool CreateEntity(ComponentMask mask, Entity& entity, Archetype*& archetype, const Archetype::Chunk*& chunk, uint32_t& row);
+        void* AddComponent(Entity entity, uint32_t id, bool& existed);
+        bool RemoveComponent(Entity entity, uint32_t id) noexcept;
+        void* GetComponent(Entity entity, uint32_t id) const noexcept;
+
+        Archetype* FindOrCreateArchetype(ComponentMask mask);
+        /// @brief 末尾に行を足して entity を置く(コンポーネントは未構築)
+        bool AppendRow(Archetype& archetype, Entity entity);
+        /// @brief 別のアーキタイプへ移す(共通の型は移し、無くなる型は破棄する。足した型は未構築)
+        bool MoveEntity(EntityRecord& record, Entity entity, Archetype& to);
+        /// @brief 行を抜いて末尾のエンティティで埋める(抜く行のコンポーネントは処理済みであること)
+        void RemoveRow(Archetype& archetype, uint32_t chunk, uint32_t row) noexcept;
+        void DestroyComponents(const Archetype& archetype, const Archetype::Chunk& chunk, uint32_t row) noexcept;
+        std::byte* AllocateChunk();
+        void FreeChunk(std::byte* data) noexcept;
+
+        std::vector<EntityRecord> m_Entities;  ///< 番号で引く
+        std::vector<uint32_t> m_FreeEntities;  ///< 破棄した番号(後入れ先出しで使い回す)
+        uint32_t m_Alive = 0;
+        std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_ArchetypeMap;
+        std::vector<Archetype*> m_Archetypes;  ///< クエリで舐める順(作った順)
+        std::vector<std::byte*> m_FreeChunks;  ///< 空いたチャンク(アーキタイプをまたいで使い回す)
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Drama::Core::Job
+{
+    /// @brief ユーザーモードの実行文脈(ファイバー)
+    /// @note Windows は Fiber API、x86-64 の POSIX はレジスタ退避だけの自前の切り替え、
+    ///       それ以外の POSIX は ucontext を使う。切り替えはスレッドをまたいでよい(別スレッドで再開できる)。
+    ///       entry は戻ってはいけない(最後は別のファイバーへ切り替えたまま放置する)。
+    class Fiber final
+    {
+    public:
+        using Entry = void (*)(void* arg);
+
+        Fiber() noexcept;
+        ~Fiber();
+        Fiber(const Fiber&) = delete;
+        Fiber& operator=(const Fiber&) = delete;
+
+        /// @brief 呼び出しスレッド自身を、切り替え元・先にできるファイバーにする
+        bool InitFromThread() noexcept;
+        /// @brief InitFromThread の後始末(同じスレッドで、そのファイバーの上から呼ぶ)
+        void ReleaseFromThread() noexcept;
+
+        /// @brief 新しいファイバーを作る
+        /// @param stack スタック領域(低位アドレス)。Windows では使わず OS が確保する
+        /// @param stackSize スタックの大きさ(Windows では予約サイズ)
+        bool Create(Entry entry, void* arg, void* stack, size_t stackSize) noexcept;
+
+        /// @brief 実行中の from から to へ切り替える(to が切り替え返してくるまで戻らない)
+        static void Switch(Fiber& from, Fiber& to) noexcept;
+
+        bool IsValid() const noexcept { return m_Handle != nullptr; }
+        bool IsThreadFiber() const noexcept { return m_IsThread; }
+
+    private:
+        /// @brief ucontext を使う環境の切り替え文脈(それ以外の環境では空)
+        struct Context;
+
+        static void Start(Fiber* self) noexcept;
+
+        void* m_Handle = nullptr; ///< Windows: ファイバーハンドル / x86-64: 退避したスタックポインタ / ucontext: m_Context の ucontext_t
+        std::unique_ptr<Context> m_Context;
+        Entry m_Entry = nullptr;
+        void* m_Arg = nullptr;
+        bool m_IsThread = false;
+        bool m_IsConverted = false; ///< InitFromThread でスレッドを変換した(戻す必要がある)
+    };
+
+    /// @brief 同じ大きさのスタックを持つファイバーを前もって作っておく置き場
+    /// @note POSIX ではスタックをまとめて1回で予約し、各スタックの下端に保護ページを置く
+    ///       (あふれたらその場で落ちる)。物理メモリは触ったページにしか割り当たらない。
+    class FiberPool final
+    {
+    public:
+        FiberPool() = default;
+        ~FiberPool();
+        FiberPool(const FiberPool&) = delete;
+        FiberPool& operator=(const FiberPool&) = delete;
+
+        /// @brief count 個のファイバーを作る(どれも entry(arg) から始まる)
+        bool Init(uint32_t count, size_t stackSize, Fiber::Entry entry, void* arg);
+        /// @brief 全ファイバーとスタックを解放する(実行中のものが無いこと)
+        void Shutdown() noexcept;
+
+        /// @brief 空いているファイバーを1つ取る。無ければ nullptr
+        Fiber* Acquire() noexcept;
+        void Release(Fiber* fiber) noexcept;
+
+        uint32_t Capacity() const noexcept { return static_cast<uint32_t>(m_Fibers.size()); }
+        uint32_t Available() const noexcept;
+        size_t StackSize() const noexcept { return m_StackSize; }
+
+    private:
+        std::vector<std::unique_ptr<Fiber>> m_Fibers;
+        mutable std::mutex m_Mutex;
+        std::vector<Fiber*> m_Free;
+        void* m_Stacks = nullptr;   ///< POSIX: 全スタックの予約領域
+        size_t m_StacksBytes = 0;
+        size_t m_StackSize = 0;
+    };
+}
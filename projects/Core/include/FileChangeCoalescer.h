@@ -0,0 +1,39 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Core/include/IFileWatcher.h"
+
+namespace Drama::Core::IO
+{
+    /// @brief OSから届いた生の通知をパスごとにまとめ、静かになったものから確定させる
+    /// @note エディタの保存は「一時ファイルに書いて置き換える」「消してから作る」など複数の通知になるので、
+    ///       同じパスの通知は1件に畳む(Added→Removed は無かったことに、Removed→Added は Modified に)。
+    ///       時刻は呼び出し側が渡す(テストで時間を進められるように)。スレッドセーフではない。
+    class FileChangeCoalescer final
+    {
+    public:
+        void Push(std::string_view path, FileChangeKind kind, uint64_t nowNs);
+
+        /// @brief 最後の通知から debounceNs 以上たったものを out に追加する(パス順)
+        /// @return 追加した件数
+        size_t Drain(uint64_t nowNs, uint64_t debounceNs, std::vector<FileChange>& out);
+
+        size_t PendingCount() const noexcept { return m_Pending.size(); }
+        void Clear() noexcept { m_Pending.clear(); }
+
+    private:
+        struct Pending
+        {
+            FileChangeKind kind = FileChangeKind::Modified;
+            uint64_t lastNs = 0;
+        };
+
+        std::unordered_map<std::string, Pending> m_Pending;
+        uint64_t m_OldestNs = UINT64_MAX; ///< 一番古い通知の時刻(まだ確定しないなら走査しない)
+        std::vector<std::string> m_Ready;
+    };
+}
@@ -0,0 +1,43 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+#include "Core/include/IFileWatcher.h"
+
+namespace Drama::Core::IO
+{
+    using FileChangeHandler = std::function<void(std::span<const FileChange>)>;
+
+    /// @brief 1フレーム分の変更を、パスの前方一致で購読者ごとに1回ずつまとめて渡す
+    /// @note 再読み込みする側は「自分の関係するファイルが変わった」ことだけ分かればよいので、
+    ///       ファイルごとに登録させず、ディレクトリやファイルのパスの前方一致で購読させる。
+    ///       Rescan は購読パスを含むディレクトリのものも渡す。
+    class FileChangeDispatcher final
+    {
+    public:
+        /// @brief 購読する。prefix は監視を登録したときと同じ書き方で、区切りは '/'
+        /// @return 購読ID(0は使わない)
+        uint32_t Subscribe(std::string prefix, FileChangeHandler handler);
+        void Unsubscribe(uint32_t id) noexcept;
+
+        /// @brief 変更を配る(ハンドラの中で Subscribe/Unsubscribe しないこと)
+        void Dispatch(std::span<const FileChange> changes);
+
+        size_t SubscriberCount() const noexcept { return m_Subscribers.size(); }
+
+    private:
+        struct Subscriber
+        {
+            uint32_t id = 0;
+            std::string prefix;
+            FileChangeHandler handler;
+        };
+
+        std::vector<Subscriber> m_Subscribers;
+        std::vector<FileChange> m_Batch;
+        uint32_t m_NextId = 1;
+    };
+}
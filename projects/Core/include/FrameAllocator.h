@@ -0,0 +1,186 @@
+#pragma once
+// C++ standard library includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/include/MemoryTracker.h"
+
+namespace Drama::Core::Memory
+{
+    /// @brief 先頭から順に切り出すだけの確保器(個別の解放は無く、Reset でまとめて戻す)
+    /// @note ブロックが尽きたら次のブロックへ進む。Reset してもブロックは手放さないので、
+    ///       2周目以降は前回の使用量まではヒープを触らない。スレッドセーフではない
+    class LinearArena final
+    {
+    public:
+        /// @param blockSize 1ブロックの大きさ(これより大きい要求は専用のブロックを確保する)
+        /// @param tag ブロックを MemoryTracker に記録するときの用途
+        explicit LinearArena(size_t blockSize = 64 * 1024, MemoryTag tag = MemoryTag::Frame) noexcept;
+        ~LinearArena();
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        /// @brief size バイトを align 境界で切り出す
+        /// @param align 2 の累乗
+        /// @return 確保できなければ nullptr
+        void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) noexcept
+        {
+            const uintptr_t p = (m_Cursor + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+            if (p < m_End && size <= m_End - p)
+            {
+                m_Cursor = p + size;
+                return reinterpret_cast<void*>(p);
+            }
+            return AllocateSlow(size, align);
+        }
+
+        /// @brief 型付きで count 個分を切り出す(コンストラクタは呼ばない)
+        template <class T>
+        T* AllocateArray(size_t count) noexcept
+        {
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /// @brief すべて解放したことにして先頭のブロックへ戻る(ブロックは残す)
+        void Reset() noexcept;
+        /// @brief 確保したブロックをすべて返す
+        void Release() noexcept;
+
+        /// @brief 切り出し済みのバイト数(境界合わせとブロック末尾の余りを含む)
+        size_t UsedBytes() const noexcept;
+        /// @brief ヒープから確保しているバイト数
+        size_t ReservedBytes() const noexcept { return m_Reserved; }
+        /// @brief Reset までに使った最大バイト数
+        size_t PeakBytes() const noexcept;
+        /// @brief ブロックを新たに確保した回数
+        uint64_t BlockAllocations() const noexcept { return m_BlockAllocations; }
+
+    private:
+        struct Block
+        {
+            Block* next;
+            size_t size; ///< ヘッダを除いた大きさ
+            std::byte* Data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+        };
+
+        void* AllocateSlow(size_t size, size_t align) noexcept;
+        void Enter(Block* block) noexcept;
+
+        Block* m_Head = nullptr;
+        Block* m_Current = nullptr;
+        uintptr_t m_Cursor = 0;
+        uintptr_t m_End = 0;
+        size_t m_BlockSize;
+        MemoryTag m_Tag;
+        size_t m_UsedBefore = 0;     ///< m_Current より前のブロックで使った分
+        size_t m_Reserved = 0;
+        size_t m_Peak = 0;
+        uint64_t m_BlockAllocations = 0;
+    };
+
+    /// @brief フレーム用確保器の設定
+    struct FrameAllocatorDesc
+    {
+        size_t blockSize = 256 * 1024; ///< スレッドごとの確保器の1ブロック
+        uint32_t maxThreads = 64;      ///< 専用の確保器を持てるスレッド数(超えたスレッドはロック付きの共有確保器を使う)
+    };
+
+    /// @brief フレームの使用量
+    struct FrameAllocatorStats
+    {
+        size_t usedBytes = 0;          ///< 使用中のバイト数
+        size_t reservedBytes = 0;      ///< ヒープから確保しているバイト数
+        size_t peakBytes = 0;          ///< 1フレームで使った最大バイト数
+        uint64_t blockAllocations = 0; ///< ブロックを新たに確保した回数(落ち着けば増えなくなる)
+        uint32_t threads = 0;          ///< 使ったスレッド数
+    };
+
+    /// @brief フレームの間だけ使う一時メモリ
+    /// @note 同時に処理中のフレームの数(BufferingCount)だけ枠を持ち、フレーム f は枠 f % 枠数 を使う。
+    ///       枠の中はスレッドごとの LinearArena に分かれているので、ジョブのワーカーはロック無しで確保できる。
+    ///       解放は個別に行わず、そのフレームが描画まで終わってから Reset で枠ごと戻す。
+    ///       Reset(f) は枠を共有する前のフレーム(f - 枠数)を使うスレッドがもう無いときに呼ぶ
+    ///       (FramePipeline::BeginUpdate が返った直後なら満たされる)。
+    ///       確保したメモリのデストラクタは呼ばれないので、置けるのはトリビアルに破棄できるものか、
+    ///       FrameMemoryResource を使うコンテナのようにフレーム内で破棄が済むものに限る
+    class FrameAllocator final
+    {
+    public:
+        FrameAllocator() noexcept;
+        ~FrameAllocator();
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        /// @brief 初期化
+        /// @param frameSlots 同時に処理中のフレームの数(1 以上)
+        /// @return 成功ならtrue
+        bool Init(uint32_t frameSlots, const FrameAllocatorDesc& desc = {});
+        /// @brief すべての枠を解放する
+        void Shutdown() noexcept;
+
+        /// @brief フレーム frameIndex の一時メモリを確保する(どのスレッドからでもよい)
+        /// @return 確保できなければ nullptr
+        void* Allocate(uint64_t frameIndex, size_t size, size_t align = alignof(std::max_align_t)) noexcept;
+        /// @brief 型付きで count 個分を確保する(コンストラクタは呼ばない)
+        template <class T>
+        T* AllocateArray(uint64_t frameIndex, size_t count) noexcept
+        {
+            return static_cast<T*>(Allocate(frameIndex, sizeof(T) * count, alignof(T)));
+        }
+
+        /// @brief フレーム frameIndex の枠を空にする(同じ枠を使っていた前のフレームの分がまとめて戻る)
+        void Reset(uint64_t frameIndex) noexcept;
+
+        /// @brief フレーム frameIndex の枠の使用量(Reset と同じく、その枠を使うスレッドが無いときに呼ぶ)
+        FrameAllocatorStats Stats(uint64_t frameIndex) const;
+        uint32_t SlotCount() const noexcept { return static_cast<uint32_t>(m_Slots.size()); }
+
+    private:
+        /// @brief 1スレッド分。隣のスレッドとキャッシュラインを共有しないよう離す
+        struct alignas(64) ThreadArena
+        {
+            explicit ThreadArena(size_t blockSize) noexcept : arena(blockSize) {}
+            LinearArena arena;
+        };
+        struct Slot
+        {
+            std::vector<std::unique_ptr<ThreadArena>> threads; ///< スレッド番号で引く(Init で全部作る)
+            std::mutex sharedMutex;
+            std::unique_ptr<LinearArena> shared;               ///< maxThreads を超えたスレッド用
+        };
+
+        uint32_t ThreadIndex() noexcept;
+
+        std::vector<std::unique_ptr<Slot>> m_Slots;
+        uint32_t m_MaxThreads = 0;
+        uint64_t m_Id = 0;                        ///< スレッドローカルの覚えを他の確保器と区別する
+        std::mutex m_ThreadMutex;
+        std::vector<std::thread::id> m_ThreadIds; ///< 番号を振ったスレッド(添字が番号)
+    };
+
+    /// @brief FrameAllocator のあるフレームを std::pmr のコンテナから使うための窓口
+    /// @note deallocate は何もしない(フレームの Reset でまとめて戻る)。
+    ///       コンテナはそのフレームが終わるまでに破棄すること
+    class FrameMemoryResource final : public std::pmr::memory_resource
+    {
+    public:
+        FrameMemoryResource(FrameAllocator& allocator, uint64_t frameIndex) noexcept
+            : m_Allocator(&allocator), m_FrameIndex(frameIndex)
+        {
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        FrameAllocator* m_Allocator;
+        uint64_t m_FrameIndex;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+// C++ standard library includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Drama::Core::Frame
+{
+    constexpr uint32_t kMaxFrameSlots = 4; ///< 用意できるスナップショットの最大数
+
+    /// @brief 単調に増える値で進み具合を知らせるフェンス(ID3D12Fence と同じ考え方の CPU 版)
+    /// @note Signal するのは1スレッドだけにする。Cancel 後の Wait は値に届かなくても false で戻る
+    class FrameFence final
+    {
+    public:
+        FrameFence() = default;
+        FrameFence(const FrameFence&) = delete;
+        FrameFence& operator=(const FrameFence&) = delete;
+
+        /// @brief 完了した値
+        uint64_t Completed() const noexcept { return m_Value.load(std::memory_order_acquire) & ~kCancelBit; }
+        /// @brief 値を進めて待っているスレッドを起こす(値は前より大きいこと)
+        void Signal(uint64_t value) noexcept;
+        /// @brief 値が value 以上になるまで待つ
+        /// @return 届いたらtrue、Cancel されたらfalse
+        bool Wait(uint64_t value) const noexcept;
+        /// @brief 待っているスレッドをすべて起こし、以後の Wait を止める
+        void Cancel() noexcept;
+        bool IsCancelled() const noexcept { return (m_Value.load(std::memory_order_acquire) & kCancelBit) != 0; }
+        /// @brief 0 に戻す(待っているスレッドが無いときに呼ぶ)
+        void Reset() noexcept { m_Value.store(0, std::memory_order_release); }
+
+    private:
+        // 取り消しも値の変化として見せないと atomic::wait が起きないので、最上位ビットに同居させる
+        static constexpr uint64_t kCancelBit = 1ull << 63;
+        std::atomic<uint64_t> m_Value{ 0 };
+    };
+
+    /// @brief 更新(Update)と描画(Render)を別スレッドで1フレームずらして重ねるための受け渡し
+    /// @note Update はフレーム f のスナップショットを slot[f % slotCount] に書いて公開し、Render はそれを
+    ///       読み取り専用で受け取る。Update は slotCount フレーム前の描画が終わるまで同じ枠を書けないので、
+    ///       描画の遅れは最大 slotCount - 1 フレームに抑えられる。slotCount = 1 なら交互に動く(重ならない)。
+    ///       枠の中身はフレームをまたいで使い回すので、Snapshot のコンテナは容量を残したまま書き直すとよい。
+    ///       Update 側・Render 側はそれぞれ1スレッドから呼ぶ
+    template <class Snapshot>
+    class FramePipeline final
+    {
+    public:
+        FramePipeline() = default;
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        /// @brief 枠数を決めて最初のフレームからやり直す(両側とも止まっているときに呼ぶ)
+        /// @return slotCount が 1..kMaxFrameSlots ならtrue
+        bool Init(uint32_t slotCount) noexcept
+        {
+            if (slotCount == 0 || slotCount > kMaxFrameSlots)
+            {
+                return false;
+            }
+            m_SlotCount = slotCount;
+            m_Updated.Reset();
+            m_Rendered.Reset();
+            m_UpdateFrame = 0;
+            m_RenderFrame = 0;
+            return true;
+        }
+
+        /// @brief 次のフレームの枠を取る(描画中の枠なら空くまで待つ)
+        /// @return 書き込む枠。Stop 済みなら nullptr
+        Snapshot* BeginUpdate() noexcept
+        {
+            const uint64_t frame = m_UpdateFrame;
+            if (frame >= m_SlotCount && !m_Rendered.Wait(frame - m_SlotCount + 1))
+            {
+                return nullptr;
+            }
+            return &m_Slots[frame % m_SlotCount];
+        }
+        /// @brief BeginUpdate で取った枠を公開する
+        void EndUpdate() noexcept
+        {
+            m_Updated.Signal(++m_UpdateFrame);
+        }
+
+        /// @brief 公開された次のフレームを受け取る(まだなら公開されるまで待つ)
+        /// @return 読み取る枠。Stop 後に公開済みの分を取り尽くしたら nullptr
+        const Snapshot* BeginRender() noexcept
+        {
+            const uint64_t frame = m_RenderFrame;
+            if (m_Updated.Completed() <= frame && !m_Updated.Wait(frame + 1))
+            {
+                return nullptr;
+            }
+            return &m_Slots[frame % m_SlotCount];
+        }
+        /// @brief BeginRender で受け取った枠を返す(Update がその枠を再び書けるようになる)
+        void EndRender() noexcept
+        {
+            m_Rendered.Signal(++m_RenderFrame);
+        }
+
+        /// @brief 両側の待ちを解く。以後 BeginUpdate は nullptr、BeginRender は公開済みの分だけ返す
+        void Stop() noexcept
+        {
+            m_Updated.Cancel();
+            m_Rendered.Cancel();
+        }
+
+        uint32_t SlotCount() const noexcept { return m_SlotCount; }
+        /// @brief 公開したフレーム数
+        uint64_t UpdatedFrames() const noexcept { return m_Updated.Completed(); }
+        /// @brief 描画し終えたフレーム数
+        uint64_t RenderedFrames() const noexcept { return m_Rendered.Completed(); }
+
+    private:
+        std::array<Snapshot, kMaxFrameSlots> m_Slots{};
+        uint32_t m_SlotCount = 1;
+        FrameFence m_Updated;        ///< 公開したフレーム数(Update 側が進める)
+        FrameFence m_Rendered;       ///< 描画し終えたフレーム数(Render 側が進める)
+        uint64_t m_UpdateFrame = 0;  ///< Update 側だけが触る
+        uint64_t m_RenderFrame = 0;  ///< Render 側だけが触る
+    };
+}
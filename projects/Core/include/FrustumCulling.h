@@ -0,0 +1,113 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Core/include/Bounds.h"
+#include "Core/include/MathBatch.h"
+
+namespace Drama::Core::Job
+{
+    class JobSystem;
+}
+
+namespace Drama::Core::Scene
+{
+    /// @brief 視錐台(6枚の平面。xyz は内向きの単位法線、w は距離。dot(n, p) + w >= 0 が内側)
+    struct Frustum
+    {
+        Math::Float4 planes[6];
+    };
+
+    /// @brief ビュー射影行列(行ベクトル。クリップ空間の z は 0〜1)から視錐台を作る
+    Frustum FrustumFromMatrix(const Math::Float4x4& viewProjection) noexcept;
+
+    /// @brief カリングする物の境界(球と AABB)を SoA で並べたもの
+    /// @note 番号は描画要求などの番号と揃えて使う。配列は8の倍数まで、決して見えない詰め物で伸ばしてあるので、
+    ///       カーネルは端数を気にせず8個ずつ読める
+    class CullingSet
+    {
+    public:
+        /// @brief 配列の長さはこの倍数にそろえる
+        static constexpr uint32_t kPadding = 8;
+
+        /// @brief 末尾に足す
+        /// @return 番号
+        uint32_t Add(const BoundingSphere& sphere, const Aabb& box);
+        /// @brief 箱を囲む球を使って足す
+        uint32_t Add(const Aabb& box);
+        /// @brief 範囲外の番号なら false
+        bool Set(uint32_t index, const BoundingSphere& sphere, const Aabb& box) noexcept;
+        void Clear() noexcept;
+        void Reserve(uint32_t count);
+
+        uint32_t Size() const noexcept { return m_Count; }
+        /// @brief 詰め物を含めた長さ(8の倍数)
+        uint32_t PaddedSize() const noexcept { return static_cast<uint32_t>(m_Radius.size()); }
+
+        // カーネル用の SoA 列(長さは PaddedSize)
+        Math::ConstFloat3Stream SphereCenters() const noexcept { return { m_SphereX.data(), m_SphereY.data(), m_SphereZ.data() }; }
+        const float* SphereRadii() const noexcept { return m_Radius.data(); }
+        Math::ConstFloat3Stream BoxCenters() const noexcept { return { m_BoxX.data(), m_BoxY.data(), m_BoxZ.data() }; }
+        Math::ConstFloat3Stream BoxExtents() const noexcept { return { m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() }; }
+
+    private:
+        void Write(uint32_t index, const BoundingSphere& sphere, const Aabb& box) noexcept;
+
+        std::vector<float> m_SphereX, m_SphereY, m_SphereZ, m_Radius;
+        std::vector<float> m_BoxX, m_BoxY, m_BoxZ;          ///< 箱の中心
+        std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ; ///< 箱の半分の大きさ
+        uint32_t m_Count = 0;
+    };
+
+    /// @brief set の [begin, end) のうち視錐台にかかるものの番号を、昇順で out に詰めて書く
+    /// @param end 8の倍数でなくてもよい(PaddedSize まで)。out には end - begin 個分の場所が要る
+    /// @return 書いた個数
+    using CullFunction = uint32_t(*)(const Frustum& frustum, const CullingSet& set, uint32_t begin, uint32_t end, uint32_t* out) noexcept;
+
+    /// @brief level の実装(この実行ファイルと CPU で使えなければ nullptr)
+    /// @note 球の判定と AABB の判定の両方を通ったものを見えるとする。Scalar は他の実装の正解として使う
+    CullFunction CullFunctionFor(Math::SimdLevel level) noexcept;
+    /// @brief この CPU で使える一番速い実装の種類(ビルド設定より上の AVX2 も CPU を見て選ぶ)
+    Math::SimdLevel BestCullLevel() noexcept;
+
+    /// @brief 見える物の番号の一覧をフレームの枠ごとに作る
+    /// @note フレーム f の結果は枠 f % 枠数 に書く(FrameAllocator と同じく、枠数は同時に処理中のフレームの数)。
+    ///       物をチャンクに分けてジョブで判定し、チャンクごとの結果を前に詰めて1本の昇順の一覧にする。
+    ///       同じ枠を使う前のフレームを誰も読んでいないときに Cull を呼ぶこと
+    class VisibilityCuller
+    {
+    public:
+        /// @brief 初期化
+        /// @param frameSlots 同時に処理中のフレームの数(1 以上)
+        /// @param level 使う実装(使えなければ false)
+        /// @return 成功ならtrue
+        bool Init(uint32_t frameSlots, Math::SimdLevel level = BestCullLevel());
+
+        /// @brief フレーム frameIndex の見える番号を作る
+        /// @param jobs nullptr なら呼び出したスレッドだけで判定する
+        /// @return 作った一覧(次に同じ枠へ Cull するまで有効)
+        std::span<const uint32_t> Cull(uint64_t frameIndex, const Frustum& frustum, const CullingSet& set, Job::JobSystem* jobs = nullptr);
+        /// @brief Cull で作ったフレーム frameIndex の一覧
+        std::span<const uint32_t> Visible(uint64_t frameIndex) const noexcept;
+
+        Math::SimdLevel Level() const noexcept { return m_Level; }
+        uint32_t SlotCount() const noexcept { return static_cast<uint32_t>(m_Slots.size()); }
+
+    private:
+        /// @brief 1ジョブで判定する物の数(8の倍数)
+        static constexpr uint32_t kChunkSize = 4096;
+
+        struct Slot
+        {
+            std::vector<uint32_t> indices; ///< 長さは判定した物の数。前から count 個が結果
+            uint32_t count = 0;
+        };
+
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_ChunkCounts;
+        CullFunction m_Cull = nullptr;
+        Math::SimdLevel m_Level = Math::SimdLevel::Scalar;
+    };
+}
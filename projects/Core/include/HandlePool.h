@@ -0,0 +1,117 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Core/include/SlabAllocator.h"
+
+namespace Drama::Core::Memory
+{
+    /// @brief 型付きのハンドル(別の型のプールのハンドルと取り違えないため)
+    template <class T>
+    struct PoolHandle
+    {
+        SlabHandle handle;
+
+        constexpr bool IsValid() const noexcept { return handle.IsValid(); }
+        constexpr uint64_t Value() const noexcept { return handle.value; }
+        friend constexpr bool operator==(PoolHandle a, PoolHandle b) noexcept { return a.handle == b.handle; }
+    };
+
+    /// @brief プールの設定
+    struct HandlePoolDesc
+    {
+        uint32_t objectsPerSlab = 1024; ///< 1回に確保するオブジェクト数(2 の累乗に切り上げる)
+        uint32_t maxObjects = 65536;    ///< 上限(SlabHandle::kMaxBlocks 以下)
+        MemoryTag tag = MemoryTag::Pool; ///< MemoryTracker に記録するときの用途
+    };
+
+    /// @brief T をスラブに詰めて置き、世代付きのハンドルで参照するプール
+    /// @note unique_ptr で1個ずつヒープに置く代わりに使う。オブジェクトはスラブの中で連続して並ぶので
+    ///       ForEach で頭から舐めるとキャッシュに乗りやすい。Create / Destroy はどのスレッドからもロック無しで呼べる。
+    ///       ハンドルは解放後に引くと nullptr になる(ポインタと違い、使い終わったものを安全に見分けられる)。
+    ///       Get で得たポインタは、そのハンドルを Destroy するまでしか使えない
+    template <class T>
+    class HandlePool final
+    {
+    public:
+        using Handle = PoolHandle<T>;
+
+        HandlePool() noexcept = default;
+        ~HandlePool()
+        {
+            Shutdown();
+        }
+        HandlePool(const HandlePool&) = delete;
+        HandlePool& operator=(const HandlePool&) = delete;
+
+        /// @brief 初期化
+        /// @return 成功ならtrue
+        bool Init(const HandlePoolDesc& desc = {})
+        {
+            Shutdown();
+            SlabDesc slab{};
+            slab.blockSize = sizeof(T);
+            slab.blockAlign = alignof(T);
+            slab.blocksPerSlab = desc.objectsPerSlab;
+            slab.maxBlocks = desc.maxObjects;
+            slab.tag = desc.tag;
+            return m_Slab.Init(slab);
+        }
+
+        /// @brief 生きているオブジェクトを破棄してスラブを返す
+        void Shutdown() noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                m_Slab.ForEach([](SlabHandle, void* p) { static_cast<T*>(p)->~T(); });
+            }
+            m_Slab.Shutdown();
+        }
+
+        /// @brief オブジェクトを作る
+        /// @return 上限に達したら無効なハンドル
+        template <class... Args>
+        Handle Create(Args&&... args)
+        {
+            void* block = nullptr;
+            const SlabHandle h = m_Slab.Allocate(&block);
+            if (!h.IsValid())
+            {
+                return {};
+            }
+            ::new (block) T(std::forward<Args>(args)...);
+            return Handle{ h };
+        }
+
+        /// @brief オブジェクトを破棄する
+        /// @return 古いハンドルや二重解放なら false
+        bool Destroy(Handle h) noexcept
+        {
+            return m_Slab.Free(h.handle, [](void* p) { static_cast<T*>(p)->~T(); });
+        }
+
+        /// @brief ハンドルのオブジェクト(破棄済みなら nullptr)
+        T* Get(Handle h) noexcept { return static_cast<T*>(m_Slab.Resolve(h.handle)); }
+        const T* Get(Handle h) const noexcept { return static_cast<const T*>(m_Slab.Resolve(h.handle)); }
+        /// @brief ハンドルがまだ生きているか
+        bool IsAlive(Handle h) const noexcept { return m_Slab.Resolve(h.handle) != nullptr; }
+
+        /// @brief 生きているオブジェクトを並び順に回る fn(Handle, T&)
+        /// @note Create / Destroy と同時には呼ばないこと
+        template <class F>
+        void ForEach(F&& fn)
+        {
+            m_Slab.ForEach([&fn](SlabHandle h, void* p) { fn(Handle{ h }, *static_cast<T*>(p)); });
+        }
+
+        /// @brief 生きているオブジェクト数(呼ぶたびに数える)
+        uint32_t Size() const noexcept { return m_Slab.LiveCount(); }
+        uint32_t Capacity() const noexcept { return m_Slab.Capacity(); }
+
+    private:
+        SlabAllocator m_Slab;
+    };
+}
@@ -1,9 +1,13 @@
 #pragma once
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <system_error>
+#include <utility>
+#include "Core/include/MappedFile.h"
 
 namespace Drama::Core::IO
 {
@@ -28,6 +32,60 @@ namespace Drama::Core::IO
         static FsResult Ok() noexcept { return {}; }
     };
 
+    /// @brief ベクタ書き込みの1要素
+    struct WriteSlice
+    {
+        const void* data = nullptr;
+        size_t size = 0;
+    };
+
+    /// @brief 書き込みストリームの開き方
+    enum class FileWriteMode : uint8_t
+    {
+        Truncate, ///< 無ければ作り、あれば空にする
+        Append,   ///< 無ければ作り、末尾から書く
+    };
+
+    /// @brief 読み込みストリーム。バッファは呼び出し側が用意するので、ファイルの大きさに関係なくメモリは一定
+    struct IFileReader
+    {
+        virtual ~IFileReader() = default;
+
+        /// @brief 現在位置から読み、読めた分だけ位置を進める
+        /// @param bytesRead 読めたバイト数。sizeより小さければEOFに達した
+        virtual FsResult Read(void* buffer, size_t size, size_t& bytesRead) noexcept = 0;
+        /// @brief 位置を指定して読む(現在位置は変えない)
+        virtual FsResult ReadAt(uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept = 0;
+
+        /// @brief 現在位置を変える(末尾より後ろも可。そこからのReadは0バイト)
+        virtual FsResult Seek(uint64_t offset) noexcept = 0;
+        virtual uint64_t Tell() const noexcept = 0;
+        virtual FsResult Size(uint64_t& out) noexcept = 0;
+    };
+
+    /// @brief 書き込みストリーム
+    struct IFileWriter
+    {
+        virtual ~IFileWriter() = default;
+
+        /// @brief 現在位置に書き、位置を進める
+        virtual FsResult Write(const void* data, size_t size) noexcept = 0;
+        /// @brief 複数のバッファを順に書く(連結用の一時バッファを作らない)
+        virtual FsResult WriteV(std::span<const WriteSlice> slices) noexcept = 0;
+        /// @brief 位置を指定して書く(現在位置は変えない。ヘッダの後書きなど)
+        virtual FsResult WriteAt(uint64_t offset, const void* data, size_t size) noexcept = 0;
+
+        virtual FsResult Seek(uint64_t offset) noexcept = 0;
+        virtual uint64_t Tell() const noexcept = 0;
+        virtual FsResult Size(uint64_t& out) noexcept = 0;
+
+        /// @brief ディスクまで書き出す(fsync / FlushFileBuffers)
+        virtual FsResult Flush() noexcept = 0;
+        /// @brief 書き終えて閉じる(2回目以降は何もしない。閉じた後の書き込みは失敗する)
+        /// @note デストラクタも閉じるが失敗を返せないので、結果が要るならこちらを呼ぶ
+        virtual FsResult Close() noexcept = 0;
+    };
+
     struct IFileSystem
     {
         virtual ~IFileSystem() = default;
@@ -39,10 +97,96 @@ namespace Drama::Core::IO
         virtual FsResult WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept = 0;
         /// @brief 読み取り
         virtual FsResult ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept = 0;
+        /// @brief 読み取り専用でマップする(コピーしない)
+        /// @note 既定は ReadAllBytes で読んだバッファを渡す。マップできる実装は上書きする
+        virtual FsResult MapReadOnly(std::string_view path, MappedFile& out) noexcept
+        {
+            out.Reset();
+            std::vector<uint8_t> bytes;
+            if (FsResult r = ReadAllBytes(path, bytes); !r)
+            {
+                return r;
+            }
+            out = MappedFile::FromBytes(std::move(bytes));
+            return FsResult::Ok();
+        }
         /// @brief 追記
         virtual FsResult AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept = 0;
         /// @brief 安全な保存
         virtual FsResult WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept = 0;
+        /// @brief ファイルを消す(無ければ NotFound)
+        /// @note 既定は消せない(AccessDenied)。書き込める実装は上書きする
+        virtual FsResult Remove(std::string_view path) noexcept
+        {
+            (void)path;
+            FsResult r;
+            r.error = FsError::AccessDenied;
+            r.message = "Remove is not supported.";
+            return r;
+        }
+
+        /// @brief 読み込みストリームを開く
+        virtual FsResult OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept = 0;
+        /// @brief 書き込みストリームを開く
+        virtual FsResult OpenWrite(std::string_view path, FileWriteMode mode, std::unique_ptr<IFileWriter>& out) noexcept = 0;
+
+        /// @brief ファイルサイズ
+        /// @note 既定は開いて Size を取る。開かずに調べられる実装は上書きする
+        virtual FsResult FileSize(std::string_view path, uint64_t& out) noexcept
+        {
+            out = 0;
+            std::unique_ptr<IFileReader> reader;
+            if (FsResult r = OpenRead(path, reader); !r)
+            {
+                return r;
+            }
+            return reader->Size(out);
+        }
+
+        /// @brief 最終更新時刻(ナノ秒。起点は実装ごとに決まるので、同じファイルシステムの中の比較にだけ使う)
+        /// @note 既定は調べられない(AccessDenied)。調べられる実装は上書きする
+        virtual FsResult LastWriteTime(std::string_view path, uint64_t& outNs) noexcept
+        {
+            (void)path;
+            outNs = 0;
+            FsResult r;
+            r.error = FsError::AccessDenied;
+            r.message = "LastWriteTime is not supported.";
+            return r;
+        }
+
+        /// @brief ファイル丸ごとのコピー(dstは上書き)
+        /// @note 既定は固定サイズのバッファでストリームコピーする。カーネル内でコピーできる実装は上書きする
+        virtual FsResult CopyAllBytes(std::string_view src, std::string_view dst) noexcept
+        {
+            std::unique_ptr<IFileReader> reader;
+            if (FsResult r = OpenRead(src, reader); !r)
+            {
+                return r;
+            }
+            std::unique_ptr<IFileWriter> writer;
+            if (FsResult r = OpenWrite(dst, FileWriteMode::Truncate, writer); !r)
+            {
+                return r;
+            }
+            std::vector<uint8_t> buffer(1024 * 1024);
+            while (true)
+            {
+                size_t n = 0;
+                if (FsResult r = reader->Read(buffer.data(), buffer.size(), n); !r)
+                {
+                    return r;
+                }
+                if (n == 0)
+                {
+                    return FsResult::Ok();
+                }
+                if (FsResult r = writer->Write(buffer.data(), n); !r)
+                {
+                    return r;
+                }
+            }
+        }
 
         virtual std::string currentPath() noexcept = 0;
     };
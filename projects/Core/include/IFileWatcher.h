@@ -0,0 +1,51 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Core/include/IFileSystem.h"
+
+namespace Drama::Core::IO
+{
+    enum class FileChangeKind : uint8_t
+    {
+        Added,
+        Modified,
+        Removed,
+        /// @brief OS側の通知があふれた。path 以下は何が変わったか分からないので読み直すこと
+        Rescan,
+    };
+
+    struct FileChange
+    {
+        std::string path; ///< 監視を登録したディレクトリ + '/' 区切りの相対パス
+        FileChangeKind kind = FileChangeKind::Modified;
+    };
+
+    using FileWatchId = uint32_t;
+    constexpr FileWatchId kInvalidFileWatchId = 0;
+
+    struct FileWatchDesc
+    {
+        /// @brief 最後の通知からこの時間だけ静かになったら確定させる(保存中の書きかけを拾わない)
+        uint32_t debounceMs = 100;
+    };
+
+    /// @brief ディレクトリ単位のファイル変更監視
+    /// @note ファイルごとではなくディレクトリごとにOSへ登録するので、監視するファイル数が増えても
+    ///       1フレームあたりのコストは届いた通知の数だけで決まる。Poll はメインスレッドから呼ぶ。
+    struct IFileWatcher
+    {
+        virtual ~IFileWatcher() = default;
+
+        /// @brief ディレクトリを監視する
+        /// @param recursive 配下のディレクトリ(後から作られたものを含む)も監視する
+        virtual FsResult Watch(std::string_view directory, bool recursive, FileWatchId& out) noexcept = 0;
+        virtual void Unwatch(FileWatchId id) noexcept = 0;
+
+        /// @brief 届いた通知を取り込み、debounce を過ぎて確定した変更を out に追加する
+        /// @return 追加した件数
+        virtual size_t Poll(std::vector<FileChange>& out) noexcept = 0;
+    };
+}
@@ -0,0 +1,287 @@
+#pragma once
+// C++ standard library includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Core/include/Fiber.h"
+#include "Core/include/SlabAllocator.h"
+#include "Core/include/WorkStealingDeque.h"
+
+namespace Drama::Core::Job
+{
+    constexpr size_t kJobStorageSize = 64;     ///< ジョブに持たせられるキャプチャの最大バイト数
+    constexpr size_t kJobPoolSize = 4096;      ///< ワーカーごとのジョブ置き場(使い切ったら共有のスラブ)
+    constexpr size_t kJobDequeCapacity = 4096; ///< ワーカーごとのキュー容量(あふれたら積んだスレッドで即実行)
+
+    class JobCounter;
+
+    /// @brief 1件のジョブ(呼び出し可能オブジェクトをその場に置く。std::function の確保を避ける)
+    struct alignas(64) Job
+    {
+        void (*invoke)(void* storage) = nullptr;
+        void (*destroy)(void* storage) = nullptr;
+        JobCounter* counter = nullptr; ///< 終わったら1減らす
+        std::atomic<bool> inUse{ false };
+        Memory::SlabHandle overflow{}; ///< 共有のスラブから取った場合のハンドル(無効ならワーカーの置き場)
+        alignas(16) std::byte storage[kJobStorageSize];
+    };
+
+    /// @brief 未完了ジョブ数。Wait と依存関係(RunAfter)の単位
+    /// @note 0 に戻った後は使い回してよい。RunAfter の依存先にした場合は、待っているジョブが投入されるまで
+    ///       破棄したり増やしたりしないこと
+    class JobCounter final
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const noexcept { return m_Value.load(std::memory_order_acquire) == 0; }
+        uint32_t Pending() const noexcept { return m_Value.load(std::memory_order_relaxed); }
+
+    private:
+        friend class JobSystem;
+
+        // 0 になった瞬間に Wait が戻って破棄されることがあるので、減らした後はこのオブジェクトに触らない。
+        // そのため依存待ちのジョブはカウンタではなく JobSystem 側で持つ
+        std::atomic<uint32_t> m_Value{ 0 };
+    };
+
+    /// @brief ジョブシステムの設定
+    struct JobSystemDesc
+    {
+        uint32_t threadCount = 0; ///< Start を呼んだスレッドを含むスレッド数。0 ならコア数、1 なら呼び出しスレッドだけで実行する
+        uint32_t spinCount = 64;  ///< 仕事が無いときに眠る前に探し直す回数
+        /// @brief ジョブを実行するファイバーの数。0 ならファイバーを使わず、Wait は待つ間に他のジョブを実行する
+        /// @note Wait で止まっているジョブ1つにつき1つ使うので、同時に待つ数(入れ子の深さを含む)より多めにする。
+        ///       足りなければ上と同じ動きになるが、それはファイバーの小さなスタックの上で入れ子になる
+        uint32_t fiberCount = 0;
+        size_t fiberStackSize = 256 * 1024; ///< ファイバー1つのスタック
+    };
+
+    /// @brief 計測用の統計
+    struct JobSystemStats
+    {
+        uint64_t executed = 0;   ///< 実行したジョブ数
+        uint64_t stolen = 0;     ///< 他のワーカーから盗んだ数
+        uint64_t heapJobs = 0;   ///< 置き場が足りず共有のスラブから確保した数
+        uint64_t inlineJobs = 0; ///< キューかスラブがあふれて積んだスレッドで実行した数
+        uint64_t parks = 0;      ///< Wait でファイバーを退避した回数
+    };
+
+    /// @brief ワークスティーリング型のジョブシステム
+    /// @note ワーカーごとに Chase-Lev の両端キューを持ち、自分の積んだジョブは末尾から(LIFO)、
+    ///       他人のものは先頭から(FIFO)取る。分割したジョブの大きい方が先に盗まれるので、盗みの回数が少なく済む。
+    ///       Start を呼んだスレッドはワーカー0 になり、Wait の間は自分でもジョブを実行する。
+    ///       ワーカー以外のスレッドから Run した場合は共有キューを経由する。
+    ///       fiberCount を指定すると、ジョブはファイバーの上で動き、ジョブ内の Wait はファイバーを退避して
+    ///       そのワーカーに別の仕事をさせる(カウンタが 0 になると別のワーカーで再開することがある)。
+    ///       ワーカー0 の Wait も退避するが、再開は必ずワーカー0(Start を呼んだスレッド)で行う。
+    class JobSystem final
+    {
+    public:
+        JobSystem() = default;
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// @brief ワーカー開始(呼び出したスレッドがワーカー0 になる)
+        /// @return 成功ならtrue
+        bool Start(const JobSystemDesc& desc = {});
+        /// @brief ワーカー停止。残っていたジョブは呼び出しスレッドで実行してから戻る
+        /// @note Start と同じスレッドから呼ぶ
+        void Stop() noexcept;
+
+        /// @brief ジョブを投入する
+        /// @note ジョブを置く場所が尽きたら積まずにその場で実行する
+        template <class F>
+        void Run(JobCounter& counter, F&& fn)
+        {
+            if (Job* job = MakeJob(counter, std::forward<F>(fn)))
+            {
+                Submit(job);
+                return;
+            }
+            m_InlineJobs.fetch_add(1, std::memory_order_relaxed);
+            fn();
+        }
+
+        /// @brief dependency が 0 になってから実行するジョブを投入する
+        /// @note ジョブを置く場所が尽きたら dependency を待ってからその場で実行する
+        template <class F>
+        void RunAfter(JobCounter& dependency, JobCounter& counter, F&& fn)
+        {
+            if (Job* job = MakeJob(counter, std::forward<F>(fn)))
+            {
+                Defer(dependency, job);
+                return;
+            }
+            m_InlineJobs.fetch_add(1, std::memory_order_relaxed);
+            Wait(dependency);
+            fn();
+        }
+
+        /// @brief counter が 0 になるまで待つ
+        /// @note ファイバーを使う場合はワーカーを止めずに退避する。使わない場合・ワーカー以外のスレッドでは、
+        ///       待つ間に他のジョブを実行する
+        void Wait(JobCounter& counter) noexcept;
+
+        /// @brief [0, count) を fn(begin, end) に分けて並列に実行し、全部終わるまで待つ
+        /// @param grain 1ジョブで処理する最小件数。0 なら件数とスレッド数から決める
+        template <class F>
+        void ParallelFor(size_t count, F&& fn, size_t grain = 0)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            if (grain == 0)
+            {
+                grain = AutoGrain(count);
+            }
+            using Fn = std::remove_reference_t<F>;
+            JobCounter counter;
+            RunRange<Fn>(counter, &fn, 0, count, grain);
+            Wait(counter);
+        }
+
+        /// @brief 自動で決める ParallelFor の粒度(1スレッドあたり約8個に分ける。偏りは盗みでならす)
+        size_t AutoGrain(size_t count) const noexcept;
+
+        /// @brief ワーカー0 を含めたスレッド数
+        uint32_t ThreadCount() const noexcept { return static_cast<uint32_t>(m_Workers.size()); }
+        bool IsRunning() const noexcept { return m_IsRunning.load(std::memory_order_acquire); }
+        JobSystemStats Stats() const noexcept;
+
+    private:
+        struct alignas(64) Worker
+        {
+            WorkStealingDeque<Job*> deque;
+            Fiber threadFiber;             ///< ファイバー利用時のスレッド自身
+            std::unique_ptr<Job[]> pool;
+            uint32_t poolNext = 0;
+            uint64_t rng = 0;
+            std::thread thread;
+            std::atomic<uint64_t> executed{ 0 };
+            std::atomic<uint64_t> stolen{ 0 };
+        };
+
+        template <class F>
+        Job* MakeJob(JobCounter& counter, F&& fn)
+        {
+            using Fn = std::decay_t<F>;
+            static_assert(sizeof(Fn) <= kJobStorageSize, "job capture is too large; capture by pointer instead");
+            static_assert(alignof(Fn) <= 16, "job capture is over-aligned");
+            Job* job = AllocateJob();
+            if (job == nullptr)
+            {
+                return nullptr; // fn はまだ受け取っていないので、呼び出し側がそのまま実行できる
+            }
+            ::new (static_cast<void*>(job->storage)) Fn(std::forward<F>(fn));
+            job->invoke = [](void* p) { (*static_cast<Fn*>(p))(); };
+            job->destroy = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+            job->counter = &counter;
+            // 減らすのは実行後なので relaxed で足りる(キューへの公開が release)
+            counter.m_Value.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+
+        /// @brief 大きい範囲は半分ずつ切り出してジョブにし、最後に残った分を自分で処理する
+        template <class Fn>
+        void RunRange(JobCounter& counter, Fn* fn, size_t begin, size_t end, size_t grain)
+        {
+            while (end - begin > grain)
+            {
+                const size_t mid = begin + (end - begin) / 2;
+                Run(counter, [this, &counter, fn, mid, end, grain]()
+                    {
+                        RunRange<Fn>(counter, fn, mid, end, grain);
+                    });
+                end = mid;
+            }
+            (*fn)(begin, end);
+        }
+
+        /// @brief 置き場かスラブからジョブを取る。どちらも尽きていれば nullptr
+        Job* AllocateJob() noexcept;
+        void FreeJob(Job* job) noexcept;
+        void Submit(Job* job) noexcept;
+        void Defer(JobCounter& dependency, Job* job) noexcept;
+        void Execute(Job* job) noexcept;
+        void Finish(JobCounter& counter) noexcept;
+        void ReleaseDeferred() noexcept;
+        Job* FindJob(uint32_t self) noexcept;
+        bool HasWork(uint32_t self) const noexcept;
+        void WakeOne() noexcept;
+        void WakeAll() noexcept;
+        /// @brief 仕事が無ければ少し回ってから眠る
+        void Idle(uint32_t& idle) noexcept;
+        void WorkerMain(uint32_t index);
+        void RunLoop(uint32_t index);
+
+        // ファイバー
+        enum class Arrival : uint8_t
+        {
+            None,
+            Release, ///< 切り替え元を置き場へ返す
+            Park,    ///< 切り替え元をカウンタ待ちにする
+        };
+        static void FiberEntry(void* self) noexcept;
+        /// @brief ファイバーの上で回るスケジューラ(戻らない)
+        void SchedulerLoop() noexcept;
+        /// @brief 切り替え元の後始末(arrival)は切り替え先で行う。切り替え完了前に他のスレッドが再開しないように
+        void SwitchTo(Fiber* to, Arrival arrival, Fiber* subject, JobCounter* counter) noexcept;
+        void OnArrive() noexcept;
+        void Park(Fiber* fiber, JobCounter& counter) noexcept;
+        void MakeReady(Fiber* fiber) noexcept;
+        Fiber* TakeReadyFiber(uint32_t self) noexcept;
+        /// @brief 呼び出しスレッドがこのシステムのワーカーなら番号、そうでなければ UINT32_MAX
+        uint32_t CurrentWorker() const noexcept;
+
+        JobSystemDesc m_Desc{};
+        std::vector<std::unique_ptr<Worker>> m_Workers;
+        std::atomic<bool> m_IsRunning{ false };
+
+        // ワーカー以外から投入されたジョブ
+        mutable std::mutex m_InjectMutex;
+        std::deque<Job*> m_Injected;
+        std::atomic<size_t> m_InjectedCount{ 0 };
+
+        // RunAfter と退避したファイバーの待ち。依存先が 0 になったものを、どこかのカウンタが 0 になるたびにまとめて出す
+        struct Deferred
+        {
+            JobCounter* dependency = nullptr;
+            Job* job = nullptr;     ///< RunAfter のジョブ(ファイバーの場合は nullptr)
+            Fiber* fiber = nullptr; ///< Wait で退避したファイバー
+        };
+        std::mutex m_DeferMutex;
+        std::vector<Deferred> m_Deferred;
+        std::atomic<size_t> m_DeferredCount{ 0 };
+
+        // ファイバー
+        bool m_UseFibers = false;
+        FiberPool m_FiberPool;
+        std::mutex m_ReadyMutex;
+        std::deque<Fiber*> m_ReadyFibers;        ///< 再開できるようになったファイバー(どのワーカーで再開してもよい)
+        std::atomic<size_t> m_ReadyCount{ 0 };
+        std::atomic<Fiber*> m_ResumeMain{ nullptr }; ///< 再開を待つワーカー0 のスレッドファイバー
+        std::atomic<uint64_t> m_Parks{ 0 };
+
+        // 眠っているワーカーの起こし方: 眠る側は m_Sleeping を増やしてから仕事を探し直し、
+        // 積む側は積んだ後に m_Sleeping を見る。どちらも seq_cst なので、少なくとも片方が相手に気付く
+        alignas(64) std::atomic<uint32_t> m_Epoch{ 0 };
+        std::atomic<uint32_t> m_Sleeping{ 0 };
+
+        Memory::SlabAllocator m_OverflowJobs; ///< ワーカー以外からの投入と、置き場が埋まったときのジョブ
+        std::atomic<uint64_t> m_HeapJobs{ 0 };
+        std::atomic<uint64_t> m_InlineJobs{ 0 };
+    };
+}
@@ -7,45 +7,54 @@
 #include <cstddef>
 #include <cstdint>
 #include "Core/include/IFileSystem.h"
+#include "Core/include/AsyncLogWriter.h"
+#include "Core/include/LogSegmentStore.h"
 
 namespace Drama::Core
 {
     class LogAssert final
     {
     public:
-        static bool Init(IO::IFileSystem& fs, std::string logPathUtf8,
-            size_t maxLines = 500, size_t trimTrigger = 550)
+        /// @brief 初期化
+        /// @note 1行を kTypicalLineBytes とみなして maxLines 行分を残すバイト数に換算する
+        static bool Init(IO::IFileSystem& fs, std::string logPathUtf8, size_t maxLines = 500)
+        {
+            LogRotationDesc desc{};
+            desc.retainBytes = maxLines * kTypicalLineBytes;
+            return Init(fs, std::move(logPathUtf8), desc);
+        }
+
+        /// @brief 初期化(ローテーション設定を直接指定)
+        /// @param logPathUtf8 "temp/log.txt" なら "temp/log.0.txt" ... に書く。旧形式の "temp/log.txt" は取り込んで消す
+        static bool Init(IO::IFileSystem& fs, std::string logPathUtf8, const LogRotationDesc& desc)
         {
             std::scoped_lock lock(m_Mutex);
 
             m_Fs = &fs;
             m_LogPath = std::move(logPathUtf8);
-            m_MaxLines = maxLines;
-            m_TrimTrigger = trimTrigger;
 
             if (!EnsureParentDir_NoLock())
             {
                 return false;
             }
-            if (!EnsureFileExists_NoLock())
-            {
-                return false;
-            }
 
-            m_LineCount = CountLines_NoLock();
+            // 起動時にセグメントを走査して行数と現在位置を求める(保持量で頭打ち)
+            return m_Store.Open(fs, m_LogPath, desc);
+        }
 
-            if (m_LineCount > m_TrimTrigger)
+        static bool WriteLine(std::string_view lineUtf8) noexcept
+        {
+            // 非同期モード中は積むだけ。ファイルI/Oは書き込みスレッドがまとめて行う。
+            // 停止と競合して受け付けられなかった行は、下の同期書き込みで残す
+            if (m_Async.IsRunning())
             {
-                if (!TrimToLastN_NoLock(m_MaxLines))
+                const LogPushResult pushed = m_Async.PushLine(lineUtf8);
+                if (pushed != LogPushResult::Stopped)
                 {
-                    return false;
+                    return pushed == LogPushResult::Queued;
                 }
             }
-            return true;
-        }
 
-        static bool WriteLine(std::string_view lineUtf8) noexcept
-        {
             std::scoped_lock lock(m_Mutex);
 
             if (!m_Fs)
@@ -53,36 +62,71 @@ namespace Drama::Core
                 return false; // Init忘れ
             }
 
-            if (!EnsureParentDir_NoLock())
-            {
-                return false;
-            }
-
             // string_viewは終端'\0'保証なし。必ず(data,size)で追記する。
             m_Tmp.clear();
             m_Tmp.reserve(lineUtf8.size() + 1);
             m_Tmp.append(lineUtf8.data(), lineUtf8.size());
             m_Tmp.push_back('\n');
 
-            {
-                auto r = m_Fs->AppendAllBytes(m_LogPath, m_Tmp.data(), m_Tmp.size());
-                if (!r)
-                    return false;
-            }
-
-            ++m_LineCount;
+            return AppendBatch_NoLock(m_Tmp.data(), m_Tmp.size());
+        }
 
-            if (m_LineCount > m_TrimTrigger)
+        /// @brief 非同期モード開始
+        /// @note 以降のWriteLineはロックフリーのリングバッファに積むだけになり、
+        ///       専用スレッドがバッチ単位で1回ずつ追記する。Init後に呼ぶこと。
+        /// @param desc リングバッファ容量と満杯時の方針
+        /// @return 成功ならtrue
+        static bool EnableAsync(const AsyncLogDesc& desc = {})
+        {
             {
-                if (!TrimToLastN_NoLock(m_MaxLines))
+                std::scoped_lock lock(m_Mutex);
+                if (!m_Fs)
                 {
-                    // トリム失敗でもログ追記自体は成功している。
-                    // ここを false にするかは運用次第。今はあなたの元コードに合わせて false。
-                    return false;
+                    return false; // Init忘れ
                 }
             }
+            return m_Async.Start(desc, [](const char* data, size_t size, size_t)
+                {
+                    std::scoped_lock lock(m_Mutex);
+                    return AppendBatch_NoLock(data, size);
+                });
+        }
+
+        /// @brief ここまでのログを書き出し終えるまで待つ(終了処理・クラッシュ処理用)
+        /// @return 書き込みが全て成功していればtrue
+        static bool Flush() noexcept
+        {
+            return m_Async.Flush();
+        }
+
+        /// @brief 書き出してから非同期モードを終了する
+        /// @note IFileSystemを破棄する前に必ず呼ぶこと
+        static void Shutdown() noexcept
+        {
+            m_Async.Flush();
+            m_Async.Stop();
+        }
 
-            return true;
+        /// @brief 保持している行数(起動時からあった分は初めて呼ばれたときに読んで数え、以降は追記の分を足す)
+        static size_t RetainedLines() noexcept
+        {
+            std::scoped_lock lock(m_Mutex);
+            return m_Store.RetainedLines();
+        }
+
+        /// @brief 古い順のセグメントファイルパス(ログを読む側が連結する)
+        static std::vector<std::string> SegmentPaths()
+        {
+            std::scoped_lock lock(m_Mutex);
+            std::vector<std::string> paths;
+            m_Store.CollectPaths(paths);
+            return paths;
+        }
+
+        /// @brief 非同期モードで破棄された行数(Drop方針時)
+        static uint64_t DroppedLines() noexcept
+        {
+            return m_Async.DroppedCount();
         }
 
     private:
@@ -108,107 +152,35 @@ namespace Drama::Core
             return static_cast<bool>(r);
         }
 
-        static bool EnsureFileExists_NoLock() noexcept
+        static bool AppendBatch_NoLock(const char* data, size_t size) noexcept
         {
-            // あなたのExists()仕様に合わせる：
-            // OKなら存在、NotFoundなら無い、それ以外はエラー
-            auto r = m_Fs->Exists(m_LogPath);
-            if (r)
-            {
-                return true;
-            }
-
-            if (r.error == IO::FsError::NotFound)
-            {
-                // 空ファイル作成
-                auto r2 = m_Fs->WriteAllBytes(m_LogPath, "", 0);
-                return static_cast<bool>(r2);
-            }
-            return false;
-        }
-
-        static size_t CountLines_NoLock() noexcept
-        {
-            std::vector<uint8_t> bytes;
-            auto r = m_Fs->ReadAllBytes(m_LogPath, bytes);
-            if (!r)
-            {
-                return 0;
-            }
-
-            size_t count = 0;
-            for (uint8_t c : bytes)
-            {
-                if (c == '\n')
-                {
-                    ++count;
-                }
-            }
-
-            return count;
-        }
-
-        static bool TrimToLastN_NoLock(size_t n) noexcept
-        {
-            std::vector<uint8_t> bytes;
-            auto r = m_Fs->ReadAllBytes(m_LogPath, bytes);
-            if (!r)
+            if (!m_Fs)
             {
                 return false;
             }
-
-            // 行数カウント（\n基準）
-            size_t lines = 0;
-            for (uint8_t c : bytes)
-                if (c == '\n')
-                    ++lines;
-
-            if (lines <= n)
-            {
-                m_LineCount = lines;
-                return true;
-            }
-
-            // 後ろから n 行分の開始位置を探す
-            size_t need = n; // 末尾から数える\nの数
-            size_t i = bytes.size();
-
-            while (i > 0 && need > 0)
-            {
-                --i;
-                if (bytes[i] == '\n')
-                {
-                    --need;
-                }
-            }
-
-            // i は「n行分の先頭の直前 or ちょうど先頭付近」
-            // ここでは i+1 を開始にすると、「ちょうど境界の次」から取れる。
-            size_t start = (i + 1 < bytes.size()) ? (i + 1) : 0;
-
-            const uint8_t* p = bytes.data() + start;
-            const size_t   sz = bytes.size() - start;
-
-            r = m_Fs->WriteAllBytes(m_LogPath, p, sz);
-            if (!r)
+            if (!EnsureParentDir_NoLock())
             {
                 return false;
             }
 
-            m_LineCount = n;
-            return true;
+            // 追記と、必要なら最古セグメントの削除だけ。既存行は書き直さない。
+            return m_Store.Append(data, size);
         }
 
     private:
+        /// @brief 行数指定の Init で想定する1行の長さ
+        static constexpr size_t kTypicalLineBytes = 128;
+
         static inline IO::IFileSystem* m_Fs = nullptr;
         static inline std::string m_LogPath = "temp/log.txt";
 
-        static inline size_t m_MaxLines = 500;
-        static inline size_t m_TrimTrigger = 550;
-        static inline size_t m_LineCount = 0;
+        static inline LogSegmentStore m_Store;
 
         static inline std::mutex m_Mutex;
 
+        // 非同期モード用の書き込みスレッド
+        static inline AsyncLogWriter m_Async;
+
         // 使い回しバッファ（毎回newしない）
         static inline std::string m_Tmp;
     };
@@ -0,0 +1,33 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <string_view>
+
+namespace Drama::Core
+{
+    /// @brief ログの重要度。値はバイナリログにそのまま保存するので並びを変えないこと
+    enum class LogLevel : uint8_t
+    {
+        Trace = 0,
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Fatal,
+    };
+
+    /// @brief 表示用の名前
+    constexpr std::string_view ToString(LogLevel level) noexcept
+    {
+        switch (level)
+        {
+        case LogLevel::Trace:   return "Trace";
+        case LogLevel::Debug:   return "Debug";
+        case LogLevel::Info:    return "Info";
+        case LogLevel::Warning: return "Warning";
+        case LogLevel::Error:   return "Error";
+        case LogLevel::Fatal:   return "Fatal";
+        }
+        return "Unknown";
+    }
+}
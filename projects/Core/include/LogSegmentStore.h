@@ -0,0 +1,81 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Core/include/IFileSystem.h"
+
+namespace Drama::Core
+{
+    /// @brief ログのローテーション設定
+    struct LogRotationDesc
+    {
+        size_t retainBytes = 128 * 1024; ///< 最低限残すバイト数の目安
+        size_t segmentBytes = 32 * 1024; ///< 1セグメントの最大バイト数(1行がこれより長い場合を除く)
+    };
+
+    /// @brief 固定サイズのセグメントファイルを循環させてログを保持する
+    /// @note "temp/log.txt" なら "temp/log.0.txt" ... を使う。索引ファイルは持たない。
+    ///       現在のセグメントの次は常に空にしておき、起動時は「空でない直後が空」の位置を現在とみなす。
+    ///       切り替えは次の次を消すだけなので fsync は要らず、途中で落ちても空きが2つ続くだけで済む。
+    ///       起動時はセグメントの大きさだけを調べ、中身は読まない(行数は RetainedLines で初めて数える)。
+    ///       スレッド安全ではない(呼び出し側でロックする)。
+    class LogSegmentStore final
+    {
+    public:
+        /// @brief セグメントを走査して状態を作り直す。旧形式の単一ファイルがあれば取り込んで消す
+        /// @return 成功ならtrue
+        bool Open(IO::IFileSystem& fs, std::string_view basePathUtf8, const LogRotationDesc& desc);
+
+        /// @brief 行の途中で分けずに追記する。セグメントが埋まれば次へ切り替える
+        bool Append(const void* data, size_t size);
+        /// @brief 分けずに現在のセグメントへ追記する(切り替えは呼び出し側が Roll で行う。バイナリのレコード用)
+        bool AppendWhole(const void* data, size_t size);
+        /// @brief 次のセグメントへ切り替える
+        bool Roll();
+        /// @brief 現在のセグメントのバイト数
+        size_t ActiveBytes() const noexcept;
+
+        /// @brief 保持している行数
+        /// @note 起動時からあったセグメントは、初めて呼ばれたときに読んで数える(以降は追記の分を足すだけ)
+        size_t RetainedLines() noexcept;
+        /// @brief 保持しているバイト数
+        size_t RetainedBytes() const noexcept;
+        /// @brief 古い順のセグメントパス(空のものは除く)
+        void CollectPaths(std::vector<std::string>& out) const;
+
+        /// @brief セグメントファイルのパス
+        std::string SegmentPath(uint32_t slot) const;
+        /// @brief セグメント数(現在の1つと常に空の1つを含む)
+        uint32_t SlotCount() const noexcept { return static_cast<uint32_t>(m_Segments.size()); }
+
+    private:
+        struct SegmentInfo
+        {
+            uint64_t lines = 0;          ///< 数え終わった行数
+            uint64_t bytes = 0;
+            uint64_t uncountedBytes = 0; ///< 先頭からこのバイト数はまだ行を数えていない(起動時からあった分)
+        };
+
+        /// @brief セグメントを消す(無いのは空とみなす)
+        bool Clear(uint32_t slot);
+        /// @brief 全セグメントの大きさから現在位置を求める(中身は読まない)
+        bool Scan();
+        /// @brief 空でないセグメントのうち最後に書かれたもの
+        /// @param isFollowedByEmpty 直後が空のものだけから選ぶ
+        /// @return 見つかれば true
+        bool FindNewest(bool isFollowedByEmpty, uint32_t& out);
+        /// @brief 旧形式("log.txt" と "log.index")を取り込んで消す
+        bool MigrateLegacy(std::string_view basePathUtf8);
+
+        IO::IFileSystem* m_Fs = nullptr;
+        LogRotationDesc m_Desc{};
+        std::string m_Stem;      ///< 拡張子を除いたパス
+        std::string m_Extension; ///< "." を含む拡張子
+
+        std::vector<SegmentInfo> m_Segments;
+        uint32_t m_Active = 0;
+    };
+}
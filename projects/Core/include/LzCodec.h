@@ -0,0 +1,37 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+
+namespace Drama::Core::Compression
+{
+    /// @brief LZ77系の軽量コーデック(LZ4と同系統のバイト列形式。互換ではない)
+    /// @note 形式: [token][リテラル長の延長][リテラル][offset(u16 LE)][一致長の延長] の繰り返し。
+    ///       token上位4bitがリテラル長、下位4bitが(一致長-4)。15なら255刻みの延長バイトが続く。
+    ///       最後のシーケンスはリテラルのみ。参照距離は64KB未満。
+
+    /// @brief 最悪ケースの圧縮後サイズ
+    constexpr size_t CompressBound(size_t size) noexcept
+    {
+        return size + size / 255 + 16;
+    }
+
+    constexpr uint32_t kHashBits = 14;
+
+    /// @brief 圧縮の一致探索表(64KB)
+    /// @note スタックに置くとファイバーの小さなスタックを食うので、呼び出し側がヒープなどに持って使い回す。
+    ///       中身は Compress が毎回初期化する。同時に使えるのは1スレッドだけ
+    struct CompressScratch
+    {
+        uint32_t table[1u << kHashBits];
+    };
+
+    /// @brief 圧縮する
+    /// @return 圧縮後のバイト数。dstCapacity に収まらなければ0
+    size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity, CompressScratch& scratch) noexcept;
+
+    /// @brief 展開する
+    /// @param rawSize 展開後のバイト数(ブロック索引に記録した値)
+    /// @return 入力が壊れていたり rawSize と一致しなければfalse(範囲外は読み書きしない)
+    bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t rawSize) noexcept;
+}
@@ -0,0 +1,47 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Drama::Core::IO
+{
+    /// @brief 読み取り専用のファイル内容ビュー(ムーブのみ)
+    /// @note OSのマッピング(mmap / MapViewOfFile)か、マッピングできなかった場合に読み込んだバッファのどちらかを持つ。
+    ///       破棄時にマッピングは解放関数で、バッファはvectorごと解放される。
+    class MappedFile final
+    {
+    public:
+        /// @brief マッピング解放関数(IFileSystem 実装が用意する)
+        using ReleaseFn = void (*)(const uint8_t* data, size_t size) noexcept;
+
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& o) noexcept;
+        MappedFile& operator=(MappedFile&& o) noexcept;
+
+        /// @brief OSのマッピングを引き取る
+        static MappedFile FromMapping(const uint8_t* data, size_t size, ReleaseFn release) noexcept;
+        /// @brief 読み込み済みのバッファを引き取る(フォールバック用)
+        static MappedFile FromBytes(std::vector<uint8_t>&& bytes) noexcept;
+
+        /// @brief 持っている内容を解放して空にする
+        void Reset() noexcept;
+
+        const uint8_t* Data() const noexcept { return m_Data; }
+        size_t Size() const noexcept { return m_Size; }
+        std::span<const uint8_t> Bytes() const noexcept { return { m_Data, m_Size }; }
+        bool IsEmpty() const noexcept { return m_Size == 0; }
+        /// @brief OSのマッピングならtrue(falseなら読み込んだコピー)
+        bool IsMapped() const noexcept { return m_Release != nullptr; }
+
+    private:
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+        ReleaseFn m_Release = nullptr;
+        std::vector<uint8_t> m_Fallback;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+
+#include "Core/include/MathTypes.h"
+
+namespace Drama::Core::Math
+{
+    /// @brief バッチ処理の実装の種類
+    enum class SimdLevel : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2, ///< AVX2 + FMA
+        Neon,
+        Count,
+    };
+
+    /// @brief 表示用の名前
+    const char* SimdLevelName(SimdLevel level) noexcept;
+    /// @brief Batch の関数が使う実装(ビルド設定で決まる。Simd.h の DRAMA_SIMD_* と同じ)
+    SimdLevel CompiledSimdLevel() noexcept;
+    /// @brief この実行ファイルと CPU で level の実装が使えるか
+    bool IsSimdLevelSupported(SimdLevel level) noexcept;
+
+    /// @brief float3 の SoA 列(x, y, z を別々の配列に置く)
+    struct Float3Stream
+    {
+        float* x = nullptr;
+        float* y = nullptr;
+        float* z = nullptr;
+    };
+    struct ConstFloat3Stream
+    {
+        const float* x = nullptr;
+        const float* y = nullptr;
+        const float* z = nullptr;
+
+        ConstFloat3Stream() = default;
+        ConstFloat3Stream(const float* px, const float* py, const float* pz) noexcept : x(px), y(py), z(pz) {}
+        ConstFloat3Stream(const Float3Stream& s) noexcept : x(s.x), y(s.y), z(s.z) {}
+    };
+    /// @brief 四元数の SoA 列
+    struct QuaternionStream
+    {
+        float* x = nullptr;
+        float* y = nullptr;
+        float* z = nullptr;
+        float* w = nullptr;
+    };
+
+    /// @brief 実装ごとの関数表(比較・ベンチマーク用。普段は Batch の関数を使う)
+    struct BatchKernels
+    {
+        SimdLevel level;
+        void (*transformPoints)(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept;
+        void (*multiplyMatrices)(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept;
+        void (*normalizeQuaternions)(QuaternionStream q, size_t count) noexcept;
+    };
+
+    /// @brief level の関数表(使えなければ nullptr)
+    const BatchKernels* KernelsFor(SimdLevel level) noexcept;
+
+    // 配列の長さと境界は問わない(端数はスカラーで処理する)。out は入力と同じ配列でもよい。
+    // 結果は実装によって最後の数 ulp が違うことがある(FMA の有無など)
+    namespace Batch
+    {
+        /// @brief out[i] = TransformPoint(in[i], m)
+        void TransformPoints(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept;
+        /// @brief out[i] = a[i] * b[i]
+        void MultiplyMatrices(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept;
+        /// @brief q[i] を長さ1にする(長さ0なら回転なしにする)
+        void NormalizeQuaternions(QuaternionStream q, size_t count) noexcept;
+    }
+}
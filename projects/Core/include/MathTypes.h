@@ -0,0 +1,210 @@
+#pragma once
+// C++ standard library includes
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Core/include/Simd.h"
+
+namespace Drama::Core::Math
+{
+    // 並びは HLSL の float2 / float3 / float4 / float4x4 と同じ(定数バッファや StructuredBuffer へそのまま書ける)。
+    // 行列は行優先で、ベクトルは行ベクトル(v * M。平行移動は4行目)。シェーダー側は row_major を付けて mul(v, M) で使う。
+    // 定数バッファでは float3 の後ろに float を詰めて 16 バイト境界を跨がないよう並べること
+
+    struct Float2
+    {
+        float x, y;
+    };
+
+    struct Float3
+    {
+        float x, y, z;
+    };
+
+    struct alignas(16) Float4
+    {
+        float x, y, z, w;
+    };
+
+    /// @brief 4x4 行列(行優先。r[3] が平行移動)
+    struct alignas(16) Float4x4
+    {
+        Float4 r[4];
+    };
+
+    /// @brief 回転の四元数(x, y, z が虚部、w が実部)
+    struct alignas(16) Quaternion
+    {
+        float x, y, z, w;
+    };
+
+    static_assert(sizeof(Float2) == 8 && sizeof(Float3) == 12 && sizeof(Float4) == 16, "HLSL vector layout");
+    static_assert(sizeof(Float4x4) == 64 && sizeof(Quaternion) == 16, "HLSL matrix layout");
+
+    // ---- Float3 ----
+
+    constexpr Float3 operator+(Float3 a, Float3 b) noexcept { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    constexpr Float3 operator-(Float3 a, Float3 b) noexcept { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    constexpr Float3 operator-(Float3 a) noexcept { return { -a.x, -a.y, -a.z }; }
+    constexpr Float3 operator*(Float3 a, float s) noexcept { return { a.x * s, a.y * s, a.z * s }; }
+    constexpr Float3 operator*(float s, Float3 a) noexcept { return a * s; }
+    /// @brief 要素ごとの積
+    constexpr Float3 operator*(Float3 a, Float3 b) noexcept { return { a.x * b.x, a.y * b.y, a.z * b.z }; }
+
+    constexpr float Dot(Float3 a, Float3 b) noexcept { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    constexpr Float3 Cross(Float3 a, Float3 b) noexcept
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+    inline float Length(Float3 a) noexcept { return std::sqrt(Dot(a, a)); }
+    /// @brief 長さ1にする(長さ0ならそのまま返す)
+    inline Float3 Normalize(Float3 a) noexcept
+    {
+        const float len = Length(a);
+        return len > 0.0f ? a * (1.0f / len) : a;
+    }
+    constexpr Float3 Min(Float3 a, Float3 b) noexcept { return { a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z }; }
+    constexpr Float3 Max(Float3 a, Float3 b) noexcept { return { a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z }; }
+
+    // ---- Float4 ----
+
+    constexpr Float4 operator+(Float4 a, Float4 b) noexcept { return { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }; }
+    constexpr Float4 operator-(Float4 a, Float4 b) noexcept { return { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w }; }
+    constexpr Float4 operator*(Float4 a, float s) noexcept { return { a.x * s, a.y * s, a.z * s, a.w * s }; }
+    constexpr float Dot(Float4 a, Float4 b) noexcept { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    // ---- Float4x4 ----
+
+    constexpr Float4x4 Identity() noexcept
+    {
+        return { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+    }
+    constexpr Float4x4 Translation(Float3 t) noexcept
+    {
+        return { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { t.x, t.y, t.z, 1 } } };
+    }
+    constexpr Float4x4 Scaling(Float3 s) noexcept
+    {
+        return { { { s.x, 0, 0, 0 }, { 0, s.y, 0, 0 }, { 0, 0, s.z, 0 }, { 0, 0, 0, 1 } } };
+    }
+    constexpr Float4x4 Transpose(const Float4x4& m) noexcept
+    {
+        return { { { m.r[0].x, m.r[1].x, m.r[2].x, m.r[3].x },
+                   { m.r[0].y, m.r[1].y, m.r[2].y, m.r[3].y },
+                   { m.r[0].z, m.r[1].z, m.r[2].z, m.r[3].z },
+                   { m.r[0].w, m.r[1].w, m.r[2].w, m.r[3].w } } };
+    }
+
+    /// @brief a * b(a を適用してから b を適用する変換)
+    inline Float4x4 Multiply(const Float4x4& a, const Float4x4& b) noexcept
+    {
+        // 結果の i 行 = a[i].x * b[0] + a[i].y * b[1] + a[i].z * b[2] + a[i].w * b[3]
+        using namespace Simd;
+        const V4 b0 = Load(&b.r[0].x);
+        const V4 b1 = Load(&b.r[1].x);
+        const V4 b2 = Load(&b.r[2].x);
+        const V4 b3 = Load(&b.r[3].x);
+        Float4x4 out;
+        for (int i = 0; i < 4; ++i)
+        {
+            const V4 row = Load(&a.r[i].x);
+            V4 acc = Mul(SplatLane<0>(row), b0);
+            acc = MulAdd(SplatLane<1>(row), b1, acc);
+            acc = MulAdd(SplatLane<2>(row), b2, acc);
+            acc = MulAdd(SplatLane<3>(row), b3, acc);
+            Store(&out.r[i].x, acc);
+        }
+        return out;
+    }
+    inline Float4x4 operator*(const Float4x4& a, const Float4x4& b) noexcept { return Multiply(a, b); }
+
+    /// @brief 点を変換する(w = 1 として扱い、射影の割り算はしない)
+    constexpr Float3 TransformPoint(Float3 p, const Float4x4& m) noexcept
+    {
+        return { p.x * m.r[0].x + p.y * m.r[1].x + p.z * m.r[2].x + m.r[3].x,
+                 p.x * m.r[0].y + p.y * m.r[1].y + p.z * m.r[2].y + m.r[3].y,
+                 p.x * m.r[0].z + p.y * m.r[1].z + p.z * m.r[2].z + m.r[3].z };
+    }
+    /// @brief 方向を変換する(w = 0。平行移動は効かない)
+    constexpr Float3 TransformVector(Float3 v, const Float4x4& m) noexcept
+    {
+        return { v.x * m.r[0].x + v.y * m.r[1].x + v.z * m.r[2].x,
+                 v.x * m.r[0].y + v.y * m.r[1].y + v.z * m.r[2].y,
+                 v.x * m.r[0].z + v.y * m.r[1].z + v.z * m.r[2].z };
+    }
+    /// @brief 4成分を変換する
+    constexpr Float4 Transform(Float4 v, const Float4x4& m) noexcept
+    {
+        return m.r[0] * v.x + m.r[1] * v.y + m.r[2] * v.z + m.r[3] * v.w;
+    }
+
+    /// @brief 逆行列
+    /// @param outDeterminant 非 nullptr なら行列式を返す(0 に近ければ逆は信用できない)
+    /// @return 特異なら単位行列
+    Float4x4 Inverse(const Float4x4& m, float* outDeterminant = nullptr) noexcept;
+
+    // ---- Quaternion ----
+
+    constexpr Quaternion IdentityQuaternion() noexcept { return { 0, 0, 0, 1 }; }
+    /// @brief axis(長さ1)回りに radians 回す
+    inline Quaternion FromAxisAngle(Float3 axis, float radians) noexcept
+    {
+        const float s = std::sin(radians * 0.5f);
+        return { axis.x * s, axis.y * s, axis.z * s, std::cos(radians * 0.5f) };
+    }
+    constexpr Quaternion Conjugate(Quaternion q) noexcept { return { -q.x, -q.y, -q.z, q.w }; }
+    constexpr float Dot(Quaternion a, Quaternion b) noexcept { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+    /// @brief a * b(行ベクトルの行列と同じく、a の回転の後に b の回転を行う)
+    constexpr Quaternion Multiply(Quaternion a, Quaternion b) noexcept
+    {
+        return { b.w * a.x + b.x * a.w + b.y * a.z - b.z * a.y,
+                 b.w * a.y - b.x * a.z + b.y * a.w + b.z * a.x,
+                 b.w * a.z + b.x * a.y - b.y * a.x + b.z * a.w,
+                 b.w * a.w - b.x * a.x - b.y * a.y - b.z * a.z };
+    }
+    constexpr Quaternion operator*(Quaternion a, Quaternion b) noexcept { return Multiply(a, b); }
+    /// @brief 長さ1にする(長さ0なら回転なし)
+    inline Quaternion Normalize(Quaternion q) noexcept
+    {
+        const float lenSq = Dot(q, q);
+        if (!(lenSq > 0.0f))
+        {
+            return IdentityQuaternion();
+        }
+        const float inv = 1.0f / std::sqrt(lenSq);
+        return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+    }
+    /// @brief ベクトルを回す(q は長さ1)
+    constexpr Float3 Rotate(Float3 v, Quaternion q) noexcept
+    {
+        // v' = v + 2w(u x v) + 2(u x (u x v))
+        const Float3 u{ q.x, q.y, q.z };
+        const Float3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+    /// @brief 球面線形補間(近い方の経路を通る)
+    Quaternion Slerp(Quaternion a, Quaternion b, float t) noexcept;
+
+    /// @brief 回転行列(q は長さ1)
+    constexpr Float4x4 RotationMatrix(Quaternion q) noexcept
+    {
+        const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        return { { { 1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0 },
+                   { 2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0 },
+                   { 2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0 },
+                   { 0, 0, 0, 1 } } };
+    }
+    /// @brief 拡縮 → 回転 → 平行移動 の順に行う行列
+    constexpr Float4x4 Compose(Float3 scale, Quaternion rotation, Float3 translation) noexcept
+    {
+        Float4x4 m = RotationMatrix(rotation);
+        m.r[0] = m.r[0] * scale.x;
+        m.r[1] = m.r[1] * scale.y;
+        m.r[2] = m.r[2] * scale.z;
+        m.r[3] = { translation.x, translation.y, translation.z, 1 };
+        return m;
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+// C++ standard library includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+// メモリの追跡を有効にするか。Debug / Develop では有効、Release では記録の呼び出しごと消える。
+// プロジェクト設定で DRAMA_MEMORY_TRACKING=0/1 を定義すれば上書きできる
+#if !defined(DRAMA_MEMORY_TRACKING)
+#if defined(_DEBUG) || defined(DEVELOP)
+#define DRAMA_MEMORY_TRACKING 1
+#else
+#define DRAMA_MEMORY_TRACKING 0
+#endif
+#endif
+
+namespace Drama::Core::Memory
+{
+    /// @brief 確保の用途
+    enum class MemoryTag : uint8_t
+    {
+        Unknown,
+        Log,
+        IO,
+        Assets,
+        Frame,  ///< FrameAllocator のブロック
+        Pool,   ///< SlabAllocator / HandlePool のスラブ
+        Job,
+        Render,
+        Ecs,    ///< ECS のチャンクとコマンド
+        Count,
+    };
+    constexpr size_t kMemoryTagCount = static_cast<size_t>(MemoryTag::Count);
+
+    /// @brief 用途の表示名
+    const char* TagName(MemoryTag tag) noexcept;
+
+    /// @brief 用途ごとの集計(最後に Update / Capture した時点)
+    struct TagStats
+    {
+        int64_t liveBytes = 0;    ///< 使用中のバイト数
+        int64_t peakBytes = 0;    ///< Update 時点での最大(フレーム単位の最大)
+        uint64_t allocations = 0; ///< 確保回数の累計
+        uint64_t frees = 0;       ///< 解放回数の累計
+        int64_t budgetBytes = 0;  ///< 予算(0 なら無制限)
+    };
+
+    /// @brief 個々の確保の記録(EnableAllocationRecords 中の確保だけ)
+    struct AllocationRecord
+    {
+        const void* address = nullptr;
+        size_t size = 0;
+        MemoryTag tag = MemoryTag::Unknown;
+        uint64_t sequence = 0; ///< 確保の通し番号(古いほど小さい)
+        uint64_t frame = 0;    ///< 確保したときのフレーム番号(Update に渡した値)
+    };
+
+    /// @brief ある時点の集計と、生きている確保の記録
+    struct MemorySnapshot
+    {
+        std::array<TagStats, kMemoryTagCount> tags{};
+        uint64_t sequence = 0;                 ///< この時点までに振った確保の通し番号
+        uint64_t frame = 0;
+        uint64_t droppedRecords = 0;           ///< 記録の表を広げられずに取れなかった数(0 でなければ records は不完全)
+        std::vector<AllocationRecord> records; ///< 通し番号順
+    };
+
+    /// @brief 2つの時点の差
+    struct MemoryDiff
+    {
+        std::array<int64_t, kMemoryTagCount> liveBytesDelta{};
+        std::array<int64_t, kMemoryTagCount> allocationDelta{}; ///< 確保回数 - 解放回数 の増分
+        std::vector<AllocationRecord> leaked;                   ///< before の後に確保され、after でまだ生きているもの
+    };
+
+    /// @brief 予算超えの通知先(tag, 使用量, 予算)
+    using BudgetHandler = void (*)(MemoryTag tag, int64_t liveBytes, int64_t budgetBytes);
+
+    /// @brief 用途ごとのメモリ使用量の追跡
+    /// @note 記録はスレッドごとのカウンタに足すだけ(持ち主だけが書く)。全スレッドの合計は Update で
+    ///       1フレームに1回まとめて取り、そのときに最大値と予算を確かめる。
+    ///       確保の記録(リーク探し用)は EnableAllocationRecords 中だけロック付きで取る。
+    ///       DRAMA_MEMORY_TRACKING が 0 なら全関数が空になり、集計は常に 0 を返す
+    class MemoryTracker final
+    {
+    public:
+#if DRAMA_MEMORY_TRACKING
+        /// @brief 確保を記録する(独自の確保器がヒープから取ったときに呼ぶ)
+        static void RecordAllocation(MemoryTag tag, const void* address, size_t size) noexcept;
+        /// @brief 解放を記録する(確保時と同じ tag と size で呼ぶ)
+        static void RecordFree(MemoryTag tag, const void* address, size_t size) noexcept;
+
+        /// @brief 全スレッドのカウンタを合計し、最大値と予算を更新する(1フレームに1回、同じスレッドから呼ぶ)
+        static void Update(uint64_t frameIndex) noexcept;
+        /// @brief 最後の Update の集計
+        static TagStats Stats(MemoryTag tag) noexcept;
+
+        /// @brief 予算(0 で無制限)。超えたときに BudgetHandler を1回呼び、下回ると再び通知できる状態に戻る
+        static void SetBudget(MemoryTag tag, int64_t bytes) noexcept;
+        static void SetBudgetHandler(BudgetHandler handler) noexcept;
+
+        /// @brief 個々の確保の記録を取るか(取っている間は確保ごとにロックを取る)
+        static void EnableAllocationRecords(bool enable) noexcept;
+        /// @brief 今の集計と記録を取る(Update も兼ねる)
+        static MemorySnapshot Capture();
+#else
+        static void RecordAllocation(MemoryTag, const void*, size_t) noexcept {}
+        static void RecordFree(MemoryTag, const void*, size_t) noexcept {}
+        static void Update(uint64_t) noexcept {}
+        static TagStats Stats(MemoryTag) noexcept { return {}; }
+        static void SetBudget(MemoryTag, int64_t) noexcept {}
+        static void SetBudgetHandler(BudgetHandler) noexcept {}
+        static void EnableAllocationRecords(bool) noexcept {}
+        static MemorySnapshot Capture() { return {}; }
+#endif
+        /// @brief before から after までの差(リークの候補は after の記録のうち before より後に確保したもの)
+        static MemoryDiff Diff(const MemorySnapshot& before, const MemorySnapshot& after);
+    };
+
+    /// @brief 用途付きでヒープから確保する
+    /// @return 確保できなければ nullptr
+    inline void* TrackedAllocate(MemoryTag tag, size_t size, size_t align = alignof(std::max_align_t)) noexcept
+    {
+        void* p = ::operator new(size, std::align_val_t(align), std::nothrow);
+        if (p)
+        {
+            MemoryTracker::RecordAllocation(tag, p, size);
+        }
+        return p;
+    }
+    /// @brief TrackedAllocate で確保したものを返す(確保時と同じ tag / size / align で呼ぶ)
+    inline void TrackedFree(MemoryTag tag, void* p, size_t size, size_t align = alignof(std::max_align_t)) noexcept
+    {
+        if (p)
+        {
+            MemoryTracker::RecordFree(tag, p, size);
+            ::operator delete(p, std::align_val_t(align));
+        }
+    }
+
+    /// @brief 上流の memory_resource に用途を付けて記録する(std::pmr のコンテナ用)
+    class TrackingMemoryResource final : public std::pmr::memory_resource
+    {
+    public:
+        explicit TrackingMemoryResource(MemoryTag tag, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+            : m_Tag(tag), m_Upstream(upstream)
+        {
+        }
+        MemoryTag Tag() const noexcept { return m_Tag; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            void* p = m_Upstream->allocate(bytes, alignment);
+            MemoryTracker::RecordAllocation(m_Tag, p, bytes);
+            return p;
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            MemoryTracker::RecordFree(m_Tag, p, bytes);
+            m_Upstream->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            const auto* o = dynamic_cast<const TrackingMemoryResource*>(&other);
+            return o && o->m_Tag == m_Tag && o->m_Upstream->is_equal(*m_Upstream);
+        }
+
+        MemoryTag m_Tag;
+        std::pmr::memory_resource* m_Upstream;
+    };
+}
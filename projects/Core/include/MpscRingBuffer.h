@@ -0,0 +1,104 @@
+#pragma once
+// C++ standard library includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "Core/include/MemoryTracker.h"
+
+namespace Drama::Core
+{
+    /// @brief 複数生産者・単一消費者のロックフリーなバイト列リングバッファ
+    /// @note 1レコードは連続したスロットに分割して格納される。
+    ///       消費者はスロットを順に取り出すだけでレコードのバイト列を復元できる。
+    class MpscRingBuffer final
+    {
+    public:
+        static constexpr size_t kSlotSize = 256;                              ///< スロット全体のサイズ
+        static constexpr size_t kSlotPayload = kSlotSize - sizeof(uint64_t) * 2; ///< スロット1つに入るバイト数
+
+        MpscRingBuffer() = default;
+        ~MpscRingBuffer();
+        MpscRingBuffer(const MpscRingBuffer&) = delete;
+        MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+        /// @brief バッファ確保(容量が同じなら確保済みのスロットを空にして使い回す)
+        /// @note 生産者も消費者も触れていないときに呼ぶこと
+        /// @param slotCount スロット数(2の冪に切り上げる)
+        /// @param tag スロットの配列を MemoryTracker に記録するときの用途
+        /// @return 成功ならtrue
+        bool Init(size_t slotCount, Memory::MemoryTag tag = Memory::MemoryTag::Log);
+
+        /// @brief 生産者側：バイト列を積む(ロックフリー)
+        /// @return 空きが無い、または容量を超えるならfalse
+        bool TryPush(const void* data, size_t size) noexcept;
+
+        /// @brief 消費者側：公開済みのスロットを順に取り出す
+        /// @param fn void(const char* data, size_t size) で呼ばれる
+        /// @return 取り出したスロット数
+        template <class Fn>
+        size_t Drain(Fn&& fn) noexcept
+        {
+            size_t count = 0;
+            uint64_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Slot& slot = m_Slots[pos & m_Mask];
+                const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+                if (seq != pos + 1)
+                {
+                    break; // 未公開
+                }
+                fn(slot.bytes, static_cast<size_t>(slot.size));
+                slot.sequence.store(pos + m_Capacity, std::memory_order_release);
+                ++pos;
+                ++count;
+            }
+            m_DequeuePos.store(pos, std::memory_order_release);
+            return count;
+        }
+
+        /// @brief 指定バイト数が必要とするスロット数
+        static constexpr size_t SlotsFor(size_t size) noexcept
+        {
+            return (size == 0) ? 1 : (size + kSlotPayload - 1) / kSlotPayload;
+        }
+
+        /// @brief 1レコードとして積める最大バイト数
+        size_t MaxRecordBytes() const noexcept { return m_Capacity * kSlotPayload; }
+        size_t Capacity() const noexcept { return static_cast<size_t>(m_Capacity); }
+
+        /// @brief 予約済み位置(生産者が確保した末尾)
+        uint64_t EnqueuePosition() const noexcept { return m_EnqueuePos.load(std::memory_order_acquire); }
+        /// @brief 消費済み位置
+        uint64_t DequeuePosition() const noexcept { return m_DequeuePos.load(std::memory_order_acquire); }
+        /// @brief おおよその使用スロット数
+        size_t ApproxUsed() const noexcept
+        {
+            return static_cast<size_t>(EnqueuePosition() - DequeuePosition());
+        }
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> sequence{ 0 };
+            uint64_t size = 0;
+            char bytes[kSlotPayload]{};
+        };
+        static_assert(sizeof(Slot) == kSlotSize);
+
+        /// @brief スロットの配列を手放す(記録も消す)
+        void ReleaseSlots() noexcept;
+
+        std::unique_ptr<Slot[]> m_Slots;
+        uint64_t m_Capacity = 0;
+        uint64_t m_Mask = 0;
+        Memory::MemoryTag m_Tag = Memory::MemoryTag::Log;
+
+        // 生産者と消費者で別キャッシュラインに置く(偽共有回避)
+        alignas(64) std::atomic<uint64_t> m_EnqueuePos{ 0 };
+        alignas(64) std::atomic<uint64_t> m_DequeuePos{ 0 };
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+// C++ standard library includes
+#include <string>
+#include <vector>
+#include "Core/include/IFileSystem.h"
+
+namespace Drama::Core::IO
+{
+    class ArchiveFileSystem;
+
+    /// @brief パックを実ファイルより先に探す IFileSystem
+    /// @note 読み込みは後からマウントしたパック → 先にマウントしたパック → 実ファイルの順に探す。
+    ///       書き込みは常に実ファイル側へ。パスは実ファイル側の currentPath() 配下の絶対パスでも、
+    ///       そこからの相対パスでもよい(パック内は相対パスで引く)。
+    class OverlayFileSystem final : public IFileSystem
+    {
+    public:
+        explicit OverlayFileSystem(IFileSystem& loose);
+
+        /// @brief パックを追加する(所有しない。アンマウントまで生存させること)
+        void Mount(ArchiveFileSystem& archive);
+        void Unmount(ArchiveFileSystem& archive) noexcept;
+
+        FsResult Exists(std::string_view path) noexcept override;
+        FsResult CreateDirectories(std::string_view path) noexcept override;
+        FsResult Remove(std::string_view path) noexcept override;
+        FsResult LastWriteTime(std::string_view path, uint64_t& outNs) noexcept override;
+
+        FsResult WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept override;
+        FsResult MapReadOnly(std::string_view path, MappedFile& out) noexcept override;
+        FsResult AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept override;
+        FsResult OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept override;
+        FsResult OpenWrite(std::string_view path, FileWriteMode mode, std::unique_ptr<IFileWriter>& out) noexcept override;
+
+        std::string currentPath() noexcept override { return m_Loose.currentPath(); }
+
+    private:
+        /// @brief パスを持っているパック(無ければnullptr)
+        ArchiveFileSystem* FindArchive(std::string_view path, std::string_view& relative) noexcept;
+
+        IFileSystem& m_Loose;
+        std::string m_LooseRoot;
+        std::vector<ArchiveFileSystem*> m_Archives;
+    };
+}
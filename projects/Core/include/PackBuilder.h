@@ -0,0 +1,34 @@
+#pragma once
+// C++ standard library includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Core/include/IFileSystem.h"
+
+namespace Drama::Core::IO
+{
+    /// @brief パックファイルを作る
+    /// @note 中身は Build 時にストリームで読み込むので、全ファイルをメモリに載せない
+    class PackBuilder final
+    {
+    public:
+        /// @brief 1ファイル追加
+        /// @param virtualPath パック内のパス(区切りは '/' に正規化される)
+        /// @param sourcePath 読み込み元(fs上のパス)
+        /// @return 同じ virtualPath が既にあればfalse
+        bool Add(std::string_view virtualPath, std::string_view sourcePath);
+
+        /// @brief パックを書き出す
+        FsResult Build(IFileSystem& fs, std::string_view outPath) const;
+
+        size_t Count() const noexcept { return m_Sources.size(); }
+
+    private:
+        struct Source
+        {
+            std::string virtualPath;
+            std::string sourcePath;
+        };
+        std::vector<Source> m_Sources;
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+// C++ standard library includes
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Drama::Core::IO::Pack
+{
+    /// @brief パックファイルの構成
+    /// @note [PackHeader][PackEntry × entryCount(pathHash昇順)][パス文字列][64B境界に揃えた各ファイル本体]
+    ///       検索はパスのハッシュで二分探索し、衝突時は保存したパス文字列で確かめる。
+    constexpr uint32_t kMagic = 0x4B415044; // "DPAK"
+    constexpr uint16_t kVersion = 1;
+    constexpr uint32_t kAlignment = 64;
+
+    struct PackHeader
+    {
+        uint32_t magic = kMagic;
+        uint16_t version = kVersion;
+        uint16_t flags = 0;
+        uint32_t entryCount = 0;
+        uint32_t alignment = kAlignment;
+        uint64_t entryTableOffset = 0;
+        uint64_t stringTableOffset = 0;
+        uint64_t stringTableSize = 0;
+        uint64_t dataOffset = 0;
+        uint8_t reserved[16] = {};
+    };
+    static_assert(sizeof(PackHeader) == 64, "PackHeader layout changed");
+
+    struct PackEntry
+    {
+        uint64_t pathHash = 0;
+        uint64_t dataOffset = 0;  ///< ファイル先頭からの位置(kAlignment の倍数)
+        uint64_t size = 0;
+        uint32_t pathOffset = 0;  ///< 文字列テーブル内の位置
+        uint32_t pathSize = 0;
+    };
+    static_assert(sizeof(PackEntry) == 32, "PackEntry layout changed");
+
+    constexpr uint64_t AlignUp(uint64_t v, uint64_t a) noexcept
+    {
+        return (v + a - 1) / a * a;
+    }
+
+    /// @brief パスの正規化規則: '\\' は '/' とみなし、先頭の "./" と '/' は無視する
+    constexpr std::string_view TrimPathPrefix(std::string_view path) noexcept
+    {
+        while (true)
+        {
+            if (path.size() >= 2 && path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+            {
+                path.remove_prefix(2);
+            }
+            else if (!path.empty() && (path[0] == '/' || path[0] == '\\'))
+            {
+                path.remove_prefix(1);
+            }
+            else
+            {
+                return path;
+            }
+        }
+    }
+
+    constexpr char NormalizeChar(char c) noexcept
+    {
+        return (c == '\\') ? '/' : c;
+    }
+
+    /// @brief 正規化したパスのFNV-1a(64bit)。文字列を作らずに計算する
+    constexpr uint64_t HashPath(std::string_view path) noexcept
+    {
+        path = TrimPathPrefix(path);
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : path)
+        {
+            h ^= static_cast<uint8_t>(NormalizeChar(c));
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    /// @brief 正規化した上で等しいか
+    constexpr bool PathEquals(std::string_view a, std::string_view b) noexcept
+    {
+        a = TrimPathPrefix(a);
+        b = TrimPathPrefix(b);
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (NormalizeChar(a[i]) != NormalizeChar(b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief root 配下のパスなら root 以降の相対パスを返す。そうでなければ path のまま
+    constexpr std::string_view StripRoot(std::string_view path, std::string_view root) noexcept
+    {
+        while (!root.empty() && (root.back() == '/' || root.back() == '\\'))
+        {
+            root.remove_suffix(1);
+        }
+        if (root.empty() || path.size() <= root.size())
+        {
+            return path;
+        }
+        for (size_t i = 0; i < root.size(); ++i)
+        {
+            if (NormalizeChar(path[i]) != NormalizeChar(root[i]))
+            {
+                return path;
+            }
+        }
+        const char sep = path[root.size()];
+        if (sep != '/' && sep != '\\')
+        {
+            return path;
+        }
+        return path.substr(root.size() + 1);
+    }
+}
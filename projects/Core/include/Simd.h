@@ -0,0 +1,154 @@
+#pragma once
+// C++ standard library includes
+#include <cmath>
+#include <cstdint>
+
+// 使う命令セットをコンパイル時に決める。DRAMA_SIMD_FORCE_SCALAR を定義すると SIMD を使わない(比較・デバッグ用)。
+//  DRAMA_SIMD_SSE  : x86-64(SSE2 は必ずある)
+//  DRAMA_SIMD_AVX2 : /arch:AVX2 や -mavx2 でビルドしたとき(SSE も有効のまま)
+//  DRAMA_SIMD_NEON : ARM64
+#if !defined(DRAMA_SIMD_FORCE_SCALAR)
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define DRAMA_SIMD_SSE 1
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define DRAMA_SIMD_AVX2 1
+#endif
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#define DRAMA_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Drama::Core::Math::Simd
+{
+    /// @brief 4要素の float レジスタ
+#if defined(DRAMA_SIMD_SSE)
+    using V4 = __m128;
+#elif defined(DRAMA_SIMD_NEON)
+    using V4 = float32x4_t;
+#else
+    struct V4
+    {
+        float v[4];
+    };
+#endif
+
+    /// @brief 16 バイト境界の4要素を読む
+    inline V4 Load(const float* p) noexcept
+    {
+#if defined(DRAMA_SIMD_SSE)
+        return _mm_load_ps(p);
+#elif defined(DRAMA_SIMD_NEON)
+        return vld1q_f32(p);
+#else
+        return V4{ { p[0], p[1], p[2], p[3] } };
+#endif
+    }
+    /// @brief 境界を問わず4要素を読む
+    inline V4 LoadUnaligned(const float* p) noexcept
+    {
+#if defined(DRAMA_SIMD_SSE)
+        return _mm_loadu_ps(p);
+#else
+        return Load(p);
+#endif
+    }
+    inline void Store(float* p, V4 a) noexcept
+    {
+#if defined(DRAMA_SIMD_SSE)
+        _mm_store_ps(p, a);
+#elif defined(DRAMA_SIMD_NEON)
+        vst1q_f32(p, a);
+#else
+        p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+#endif
+    }
+    inline void StoreUnaligned(float* p, V4 a) noexcept
+    {
+#if defined(DRAMA_SIMD_SSE)
+        _mm_storeu_ps(p, a);
+#else
+        Store(p, a);
+#endif
+    }
+    inline V4 Splat(float f) noexcept
+    {
+#if defined(DRAMA_SIMD_SSE)
+        return _mm_set1_ps(f);
+#elif defined(DRAMA_SIMD_NEON)
+        return vdupq_n_f32(f);
+#else
+        return V4{ { f, f, f, f } };
+#endif
+    }
+    /// @brief a の i 番目の要素を4つに広げる
+    template <int I>
+    inline V4 SplatLane(V4 a) noexcept
+    {
+        static_assert(I >= 0 && I < 4);
+#if defined(DRAMA_SIMD_SSE)
+        return _mm_shuffle_ps(a, a, _MM_SHUFFLE(I, I, I, I));
+#elif defined(DRAMA_SIMD_NEON)
+        return vdupq_laneq_f32(a, I);
+#else
+        return Splat(a.v[I]);
+#endif
+    }
+
+#if defined(DRAMA_SIMD_SSE)
+    inline V4 Add(V4 a, V4 b) noexcept { return _mm_add_ps(a, b); }
+    inline V4 Sub(V4 a, V4 b) noexcept { return _mm_sub_ps(a, b); }
+    inline V4 Mul(V4 a, V4 b) noexcept { return _mm_mul_ps(a, b); }
+    inline V4 Div(V4 a, V4 b) noexcept { return _mm_div_ps(a, b); }
+    inline V4 Min(V4 a, V4 b) noexcept { return _mm_min_ps(a, b); }
+    inline V4 Max(V4 a, V4 b) noexcept { return _mm_max_ps(a, b); }
+    inline V4 Sqrt(V4 a) noexcept { return _mm_sqrt_ps(a); }
+    /// @brief a * b + c(FMA があれば1回で丸める)
+    inline V4 MulAdd(V4 a, V4 b, V4 c) noexcept
+    {
+#if defined(DRAMA_SIMD_AVX2)
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+    /// @brief a[i] <= b[i] なら bit i を立てる(NaN は偽)
+    inline uint32_t LessEqualMask(V4 a, V4 b) noexcept { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(a, b))); }
+#elif defined(DRAMA_SIMD_NEON)
+    inline V4 Add(V4 a, V4 b) noexcept { return vaddq_f32(a, b); }
+    inline V4 Sub(V4 a, V4 b) noexcept { return vsubq_f32(a, b); }
+    inline V4 Mul(V4 a, V4 b) noexcept { return vmulq_f32(a, b); }
+    inline V4 Div(V4 a, V4 b) noexcept { return vdivq_f32(a, b); }
+    inline V4 Min(V4 a, V4 b) noexcept { return vminq_f32(a, b); }
+    inline V4 Max(V4 a, V4 b) noexcept { return vmaxq_f32(a, b); }
+    inline V4 Sqrt(V4 a) noexcept { return vsqrtq_f32(a); }
+    inline V4 MulAdd(V4 a, V4 b, V4 c) noexcept { return vfmaq_f32(c, a, b); }
+    inline uint32_t LessEqualMask(V4 a, V4 b) noexcept
+    {
+        static const int32_t kShift[4] = { 0, 1, 2, 3 };
+        return vaddvq_u32(vshlq_u32(vshrq_n_u32(vcleq_f32(a, b), 31), vld1q_s32(kShift)));
+    }
+#else
+    namespace Detail
+    {
+        template <class F>
+        inline V4 Map(V4 a, V4 b, F f) noexcept
+        {
+            return V4{ { f(a.v[0], b.v[0]), f(a.v[1], b.v[1]), f(a.v[2], b.v[2]), f(a.v[3], b.v[3]) } };
+        }
+    }
+    inline V4 Add(V4 a, V4 b) noexcept { return Detail::Map(a, b, [](float x, float y) { return x + y; }); }
+    inline V4 Sub(V4 a, V4 b) noexcept { return Detail::Map(a, b, [](float x, float y) { return x - y; }); }
+    inline V4 Mul(V4 a, V4 b) noexcept { return Detail::Map(a, b, [](float x, float y) { return x * y; }); }
+    inline V4 Div(V4 a, V4 b) noexcept { return Detail::Map(a, b, [](float x, float y) { return x / y; }); }
+    inline V4 Min(V4 a, V4 b) noexcept { return Detail::Map(a, b, [](float x, float y) { return y < x ? y : x; }); }
+    inline V4 Max(V4 a, V4 b) noexcept { return Detail::Map(a, b, [](float x, float y) { return x < y ? y : x; }); }
+    inline V4 Sqrt(V4 a) noexcept { return V4{ { std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) } }; }
+    inline V4 MulAdd(V4 a, V4 b, V4 c) noexcept { return Add(Mul(a, b), c); }
+    inline uint32_t LessEqualMask(V4 a, V4 b) noexcept
+    {
+        return (a.v[0] <= b.v[0] ? 1u : 0u) | (a.v[1] <= b.v[1] ? 2u : 0u) | (a.v[2] <= b.v[2] ? 4u : 0u) | (a.v[3] <= b.v[3] ? 8u : 0u);
+    }
+#endif
+}
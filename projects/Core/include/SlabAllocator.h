@@ -0,0 +1,176 @@
+#pragma once
+// C++ standard library includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Core/include/MemoryTracker.h"
+
+namespace Drama::Core::Memory
+{
+    /// @brief 64bit のハンドル(下位 32bit が番号、上位 32bit が世代)
+    /// @note 番号は 20bit(1つの確保器で最大 kMaxBlocks = 1,048,576 ブロック)、
+    ///       世代は 31bit(ブロックの状態に生存ビットと一緒に詰める。1 から 2^31-1 まで)。
+    ///       値 0 は無効(世代は 1 から始まり 0 を飛ばす)。ブロックを解放すると世代が進むので、
+    ///       古いハンドルで引いても別のオブジェクトには届かず nullptr になる。
+    ///       世代が一周するのは同じブロックを約 21 億回使い回したとき
+    struct SlabHandle
+    {
+        static constexpr uint32_t kIndexBits = 20;
+        static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+        static constexpr uint32_t kGenerationBits = 31;
+        static constexpr uint32_t kGenerationMask = (1u << kGenerationBits) - 1;
+        static constexpr uint32_t kMaxBlocks = 1u << kIndexBits;
+
+        uint64_t value = 0;
+
+        constexpr uint32_t Index() const noexcept { return static_cast<uint32_t>(value) & kIndexMask; }
+        constexpr uint32_t Generation() const noexcept { return static_cast<uint32_t>(value >> 32); }
+        constexpr bool IsValid() const noexcept { return value != 0; }
+        static constexpr SlabHandle Make(uint32_t index, uint32_t generation) noexcept
+        {
+            return SlabHandle{ (static_cast<uint64_t>(generation & kGenerationMask) << 32) | (index & kIndexMask) };
+        }
+        friend constexpr bool operator==(SlabHandle a, SlabHandle b) noexcept { return a.value == b.value; }
+    };
+
+    /// @brief スラブの設定
+    struct SlabDesc
+    {
+        size_t blockSize = 64;        ///< 1ブロックの大きさ
+        size_t blockAlign = alignof(std::max_align_t);
+        uint32_t blocksPerSlab = 1024; ///< 1スラブのブロック数(2 の累乗に切り上げる。最後のスラブは maxBlocks で切り詰める)
+        uint32_t maxBlocks = 65536;    ///< 上限(SlabHandle::kMaxBlocks 以下。2 の累乗でなくてもちょうどこの数で止まる)
+        MemoryTag tag = MemoryTag::Pool; ///< スラブを MemoryTracker に記録するときの用途
+    };
+
+    /// @brief 同じ大きさのブロックをスラブ(連続した塊)単位で確保し、番号と世代のハンドルで配る
+    /// @note 確保と解放はロックフリー(番号の空きリストを世代タグ付きの CAS で出し入れする)。
+    ///       各スレッドは解放した番号を少しだけ手元に置き、次の確保はそこから取るので、
+    ///       作って壊すを繰り返す間は共有の空きリストに触らない(溢れた分はまとめて1回の CAS で戻す)。
+    ///       空きが尽きたときだけロックを取って次のスラブを足し、上限まで足していれば終わったスレッドの手元の空きを回収する
+    ///       (生きている他のスレッドの手元にある分、最大でスレッドあたり ThreadCache::kCapacity 個は使えない)。スラブは Shutdown まで手放さないので、
+    ///       ハンドルからのアドレスは安定しており、解放済みのハンドルは世代の不一致で弾ける。
+    ///       空きは後入れ先出しなので、直前に解放したキャッシュの温かいブロックから再利用される
+    class SlabAllocator final
+    {
+    public:
+        SlabAllocator() noexcept = default;
+        ~SlabAllocator();
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+        /// @brief 初期化(最初のスラブも確保する)
+        /// @return 成功ならtrue
+        bool Init(const SlabDesc& desc);
+        /// @brief すべてのスラブを返す(生きているブロックのデストラクタは呼ばない)
+        /// @note 世代は次の Init に引き継ぐので、Shutdown 前のハンドルは作り直した後のブロックにも届かない
+        void Shutdown() noexcept;
+
+        /// @brief ブロックを1つ確保する(どのスレッドからでもよい)
+        /// @param outBlock 非 nullptr ならブロックのアドレスを返す(Resolve を引き直さずに済む)
+        /// @return 上限に達したかメモリが無ければ無効なハンドル
+        SlabHandle Allocate(void** outBlock = nullptr) noexcept;
+        /// @brief ブロックを返す(どのスレッドからでもよい)
+        /// @param destroy 空きリストに戻す前にブロックのアドレスで呼ぶ(中身の破棄用。nullptr なら呼ばない)
+        /// @return 古いハンドルや二重解放なら false(何もしない)
+        bool Free(SlabHandle handle, void (*destroy)(void*) = nullptr) noexcept;
+
+        /// @brief ハンドルのブロックのアドレス
+        /// @return 解放済み・無効なハンドルなら nullptr
+        /// @note 他のスレッドが同時に Free すると、返したアドレスはその後で再利用されうる(寿命の管理は呼び出し側で)
+        void* Resolve(SlabHandle handle) const noexcept;
+
+        /// @brief 生きているブロックを番号順に回る fn(SlabHandle, void*)
+        /// @note 確保・解放と同時には呼ばないこと
+        template <class F>
+        void ForEach(F&& fn) const
+        {
+            const uint32_t slabs = m_SlabCount.load(std::memory_order_acquire);
+            for (uint32_t s = 0; s < slabs; ++s)
+            {
+                const Slab* slab = m_Slabs[s].load(std::memory_order_acquire);
+                for (uint32_t i = 0; i < slab->blockCount; ++i)
+                {
+                    const uint32_t state = slab->meta[i].state.load(std::memory_order_acquire);
+                    if (state & kAlive)
+                    {
+                        fn(SlabHandle::Make((s << m_SlabShift) | i, state >> 1), slab->data + i * m_Stride);
+                    }
+                }
+            }
+        }
+
+        /// @brief 生きているブロック数
+        /// @note 確保・解放のたびに共有のカウンタを更新しないよう、呼ばれたときに数える(容量に比例する)
+        uint32_t LiveCount() const noexcept
+        {
+            uint32_t live = 0;
+            ForEach([&live](SlabHandle, void*) { ++live; });
+            return live;
+        }
+        /// @brief 確保済みのスラブに入るブロック数
+        uint32_t Capacity() const noexcept
+        {
+            const uint32_t capacity = m_SlabCount.load(std::memory_order_relaxed) * m_BlocksPerSlab;
+            return capacity < m_MaxBlocks ? capacity : m_MaxBlocks;
+        }
+        uint32_t SlabCount() const noexcept { return m_SlabCount.load(std::memory_order_relaxed); }
+        /// @brief ブロックの間隔(blockSize を blockAlign に切り上げたもの)
+        size_t Stride() const noexcept { return m_Stride; }
+
+    private:
+        static constexpr uint32_t kAlive = 1;              ///< state の最下位ビット(残りが世代)
+        static constexpr uint32_t kNoIndex = 0xFFFFFFFFu;
+
+        /// @brief ブロックごとの管理情報(データとは別の配列にして、データ側を詰めて並べる)
+        struct BlockMeta
+        {
+            std::atomic<uint32_t> state{ 1u << 1 }; ///< (世代 << 1) | 生存。空きで始める(世代は Grow で m_FirstGeneration にそろえる)
+            std::atomic<uint32_t> next{ kNoIndex }; ///< 空きリストの次の番号
+        };
+        struct Slab
+        {
+            std::unique_ptr<BlockMeta[]> meta;
+            std::byte* data = nullptr;
+            uint32_t blockCount = 0; ///< 使うブロック数(最後のスラブだけ m_BlocksPerSlab より少ないことがある)
+        };
+        /// @brief スレッドの手元に置く空き番号(持ち主のスレッドだけが触る)
+        struct alignas(64) ThreadCache
+        {
+            static constexpr uint32_t kCapacity = 32;
+            uint32_t count = 0;
+            uint32_t indices[kCapacity];
+        };
+
+        BlockMeta& Meta(uint32_t index) const noexcept
+        {
+            return m_Slabs[index >> m_SlabShift].load(std::memory_order_acquire)->meta[index & (m_BlocksPerSlab - 1)];
+        }
+        bool Grow() noexcept;
+        void PushChain(uint32_t first, uint32_t last) noexcept;
+        SlabHandle Claim(uint32_t index, void** outBlock) const noexcept;
+        ThreadCache* LocalCache() noexcept;
+        /// @brief 持ち主のいない枠の手元の空きを共有の空きリストへ戻す
+        /// @return 何か戻せたら true
+        bool ReclaimIdleCaches() noexcept;
+
+        std::unique_ptr<std::atomic<Slab*>[]> m_Slabs; ///< maxSlabs 個。足したスラブは Shutdown まで動かさない
+        std::vector<std::unique_ptr<Slab>> m_SlabStorage; ///< スラブの持ち主(m_GrowMutex で守る。引く側は m_Slabs を見る)
+        std::atomic<uint32_t> m_SlabCount{ 0 };
+        uint32_t m_MaxSlabs = 0;
+        uint32_t m_MaxBlocks = 0;
+        uint32_t m_FirstGeneration = 1; ///< 新しいスラブのブロックの世代(Shutdown で使われた世代より先へ進める)
+        uint32_t m_BlocksPerSlab = 0;
+        uint32_t m_SlabShift = 0;
+        size_t m_Stride = 0;
+        size_t m_Align = 0;
+        MemoryTag m_Tag = MemoryTag::Pool;
+        std::atomic<uint64_t> m_FreeHead{ kNoIndex }; ///< (タグ << 32) | 番号。タグで ABA を防ぐ
+        std::unique_ptr<std::unique_ptr<ThreadCache>[]> m_Caches; ///< スレッドの枠番号で引く(初めて使うときに枠の持ち主が作る)
+        std::mutex m_GrowMutex;
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Core/include/Ecs.h"
+#include "Core/include/JobSystem.h"
+
+namespace Drama::Core::Ecs
+{
+    /// @brief システムが触るコンポーネント(並べて動かしてよいかの判断に使う)
+    struct ComponentAccess
+    {
+        ComponentMask reads = 0;  ///< 読むだけの型
+        ComponentMask writes = 0; ///< 書く型
+        bool exclusive = false;   ///< World を直接変えるなど、他のシステムと同時に動かせない
+
+        /// @brief 型の並びから作る(const を付けた型は読むだけ、付けない型は書く)
+        template <class... Ts>
+        static ComponentAccess Of() noexcept
+        {
+            ComponentAccess access{};
+            (((std::is_const_v<Ts> ? access.reads : access.writes) |= MaskOf<Ts>()), ...);
+            return access;
+        }
+        static ComponentAccess Exclusive() noexcept
+        {
+            ComponentAccess access{};
+            access.exclusive = true;
+            return access;
+        }
+
+        /// @brief 同時に動かすと競合するか(どちらかが書く型を、もう一方が読むか書く)
+        bool ConflictsWith(const ComponentAccess& other) const noexcept
+        {
+            return exclusive || other.exclusive ||
+                (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+        }
+    };
+
+    /// @brief システムに渡すもの
+    struct SystemContext
+    {
+        World& world;
+        CommandBuffer& commands; ///< このシステム専用(構造の変更はここへ積む。全システムの後で反映する)
+        Job::JobSystem& jobs;    ///< ParallelForEachChunk などで処理を広げてよい
+        double deltaSeconds;
+    };
+
+    using SystemFunction = std::function<void(SystemContext&)>;
+
+    /// @brief システムを触る型の読み書きに従って並列に動かす
+    /// @note 登録順を基準に、前のシステムと競合するものだけを後の段へ送る(競合しない限り同じ段で同時に動く)。
+    ///       競合する組の実行順は登録順のまま保たれる。システムの中で World の構造は変えず、
+    ///       context.commands に積む。積んだ変更は全段が終わった後に登録順で反映する
+    class SystemScheduler final
+    {
+    public:
+        SystemScheduler() = default;
+        SystemScheduler(const SystemScheduler&) = delete;
+        SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+        /// @brief システムを足す
+        /// @return 登録順の番号
+        uint32_t AddSystem(std::string name, const ComponentAccess& access, SystemFunction fn);
+
+        /// @brief すべてのシステムを1回ずつ動かし、積まれた構造の変更を反映する
+        /// @note JobSystem を Start したスレッド(ワーカー0)から呼ぶ
+        void Run(World& world, Job::JobSystem& jobs, double deltaSeconds);
+
+        size_t SystemCount() const noexcept { return m_Systems.size(); }
+        const std::string& SystemName(uint32_t system) const noexcept { return m_Systems[system].name; }
+        /// @brief 段の数(次の Run で使う並べ方)
+        size_t PhaseCount();
+        /// @brief システムが動く段
+        uint32_t PhaseOf(uint32_t system);
+
+    private:
+        struct System
+        {
+            std::string name;
+            ComponentAccess access;
+            SystemFunction fn;
+            std::unique_ptr<CommandBuffer> commands;
+            uint32_t phase = 0;
+        };
+
+        void BuildPhases();
+
+        std::vector<System> m_Systems;
+        std::vector<std::vector<uint32_t>> m_Phases; ///< 段ごとのシステム番号
+        bool m_Dirty = true;
+    };
+}
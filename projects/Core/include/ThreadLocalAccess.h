@@ -0,0 +1,15 @@
+#pragma once
+
+// スレッドローカル変数を引き直す関数に付ける印。
+// ジョブはファイバーごと別のスレッドへ移ることがあるので、スレッドローカル変数のアドレスを
+// 呼び出し側でキャッシュさせないよう、引き直す関数は DRAMA_NOINLINE にして先頭で DRAMA_OPAQUE_BARRIER() を置く
+//  DRAMA_NOINLINE          : インライン展開させない
+//  DRAMA_OPAQUE_BARRIER()  : noinline だけでは副作用の無い関数(const)と推論され、呼び出し自体をまとめられてしまうのを防ぐ
+//                            (MSVC は noinline の関数をまとめないので空。スレッドローカルのキャッシュは /GT で防ぐ)
+#if defined(_MSC_VER)
+#define DRAMA_NOINLINE __declspec(noinline)
+#define DRAMA_OPAQUE_BARRIER()
+#else
+#define DRAMA_NOINLINE __attribute__((noinline))
+#define DRAMA_OPAQUE_BARRIER() asm volatile("" ::: "memory")
+#endif
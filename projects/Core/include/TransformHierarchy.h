@@ -0,0 +1,153 @@
+#pragma once
+// C++ standard library includes
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Core/include/MathTypes.h"
+
+namespace Drama::Core::Job
+{
+    class JobSystem;
+}
+
+namespace Drama::Core::Scene
+{
+    /// @brief 変換ノードのハンドル(generation が 0 なら無効)
+    struct TransformNode
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        constexpr bool IsValid() const noexcept { return generation != 0; }
+        friend constexpr bool operator==(TransformNode a, TransformNode b) noexcept { return a.index == b.index && a.generation == b.generation; }
+    };
+
+    /// @brief 親子関係を持つ変換の集まり。ワールド行列は Update でまとめて計算する
+    /// @note ノードは深さごとに区切った平坦な配列に置く(幅優先の順。親は必ず子より前)。
+    ///       ローカル行列を変えたノードだけを覚えておき、Update で深さの浅い順にその部分木だけを計算し直す。
+    ///       同じ深さのノードは互いに依存しないので、深さごとにジョブへ分けて並列に計算する。
+    ///       親の付け替えで深さが変わったノードは、段の境目との入れ替えで移す(全体の並べ直しはしない)。
+    ///       配列の位置は作成・破棄・付け替えで変わるので、外からはハンドルで指す。スレッドセーフではない
+    class TransformHierarchy
+    {
+    public:
+        TransformHierarchy() = default;
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+        /// @brief ノードを作る
+        /// @param parent 無効なハンドルなら根になる
+        /// @return parent が破棄済みなら無効なハンドル
+        TransformNode Create(TransformNode parent = {}, const Math::Float4x4& local = Math::Identity());
+        /// @brief ノードを子孫ごと破棄する
+        /// @return 破棄済みなら false
+        bool Destroy(TransformNode node);
+        bool IsAlive(TransformNode node) const noexcept;
+
+        /// @brief 親を付け替える
+        /// @param parent 無効なハンドルなら根にする
+        /// @param keepWorld true なら見た目の位置が変わらないようローカル行列を直す(直前の Update のワールド行列を使う)
+        /// @return node や parent が破棄済みのとき、parent が node 自身かその子孫のときは false
+        bool SetParent(TransformNode node, TransformNode parent, bool keepWorld = false);
+        /// @brief 親(根なら無効なハンドル)
+        TransformNode Parent(TransformNode node) const noexcept;
+
+        /// @brief ローカル行列(親の空間での変換)を変え、部分木を次の Update で計算し直す
+        bool SetLocal(TransformNode node, const Math::Float4x4& local) noexcept;
+        bool SetLocal(TransformNode node, Math::Float3 scale, Math::Quaternion rotation, Math::Float3 translation) noexcept;
+        /// @return 破棄済みなら nullptr
+        const Math::Float4x4* Local(TransformNode node) const noexcept;
+        /// @brief 直前の Update 時点のワールド行列
+        /// @return 破棄済みなら nullptr
+        const Math::Float4x4* World(TransformNode node) const noexcept;
+
+        /// @brief 変更のあった部分木のワールド行列を計算し直す
+        void Update();
+        /// @brief 同じ深さのノードを jobs で並列に計算する(呼び出したスレッドも手伝い、終わるまで戻らない)
+        void Update(Job::JobSystem& jobs);
+
+        /// @brief 全ノードのワールド行列(配列の順。GPU への転送用。位置は IndexOf で引く)
+        std::span<const Math::Float4x4> WorldMatrices() const noexcept { return m_World; }
+        /// @return 破棄済みなら UINT32_MAX
+        uint32_t IndexOf(TransformNode node) const noexcept;
+
+        uint32_t NodeCount() const noexcept { return static_cast<uint32_t>(m_Local.size()); }
+        /// @brief 深さの段数(一番深いノードの深さ + 1)
+        uint32_t LevelCount() const noexcept { return static_cast<uint32_t>(m_LevelBegin.size()); }
+        /// @brief 直前の Update で計算し直したノード数
+        uint32_t LastUpdatedCount() const noexcept { return m_LastUpdated; }
+
+        /// @brief すべてのノードを破棄する
+        void Clear() noexcept;
+        /// @brief 配列の並びと親子の対応が正しいか(テスト用。ノード数に比例して遅い)
+        bool Validate() const;
+
+    private:
+        static constexpr uint32_t kNone = UINT32_MAX;
+
+        /// @brief 配列上の状態
+        enum NodeState : uint8_t
+        {
+            kClean,   ///< ワールド行列は最新
+            kPending, ///< 変更があり、m_Pending に載っている
+            kQueued,  ///< Update 中。計算する段の作業リストに載っている
+        };
+
+        /// @brief ハンドルの番号ごとの情報(配列の位置が変わっても動かない)
+        struct Slot
+        {
+            uint32_t index = kNone;      ///< 配列の位置(空きなら kNone)
+            uint32_t generation = 1;
+            uint32_t depth = 0;
+            uint32_t parent = kNone;     ///< 親の番号
+            uint32_t firstChild = kNone; ///< 子の番号の双方向リスト
+            uint32_t prevSibling = kNone;
+            uint32_t nextSibling = kNone;
+            uint32_t nextFree = kNone;
+        };
+
+        const Slot* Resolve(TransformNode node) const noexcept;
+        void MarkDirty(uint32_t index);
+        void LinkChild(uint32_t parentSlot, uint32_t slot) noexcept;
+        void UnlinkChild(uint32_t slot) noexcept;
+        /// @brief 配列の位置 a と b のノードを入れ替え、位置を指している情報を直す
+        void SwapNodes(uint32_t a, uint32_t b) noexcept;
+        /// @brief 配列の位置 index のノードを depth の段へ移す(段の境目と入れ替えながら1段ずつ動かす)
+        /// @return 移った後の位置
+        uint32_t MoveToLevel(uint32_t index, uint32_t depth) noexcept;
+        uint32_t LevelEnd(uint32_t level) const noexcept;
+        void TrimLevels() noexcept;
+        /// @brief slot とその子孫の番号を幅優先で out に積む
+        void CollectSubtree(uint32_t slot, std::vector<uint32_t>& out) const;
+        void RemoveLeaf(uint32_t slot) noexcept;
+
+        void UpdateImpl(Job::JobSystem* jobs);
+        /// @brief 1バッチ分を計算する
+        /// @param list nullptr なら [begin, end) の位置を順に見て、kQueued か親がこの Update で計算されたものを計算し、計算した位置を out に積む。
+        ///             そうでなければ list[begin, end) を計算し、まだ積まれていない子を out に積む
+        void ProcessBatch(const uint32_t* list, uint32_t begin, uint32_t end, std::vector<uint32_t>& out) noexcept;
+        /// @brief まだ積まれていない子を kQueued にして out に積む
+        void QueueChildren(uint32_t index, std::vector<uint32_t>& out) noexcept;
+
+        // 配列の位置ごとの情報(深さの浅い順。段 d は [m_LevelBegin[d], LevelEnd(d)))
+        std::vector<Math::Float4x4> m_Local;
+        std::vector<Math::Float4x4> m_World;
+        std::vector<uint32_t> m_Parent; ///< 親の位置(根なら kNone)
+        std::vector<uint32_t> m_SlotOf; ///< ハンドルの番号
+        std::vector<uint8_t> m_State;   ///< NodeState
+        std::vector<uint32_t> m_Stamp;  ///< 最後に計算した Update の番号(親が計算されたかを子から調べる)
+        std::vector<uint32_t> m_LevelBegin;
+
+        std::vector<Slot> m_Slots;
+        uint32_t m_FreeSlot = kNone;
+        std::vector<uint32_t> m_Pending; ///< 変更のあったノードの番号(位置は Update までに変わりうる)
+
+        // Update の作業領域(フレームをまたいで容量を使い回す)
+        std::vector<std::vector<uint32_t>> m_LevelWork;
+        std::vector<std::vector<uint32_t>> m_BatchOut;
+        std::vector<uint32_t> m_Scratch;
+        uint32_t m_UpdateSerial = 0;
+        uint32_t m_LastUpdated = 0;
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+// C++ standard library includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace Drama::Core::Job
+{
+    /// @brief Chase-Lev のワークスティーリング両端キュー(固定容量)
+    /// @note 持ち主のスレッドだけが Push/Pop で末尾(bottom)を触り、他のスレッドは Steal で先頭(top)から取る。
+    ///       持ち主同士・盗む側同士の競合は最後の1要素の top に対するCASだけで決着する。
+    ///       メモリ順序は Lê らの C11 版(PPoPP'13)に従う。容量を超えたら Push は false を返す。
+    template <class T>
+    class WorkStealingDeque final
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque holds pointers or small handles");
+
+    public:
+        WorkStealingDeque() = default;
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /// @brief 容量を確保する(2の冪に切り上げる)。使い始める前に1度だけ呼ぶ
+        void Init(size_t capacity)
+        {
+            size_t cap = 1;
+            while (cap < capacity)
+            {
+                cap <<= 1;
+            }
+            m_Buffer = std::make_unique<std::atomic<T>[]>(cap);
+            m_Mask = static_cast<int64_t>(cap) - 1;
+            m_Top.store(0, std::memory_order_relaxed);
+            m_Bottom.store(0, std::memory_order_relaxed);
+        }
+
+        /// @brief 持ち主: 末尾に積む
+        bool Push(T item) noexcept
+        {
+            const int64_t b = m_Bottom.load(std::memory_order_relaxed);
+            const int64_t t = m_Top.load(std::memory_order_acquire);
+            if (b - t > m_Mask)
+            {
+                return false;
+            }
+            // 要素自体も release/acquire にしておく(x86 では通常のストアと同じ。フェンスを解さない検査ツールにも順序が見える)
+            m_Buffer[b & m_Mask].store(item, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_Bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /// @brief 持ち主: 末尾から取る(最後に積んだものから。キャッシュに残っている可能性が高い)
+        bool Pop(T& out) noexcept
+        {
+            const int64_t b = m_Bottom.load(std::memory_order_relaxed) - 1;
+            m_Bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = m_Top.load(std::memory_order_relaxed);
+            if (t > b)
+            {
+                // 空だった
+                m_Bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            out = m_Buffer[b & m_Mask].load(std::memory_order_acquire);
+            if (t != b)
+            {
+                return true; // 2つ以上残っていたので盗む側とは競合しない
+            }
+            // 最後の1つ: 盗む側と取り合う
+            const bool won = m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_Bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        /// @brief 他のスレッド: 先頭から盗む(取り合いに負けたら false。空とは限らない)
+        bool Steal(T& out) noexcept
+        {
+            int64_t t = m_Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = m_Bottom.load(std::memory_order_acquire);
+            if (t >= b)
+            {
+                return false;
+            }
+            out = m_Buffer[t & m_Mask].load(std::memory_order_acquire);
+            return m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        /// @brief おおよその要素数(他スレッドから見ると古い値のことがある)
+        size_t ApproxSize() const noexcept
+        {
+            const int64_t b = m_Bottom.load(std::memory_order_relaxed);
+            const int64_t t = m_Top.load(std::memory_order_relaxed);
+            return (b > t) ? static_cast<size_t>(b - t) : 0;
+        }
+
+        size_t Capacity() const noexcept { return static_cast<size_t>(m_Mask + 1); }
+
+    private:
+        // 持ち主が書く bottom と盗む側が書く top を別のキャッシュラインに置く
+        alignas(64) std::atomic<int64_t> m_Top{ 0 };
+        alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+        alignas(64) std::unique_ptr<std::atomic<T>[]> m_Buffer;
+        int64_t m_Mask = -1;
+    };
+}
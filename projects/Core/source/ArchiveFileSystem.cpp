@@ -0,0 +1,294 @@
+#include "pch.h"
+#include "include/ArchiveFileSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    using namespace Drama::Core::IO;
+
+    FsResult MakeError(FsError e, const char* msg)
+    {
+        FsResult r;
+        r.error = e;
+        r.message = msg;
+        return r;
+    }
+
+    FsResult ReadOnlyError()
+    {
+        return MakeError(FsError::AccessDenied, "Archive is read-only.");
+    }
+
+    /// @brief パック内のビューは ArchiveFileSystem が持つので、解放では何もしない
+    void ReleaseNothing(const uint8_t*, size_t) noexcept
+    {
+    }
+
+    /// @brief メモリ上の範囲を読むストリーム
+    class MemoryFileReader final : public IFileReader
+    {
+    public:
+        explicit MemoryFileReader(std::span<const uint8_t> bytes) noexcept : m_Bytes(bytes) {}
+
+        FsResult Read(void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            FsResult r = ReadAt(m_Position, buffer, size, bytesRead);
+            m_Position += bytesRead;
+            return r;
+        }
+
+        FsResult ReadAt(uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            bytesRead = 0;
+            if (size > 0 && buffer == nullptr)
+            {
+                return MakeError(FsError::IoError, "Buffer is null.");
+            }
+            if (offset >= m_Bytes.size())
+            {
+                return FsResult::Ok();
+            }
+            bytesRead = static_cast<size_t>(std::min<uint64_t>(size, m_Bytes.size() - offset));
+            std::memcpy(buffer, m_Bytes.data() + offset, bytesRead);
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            m_Position = offset;
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override
+        {
+            out = m_Bytes.size();
+            return FsResult::Ok();
+        }
+
+    private:
+        std::span<const uint8_t> m_Bytes;
+        uint64_t m_Position = 0;
+    };
+}
+
+namespace Drama::Core::IO
+{
+    FsResult ArchiveFileSystem::Open(IFileSystem& fs, std::string_view archivePath) noexcept
+    {
+        Close();
+
+        MappedFile image;
+        if (FsResult r = fs.MapReadOnly(archivePath, image); !r)
+        {
+            return r;
+        }
+
+        // 壊れたパックで範囲外を読まないよう、ここで全エントリを検査する
+        const uint64_t fileSize = image.Size();
+        if (fileSize < sizeof(Pack::PackHeader))
+        {
+            return MakeError(FsError::IoError, "Archive is too small.");
+        }
+        Pack::PackHeader header{};
+        std::memcpy(&header, image.Data(), sizeof(header));
+        if (header.magic != Pack::kMagic || header.version != Pack::kVersion)
+        {
+            return MakeError(FsError::IoError, "Not a pack file or unsupported version.");
+        }
+        const uint64_t tableBytes = static_cast<uint64_t>(header.entryCount) * sizeof(Pack::PackEntry);
+        if (header.entryTableOffset % alignof(Pack::PackEntry) != 0 ||
+            header.entryTableOffset > fileSize || fileSize - header.entryTableOffset < tableBytes ||
+            header.stringTableOffset > fileSize || fileSize - header.stringTableOffset < header.stringTableSize)
+        {
+            return MakeError(FsError::IoError, "Archive tables are out of range.");
+        }
+
+        const auto* entries = reinterpret_cast<const Pack::PackEntry*>(image.Data() + header.entryTableOffset);
+        for (uint32_t i = 0; i < header.entryCount; ++i)
+        {
+            const Pack::PackEntry& e = entries[i];
+            if (e.dataOffset > fileSize || fileSize - e.dataOffset < e.size ||
+                static_cast<uint64_t>(e.pathOffset) + e.pathSize > header.stringTableSize ||
+                (i > 0 && entries[i - 1].pathHash > e.pathHash))
+            {
+                return MakeError(FsError::IoError, "Archive entry is corrupt.");
+            }
+        }
+
+        m_Image = std::move(image);
+        m_ArchivePath = std::string(archivePath);
+        m_Entries = reinterpret_cast<const Pack::PackEntry*>(m_Image.Data() + header.entryTableOffset);
+        m_EntryCount = header.entryCount;
+        m_Strings = reinterpret_cast<const char*>(m_Image.Data() + header.stringTableOffset);
+        return FsResult::Ok();
+    }
+
+    void ArchiveFileSystem::Close() noexcept
+    {
+        m_Entries = nullptr;
+        m_EntryCount = 0;
+        m_Strings = nullptr;
+        m_ArchivePath.clear();
+        m_Image.Reset();
+    }
+
+    std::string_view ArchiveFileSystem::EntryPath(size_t i) const noexcept
+    {
+        if (i >= m_EntryCount)
+        {
+            return {};
+        }
+        return std::string_view(m_Strings + m_Entries[i].pathOffset, m_Entries[i].pathSize);
+    }
+
+    const Pack::PackEntry* ArchiveFileSystem::FindEntry(std::string_view path) const noexcept
+    {
+        if (m_Entries == nullptr)
+        {
+            return nullptr;
+        }
+        const uint64_t hash = Pack::HashPath(path);
+        const Pack::PackEntry* end = m_Entries + m_EntryCount;
+        const Pack::PackEntry* it = std::lower_bound(m_Entries, end, hash,
+            [](const Pack::PackEntry& e, uint64_t h) { return e.pathHash < h; });
+        // ハッシュが衝突していればパス文字列で区別する
+        for (; it != end && it->pathHash == hash; ++it)
+        {
+            if (Pack::PathEquals(std::string_view(m_Strings + it->pathOffset, it->pathSize), path))
+            {
+                return it;
+            }
+        }
+        return nullptr;
+    }
+
+    bool ArchiveFileSystem::Find(std::string_view path, std::span<const uint8_t>& out) const noexcept
+    {
+        const Pack::PackEntry* e = FindEntry(path);
+        if (e == nullptr)
+        {
+            out = {};
+            return false;
+        }
+        out = std::span<const uint8_t>(m_Image.Data() + e->dataOffset, static_cast<size_t>(e->size));
+        return true;
+    }
+
+    FsResult ArchiveFileSystem::Exists(std::string_view path) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, "Path is empty.");
+        }
+        if (FindEntry(path) != nullptr)
+        {
+            return FsResult::Ok();
+        }
+
+        // ディレクトリとしての存在(配下にファイルがあるか)は線形に探す。頻繁に呼ばれる想定はない
+        std::string_view dir = Pack::TrimPathPrefix(path);
+        while (!dir.empty() && (dir.back() == '/' || dir.back() == '\\'))
+        {
+            dir.remove_suffix(1);
+        }
+        for (size_t i = 0; i < m_EntryCount && !dir.empty(); ++i)
+        {
+            const std::string_view p = EntryPath(i);
+            if (p.size() > dir.size() && p[dir.size()] == '/' && Pack::PathEquals(p.substr(0, dir.size()), dir))
+            {
+                return FsResult::Ok();
+            }
+        }
+        return MakeError(FsError::NotFound, "Path not found in archive.");
+    }
+
+    FsResult ArchiveFileSystem::CreateDirectories(std::string_view) noexcept
+    {
+        return ReadOnlyError();
+    }
+
+    FsResult ArchiveFileSystem::WriteAllBytes(std::string_view, const void*, size_t) noexcept
+    {
+        return ReadOnlyError();
+    }
+
+    FsResult ArchiveFileSystem::Remove(std::string_view) noexcept
+    {
+        return ReadOnlyError();
+    }
+
+    FsResult ArchiveFileSystem::ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept
+    {
+        out.clear();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, "Path is empty.");
+        }
+        std::span<const uint8_t> bytes;
+        if (!Find(path, bytes))
+        {
+            return MakeError(FsError::NotFound, "Path not found in archive.");
+        }
+        out.assign(bytes.begin(), bytes.end());
+        return FsResult::Ok();
+    }
+
+    FsResult ArchiveFileSystem::MapReadOnly(std::string_view path, MappedFile& out) noexcept
+    {
+        out.Reset();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, "Path is empty.");
+        }
+        std::span<const uint8_t> bytes;
+        if (!Find(path, bytes))
+        {
+            return MakeError(FsError::NotFound, "Path not found in archive.");
+        }
+        out = MappedFile::FromMapping(bytes.data(), bytes.size(), &ReleaseNothing);
+        return FsResult::Ok();
+    }
+
+    FsResult ArchiveFileSystem::AppendAllBytes(std::string_view, const void*, size_t) noexcept
+    {
+        return ReadOnlyError();
+    }
+
+    FsResult ArchiveFileSystem::WriteAllBytesAtomic(std::string_view, const void*, size_t) noexcept
+    {
+        return ReadOnlyError();
+    }
+
+    FsResult ArchiveFileSystem::OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept
+    {
+        out.reset();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, "Path is empty.");
+        }
+        std::span<const uint8_t> bytes;
+        if (!Find(path, bytes))
+        {
+            return MakeError(FsError::NotFound, "Path not found in archive.");
+        }
+        out = std::make_unique<MemoryFileReader>(bytes);
+        return FsResult::Ok();
+    }
+
+    FsResult ArchiveFileSystem::OpenWrite(std::string_view, FileWriteMode, std::unique_ptr<IFileWriter>& out) noexcept
+    {
+        out.reset();
+        return ReadOnlyError();
+    }
+
+    FsResult ArchiveFileSystem::CopyAllBytes(std::string_view, std::string_view) noexcept
+    {
+        return ReadOnlyError();
+    }
+}
@@ -0,0 +1,367 @@
+#include "pch.h"
+#include "include/AsyncFileService.h"
+#include "include/MemoryTracker.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    /// @brief サイズを調べられなかった読み込みに見込むバイト数(読み込みは失敗するはずなので小さくてよい)
+    constexpr size_t kUnknownReadBytes = 64 * 1024;
+
+    uint64_t NowNs() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /// @brief サービスが預かっている間のバッファを IO として数える
+    /// @note 書き込み内容は受け付けてから書き終わるか取り消すまで、読み込み結果は読んでからコールバックに渡すまで。
+    ///       コールバックの後で中身を持ち出すのは呼び出し側の持ち物なので数えない
+    void TrackBuffer(const std::vector<uint8_t>& buffer) noexcept
+    {
+        if (buffer.capacity() > 0)
+        {
+            Drama::Core::Memory::MemoryTracker::RecordAllocation(Drama::Core::Memory::MemoryTag::IO, buffer.data(), buffer.capacity());
+        }
+    }
+    void UntrackBuffer(const std::vector<uint8_t>& buffer) noexcept
+    {
+        if (buffer.capacity() > 0)
+        {
+            Drama::Core::Memory::MemoryTracker::RecordFree(Drama::Core::Memory::MemoryTag::IO, buffer.data(), buffer.capacity());
+        }
+    }
+}
+
+namespace Drama::Core::IO
+{
+    AsyncFileService::~AsyncFileService()
+    {
+        Stop();
+        // 配られなかった読み込み結果はここで手放す
+        for (const Done& d : m_Done)
+        {
+            UntrackBuffer(d.completion.data);
+        }
+    }
+
+    bool AsyncFileService::Start(IFileSystem& fs, const AsyncFileDesc& desc)
+    {
+        if (m_IsRunning.load(std::memory_order_acquire) || desc.workerCount == 0)
+        {
+            return false;
+        }
+
+        m_Fs = &fs;
+        m_Desc = desc;
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_IsStopRequested = false;
+            m_PeakQueued = 0;
+            m_PeakInFlightBytes = 0;
+        }
+
+        m_IsRunning.store(true, std::memory_order_release);
+        m_Workers.reserve(desc.workerCount);
+        for (uint32_t i = 0; i < desc.workerCount; ++i)
+        {
+            m_Workers.emplace_back([this]() { WorkerMain(); });
+        }
+        return true;
+    }
+
+    void AsyncFileService::Stop() noexcept
+    {
+        if (m_Workers.empty())
+        {
+            return;
+        }
+        m_IsRunning.store(false, std::memory_order_release);
+
+        // 待機中のものは取り消し扱いで通知する(コールバック側で後始末できるように)
+        std::vector<Pending> dropped;
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_IsStopRequested = true;
+            for (auto& q : m_Queues)
+            {
+                for (Pending& p : q)
+                {
+                    dropped.push_back(std::move(p));
+                }
+                q.clear();
+            }
+            m_Queued = 0;
+            m_Cancelled += dropped.size();
+        }
+        m_WorkCv.notify_all();
+
+        for (std::thread& t : m_Workers)
+        {
+            t.join();
+        }
+        m_Workers.clear();
+
+        for (Pending& p : dropped)
+        {
+            UntrackBuffer(p.request.data);
+            IoCompletion c{};
+            c.id = p.id;
+            c.op = p.request.op;
+            c.status = IoStatus::Cancelled;
+            c.path = std::move(p.request.path);
+            c.userData = p.request.userData;
+            c.submitNs = p.submitNs;
+            c.endNs = NowNs();
+            PushCompletion(std::move(c), std::move(p.request.onComplete));
+        }
+        m_IdleCv.notify_all();
+    }
+
+    IoRequestId AsyncFileService::Submit(IoRequest&& request)
+    {
+        std::vector<IoRequest> one;
+        one.push_back(std::move(request));
+        return SubmitBatch(std::move(one));
+    }
+
+    IoRequestId AsyncFileService::SubmitBatch(std::vector<IoRequest>&& requests)
+    {
+        if (requests.empty() || !m_IsRunning.load(std::memory_order_acquire))
+        {
+            return 0;
+        }
+
+        // 予想サイズの無い読み込みは、上限判定を素通りしないよう実際のサイズで数える(ロックの外で調べる)
+        for (IoRequest& r : requests)
+        {
+            if (r.op == IoOp::Read && r.sizeHint == 0)
+            {
+                uint64_t size = 0;
+                r.sizeHint = m_Fs->FileSize(r.path, size) ? static_cast<size_t>(size) : kUnknownReadBytes;
+            }
+        }
+
+        const uint64_t now = NowNs();
+        IoRequestId first = 0;
+        {
+            std::scoped_lock lock(m_Mutex);
+            if (m_IsStopRequested)
+            {
+                return 0;
+            }
+            first = m_NextId;
+            for (IoRequest& r : requests)
+            {
+                TrackBuffer(r.data);
+                const size_t q = std::min(static_cast<size_t>(r.priority), m_Queues.size() - 1);
+                m_Queues[q].push_back(Pending{ m_NextId++, std::move(r), now });
+            }
+            m_Queued += requests.size();
+            m_PeakQueued = std::max(m_PeakQueued, m_Queued);
+        }
+        if (requests.size() == 1)
+        {
+            m_WorkCv.notify_one();
+        }
+        else
+        {
+            m_WorkCv.notify_all();
+        }
+        return first;
+    }
+
+    bool AsyncFileService::Cancel(IoRequestId id)
+    {
+        Pending victim;
+        {
+            std::scoped_lock lock(m_Mutex);
+            bool isFound = false;
+            for (auto& q : m_Queues)
+            {
+                const auto it = std::find_if(q.begin(), q.end(), [id](const Pending& p) { return p.id == id; });
+                if (it != q.end())
+                {
+                    victim = std::move(*it);
+                    q.erase(it);
+                    isFound = true;
+                    break;
+                }
+            }
+            if (!isFound)
+            {
+                return false;
+            }
+            --m_Queued;
+            ++m_Cancelled;
+        }
+
+        UntrackBuffer(victim.request.data);
+        IoCompletion c{};
+        c.id = victim.id;
+        c.op = victim.request.op;
+        c.status = IoStatus::Cancelled;
+        c.path = std::move(victim.request.path);
+        c.userData = victim.request.userData;
+        c.submitNs = victim.submitNs;
+        c.endNs = NowNs();
+        PushCompletion(std::move(c), std::move(victim.request.onComplete));
+        m_IdleCv.notify_all();
+        return true;
+    }
+
+    size_t AsyncFileService::DispatchCompletions(size_t maxCount)
+    {
+        {
+            std::scoped_lock lock(m_DoneMutex);
+            if (m_Done.empty())
+            {
+                return 0;
+            }
+            const size_t n = std::min(maxCount, m_Done.size());
+            m_Dispatching.clear();
+            m_Dispatching.insert(m_Dispatching.end(),
+                std::make_move_iterator(m_Done.begin()), std::make_move_iterator(m_Done.begin() + n));
+            m_Done.erase(m_Done.begin(), m_Done.begin() + n);
+        }
+
+        // コールバックはロック外で呼ぶ(中から Submit してよい)
+        for (Done& d : m_Dispatching)
+        {
+            UntrackBuffer(d.completion.data);
+            if (d.callback)
+            {
+                d.callback(d.completion);
+            }
+        }
+        const size_t count = m_Dispatching.size();
+        m_Dispatching.clear();
+        return count;
+    }
+
+    void AsyncFileService::WaitIdle()
+    {
+        std::unique_lock lock(m_Mutex);
+        m_IdleCv.wait(lock, [this]() { return m_Queued == 0 && m_Running == 0; });
+    }
+
+    AsyncFileStats AsyncFileService::Stats() const
+    {
+        AsyncFileStats s{};
+        {
+            std::scoped_lock lock(m_Mutex);
+            s.queued = m_Queued;
+            s.running = m_Running;
+            s.inFlightBytes = m_InFlightBytes;
+            s.peakQueued = m_PeakQueued;
+            s.peakInFlightBytes = m_PeakInFlightBytes;
+            s.cancelled = m_Cancelled;
+        }
+        {
+            std::scoped_lock lock(m_DoneMutex);
+            s.completed = m_Completed;
+        }
+        return s;
+    }
+
+    size_t AsyncFileService::CostOf(const IoRequest& request) noexcept
+    {
+        return (request.op == IoOp::Read) ? request.sizeHint : request.data.size();
+    }
+
+    bool AsyncFileService::PopNext_NoLock(Pending& out, size_t& bytes)
+    {
+        for (auto& q : m_Queues)
+        {
+            if (q.empty())
+            {
+                continue;
+            }
+            // 上限を超える場合は、優先度を飛ばさずに枠が空くのを待つ。
+            // ただし何も実行していなければ、上限より大きい要求でも1件は通す(永久に止まらないように)
+            const size_t cost = CostOf(q.front().request);
+            if (m_Running > 0 && m_InFlightBytes + cost > m_Desc.maxInFlightBytes)
+            {
+                return false;
+            }
+            out = std::move(q.front());
+            q.pop_front();
+            bytes = cost;
+            --m_Queued;
+            ++m_Running;
+            m_InFlightBytes += cost;
+            m_PeakInFlightBytes = std::max(m_PeakInFlightBytes, m_InFlightBytes);
+            return true;
+        }
+        return false;
+    }
+
+    void AsyncFileService::PushCompletion(IoCompletion&& completion, std::function<void(IoCompletion&)>&& callback)
+    {
+        std::scoped_lock lock(m_DoneMutex);
+        m_Done.push_back(Done{ std::move(completion), std::move(callback) });
+        ++m_Completed;
+    }
+
+    void AsyncFileService::WorkerMain()
+    {
+        while (true)
+        {
+            Pending job;
+            size_t bytes = 0;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_WorkCv.wait(lock, [this, &job, &bytes]()
+                    {
+                        return m_IsStopRequested || PopNext_NoLock(job, bytes);
+                    });
+                if (job.id == 0)
+                {
+                    return; // 停止要求
+                }
+            }
+
+            IoCompletion c{};
+            c.id = job.id;
+            c.op = job.request.op;
+            c.userData = job.request.userData;
+            c.submitNs = job.submitNs;
+            c.startNs = NowNs();
+
+            IoRequest& r = job.request;
+            switch (r.op)
+            {
+            case IoOp::Read:
+                c.result = m_Fs->ReadAllBytes(r.path, c.data);
+                TrackBuffer(c.data);
+                break;
+            case IoOp::Write:
+                c.result = m_Fs->WriteAllBytes(r.path, r.data.data(), r.data.size());
+                break;
+            case IoOp::Append:
+                c.result = m_Fs->AppendAllBytes(r.path, r.data.data(), r.data.size());
+                break;
+            case IoOp::WriteAtomic:
+                c.result = m_Fs->WriteAllBytesAtomic(r.path, r.data.data(), r.data.size());
+                break;
+            }
+            c.endNs = NowNs();
+            UntrackBuffer(r.data);
+            c.status = c.result ? IoStatus::Completed : IoStatus::Failed;
+            c.path = std::move(r.path);
+            PushCompletion(std::move(c), std::move(r.onComplete));
+
+            {
+                std::scoped_lock lock(m_Mutex);
+                --m_Running;
+                m_InFlightBytes -= bytes;
+            }
+            // 枠が空いたので、上限で止まっていた他のスレッドも起こす
+            m_WorkCv.notify_all();
+            m_IdleCv.notify_all();
+        }
+    }
+}
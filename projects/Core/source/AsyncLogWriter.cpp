@@ -0,0 +1,283 @@
+#include "pch.h"
+#include "include/AsyncLogWriter.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Drama::Core
+{
+    AsyncLogWriter::~AsyncLogWriter()
+    {
+        Stop();
+    }
+
+    bool AsyncLogWriter::Start(const AsyncLogDesc& desc, Sink sink)
+    {
+        if (m_IsRunning.load(std::memory_order_acquire) || !sink)
+        {
+            return false;
+        }
+        // 前回 Stop した後に受付チェックで弾かれる途中の生産者がまだ m_Ring に触れているかもしれない
+        WaitProducers();
+        if (!m_Ring.Init(desc.slotCount))
+        {
+            return false;
+        }
+
+        m_Desc = desc;
+        m_Sink = std::move(sink);
+        m_IsSinkOk.store(true, std::memory_order_relaxed);
+        m_DroppedPending.store(0, std::memory_order_relaxed);
+        m_DroppedTotal.store(0, std::memory_order_relaxed);
+        m_WrittenPos.store(0, std::memory_order_relaxed);
+        {
+            std::scoped_lock lock(m_WakeMutex);
+            m_IsStopRequested = false;
+            m_IsFlushRequested = false;
+        }
+        // 最悪ケース(全スロット分)で一度だけ確保しておく
+        m_Batch.clear();
+        m_Batch.reserve(m_Ring.Capacity() * MpscRingBuffer::kSlotPayload);
+
+        m_IsRunning.store(true, std::memory_order_release);
+        m_Thread = std::thread([this]() { ThreadMain(); });
+        return true;
+    }
+
+    void AsyncLogWriter::Stop() noexcept
+    {
+        if (!m_Thread.joinable())
+        {
+            return;
+        }
+        // 先に受付を止め、受付チェックを通り抜けた生産者が積み終えるのを待ってから、
+        // 書き込みスレッドに残りを吐き出させる(最後の吐き出しの後に積まれる行が無いようにする)
+        m_IsRunning.store(false, std::memory_order_seq_cst);
+        WaitProducers();
+        {
+            std::scoped_lock lock(m_WakeMutex);
+            m_IsStopRequested = true;
+        }
+        m_WakeCv.notify_one();
+        m_Thread.join();
+
+        {
+            std::scoped_lock lock(m_WakeMutex);
+        }
+        m_DoneCv.notify_all();
+    }
+
+    LogPushResult AsyncLogWriter::PushLine(std::string_view line) noexcept
+    {
+        if (!EnterProducer())
+        {
+            return LogPushResult::Stopped;
+        }
+
+        // 改行付きの1レコードをスレッドごとの作業領域で組み立てる(確保は初回のみ)
+        thread_local std::string tls_Record;
+        const size_t maxBody = m_Ring.MaxRecordBytes() - 1;
+        const size_t body = (line.size() > maxBody) ? maxBody : line.size();
+        tls_Record.assign(line.data(), body);
+        tls_Record.push_back('\n');
+
+        const LogPushResult result = PushBytes(tls_Record.data(), tls_Record.size());
+        LeaveProducer();
+        return result;
+    }
+
+    LogPushResult AsyncLogWriter::PushRecord(const void* data, size_t size) noexcept
+    {
+        if (!EnterProducer())
+        {
+            return LogPushResult::Stopped;
+        }
+        // 行と違って切り詰めると読めなくなるので、収まらないものは呼び出し側に返す
+        const LogPushResult result = (size > m_Ring.MaxRecordBytes()) ?
+            LogPushResult::Rejected : PushBytes(data, size);
+        LeaveProducer();
+        return result;
+    }
+
+    bool AsyncLogWriter::EnterProducer() noexcept
+    {
+        // 数を増やしてから受付を確かめる。Stop は受付を止めてから数が 0 になるのを待つので、
+        // ここを通り抜けた生産者の行は必ず最後の吐き出しに含まれる
+        m_Producers.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_IsRunning.load(std::memory_order_seq_cst))
+        {
+            m_Producers.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    void AsyncLogWriter::LeaveProducer() noexcept
+    {
+        m_Producers.fetch_sub(1, std::memory_order_release);
+    }
+
+    LogPushResult AsyncLogWriter::PushBytes(const void* data, size_t size) noexcept
+    {
+        while (!m_Ring.TryPush(data, size))
+        {
+            if (m_Desc.overflow == LogOverflowPolicy::Drop)
+            {
+                m_DroppedPending.fetch_add(1, std::memory_order_relaxed);
+                m_DroppedTotal.fetch_add(1, std::memory_order_relaxed);
+                Wake();
+                return LogPushResult::Dropped;
+            }
+            Wake();
+            std::this_thread::yield();
+        }
+
+        // 半分を超えたら待たずに起こす。それ以外はタイムアウトでまとめて拾う。
+        if (m_Ring.ApproxUsed() >= m_Ring.Capacity() / 2)
+        {
+            Wake();
+        }
+        return LogPushResult::Queued;
+    }
+
+    bool AsyncLogWriter::Flush() noexcept
+    {
+        if (!m_IsRunning.load(std::memory_order_acquire))
+        {
+            return m_IsSinkOk.exchange(true, std::memory_order_acq_rel);
+        }
+
+        const uint64_t target = m_Ring.EnqueuePosition();
+        {
+            std::unique_lock lock(m_WakeMutex);
+            m_IsFlushRequested = true;
+            m_WakeCv.notify_one();
+            m_DoneCv.wait(lock, [this, target]()
+                {
+                    return m_WrittenPos.load(std::memory_order_acquire) >= target ||
+                        !m_IsRunning.load(std::memory_order_acquire);
+                });
+        }
+        return m_IsSinkOk.exchange(true, std::memory_order_acq_rel);
+    }
+
+    void AsyncLogWriter::ThreadMain()
+    {
+        const auto idle = std::chrono::milliseconds(m_Desc.idleWaitMs);
+        const size_t highWater = m_Ring.Capacity() / 2;
+
+        while (true)
+        {
+            bool isStop = false;
+            {
+                std::unique_lock lock(m_WakeMutex);
+                m_WakeCv.wait_for(lock, idle, [this, highWater]()
+                    {
+                        return m_IsStopRequested || m_IsFlushRequested ||
+                            m_Ring.ApproxUsed() >= highWater ||
+                            m_DroppedPending.load(std::memory_order_relaxed) > 0;
+                    });
+                m_IsFlushRequested = false;
+                isStop = m_IsStopRequested;
+            }
+
+            while (DrainAndWrite())
+            {
+            }
+
+            // Flush側の待機と取りこぼしが起きないよう、一度ロックを通してから通知する
+            {
+                std::scoped_lock lock(m_WakeMutex);
+            }
+            m_DoneCv.notify_all();
+
+            if (isStop)
+            {
+                break;
+            }
+        }
+    }
+
+    bool AsyncLogWriter::DrainAndWrite()
+    {
+        if (!m_Desc.isFramed)
+        {
+            m_Batch.clear();
+        }
+
+        // isFramed では件数だけ数える(バイナリの並びに行を混ぜない)
+        const uint64_t dropped = m_DroppedPending.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0 && !m_Desc.isFramed)
+        {
+            m_Batch.append("[LogAssert] dropped ");
+            m_Batch.append(std::to_string(dropped));
+            m_Batch.append(" line(s)\n");
+        }
+
+        const size_t slots = m_Ring.Drain([this](const char* data, size_t size)
+            {
+                m_Batch.append(data, size);
+            });
+
+        if (m_Desc.isFramed)
+        {
+            // スロットはレコードの途中で公開が止まることがあるので、揃った分だけ渡して残りは持ち越す
+            size_t records = 0;
+            const size_t end = CompleteFramesEnd(records);
+            if (end > 0)
+            {
+                if (!m_Sink(m_Batch.data(), end, records))
+                {
+                    m_IsSinkOk.store(false, std::memory_order_release);
+                }
+                m_Batch.erase(0, end);
+            }
+        }
+        else if (!m_Batch.empty())
+        {
+            const size_t lines = static_cast<size_t>(std::count(m_Batch.begin(), m_Batch.end(), '\n'));
+            if (!m_Sink(m_Batch.data(), m_Batch.size(), lines))
+            {
+                m_IsSinkOk.store(false, std::memory_order_release);
+            }
+        }
+
+        m_WrittenPos.store(m_Ring.DequeuePosition(), std::memory_order_release);
+        return slots > 0;
+    }
+
+    size_t AsyncLogWriter::CompleteFramesEnd(size_t& records) const noexcept
+    {
+        records = 0;
+        size_t at = 0;
+        while (m_Batch.size() - at >= sizeof(uint32_t))
+        {
+            uint32_t length = 0;
+            std::memcpy(&length, m_Batch.data() + at, sizeof(length));
+            if (m_Batch.size() - at - sizeof(length) < length)
+            {
+                break;
+            }
+            at += sizeof(length) + length;
+            ++records;
+        }
+        return at;
+    }
+
+    void AsyncLogWriter::WaitProducers() const noexcept
+    {
+        // 生産者は受付チェックの直後に抜けるか、1行積むだけなので長くは待たない
+        while (m_Producers.load(std::memory_order_acquire) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void AsyncLogWriter::Wake() noexcept
+    {
+        // タイムアウト付きで待っているので、取りこぼしても遅延は idleWaitMs に収まる
+        m_WakeCv.notify_one();
+    }
+}
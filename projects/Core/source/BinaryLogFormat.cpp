@@ -0,0 +1,368 @@
+#include "pch.h"
+#include "include/BinaryLogFormat.h"
+
+// C++ standard library includes
+#include <unordered_map>
+#include <variant>
+
+namespace
+{
+    using namespace Drama::Core::BinaryLog;
+
+    using ArgValue = std::variant<int64_t, uint64_t, double, bool, char, std::string, const void*>;
+
+    class Reader
+    {
+    public:
+        Reader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+        template <class T>
+        bool Get(T& v) noexcept
+        {
+            if (m_Size - m_Pos < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&v, m_Data + m_Pos, sizeof(T));
+            m_Pos += sizeof(T);
+            return true;
+        }
+
+        bool GetString(std::string& s)
+        {
+            uint32_t len = 0;
+            if (!Get(len) || m_Size - m_Pos < len)
+            {
+                return false;
+            }
+            s.assign(reinterpret_cast<const char*>(m_Data + m_Pos), len);
+            m_Pos += len;
+            return true;
+        }
+
+        bool IsEnd() const noexcept { return m_Pos >= m_Size; }
+        void Skip(size_t bytes) noexcept { m_Pos = (m_Size - m_Pos < bytes) ? m_Size : m_Pos + bytes; }
+
+    private:
+        const uint8_t* m_Data;
+        size_t m_Size;
+        size_t m_Pos = 0;
+    };
+
+    bool ReadArg(Reader& r, ArgValue& v)
+    {
+        ArgType type{};
+        if (!r.Get(type))
+        {
+            return false;
+        }
+        switch (type)
+        {
+        case ArgType::I64: { int64_t x = 0; if (!r.Get(x)) return false; v = x; return true; }
+        case ArgType::U64: { uint64_t x = 0; if (!r.Get(x)) return false; v = x; return true; }
+        case ArgType::F64: { double x = 0; if (!r.Get(x)) return false; v = x; return true; }
+        case ArgType::Bool: { uint8_t x = 0; if (!r.Get(x)) return false; v = (x != 0); return true; }
+        case ArgType::Char: { char x = 0; if (!r.Get(x)) return false; v = x; return true; }
+        case ArgType::String: { std::string x; if (!r.GetString(x)) return false; v = std::move(x); return true; }
+        case ArgType::Pointer:
+        {
+            uint64_t x = 0;
+            if (!r.Get(x)) return false;
+            v = reinterpret_cast<const void*>(static_cast<uintptr_t>(x));
+            return true;
+        }
+        }
+        return false;
+    }
+
+    bool IsDigit(char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    bool IsAlign(char c) noexcept
+    {
+        return c == '<' || c == '>' || c == '^';
+    }
+
+    /// @brief 桁の並びを読み飛ばす。壊れた書式に備え、桁数の多すぎる幅・精度は不正とする
+    bool SkipNumber(std::string_view spec, size_t& i) noexcept
+    {
+        const size_t begin = i;
+        while (i < spec.size() && IsDigit(spec[i]))
+        {
+            ++i;
+        }
+        return i - begin <= 6;
+    }
+
+    /// @brief 標準の書式指定がその値で受け付けられるかを調べる
+    /// @note 復号側の型変換(例: int32→int64)で記録時の検証と合わなくなる場合があるので、
+    ///       std::format に渡す前にここで弾く(例外に頼らない)
+    bool IsValidSpec(std::string_view spec, const ArgValue& arg) noexcept
+    {
+        // [[fill]align] fill は UTF-8 の1文字
+        size_t i = 0;
+        const uint8_t lead = spec.empty() ? 0 : static_cast<uint8_t>(spec[0]);
+        const size_t fillBytes = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+        if (spec.size() > fillBytes && IsAlign(spec[fillBytes]))
+        {
+            if (spec[0] == '{' || spec[0] == '}')
+            {
+                return false;
+            }
+            i = fillBytes + 1;
+        }
+        else if (!spec.empty() && IsAlign(spec[0]))
+        {
+            i = 1;
+        }
+
+        // [sign][#][0][width][.precision][L][type]
+        const bool hasSign = i < spec.size() && (spec[i] == '+' || spec[i] == '-' || spec[i] == ' ');
+        i += hasSign ? 1 : 0;
+        const bool hasAlt = i < spec.size() && spec[i] == '#';
+        i += hasAlt ? 1 : 0;
+        const bool hasZero = i < spec.size() && spec[i] == '0';
+        i += hasZero ? 1 : 0;
+        if (!SkipNumber(spec, i))
+        {
+            return false;
+        }
+        bool hasPrecision = false;
+        if (i < spec.size() && spec[i] == '.')
+        {
+            const size_t begin = ++i;
+            if (!SkipNumber(spec, i) || i == begin)
+            {
+                return false;
+            }
+            hasPrecision = true;
+        }
+        const bool hasLocale = i < spec.size() && spec[i] == 'L';
+        i += hasLocale ? 1 : 0;
+        const char type = (i < spec.size()) ? spec[i++] : '\0';
+        if (i != spec.size())
+        {
+            return false;
+        }
+
+        const bool isIntegerType = type != '\0' && std::string_view("bBdoxX").find(type) != std::string_view::npos;
+        const bool hasNumericFlags = hasSign || hasAlt || hasZero;
+        switch (arg.index())
+        {
+        case 0: // int64_t
+        case 1: // uint64_t
+        {
+            if (hasPrecision)
+            {
+                return false;
+            }
+            if (type == 'c')
+            {
+                // 文字として出すには char に収まる値でなければならない
+                const bool fits = (arg.index() == 0) ?
+                    (std::get<int64_t>(arg) >= -128 && std::get<int64_t>(arg) <= 127) :
+                    (std::get<uint64_t>(arg) <= 127);
+                return fits && !hasNumericFlags;
+            }
+            return type == '\0' || isIntegerType;
+        }
+        case 2: // double
+            return type == '\0' || std::string_view("aAeEfFgG").find(type) != std::string_view::npos;
+        case 3: // bool
+        case 4: // char
+        {
+            if (hasPrecision)
+            {
+                return false;
+            }
+            const char textType = (arg.index() == 3) ? 's' : 'c';
+            if (type == '\0' || type == textType)
+            {
+                return !hasNumericFlags;
+            }
+            return isIntegerType;
+        }
+        case 5: // std::string
+            return (type == '\0' || type == 's') && !hasNumericFlags && !hasLocale;
+        case 6: // const void*
+            return (type == '\0' || type == 'p') && !hasNumericFlags && !hasLocale && !hasPrecision;
+        default:
+            return false;
+        }
+    }
+
+    /// @brief 1フィールド分を書式化する。書式指定が型に合わない場合は "{?}"
+    void FormatField(std::string& out, std::string_view spec, const ArgValue& arg)
+    {
+        if (!IsValidSpec(spec, arg))
+        {
+            out += "{?}";
+            return;
+        }
+        const std::string fmt = "{:" + std::string(spec) + "}";
+        std::visit([&](const auto& value)
+            {
+                auto copy = value;
+                out += std::vformat(fmt, std::make_format_args(copy));
+            }, arg);
+    }
+
+    /// @brief std::format 互換の置換フィールドを、保存された引数で埋める
+    void Render(std::string& out, std::string_view fmt, const std::vector<ArgValue>& args)
+    {
+        size_t autoIndex = 0;
+        size_t i = 0;
+        while (i < fmt.size())
+        {
+            const char c = fmt[i];
+            if (c == '{')
+            {
+                if (i + 1 < fmt.size() && fmt[i + 1] == '{')
+                {
+                    out += '{';
+                    i += 2;
+                    continue;
+                }
+                // 対応する '}' を探す(動的幅などの入れ子を考慮)
+                size_t depth = 1;
+                size_t j = i + 1;
+                while (j < fmt.size() && depth > 0)
+                {
+                    if (fmt[j] == '{') ++depth;
+                    else if (fmt[j] == '}') --depth;
+                    if (depth > 0) ++j;
+                }
+                if (j >= fmt.size())
+                {
+                    out.append(fmt.substr(i));
+                    return;
+                }
+                const std::string_view field = fmt.substr(i + 1, j - i - 1);
+                const size_t colon = field.find(':');
+                const std::string_view idPart = field.substr(0, colon);
+                const std::string_view spec = (colon == std::string_view::npos) ? std::string_view{} : field.substr(colon + 1);
+
+                size_t index = 0;
+                if (idPart.empty())
+                {
+                    index = autoIndex++;
+                }
+                else
+                {
+                    for (char d : idPart)
+                    {
+                        index = index * 10 + static_cast<size_t>(d - '0');
+                    }
+                }
+
+                if (index < args.size() && spec.find('{') == std::string_view::npos)
+                {
+                    FormatField(out, spec, args[index]);
+                }
+                else
+                {
+                    out += "{?}";
+                }
+                i = j + 1;
+                continue;
+            }
+            if (c == '}' && i + 1 < fmt.size() && fmt[i + 1] == '}')
+            {
+                out += '}';
+                i += 2;
+                continue;
+            }
+            out += c;
+            ++i;
+        }
+    }
+}
+
+namespace Drama::Core::BinaryLog
+{
+    bool ReadFileHeader(const uint8_t* data, size_t size, uint64_t& startTimeNs, uint16_t& segment) noexcept
+    {
+        Reader r(data, size);
+        uint32_t magic = 0;
+        uint16_t version = 0;
+        if (!r.Get(magic) || !r.Get(version) || !r.Get(segment) || !r.Get(startTimeNs))
+        {
+            return false;
+        }
+        return magic == kFileMagic && version == kFileVersion;
+    }
+
+    bool DecodeToText(const uint8_t* data, size_t size, std::string& out)
+    {
+        Reader r(data, size);
+
+        uint64_t startTimeNs = 0;
+        uint16_t segment = 0;
+        if (!ReadFileHeader(data, size, startTimeNs, segment))
+        {
+            return false;
+        }
+        r.Skip(sizeof(uint32_t) + sizeof(uint16_t) * 2 + sizeof(uint64_t));
+
+        std::unordered_map<uint64_t, std::string> formats;
+        std::vector<ArgValue> args;
+
+        while (!r.IsEnd())
+        {
+            RecordKind kind{};
+            uint64_t id = 0;
+            if (!r.Get(kind) || !r.Get(id))
+            {
+                return false;
+            }
+
+            if (kind == RecordKind::FormatDef)
+            {
+                std::string fmt;
+                if (!r.GetString(fmt))
+                {
+                    return false;
+                }
+                formats[id] = std::move(fmt);
+                continue;
+            }
+            if (kind != RecordKind::Message)
+            {
+                return false;
+            }
+
+            LogLevel level{};
+            uint64_t timeNs = 0;
+            uint8_t argc = 0;
+            if (!r.Get(level) || !r.Get(timeNs) || !r.Get(argc))
+            {
+                return false;
+            }
+            args.clear();
+            for (uint8_t i = 0; i < argc; ++i)
+            {
+                ArgValue v;
+                if (!ReadArg(r, v))
+                {
+                    return false;
+                }
+                args.push_back(std::move(v));
+            }
+
+            out += std::format("[+{:.6f}s][{}] ", static_cast<double>(timeNs) * 1e-9, ToString(level));
+            const auto it = formats.find(id);
+            if (it == formats.end())
+            {
+                out += std::format("<unknown format {:016x}>", id);
+            }
+            else
+            {
+                Render(out, it->second, args);
+            }
+            out += '\n';
+        }
+        return true;
+    }
+}
@@ -0,0 +1,217 @@
+#include "pch.h"
+#include "include/CompressedBlob.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include "include/JobSystem.h"
+#include "include/LzCodec.h"
+
+namespace
+{
+    using Drama::Core::Job::JobSystem;
+
+    /// @brief ジョブに分ける価値があるか(止まっているジョブシステムに投入すると Wait が戻らない)
+    bool CanSpread(JobSystem* jobs, size_t count) noexcept
+    {
+        return jobs != nullptr && jobs->IsRunning() && jobs->ThreadCount() > 1 && count > 1;
+    }
+}
+
+namespace Drama::Core::IO::Blob
+{
+    bool IsBlob(std::span<const uint8_t> head) noexcept
+    {
+        if (head.size() < sizeof(BlobHeader))
+        {
+            return false;
+        }
+        BlobHeader header{};
+        std::memcpy(&header, head.data(), sizeof(header));
+        return header.magic == kMagic && header.version == kVersion;
+    }
+
+    bool BuildIndex(const BlobHeader& header, std::span<const BlockEntry> blocks, uint64_t fileSize, BlobIndex& out)
+    {
+        if (header.magic != kMagic || header.version != kVersion || blocks.size() != header.blockCount)
+        {
+            return false;
+        }
+        out.header = header;
+        out.blocks.assign(blocks.begin(), blocks.end());
+        out.rawOffsets.resize(blocks.size() + 1);
+
+        uint64_t raw = 0;
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            const BlockEntry& e = blocks[i];
+            const bool stored = (e.flags & kBlockStored) != 0;
+            if (e.rawSize == 0 || e.rawSize > kMaxBlockSize ||
+                (stored && e.storedSize != e.rawSize) ||
+                e.offset < sizeof(BlobHeader) || e.offset > fileSize || fileSize - e.offset < e.storedSize)
+            {
+                return false;
+            }
+            out.rawOffsets[i] = raw;
+            raw += e.rawSize;
+        }
+        out.rawOffsets.back() = raw;
+        return raw == header.rawSize;
+    }
+
+    size_t FindBlock(const BlobIndex& index, uint64_t rawOffset) noexcept
+    {
+        // rawOffsets は昇順。rawOffset を越える最初の開始位置の1つ手前が含むブロック
+        const auto it = std::upper_bound(index.rawOffsets.begin(), index.rawOffsets.end(), rawOffset);
+        if (it == index.rawOffsets.end())
+        {
+            return index.blocks.size();
+        }
+        return static_cast<size_t>(it - index.rawOffsets.begin()) - 1;
+    }
+
+    void CompressBlock(const uint8_t* raw, size_t size, std::vector<uint8_t>& stored, uint32_t& flags,
+        Compression::CompressScratch& scratch)
+    {
+        stored.resize(Compression::CompressBound(size));
+        const size_t packed = Compression::Compress(raw, size, stored.data(), stored.size(), scratch);
+        if (packed == 0 || packed >= size)
+        {
+            stored.assign(raw, raw + size);
+            flags = kBlockStored;
+            return;
+        }
+        stored.resize(packed);
+        flags = 0;
+    }
+
+    bool DecompressBlock(const BlockEntry& entry, const uint8_t* stored, uint8_t* dst) noexcept
+    {
+        if ((entry.flags & kBlockStored) != 0)
+        {
+            std::memcpy(dst, stored, entry.rawSize);
+            return true;
+        }
+        return Compression::Decompress(stored, entry.storedSize, dst, entry.rawSize);
+    }
+
+    void Encode(std::span<const uint8_t> raw, uint32_t blockSize, Job::JobSystem* jobs, std::vector<uint8_t>& out)
+    {
+        blockSize = std::clamp(blockSize, kMinBlockSize, kMaxBlockSize);
+        const size_t blockCount = (raw.size() + blockSize - 1) / blockSize;
+
+        // ブロックごとに別のバッファへ圧縮してから連結する(各ブロックの大きさは圧縮するまで分からない)
+        std::vector<std::vector<uint8_t>> packed(blockCount);
+        std::vector<BlockEntry> entries(blockCount);
+        auto compress = [&](size_t i, Compression::CompressScratch& scratch)
+            {
+                const size_t begin = i * blockSize;
+                const size_t size = std::min<size_t>(blockSize, raw.size() - begin);
+                CompressBlock(raw.data() + begin, size, packed[i], entries[i].flags, scratch);
+                entries[i].rawSize = static_cast<uint32_t>(size);
+                entries[i].storedSize = static_cast<uint32_t>(packed[i].size());
+            };
+
+        if (!CanSpread(jobs, blockCount))
+        {
+            auto scratch = std::make_unique<Compression::CompressScratch>();
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                compress(i, *scratch);
+            }
+        }
+        else
+        {
+            // 探索表は1つ 64KB あるので、ブロックごとではなくスレッド数の2倍の区画ごとに持つ。
+            // 区画内の重さの偏りは盗みでならす
+            const size_t pieces = std::min<size_t>(blockCount, static_cast<size_t>(jobs->ThreadCount()) * 2);
+            auto scratch = std::make_unique<Compression::CompressScratch[]>(pieces);
+            jobs->ParallelFor(pieces, [&](size_t begin, size_t end)
+                {
+                    for (size_t p = begin; p < end; ++p)
+                    {
+                        for (size_t i = p * blockCount / pieces; i < (p + 1) * blockCount / pieces; ++i)
+                        {
+                            compress(i, scratch[p]);
+                        }
+                    }
+                }, 1);
+        }
+
+        uint64_t offset = sizeof(BlobHeader);
+        for (BlockEntry& e : entries)
+        {
+            e.offset = offset;
+            offset += e.storedSize;
+        }
+
+        BlobHeader header{};
+        header.blockSize = blockSize;
+        header.blockCount = static_cast<uint32_t>(blockCount);
+        header.rawSize = raw.size();
+        header.indexOffset = offset;
+
+        out.resize(static_cast<size_t>(offset) + blockCount * sizeof(BlockEntry));
+        std::memcpy(out.data(), &header, sizeof(header));
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            if (!packed[i].empty())
+            {
+                std::memcpy(out.data() + entries[i].offset, packed[i].data(), packed[i].size());
+            }
+        }
+        if (blockCount > 0)
+        {
+            std::memcpy(out.data() + offset, entries.data(), blockCount * sizeof(BlockEntry));
+        }
+    }
+
+    bool ReadIndex(std::span<const uint8_t> blob, BlobIndex& out)
+    {
+        if (!IsBlob(blob))
+        {
+            return false;
+        }
+        BlobHeader header{};
+        std::memcpy(&header, blob.data(), sizeof(header));
+        const uint64_t indexBytes = static_cast<uint64_t>(header.blockCount) * sizeof(BlockEntry);
+        if (header.indexOffset > blob.size() || blob.size() - header.indexOffset < indexBytes)
+        {
+            return false;
+        }
+        // 索引の位置は揃っていないことがあるのでコピーしてから使う
+        std::vector<BlockEntry> blocks(header.blockCount);
+        if (!blocks.empty())
+        {
+            std::memcpy(blocks.data(), blob.data() + header.indexOffset, static_cast<size_t>(indexBytes));
+        }
+        return BuildIndex(header, blocks, blob.size(), out);
+    }
+
+    bool Decode(std::span<const uint8_t> blob, const BlobIndex& index, uint8_t* dst, Job::JobSystem* jobs)
+    {
+        std::atomic<bool> ok{ true };
+        auto decode = [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const BlockEntry& e = index.blocks[i];
+                    if (!DecompressBlock(e, blob.data() + e.offset, dst + index.rawOffsets[i]))
+                    {
+                        ok.store(false, std::memory_order_relaxed);
+                    }
+                }
+            };
+        if (CanSpread(jobs, index.blocks.size()))
+        {
+            jobs->ParallelFor(index.blocks.size(), decode);
+        }
+        else
+        {
+            decode(0, index.blocks.size());
+        }
+        return ok.load(std::memory_order_relaxed);
+    }
+}
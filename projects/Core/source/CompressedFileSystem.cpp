@@ -0,0 +1,821 @@
+#include "pch.h"
+#include "include/CompressedFileSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "include/JobSystem.h"
+
+namespace
+{
+    using namespace Drama::Core::IO;
+    namespace Compression = Drama::Core::Compression;
+
+    FsResult MakeError(FsError e, const char* msg)
+    {
+        FsResult r;
+        r.error = e;
+        r.message = msg;
+        return r;
+    }
+
+    FsResult CorruptError()
+    {
+        return MakeError(FsError::IoError, "Compressed file is corrupt.");
+    }
+
+    /// @brief 指定の大きさを読み切る(足りなければ壊れている)
+    FsResult ReadExactAt(IFileReader& reader, uint64_t offset, void* buffer, size_t size) noexcept
+    {
+        size_t n = 0;
+        if (FsResult r = reader.ReadAt(offset, buffer, size, n); !r)
+        {
+            return r;
+        }
+        return (n == size) ? FsResult::Ok() : CorruptError();
+    }
+
+    /// @brief ヘッダと索引だけを読む(本体は読まない)
+    /// @param fileSize 格納形式のファイルの大きさ
+    FsResult LoadIndex(IFileReader& reader, Blob::BlobIndex& index, uint64_t& fileSize) noexcept
+    {
+        fileSize = 0;
+        if (FsResult r = reader.Size(fileSize); !r)
+        {
+            return r;
+        }
+        if (fileSize < sizeof(Blob::BlobHeader))
+        {
+            return CorruptError();
+        }
+
+        Blob::BlobHeader header{};
+        if (FsResult r = ReadExactAt(reader, 0, &header, sizeof(header)); !r)
+        {
+            return r;
+        }
+        if (!Blob::IsBlob(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&header), sizeof(header))))
+        {
+            return CorruptError();
+        }
+
+        const uint64_t indexBytes = static_cast<uint64_t>(header.blockCount) * sizeof(Blob::BlockEntry);
+        if (header.indexOffset > fileSize || fileSize - header.indexOffset < indexBytes)
+        {
+            return CorruptError();
+        }
+        std::vector<Blob::BlockEntry> blocks(header.blockCount);
+        if (FsResult r = ReadExactAt(reader, header.indexOffset, blocks.data(), static_cast<size_t>(indexBytes)); !r)
+        {
+            return r;
+        }
+        if (!Blob::BuildIndex(header, blocks, fileSize, index))
+        {
+            return CorruptError();
+        }
+        return FsResult::Ok();
+    }
+
+    /// @brief 触れたブロックだけを展開する読み込みストリーム
+    class CompressedFileReader final : public IFileReader
+    {
+    public:
+        CompressedFileReader(std::unique_ptr<IFileReader> inner, Blob::BlobIndex&& index) noexcept
+            : m_Inner(std::move(inner)), m_Index(std::move(index))
+        {
+        }
+
+        FsResult Read(void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            FsResult r = ReadAt(m_Position, buffer, size, bytesRead);
+            m_Position += bytesRead;
+            return r;
+        }
+
+        FsResult ReadAt(uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            bytesRead = 0;
+            if (size > 0 && buffer == nullptr)
+            {
+                return MakeError(FsError::IoError, "Buffer is null.");
+            }
+            const uint64_t rawSize = m_Index.header.rawSize;
+            if (offset >= rawSize)
+            {
+                return FsResult::Ok();
+            }
+            size = static_cast<size_t>(std::min<uint64_t>(size, rawSize - offset));
+
+            auto* dst = static_cast<uint8_t*>(buffer);
+            while (bytesRead < size)
+            {
+                const uint64_t pos = offset + bytesRead;
+                const size_t i = Blob::FindBlock(m_Index, pos);
+                const Blob::BlockEntry& e = m_Index.blocks[i];
+                const size_t inBlock = static_cast<size_t>(pos - m_Index.rawOffsets[i]);
+                const size_t n = std::min<size_t>(size - bytesRead, e.rawSize - inBlock);
+
+                if (inBlock == 0 && n == e.rawSize && m_CachedBlock != i)
+                {
+                    // ブロック全体を読むなら呼び出し側のバッファへ直接展開する(キャッシュ経由のコピーを省く)
+                    if (FsResult r = DecodeBlockTo(e, dst + bytesRead); !r)
+                    {
+                        return r;
+                    }
+                }
+                else
+                {
+                    if (FsResult r = LoadBlock(i); !r)
+                    {
+                        return r;
+                    }
+                    std::memcpy(dst + bytesRead, m_Block.data() + inBlock, n);
+                }
+                bytesRead += n;
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            m_Position = offset;
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override
+        {
+            out = m_Index.header.rawSize;
+            return FsResult::Ok();
+        }
+
+    private:
+        FsResult DecodeBlockTo(const Blob::BlockEntry& e, uint8_t* dst) noexcept
+        {
+            if ((e.flags & Blob::kBlockStored) != 0)
+            {
+                return ReadExactAt(*m_Inner, e.offset, dst, e.storedSize);
+            }
+            m_Stored.resize(e.storedSize);
+            if (FsResult r = ReadExactAt(*m_Inner, e.offset, m_Stored.data(), m_Stored.size()); !r)
+            {
+                return r;
+            }
+            return Blob::DecompressBlock(e, m_Stored.data(), dst) ? FsResult::Ok() : CorruptError();
+        }
+
+        /// @brief 直近のブロックを1つだけ持っておく(小さな順読みで同じブロックを何度も展開しない)
+        FsResult LoadBlock(size_t i) noexcept
+        {
+            if (m_CachedBlock == i)
+            {
+                return FsResult::Ok();
+            }
+            m_CachedBlock = kNoBlock;
+            m_Block.resize(m_Index.blocks[i].rawSize);
+            if (FsResult r = DecodeBlockTo(m_Index.blocks[i], m_Block.data()); !r)
+            {
+                return r;
+            }
+            m_CachedBlock = i;
+            return FsResult::Ok();
+        }
+
+        static constexpr size_t kNoBlock = std::numeric_limits<size_t>::max();
+
+        std::unique_ptr<IFileReader> m_Inner;
+        Blob::BlobIndex m_Index;
+        std::vector<uint8_t> m_Stored;
+        std::vector<uint8_t> m_Block;
+        size_t m_CachedBlock = kNoBlock;
+        uint64_t m_Position = 0;
+    };
+
+    /// @brief 1ブロック分たまるごとに圧縮して書き出すストリーム。索引とヘッダは Flush/Close で書く
+    /// @note 最後の半端なブロックは書き出した後も m_Pending に残しておき、続きが書かれたら索引から外して
+    ///       作り直す。Flush や追記のたびに小さなブロックが増えていかないようにするため。
+    ///       ヘッダが指している範囲(m_CommittedEnd より前)は上書きせず、作り直したブロックと新しい索引は
+    ///       その後ろに足してから最後にヘッダを書き換える。途中で落ちても前回確定した内容が読める。
+    class CompressedFileWriter final : public IFileWriter
+    {
+    public:
+        CompressedFileWriter(std::unique_ptr<IFileWriter> inner, uint32_t blockSize)
+            : m_Inner(std::move(inner)), m_BlockSize(std::clamp(blockSize, Blob::kMinBlockSize, Blob::kMaxBlockSize)),
+            m_Scratch(std::make_unique<Compression::CompressScratch>())
+        {
+        }
+
+        ~CompressedFileWriter() override
+        {
+            // デストラクタでは失敗を返せない。結果が要るなら先に Flush を呼ぶ
+            (void)Close();
+        }
+
+        /// @brief 既存のブロック圧縮ファイルの続きから書く
+        /// @param fileSize 既存のファイルの大きさ(ここまでは確定済みとして上書きしない)
+        FsResult Resume(IFileReader& existing, const Blob::BlobIndex& index, uint64_t fileSize)
+        {
+            // 途中で失敗したら閉じるときに何も書かない(既存のファイルを壊さない)
+            m_Closed = true;
+            m_BlockSize = std::clamp(index.header.blockSize, Blob::kMinBlockSize, Blob::kMaxBlockSize);
+            m_Entries = index.blocks;
+            m_Position = index.header.rawSize;
+            m_CommittedEnd = fileSize;
+            m_DataEnd = fileSize;
+            m_Dirty = false;
+
+            if (!m_Entries.empty() && m_Entries.back().rawSize < m_BlockSize)
+            {
+                // 半端なブロックは展開して手元に戻し、続きを足してから作り直す
+                const Blob::BlockEntry& last = m_Entries.back();
+                m_Stored.resize(last.storedSize);
+                if (FsResult r = ReadExactAt(existing, last.offset, m_Stored.data(), m_Stored.size()); !r)
+                {
+                    return r;
+                }
+                m_Pending.resize(last.rawSize);
+                if (!Blob::DecompressBlock(last, m_Stored.data(), m_Pending.data()))
+                {
+                    return CorruptError();
+                }
+                m_PendingEmitted = true;
+            }
+            m_Closed = false;
+            return FsResult::Ok();
+        }
+
+        FsResult Write(const void* data, size_t size) noexcept override
+        {
+            if (!m_Inner)
+            {
+                return MakeError(FsError::IoError, "Stream is closed.");
+            }
+            if (size > 0 && data == nullptr)
+            {
+                return MakeError(FsError::IoError, "Data is null.");
+            }
+            if (size == 0)
+            {
+                return FsResult::Ok();
+            }
+            m_Dirty = true;
+            if (m_PendingEmitted)
+            {
+                RetractPending();
+            }
+
+            const auto* src = static_cast<const uint8_t*>(data);
+            while (size > 0)
+            {
+                const size_t n = std::min<size_t>(size, m_BlockSize - m_Pending.size());
+                m_Pending.insert(m_Pending.end(), src, src + n);
+                src += n;
+                size -= n;
+                m_Position += n;
+                if (m_Pending.size() == m_BlockSize)
+                {
+                    if (FsResult r = EmitPending(); !r)
+                    {
+                        return r;
+                    }
+                }
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult WriteV(std::span<const WriteSlice> slices) noexcept override
+        {
+            for (const WriteSlice& s : slices)
+            {
+                if (FsResult r = Write(s.data, s.size); !r)
+                {
+                    return r;
+                }
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult WriteAt(uint64_t offset, const void* data, size_t size) noexcept override
+        {
+            if (!m_Inner)
+            {
+                return MakeError(FsError::IoError, "Stream is closed.");
+            }
+            if (size > 0 && data == nullptr)
+            {
+                return MakeError(FsError::IoError, "Data is null.");
+            }
+            const uint64_t pendingStart = m_Position - m_Pending.size();
+            if (offset < pendingStart || offset > m_Position || m_Position - offset < size)
+            {
+                return MakeError(FsError::IoError, "Compressed stream can only patch the unwritten tail block.");
+            }
+            if (size == 0)
+            {
+                return FsResult::Ok();
+            }
+            m_Dirty = true;
+            if (m_PendingEmitted)
+            {
+                RetractPending();
+            }
+            std::memcpy(m_Pending.data() + (offset - pendingStart), data, size);
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            if (offset != m_Position)
+            {
+                return MakeError(FsError::IoError, "Compressed stream cannot seek.");
+            }
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override
+        {
+            out = m_Position;
+            return FsResult::Ok();
+        }
+
+        FsResult Flush() noexcept override
+        {
+            if (!m_Inner)
+            {
+                return MakeError(FsError::IoError, "Stream is closed.");
+            }
+            if (FsResult r = Commit(); !r)
+            {
+                return r;
+            }
+            return m_Inner->Flush();
+        }
+
+        /// @brief 索引とヘッダを書いて閉じる(2回目以降は何もしない)
+        FsResult Close() noexcept override
+        {
+            if (!m_Inner)
+            {
+                return FsResult::Ok();
+            }
+            // Resume に失敗したもの(m_Closed)は何も書かずに閉じる
+            FsResult r = m_Closed ? FsResult::Ok() : Commit();
+            m_Closed = true;
+            FsResult closed = m_Inner->Close();
+            m_Inner.reset();
+            return r ? closed : r;
+        }
+
+    private:
+        FsResult EmitPending() noexcept
+        {
+            uint32_t flags = 0;
+            Blob::CompressBlock(m_Pending.data(), m_Pending.size(), m_Stored, flags, *m_Scratch);
+            if (FsResult r = m_Inner->WriteAt(m_DataEnd, m_Stored.data(), m_Stored.size()); !r)
+            {
+                return r;
+            }
+            Blob::BlockEntry e{};
+            e.offset = m_DataEnd;
+            e.storedSize = static_cast<uint32_t>(m_Stored.size());
+            e.rawSize = static_cast<uint32_t>(m_Pending.size());
+            e.flags = flags;
+            m_Entries.push_back(e);
+            m_DataEnd += e.storedSize;
+
+            if (m_Pending.size() == m_BlockSize)
+            {
+                m_Pending.clear();
+                m_PendingEmitted = false;
+            }
+            else
+            {
+                m_PendingEmitted = true;
+            }
+            return FsResult::Ok();
+        }
+
+        void RetractPending() noexcept
+        {
+            // まだ確定していない位置なら同じ場所に作り直す。確定済みならヘッダが指しているので後ろへ足す
+            m_DataEnd = std::max(m_Entries.back().offset, m_CommittedEnd);
+            m_Entries.pop_back();
+            m_PendingEmitted = false;
+        }
+
+        FsResult Commit() noexcept
+        {
+            if (!m_Dirty)
+            {
+                return FsResult::Ok();
+            }
+            if (!m_Pending.empty() && !m_PendingEmitted)
+            {
+                if (FsResult r = EmitPending(); !r)
+                {
+                    return r;
+                }
+            }
+            const uint64_t indexBytes = m_Entries.size() * sizeof(Blob::BlockEntry);
+            if (!m_Entries.empty())
+            {
+                if (FsResult r = m_Inner->WriteAt(m_DataEnd, m_Entries.data(), static_cast<size_t>(indexBytes)); !r)
+                {
+                    return r;
+                }
+            }
+            if (m_CommittedEnd > 0)
+            {
+                // 確定済みの内容を指すヘッダを書き換える前に、新しいブロックと索引を書き終えておく
+                if (FsResult r = m_Inner->Flush(); !r)
+                {
+                    return r;
+                }
+            }
+            Blob::BlobHeader header{};
+            header.blockSize = m_BlockSize;
+            header.blockCount = static_cast<uint32_t>(m_Entries.size());
+            header.rawSize = m_Position;
+            header.indexOffset = m_DataEnd;
+            if (FsResult r = m_Inner->WriteAt(0, &header, sizeof(header)); !r)
+            {
+                return r;
+            }
+            m_CommittedEnd = m_DataEnd + indexBytes;
+            m_DataEnd = m_CommittedEnd;
+            m_Dirty = false;
+            return FsResult::Ok();
+        }
+
+        std::unique_ptr<IFileWriter> m_Inner;
+        uint32_t m_BlockSize;
+        std::vector<Blob::BlockEntry> m_Entries;
+        std::vector<uint8_t> m_Pending;
+        std::vector<uint8_t> m_Stored;
+        std::unique_ptr<Compression::CompressScratch> m_Scratch;
+        uint64_t m_Position = 0;
+        uint64_t m_DataEnd = sizeof(Blob::BlobHeader);
+        uint64_t m_CommittedEnd = 0;   ///< ヘッダが指している範囲の終わり(ここより前は書き換えない)
+        bool m_PendingEmitted = false; ///< m_Pending が索引の最後のブロックとして書き出し済み
+        bool m_Dirty = true;           ///< 前回の確定から書き込みがあった(新しいファイルは空でもヘッダが要る)
+        bool m_Closed = false;
+    };
+
+    /// @brief 生きているブロックと索引より残骸の方が大きいか(追記を繰り返したファイルを詰め直す目安)
+    bool IsSparse(const Blob::BlobIndex& index, uint64_t fileSize) noexcept
+    {
+        uint64_t live = sizeof(Blob::BlobHeader) + index.blocks.size() * sizeof(Blob::BlockEntry);
+        for (const Blob::BlockEntry& e : index.blocks)
+        {
+            live += e.storedSize;
+        }
+        return fileSize > live && fileSize - live > std::max<uint64_t>(live, Blob::kMinBlockSize);
+    }
+}
+
+namespace Drama::Core::IO
+{
+    CompressedFileSystem::CompressedFileSystem(IFileSystem& inner, CompressionDesc desc)
+        : m_Inner(inner), m_Desc(std::move(desc))
+    {
+    }
+
+    bool CompressedFileSystem::ShouldCompress(std::string_view path) const
+    {
+        return !m_Desc.filter || m_Desc.filter(path);
+    }
+
+    std::string CompressedFileSystem::StoredPath(std::string_view path)
+    {
+        // 空のパスは空のまま渡して、下の実装に InvalidPath を返させる
+        if (path.empty())
+        {
+            return {};
+        }
+        std::string stored(path);
+        stored += Blob::kFileExtension;
+        return stored;
+    }
+
+    FsResult CompressedFileSystem::RemoveStale(std::string_view path) noexcept
+    {
+        FsResult r = m_Inner.Remove(path);
+        if (!r && r.error == FsError::NotFound)
+        {
+            return FsResult::Ok();
+        }
+        return r;
+    }
+
+    Job::JobSystem* CompressedFileSystem::JobsFor(uint64_t rawSize) const noexcept
+    {
+        return (rawSize >= m_Desc.parallelThreshold) ? m_Desc.jobSystem : nullptr;
+    }
+
+    FsResult CompressedFileSystem::Decode(std::span<const uint8_t> stored, std::vector<uint8_t>& out) noexcept
+    {
+        Blob::BlobIndex index;
+        if (!Blob::ReadIndex(stored, index))
+        {
+            return CorruptError();
+        }
+        out.resize(static_cast<size_t>(index.header.rawSize));
+        if (!Blob::Decode(stored, index, out.data(), JobsFor(index.header.rawSize)))
+        {
+            out.clear();
+            return CorruptError();
+        }
+        return FsResult::Ok();
+    }
+
+    FsResult CompressedFileSystem::Compact(const std::string& stored) noexcept
+    {
+        std::vector<uint8_t> bytes;
+        if (FsResult r = m_Inner.ReadAllBytes(stored, bytes); !r)
+        {
+            return r;
+        }
+        Blob::BlobIndex index;
+        if (!Blob::ReadIndex(bytes, index))
+        {
+            return CorruptError();
+        }
+        std::vector<uint8_t> raw;
+        if (FsResult r = Decode(bytes, raw); !r)
+        {
+            return r;
+        }
+        Blob::Encode(raw, index.header.blockSize, JobsFor(raw.size()), bytes);
+        return m_Inner.WriteAllBytesAtomic(stored, bytes.data(), bytes.size());
+    }
+
+    FsResult CompressedFileSystem::Exists(std::string_view path) noexcept
+    {
+        FsResult r = m_Inner.Exists(StoredPath(path));
+        if (!r && r.error == FsError::NotFound)
+        {
+            return m_Inner.Exists(path);
+        }
+        return r;
+    }
+
+    FsResult CompressedFileSystem::CreateDirectories(std::string_view path) noexcept
+    {
+        return m_Inner.CreateDirectories(path);
+    }
+
+    FsResult CompressedFileSystem::Remove(std::string_view path) noexcept
+    {
+        FsResult stored = m_Inner.Remove(StoredPath(path));
+        if (!stored && stored.error != FsError::NotFound)
+        {
+            return stored;
+        }
+        FsResult raw = m_Inner.Remove(path);
+        if (stored && !raw && raw.error == FsError::NotFound)
+        {
+            return FsResult::Ok();
+        }
+        return raw;
+    }
+
+    FsResult CompressedFileSystem::WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept
+    {
+        if (size > 0 && data == nullptr)
+        {
+            return MakeError(FsError::IoError, "Data is null.");
+        }
+        if (!ShouldCompress(path))
+        {
+            if (FsResult r = m_Inner.WriteAllBytes(path, data, size); !r)
+            {
+                return r;
+            }
+            // 圧縮版が残っていると読み込みがそちらを見る
+            return RemoveStale(StoredPath(path));
+        }
+        std::vector<uint8_t> encoded;
+        Blob::Encode(std::span<const uint8_t>(static_cast<const uint8_t*>(data), size), m_Desc.blockSize, JobsFor(size), encoded);
+        if (FsResult r = m_Inner.WriteAllBytes(StoredPath(path), encoded.data(), encoded.size()); !r)
+        {
+            return r;
+        }
+        return RemoveStale(path);
+    }
+
+    FsResult CompressedFileSystem::ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept
+    {
+        out.clear();
+        std::vector<uint8_t> stored;
+        FsResult r = m_Inner.ReadAllBytes(StoredPath(path), stored);
+        if (!r && r.error == FsError::NotFound)
+        {
+            return m_Inner.ReadAllBytes(path, out);
+        }
+        if (!r)
+        {
+            return r;
+        }
+        return Decode(stored, out);
+    }
+
+    FsResult CompressedFileSystem::MapReadOnly(std::string_view path, MappedFile& out) noexcept
+    {
+        out.Reset();
+        MappedFile stored;
+        FsResult r = m_Inner.MapReadOnly(StoredPath(path), stored);
+        if (!r && r.error == FsError::NotFound)
+        {
+            return m_Inner.MapReadOnly(path, out);
+        }
+        if (!r)
+        {
+            return r;
+        }
+
+        // 展開した結果はどこにも無いのでコピーになる。ブロックはマップしたまま展開する
+        std::vector<uint8_t> raw;
+        if (r = Decode(stored.Bytes(), raw); !r)
+        {
+            return r;
+        }
+        out = MappedFile::FromBytes(std::move(raw));
+        return FsResult::Ok();
+    }
+
+    FsResult CompressedFileSystem::AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept
+    {
+        if (size > 0 && data == nullptr)
+        {
+            return MakeError(FsError::IoError, "Data is null.");
+        }
+        std::unique_ptr<IFileWriter> writer;
+        if (FsResult r = OpenWrite(path, FileWriteMode::Append, writer); !r)
+        {
+            return r;
+        }
+        if (FsResult r = writer->Write(data, size); !r)
+        {
+            return r;
+        }
+        return writer->Close();
+    }
+
+    FsResult CompressedFileSystem::WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept
+    {
+        if (size > 0 && data == nullptr)
+        {
+            return MakeError(FsError::IoError, "Data is null.");
+        }
+        // 新しい方を置き換え終えてから古い形式の方を消す。間で落ちても古い内容か新しい内容のどちらかが読める
+        if (!ShouldCompress(path))
+        {
+            if (FsResult r = m_Inner.WriteAllBytesAtomic(path, data, size); !r)
+            {
+                return r;
+            }
+            return RemoveStale(StoredPath(path));
+        }
+        std::vector<uint8_t> encoded;
+        Blob::Encode(std::span<const uint8_t>(static_cast<const uint8_t*>(data), size), m_Desc.blockSize, JobsFor(size), encoded);
+        if (FsResult r = m_Inner.WriteAllBytesAtomic(StoredPath(path), encoded.data(), encoded.size()); !r)
+        {
+            return r;
+        }
+        return RemoveStale(path);
+    }
+
+    FsResult CompressedFileSystem::OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept
+    {
+        out.reset();
+        std::unique_ptr<IFileReader> inner;
+        FsResult r = m_Inner.OpenRead(StoredPath(path), inner);
+        if (!r && r.error == FsError::NotFound)
+        {
+            return m_Inner.OpenRead(path, out);
+        }
+        if (!r)
+        {
+            return r;
+        }
+        Blob::BlobIndex index;
+        uint64_t fileSize = 0;
+        if (r = LoadIndex(*inner, index, fileSize); !r)
+        {
+            return r;
+        }
+        out = std::make_unique<CompressedFileReader>(std::move(inner), std::move(index));
+        return FsResult::Ok();
+    }
+
+    FsResult CompressedFileSystem::OpenWrite(std::string_view path, FileWriteMode mode, std::unique_ptr<IFileWriter>& out) noexcept
+    {
+        out.reset();
+        const std::string stored = StoredPath(path);
+        if (mode == FileWriteMode::Append)
+        {
+            std::unique_ptr<IFileReader> existing;
+            FsResult r = m_Inner.OpenRead(stored, existing);
+            if (r)
+            {
+                return ResumeAppend(stored, std::move(existing), out);
+            }
+            if (r.error != FsError::NotFound)
+            {
+                return r;
+            }
+            // 圧縮していない既存ファイルにはそのまま追記する
+            uint64_t size = 0;
+            if (m_Inner.FileSize(path, size) && size > 0)
+            {
+                return m_Inner.OpenWrite(path, mode, out);
+            }
+        }
+        if (!ShouldCompress(path))
+        {
+            if (FsResult r = m_Inner.OpenWrite(path, mode, out); !r)
+            {
+                return r;
+            }
+            return RemoveStale(stored);
+        }
+
+        std::unique_ptr<IFileWriter> inner;
+        if (FsResult r = m_Inner.OpenWrite(stored, mode, inner); !r)
+        {
+            return r;
+        }
+        if (FsResult r = RemoveStale(path); !r)
+        {
+            return r;
+        }
+        out = std::make_unique<CompressedFileWriter>(std::move(inner), m_Desc.blockSize);
+        return FsResult::Ok();
+    }
+
+    FsResult CompressedFileSystem::ResumeAppend(const std::string& stored, std::unique_ptr<IFileReader> existing,
+        std::unique_ptr<IFileWriter>& out) noexcept
+    {
+        Blob::BlobIndex index;
+        uint64_t fileSize = 0;
+        if (FsResult r = LoadIndex(*existing, index, fileSize); !r)
+        {
+            return r;
+        }
+        if (IsSparse(index, fileSize))
+        {
+            // 追記のたびに作り直した末尾ブロックと索引の残骸が溜まるので、一定以上になったら丸ごと書き直す
+            existing.reset();
+            if (FsResult r = Compact(stored); !r)
+            {
+                return r;
+            }
+            if (FsResult r = m_Inner.OpenRead(stored, existing); !r)
+            {
+                return r;
+            }
+            if (FsResult r = LoadIndex(*existing, index, fileSize); !r)
+            {
+                return r;
+            }
+        }
+
+        std::unique_ptr<IFileWriter> inner;
+        if (FsResult r = m_Inner.OpenWrite(stored, FileWriteMode::Append, inner); !r)
+        {
+            return r;
+        }
+        auto writer = std::make_unique<CompressedFileWriter>(std::move(inner), m_Desc.blockSize);
+        if (FsResult r = writer->Resume(*existing, index, fileSize); !r)
+        {
+            return r;
+        }
+        out = std::move(writer);
+        return FsResult::Ok();
+    }
+
+    FsResult CompressedFileSystem::CopyAllBytes(std::string_view srcPath, std::string_view dstPath) noexcept
+    {
+        // 格納形式のまま写し、コピー先に残っている別の形式は消す
+        const std::string srcStored = StoredPath(srcPath);
+        const std::string dstStored = StoredPath(dstPath);
+        FsResult r = m_Inner.CopyAllBytes(srcStored, dstStored);
+        if (r)
+        {
+            return RemoveStale(dstPath);
+        }
+        if (r.error != FsError::NotFound)
+        {
+            return r;
+        }
+        if (r = m_Inner.CopyAllBytes(srcPath, dstPath); !r)
+        {
+            return r;
+        }
+        return RemoveStale(dstStored);
+    }
+}
@@ -0,0 +1,1057 @@
+#include "pch.h"
+#include "include/DynamicBvh.h"
+#include "include/JobSystem.h"
+#include "include/Simd.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace Drama::Core::Scene
+{
+    namespace
+    {
+        /// @brief Rebuild で重心を振り分ける区間の数
+        constexpr uint32_t kBinCount = 16;
+        /// @brief 問い合わせの積み荷を関数の中に置ける数(これより深い木では確保する)
+        constexpr uint32_t kLocalStackSize = 192;
+
+        Math::Float3 Centroid(const Aabb& box) noexcept
+        {
+            return (box.min + box.max) * 0.5f;
+        }
+
+        float Component(Math::Float3 v, uint32_t axis) noexcept
+        {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        }
+
+        /// @brief 空の箱(どの箱と合わせても相手がそのまま残る)
+        constexpr Aabb kEmptyBox{ Math::Float3{ FLT_MAX, FLT_MAX, FLT_MAX }, Math::Float3{ -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+    }
+
+    // ---- DynamicAabbTree ----
+
+    uint32_t DynamicAabbTree::AllocateNode()
+    {
+        uint32_t index = m_FreeList;
+        if (index != kNone)
+        {
+            m_FreeList = m_Nodes[index].parent;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+        Node& node = m_Nodes[index];
+        node.parent = kNone;
+        node.child1 = kNone;
+        node.child2 = kNone;
+        node.height = 0;
+        node.allocated = true;
+        node.dirty = false;
+        return index;
+    }
+
+    void DynamicAabbTree::FreeNode(uint32_t index) noexcept
+    {
+        Node& node = m_Nodes[index];
+        node.allocated = false;
+        node.dirty = false;
+        // 世代が一周して 0(無効)にならないようにする
+        node.generation = node.generation + 1 == 0 ? 1 : node.generation + 1;
+        node.parent = m_FreeList;
+        m_FreeList = index;
+    }
+
+    const DynamicAabbTree::Node* DynamicAabbTree::Resolve(BvhProxy proxy) const noexcept
+    {
+        if (proxy.index >= m_Nodes.size())
+        {
+            return nullptr;
+        }
+        const Node& node = m_Nodes[proxy.index];
+        return node.allocated && node.child1 == kNone && node.generation == proxy.generation ? &node : nullptr;
+    }
+
+    bool DynamicAabbTree::IsAlive(BvhProxy proxy) const noexcept
+    {
+        return Resolve(proxy) != nullptr;
+    }
+
+    BvhProxy DynamicAabbTree::Create(const Aabb& box, uint32_t userData)
+    {
+        const uint32_t leaf = AllocateNode();
+        Node& node = m_Nodes[leaf];
+        node.tight = box;
+        node.box = Expand(box, m_Margin);
+        node.userData = userData;
+        InsertLeaf(leaf);
+        ++m_LeafCount;
+        return BvhProxy{ leaf, m_Nodes[leaf].generation };
+    }
+
+    bool DynamicAabbTree::Destroy(BvhProxy proxy)
+    {
+        if (!Resolve(proxy))
+        {
+            return false;
+        }
+        RemoveLeaf(proxy.index);
+        FreeNode(proxy.index);
+        --m_LeafCount;
+        return true;
+    }
+
+    bool DynamicAabbTree::Move(BvhProxy proxy, const Aabb& box)
+    {
+        if (!Resolve(proxy))
+        {
+            return false;
+        }
+        Node& node = m_Nodes[proxy.index];
+        node.tight = box;
+        if (Contains(node.box, box))
+        {
+            return false;
+        }
+        RemoveLeaf(proxy.index);
+        m_Nodes[proxy.index].box = Expand(box, m_Margin);
+        InsertLeaf(proxy.index);
+        return true;
+    }
+
+    bool DynamicAabbTree::SetBounds(BvhProxy proxy, const Aabb& box) noexcept
+    {
+        if (!Resolve(proxy))
+        {
+            return false;
+        }
+        Node& node = m_Nodes[proxy.index];
+        node.tight = box;
+        node.box = box;
+        if (!node.dirty)
+        {
+            node.dirty = true;
+            m_DirtyLeaves.push_back(proxy.index);
+        }
+        return true;
+    }
+
+    const Aabb* DynamicAabbTree::Bounds(BvhProxy proxy) const noexcept
+    {
+        const Node* node = Resolve(proxy);
+        return node ? &node->tight : nullptr;
+    }
+
+    const Aabb* DynamicAabbTree::FatBounds(BvhProxy proxy) const noexcept
+    {
+        const Node* node = Resolve(proxy);
+        return node ? &node->box : nullptr;
+    }
+
+    uint32_t DynamicAabbTree::UserData(BvhProxy proxy) const noexcept
+    {
+        const Node* node = Resolve(proxy);
+        return node ? node->userData : UINT32_MAX;
+    }
+
+    void DynamicAabbTree::InsertLeaf(uint32_t leaf)
+    {
+        if (m_Root == kNone)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].parent = kNone;
+            return;
+        }
+
+        // 兄弟を SAH で選ぶ: ここに付けたときの増え方と、子へ降りた場合の下限を比べて小さい方へ降りる
+        const Aabb box = m_Nodes[leaf].box;
+        uint32_t index = m_Root;
+        while (m_Nodes[index].child1 != kNone)
+        {
+            const Node& node = m_Nodes[index];
+            const float area = HalfArea(node.box);
+            const float combinedArea = HalfArea(Union(node.box, box));
+            // ここで新しい親を作る費用 / 子へ降りたときに祖先として増える分
+            const float cost = 2.0f * combinedArea;
+            const float inheritance = 2.0f * (combinedArea - area);
+            auto descendCost = [&](uint32_t child)
+                {
+                    const Node& c = m_Nodes[child];
+                    const float grown = HalfArea(Union(c.box, box));
+                    return (c.child1 == kNone ? grown : grown - HalfArea(c.box)) + inheritance;
+                };
+            const float cost1 = descendCost(node.child1);
+            const float cost2 = descendCost(node.child2);
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const uint32_t sibling = index;
+        const uint32_t oldParent = m_Nodes[sibling].parent;
+        const uint32_t newParent = AllocateNode();
+        Node& parent = m_Nodes[newParent];
+        parent.parent = oldParent;
+        parent.box = Union(box, m_Nodes[sibling].box);
+        parent.height = static_cast<uint16_t>(m_Nodes[sibling].height + 1);
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+        if (oldParent != kNone)
+        {
+            Node& p = m_Nodes[oldParent];
+            (p.child1 == sibling ? p.child1 : p.child2) = newParent;
+        }
+        else
+        {
+            m_Root = newParent;
+        }
+        m_Nodes[sibling].parent = newParent;
+        m_Nodes[leaf].parent = newParent;
+
+        RefitAncestors(m_Nodes[leaf].parent);
+    }
+
+    void DynamicAabbTree::RemoveLeaf(uint32_t leaf) noexcept
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = kNone;
+            return;
+        }
+        const uint32_t parent = m_Nodes[leaf].parent;
+        const uint32_t grandParent = m_Nodes[parent].parent;
+        const uint32_t sibling = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+        if (grandParent != kNone)
+        {
+            // 親を消して兄弟を祖父に直接付ける
+            Node& g = m_Nodes[grandParent];
+            (g.child1 == parent ? g.child1 : g.child2) = sibling;
+            m_Nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            RefitAncestors(grandParent);
+        }
+        else
+        {
+            m_Root = sibling;
+            m_Nodes[sibling].parent = kNone;
+            FreeNode(parent);
+        }
+        m_Nodes[leaf].parent = kNone;
+    }
+
+    void DynamicAabbTree::UpdateNode(uint32_t index) noexcept
+    {
+        Node& node = m_Nodes[index];
+        const Node& c1 = m_Nodes[node.child1];
+        const Node& c2 = m_Nodes[node.child2];
+        node.box = Union(c1.box, c2.box);
+        node.height = static_cast<uint16_t>(1 + std::max(c1.height, c2.height));
+    }
+
+    void DynamicAabbTree::RefitAncestors(uint32_t index) noexcept
+    {
+        while (index != kNone)
+        {
+            UpdateNode(index);
+            Rotate(index);
+            index = m_Nodes[index].parent;
+        }
+    }
+
+    void DynamicAabbTree::Rotate(uint32_t index) noexcept
+    {
+        // A の子が B と C、B の子が D と E、C の子が F と G のとき、
+        // B と F/G、または C と D/E を入れ替える4通りのうち、入れ替えで形の変わる節点(C か B)の
+        // 表面積が一番減るものを選ぶ。A の箱は葉の集まりが変わらないのでそのまま
+        Node& a = m_Nodes[index];
+        if (a.height < 2)
+        {
+            return;
+        }
+        const uint32_t b = a.child1;
+        const uint32_t c = a.child2;
+        enum Rotation { kNoRotation, kBF, kBG, kCD, kCE };
+        Rotation best = kNoRotation;
+        float bestGain = 0.0f;
+        if (m_Nodes[c].child1 != kNone)
+        {
+            const Node& nc = m_Nodes[c];
+            const float area = HalfArea(nc.box);
+            const float gainBF = area - HalfArea(Union(m_Nodes[b].box, m_Nodes[nc.child2].box));
+            const float gainBG = area - HalfArea(Union(m_Nodes[nc.child1].box, m_Nodes[b].box));
+            if (gainBF > bestGain)
+            {
+                best = kBF;
+                bestGain = gainBF;
+            }
+            if (gainBG > bestGain)
+            {
+                best = kBG;
+                bestGain = gainBG;
+            }
+        }
+        if (m_Nodes[b].child1 != kNone)
+        {
+            const Node& nb = m_Nodes[b];
+            const float area = HalfArea(nb.box);
+            const float gainCD = area - HalfArea(Union(m_Nodes[c].box, m_Nodes[nb.child2].box));
+            const float gainCE = area - HalfArea(Union(m_Nodes[nb.child1].box, m_Nodes[c].box));
+            if (gainCD > bestGain)
+            {
+                best = kCD;
+                bestGain = gainCD;
+            }
+            if (gainCE > bestGain)
+            {
+                best = kCE;
+            }
+        }
+
+        // outer(A の子) と inner(もう一方の子 holder の子) を入れ替える
+        auto swap = [&](uint32_t outer, uint32_t holder, bool innerIsFirst)
+            {
+                Node& h = m_Nodes[holder];
+                uint32_t& slot = innerIsFirst ? h.child1 : h.child2;
+                const uint32_t inner = slot;
+                slot = outer;
+                m_Nodes[outer].parent = holder;
+                Node& na = m_Nodes[index];
+                (na.child1 == outer ? na.child1 : na.child2) = inner;
+                m_Nodes[inner].parent = index;
+                UpdateNode(holder);
+                UpdateNode(index);
+            };
+        switch (best)
+        {
+        case kBF: swap(b, c, true); break;
+        case kBG: swap(b, c, false); break;
+        case kCD: swap(c, b, true); break;
+        case kCE: swap(c, b, false); break;
+        default: break;
+        }
+    }
+
+    void DynamicAabbTree::Refit(bool rotate)
+    {
+        // 変わった葉から根まで印を付ける(印のある所まで来たら、その上はもう付いている)
+        for (const uint32_t leaf : m_DirtyLeaves)
+        {
+            const Node& node = m_Nodes[leaf];
+            if (!node.allocated || !node.dirty || node.child1 != kNone)
+            {
+                continue;
+            }
+            for (uint32_t index = node.parent; index != kNone && !m_Nodes[index].dirty; index = m_Nodes[index].parent)
+            {
+                m_Nodes[index].dirty = true;
+            }
+        }
+        m_DirtyLeaves.clear();
+        if (m_Root == kNone || !m_Nodes[m_Root].dirty)
+        {
+            return;
+        }
+
+        // 印の付いた内側の節点を上から集め、逆順(子が先)に直す
+        m_Scratch.clear();
+        m_QueryStack.clear();
+        m_QueryStack.push_back(m_Root);
+        while (!m_QueryStack.empty())
+        {
+            const uint32_t index = m_QueryStack.back();
+            m_QueryStack.pop_back();
+            Node& node = m_Nodes[index];
+            if (node.child1 == kNone)
+            {
+                node.dirty = false;
+                continue;
+            }
+            m_Scratch.push_back(index);
+            for (const uint32_t child : { node.child1, node.child2 })
+            {
+                if (m_Nodes[child].dirty)
+                {
+                    m_QueryStack.push_back(child);
+                }
+            }
+        }
+        for (auto it = m_Scratch.rbegin(); it != m_Scratch.rend(); ++it)
+        {
+            UpdateNode(*it);
+            if (rotate)
+            {
+                Rotate(*it);
+            }
+            m_Nodes[*it].dirty = false;
+        }
+        m_Scratch.clear();
+    }
+
+    void DynamicAabbTree::Rebuild()
+    {
+        if (m_Root == kNone)
+        {
+            return;
+        }
+        // 葉を集め、内側の節点は全部空きに戻す
+        std::vector<uint32_t> leaves;
+        leaves.reserve(m_LeafCount);
+        m_QueryStack.clear();
+        m_QueryStack.push_back(m_Root);
+        while (!m_QueryStack.empty())
+        {
+            const uint32_t index = m_QueryStack.back();
+            m_QueryStack.pop_back();
+            const Node& node = m_Nodes[index];
+            if (node.child1 == kNone)
+            {
+                leaves.push_back(index);
+                continue;
+            }
+            m_QueryStack.push_back(node.child1);
+            m_QueryStack.push_back(node.child2);
+            FreeNode(index);
+        }
+
+        // 上から下へ: 重心の広がりが一番大きい軸で区間に振り分け、SAH の費用が一番小さい境目で2つに分ける
+        struct Task
+        {
+            uint32_t begin, end;
+            uint32_t parent;
+            bool first;
+        };
+        std::vector<Task> tasks{ Task{ 0, static_cast<uint32_t>(leaves.size()), kNone, true } };
+        m_Scratch.clear(); // 作った内側の節点(親が先)
+        while (!tasks.empty())
+        {
+            const Task task = tasks.back();
+            tasks.pop_back();
+            uint32_t node;
+            if (task.end - task.begin == 1)
+            {
+                node = leaves[task.begin];
+                m_Nodes[node].height = 0;
+                m_Nodes[node].dirty = false;
+            }
+            else
+            {
+                Aabb centroids = kEmptyBox;
+                for (uint32_t i = task.begin; i < task.end; ++i)
+                {
+                    const Math::Float3 c = Centroid(m_Nodes[leaves[i]].box);
+                    centroids = Union(centroids, Aabb{ c, c });
+                }
+                const Math::Float3 extent = centroids.max - centroids.min;
+                const uint32_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+                const float lo = Component(centroids.min, axis);
+                const float width = Component(extent, axis);
+
+                uint32_t mid = task.begin + (task.end - task.begin) / 2;
+                if (width > 0.0f)
+                {
+                    const float scale = kBinCount / width;
+                    auto binOf = [&](uint32_t leaf)
+                        {
+                            const float c = Component(Centroid(m_Nodes[leaf].box), axis);
+                            return std::min(kBinCount - 1, static_cast<uint32_t>((c - lo) * scale));
+                        };
+                    Aabb binBox[kBinCount];
+                    uint32_t binCount[kBinCount] = {};
+                    std::fill(std::begin(binBox), std::end(binBox), kEmptyBox);
+                    for (uint32_t i = task.begin; i < task.end; ++i)
+                    {
+                        const uint32_t bin = binOf(leaves[i]);
+                        binBox[bin] = Union(binBox[bin], m_Nodes[leaves[i]].box);
+                        ++binCount[bin];
+                    }
+                    // 右から累積した面積と個数を先に作り、左から境目を動かして比べる
+                    float rightCost[kBinCount] = {};
+                    Aabb acc = kEmptyBox;
+                    uint32_t count = 0;
+                    for (uint32_t b = kBinCount - 1; b > 0; --b)
+                    {
+                        acc = Union(acc, binBox[b]);
+                        count += binCount[b];
+                        rightCost[b] = count ? HalfArea(acc) * static_cast<float>(count) : 0.0f;
+                    }
+                    float bestCost = FLT_MAX;
+                    uint32_t bestSplit = kBinCount;
+                    acc = kEmptyBox;
+                    count = 0;
+                    for (uint32_t b = 0; b + 1 < kBinCount; ++b)
+                    {
+                        acc = Union(acc, binBox[b]);
+                        count += binCount[b];
+                        const float cost = (count ? HalfArea(acc) * static_cast<float>(count) : 0.0f) + rightCost[b + 1];
+                        if (count > 0 && count < task.end - task.begin && cost < bestCost)
+                        {
+                            bestCost = cost;
+                            bestSplit = b + 1;
+                        }
+                    }
+                    if (bestSplit < kBinCount)
+                    {
+                        const auto pivot = std::partition(leaves.begin() + task.begin, leaves.begin() + task.end,
+                            [&](uint32_t leaf) { return binOf(leaf) < bestSplit; });
+                        mid = static_cast<uint32_t>(pivot - leaves.begin());
+                    }
+                }
+
+                node = AllocateNode();
+                m_Scratch.push_back(node);
+                tasks.push_back(Task{ mid, task.end, node, false });
+                tasks.push_back(Task{ task.begin, mid, node, true });
+            }
+
+            m_Nodes[node].parent = task.parent;
+            if (task.parent == kNone)
+            {
+                m_Root = node;
+            }
+            else
+            {
+                (task.first ? m_Nodes[task.parent].child1 : m_Nodes[task.parent].child2) = node;
+            }
+        }
+        for (auto it = m_Scratch.rbegin(); it != m_Scratch.rend(); ++it)
+        {
+            UpdateNode(*it);
+        }
+        m_Scratch.clear();
+        m_DirtyLeaves.clear();
+    }
+
+    void DynamicAabbTree::Clear() noexcept
+    {
+        // 番号は世代を上げて使い回す(古いハンドルを無効にする)
+        m_FreeList = kNone;
+        for (uint32_t i = static_cast<uint32_t>(m_Nodes.size()); i-- > 0;)
+        {
+            if (m_Nodes[i].allocated)
+            {
+                FreeNode(i);
+            }
+            else
+            {
+                m_Nodes[i].parent = m_FreeList;
+                m_FreeList = i;
+            }
+        }
+        m_Root = kNone;
+        m_LeafCount = 0;
+        m_DirtyLeaves.clear();
+    }
+
+    uint32_t DynamicAabbTree::Height() const noexcept
+    {
+        return m_Root == kNone ? 0 : m_Nodes[m_Root].height;
+    }
+
+    float DynamicAabbTree::AreaRatio() const noexcept
+    {
+        if (m_Root == kNone)
+        {
+            return 0.0f;
+        }
+        const float rootArea = HalfArea(m_Nodes[m_Root].box);
+        double total = 0.0;
+        for (const Node& node : m_Nodes)
+        {
+            if (node.allocated && node.child1 != kNone)
+            {
+                total += HalfArea(node.box);
+            }
+        }
+        return rootArea > 0.0f ? static_cast<float>(total / rootArea) : 0.0f;
+    }
+
+    bool DynamicAabbTree::Validate() const
+    {
+        uint32_t allocated = 0;
+        for (const Node& node : m_Nodes)
+        {
+            allocated += node.allocated ? 1 : 0;
+        }
+        if (m_Root == kNone)
+        {
+            return allocated == 0 && m_LeafCount == 0;
+        }
+        if (m_Nodes[m_Root].parent != kNone)
+        {
+            return false;
+        }
+        uint32_t reached = 0;
+        uint32_t leaves = 0;
+        std::vector<uint32_t> stack{ m_Root };
+        while (!stack.empty())
+        {
+            const uint32_t index = stack.back();
+            stack.pop_back();
+            const Node& node = m_Nodes[index];
+            if (!node.allocated || node.dirty)
+            {
+                return false;
+            }
+            ++reached;
+            if (node.child1 == kNone)
+            {
+                if (node.child2 != kNone || node.height != 0 || !Contains(node.box, node.tight))
+                {
+                    return false;
+                }
+                ++leaves;
+                continue;
+            }
+            const Node& c1 = m_Nodes[node.child1];
+            const Node& c2 = m_Nodes[node.child2];
+            if (node.child2 == kNone || c1.parent != index || c2.parent != index ||
+                node.height != 1 + std::max(c1.height, c2.height) || !Contains(node.box, c1.box) || !Contains(node.box, c2.box))
+            {
+                return false;
+            }
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+        return reached == allocated && leaves == m_LeafCount;
+    }
+
+    // ---- WideBvh ----
+
+    namespace
+    {
+        /// @brief 辿る途中の節点と、そこへ入る位置(光線なら t、近傍なら距離の2乗)
+        struct StackEntry
+        {
+            uint32_t node;
+            float key;
+        };
+
+        /// @brief 問い合わせの積み荷(浅い木なら関数の中、深い木ならヒープに置く)
+        class TraversalStack
+        {
+        public:
+            explicit TraversalStack(uint32_t depth)
+            {
+                // 1段降りるごとに積み荷は高々3つ増える
+                const size_t capacity = static_cast<size_t>(depth) * 3 + 1;
+                if (capacity > kLocalStackSize)
+                {
+                    m_Heap.resize(capacity);
+                    m_Data = m_Heap.data();
+                }
+            }
+            void Push(uint32_t node, float key) noexcept { m_Data[m_Size++] = StackEntry{ node, key }; }
+            StackEntry Pop() noexcept { return m_Data[--m_Size]; }
+            bool Empty() const noexcept { return m_Size == 0; }
+
+        private:
+            StackEntry m_Local[kLocalStackSize];
+            std::vector<StackEntry> m_Heap;
+            StackEntry* m_Data = m_Local;
+            uint32_t m_Size = 0;
+        };
+
+        /// @brief 近い順に積むため、見つけた子を key の小さい順に並べる(高々4個)
+        void SortByKey(StackEntry* entries, uint32_t count) noexcept
+        {
+            for (uint32_t i = 1; i < count; ++i)
+            {
+                const StackEntry e = entries[i];
+                uint32_t j = i;
+                for (; j > 0 && entries[j - 1].key > e.key; --j)
+                {
+                    entries[j] = entries[j - 1];
+                }
+                entries[j] = e;
+            }
+        }
+    }
+
+    void WideBvh::Clear() noexcept
+    {
+        m_Nodes.clear();
+        m_Items.clear();
+        m_Depth = 0;
+    }
+
+    void WideBvh::Build(const DynamicAabbTree& tree)
+    {
+        using TreeNode = DynamicAabbTree::Node;
+        Clear();
+        if (tree.m_Root == DynamicAabbTree::kNone)
+        {
+            return;
+        }
+        m_Nodes.reserve(tree.m_LeafCount / 2 + 1);
+        m_Items.reserve(tree.m_LeafCount);
+
+        auto setLane = [](Node& node, uint32_t lane, const Aabb& box)
+            {
+                node.minX[lane] = box.min.x;
+                node.minY[lane] = box.min.y;
+                node.minZ[lane] = box.min.z;
+                node.maxX[lane] = box.max.x;
+                node.maxY[lane] = box.max.y;
+                node.maxZ[lane] = box.max.z;
+            };
+
+        // 2分木の節点ごとに、子と孫から面積の大きい内側の節点を開いて最大4つの子を集める。
+        // 積み荷は後入れ先出しなので、0 番の子から深さ優先に並ぶ
+        struct Task
+        {
+            uint32_t treeNode;
+            uint32_t parent;
+            uint32_t lane;
+            uint32_t depth;
+        };
+        std::vector<Task> tasks{ Task{ tree.m_Root, kEmpty, 0, 1 } };
+        while (!tasks.empty())
+        {
+            const Task task = tasks.back();
+            tasks.pop_back();
+            const uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+            m_Nodes.emplace_back();
+            Node& node = m_Nodes.back();
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                // 空きは min > max にしておけば、どの判定でも外れる
+                setLane(node, lane, Aabb{ Math::Float3{ INFINITY, INFINITY, INFINITY }, Math::Float3{ -INFINITY, -INFINITY, -INFINITY } });
+                node.child[lane] = kEmpty;
+            }
+            if (task.parent != kEmpty)
+            {
+                m_Nodes[task.parent].child[task.lane] = index;
+            }
+            m_Depth = std::max(m_Depth, task.depth);
+
+            uint32_t kids[4] = { task.treeNode };
+            uint32_t count = 1;
+            const TreeNode& root = tree.m_Nodes[task.treeNode];
+            if (root.child1 != DynamicAabbTree::kNone)
+            {
+                kids[0] = root.child1;
+                kids[1] = root.child2;
+                count = 2;
+            }
+            while (count < 4)
+            {
+                uint32_t open = 4;
+                float openArea = -1.0f;
+                for (uint32_t k = 0; k < count; ++k)
+                {
+                    const TreeNode& n = tree.m_Nodes[kids[k]];
+                    if (n.child1 != DynamicAabbTree::kNone && HalfArea(n.box) > openArea)
+                    {
+                        open = k;
+                        openArea = HalfArea(n.box);
+                    }
+                }
+                if (open == 4)
+                {
+                    break;
+                }
+                const TreeNode& n = tree.m_Nodes[kids[open]];
+                kids[open] = n.child1;
+                kids[count++] = n.child2;
+            }
+
+            for (uint32_t lane = count; lane-- > 0;)
+            {
+                const TreeNode& kid = tree.m_Nodes[kids[lane]];
+                if (kid.child1 == DynamicAabbTree::kNone)
+                {
+                    setLane(m_Nodes[index], lane, kid.tight);
+                    m_Nodes[index].child[lane] = kLeafBit | static_cast<uint32_t>(m_Items.size());
+                    m_Items.push_back(kid.userData);
+                }
+                else
+                {
+                    tasks.push_back(Task{ kids[lane], index, lane, task.depth + 1 });
+                }
+            }
+        }
+
+        // 内側の箱は太らせていない葉の箱から作り直す(子は必ず親より後ろにある)
+        for (uint32_t index = static_cast<uint32_t>(m_Nodes.size()); index-- > 0;)
+        {
+            Node& node = m_Nodes[index];
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                const uint32_t child = node.child[lane];
+                if (child == kEmpty || (child & kLeafBit))
+                {
+                    continue;
+                }
+                const Node& c = m_Nodes[child];
+                Aabb box{ Math::Float3{ c.minX[0], c.minY[0], c.minZ[0] }, Math::Float3{ c.maxX[0], c.maxY[0], c.maxZ[0] } };
+                for (uint32_t l = 1; l < 4; ++l)
+                {
+                    box = Union(box, Aabb{ Math::Float3{ c.minX[l], c.minY[l], c.minZ[l] }, Math::Float3{ c.maxX[l], c.maxY[l], c.maxZ[l] } });
+                }
+                setLane(node, lane, box);
+            }
+        }
+    }
+
+    RayHit WideBvh::Raycast(const Ray& ray) const
+    {
+        using namespace Math::Simd;
+        RayHit hit{};
+        hit.t = ray.maxT;
+        if (m_Nodes.empty())
+        {
+            return hit;
+        }
+        // 向きの符号で手前と奥の面を先に選んでおく(min/max で入れ替えないので、空きの箱は t の区間が逆になって外れる)
+        const Math::Float3 inv{ 1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z };
+        const bool negX = std::signbit(inv.x);
+        const bool negY = std::signbit(inv.y);
+        const bool negZ = std::signbit(inv.z);
+        const V4 ox = Splat(ray.origin.x), oy = Splat(ray.origin.y), oz = Splat(ray.origin.z);
+        const V4 ix = Splat(inv.x), iy = Splat(inv.y), iz = Splat(inv.z);
+        const V4 zero = Splat(0.0f);
+
+        TraversalStack stack(m_Depth);
+        stack.Push(0, 0.0f);
+        while (!stack.Empty())
+        {
+            const StackEntry e = stack.Pop();
+            if (e.key > hit.t)
+            {
+                continue;
+            }
+            const Node& node = m_Nodes[e.node];
+            const V4 nearX = Mul(Sub(Load(negX ? node.maxX : node.minX), ox), ix);
+            const V4 nearY = Mul(Sub(Load(negY ? node.maxY : node.minY), oy), iy);
+            const V4 nearZ = Mul(Sub(Load(negZ ? node.maxZ : node.minZ), oz), iz);
+            const V4 farX = Mul(Sub(Load(negX ? node.minX : node.maxX), ox), ix);
+            const V4 farY = Mul(Sub(Load(negY ? node.minY : node.maxY), oy), iy);
+            const V4 farZ = Mul(Sub(Load(negZ ? node.minZ : node.maxZ), oz), iz);
+            const V4 tEnter = Max(Max(nearX, nearY), Max(nearZ, zero));
+            const V4 tExit = Min(Min(farX, farY), Min(farZ, Splat(hit.t)));
+            uint32_t mask = LessEqualMask(tEnter, tExit);
+            if (mask == 0)
+            {
+                continue;
+            }
+            alignas(16) float enter[4];
+            Store(enter, tEnter);
+            StackEntry inner[4];
+            uint32_t innerCount = 0;
+            for (; mask; mask &= mask - 1)
+            {
+                const uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+                const uint32_t child = node.child[lane];
+                if (child & kLeafBit)
+                {
+                    if (enter[lane] < hit.t || !hit.IsHit())
+                    {
+                        hit.t = enter[lane];
+                        hit.item = m_Items[child & ~kLeafBit];
+                    }
+                }
+                else
+                {
+                    inner[innerCount++] = StackEntry{ child, enter[lane] };
+                }
+            }
+            // 近い子を先に取り出せるよう、遠い方から積む
+            SortByKey(inner, innerCount);
+            for (uint32_t i = innerCount; i-- > 0;)
+            {
+                stack.Push(inner[i].node, inner[i].key);
+            }
+        }
+        return hit;
+    }
+
+    uint32_t WideBvh::Overlap(const Aabb& box, std::vector<uint32_t>& out) const
+    {
+        using namespace Math::Simd;
+        if (m_Nodes.empty())
+        {
+            return 0;
+        }
+        const size_t before = out.size();
+        const V4 qMinX = Splat(box.min.x), qMinY = Splat(box.min.y), qMinZ = Splat(box.min.z);
+        const V4 qMaxX = Splat(box.max.x), qMaxY = Splat(box.max.y), qMaxZ = Splat(box.max.z);
+        TraversalStack stack(m_Depth);
+        stack.Push(0, 0.0f);
+        while (!stack.Empty())
+        {
+            const Node& node = m_Nodes[stack.Pop().node];
+            uint32_t mask = LessEqualMask(Load(node.minX), qMaxX) & LessEqualMask(qMinX, Load(node.maxX)) &
+                LessEqualMask(Load(node.minY), qMaxY) & LessEqualMask(qMinY, Load(node.maxY)) &
+                LessEqualMask(Load(node.minZ), qMaxZ) & LessEqualMask(qMinZ, Load(node.maxZ));
+            for (; mask; mask &= mask - 1)
+            {
+                const uint32_t child = node.child[std::countr_zero(mask)];
+                if (child & kLeafBit)
+                {
+                    out.push_back(m_Items[child & ~kLeafBit]);
+                }
+                else
+                {
+                    stack.Push(child, 0.0f);
+                }
+            }
+        }
+        return static_cast<uint32_t>(out.size() - before);
+    }
+
+    NearestHit WideBvh::Nearest(Math::Float3 point, float maxDistance) const
+    {
+        using namespace Math::Simd;
+        NearestHit hit{};
+        // 2乗が無限大にならないよう抑える(空きの箱は距離が無限大なので、これで必ず外れる)
+        hit.distanceSq = std::min(maxDistance * maxDistance, FLT_MAX);
+        if (m_Nodes.empty())
+        {
+            return hit;
+        }
+        const V4 px = Splat(point.x), py = Splat(point.y), pz = Splat(point.z);
+        const V4 zero = Splat(0.0f);
+        TraversalStack stack(m_Depth);
+        stack.Push(0, 0.0f);
+        while (!stack.Empty())
+        {
+            const StackEntry e = stack.Pop();
+            if (e.key > hit.distanceSq)
+            {
+                continue;
+            }
+            const Node& node = m_Nodes[e.node];
+            // 軸ごとに箱の外へはみ出した分(中なら 0)
+            const V4 dx = Max(Max(Sub(Load(node.minX), px), Sub(px, Load(node.maxX))), zero);
+            const V4 dy = Max(Max(Sub(Load(node.minY), py), Sub(py, Load(node.maxY))), zero);
+            const V4 dz = Max(Max(Sub(Load(node.minZ), pz), Sub(pz, Load(node.maxZ))), zero);
+            const V4 distanceSq = MulAdd(dx, dx, MulAdd(dy, dy, Mul(dz, dz)));
+            uint32_t mask = LessEqualMask(distanceSq, Splat(hit.distanceSq));
+            if (mask == 0)
+            {
+                continue;
+            }
+            alignas(16) float d[4];
+            Store(d, distanceSq);
+            StackEntry inner[4];
+            uint32_t innerCount = 0;
+            for (; mask; mask &= mask - 1)
+            {
+                const uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+                const uint32_t child = node.child[lane];
+                if (child & kLeafBit)
+                {
+                    if (d[lane] < hit.distanceSq || !hit.IsHit())
+                    {
+                        hit.distanceSq = d[lane];
+                        hit.item = m_Items[child & ~kLeafBit];
+                    }
+                }
+                else
+                {
+                    inner[innerCount++] = StackEntry{ child, d[lane] };
+                }
+            }
+            SortByKey(inner, innerCount);
+            for (uint32_t i = innerCount; i-- > 0;)
+            {
+                stack.Push(inner[i].node, inner[i].key);
+            }
+        }
+        return hit;
+    }
+
+    void WideBvh::RaycastBatch(std::span<const Ray> rays, std::span<RayHit> hits, Job::JobSystem* jobs) const
+    {
+        const size_t count = std::min(rays.size(), hits.size());
+        auto run = [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    hits[i] = Raycast(rays[i]);
+                }
+            };
+        if (jobs && count > kBatchGrain)
+        {
+            jobs->ParallelFor(count, run, kBatchGrain);
+        }
+        else
+        {
+            run(0, count);
+        }
+    }
+
+    void WideBvh::NearestBatch(std::span<const Math::Float3> points, float maxDistance, std::span<NearestHit> hits, Job::JobSystem* jobs) const
+    {
+        const size_t count = std::min(points.size(), hits.size());
+        auto run = [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    hits[i] = Nearest(points[i], maxDistance);
+                }
+            };
+        if (jobs && count > kBatchGrain)
+        {
+            jobs->ParallelFor(count, run, kBatchGrain);
+        }
+        else
+        {
+            run(0, count);
+        }
+    }
+
+    void WideBvh::OverlapBatch(std::span<const Aabb> boxes, std::vector<uint32_t>& offsets, std::vector<uint32_t>& items, Job::JobSystem* jobs) const
+    {
+        // 個数が問い合わせごとに違うので、kBatchGrain 個ずつの塊ごとに別の配列へ書き、最後につなぐ
+        const size_t count = boxes.size();
+        const size_t chunks = (count + kBatchGrain - 1) / kBatchGrain;
+        std::vector<std::vector<uint32_t>> chunkItems(chunks);
+        offsets.assign(count + 1, 0);
+        auto run = [&](size_t chunk)
+            {
+                const size_t begin = chunk * kBatchGrain;
+                const size_t end = std::min(count, begin + kBatchGrain);
+                for (size_t q = begin; q < end; ++q)
+                {
+                    offsets[q + 1] = Overlap(boxes[q], chunkItems[chunk]);
+                }
+            };
+        if (jobs && chunks > 1)
+        {
+            jobs->ParallelFor(chunks, [&](size_t begin, size_t end)
+                {
+                    for (size_t chunk = begin; chunk < end; ++chunk)
+                    {
+                        run(chunk);
+                    }
+                }, 1);
+        }
+        else
+        {
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                run(chunk);
+            }
+        }
+
+        for (size_t q = 0; q < count; ++q)
+        {
+            offsets[q + 1] += offsets[q];
+        }
+        items.clear();
+        items.reserve(offsets[count]);
+        for (const std::vector<uint32_t>& chunk : chunkItems)
+        {
+            items.insert(items.end(), chunk.begin(), chunk.end());
+        }
+    }
+}
@@ -0,0 +1,507 @@
+#include "pch.h"
+#include "include/Ecs.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+
+#include "include/MemoryTracker.h"
+
+namespace
+{
+    using Drama::Core::Ecs::ComponentTypeInfo;
+    using Drama::Core::Ecs::kMaxComponentTypes;
+
+    /// @brief 型の登録表(番号で引く。登録は型ごとの初回だけなのでロックでよい)
+    std::mutex g_TypeMutex;
+    ComponentTypeInfo g_Types[kMaxComponentTypes];
+    uint32_t g_TypeCount = 0;
+
+    constexpr size_t kColumnAlign = 64; ///< 各配列の先頭をキャッシュラインに揃える(SIMD でまとめて読める)
+
+    inline void Relocate(const ComponentTypeInfo& info, void* dst, void* src) noexcept
+    {
+        if (info.relocate)
+        {
+            info.relocate(dst, src);
+        }
+        else
+        {
+            std::memcpy(dst, src, info.size);
+        }
+    }
+
+    inline void DestroyValue(const ComponentTypeInfo& info, void* p) noexcept
+    {
+        if (info.destroy)
+        {
+            info.destroy(p);
+        }
+    }
+
+    constexpr size_t AlignUp(size_t value, size_t align) noexcept
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+}
+
+namespace Drama::Core::Ecs
+{
+    uint32_t Detail::RegisterComponentType(const ComponentTypeInfo& info) noexcept
+    {
+        std::scoped_lock lock(g_TypeMutex);
+        if (g_TypeCount >= kMaxComponentTypes)
+        {
+            return kInvalidComponent;
+        }
+        g_Types[g_TypeCount] = info;
+        return g_TypeCount++;
+    }
+
+    const ComponentTypeInfo& ComponentType(uint32_t id) noexcept
+    {
+        return g_Types[id];
+    }
+
+    // ---- CommandBuffer ----
+
+    CommandBuffer::CommandBuffer(size_t blockSize) noexcept
+        : m_Arena(blockSize, Memory::MemoryTag::Ecs)
+    {
+    }
+
+    CommandBuffer::~CommandBuffer()
+    {
+        Clear();
+    }
+
+    void CommandBuffer::Destroy(Entity entity)
+    {
+        m_Commands.push_back(Command{ Op::Destroy, kInvalidComponent, 0, entity, nullptr });
+    }
+
+    void CommandBuffer::Clear() noexcept
+    {
+        for (const Command& command : m_Commands)
+        {
+            if (command.op == Op::Create)
+            {
+                const Payload* payloads = static_cast<const Payload*>(command.payload);
+                for (uint32_t i = 0; i < command.count; ++i)
+                {
+                    if (payloads[i].data && payloads[i].component != kInvalidComponent)
+                    {
+                        DestroyValue(ComponentType(payloads[i].component), payloads[i].data);
+                    }
+                }
+            }
+            else if (command.op == Op::Add && command.payload && command.component != kInvalidComponent)
+            {
+                DestroyValue(ComponentType(command.component), command.payload);
+            }
+        }
+        Consumed();
+    }
+
+    void CommandBuffer::Consumed() noexcept
+    {
+        m_Commands.clear();
+        m_Arena.Reset();
+    }
+
+    // ---- World ----
+
+    World::~World()
+    {
+        Clear();
+        for (std::byte* data : m_FreeChunks)
+        {
+            Memory::TrackedFree(Memory::MemoryTag::Ecs, data, kChunkSize, kColumnAlign);
+        }
+        m_FreeChunks.clear();
+    }
+
+    bool World::CreateEntity(ComponentMask mask, Entity& entity, Archetype*& archetype, const Archetype::Chunk*& chunk, uint32_t& row)
+    {
+        archetype = FindOrCreateArchetype(mask);
+        if (!archetype)
+        {
+            return false;
+        }
+        uint32_t index = 0;
+        if (!m_FreeEntities.empty())
+        {
+            index = m_FreeEntities.back();
+            m_FreeEntities.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_Entities.size());
+            m_Entities.emplace_back();
+        }
+        entity = Entity{ index, m_Entities[index].generation };
+        if (!AppendRow(*archetype, entity))
+        {
+            m_FreeEntities.push_back(index);
+            return false;
+        }
+        const EntityRecord& record = m_Entities[index];
+        chunk = &archetype->m_Chunks[record.chunk];
+        row = record.row;
+        ++m_Alive;
+        return true;
+    }
+
+    bool World::Destroy(Entity entity) noexcept
+    {
+        if (!IsAlive(entity))
+        {
+            return false;
+        }
+        EntityRecord& record = m_Entities[entity.index];
+        Archetype& archetype = *record.archetype;
+        DestroyComponents(archetype, archetype.m_Chunks[record.chunk], record.row);
+        RemoveRow(archetype, record.chunk, record.row);
+        record.archetype = nullptr;
+        // 世代は 0(無効)を飛ばして進める
+        record.generation = record.generation + 1 != 0 ? record.generation + 1 : 1;
+        m_FreeEntities.push_back(entity.index);
+        --m_Alive;
+        return true;
+    }
+
+    void* World::AddComponent(Entity entity, uint32_t id, bool& existed)
+    {
+        existed = false;
+        if (id >= kMaxComponentTypes || !IsAlive(entity))
+        {
+            return nullptr;
+        }
+        EntityRecord& record = m_Entities[entity.index];
+        Archetype* from = record.archetype;
+        if (from->m_Mask & (ComponentMask{ 1 } << id))
+        {
+            existed = true;
+            return from->Component(from->m_Chunks[record.chunk], id, record.row);
+        }
+        Archetype* to = from->m_AddEdges[id];
+        if (!to)
+        {
+            to = FindOrCreateArchetype(from->m_Mask | (ComponentMask{ 1 } << id));
+            if (!to)
+            {
+                return nullptr;
+            }
+            from->m_AddEdges[id] = to;
+        }
+        if (!MoveEntity(record, entity, *to))
+        {
+            return nullptr;
+        }
+        return to->Component(to->m_Chunks[record.chunk], id, record.row);
+    }
+
+    bool World::RemoveComponent(Entity entity, uint32_t id) noexcept
+    {
+        if (id >= kMaxComponentTypes || !IsAlive(entity))
+        {
+            return false;
+        }
+        EntityRecord& record = m_Entities[entity.index];
+        Archetype* from = record.archetype;
+        if (!(from->m_Mask & (ComponentMask{ 1 } << id)))
+        {
+            return false;
+        }
+        Archetype* to = from->m_RemoveEdges[id];
+        if (!to)
+        {
+            to = FindOrCreateArchetype(from->m_Mask & ~(ComponentMask{ 1 } << id));
+            if (!to)
+            {
+                return false;
+            }
+            from->m_RemoveEdges[id] = to;
+        }
+        // 外す型は MoveEntity が移し先に無いものとして破棄する
+        return MoveEntity(record, entity, *to);
+    }
+
+    void* World::GetComponent(Entity entity, uint32_t id) const noexcept
+    {
+        if (id >= kMaxComponentTypes || !IsAlive(entity))
+        {
+            return nullptr;
+        }
+        const EntityRecord& record = m_Entities[entity.index];
+        const Archetype* archetype = record.archetype;
+        if (!(archetype->m_Mask & (ComponentMask{ 1 } << id)))
+        {
+            return nullptr;
+        }
+        return archetype->Component(archetype->m_Chunks[record.chunk], id, record.row);
+    }
+
+    Archetype* World::FindOrCreateArchetype(ComponentMask mask)
+    {
+        auto it = m_ArchetypeMap.find(mask);
+        if (it != m_ArchetypeMap.end())
+        {
+            return it->second.get();
+        }
+
+        auto archetype = std::make_unique<Archetype>();
+        archetype->m_Mask = mask;
+        size_t rowSize = sizeof(Entity);
+        for (ComponentMask bits = mask; bits != 0; bits &= bits - 1)
+        {
+            const uint32_t id = static_cast<uint32_t>(std::countr_zero(bits));
+            archetype->m_Components.push_back(id);
+            rowSize += ComponentType(id).size;
+        }
+        // 配列ごとの境界合わせで失う分を先に引いてから、1チャンクに入る数を決める
+        const size_t padding = kColumnAlign * archetype->m_Components.size();
+        if (kChunkSize <= padding + rowSize)
+        {
+            return nullptr;
+        }
+        const uint32_t capacity = static_cast<uint32_t>((kChunkSize - padding) / rowSize);
+        size_t offset = AlignUp(sizeof(Entity) * capacity, kColumnAlign);
+        for (const uint32_t id : archetype->m_Components)
+        {
+            const ComponentTypeInfo& info = ComponentType(id);
+            if (info.align > kColumnAlign)
+            {
+                return nullptr;
+            }
+            archetype->m_Offsets[id] = static_cast<uint32_t>(offset);
+            offset = AlignUp(offset + info.size * capacity, kColumnAlign);
+        }
+        archetype->m_Capacity = capacity;
+
+        Archetype* result = archetype.get();
+        m_ArchetypeMap.emplace(mask, std::move(archetype));
+        m_Archetypes.push_back(result);
+        return result;
+    }
+
+    bool World::AppendRow(Archetype& archetype, Entity entity)
+    {
+        if (archetype.m_Chunks.empty() || archetype.m_Chunks.back().count == archetype.m_Capacity)
+        {
+            std::byte* data = AllocateChunk();
+            if (!data)
+            {
+                return false;
+            }
+            archetype.m_Chunks.push_back(Archetype::Chunk{ data, 0 });
+        }
+        Archetype::Chunk& chunk = archetype.m_Chunks.back();
+        const uint32_t row = chunk.count++;
+        archetype.Entities(chunk)[row] = entity;
+        ++archetype.m_EntityCount;
+
+        EntityRecord& record = m_Entities[entity.index];
+        record.archetype = &archetype;
+        record.chunk = static_cast<uint32_t>(archetype.m_Chunks.size() - 1);
+        record.row = row;
+        return true;
+    }
+
+    bool World::MoveEntity(EntityRecord& record, Entity entity, Archetype& to)
+    {
+        Archetype& from = *record.archetype;
+        const uint32_t fromChunk = record.chunk;
+        const uint32_t fromRow = record.row;
+        if (!AppendRow(to, entity))
+        {
+            return false;
+        }
+        const Archetype::Chunk& src = from.m_Chunks[fromChunk];
+        const Archetype::Chunk& dst = to.m_Chunks[record.chunk];
+        for (const uint32_t id : from.m_Components)
+        {
+            const ComponentTypeInfo& info = ComponentType(id);
+            void* p = from.Component(src, id, fromRow);
+            if (to.m_Mask & (ComponentMask{ 1 } << id))
+            {
+                Relocate(info, to.Component(dst, id, record.row), p);
+            }
+            else
+            {
+                DestroyValue(info, p);
+            }
+        }
+        RemoveRow(from, fromChunk, fromRow);
+        return true;
+    }
+
+    void World::RemoveRow(Archetype& archetype, uint32_t chunk, uint32_t row) noexcept
+    {
+        const uint32_t lastChunk = static_cast<uint32_t>(archetype.m_Chunks.size() - 1);
+        Archetype::Chunk& last = archetype.m_Chunks[lastChunk];
+        const uint32_t lastRow = last.count - 1;
+        if (chunk != lastChunk || row != lastRow)
+        {
+            // 末尾のエンティティで穴を埋めて、チャンクを詰まった状態に保つ
+            Archetype::Chunk& hole = archetype.m_Chunks[chunk];
+            const Entity moved = archetype.Entities(last)[lastRow];
+            for (const uint32_t id : archetype.m_Components)
+            {
+                Relocate(ComponentType(id), archetype.Component(hole, id, row), archetype.Component(last, id, lastRow));
+            }
+            archetype.Entities(hole)[row] = moved;
+            EntityRecord& record = m_Entities[moved.index];
+            record.chunk = chunk;
+            record.row = row;
+        }
+        --last.count;
+        --archetype.m_EntityCount;
+        if (last.count == 0)
+        {
+            FreeChunk(last.data);
+            archetype.m_Chunks.pop_back();
+        }
+    }
+
+    void World::DestroyComponents(const Archetype& archetype, const Archetype::Chunk& chunk, uint32_t row) noexcept
+    {
+        for (const uint32_t id : archetype.m_Components)
+        {
+            DestroyValue(ComponentType(id), archetype.Component(chunk, id, row));
+        }
+    }
+
+    std::byte* World::AllocateChunk()
+    {
+        if (!m_FreeChunks.empty())
+        {
+            std::byte* data = m_FreeChunks.back();
+            m_FreeChunks.pop_back();
+            return data;
+        }
+        return static_cast<std::byte*>(Memory::TrackedAllocate(Memory::MemoryTag::Ecs, kChunkSize, kColumnAlign));
+    }
+
+    void World::FreeChunk(std::byte* data) noexcept
+    {
+        m_FreeChunks.push_back(data);
+    }
+
+    void World::Playback(CommandBuffer& commands)
+    {
+        using Op = CommandBuffer::Op;
+        using Payload = CommandBuffer::Payload;
+        for (const CommandBuffer::Command& command : commands.m_Commands)
+        {
+            switch (command.op)
+            {
+            case Op::Create:
+            {
+                const Payload* payloads = static_cast<const Payload*>(command.payload);
+                ComponentMask mask = 0;
+                bool valid = true;
+                for (uint32_t i = 0; i < command.count; ++i)
+                {
+                    valid = valid && payloads[i].component != kInvalidComponent;
+                    if (valid && payloads[i].data)
+                    {
+                        mask |= ComponentMask{ 1 } << payloads[i].component;
+                    }
+                }
+                Entity entity{};
+                Archetype* archetype = nullptr;
+                const Archetype::Chunk* chunk = nullptr;
+                uint32_t row = 0;
+                const bool created = valid && CreateEntity(mask, entity, archetype, chunk, row);
+                for (uint32_t i = 0; i < command.count; ++i)
+                {
+                    const Payload& payload = payloads[i];
+                    if (!payload.data || payload.component == kInvalidComponent)
+                    {
+                        continue;
+                    }
+                    const ComponentTypeInfo& info = ComponentType(payload.component);
+                    if (created)
+                    {
+                        Relocate(info, archetype->Component(*chunk, payload.component, row), payload.data);
+                    }
+                    else
+                    {
+                        DestroyValue(info, payload.data);
+                    }
+                }
+                break;
+            }
+            case Op::Destroy:
+                Destroy(command.entity);
+                break;
+            case Op::Add:
+            {
+                if (!command.payload || command.component == kInvalidComponent)
+                {
+                    break;
+                }
+                const ComponentTypeInfo& info = ComponentType(command.component);
+                bool existed = false;
+                void* p = AddComponent(command.entity, command.component, existed);
+                if (!p)
+                {
+                    DestroyValue(info, command.payload);
+                    break;
+                }
+                if (existed)
+                {
+                    DestroyValue(info, p);
+                }
+                Relocate(info, p, command.payload);
+                break;
+            }
+            case Op::Remove:
+                RemoveComponent(command.entity, command.component);
+                break;
+            }
+        }
+        commands.Consumed();
+    }
+
+    void World::Clear() noexcept
+    {
+        for (Archetype* archetype : m_Archetypes)
+        {
+            for (const Archetype::Chunk& chunk : archetype->m_Chunks)
+            {
+                for (uint32_t row = 0; row < chunk.count; ++row)
+                {
+                    DestroyComponents(*archetype, chunk, row);
+                }
+                FreeChunk(chunk.data);
+            }
+            archetype->m_Chunks.clear();
+            archetype->m_EntityCount = 0;
+        }
+        for (uint32_t i = 0; i < m_Entities.size(); ++i)
+        {
+            EntityRecord& record = m_Entities[i];
+            if (record.archetype)
+            {
+                record.archetype = nullptr;
+                record.generation = record.generation + 1 != 0 ? record.generation + 1 : 1;
+                m_FreeEntities.push_back(i);
+            }
+        }
+        m_Alive = 0;
+    }
+
+    size_t World::ChunkCount() const noexcept
+    {
+        size_t count = 0;
+        for (const Archetype* archetype : m_Archetypes)
+        {
+            count += archetype->m_Chunks.size();
+        }
+        return count;
+    }
+}
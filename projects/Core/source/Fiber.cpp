@@ -0,0 +1,302 @@
+#include "pch.h"
+#include "include/Fiber.h"
+
+// C++ standard library includes
+#include <cstdlib>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__x86_64__) && defined(__linux__)
+#define DRAMA_FIBER_X64_ASM 1
+#else
+#include <ucontext.h>
+#endif
+#endif
+
+#if defined(DRAMA_FIBER_X64_ASM)
+// System V x86-64 の callee-saved レジスタ(rbp, rbx, r12-r15)と MXCSR / x87 制御語だけを退避して
+// スタックを差し替える。ucontext の swapcontext はシグナルマスクのためにシステムコールを伴うので使わない。
+extern "C" void DramaFiberSwitch(void** saveSp, void* loadSp);
+extern "C" void DramaFiberTrampoline();
+asm(R"(
+    .text
+    .globl DramaFiberSwitch
+    .type DramaFiberSwitch,@function
+    .p2align 4
+DramaFiberSwitch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size DramaFiberSwitch,.-DramaFiberSwitch
+
+    .globl DramaFiberTrampoline
+    .type DramaFiberTrampoline,@function
+    .p2align 4
+DramaFiberTrampoline:
+    movq %r12, %rdi
+    callq *%r13
+    ud2
+    .size DramaFiberTrampoline,.-DramaFiberTrampoline
+)");
+#endif
+
+namespace
+{
+#if !defined(_WIN32)
+    size_t PageSize() noexcept
+    {
+        static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+#endif
+}
+
+namespace Drama::Core::Job
+{
+#if !defined(_WIN32) && !defined(DRAMA_FIBER_X64_ASM)
+    struct Fiber::Context
+    {
+        ucontext_t uc{};
+    };
+#else
+    struct Fiber::Context
+    {
+    };
+#endif
+
+    Fiber::Fiber() noexcept = default;
+
+    Fiber::~Fiber()
+    {
+#if defined(_WIN32)
+        if (m_Handle != nullptr && !m_IsThread)
+        {
+            ::DeleteFiber(m_Handle);
+        }
+#endif
+        m_Handle = nullptr;
+    }
+
+    bool Fiber::InitFromThread() noexcept
+    {
+        m_IsThread = true;
+#if defined(_WIN32)
+        m_Handle = ::ConvertThreadToFiberEx(nullptr, FIBER_FLAG_FLOAT_SWITCH);
+        m_IsConverted = (m_Handle != nullptr);
+        if (m_Handle == nullptr && ::GetLastError() == ERROR_ALREADY_FIBER)
+        {
+            m_Handle = ::GetCurrentFiber();
+        }
+        return m_Handle != nullptr;
+#elif defined(DRAMA_FIBER_X64_ASM)
+        // 退避先のスタックポインタは最初に切り替えたときに書かれる。それまでの目印として自分を指しておく
+        m_Handle = this;
+        return true;
+#else
+        m_Context = std::make_unique<Context>();
+        m_Handle = &m_Context->uc;
+        return true;
+#endif
+    }
+
+    void Fiber::ReleaseFromThread() noexcept
+    {
+        if (!m_IsThread)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        if (m_IsConverted)
+        {
+            ::ConvertFiberToThread();
+        }
+#endif
+        m_Context.reset();
+        m_Handle = nullptr;
+        m_IsThread = false;
+        m_IsConverted = false;
+    }
+
+    bool Fiber::Create(Entry entry, void* arg, [[maybe_unused]] void* stack, size_t stackSize) noexcept
+    {
+        m_Entry = entry;
+        m_Arg = arg;
+        m_IsThread = false;
+#if defined(_WIN32)
+        m_Handle = ::CreateFiberEx(0, stackSize, FIBER_FLAG_FLOAT_SWITCH,
+            [](void* p) { Fiber::Start(static_cast<Fiber*>(p)); }, this);
+        return m_Handle != nullptr;
+#elif defined(DRAMA_FIBER_X64_ASM)
+        if (stack == nullptr || stackSize < 256)
+        {
+            return false;
+        }
+        // DramaFiberSwitch が復元する並びで初期値を積む。ret で DramaFiberTrampoline に入り、
+        // そこから r13(Start) を r12(this) を引数に呼ぶ。ret 直後の rsp が16バイト境界になるようにする
+        auto* top = reinterpret_cast<uint64_t*>(
+            (reinterpret_cast<uintptr_t>(stack) + stackSize) & ~static_cast<uintptr_t>(15));
+        top[-1] = reinterpret_cast<uint64_t>(&DramaFiberTrampoline);
+        top[-2] = 0;                                                // rbp
+        top[-3] = 0;                                                // rbx
+        top[-4] = reinterpret_cast<uint64_t>(this);                 // r12
+        top[-5] = reinterpret_cast<uint64_t>(&Fiber::Start);        // r13
+        top[-6] = 0;                                                // r14
+        top[-7] = 0;                                                // r15
+        top[-8] = 0x1F80ull | (0x037Full << 32);                    // MXCSR / x87 制御語の既定値
+        m_Handle = &top[-8];
+        return true;
+#else
+        if (stack == nullptr)
+        {
+            return false;
+        }
+        m_Context = std::make_unique<Context>();
+        ucontext_t* uc = &m_Context->uc;
+        if (::getcontext(uc) != 0)
+        {
+            m_Context.reset();
+            return false;
+        }
+        uc->uc_stack.ss_sp = stack;
+        uc->uc_stack.ss_size = stackSize;
+        uc->uc_link = nullptr;
+        // makecontext の引数は int なので、ポインタを上下に分けて渡す
+        const uintptr_t self = reinterpret_cast<uintptr_t>(this);
+        ::makecontext(uc, reinterpret_cast<void (*)()>(+[](int hi, int lo)
+            {
+                const uintptr_t p = (static_cast<uintptr_t>(static_cast<uint32_t>(hi)) << 32) | static_cast<uint32_t>(lo);
+                Fiber::Start(reinterpret_cast<Fiber*>(p));
+            }), 2, static_cast<int>(self >> 32), static_cast<int>(self & 0xFFFFFFFFu));
+        m_Handle = uc;
+        return true;
+#endif
+    }
+
+    void Fiber::Switch([[maybe_unused]] Fiber& from, Fiber& to) noexcept
+    {
+#if defined(_WIN32)
+        ::SwitchToFiber(to.m_Handle);
+#elif defined(DRAMA_FIBER_X64_ASM)
+        DramaFiberSwitch(&from.m_Handle, to.m_Handle);
+#else
+        ::swapcontext(static_cast<ucontext_t*>(from.m_Handle), static_cast<ucontext_t*>(to.m_Handle));
+#endif
+    }
+
+    void Fiber::Start(Fiber* self) noexcept
+    {
+        self->m_Entry(self->m_Arg);
+        // entry から戻ってくるのは使い方の誤り(戻り先が無い)
+        std::abort();
+    }
+
+    FiberPool::~FiberPool()
+    {
+        Shutdown();
+    }
+
+    bool FiberPool::Init(uint32_t count, size_t stackSize, Fiber::Entry entry, void* arg)
+    {
+        Shutdown();
+#if defined(_WIN32)
+        m_StackSize = stackSize;
+#else
+        const size_t page = PageSize();
+        m_StackSize = (stackSize + page - 1) / page * page;
+        const size_t stride = m_StackSize + page;
+        m_StacksBytes = stride * count;
+        void* region = ::mmap(nullptr, m_StacksBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED)
+        {
+            m_StacksBytes = 0;
+            return false;
+        }
+        m_Stacks = region;
+#endif
+        m_Fibers.reserve(count);
+        m_Free.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            void* stack = nullptr;
+#if !defined(_WIN32)
+            // 各スタックの下端(スタックが伸びていく先)を保護ページにする
+            auto* base = static_cast<std::byte*>(m_Stacks) + stride * i;
+            ::mprotect(base, page, PROT_NONE);
+            stack = base + page;
+#endif
+            auto fiber = std::make_unique<Fiber>();
+            if (!fiber->Create(entry, arg, stack, m_StackSize))
+            {
+                Shutdown();
+                return false;
+            }
+            m_Free.push_back(fiber.get());
+            m_Fibers.push_back(std::move(fiber));
+        }
+        return true;
+    }
+
+    void FiberPool::Shutdown() noexcept
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Free.clear();
+        }
+        m_Fibers.clear();
+#if !defined(_WIN32)
+        if (m_Stacks != nullptr)
+        {
+            ::munmap(m_Stacks, m_StacksBytes);
+        }
+#endif
+        m_Stacks = nullptr;
+        m_StacksBytes = 0;
+    }
+
+    Fiber* FiberPool::Acquire() noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+        if (m_Free.empty())
+        {
+            return nullptr;
+        }
+        Fiber* fiber = m_Free.back();
+        m_Free.pop_back();
+        return fiber;
+    }
+
+    void FiberPool::Release(Fiber* fiber) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Free.push_back(fiber);
+    }
+
+    uint32_t FiberPool::Available() const noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+        return static_cast<uint32_t>(m_Free.size());
+    }
+}
@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "include/FileChangeCoalescer.h"
+
+// C++ standard library includes
+#include <algorithm>
+
+namespace
+{
+    using Drama::Core::IO::FileChangeKind;
+
+    /// @brief 同じパスに続けて届いた通知を1つにする
+    /// @return 打ち消し合って何も無かったことになるなら false
+    bool Merge(FileChangeKind& current, FileChangeKind next) noexcept
+    {
+        if (current == FileChangeKind::Rescan || next == FileChangeKind::Rescan)
+        {
+            current = FileChangeKind::Rescan;
+            return true;
+        }
+        switch (current)
+        {
+        case FileChangeKind::Added:
+            // 作ってすぐ消えた一時ファイルは通知しない。作った後の書き込みは Added のまま
+            return next != FileChangeKind::Removed;
+        case FileChangeKind::Removed:
+            // 消してから作り直す保存方法は、利用側から見れば書き換え
+            current = (next == FileChangeKind::Removed) ? FileChangeKind::Removed : FileChangeKind::Modified;
+            return true;
+        default:
+            current = next;
+            return true;
+        }
+    }
+}
+
+namespace Drama::Core::IO
+{
+    void FileChangeCoalescer::Push(std::string_view path, FileChangeKind kind, uint64_t nowNs)
+    {
+        auto it = m_Pending.find(std::string(path));
+        if (it == m_Pending.end())
+        {
+            m_Pending.emplace(std::string(path), Pending{ kind, nowNs });
+        }
+        else if (Merge(it->second.kind, kind))
+        {
+            it->second.lastNs = nowNs;
+        }
+        else
+        {
+            m_Pending.erase(it);
+        }
+        m_OldestNs = std::min(m_OldestNs, nowNs);
+    }
+
+    size_t FileChangeCoalescer::Drain(uint64_t nowNs, uint64_t debounceNs, std::vector<FileChange>& out)
+    {
+        // 通知が無いフレーム、まだ静かになっていないフレームは走査しない
+        if (m_Pending.empty() || nowNs < m_OldestNs || nowNs - m_OldestNs < debounceNs)
+        {
+            return 0;
+        }
+
+        m_Ready.clear();
+        uint64_t oldest = UINT64_MAX;
+        for (const auto& [path, pending] : m_Pending)
+        {
+            if (nowNs >= pending.lastNs && nowNs - pending.lastNs >= debounceNs)
+            {
+                m_Ready.push_back(path);
+            }
+            else
+            {
+                oldest = std::min(oldest, pending.lastNs);
+            }
+        }
+        m_OldestNs = oldest;
+
+        // ハッシュ表の順は実行ごとに変わり得るので、並びを決めておく
+        std::sort(m_Ready.begin(), m_Ready.end());
+        out.reserve(out.size() + m_Ready.size());
+        for (std::string& path : m_Ready)
+        {
+            auto node = m_Pending.extract(path);
+            out.push_back(FileChange{ std::move(node.key()), node.mapped().kind });
+        }
+        return m_Ready.size();
+    }
+}
@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "include/FileChangeDispatcher.h"
+
+// C++ standard library includes
+#include <algorithm>
+
+namespace
+{
+    using Drama::Core::IO::FileChange;
+    using Drama::Core::IO::FileChangeKind;
+
+    bool Matches(const FileChange& change, std::string_view prefix) noexcept
+    {
+        if (std::string_view(change.path).starts_with(prefix))
+        {
+            return true;
+        }
+        // 親ディレクトリごと読み直しが必要になった場合
+        return change.kind == FileChangeKind::Rescan && prefix.starts_with(change.path);
+    }
+}
+
+namespace Drama::Core::IO
+{
+    uint32_t FileChangeDispatcher::Subscribe(std::string prefix, FileChangeHandler handler)
+    {
+        const uint32_t id = m_NextId++;
+        m_Subscribers.push_back(Subscriber{ id, std::move(prefix), std::move(handler) });
+        return id;
+    }
+
+    void FileChangeDispatcher::Unsubscribe(uint32_t id) noexcept
+    {
+        m_Subscribers.erase(std::remove_if(m_Subscribers.begin(), m_Subscribers.end(),
+            [id](const Subscriber& s) { return s.id == id; }), m_Subscribers.end());
+    }
+
+    void FileChangeDispatcher::Dispatch(std::span<const FileChange> changes)
+    {
+        if (changes.empty())
+        {
+            return;
+        }
+        for (Subscriber& s : m_Subscribers)
+        {
+            m_Batch.clear();
+            for (const FileChange& c : changes)
+            {
+                if (Matches(c, s.prefix))
+                {
+                    m_Batch.push_back(c);
+                }
+            }
+            if (!m_Batch.empty() && s.handler)
+            {
+                s.handler(m_Batch);
+            }
+        }
+    }
+}
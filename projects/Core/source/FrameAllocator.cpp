@@ -0,0 +1,283 @@
+#include "pch.h"
+#include "include/FrameAllocator.h"
+#include "include/ThreadLocalAccess.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <new>
+
+namespace
+{
+    /// @brief 呼び出しスレッドが最後に使った確保器と、そこでの番号
+    struct ThreadSlotCache
+    {
+        uint64_t allocatorId = 0;
+        uint32_t index = 0;
+    };
+    thread_local ThreadSlotCache t_Cache;
+
+    // ファイバーで移るジョブから呼ばれるので毎回引き直す(理由は ThreadLocalAccess.h)
+    DRAMA_NOINLINE ThreadSlotCache& Cache() noexcept
+    {
+        DRAMA_OPAQUE_BARRIER();
+        return t_Cache;
+    }
+
+    std::atomic<uint64_t> g_NextAllocatorId{ 1 };
+}
+
+namespace Drama::Core::Memory
+{
+    LinearArena::LinearArena(size_t blockSize, MemoryTag tag) noexcept
+        : m_BlockSize(std::max<size_t>(blockSize, 256)), m_Tag(tag)
+    {
+    }
+
+    LinearArena::~LinearArena()
+    {
+        Release();
+    }
+
+    void* LinearArena::AllocateSlow(size_t size, size_t align) noexcept
+    {
+        // 0 バイトでも他と重ならない有効なアドレスを返す
+        size = std::max<size_t>(size, 1);
+        if (align == 0 || (align & (align - 1)) != 0 || size > SIZE_MAX / 2)
+        {
+            return nullptr;
+        }
+        const size_t need = size + align - 1;
+
+        // 後ろに残っているブロックで足りるものがあれば使う(前回までに伸ばした分)
+        if (m_Current && m_Current->next && m_Current->next->size >= need)
+        {
+            Enter(m_Current->next);
+            const uintptr_t p = (m_Cursor + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+            m_Cursor = p + size;
+            return reinterpret_cast<void*>(p);
+        }
+
+        // 足りなければ新しいブロックを今のブロックの直後に差し込む(残りのブロックは次の周で使う)
+        const size_t blockSize = std::max(m_BlockSize, need);
+        void* memory = ::operator new(sizeof(Block) + blockSize, std::nothrow);
+        if (!memory)
+        {
+            return nullptr;
+        }
+        Block* block = static_cast<Block*>(memory);
+        block->size = blockSize;
+        block->next = nullptr;
+        m_Reserved += sizeof(Block) + blockSize;
+        MemoryTracker::RecordAllocation(m_Tag, memory, sizeof(Block) + blockSize);
+        ++m_BlockAllocations;
+        if (m_Current)
+        {
+            block->next = m_Current->next;
+            m_Current->next = block;
+        }
+        else
+        {
+            block->next = m_Head;
+            m_Head = block;
+        }
+        Enter(block);
+        const uintptr_t p = (m_Cursor + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+        m_Cursor = p + size;
+        return reinterpret_cast<void*>(p);
+    }
+
+    void LinearArena::Enter(Block* block) noexcept
+    {
+        if (m_Current)
+        {
+            m_UsedBefore += m_Cursor - reinterpret_cast<uintptr_t>(m_Current->Data());
+        }
+        m_Current = block;
+        m_Cursor = reinterpret_cast<uintptr_t>(block->Data());
+        m_End = m_Cursor + block->size;
+    }
+
+    void LinearArena::Reset() noexcept
+    {
+        m_Peak = std::max(m_Peak, UsedBytes());
+        m_UsedBefore = 0;
+        m_Current = nullptr;
+        m_Cursor = 0;
+        m_End = 0;
+        if (m_Head)
+        {
+            Enter(m_Head);
+        }
+    }
+
+    void LinearArena::Release() noexcept
+    {
+        m_Peak = std::max(m_Peak, UsedBytes());
+        Block* block = m_Head;
+        while (block)
+        {
+            Block* next = block->next;
+            MemoryTracker::RecordFree(m_Tag, block, sizeof(Block) + block->size);
+            ::operator delete(block);
+            block = next;
+        }
+        m_Head = nullptr;
+        m_Current = nullptr;
+        m_Cursor = 0;
+        m_End = 0;
+        m_UsedBefore = 0;
+        m_Reserved = 0;
+    }
+
+    size_t LinearArena::UsedBytes() const noexcept
+    {
+        if (!m_Current)
+        {
+            return 0;
+        }
+        return m_UsedBefore + (m_Cursor - reinterpret_cast<uintptr_t>(m_Current->Data()));
+    }
+
+    size_t LinearArena::PeakBytes() const noexcept
+    {
+        return std::max(m_Peak, UsedBytes());
+    }
+
+    FrameAllocator::FrameAllocator() noexcept
+        : m_Id(g_NextAllocatorId.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        Shutdown();
+    }
+
+    bool FrameAllocator::Init(uint32_t frameSlots, const FrameAllocatorDesc& desc)
+    {
+        Shutdown();
+        if (frameSlots == 0 || desc.maxThreads == 0)
+        {
+            return false;
+        }
+        m_MaxThreads = desc.maxThreads;
+        m_Slots.reserve(frameSlots);
+        for (uint32_t i = 0; i < frameSlots; ++i)
+        {
+            // ブロックは最初に確保したときに取る(使わないスレッドの分はメモリを食わない)
+            auto slot = std::make_unique<Slot>();
+            slot->threads.reserve(m_MaxThreads);
+            for (uint32_t t = 0; t < m_MaxThreads; ++t)
+            {
+                slot->threads.push_back(std::make_unique<ThreadArena>(desc.blockSize));
+            }
+            slot->shared = std::make_unique<LinearArena>(desc.blockSize);
+            m_Slots.push_back(std::move(slot));
+        }
+        return true;
+    }
+
+    void FrameAllocator::Shutdown() noexcept
+    {
+        m_Slots.clear();
+        std::scoped_lock lock(m_ThreadMutex);
+        m_ThreadIds.clear();
+        // 覚えている番号を無効にする(次の Init で振り直す)
+        m_Id = g_NextAllocatorId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t FrameAllocator::ThreadIndex() noexcept
+    {
+        ThreadSlotCache& cache = Cache();
+        if (cache.allocatorId == m_Id)
+        {
+            return cache.index;
+        }
+
+        // 初めて使うスレッドか、別の確保器と交互に使っている(番号は確保器ごとに振る)
+        const std::thread::id self = std::this_thread::get_id();
+        std::scoped_lock lock(m_ThreadMutex);
+        const auto it = std::find(m_ThreadIds.begin(), m_ThreadIds.end(), self);
+        uint32_t index = static_cast<uint32_t>(it - m_ThreadIds.begin());
+        if (it == m_ThreadIds.end())
+        {
+            m_ThreadIds.push_back(self);
+        }
+        cache.allocatorId = m_Id;
+        cache.index = index;
+        return index;
+    }
+
+    void* FrameAllocator::Allocate(uint64_t frameIndex, size_t size, size_t align) noexcept
+    {
+        if (m_Slots.empty())
+        {
+            return nullptr;
+        }
+        Slot& slot = *m_Slots[frameIndex % m_Slots.size()];
+        const uint32_t index = ThreadIndex();
+        if (index < m_MaxThreads)
+        {
+            return slot.threads[index]->arena.Allocate(size, align);
+        }
+        std::scoped_lock lock(slot.sharedMutex);
+        return slot.shared->Allocate(size, align);
+    }
+
+    void FrameAllocator::Reset(uint64_t frameIndex) noexcept
+    {
+        if (m_Slots.empty())
+        {
+            return;
+        }
+        Slot& slot = *m_Slots[frameIndex % m_Slots.size()];
+        for (auto& thread : slot.threads)
+        {
+            thread->arena.Reset();
+        }
+        std::scoped_lock lock(slot.sharedMutex);
+        slot.shared->Reset();
+    }
+
+    FrameAllocatorStats FrameAllocator::Stats(uint64_t frameIndex) const
+    {
+        FrameAllocatorStats stats;
+        if (m_Slots.empty())
+        {
+            return stats;
+        }
+        const Slot& slot = *m_Slots[frameIndex % m_Slots.size()];
+        auto add = [&stats](const LinearArena& arena)
+            {
+                stats.usedBytes += arena.UsedBytes();
+                stats.reservedBytes += arena.ReservedBytes();
+                stats.peakBytes += arena.PeakBytes();
+                stats.blockAllocations += arena.BlockAllocations();
+                stats.threads += arena.ReservedBytes() > 0 ? 1 : 0;
+            };
+        for (const auto& thread : slot.threads)
+        {
+            add(thread->arena);
+        }
+        add(*slot.shared);
+        return stats;
+    }
+
+    void* FrameMemoryResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        void* p = m_Allocator->Allocate(m_FrameIndex, bytes, alignment);
+        if (!p)
+        {
+            // memory_resource の約束では失敗は例外で伝える(コンテナが nullptr を扱えないため)
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    bool FrameMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        // 同じ確保器の同じフレームなら、片方で確保したものをもう片方へ返してよい(どちらも何もしない)
+        const auto* o = dynamic_cast<const FrameMemoryResource*>(&other);
+        return o && o->m_Allocator == m_Allocator && o->m_FrameIndex % m_Allocator->SlotCount() == m_FrameIndex % m_Allocator->SlotCount();
+    }
+}
@@ -0,0 +1,40 @@
+#include "pch.h"
+#include "include/FramePipeline.h"
+
+namespace Drama::Core::Frame
+{
+    void FrameFence::Signal(uint64_t value) noexcept
+    {
+        // Cancel と同時に来ても取り消しビットを落とさないよう、残したまま値だけ差し替える
+        uint64_t current = m_Value.load(std::memory_order_relaxed);
+        while (!m_Value.compare_exchange_weak(current, (current & kCancelBit) | value,
+            std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        m_Value.notify_all();
+    }
+
+    bool FrameFence::Wait(uint64_t value) const noexcept
+    {
+        for (;;)
+        {
+            const uint64_t current = m_Value.load(std::memory_order_acquire);
+            // 値に届いていれば取り消されていても成功にする(公開済みのフレームは取りこぼさない)
+            if ((current & ~kCancelBit) >= value)
+            {
+                return true;
+            }
+            if ((current & kCancelBit) != 0)
+            {
+                return false;
+            }
+            m_Value.wait(current, std::memory_order_acquire);
+        }
+    }
+
+    void FrameFence::Cancel() noexcept
+    {
+        m_Value.fetch_or(kCancelBit, std::memory_order_acq_rel);
+        m_Value.notify_all();
+    }
+}
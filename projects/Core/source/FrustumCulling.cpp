@@ -0,0 +1,476 @@
+#include "pch.h"
+#include "include/FrustumCulling.h"
+#include "include/JobSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+// AVX2 の実装は x86-64 なら常にビルドし、使うかは CPU を見て決める(MathBatch.cpp と同じ)
+#if defined(DRAMA_SIMD_SSE)
+#define DRAMA_CULL_HAS_AVX2_KERNEL 1
+#if defined(__GNUC__) || defined(__clang__)
+#define DRAMA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define DRAMA_TARGET_AVX2
+#endif
+#endif
+
+namespace Drama::Core::Scene
+{
+    namespace
+    {
+        /// @brief 判定で使う平面の値(法線の絶対値は AABB の判定用に前もって作っておく)
+        struct PlaneTable
+        {
+            float nx[6], ny[6], nz[6], w[6];
+            float ax[6], ay[6], az[6];
+        };
+
+        PlaneTable MakePlaneTable(const Frustum& frustum) noexcept
+        {
+            PlaneTable t{};
+            for (int p = 0; p < 6; ++p)
+            {
+                const Math::Float4& plane = frustum.planes[p];
+                t.nx[p] = plane.x;
+                t.ny[p] = plane.y;
+                t.nz[p] = plane.z;
+                t.w[p] = plane.w;
+                t.ax[p] = std::fabs(plane.x);
+                t.ay[p] = std::fabs(plane.y);
+                t.az[p] = std::fabs(plane.z);
+            }
+            return t;
+        }
+
+        /// @brief 1個分の判定(Scalar 実装と、SIMD 実装の端数で使う)
+        inline bool IsVisibleAt(const PlaneTable& t, const CullingSet& set, uint32_t i) noexcept
+        {
+            const Math::ConstFloat3Stream c = set.SphereCenters();
+            const Math::ConstFloat3Stream b = set.BoxCenters();
+            const Math::ConstFloat3Stream e = set.BoxExtents();
+            const float negRadius = -set.SphereRadii()[i];
+            for (int p = 0; p < 6; ++p)
+            {
+                // 球: 中心の距離が -半径 以上 / 箱: 平面に一番近い頂点(中心 + 法線側へ広げた分)が内側
+                const float s = t.nx[p] * c.x[i] + t.ny[p] * c.y[i] + t.nz[p] * c.z[i] + t.w[p];
+                const float d = t.nx[p] * b.x[i] + t.ny[p] * b.y[i] + t.nz[p] * b.z[i] + t.w[p];
+                const float r = t.ax[p] * e.x[i] + t.ay[p] * e.y[i] + t.az[p] * e.z[i];
+                if (!(s >= negRadius) || !(d + r >= 0.0f))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        namespace Scalar
+        {
+            uint32_t Cull(const Frustum& frustum, const CullingSet& set, uint32_t begin, uint32_t end, uint32_t* out) noexcept
+            {
+                const PlaneTable t = MakePlaneTable(frustum);
+                uint32_t n = 0;
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    // 分岐せずに書き、見えたときだけ進める
+                    out[n] = i;
+                    n += IsVisibleAt(t, set, i) ? 1 : 0;
+                }
+                return n;
+            }
+        }
+
+#if defined(DRAMA_SIMD_SSE)
+        namespace Sse2
+        {
+            uint32_t Cull(const Frustum& frustum, const CullingSet& set, uint32_t begin, uint32_t end, uint32_t* out) noexcept
+            {
+                const PlaneTable t = MakePlaneTable(frustum);
+                const Math::ConstFloat3Stream c = set.SphereCenters();
+                const Math::ConstFloat3Stream b = set.BoxCenters();
+                const Math::ConstFloat3Stream e = set.BoxExtents();
+                const float* radii = set.SphereRadii();
+                const __m128 signBit = _mm_set1_ps(-0.0f);
+                const __m128 zero = _mm_setzero_ps();
+                uint32_t n = 0;
+                uint32_t i = begin;
+                for (; i + 4 <= end; i += 4)
+                {
+                    const __m128 cx = _mm_loadu_ps(c.x + i), cy = _mm_loadu_ps(c.y + i), cz = _mm_loadu_ps(c.z + i);
+                    const __m128 bx = _mm_loadu_ps(b.x + i), by = _mm_loadu_ps(b.y + i), bz = _mm_loadu_ps(b.z + i);
+                    const __m128 ex = _mm_loadu_ps(e.x + i), ey = _mm_loadu_ps(e.y + i), ez = _mm_loadu_ps(e.z + i);
+                    const __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(radii + i), signBit);
+                    __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                    for (int p = 0; p < 6; ++p)
+                    {
+                        const __m128 nx = _mm_set1_ps(t.nx[p]), ny = _mm_set1_ps(t.ny[p]), nz = _mm_set1_ps(t.nz[p]), w = _mm_set1_ps(t.w[p]);
+                        const __m128 s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), w));
+                        const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, bx), _mm_mul_ps(ny, by)), _mm_add_ps(_mm_mul_ps(nz, bz), w));
+                        const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.ax[p]), ex), _mm_mul_ps(_mm_set1_ps(t.ay[p]), ey)),
+                            _mm_mul_ps(_mm_set1_ps(t.az[p]), ez));
+                        visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmpge_ps(s, negRadius), _mm_cmpge_ps(_mm_add_ps(d, r), zero)));
+                    }
+                    const int mask = _mm_movemask_ps(visible);
+                    for (uint32_t k = 0; k < 4; ++k)
+                    {
+                        out[n] = i + k;
+                        n += (mask >> k) & 1;
+                    }
+                }
+                for (; i < end; ++i)
+                {
+                    out[n] = i;
+                    n += IsVisibleAt(t, set, i) ? 1 : 0;
+                }
+                return n;
+            }
+        }
+#endif
+
+#if defined(DRAMA_CULL_HAS_AVX2_KERNEL)
+        /// @brief 8 bit の可視マスクから、見えたレーンの番号を前に詰めた並び(1 バイトずつ8個)
+        struct CompactTable
+        {
+            uint64_t lanes[256];
+        };
+
+        constexpr CompactTable MakeCompactTable() noexcept
+        {
+            CompactTable table{};
+            for (uint32_t mask = 0; mask < 256; ++mask)
+            {
+                uint64_t packed = 0;
+                uint32_t n = 0;
+                for (uint32_t k = 0; k < 8; ++k)
+                {
+                    if ((mask >> k) & 1)
+                    {
+                        packed |= static_cast<uint64_t>(k) << (8 * n++);
+                    }
+                }
+                table.lanes[mask] = packed;
+            }
+            return table;
+        }
+
+        constexpr CompactTable kCompactTable = MakeCompactTable();
+
+        namespace Avx2
+        {
+            DRAMA_TARGET_AVX2 uint32_t Cull(const Frustum& frustum, const CullingSet& set, uint32_t begin, uint32_t end, uint32_t* out) noexcept
+            {
+                const PlaneTable t = MakePlaneTable(frustum);
+                const Math::ConstFloat3Stream c = set.SphereCenters();
+                const Math::ConstFloat3Stream b = set.BoxCenters();
+                const Math::ConstFloat3Stream e = set.BoxExtents();
+                const float* radii = set.SphereRadii();
+                const __m256 signBit = _mm256_set1_ps(-0.0f);
+                const __m256 zero = _mm256_setzero_ps();
+                uint32_t n = 0;
+                uint32_t i = begin;
+                for (; i + 8 <= end; i += 8)
+                {
+                    const __m256 cx = _mm256_loadu_ps(c.x + i), cy = _mm256_loadu_ps(c.y + i), cz = _mm256_loadu_ps(c.z + i);
+                    const __m256 bx = _mm256_loadu_ps(b.x + i), by = _mm256_loadu_ps(b.y + i), bz = _mm256_loadu_ps(b.z + i);
+                    const __m256 ex = _mm256_loadu_ps(e.x + i), ey = _mm256_loadu_ps(e.y + i), ez = _mm256_loadu_ps(e.z + i);
+                    const __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(radii + i), signBit);
+                    __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                    for (int p = 0; p < 6; ++p)
+                    {
+                        const __m256 nx = _mm256_set1_ps(t.nx[p]), ny = _mm256_set1_ps(t.ny[p]), nz = _mm256_set1_ps(t.nz[p]), w = _mm256_set1_ps(t.w[p]);
+                        const __m256 s = _mm256_fmadd_ps(nx, cx, _mm256_fmadd_ps(ny, cy, _mm256_fmadd_ps(nz, cz, w)));
+                        const __m256 d = _mm256_fmadd_ps(nx, bx, _mm256_fmadd_ps(ny, by, _mm256_fmadd_ps(nz, bz, w)));
+                        const __m256 r = _mm256_fmadd_ps(_mm256_set1_ps(t.ax[p]), ex,
+                            _mm256_fmadd_ps(_mm256_set1_ps(t.ay[p]), ey, _mm256_mul_ps(_mm256_set1_ps(t.az[p]), ez)));
+                        visible = _mm256_and_ps(visible, _mm256_and_ps(_mm256_cmp_ps(s, negRadius, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(d, r), zero, _CMP_GE_OQ)));
+                    }
+                    // 見えた番号を表で前に詰め、8個まとめて書く(後ろの余りは次の書き込みで上書きされる)
+                    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(visible));
+                    const __m128i lanes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kCompactTable.lanes[mask]));
+                    const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), _mm256_cvtepu8_epi32(lanes));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + n), indices);
+                    n += static_cast<uint32_t>(std::popcount(mask));
+                }
+                for (; i < end; ++i)
+                {
+                    out[n] = i;
+                    n += IsVisibleAt(t, set, i) ? 1 : 0;
+                }
+                return n;
+            }
+        }
+#endif
+
+#if defined(DRAMA_SIMD_NEON)
+        namespace Neon
+        {
+            uint32_t Cull(const Frustum& frustum, const CullingSet& set, uint32_t begin, uint32_t end, uint32_t* out) noexcept
+            {
+                const PlaneTable t = MakePlaneTable(frustum);
+                const Math::ConstFloat3Stream c = set.SphereCenters();
+                const Math::ConstFloat3Stream b = set.BoxCenters();
+                const Math::ConstFloat3Stream e = set.BoxExtents();
+                const float* radii = set.SphereRadii();
+                const float32x4_t zero = vdupq_n_f32(0.0f);
+                uint32_t n = 0;
+                uint32_t i = begin;
+                for (; i + 4 <= end; i += 4)
+                {
+                    const float32x4_t cx = vld1q_f32(c.x + i), cy = vld1q_f32(c.y + i), cz = vld1q_f32(c.z + i);
+                    const float32x4_t bx = vld1q_f32(b.x + i), by = vld1q_f32(b.y + i), bz = vld1q_f32(b.z + i);
+                    const float32x4_t ex = vld1q_f32(e.x + i), ey = vld1q_f32(e.y + i), ez = vld1q_f32(e.z + i);
+                    const float32x4_t negRadius = vnegq_f32(vld1q_f32(radii + i));
+                    uint32x4_t visible = vdupq_n_u32(~0u);
+                    for (int p = 0; p < 6; ++p)
+                    {
+                        const float32x4_t w = vdupq_n_f32(t.w[p]);
+                        const float32x4_t s = vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(w, cz, t.nz[p]), cy, t.ny[p]), cx, t.nx[p]);
+                        const float32x4_t d = vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(w, bz, t.nz[p]), by, t.ny[p]), bx, t.nx[p]);
+                        const float32x4_t r = vfmaq_n_f32(vfmaq_n_f32(vmulq_n_f32(ez, t.az[p]), ey, t.ay[p]), ex, t.ax[p]);
+                        visible = vandq_u32(visible, vandq_u32(vcgeq_f32(s, negRadius), vcgeq_f32(vaddq_f32(d, r), zero)));
+                    }
+                    const uint32_t lane[4] = { vgetq_lane_u32(visible, 0), vgetq_lane_u32(visible, 1), vgetq_lane_u32(visible, 2), vgetq_lane_u32(visible, 3) };
+                    for (uint32_t k = 0; k < 4; ++k)
+                    {
+                        out[n] = i + k;
+                        n += lane[k] & 1;
+                    }
+                }
+                for (; i < end; ++i)
+                {
+                    out[n] = i;
+                    n += IsVisibleAt(t, set, i) ? 1 : 0;
+                }
+                return n;
+            }
+        }
+#endif
+
+        /// @brief 行ベクトルの行列の j 列目(クリップ座標の各成分は位置と列の内積)
+        Math::Float4 Column(const Math::Float4x4& m, int j) noexcept
+        {
+            const float* p = &m.r[0].x;
+            return Math::Float4{ p[j], p[4 + j], p[8 + j], p[12 + j] };
+        }
+
+        Math::Float4 NormalizePlane(Math::Float4 plane) noexcept
+        {
+            const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            return length > 0.0f ? plane * (1.0f / length) : plane;
+        }
+    }
+
+    Frustum FrustumFromMatrix(const Math::Float4x4& viewProjection) noexcept
+    {
+        // -w <= x <= w, -w <= y <= w, 0 <= z <= w を平面の式に直す
+        const Math::Float4 x = Column(viewProjection, 0);
+        const Math::Float4 y = Column(viewProjection, 1);
+        const Math::Float4 z = Column(viewProjection, 2);
+        const Math::Float4 w = Column(viewProjection, 3);
+        Frustum frustum{};
+        frustum.planes[0] = NormalizePlane(w + x); // 左
+        frustum.planes[1] = NormalizePlane(w - x); // 右
+        frustum.planes[2] = NormalizePlane(w + y); // 下
+        frustum.planes[3] = NormalizePlane(w - y); // 上
+        frustum.planes[4] = NormalizePlane(z);     // 近
+        frustum.planes[5] = NormalizePlane(w - z); // 遠
+        return frustum;
+    }
+
+    // ---- CullingSet ----
+
+    uint32_t CullingSet::Add(const BoundingSphere& sphere, const Aabb& box)
+    {
+        const uint32_t index = m_Count++;
+        if (index == PaddedSize())
+        {
+            // 詰め物は半径を負の最大値にして、どの平面でも外になるようにする
+            const uint32_t padded = index + kPadding;
+            m_SphereX.resize(padded, 0.0f);
+            m_SphereY.resize(padded, 0.0f);
+            m_SphereZ.resize(padded, 0.0f);
+            m_Radius.resize(padded, -FLT_MAX);
+            m_BoxX.resize(padded, 0.0f);
+            m_BoxY.resize(padded, 0.0f);
+            m_BoxZ.resize(padded, 0.0f);
+            m_ExtentX.resize(padded, 0.0f);
+            m_ExtentY.resize(padded, 0.0f);
+            m_ExtentZ.resize(padded, 0.0f);
+        }
+        Write(index, sphere, box);
+        return index;
+    }
+
+    uint32_t CullingSet::Add(const Aabb& box)
+    {
+        return Add(BoundingSphere{ (box.min + box.max) * 0.5f, Math::Length(box.max - box.min) * 0.5f }, box);
+    }
+
+    bool CullingSet::Set(uint32_t index, const BoundingSphere& sphere, const Aabb& box) noexcept
+    {
+        if (index >= m_Count)
+        {
+            return false;
+        }
+        Write(index, sphere, box);
+        return true;
+    }
+
+    void CullingSet::Write(uint32_t index, const BoundingSphere& sphere, const Aabb& box) noexcept
+    {
+        m_SphereX[index] = sphere.center.x;
+        m_SphereY[index] = sphere.center.y;
+        m_SphereZ[index] = sphere.center.z;
+        m_Radius[index] = sphere.radius;
+        const Math::Float3 center = (box.min + box.max) * 0.5f;
+        const Math::Float3 extent = (box.max - box.min) * 0.5f;
+        m_BoxX[index] = center.x;
+        m_BoxY[index] = center.y;
+        m_BoxZ[index] = center.z;
+        m_ExtentX[index] = extent.x;
+        m_ExtentY[index] = extent.y;
+        m_ExtentZ[index] = extent.z;
+    }
+
+    void CullingSet::Clear() noexcept
+    {
+        m_SphereX.clear();
+        m_SphereY.clear();
+        m_SphereZ.clear();
+        m_Radius.clear();
+        m_BoxX.clear();
+        m_BoxY.clear();
+        m_BoxZ.clear();
+        m_ExtentX.clear();
+        m_ExtentY.clear();
+        m_ExtentZ.clear();
+        m_Count = 0;
+    }
+
+    void CullingSet::Reserve(uint32_t count)
+    {
+        const size_t padded = (static_cast<size_t>(count) + kPadding - 1) / kPadding * kPadding;
+        for (std::vector<float>* v : { &m_SphereX, &m_SphereY, &m_SphereZ, &m_Radius, &m_BoxX, &m_BoxY, &m_BoxZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+        {
+            v->reserve(padded);
+        }
+    }
+
+    // ---- 実装の選択 ----
+
+    CullFunction CullFunctionFor(Math::SimdLevel level) noexcept
+    {
+        switch (level)
+        {
+        case Math::SimdLevel::Scalar:
+            return &Scalar::Cull;
+#if defined(DRAMA_SIMD_SSE)
+        case Math::SimdLevel::Sse2:
+            return &Sse2::Cull;
+#endif
+#if defined(DRAMA_CULL_HAS_AVX2_KERNEL)
+        case Math::SimdLevel::Avx2:
+            // CPU の判定は MathBatch と共有する
+            return Math::IsSimdLevelSupported(Math::SimdLevel::Avx2) ? &Avx2::Cull : nullptr;
+#endif
+#if defined(DRAMA_SIMD_NEON)
+        case Math::SimdLevel::Neon:
+            return &Neon::Cull;
+#endif
+        default:
+            return nullptr;
+        }
+    }
+
+    Math::SimdLevel BestCullLevel() noexcept
+    {
+        // 関数ポインタで呼ぶのはチャンクごとに1回なので、ビルド設定より上の実装も CPU を見て使う
+        return CullFunctionFor(Math::SimdLevel::Avx2) ? Math::SimdLevel::Avx2 : Math::CompiledSimdLevel();
+    }
+
+    // ---- VisibilityCuller ----
+
+    bool VisibilityCuller::Init(uint32_t frameSlots, Math::SimdLevel level)
+    {
+        const CullFunction cull = CullFunctionFor(level);
+        if (frameSlots == 0 || !cull)
+        {
+            return false;
+        }
+        m_Slots.assign(frameSlots, Slot{});
+        m_Cull = cull;
+        m_Level = level;
+        return true;
+    }
+
+    std::span<const uint32_t> VisibilityCuller::Cull(uint64_t frameIndex, const Frustum& frustum, const CullingSet& set, Job::JobSystem* jobs)
+    {
+        if (m_Slots.empty())
+        {
+            return {};
+        }
+        Slot& slot = m_Slots[frameIndex % m_Slots.size()];
+        // 詰め物まで判定する(決して見えないので端数の処理が要らない)
+        const uint32_t count = set.PaddedSize();
+        if (slot.indices.size() < count)
+        {
+            slot.indices.resize(count);
+        }
+        const uint32_t chunks = (count + kChunkSize - 1) / kChunkSize;
+        if (m_ChunkCounts.size() < chunks)
+        {
+            m_ChunkCounts.resize(chunks);
+        }
+
+        // チャンク c は一覧の [c * kChunkSize, ...) に書く(書く場所が重ならないので並列にできる)
+        uint32_t* indices = slot.indices.data();
+        const CullFunction cull = m_Cull;
+        auto run = [&](size_t chunk)
+            {
+                const uint32_t begin = static_cast<uint32_t>(chunk) * kChunkSize;
+                const uint32_t end = std::min(count, begin + kChunkSize);
+                m_ChunkCounts[chunk] = cull(frustum, set, begin, end, indices + begin);
+            };
+        if (jobs && chunks > 1)
+        {
+            jobs->ParallelFor(chunks, [&](size_t begin, size_t end)
+                {
+                    for (size_t chunk = begin; chunk < end; ++chunk)
+                    {
+                        run(chunk);
+                    }
+                }, 1);
+        }
+        else
+        {
+            for (uint32_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                run(chunk);
+            }
+        }
+
+        // チャンクの結果を前に詰める(書き込み先はいつも読み込み元より前なので、順に動かせば壊れない)
+        uint32_t visible = chunks > 0 ? m_ChunkCounts[0] : 0;
+        for (uint32_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            std::memmove(indices + visible, indices + static_cast<size_t>(chunk) * kChunkSize, sizeof(uint32_t) * m_ChunkCounts[chunk]);
+            visible += m_ChunkCounts[chunk];
+        }
+        slot.count = visible;
+        return { indices, visible };
+    }
+
+    std::span<const uint32_t> VisibilityCuller::Visible(uint64_t frameIndex) const noexcept
+    {
+        if (m_Slots.empty())
+        {
+            return {};
+        }
+        const Slot& slot = m_Slots[frameIndex % m_Slots.size()];
+        return { slot.indices.data(), slot.count };
+    }
+}
@@ -0,0 +1,687 @@
+#include "pch.h"
+#include "include/JobSystem.h"
+#include "include/ThreadLocalAccess.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    using Drama::Core::Job::Fiber;
+    using Drama::Core::Job::JobCounter;
+    using Drama::Core::Job::JobSystem;
+
+    /// @brief 呼び出しスレッドがどのシステムの何番のワーカーか
+    struct ThreadState
+    {
+        const JobSystem* system = nullptr;
+        uint32_t worker = UINT32_MAX;
+        Fiber* fiber = nullptr;            ///< 実行中のファイバー(ファイバーを使わない場合は nullptr)
+        uint8_t arrival = 0;               ///< 切り替え先で行う後始末(JobSystem::Arrival)
+        Fiber* arrivalFiber = nullptr;
+        JobCounter* arrivalCounter = nullptr;
+    };
+    thread_local ThreadState t_State;
+
+    // ファイバーは切り替えの前後で別のスレッドに移ることがあるので、スレッドローカル変数のアドレスを
+    // 関数の中でキャッシュされないよう、必ずこの関数を通して毎回引き直す(MSVC は /GT も併用)
+    DRAMA_NOINLINE ThreadState& State() noexcept
+    {
+        DRAMA_OPAQUE_BARRIER();
+        return t_State;
+    }
+
+    constexpr uint32_t kPoolProbeCount = 8; ///< 置き場の空きを探す数(見つからなければ共有のスラブ)
+    constexpr uint32_t kOverflowJobsPerSlab = 256;
+
+    uint64_t NextRandom(uint64_t& state) noexcept
+    {
+        // xorshift64: 盗む相手を散らすだけなので質は問わない
+        uint64_t x = state;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        state = x;
+        return x;
+    }
+}
+
+namespace Drama::Core::Job
+{
+    JobSystem::~JobSystem()
+    {
+        Stop();
+    }
+
+    bool JobSystem::Start(const JobSystemDesc& desc)
+    {
+        if (m_IsRunning.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        m_Desc = desc;
+        uint32_t threads = desc.threadCount;
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_Workers.clear();
+        for (uint32_t i = 0; i < threads; ++i)
+        {
+            auto w = std::make_unique<Worker>();
+            w->deque.Init(kJobDequeCapacity);
+            w->pool = std::make_unique<Job[]>(kJobPoolSize);
+            w->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+            m_Workers.push_back(std::move(w));
+        }
+
+        Memory::SlabDesc overflowDesc;
+        overflowDesc.blockSize = sizeof(Job);
+        overflowDesc.blockAlign = alignof(Job);
+        overflowDesc.blocksPerSlab = kOverflowJobsPerSlab;
+        overflowDesc.maxBlocks = Memory::SlabHandle::kMaxBlocks;
+        overflowDesc.tag = Memory::MemoryTag::Job;
+        if (!m_OverflowJobs.Init(overflowDesc))
+        {
+            m_Workers.clear();
+            return false;
+        }
+
+        // 各ワーカーがスケジューラを回すのに1つずつ使うので、退避用にその倍は用意する
+        m_UseFibers = desc.fiberCount > 0;
+        if (m_UseFibers)
+        {
+            const uint32_t fibers = std::max(desc.fiberCount, threads * 2);
+            if (!m_FiberPool.Init(fibers, desc.fiberStackSize, &JobSystem::FiberEntry, this) ||
+                !m_Workers[0]->threadFiber.InitFromThread())
+            {
+                m_FiberPool.Shutdown();
+                m_OverflowJobs.Shutdown();
+                m_Workers.clear();
+                m_UseFibers = false;
+                return false;
+            }
+        }
+
+        m_IsRunning.store(true, std::memory_order_release);
+        ThreadState& s = State();
+        s.system = this;
+        s.worker = 0;
+        s.fiber = m_UseFibers ? &m_Workers[0]->threadFiber : nullptr;
+        for (uint32_t i = 1; i < threads; ++i)
+        {
+            m_Workers[i]->thread = std::thread([this, i]() { WorkerMain(i); });
+        }
+        return true;
+    }
+
+    void JobSystem::Stop() noexcept
+    {
+        if (!m_IsRunning.exchange(false, std::memory_order_acq_rel))
+        {
+            return;
+        }
+        WakeAll();
+        for (size_t i = 1; i < m_Workers.size(); ++i)
+        {
+            if (m_Workers[i]->thread.joinable())
+            {
+                m_Workers[i]->thread.join();
+            }
+        }
+
+        // 取り残されたジョブ(止める前に Wait しなかった分)は、ここで片付ける。
+        // ファイバーを使う場合は、退避中のファイバーを再開できるようにスケジューラを1周回す
+        // (仕事が尽きればこのスレッドのファイバーへ戻ってくる)
+        ThreadState& s = State();
+        const bool isOwner = (s.system == this);
+        if (m_UseFibers && isOwner && s.fiber != nullptr)
+        {
+            if (Fiber* f = m_FiberPool.Acquire())
+            {
+                SwitchTo(f, Arrival::None, nullptr, nullptr);
+            }
+        }
+
+        // 残りはこのスレッドで直接実行する。他のワーカーのキューは持ち主がもういないので、盗む側として取り出す
+        ThreadState& st = State();
+        st.fiber = nullptr;
+        const uint32_t self = isOwner ? 0 : UINT32_MAX;
+        while (true)
+        {
+            Job* job = FindJob(self);
+            if (job == nullptr)
+            {
+                std::lock_guard lock(m_DeferMutex);
+                // 依存先が 0 にならないまま止められたジョブは実行せずに捨てる。
+                // 退避したまま再開できなかったファイバーはスタックごと解放される
+                for (Deferred& d : m_Deferred)
+                {
+                    if (d.job != nullptr)
+                    {
+                        d.job->destroy(d.job->storage);
+                        FreeJob(d.job);
+                    }
+                }
+                m_Deferred.clear();
+                m_DeferredCount.store(0, std::memory_order_relaxed);
+                break;
+            }
+            Execute(job);
+        }
+
+        if (m_UseFibers)
+        {
+            {
+                std::lock_guard lock(m_ReadyMutex);
+                m_ReadyFibers.clear();
+                m_ReadyCount.store(0, std::memory_order_relaxed);
+            }
+            m_ResumeMain.store(nullptr, std::memory_order_relaxed);
+            m_FiberPool.Shutdown();
+            if (isOwner)
+            {
+                m_Workers[0]->threadFiber.ReleaseFromThread();
+            }
+            m_UseFibers = false;
+        }
+        // 残りのジョブは上で全て返したので、溢れた分の置き場も手放す(以降の Run はその場で実行される)
+        m_OverflowJobs.Shutdown();
+        if (isOwner)
+        {
+            st.system = nullptr;
+            st.worker = UINT32_MAX;
+        }
+    }
+
+    void JobSystem::Wait(JobCounter& counter) noexcept
+    {
+        if (counter.IsDone())
+        {
+            return;
+        }
+
+        // ファイバーの上なら退避して、このワーカーには別のファイバーでスケジューラを回させる。
+        // 戻ってきたときには counter は 0 になっている(別のスレッドのことがある)
+        ThreadState& s = State();
+        if (m_UseFibers && s.system == this && s.fiber != nullptr)
+        {
+            if (Fiber* next = m_FiberPool.Acquire())
+            {
+                m_Parks.fetch_add(1, std::memory_order_relaxed);
+                SwitchTo(next, Arrival::Park, s.fiber, &counter);
+                return;
+            }
+            // 置き場が尽きたら、下の方法で待つ
+        }
+
+        uint32_t idle = 0;
+        while (!counter.IsDone())
+        {
+            if (Job* job = FindJob(CurrentWorker()))
+            {
+                Execute(job);
+                idle = 0;
+                continue;
+            }
+            // 残りは他のスレッドが実行中。眠ると起こす仕組みが要るので、譲るだけにする
+            if (++idle > m_Desc.spinCount)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    size_t JobSystem::AutoGrain(size_t count) const noexcept
+    {
+        const size_t pieces = static_cast<size_t>(std::max<uint32_t>(1, ThreadCount())) * 8;
+        return std::max<size_t>(1, count / pieces);
+    }
+
+    JobSystemStats JobSystem::Stats() const noexcept
+    {
+        JobSystemStats s;
+        for (const auto& w : m_Workers)
+        {
+            s.executed += w->executed.load(std::memory_order_relaxed);
+            s.stolen += w->stolen.load(std::memory_order_relaxed);
+        }
+        s.heapJobs = m_HeapJobs.load(std::memory_order_relaxed);
+        s.inlineJobs = m_InlineJobs.load(std::memory_order_relaxed);
+        s.parks = m_Parks.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    uint32_t JobSystem::CurrentWorker() const noexcept
+    {
+        const ThreadState& s = State();
+        return (s.system == this) ? s.worker : UINT32_MAX;
+    }
+
+    Job* JobSystem::AllocateJob() noexcept
+    {
+        const uint32_t self = CurrentWorker();
+        if (self != UINT32_MAX)
+        {
+            // 置き場はリング状に使う。ほとんどのジョブは一周して戻る頃には終わっているが、
+            // 入れ子の Wait を抱えたジョブは長く残るので、埋まっていたら少し先まで探す
+            Worker& w = *m_Workers[self];
+            for (uint32_t probe = 0; probe < kPoolProbeCount; ++probe)
+            {
+                Job& slot = w.pool[w.poolNext++ & (kJobPoolSize - 1)];
+                if (!slot.inUse.load(std::memory_order_acquire))
+                {
+                    slot.inUse.store(true, std::memory_order_relaxed);
+                    return &slot;
+                }
+            }
+        }
+        void* block = nullptr;
+        const Memory::SlabHandle handle = m_OverflowJobs.Allocate(&block);
+        if (!handle.IsValid())
+        {
+            return nullptr;
+        }
+        m_HeapJobs.fetch_add(1, std::memory_order_relaxed);
+        Job* job = ::new (block) Job();
+        job->overflow = handle;
+        return job;
+    }
+
+    void JobSystem::FreeJob(Job* job) noexcept
+    {
+        if (job->overflow.IsValid())
+        {
+            m_OverflowJobs.Free(job->overflow, [](void* p) { static_cast<Job*>(p)->~Job(); });
+            return;
+        }
+        // 別のスレッドで実行された場合も、次に確保する持ち主から見えるように release
+        job->inUse.store(false, std::memory_order_release);
+    }
+
+    void JobSystem::Submit(Job* job) noexcept
+    {
+        const uint32_t self = CurrentWorker();
+        if (self != UINT32_MAX)
+        {
+            if (!m_Workers[self]->deque.Push(job))
+            {
+                // あふれたら積まずにその場で実行する(再帰的に分割している場合は深さ優先になるので量が減っていく)
+                m_InlineJobs.fetch_add(1, std::memory_order_relaxed);
+                Execute(job);
+                return;
+            }
+        }
+        else
+        {
+            std::lock_guard lock(m_InjectMutex);
+            m_Injected.push_back(job);
+            m_InjectedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        WakeOne();
+    }
+
+    void JobSystem::Defer(JobCounter& dependency, Job* job) noexcept
+    {
+        {
+            std::lock_guard lock(m_DeferMutex);
+            // 先に件数を増やしてから依存先を見る。Finish は逆の順で見るので、どちらかが必ず相手に気付く
+            m_DeferredCount.fetch_add(1, std::memory_order_seq_cst);
+            if (dependency.m_Value.load(std::memory_order_seq_cst) != 0)
+            {
+                m_Deferred.push_back(Deferred{ &dependency, job, nullptr });
+                return;
+            }
+            m_DeferredCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        Submit(job);
+    }
+
+    void JobSystem::Execute(Job* job) noexcept
+    {
+        job->invoke(job->storage);
+        job->destroy(job->storage);
+        JobCounter* counter = job->counter;
+        FreeJob(job);
+        // ジョブの中で Wait して別のスレッドに移っていることがあるので、ワーカー番号は実行後に引き直す
+        const uint32_t self = CurrentWorker();
+        if (self != UINT32_MAX)
+        {
+            m_Workers[self]->executed.fetch_add(1, std::memory_order_relaxed);
+        }
+        Finish(*counter);
+    }
+
+    void JobSystem::Finish(JobCounter& counter) noexcept
+    {
+        // 0 にした後は counter に触らない(Wait していた側がすぐ破棄することがある)
+        if (counter.m_Value.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+            m_DeferredCount.load(std::memory_order_seq_cst) > 0)
+        {
+            ReleaseDeferred();
+        }
+    }
+
+    void JobSystem::ReleaseDeferred() noexcept
+    {
+        // 待ちは1フレームに数件程度の想定なので、線形に見て依存先が 0 のものをまとめて出す
+        Deferred ready[32];
+        size_t readyCount = 0;
+        bool more = true;
+        while (more)
+        {
+            more = false;
+            readyCount = 0;
+            {
+                std::lock_guard lock(m_DeferMutex);
+                for (size_t i = 0; i < m_Deferred.size();)
+                {
+                    if (m_Deferred[i].dependency->m_Value.load(std::memory_order_acquire) != 0)
+                    {
+                        ++i;
+                        continue;
+                    }
+                    if (readyCount == std::size(ready))
+                    {
+                        more = true;
+                        break;
+                    }
+                    ready[readyCount++] = m_Deferred[i];
+                    m_Deferred[i] = m_Deferred.back();
+                    m_Deferred.pop_back();
+                }
+                m_DeferredCount.fetch_sub(readyCount, std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < readyCount; ++i)
+            {
+                if (ready[i].job != nullptr)
+                {
+                    Submit(ready[i].job);
+                }
+                else
+                {
+                    MakeReady(ready[i].fiber);
+                }
+            }
+        }
+    }
+
+    Job* JobSystem::FindJob(uint32_t self) noexcept
+    {
+        Job* job = nullptr;
+        if (self != UINT32_MAX && m_Workers[self]->deque.Pop(job))
+        {
+            return job;
+        }
+        if (m_InjectedCount.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard lock(m_InjectMutex);
+            if (!m_Injected.empty())
+            {
+                job = m_Injected.front();
+                m_Injected.pop_front();
+                m_InjectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        // 乱数で選んだ相手から順に1周盗みに行く
+        const size_t n = m_Workers.size();
+        uint64_t seed = (self != UINT32_MAX) ? NextRandom(m_Workers[self]->rng) : reinterpret_cast<uintptr_t>(&job);
+        const size_t start = static_cast<size_t>(seed % n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t victim = (start + k) % n;
+            if (victim == self)
+            {
+                continue;
+            }
+            // 取り合いに負けただけなら残っているかもしれないので、空になるまで試す
+            while (m_Workers[victim]->deque.ApproxSize() > 0)
+            {
+                if (m_Workers[victim]->deque.Steal(job))
+                {
+                    if (self != UINT32_MAX)
+                    {
+                        m_Workers[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    return job;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    bool JobSystem::HasWork(uint32_t self) const noexcept
+    {
+        if (m_InjectedCount.load(std::memory_order_seq_cst) > 0 ||
+            m_ReadyCount.load(std::memory_order_seq_cst) > 0 ||
+            (self == 0 && m_ResumeMain.load(std::memory_order_seq_cst) != nullptr))
+        {
+            return true;
+        }
+        for (const auto& w : m_Workers)
+        {
+            if (w->deque.ApproxSize() > 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::WakeOne() noexcept
+    {
+        // 積んだことと m_Sleeping の読み出しの順序を保証する(Idle の眠る手順と対になる)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_Sleeping.load(std::memory_order_relaxed) > 0)
+        {
+            m_Epoch.fetch_add(1, std::memory_order_release);
+            m_Epoch.notify_one();
+        }
+    }
+
+    void JobSystem::WakeAll() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_Epoch.fetch_add(1, std::memory_order_release);
+        m_Epoch.notify_all();
+    }
+
+    void JobSystem::Idle(uint32_t& idle) noexcept
+    {
+        if (++idle <= m_Desc.spinCount)
+        {
+            std::this_thread::yield();
+            return;
+        }
+
+        // 眠る: 起こす側の目印を上げてから、もう一度だけ仕事を探す
+        const uint32_t epoch = m_Epoch.load(std::memory_order_acquire);
+        m_Sleeping.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!HasWork(CurrentWorker()) && m_IsRunning.load(std::memory_order_acquire))
+        {
+            m_Epoch.wait(epoch, std::memory_order_acquire);
+        }
+        m_Sleeping.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+
+    void JobSystem::WorkerMain(uint32_t index)
+    {
+        ThreadState& s = State();
+        s.system = this;
+        s.worker = index;
+        Worker& w = *m_Workers[index];
+        if (m_UseFibers && w.threadFiber.InitFromThread())
+        {
+            // スケジューラはファイバーの上で回す。止めるときにこのスレッドのファイバーへ戻ってくる
+            if (Fiber* f = m_FiberPool.Acquire())
+            {
+                s.fiber = &w.threadFiber;
+                SwitchTo(f, Arrival::None, nullptr, nullptr);
+            }
+            else
+            {
+                RunLoop(index);
+            }
+            ThreadState& st = State();
+            st.fiber = nullptr;
+            w.threadFiber.ReleaseFromThread();
+        }
+        else
+        {
+            RunLoop(index);
+        }
+        ThreadState& st = State();
+        st.system = nullptr;
+        st.worker = UINT32_MAX;
+    }
+
+    void JobSystem::RunLoop(uint32_t index)
+    {
+        uint32_t idle = 0;
+        while (m_IsRunning.load(std::memory_order_acquire))
+        {
+            if (Job* job = FindJob(index))
+            {
+                Execute(job);
+                idle = 0;
+                continue;
+            }
+            Idle(idle);
+        }
+    }
+
+    void JobSystem::FiberEntry(void* self) noexcept
+    {
+        auto* system = static_cast<JobSystem*>(self);
+        system->OnArrive();
+        system->SchedulerLoop();
+    }
+
+    void JobSystem::SchedulerLoop() noexcept
+    {
+        uint32_t idle = 0;
+        while (true)
+        {
+            // ジョブの中で退避・再開したり、置き場から別のスレッドで再利用されたりするので毎回引き直す
+            const uint32_t self = CurrentWorker();
+            if (Fiber* ready = TakeReadyFiber(self))
+            {
+                SwitchTo(ready, Arrival::Release, State().fiber, nullptr);
+                idle = 0;
+                continue;
+            }
+            if (Job* job = FindJob(self))
+            {
+                Execute(job);
+                idle = 0;
+                continue;
+            }
+            if (!m_IsRunning.load(std::memory_order_acquire))
+            {
+                // 停止中で仕事も尽きた: スレッドのファイバーへ戻る(このファイバーは置き場へ)
+                SwitchTo(&m_Workers[self]->threadFiber, Arrival::Release, State().fiber, nullptr);
+                idle = 0;
+                continue;
+            }
+            Idle(idle);
+        }
+    }
+
+    void JobSystem::SwitchTo(Fiber* to, Arrival arrival, Fiber* subject, JobCounter* counter) noexcept
+    {
+        ThreadState& s = State();
+        Fiber* from = s.fiber;
+        s.arrival = static_cast<uint8_t>(arrival);
+        s.arrivalFiber = subject;
+        s.arrivalCounter = counter;
+        s.fiber = to;
+        Fiber::Switch(*from, *to);
+        // ここに戻るのは誰かがこのファイバーへ切り替えたとき(別のスレッドのことがある)
+        OnArrive();
+    }
+
+    void JobSystem::OnArrive() noexcept
+    {
+        ThreadState& s = State();
+        const Arrival arrival = static_cast<Arrival>(s.arrival);
+        Fiber* subject = s.arrivalFiber;
+        JobCounter* counter = s.arrivalCounter;
+        s.arrival = static_cast<uint8_t>(Arrival::None);
+        s.arrivalFiber = nullptr;
+        s.arrivalCounter = nullptr;
+        switch (arrival)
+        {
+        case Arrival::Release:
+            m_FiberPool.Release(subject);
+            break;
+        case Arrival::Park:
+            Park(subject, *counter);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void JobSystem::Park(Fiber* fiber, JobCounter& counter) noexcept
+    {
+        {
+            std::lock_guard lock(m_DeferMutex);
+            // Defer と同じ手順(切り替えが済んでから登録するので、登録した瞬間に再開されても問題ない)
+            m_DeferredCount.fetch_add(1, std::memory_order_seq_cst);
+            if (counter.m_Value.load(std::memory_order_seq_cst) != 0)
+            {
+                m_Deferred.push_back(Deferred{ &counter, nullptr, fiber });
+                return;
+            }
+            m_DeferredCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        MakeReady(fiber);
+    }
+
+    void JobSystem::MakeReady(Fiber* fiber) noexcept
+    {
+        if (fiber == &m_Workers[0]->threadFiber)
+        {
+            // ワーカー0 のスレッドファイバーはメインループなので、必ずワーカー0 で再開する
+            m_ResumeMain.store(fiber, std::memory_order_seq_cst);
+            WakeAll();
+            return;
+        }
+        {
+            std::lock_guard lock(m_ReadyMutex);
+            m_ReadyFibers.push_back(fiber);
+            m_ReadyCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        WakeOne();
+    }
+
+    Fiber* JobSystem::TakeReadyFiber(uint32_t self) noexcept
+    {
+        if (self == 0 && m_ResumeMain.load(std::memory_order_relaxed) != nullptr)
+        {
+            if (Fiber* main = m_ResumeMain.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                return main;
+            }
+        }
+        if (m_ReadyCount.load(std::memory_order_relaxed) == 0)
+        {
+            return nullptr;
+        }
+        std::lock_guard lock(m_ReadyMutex);
+        if (m_ReadyFibers.empty())
+        {
+            return nullptr;
+        }
+        Fiber* fiber = m_ReadyFibers.front();
+        m_ReadyFibers.pop_front();
+        m_ReadyCount.fetch_sub(1, std::memory_order_relaxed);
+        return fiber;
+    }
+}
@@ -0,0 +1,307 @@
+#include "pch.h"
+#include "include/LogSegmentStore.h"
+
+// C++ standard library includes
+#include <algorithm>
+
+namespace
+{
+    uint64_t CountLines(const char* data, size_t size) noexcept
+    {
+        return static_cast<uint64_t>(std::count(data, data + size, '\n'));
+    }
+
+    /// @brief [0, limit) の最後の改行の次の位置(無ければ0)
+    size_t EndOfLastLine(const char* data, size_t limit) noexcept
+    {
+        for (size_t i = limit; i > 0; --i)
+        {
+            if (data[i - 1] == '\n')
+            {
+                return i;
+            }
+        }
+        return 0;
+    }
+}
+
+namespace Drama::Core
+{
+    bool LogSegmentStore::Open(IO::IFileSystem& fs, std::string_view basePathUtf8, const LogRotationDesc& desc)
+    {
+        m_Fs = &fs;
+        m_Desc = desc;
+        if (m_Desc.segmentBytes == 0)
+        {
+            m_Desc.segmentBytes = 1;
+        }
+
+        // "dir/log.txt" -> stem "dir/log", ext ".txt"
+        const size_t slash = basePathUtf8.find_last_of("/\\");
+        const size_t dot = basePathUtf8.find_last_of('.');
+        if (dot != std::string_view::npos && (slash == std::string_view::npos || dot > slash))
+        {
+            m_Stem = std::string(basePathUtf8.substr(0, dot));
+            m_Extension = std::string(basePathUtf8.substr(dot));
+        }
+        else
+        {
+            m_Stem = std::string(basePathUtf8);
+            m_Extension.clear();
+        }
+
+        // 書き込み中の1つと常に空の1つを除いた封印済みだけで retainBytes を満たす数
+        const size_t sealed = (m_Desc.retainBytes + m_Desc.segmentBytes - 1) / m_Desc.segmentBytes;
+        const size_t slotCount = (sealed < 1 ? 1 : sealed) + 2;
+        m_Segments.assign(slotCount, SegmentInfo{});
+        m_Active = 0;
+
+        // 設定が変わってセグメント数が減った場合、溢れた分は辿れなくなるので消す
+        for (uint32_t slot = static_cast<uint32_t>(slotCount); m_Fs->Remove(SegmentPath(slot)); ++slot)
+        {
+        }
+
+        if (!Scan())
+        {
+            return false;
+        }
+        return MigrateLegacy(basePathUtf8);
+    }
+
+    bool LogSegmentStore::Append(const void* data, size_t size)
+    {
+        if (!m_Fs || m_Segments.empty() || (size > 0 && data == nullptr))
+        {
+            return false;
+        }
+
+        const char* src = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            SegmentInfo& active = m_Segments[m_Active];
+            const size_t room = (active.bytes < m_Desc.segmentBytes) ?
+                static_cast<size_t>(m_Desc.segmentBytes - active.bytes) : 0;
+
+            // 行の途中では分けない。収まる行が無ければ切り替える
+            size_t take = size;
+            if (size > room)
+            {
+                take = EndOfLastLine(src, room);
+                if (take == 0)
+                {
+                    if (active.bytes > 0)
+                    {
+                        if (!Roll())
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+                    // 空のセグメントにも収まらない長い行はその行だけ丸ごと書く
+                    const char* end = std::find(src, src + size, '\n');
+                    take = (end == src + size) ? size : static_cast<size_t>(end - src) + 1;
+                }
+            }
+
+            if (!m_Fs->AppendAllBytes(SegmentPath(m_Active), src, take))
+            {
+                return false;
+            }
+            active.lines += CountLines(src, take);
+            active.bytes += take;
+            src += take;
+            size -= take;
+        }
+        return true;
+    }
+
+    bool LogSegmentStore::AppendWhole(const void* data, size_t size)
+    {
+        if (!m_Fs || m_Segments.empty() || (size > 0 && data == nullptr))
+        {
+            return false;
+        }
+        if (!m_Fs->AppendAllBytes(SegmentPath(m_Active), data, size))
+        {
+            return false;
+        }
+        SegmentInfo& active = m_Segments[m_Active];
+        active.lines += CountLines(static_cast<const char*>(data), size);
+        active.bytes += size;
+        return true;
+    }
+
+    size_t LogSegmentStore::ActiveBytes() const noexcept
+    {
+        return m_Segments.empty() ? 0 : static_cast<size_t>(m_Segments[m_Active].bytes);
+    }
+
+    size_t LogSegmentStore::RetainedLines() noexcept
+    {
+        uint64_t total = 0;
+        std::vector<uint8_t> bytes;
+        for (uint32_t slot = 0; slot < static_cast<uint32_t>(m_Segments.size()); ++slot)
+        {
+            SegmentInfo& s = m_Segments[slot];
+            // 起動後に足した行は数え済みなので、先頭の起動時からあった分だけ読んで数える
+            if (s.uncountedBytes > 0 && m_Fs->ReadAllBytes(SegmentPath(slot), bytes))
+            {
+                const size_t size = static_cast<size_t>(std::min<uint64_t>(s.uncountedBytes, bytes.size()));
+                s.lines += CountLines(reinterpret_cast<const char*>(bytes.data()), size);
+                s.uncountedBytes = 0;
+            }
+            total += s.lines;
+        }
+        return static_cast<size_t>(total);
+    }
+
+    size_t LogSegmentStore::RetainedBytes() const noexcept
+    {
+        uint64_t total = 0;
+        for (const SegmentInfo& s : m_Segments)
+        {
+            total += s.bytes;
+        }
+        return static_cast<size_t>(total);
+    }
+
+    void LogSegmentStore::CollectPaths(std::vector<std::string>& out) const
+    {
+        out.clear();
+        const uint32_t count = static_cast<uint32_t>(m_Segments.size());
+        for (uint32_t i = 1; i <= count; ++i)
+        {
+            // 現在の次が最古
+            const uint32_t slot = (m_Active + i) % count;
+            if (m_Segments[slot].bytes > 0)
+            {
+                out.push_back(SegmentPath(slot));
+            }
+        }
+    }
+
+    std::string LogSegmentStore::SegmentPath(uint32_t slot) const
+    {
+        return m_Stem + "." + std::to_string(slot) + m_Extension;
+    }
+
+    bool LogSegmentStore::Roll()
+    {
+        if (m_Segments.empty())
+        {
+            return false;
+        }
+        const uint32_t count = static_cast<uint32_t>(m_Segments.size());
+        const uint32_t next = (m_Active + 1) % count;
+        const uint32_t gap = (m_Active + 2) % count;
+
+        // 次(空)へ移る前に次の次(最古)を消して、現在の直後が空という形を保つ。
+        // 間で落ちても空きが2つ続くだけで、起動時の Scan は切り替え前の位置を選ぶ。
+        if (!Clear(gap))
+        {
+            return false;
+        }
+        m_Active = next;
+        return true;
+    }
+
+    bool LogSegmentStore::Clear(uint32_t slot)
+    {
+        const IO::FsResult r = m_Fs->Remove(SegmentPath(slot));
+        if (!r && r.error != IO::FsError::NotFound)
+        {
+            // 消せない環境では切り詰めで代える
+            if (!m_Fs->WriteAllBytes(SegmentPath(slot), "", 0))
+            {
+                return false;
+            }
+        }
+        m_Segments[slot] = SegmentInfo{};
+        return true;
+    }
+
+    bool LogSegmentStore::Scan()
+    {
+        // 大きさだけを調べる(起動のたびに全セグメントを読まない)
+        const uint32_t count = static_cast<uint32_t>(m_Segments.size());
+        for (uint32_t slot = 0; slot < count; ++slot)
+        {
+            uint64_t size = 0;
+            const IO::FsResult r = m_Fs->FileSize(SegmentPath(slot), size);
+            if (!r && r.error != IO::FsError::NotFound)
+            {
+                return false;
+            }
+            m_Segments[slot] = SegmentInfo{ 0, size, size };
+        }
+
+        // 空でなく直後が空のセグメントが現在。正しく書かれていれば1つに決まる。
+        // セグメント数の変更や切り替え中の異常終了で複数あるときは、最後に書かれたものを現在とみなす
+        // (ログは消さずに続きを書く。更新時刻を調べられなければ番号の若いもの)
+        uint32_t found = 0;
+        if (FindNewest(true, found))
+        {
+            m_Active = found;
+            return true;
+        }
+        // 直後が空のものが無い(セグメント数を減らして全部埋まっている)なら、最後に書かれたものの次を空ける。
+        // 順に書かれていれば次は最古なので、通常の切り替えで消えるものと同じ
+        if (FindNewest(false, found))
+        {
+            m_Active = found;
+            return Clear((found + 1) % count);
+        }
+        m_Active = 0;
+        return true;
+    }
+
+    bool LogSegmentStore::FindNewest(bool isFollowedByEmpty, uint32_t& out)
+    {
+        const uint32_t count = static_cast<uint32_t>(m_Segments.size());
+        bool isFound = false;
+        uint64_t newest = 0;
+        for (uint32_t slot = 0; slot < count; ++slot)
+        {
+            if (m_Segments[slot].bytes == 0 || (isFollowedByEmpty && m_Segments[(slot + 1) % count].bytes != 0))
+            {
+                continue;
+            }
+            uint64_t time = 0;
+            m_Fs->LastWriteTime(SegmentPath(slot), time);
+            if (!isFound || time > newest)
+            {
+                out = slot;
+                newest = time;
+                isFound = true;
+            }
+        }
+        return isFound;
+    }
+
+    bool LogSegmentStore::MigrateLegacy(std::string_view basePathUtf8)
+    {
+        // 以前の索引は使わないので消す
+        m_Fs->Remove(m_Stem + ".index");
+
+        std::vector<uint8_t> legacy;
+        if (!m_Fs->ReadAllBytes(basePathUtf8, legacy) || legacy.empty())
+        {
+            return true;
+        }
+        if (legacy.back() != '\n')
+        {
+            legacy.push_back('\n');
+        }
+        if (!Append(legacy.data(), legacy.size()))
+        {
+            return false;
+        }
+
+        // 取り込んだら消す(消せなければ空にして二重に取り込まないようにする)
+        if (!m_Fs->Remove(basePathUtf8))
+        {
+            return static_cast<bool>(m_Fs->WriteAllBytes(basePathUtf8, "", 0));
+        }
+        return true;
+    }
+}
@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "include/LzCodec.h"
+
+// C++ standard library includes
+#include <cstring>
+
+namespace
+{
+    constexpr size_t kMinMatch = 4;
+    constexpr size_t kLastLiterals = 5;   ///< 末尾はリテラルで終える(展開側の高速コピーが末尾を越えないように)
+    constexpr size_t kMatchSearchLimit = 12;
+    constexpr size_t kMaxOffset = 65535;
+    using Drama::Core::Compression::kHashBits;
+
+    inline uint32_t Read32(const uint8_t* p) noexcept
+    {
+        uint32_t v = 0;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint32_t Hash4(uint32_t v) noexcept
+    {
+        return (v * 2654435761u) >> (32 - kHashBits);
+    }
+
+    /// @brief 255刻みの延長バイトを書く
+    inline bool PutLength(uint8_t*& op, const uint8_t* end, size_t len) noexcept
+    {
+        while (len >= 255)
+        {
+            if (op >= end)
+            {
+                return false;
+            }
+            *op++ = 255;
+            len -= 255;
+        }
+        if (op >= end)
+        {
+            return false;
+        }
+        *op++ = static_cast<uint8_t>(len);
+        return true;
+    }
+
+    inline bool GetLength(const uint8_t*& ip, const uint8_t* end, size_t& len) noexcept
+    {
+        uint8_t b = 0;
+        do
+        {
+            if (ip >= end)
+            {
+                return false;
+            }
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+
+    /// @brief 1シーケンス書く(matchLen==0 なら末尾のリテラルのみ)
+    inline bool PutSequence(uint8_t*& op, const uint8_t* end, const uint8_t* literals, size_t litLen,
+        size_t offset, size_t matchLen) noexcept
+    {
+        if (op >= end)
+        {
+            return false;
+        }
+        uint8_t* token = op++;
+        const size_t litCode = (litLen >= 15) ? 15 : litLen;
+        *token = static_cast<uint8_t>(litCode << 4);
+        if (litLen >= 15 && !PutLength(op, end, litLen - 15))
+        {
+            return false;
+        }
+        if (static_cast<size_t>(end - op) < litLen)
+        {
+            return false;
+        }
+        if (litLen > 0)
+        {
+            std::memcpy(op, literals, litLen);
+        }
+        op += litLen;
+
+        if (matchLen == 0)
+        {
+            return true;
+        }
+        if (end - op < 2)
+        {
+            return false;
+        }
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        const size_t ml = matchLen - kMinMatch;
+        *token |= static_cast<uint8_t>((ml >= 15) ? 15 : ml);
+        if (ml >= 15 && !PutLength(op, end, ml - 15))
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace Drama::Core::Compression
+{
+    size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity, CompressScratch& scratch) noexcept
+    {
+        uint8_t* op = dst;
+        const uint8_t* const oend = dst + dstCapacity;
+        size_t anchor = 0;
+
+        if (srcSize > kMatchSearchLimit)
+        {
+            // 位置+1 を入れる(0は空)
+            uint32_t* const table = scratch.table;
+            std::memset(table, 0, sizeof(scratch.table));
+
+            const size_t matchLimit = srcSize - kLastLiterals;
+            const size_t searchLimit = srcSize - kMatchSearchLimit;
+            size_t ip = 0;
+            while (ip < searchLimit)
+            {
+                const uint32_t seq = Read32(src + ip);
+                const uint32_t h = Hash4(seq);
+                const size_t ref = table[h];
+                table[h] = static_cast<uint32_t>(ip + 1);
+
+                if (ref == 0 || ip - (ref - 1) > kMaxOffset || Read32(src + ref - 1) != seq)
+                {
+                    // 一致しない区間が長いほど大きく飛ばす(圧縮できないデータで時間をかけない)
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                size_t match = ref - 1;
+                // 直前のリテラルとも一致していれば後ろに伸ばす
+                while (ip > anchor && match > 0 && src[ip - 1] == src[match - 1])
+                {
+                    --ip;
+                    --match;
+                }
+                size_t len = kMinMatch;
+                while (ip + len < matchLimit && src[match + len] == src[ip + len])
+                {
+                    ++len;
+                }
+
+                if (!PutSequence(op, oend, src + anchor, ip - anchor, ip - match, len))
+                {
+                    return 0;
+                }
+                ip += len;
+                anchor = ip;
+                // 一致の末尾付近も登録しておくと次の一致が見つかりやすい
+                if (ip - 2 < searchLimit)
+                {
+                    table[Hash4(Read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+                }
+            }
+        }
+
+        if (!PutSequence(op, oend, src + anchor, srcSize - anchor, 0, 0))
+        {
+            return 0;
+        }
+        return static_cast<size_t>(op - dst);
+    }
+
+    bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t rawSize) noexcept
+    {
+        const uint8_t* ip = src;
+        const uint8_t* const iend = src + srcSize;
+        uint8_t* op = dst;
+        uint8_t* const oend = dst + rawSize;
+
+        while (ip < iend)
+        {
+            const uint8_t token = *ip++;
+
+            size_t litLen = token >> 4;
+            if (litLen == 15 && !GetLength(ip, iend, litLen))
+            {
+                return false;
+            }
+            if (static_cast<size_t>(iend - ip) < litLen || static_cast<size_t>(oend - op) < litLen)
+            {
+                return false;
+            }
+            if (litLen > 0)
+            {
+                std::memcpy(op, ip, litLen);
+            }
+            ip += litLen;
+            op += litLen;
+
+            if (ip == iend)
+            {
+                break; // 末尾のリテラルのみのシーケンス
+            }
+
+            if (iend - ip < 2)
+            {
+                return false;
+            }
+            const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - dst))
+            {
+                return false;
+            }
+
+            size_t matchLen = token & 15;
+            if (matchLen == 15 && !GetLength(ip, iend, matchLen))
+            {
+                return false;
+            }
+            matchLen += kMinMatch;
+            if (static_cast<size_t>(oend - op) < matchLen)
+            {
+                return false;
+            }
+
+            const uint8_t* match = op - offset;
+            if (offset >= 8)
+            {
+                // 8バイトずつ。重なっても offset>=8 なら読む前に書き換わらない
+                size_t i = 0;
+                for (; i + 8 <= matchLen; i += 8)
+                {
+                    std::memcpy(op + i, match + i, 8);
+                }
+                for (; i < matchLen; ++i)
+                {
+                    op[i] = match[i];
+                }
+            }
+            else
+            {
+                // 近距離の繰り返し(連続した同じバイトなど)は1バイトずつ
+                for (size_t i = 0; i < matchLen; ++i)
+                {
+                    op[i] = match[i];
+                }
+            }
+            op += matchLen;
+        }
+        return op == oend;
+    }
+}
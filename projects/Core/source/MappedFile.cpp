@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "include/MappedFile.h"
+
+// C++ standard library includes
+#include <utility>
+
+namespace Drama::Core::IO
+{
+    MappedFile::~MappedFile()
+    {
+        Reset();
+    }
+
+    MappedFile::MappedFile(MappedFile&& o) noexcept
+        : m_Data(std::exchange(o.m_Data, nullptr)),
+        m_Size(std::exchange(o.m_Size, 0)),
+        m_Release(std::exchange(o.m_Release, nullptr)),
+        m_Fallback(std::move(o.m_Fallback))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& o) noexcept
+    {
+        if (this != &o)
+        {
+            Reset();
+            m_Data = std::exchange(o.m_Data, nullptr);
+            m_Size = std::exchange(o.m_Size, 0);
+            m_Release = std::exchange(o.m_Release, nullptr);
+            m_Fallback = std::move(o.m_Fallback);
+        }
+        return *this;
+    }
+
+    MappedFile MappedFile::FromMapping(const uint8_t* data, size_t size, ReleaseFn release) noexcept
+    {
+        MappedFile f;
+        f.m_Data = data;
+        f.m_Size = size;
+        f.m_Release = release;
+        return f;
+    }
+
+    MappedFile MappedFile::FromBytes(std::vector<uint8_t>&& bytes) noexcept
+    {
+        MappedFile f;
+        f.m_Fallback = std::move(bytes);
+        // vectorのムーブでは要素の場所は変わらないので、ここで取ったポインタはムーブ後も有効
+        f.m_Data = f.m_Fallback.data();
+        f.m_Size = f.m_Fallback.size();
+        return f;
+    }
+
+    void MappedFile::Reset() noexcept
+    {
+        if (m_Release != nullptr && m_Data != nullptr)
+        {
+            m_Release(m_Data, m_Size);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Release = nullptr;
+        m_Fallback.clear();
+        m_Fallback.shrink_to_fit();
+    }
+}
@@ -0,0 +1,460 @@
+#include "pch.h"
+#include "include/MathBatch.h"
+
+// C++ standard library includes
+#include <cmath>
+
+#if defined(DRAMA_SIMD_SSE) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// AVX2 の実装は x86-64 なら常にビルドし、使うかは CPU を見て決める。
+// MSVC は /arch を付けなくても組み込み関数を使えるが、GCC/Clang は関数ごとに target の指定が要る
+#if defined(DRAMA_SIMD_SSE)
+#define DRAMA_MATH_HAS_AVX2_KERNELS 1
+#if defined(__GNUC__) || defined(__clang__)
+#define DRAMA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define DRAMA_TARGET_AVX2
+#endif
+#endif
+
+namespace Drama::Core::Math
+{
+    namespace
+    {
+        // ---- 端数と Scalar 実装が共有する1要素分の処理 ----
+
+        inline void TransformPointAt(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t i) noexcept
+        {
+            const float x = in.x[i];
+            const float y = in.y[i];
+            const float z = in.z[i];
+            out.x[i] = x * m.r[0].x + y * m.r[1].x + z * m.r[2].x + m.r[3].x;
+            out.y[i] = x * m.r[0].y + y * m.r[1].y + z * m.r[2].y + m.r[3].y;
+            out.z[i] = x * m.r[0].z + y * m.r[1].z + z * m.r[2].z + m.r[3].z;
+        }
+
+        inline void NormalizeQuaternionAt(QuaternionStream q, size_t i) noexcept
+        {
+            const float lenSq = q.x[i] * q.x[i] + q.y[i] * q.y[i] + q.z[i] * q.z[i] + q.w[i] * q.w[i];
+            if (!(lenSq > 0.0f))
+            {
+                q.x[i] = 0.0f;
+                q.y[i] = 0.0f;
+                q.z[i] = 0.0f;
+                q.w[i] = 1.0f;
+                return;
+            }
+            const float inv = 1.0f / std::sqrt(lenSq);
+            q.x[i] *= inv;
+            q.y[i] *= inv;
+            q.z[i] *= inv;
+            q.w[i] *= inv;
+        }
+
+        namespace Scalar
+        {
+            void TransformPoints(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    TransformPointAt(m, in, out, i);
+                }
+            }
+
+            void MultiplyMatrices(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept
+            {
+                for (size_t n = 0; n < count; ++n)
+                {
+                    // out が a や b と同じでもよいよう、いったん手元で組み立てる
+                    const float* pa = &a[n].r[0].x;
+                    const float* pb = &b[n].r[0].x;
+                    float result[16];
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        for (int j = 0; j < 4; ++j)
+                        {
+                            result[i * 4 + j] = pa[i * 4 + 0] * pb[0 * 4 + j] + pa[i * 4 + 1] * pb[1 * 4 + j] +
+                                pa[i * 4 + 2] * pb[2 * 4 + j] + pa[i * 4 + 3] * pb[3 * 4 + j];
+                        }
+                    }
+                    float* po = &out[n].r[0].x;
+                    for (int k = 0; k < 16; ++k)
+                    {
+                        po[k] = result[k];
+                    }
+                }
+            }
+
+            void NormalizeQuaternions(QuaternionStream q, size_t count) noexcept
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    NormalizeQuaternionAt(q, i);
+                }
+            }
+        }
+
+#if defined(DRAMA_SIMD_SSE)
+        namespace Sse2
+        {
+            void TransformPoints(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept
+            {
+                // 行列の各要素を4つに広げておき、4点ずつ積和する(SoA なのでシャッフルが要らない)
+                const __m128 m00 = _mm_set1_ps(m.r[0].x), m01 = _mm_set1_ps(m.r[0].y), m02 = _mm_set1_ps(m.r[0].z);
+                const __m128 m10 = _mm_set1_ps(m.r[1].x), m11 = _mm_set1_ps(m.r[1].y), m12 = _mm_set1_ps(m.r[1].z);
+                const __m128 m20 = _mm_set1_ps(m.r[2].x), m21 = _mm_set1_ps(m.r[2].y), m22 = _mm_set1_ps(m.r[2].z);
+                const __m128 m30 = _mm_set1_ps(m.r[3].x), m31 = _mm_set1_ps(m.r[3].y), m32 = _mm_set1_ps(m.r[3].z);
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4)
+                {
+                    const __m128 x = _mm_loadu_ps(in.x + i);
+                    const __m128 y = _mm_loadu_ps(in.y + i);
+                    const __m128 z = _mm_loadu_ps(in.z + i);
+                    _mm_storeu_ps(out.x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_add_ps(_mm_mul_ps(z, m20), m30)));
+                    _mm_storeu_ps(out.y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_add_ps(_mm_mul_ps(z, m21), m31)));
+                    _mm_storeu_ps(out.z + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)), _mm_add_ps(_mm_mul_ps(z, m22), m32)));
+                }
+                for (; i < count; ++i)
+                {
+                    TransformPointAt(m, in, out, i);
+                }
+            }
+
+            void MultiplyMatrices(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept
+            {
+                // 結果の i 行 = a[i].x * b[0] + a[i].y * b[1] + a[i].z * b[2] + a[i].w * b[3]
+                for (size_t n = 0; n < count; ++n)
+                {
+                    const __m128 b0 = _mm_load_ps(&b[n].r[0].x);
+                    const __m128 b1 = _mm_load_ps(&b[n].r[1].x);
+                    const __m128 b2 = _mm_load_ps(&b[n].r[2].x);
+                    const __m128 b3 = _mm_load_ps(&b[n].r[3].x);
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const __m128 row = _mm_load_ps(&a[n].r[i].x);
+                        __m128 acc = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+                        _mm_store_ps(&out[n].r[i].x, acc);
+                    }
+                }
+            }
+
+            void NormalizeQuaternions(QuaternionStream q, size_t count) noexcept
+            {
+                // rsqrt の概算(12 bit)をニュートン法1回で 22 bit 程度まで詰める。長さ0の要素は後で単位四元数に置き換える
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 threeHalves = _mm_set1_ps(1.5f);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.0f);
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4)
+                {
+                    const __m128 x = _mm_loadu_ps(q.x + i);
+                    const __m128 y = _mm_loadu_ps(q.y + i);
+                    const __m128 z = _mm_loadu_ps(q.z + i);
+                    const __m128 w = _mm_loadu_ps(q.w + i);
+                    const __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+                    __m128 inv = _mm_rsqrt_ps(lenSq);
+                    inv = _mm_mul_ps(inv, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, lenSq), _mm_mul_ps(inv, inv))));
+                    const __m128 valid = _mm_cmpgt_ps(lenSq, zero);
+                    inv = _mm_and_ps(inv, valid);
+                    _mm_storeu_ps(q.x + i, _mm_mul_ps(x, inv));
+                    _mm_storeu_ps(q.y + i, _mm_mul_ps(y, inv));
+                    _mm_storeu_ps(q.z + i, _mm_mul_ps(z, inv));
+                    _mm_storeu_ps(q.w + i, _mm_or_ps(_mm_and_ps(valid, _mm_mul_ps(w, inv)), _mm_andnot_ps(valid, one)));
+                }
+                for (; i < count; ++i)
+                {
+                    NormalizeQuaternionAt(q, i);
+                }
+            }
+        }
+#endif
+
+#if defined(DRAMA_MATH_HAS_AVX2_KERNELS)
+        namespace Avx2
+        {
+            DRAMA_TARGET_AVX2 void TransformPoints(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept
+            {
+                const __m256 m00 = _mm256_set1_ps(m.r[0].x), m01 = _mm256_set1_ps(m.r[0].y), m02 = _mm256_set1_ps(m.r[0].z);
+                const __m256 m10 = _mm256_set1_ps(m.r[1].x), m11 = _mm256_set1_ps(m.r[1].y), m12 = _mm256_set1_ps(m.r[1].z);
+                const __m256 m20 = _mm256_set1_ps(m.r[2].x), m21 = _mm256_set1_ps(m.r[2].y), m22 = _mm256_set1_ps(m.r[2].z);
+                const __m256 m30 = _mm256_set1_ps(m.r[3].x), m31 = _mm256_set1_ps(m.r[3].y), m32 = _mm256_set1_ps(m.r[3].z);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m256 x = _mm256_loadu_ps(in.x + i);
+                    const __m256 y = _mm256_loadu_ps(in.y + i);
+                    const __m256 z = _mm256_loadu_ps(in.z + i);
+                    _mm256_storeu_ps(out.x + i, _mm256_fmadd_ps(x, m00, _mm256_fmadd_ps(y, m10, _mm256_fmadd_ps(z, m20, m30))));
+                    _mm256_storeu_ps(out.y + i, _mm256_fmadd_ps(x, m01, _mm256_fmadd_ps(y, m11, _mm256_fmadd_ps(z, m21, m31))));
+                    _mm256_storeu_ps(out.z + i, _mm256_fmadd_ps(x, m02, _mm256_fmadd_ps(y, m12, _mm256_fmadd_ps(z, m22, m32))));
+                }
+                for (; i < count; ++i)
+                {
+                    TransformPointAt(m, in, out, i);
+                }
+            }
+
+            DRAMA_TARGET_AVX2 void MultiplyMatrices(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept
+            {
+                // 2行ずつ 256 bit に載せる。b の各行は上下両方の 128 bit に複製し、a の要素はレーン内で広げる
+                for (size_t n = 0; n < count; ++n)
+                {
+                    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b[n].r[0].x));
+                    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b[n].r[1].x));
+                    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b[n].r[2].x));
+                    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b[n].r[3].x));
+                    const __m256 a01 = _mm256_loadu_ps(&a[n].r[0].x);
+                    const __m256 a23 = _mm256_loadu_ps(&a[n].r[2].x);
+
+                    __m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+                    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(1, 1, 1, 1)), b1, r01);
+                    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(2, 2, 2, 2)), b2, r01);
+                    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(3, 3, 3, 3)), b3, r01);
+
+                    __m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+                    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(1, 1, 1, 1)), b1, r23);
+                    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(2, 2, 2, 2)), b2, r23);
+                    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(3, 3, 3, 3)), b3, r23);
+
+                    _mm256_storeu_ps(&out[n].r[0].x, r01);
+                    _mm256_storeu_ps(&out[n].r[2].x, r23);
+                }
+            }
+
+            DRAMA_TARGET_AVX2 void NormalizeQuaternions(QuaternionStream q, size_t count) noexcept
+            {
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 threeHalves = _mm256_set1_ps(1.5f);
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 one = _mm256_set1_ps(1.0f);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m256 x = _mm256_loadu_ps(q.x + i);
+                    const __m256 y = _mm256_loadu_ps(q.y + i);
+                    const __m256 z = _mm256_loadu_ps(q.z + i);
+                    const __m256 w = _mm256_loadu_ps(q.w + i);
+                    const __m256 lenSq = _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_fmadd_ps(z, z, _mm256_mul_ps(w, w))));
+                    __m256 inv = _mm256_rsqrt_ps(lenSq);
+                    inv = _mm256_mul_ps(inv, _mm256_fnmadd_ps(_mm256_mul_ps(half, lenSq), _mm256_mul_ps(inv, inv), threeHalves));
+                    const __m256 valid = _mm256_cmp_ps(lenSq, zero, _CMP_GT_OQ);
+                    inv = _mm256_and_ps(inv, valid);
+                    _mm256_storeu_ps(q.x + i, _mm256_mul_ps(x, inv));
+                    _mm256_storeu_ps(q.y + i, _mm256_mul_ps(y, inv));
+                    _mm256_storeu_ps(q.z + i, _mm256_mul_ps(z, inv));
+                    _mm256_storeu_ps(q.w + i, _mm256_blendv_ps(one, _mm256_mul_ps(w, inv), valid));
+                }
+                for (; i < count; ++i)
+                {
+                    NormalizeQuaternionAt(q, i);
+                }
+            }
+        }
+#endif
+
+#if defined(DRAMA_SIMD_NEON)
+        namespace Neon
+        {
+            void TransformPoints(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept
+            {
+                const float32x4_t m0 = vld1q_f32(&m.r[0].x);
+                const float32x4_t m1 = vld1q_f32(&m.r[1].x);
+                const float32x4_t m2 = vld1q_f32(&m.r[2].x);
+                const float32x4_t m3 = vld1q_f32(&m.r[3].x);
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4)
+                {
+                    const float32x4_t x = vld1q_f32(in.x + i);
+                    const float32x4_t y = vld1q_f32(in.y + i);
+                    const float32x4_t z = vld1q_f32(in.z + i);
+                    vst1q_f32(out.x + i, vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vdupq_laneq_f32(m3, 0), z, m2, 0), y, m1, 0), x, m0, 0));
+                    vst1q_f32(out.y + i, vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vdupq_laneq_f32(m3, 1), z, m2, 1), y, m1, 1), x, m0, 1));
+                    vst1q_f32(out.z + i, vfmaq_laneq_f32(vfmaq_laneq_f32(vfmaq_laneq_f32(vdupq_laneq_f32(m3, 2), z, m2, 2), y, m1, 2), x, m0, 2));
+                }
+                for (; i < count; ++i)
+                {
+                    TransformPointAt(m, in, out, i);
+                }
+            }
+
+            void MultiplyMatrices(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept
+            {
+                for (size_t n = 0; n < count; ++n)
+                {
+                    const float32x4_t b0 = vld1q_f32(&b[n].r[0].x);
+                    const float32x4_t b1 = vld1q_f32(&b[n].r[1].x);
+                    const float32x4_t b2 = vld1q_f32(&b[n].r[2].x);
+                    const float32x4_t b3 = vld1q_f32(&b[n].r[3].x);
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const float32x4_t row = vld1q_f32(&a[n].r[i].x);
+                        float32x4_t acc = vmulq_laneq_f32(b0, row, 0);
+                        acc = vfmaq_laneq_f32(acc, b1, row, 1);
+                        acc = vfmaq_laneq_f32(acc, b2, row, 2);
+                        acc = vfmaq_laneq_f32(acc, b3, row, 3);
+                        vst1q_f32(&out[n].r[i].x, acc);
+                    }
+                }
+            }
+
+            void NormalizeQuaternions(QuaternionStream q, size_t count) noexcept
+            {
+                // NEON の rsqrt 概算は 8 bit しかないので、ニュートン法を2回かける
+                const float32x4_t zero = vdupq_n_f32(0.0f);
+                const float32x4_t one = vdupq_n_f32(1.0f);
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4)
+                {
+                    const float32x4_t x = vld1q_f32(q.x + i);
+                    const float32x4_t y = vld1q_f32(q.y + i);
+                    const float32x4_t z = vld1q_f32(q.z + i);
+                    const float32x4_t w = vld1q_f32(q.w + i);
+                    const float32x4_t lenSq = vfmaq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(w, w), z, z), y, y), x, x);
+                    float32x4_t inv = vrsqrteq_f32(lenSq);
+                    inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lenSq, inv), inv));
+                    inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lenSq, inv), inv));
+                    const uint32x4_t valid = vcgtq_f32(lenSq, zero);
+                    vst1q_f32(q.x + i, vbslq_f32(valid, vmulq_f32(x, inv), zero));
+                    vst1q_f32(q.y + i, vbslq_f32(valid, vmulq_f32(y, inv), zero));
+                    vst1q_f32(q.z + i, vbslq_f32(valid, vmulq_f32(z, inv), zero));
+                    vst1q_f32(q.w + i, vbslq_f32(valid, vmulq_f32(w, inv), one));
+                }
+                for (; i < count; ++i)
+                {
+                    NormalizeQuaternionAt(q, i);
+                }
+            }
+        }
+#endif
+
+        constexpr BatchKernels kScalarKernels{ SimdLevel::Scalar, &Scalar::TransformPoints, &Scalar::MultiplyMatrices, &Scalar::NormalizeQuaternions };
+#if defined(DRAMA_SIMD_SSE)
+        constexpr BatchKernels kSse2Kernels{ SimdLevel::Sse2, &Sse2::TransformPoints, &Sse2::MultiplyMatrices, &Sse2::NormalizeQuaternions };
+#endif
+#if defined(DRAMA_MATH_HAS_AVX2_KERNELS)
+        constexpr BatchKernels kAvx2Kernels{ SimdLevel::Avx2, &Avx2::TransformPoints, &Avx2::MultiplyMatrices, &Avx2::NormalizeQuaternions };
+#endif
+#if defined(DRAMA_SIMD_NEON)
+        constexpr BatchKernels kNeonKernels{ SimdLevel::Neon, &Neon::TransformPoints, &Neon::MultiplyMatrices, &Neon::NormalizeQuaternions };
+#endif
+
+#if defined(DRAMA_MATH_HAS_AVX2_KERNELS)
+        /// @brief CPU と OS が AVX2 と FMA を使えるか(OS が YMM を退避しないと使えない)
+        bool DetectAvx2() noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4]{};
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+            {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+#endif
+    }
+
+    const char* SimdLevelName(SimdLevel level) noexcept
+    {
+        switch (level)
+        {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::Sse2: return "SSE2";
+        case SimdLevel::Avx2: return "AVX2";
+        case SimdLevel::Neon: return "NEON";
+        default: return "?";
+        }
+    }
+
+    SimdLevel CompiledSimdLevel() noexcept
+    {
+#if defined(DRAMA_SIMD_AVX2)
+        return SimdLevel::Avx2;
+#elif defined(DRAMA_SIMD_SSE)
+        return SimdLevel::Sse2;
+#elif defined(DRAMA_SIMD_NEON)
+        return SimdLevel::Neon;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    bool IsSimdLevelSupported(SimdLevel level) noexcept
+    {
+        return KernelsFor(level) != nullptr;
+    }
+
+    const BatchKernels* KernelsFor(SimdLevel level) noexcept
+    {
+        switch (level)
+        {
+        case SimdLevel::Scalar:
+            return &kScalarKernels;
+#if defined(DRAMA_SIMD_SSE)
+        case SimdLevel::Sse2:
+            return &kSse2Kernels;
+#endif
+#if defined(DRAMA_MATH_HAS_AVX2_KERNELS)
+        case SimdLevel::Avx2:
+        {
+            static const bool s_Supported = DetectAvx2();
+            return s_Supported ? &kAvx2Kernels : nullptr;
+        }
+#endif
+#if defined(DRAMA_SIMD_NEON)
+        case SimdLevel::Neon:
+            return &kNeonKernels;
+#endif
+        default:
+            return nullptr;
+        }
+    }
+
+    // 既定の実装はコンパイル時に決める(呼び出しごとに表を引かない)
+#if defined(DRAMA_SIMD_AVX2)
+    namespace Selected = Avx2;
+#elif defined(DRAMA_SIMD_SSE)
+    namespace Selected = Sse2;
+#elif defined(DRAMA_SIMD_NEON)
+    namespace Selected = Neon;
+#else
+    namespace Selected = Scalar;
+#endif
+
+    namespace Batch
+    {
+        void TransformPoints(const Float4x4& m, ConstFloat3Stream in, Float3Stream out, size_t count) noexcept
+        {
+            Selected::TransformPoints(m, in, out, count);
+        }
+
+        void MultiplyMatrices(const Float4x4* a, const Float4x4* b, Float4x4* out, size_t count) noexcept
+        {
+            Selected::MultiplyMatrices(a, b, out, count);
+        }
+
+        void NormalizeQuaternions(QuaternionStream q, size_t count) noexcept
+        {
+            Selected::NormalizeQuaternions(q, count);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "include/MathTypes.h"
+
+namespace Drama::Core::Math
+{
+    Float4x4 Inverse(const Float4x4& m, float* outDeterminant) noexcept
+    {
+        // 2x2 の小行列式から余因子を作る(ループなしで 100 回ほどの積で済む)
+        const float a00 = m.r[0].x, a01 = m.r[0].y, a02 = m.r[0].z, a03 = m.r[0].w;
+        const float a10 = m.r[1].x, a11 = m.r[1].y, a12 = m.r[1].z, a13 = m.r[1].w;
+        const float a20 = m.r[2].x, a21 = m.r[2].y, a22 = m.r[2].z, a23 = m.r[2].w;
+        const float a30 = m.r[3].x, a31 = m.r[3].y, a32 = m.r[3].z, a33 = m.r[3].w;
+
+        const float b00 = a00 * a11 - a01 * a10;
+        const float b01 = a00 * a12 - a02 * a10;
+        const float b02 = a00 * a13 - a03 * a10;
+        const float b03 = a01 * a12 - a02 * a11;
+        const float b04 = a01 * a13 - a03 * a11;
+        const float b05 = a02 * a13 - a03 * a12;
+        const float b06 = a20 * a31 - a21 * a30;
+        const float b07 = a20 * a32 - a22 * a30;
+        const float b08 = a20 * a33 - a23 * a30;
+        const float b09 = a21 * a32 - a22 * a31;
+        const float b10 = a21 * a33 - a23 * a31;
+        const float b11 = a22 * a33 - a23 * a32;
+
+        const float det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+        if (outDeterminant)
+        {
+            *outDeterminant = det;
+        }
+        if (det == 0.0f || !std::isfinite(det))
+        {
+            return Identity();
+        }
+        const float inv = 1.0f / det;
+        Float4x4 out;
+        out.r[0] = { (a11 * b11 - a12 * b10 + a13 * b09) * inv, (a02 * b10 - a01 * b11 - a03 * b09) * inv,
+                     (a31 * b05 - a32 * b04 + a33 * b03) * inv, (a22 * b04 - a21 * b05 - a23 * b03) * inv };
+        out.r[1] = { (a12 * b08 - a10 * b11 - a13 * b07) * inv, (a00 * b11 - a02 * b08 + a03 * b07) * inv,
+                     (a32 * b02 - a30 * b05 - a33 * b01) * inv, (a20 * b05 - a22 * b02 + a23 * b01) * inv };
+        out.r[2] = { (a10 * b10 - a11 * b08 + a13 * b06) * inv, (a01 * b08 - a00 * b10 - a03 * b06) * inv,
+                     (a30 * b04 - a31 * b02 + a33 * b00) * inv, (a21 * b02 - a20 * b04 - a23 * b00) * inv };
+        out.r[3] = { (a11 * b07 - a10 * b09 - a12 * b06) * inv, (a00 * b09 - a01 * b07 + a02 * b06) * inv,
+                     (a31 * b01 - a30 * b03 - a32 * b00) * inv, (a20 * b03 - a21 * b01 + a22 * b00) * inv };
+        return out;
+    }
+
+    Quaternion Slerp(Quaternion a, Quaternion b, float t) noexcept
+    {
+        float cosTheta = Dot(a, b);
+        // 逆向きの四元数は同じ回転。近い方を通るよう符号を合わせる
+        if (cosTheta < 0.0f)
+        {
+            b = { -b.x, -b.y, -b.z, -b.w };
+            cosTheta = -cosTheta;
+        }
+        float wa = 1.0f - t;
+        float wb = t;
+        // ほぼ同じ向きなら sin が 0 に近づいて割り算が荒れるので線形補間で済ませる
+        if (cosTheta < 0.9995f)
+        {
+            const float theta = std::acos(cosTheta);
+            const float invSin = 1.0f / std::sin(theta);
+            wa = std::sin((1.0f - t) * theta) * invSin;
+            wb = std::sin(t * theta) * invSin;
+        }
+        return Normalize(Quaternion{ a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb });
+    }
+}
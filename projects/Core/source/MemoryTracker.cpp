@@ -0,0 +1,471 @@
+#include "pch.h"
+#include "include/MemoryTracker.h"
+#include "include/ThreadLocalAccess.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <new>
+#include <mutex>
+
+#if DRAMA_MEMORY_TRACKING
+
+namespace
+{
+    using Drama::Core::Memory::AllocationRecord;
+    using Drama::Core::Memory::BudgetHandler;
+    using Drama::Core::Memory::kMemoryTagCount;
+    using Drama::Core::Memory::MemoryTag;
+    using Drama::Core::Memory::TagStats;
+
+    /// @brief 1スレッド分のカウンタ。書くのは持ち主だけなので、読み書きを分けた relaxed で足せる
+    ///       (lock 付きの加算にしない)。Update は他のスレッドから relaxed で読むだけ
+    /// @note 別のスレッドが解放すると、そのスレッドのバイト数は負になる(全スレッドの合計が合えばよい)
+    struct alignas(64) ThreadCounters
+    {
+        std::atomic<int64_t> bytes[kMemoryTagCount]{};
+        std::atomic<uint64_t> allocations[kMemoryTagCount]{};
+        std::atomic<uint64_t> frees[kMemoryTagCount]{};
+    };
+
+    template <class T, class U>
+    inline void Add(std::atomic<T>& counter, U value) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + static_cast<T>(value), std::memory_order_relaxed);
+    }
+
+    /// @brief 全スレッドのカウンタ。終わったスレッドのカウンタは次のスレッドがそのまま引き継ぐ
+    ///        (足し込んだ値は合計に残り続けるので捨てられない。使い回して数が増えないようにする)
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadCounters>> all;
+        std::vector<ThreadCounters*> free;
+    };
+    Registry g_Registry;
+
+    /// @brief Update で合計した結果と予算
+    struct Totals
+    {
+        std::mutex mutex;
+        std::array<TagStats, kMemoryTagCount> stats{};
+        std::array<bool, kMemoryTagCount> overBudget{}; ///< 通知済み(下回るまで再通知しない)
+    };
+    Totals g_Totals;
+    std::atomic<int64_t> g_Budgets[kMemoryTagCount]{};
+    std::atomic<BudgetHandler> g_BudgetHandler{ nullptr };
+    std::atomic<uint64_t> g_Frame{ 0 };
+
+    /// @brief 生きている確保の記録をアドレスで引く表(線形探索の開番地法)
+    /// @note 記録は noexcept の確保・解放の経路から呼ばれるので、例外で確保失敗を知らせる標準コンテナは使わない。
+    ///       表を広げるときは nothrow で取り、取れなければその記録だけを諦めて数える(集計のカウンタには影響しない)。
+    ///       表自体の確保は追跡しない
+    class RecordTable final
+    {
+    public:
+        RecordTable() = default;
+        ~RecordTable() { Release(); }
+        RecordTable(const RecordTable&) = delete;
+        RecordTable& operator=(const RecordTable&) = delete;
+
+        /// @brief 記録する(同じアドレスがあれば上書き)
+        /// @return 表を広げられなければ false
+        bool Assign(const AllocationRecord& record) noexcept
+        {
+            if ((m_Size + 1) * 2 > m_Capacity && !Grow())
+            {
+                return false;
+            }
+            size_t i = Home(record.address);
+            while (m_Slots[i].address && m_Slots[i].address != record.address)
+            {
+                i = (i + 1) & (m_Capacity - 1);
+            }
+            if (!m_Slots[i].address)
+            {
+                ++m_Size;
+            }
+            m_Slots[i] = record;
+            return true;
+        }
+
+        /// @brief 消す(後ろの要素を詰めて、墓標を残さない)
+        void Erase(const void* address) noexcept
+        {
+            if (m_Size == 0)
+            {
+                return;
+            }
+            const size_t mask = m_Capacity - 1;
+            size_t hole = Home(address);
+            while (m_Slots[hole].address != address)
+            {
+                if (!m_Slots[hole].address)
+                {
+                    return;
+                }
+                hole = (hole + 1) & mask;
+            }
+            // 穴より後ろにあり、本来の位置が穴を越えない要素を穴へ移す
+            for (size_t i = (hole + 1) & mask; m_Slots[i].address; i = (i + 1) & mask)
+            {
+                const size_t home = Home(m_Slots[i].address);
+                if (((i - home) & mask) >= ((i - hole) & mask))
+                {
+                    m_Slots[hole] = m_Slots[i];
+                    hole = i;
+                }
+            }
+            m_Slots[hole] = AllocationRecord{};
+            --m_Size;
+        }
+
+        size_t Size() const noexcept { return m_Size; }
+
+        template <class F>
+        void ForEach(F&& fn) const
+        {
+            for (size_t i = 0; i < m_Capacity; ++i)
+            {
+                if (m_Slots[i].address)
+                {
+                    fn(m_Slots[i]);
+                }
+            }
+        }
+
+    private:
+        static constexpr size_t kInitialCapacity = 1024;
+
+        size_t Home(const void* address) const noexcept
+        {
+            // 確保のアドレスは下位ビットがそろいやすいので、掛け算で上位へ混ぜてから使う
+            const uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(address)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(key >> m_Shift);
+        }
+
+        bool Grow() noexcept
+        {
+            const size_t capacity = m_Capacity ? m_Capacity * 2 : kInitialCapacity;
+            auto* slots = static_cast<AllocationRecord*>(::operator new(capacity * sizeof(AllocationRecord), std::nothrow));
+            if (!slots)
+            {
+                return false;
+            }
+            std::uninitialized_fill_n(slots, capacity, AllocationRecord{});
+
+            AllocationRecord* old = m_Slots;
+            const size_t oldCapacity = m_Capacity;
+            m_Slots = slots;
+            m_Capacity = capacity;
+            m_Shift = 64 - static_cast<uint32_t>(std::countr_zero(capacity));
+            m_Size = 0;
+            for (size_t i = 0; i < oldCapacity; ++i)
+            {
+                if (old[i].address)
+                {
+                    Assign(old[i]);
+                }
+            }
+            ::operator delete(old);
+            return true;
+        }
+
+        void Release() noexcept
+        {
+            ::operator delete(m_Slots);
+            m_Slots = nullptr;
+            m_Capacity = 0;
+            m_Size = 0;
+        }
+
+        AllocationRecord* m_Slots = nullptr; ///< 空きは address が nullptr
+        size_t m_Capacity = 0;               ///< 2 の累乗
+        size_t m_Size = 0;
+        uint32_t m_Shift = 64;
+    };
+
+    /// @brief 個々の確保の記録(リーク探し用。有効な間だけ取る)
+    struct Records
+    {
+        std::mutex mutex;
+        RecordTable live;
+        uint64_t sequence = 0;
+        uint64_t dropped = 0; ///< 表を広げられずに取れなかった記録の数
+    };
+    Records g_Records;
+    std::atomic<bool> g_RecordsEnabled{ false };
+    std::atomic<size_t> g_RecordCount{ 0 }; ///< live の件数(空なら解放のたびにロックを取らずに済む)
+
+    /// @brief この翻訳単位の静的変数が壊された後か
+    /// @note 他の翻訳単位の静的オブジェクト(ログの書き込み器など)は、ここより後で壊されて解放を記録しに来ることがある。
+    ///       壊れたカウンタや表に書かないよう、それ以降の記録は捨てる(プロセスの終了間際なので集計には要らない)
+    std::atomic<bool> g_IsTornDown{ false };
+    struct TeardownGuard
+    {
+        ~TeardownGuard() { g_IsTornDown.store(true, std::memory_order_relaxed); }
+    };
+    TeardownGuard g_TeardownGuard; ///< 上の静的変数より後に作るので、それらより先に壊される
+
+    /// @brief スレッドの終了時にカウンタを返す
+    struct CountersOwner
+    {
+        ThreadCounters* counters = nullptr;
+        ~CountersOwner()
+        {
+            if (counters)
+            {
+                std::scoped_lock lock(g_Registry.mutex);
+                g_Registry.free.push_back(counters);
+            }
+        }
+    };
+    thread_local CountersOwner t_Owner;
+    thread_local ThreadCounters* t_Counters = nullptr; ///< 毎回引く方はトリビアルな変数にして初期化の確認を省く
+
+    ThreadCounters* Register() noexcept
+    {
+        std::scoped_lock lock(g_Registry.mutex);
+        if (!g_Registry.free.empty())
+        {
+            ThreadCounters* counters = g_Registry.free.back();
+            g_Registry.free.pop_back();
+            return counters;
+        }
+        g_Registry.all.push_back(std::make_unique<ThreadCounters>());
+        return g_Registry.all.back().get();
+    }
+
+    // ファイバーで移るジョブから呼ばれるので毎回引き直す(理由は ThreadLocalAccess.h)
+    DRAMA_NOINLINE ThreadCounters* Current() noexcept
+    {
+        DRAMA_OPAQUE_BARRIER();
+        ThreadCounters*& counters = t_Counters;
+        if (!counters)
+        {
+            counters = Register();
+            t_Owner.counters = counters;
+        }
+        return counters;
+    }
+
+    void Merge(std::array<TagStats, kMemoryTagCount>& stats) noexcept
+    {
+        std::array<int64_t, kMemoryTagCount> bytes{};
+        std::array<uint64_t, kMemoryTagCount> allocations{};
+        std::array<uint64_t, kMemoryTagCount> frees{};
+        {
+            std::scoped_lock lock(g_Registry.mutex);
+            for (const auto& counters : g_Registry.all)
+            {
+                for (size_t t = 0; t < kMemoryTagCount; ++t)
+                {
+                    bytes[t] += counters->bytes[t].load(std::memory_order_relaxed);
+                    allocations[t] += counters->allocations[t].load(std::memory_order_relaxed);
+                    frees[t] += counters->frees[t].load(std::memory_order_relaxed);
+                }
+            }
+        }
+        for (size_t t = 0; t < kMemoryTagCount; ++t)
+        {
+            TagStats& s = stats[t];
+            s.liveBytes = bytes[t];
+            s.allocations = allocations[t];
+            s.frees = frees[t];
+            s.peakBytes = std::max(s.peakBytes, s.liveBytes);
+            s.budgetBytes = g_Budgets[t].load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief 新たに予算を超えた用途(通知はロックを離してから行うので、いったん貯める)
+    struct BudgetNotices
+    {
+        struct Notice
+        {
+            MemoryTag tag = MemoryTag::Unknown;
+            int64_t liveBytes = 0;
+            int64_t budgetBytes = 0;
+        };
+        std::array<Notice, kMemoryTagCount> items{};
+        size_t count = 0;
+    };
+
+    /// @brief Merge の後で予算を確かめ、新たに超えた用途を notices に貯める(g_Totals.mutex を持った状態で呼ぶ)
+    void CheckBudgets(BudgetNotices& notices) noexcept
+    {
+        for (size_t t = 0; t < kMemoryTagCount; ++t)
+        {
+            const TagStats& s = g_Totals.stats[t];
+            const bool over = s.budgetBytes > 0 && s.liveBytes > s.budgetBytes;
+            if (over && !g_Totals.overBudget[t])
+            {
+                notices.items[notices.count++] = { static_cast<MemoryTag>(t), s.liveBytes, s.budgetBytes };
+            }
+            g_Totals.overBudget[t] = over;
+        }
+    }
+
+    /// @brief 貯めた通知を送る(g_Totals.mutex を離してから呼ぶ。通知先から Stats や Capture を呼んでもよい)
+    void NotifyBudgets(const BudgetNotices& notices) noexcept
+    {
+        const BudgetHandler handler = g_BudgetHandler.load(std::memory_order_acquire);
+        if (!handler)
+        {
+            return;
+        }
+        for (size_t i = 0; i < notices.count; ++i)
+        {
+            handler(notices.items[i].tag, notices.items[i].liveBytes, notices.items[i].budgetBytes);
+        }
+    }
+}
+#endif
+
+namespace Drama::Core::Memory
+{
+    const char* TagName(MemoryTag tag) noexcept
+    {
+        switch (tag)
+        {
+        case MemoryTag::Unknown: return "Unknown";
+        case MemoryTag::Log: return "Log";
+        case MemoryTag::IO: return "IO";
+        case MemoryTag::Assets: return "Assets";
+        case MemoryTag::Frame: return "Frame";
+        case MemoryTag::Pool: return "Pool";
+        case MemoryTag::Job: return "Job";
+        case MemoryTag::Render: return "Render";
+        case MemoryTag::Ecs: return "Ecs";
+        default: return "?";
+        }
+    }
+
+#if DRAMA_MEMORY_TRACKING
+    void MemoryTracker::RecordAllocation(MemoryTag tag, const void* address, size_t size) noexcept
+    {
+        if (g_IsTornDown.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        const size_t t = static_cast<size_t>(tag);
+        if (ThreadCounters* counters = Current())
+        {
+            Add(counters->bytes[t], size);
+            Add(counters->allocations[t], 1);
+        }
+        if (g_RecordsEnabled.load(std::memory_order_relaxed) && address)
+        {
+            // 記録用の表自体の確保は追跡しない(ここからは RecordAllocation を呼ばない)
+            std::scoped_lock lock(g_Records.mutex);
+            AllocationRecord record{};
+            record.address = address;
+            record.size = size;
+            record.tag = tag;
+            record.sequence = ++g_Records.sequence;
+            record.frame = g_Frame.load(std::memory_order_relaxed);
+            if (!g_Records.live.Assign(record))
+            {
+                ++g_Records.dropped;
+            }
+            g_RecordCount.store(g_Records.live.Size(), std::memory_order_relaxed);
+        }
+    }
+
+    void MemoryTracker::RecordFree(MemoryTag tag, const void* address, size_t size) noexcept
+    {
+        if (g_IsTornDown.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        const size_t t = static_cast<size_t>(tag);
+        if (ThreadCounters* counters = Current())
+        {
+            Add(counters->bytes[t], -static_cast<int64_t>(size));
+            Add(counters->frees[t], 1);
+        }
+        // 記録を止めた後も、記録済みのものが解放されたら消す(残すと誤ってリークに見える)
+        if (address && g_RecordCount.load(std::memory_order_relaxed) != 0)
+        {
+            std::scoped_lock lock(g_Records.mutex);
+            g_Records.live.Erase(address);
+            g_RecordCount.store(g_Records.live.Size(), std::memory_order_relaxed);
+        }
+    }
+
+    void MemoryTracker::Update(uint64_t frameIndex) noexcept
+    {
+        g_Frame.store(frameIndex, std::memory_order_relaxed);
+        BudgetNotices notices;
+        {
+            std::scoped_lock lock(g_Totals.mutex);
+            Merge(g_Totals.stats);
+            CheckBudgets(notices);
+        }
+        NotifyBudgets(notices);
+    }
+
+    TagStats MemoryTracker::Stats(MemoryTag tag) noexcept
+    {
+        std::scoped_lock lock(g_Totals.mutex);
+        return g_Totals.stats[static_cast<size_t>(tag)];
+    }
+
+    void MemoryTracker::SetBudget(MemoryTag tag, int64_t bytes) noexcept
+    {
+        g_Budgets[static_cast<size_t>(tag)].store(std::max<int64_t>(bytes, 0), std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::SetBudgetHandler(BudgetHandler handler) noexcept
+    {
+        g_BudgetHandler.store(handler, std::memory_order_release);
+    }
+
+    void MemoryTracker::EnableAllocationRecords(bool enable) noexcept
+    {
+        g_RecordsEnabled.store(enable, std::memory_order_relaxed);
+    }
+
+    MemorySnapshot MemoryTracker::Capture()
+    {
+        MemorySnapshot snapshot{};
+        snapshot.frame = g_Frame.load(std::memory_order_relaxed);
+        BudgetNotices notices;
+        {
+            std::scoped_lock lock(g_Totals.mutex);
+            Merge(g_Totals.stats);
+            CheckBudgets(notices);
+            snapshot.tags = g_Totals.stats;
+        }
+        NotifyBudgets(notices);
+        {
+            std::scoped_lock lock(g_Records.mutex);
+            snapshot.sequence = g_Records.sequence;
+            snapshot.droppedRecords = g_Records.dropped;
+            snapshot.records.reserve(g_Records.live.Size());
+            g_Records.live.ForEach([&snapshot](const AllocationRecord& record) { snapshot.records.push_back(record); });
+        }
+        std::sort(snapshot.records.begin(), snapshot.records.end(),
+            [](const AllocationRecord& a, const AllocationRecord& b) { return a.sequence < b.sequence; });
+        return snapshot;
+    }
+#endif
+
+    MemoryDiff MemoryTracker::Diff(const MemorySnapshot& before, const MemorySnapshot& after)
+    {
+        MemoryDiff diff{};
+        for (size_t t = 0; t < kMemoryTagCount; ++t)
+        {
+            const TagStats& b = before.tags[t];
+            const TagStats& a = after.tags[t];
+            diff.liveBytesDelta[t] = a.liveBytes - b.liveBytes;
+            diff.allocationDelta[t] = static_cast<int64_t>(a.allocations - a.frees) - static_cast<int64_t>(b.allocations - b.frees);
+        }
+        // after の記録は通し番号順なので、before より後の分は末尾にまとまっている
+        const auto first = std::upper_bound(after.records.begin(), after.records.end(), before.sequence,
+            [](uint64_t sequence, const AllocationRecord& r) { return sequence < r.sequence; });
+        diff.leaked.assign(first, after.records.end());
+        return diff;
+    }
+}
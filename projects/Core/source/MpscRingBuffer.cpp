@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "include/MpscRingBuffer.h"
+
+// C++ standard library includes
+#include <cstring>
+
+namespace Drama::Core
+{
+    MpscRingBuffer::~MpscRingBuffer()
+    {
+        ReleaseSlots();
+    }
+
+    void MpscRingBuffer::ReleaseSlots() noexcept
+    {
+        if (m_Slots)
+        {
+            Memory::MemoryTracker::RecordFree(m_Tag, m_Slots.get(), static_cast<size_t>(m_Capacity) * kSlotSize);
+            m_Slots.reset();
+        }
+    }
+
+    bool MpscRingBuffer::Init(size_t slotCount, Memory::MemoryTag tag)
+    {
+        if (slotCount < 2)
+        {
+            slotCount = 2;
+        }
+        uint64_t capacity = 1;
+        while (capacity < slotCount)
+        {
+            capacity <<= 1;
+        }
+
+        // 再開時は同じ容量なら確保し直さず、スロットを空に戻すだけにする
+        if (!m_Slots || m_Capacity != capacity || m_Tag != tag)
+        {
+            ReleaseSlots();
+            m_Slots = std::make_unique<Slot[]>(static_cast<size_t>(capacity));
+            m_Tag = tag;
+            Memory::MemoryTracker::RecordAllocation(m_Tag, m_Slots.get(), static_cast<size_t>(capacity) * kSlotSize);
+        }
+        m_Capacity = capacity;
+        m_Mask = capacity - 1;
+        for (uint64_t i = 0; i < capacity; ++i)
+        {
+            m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_EnqueuePos.store(0, std::memory_order_relaxed);
+        m_DequeuePos.store(0, std::memory_order_release);
+        return true;
+    }
+
+    bool MpscRingBuffer::TryPush(const void* data, size_t size) noexcept
+    {
+        if (!m_Slots || (size > 0 && data == nullptr))
+        {
+            return false;
+        }
+        const uint64_t need = SlotsFor(size);
+        if (need > m_Capacity)
+        {
+            return false;
+        }
+
+        // 末尾スロットが今周回で空いていれば、消費者は順に解放するので手前も全て空いている。
+        uint64_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const uint64_t last = pos + need - 1;
+            const uint64_t seq = m_Slots[last & m_Mask].sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(last);
+            if (diff == 0)
+            {
+                if (m_EnqueuePos.compare_exchange_weak(pos, pos + need, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 満杯
+            }
+            else
+            {
+                pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        const char* src = static_cast<const char*>(data);
+        size_t remaining = size;
+        for (uint64_t i = 0; i < need; ++i)
+        {
+            Slot& slot = m_Slots[(pos + i) & m_Mask];
+            const size_t chunk = (remaining > kSlotPayload) ? kSlotPayload : remaining;
+            if (chunk > 0)
+            {
+                std::memcpy(slot.bytes, src, chunk);
+            }
+            slot.size = chunk;
+            slot.sequence.store(pos + i + 1, std::memory_order_release);
+            src += chunk;
+            remaining -= chunk;
+        }
+        return true;
+    }
+}
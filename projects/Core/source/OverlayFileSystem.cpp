@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "include/OverlayFileSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <span>
+#include "include/ArchiveFileSystem.h"
+#include "include/PackFormat.h"
+
+namespace Drama::Core::IO
+{
+    OverlayFileSystem::OverlayFileSystem(IFileSystem& loose)
+        : m_Loose(loose), m_LooseRoot(loose.currentPath())
+    {
+    }
+
+    void OverlayFileSystem::Mount(ArchiveFileSystem& archive)
+    {
+        m_Archives.push_back(&archive);
+    }
+
+    void OverlayFileSystem::Unmount(ArchiveFileSystem& archive) noexcept
+    {
+        m_Archives.erase(std::remove(m_Archives.begin(), m_Archives.end(), &archive), m_Archives.end());
+    }
+
+    ArchiveFileSystem* OverlayFileSystem::FindArchive(std::string_view path, std::string_view& relative) noexcept
+    {
+        if (m_Archives.empty() || path.empty())
+        {
+            return nullptr;
+        }
+        relative = Pack::StripRoot(path, m_LooseRoot);
+        std::span<const uint8_t> unused;
+        for (auto it = m_Archives.rbegin(); it != m_Archives.rend(); ++it)
+        {
+            if ((*it)->Find(relative, unused))
+            {
+                return *it;
+            }
+        }
+        return nullptr;
+    }
+
+    FsResult OverlayFileSystem::Exists(std::string_view path) noexcept
+    {
+        std::string_view relative;
+        if (FindArchive(path, relative) != nullptr)
+        {
+            return FsResult::Ok();
+        }
+        return m_Loose.Exists(path);
+    }
+
+    FsResult OverlayFileSystem::CreateDirectories(std::string_view path) noexcept
+    {
+        return m_Loose.CreateDirectories(path);
+    }
+
+    FsResult OverlayFileSystem::Remove(std::string_view path) noexcept
+    {
+        // アーカイブ側は読み取り専用なので、消せるのはルーズファイルだけ
+        return m_Loose.Remove(path);
+    }
+
+    FsResult OverlayFileSystem::LastWriteTime(std::string_view path, uint64_t& outNs) noexcept
+    {
+        // アーカイブの中身は更新時刻を持たないので、ルーズファイルだけ調べる
+        return m_Loose.LastWriteTime(path, outNs);
+    }
+
+    FsResult OverlayFileSystem::WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept
+    {
+        return m_Loose.WriteAllBytes(path, data, size);
+    }
+
+    FsResult OverlayFileSystem::ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept
+    {
+        std::string_view relative;
+        if (ArchiveFileSystem* archive = FindArchive(path, relative))
+        {
+            return archive->ReadAllBytes(relative, out);
+        }
+        return m_Loose.ReadAllBytes(path, out);
+    }
+
+    FsResult OverlayFileSystem::MapReadOnly(std::string_view path, MappedFile& out) noexcept
+    {
+        std::string_view relative;
+        if (ArchiveFileSystem* archive = FindArchive(path, relative))
+        {
+            return archive->MapReadOnly(relative, out);
+        }
+        return m_Loose.MapReadOnly(path, out);
+    }
+
+    FsResult OverlayFileSystem::AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept
+    {
+        return m_Loose.AppendAllBytes(path, data, size);
+    }
+
+    FsResult OverlayFileSystem::WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept
+    {
+        return m_Loose.WriteAllBytesAtomic(path, data, size);
+    }
+
+    FsResult OverlayFileSystem::OpenRead(std::string_view path, std::unique_ptr<IFileReader>& out) noexcept
+    {
+        std::string_view relative;
+        if (ArchiveFileSystem* archive = FindArchive(path, relative))
+        {
+            return archive->OpenRead(relative, out);
+        }
+        return m_Loose.OpenRead(path, out);
+    }
+
+    FsResult OverlayFileSystem::OpenWrite(std::string_view path, FileWriteMode mode, std::unique_ptr<IFileWriter>& out) noexcept
+    {
+        return m_Loose.OpenWrite(path, mode, out);
+    }
+}
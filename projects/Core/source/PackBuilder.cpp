@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "include/PackBuilder.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <memory>
+#include "include/PackFormat.h"
+
+namespace Drama::Core::IO
+{
+    bool PackBuilder::Add(std::string_view virtualPath, std::string_view sourcePath)
+    {
+        std::string normalized(Pack::TrimPathPrefix(virtualPath));
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        if (normalized.empty())
+        {
+            return false;
+        }
+        for (const Source& s : m_Sources)
+        {
+            if (s.virtualPath == normalized)
+            {
+                return false;
+            }
+        }
+        m_Sources.push_back(Source{ std::move(normalized), std::string(sourcePath) });
+        return true;
+    }
+
+    FsResult PackBuilder::Build(IFileSystem& fs, std::string_view outPath) const
+    {
+        struct Item
+        {
+            const Source* source;
+            Pack::PackEntry entry;
+        };
+
+        // 1) 大きさを調べ、ハッシュ順に並べる
+        std::vector<Item> items;
+        items.reserve(m_Sources.size());
+        uint64_t stringBytes = 0;
+        for (const Source& s : m_Sources)
+        {
+            std::unique_ptr<IFileReader> reader;
+            if (FsResult r = fs.OpenRead(s.sourcePath, reader); !r)
+            {
+                return r;
+            }
+            Item item{ &s, {} };
+            item.entry.pathHash = Pack::HashPath(s.virtualPath);
+            if (FsResult r = reader->Size(item.entry.size); !r)
+            {
+                return r;
+            }
+            item.entry.pathSize = static_cast<uint32_t>(s.virtualPath.size());
+            stringBytes += s.virtualPath.size();
+            items.push_back(item);
+        }
+        std::sort(items.begin(), items.end(), [](const Item& a, const Item& b)
+            {
+                if (a.entry.pathHash != b.entry.pathHash)
+                {
+                    return a.entry.pathHash < b.entry.pathHash;
+                }
+                return a.source->virtualPath < b.source->virtualPath;
+            });
+
+        // 2) 配置を決める
+        Pack::PackHeader header{};
+        header.entryCount = static_cast<uint32_t>(items.size());
+        header.entryTableOffset = sizeof(Pack::PackHeader);
+        header.stringTableOffset = header.entryTableOffset + sizeof(Pack::PackEntry) * items.size();
+        header.stringTableSize = stringBytes;
+        header.dataOffset = Pack::AlignUp(header.stringTableOffset + stringBytes, Pack::kAlignment);
+
+        uint32_t pathOffset = 0;
+        uint64_t dataOffset = header.dataOffset;
+        for (Item& item : items)
+        {
+            item.entry.pathOffset = pathOffset;
+            pathOffset += item.entry.pathSize;
+            item.entry.dataOffset = dataOffset;
+            dataOffset = Pack::AlignUp(dataOffset + item.entry.size, Pack::kAlignment);
+        }
+
+        // 3) 書き出す(本体は固定サイズのバッファで流す)
+        std::unique_ptr<IFileWriter> writer;
+        if (FsResult r = fs.OpenWrite(outPath, FileWriteMode::Truncate, writer); !r)
+        {
+            return r;
+        }
+
+        std::vector<WriteSlice> slices;
+        slices.reserve(1 + items.size() * 2);
+        slices.push_back({ &header, sizeof(header) });
+        for (const Item& item : items)
+        {
+            slices.push_back({ &item.entry, sizeof(item.entry) });
+        }
+        for (const Item& item : items)
+        {
+            slices.push_back({ item.source->virtualPath.data(), item.source->virtualPath.size() });
+        }
+        if (FsResult r = writer->WriteV(slices); !r)
+        {
+            return r;
+        }
+
+        static const uint8_t kZeros[Pack::kAlignment] = {};
+        std::vector<uint8_t> buffer(1024 * 1024);
+        for (const Item& item : items)
+        {
+            const uint64_t pad = item.entry.dataOffset - writer->Tell();
+            if (FsResult r = writer->Write(kZeros, static_cast<size_t>(pad)); !r)
+            {
+                return r;
+            }
+
+            std::unique_ptr<IFileReader> reader;
+            if (FsResult r = fs.OpenRead(item.source->sourcePath, reader); !r)
+            {
+                return r;
+            }
+            uint64_t remaining = item.entry.size;
+            while (remaining > 0)
+            {
+                size_t n = 0;
+                const size_t want = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+                if (FsResult r = reader->Read(buffer.data(), want, n); !r)
+                {
+                    return r;
+                }
+                if (n == 0)
+                {
+                    FsResult r;
+                    r.error = FsError::IoError;
+                    r.message = "Source file shrank while packing: " + item.source->sourcePath;
+                    return r;
+                }
+                if (FsResult r = writer->Write(buffer.data(), n); !r)
+                {
+                    return r;
+                }
+                remaining -= n;
+            }
+        }
+
+        // 最後のファイルの後ろも揃えておく(連結しても境界が崩れないように)
+        const uint64_t tail = Pack::AlignUp(writer->Tell(), Pack::kAlignment) - writer->Tell();
+        return writer->Write(kZeros, static_cast<size_t>(tail));
+    }
+}
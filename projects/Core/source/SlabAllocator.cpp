@@ -0,0 +1,350 @@
+#include "pch.h"
+#include "include/SlabAllocator.h"
+#include "include/ThreadLocalAccess.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kMaxCachedThreads = 64; ///< 手元の空きを持てるスレッド数(超えたスレッドは共有の空きリストだけを使う)
+
+    /// @brief スレッドに配る枠番号。スレッドが終わると返され、次のスレッドが手元の空きごと引き継ぐ
+    /// @note 枠は同時に1スレッドしか持たないので、各確保器の手元の空きは持ち主だけが触ればよい。
+    ///       返された枠の手元の空きは次の持ち主が現れるまで残るので、確保器は尽きたときに
+    ///       ForEachIdle で持ち主のいない枠から回収する
+    class ThreadSlots final
+    {
+    public:
+        uint32_t Acquire()
+        {
+            std::scoped_lock lock(m_Mutex);
+            if (!m_Free.empty())
+            {
+                const uint32_t slot = m_Free.back();
+                m_Free.pop_back();
+                return slot;
+            }
+            return m_Next < kMaxCachedThreads ? m_Next++ : kMaxCachedThreads;
+        }
+        void Release(uint32_t slot)
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_Free.push_back(slot);
+        }
+        /// @brief 持ち主のいない枠を回る fn(uint32_t)
+        /// @note 回っている間は枠を配らないので、fn はその枠の手元の空きを持ち主として触ってよい
+        template <class F>
+        void ForEachIdle(F&& fn)
+        {
+            std::scoped_lock lock(m_Mutex);
+            for (const uint32_t slot : m_Free)
+            {
+                fn(slot);
+            }
+        }
+
+    private:
+        std::mutex m_Mutex;
+        std::vector<uint32_t> m_Free;
+        uint32_t m_Next = 0;
+    };
+    ThreadSlots g_ThreadSlots;
+
+    /// @brief スレッドの終了時に枠を返す
+    struct ThreadSlotOwner
+    {
+        uint32_t slot = kMaxCachedThreads;
+        ~ThreadSlotOwner()
+        {
+            if (slot < kMaxCachedThreads)
+            {
+                g_ThreadSlots.Release(slot);
+            }
+        }
+    };
+    thread_local ThreadSlotOwner t_SlotOwner;
+    thread_local uint32_t t_Slot = 0; ///< 枠番号 + 1(0 は未割り当て)。毎回引く方はトリビアルな変数にして初期化の確認を省く
+
+    // ファイバーで移るジョブから呼ばれるので毎回引き直す(理由は ThreadLocalAccess.h)
+    DRAMA_NOINLINE uint32_t CurrentThreadSlot() noexcept
+    {
+        DRAMA_OPAQUE_BARRIER();
+        uint32_t& slot = t_Slot;
+        if (slot == 0)
+        {
+            t_SlotOwner.slot = g_ThreadSlots.Acquire();
+            slot = t_SlotOwner.slot + 1;
+        }
+        return slot - 1;
+    }
+}
+
+namespace Drama::Core::Memory
+{
+    SlabAllocator::~SlabAllocator()
+    {
+        Shutdown();
+    }
+
+    bool SlabAllocator::Init(const SlabDesc& desc)
+    {
+        Shutdown();
+        if (desc.blockSize == 0 || desc.blockAlign == 0 || (desc.blockAlign & (desc.blockAlign - 1)) != 0 ||
+            desc.maxBlocks == 0 || desc.maxBlocks > SlabHandle::kMaxBlocks)
+        {
+            return false;
+        }
+        m_Align = std::max(desc.blockAlign, alignof(std::max_align_t));
+        m_Tag = desc.tag;
+        m_Stride = (desc.blockSize + desc.blockAlign - 1) & ~(desc.blockAlign - 1);
+        // スラブの大きさは番号の分解のために 2 の累乗へ切り上げるが、ブロック数は maxBlocks で止める
+        // (はみ出す分は最後のスラブを切り詰めて、作りも配りもしない)
+        m_BlocksPerSlab = std::bit_ceil(std::clamp<uint32_t>(desc.blocksPerSlab, 1, desc.maxBlocks));
+        m_SlabShift = static_cast<uint32_t>(std::countr_zero(m_BlocksPerSlab));
+        m_MaxBlocks = desc.maxBlocks;
+        m_MaxSlabs = (desc.maxBlocks + m_BlocksPerSlab - 1) / m_BlocksPerSlab;
+        m_Slabs = std::make_unique<std::atomic<Slab*>[]>(m_MaxSlabs);
+        m_Caches = std::make_unique<std::unique_ptr<ThreadCache>[]>(kMaxCachedThreads);
+        return Grow();
+    }
+
+    void SlabAllocator::Shutdown() noexcept
+    {
+        // 作り直した後のブロックは、ここまでに使ったどの世代よりも先から始める。
+        // そうしないと Shutdown 前のハンドルが、同じ番号に作り直したブロックへ届いてしまう
+        uint32_t lastGeneration = 0;
+        for (const std::unique_ptr<Slab>& slab : m_SlabStorage)
+        {
+            for (uint32_t i = 0; i < slab->blockCount; ++i)
+            {
+                lastGeneration = std::max(lastGeneration, slab->meta[i].state.load(std::memory_order_relaxed) >> 1);
+            }
+            MemoryTracker::RecordFree(m_Tag, slab->data, m_Stride * slab->blockCount);
+            ::operator delete(slab->data, std::align_val_t(m_Align));
+        }
+        if (!m_SlabStorage.empty())
+        {
+            m_FirstGeneration = std::max(1u, (lastGeneration + 1) & SlabHandle::kGenerationMask);
+        }
+        m_SlabStorage.clear();
+        m_Slabs.reset();
+        m_Caches.reset();
+        m_SlabCount.store(0, std::memory_order_relaxed);
+        m_MaxSlabs = 0;
+        m_MaxBlocks = 0;
+        m_FreeHead.store(kNoIndex, std::memory_order_relaxed);
+    }
+
+    bool SlabAllocator::Grow() noexcept
+    {
+        std::scoped_lock lock(m_GrowMutex);
+        // 待っている間に他のスレッドが足したか、解放があれば、それを使う
+        if (static_cast<uint32_t>(m_FreeHead.load(std::memory_order_acquire)) != kNoIndex)
+        {
+            return true;
+        }
+        const uint32_t count = m_SlabCount.load(std::memory_order_relaxed);
+        if (count >= m_MaxSlabs)
+        {
+            return false;
+        }
+
+        const uint32_t first = count << m_SlabShift;
+        auto slab = std::make_unique<Slab>();
+        slab->blockCount = std::min(m_BlocksPerSlab, m_MaxBlocks - first);
+        slab->meta = std::make_unique<BlockMeta[]>(slab->blockCount);
+        slab->data = static_cast<std::byte*>(::operator new(m_Stride * slab->blockCount, std::align_val_t(m_Align), std::nothrow));
+        if (!slab->data)
+        {
+            return false;
+        }
+        MemoryTracker::RecordAllocation(m_Tag, slab->data, m_Stride * slab->blockCount);
+
+        // スラブの中を番号順に繋いでから空きリストへ一度に積む(番号の若い順に配られ、連続して並ぶ)
+        for (uint32_t i = 0; i < slab->blockCount; ++i)
+        {
+            slab->meta[i].state.store(m_FirstGeneration << 1, std::memory_order_relaxed);
+            if (i + 1 < slab->blockCount)
+            {
+                slab->meta[i].next.store(first + i + 1, std::memory_order_relaxed);
+            }
+        }
+        const uint32_t last = first + slab->blockCount - 1;
+        m_Slabs[count].store(slab.get(), std::memory_order_release);
+        m_SlabStorage.push_back(std::move(slab));
+        m_SlabCount.store(count + 1, std::memory_order_release);
+        PushChain(first, last);
+        return true;
+    }
+
+    void SlabAllocator::PushChain(uint32_t first, uint32_t last) noexcept
+    {
+        BlockMeta& tail = Meta(last);
+        uint64_t head = m_FreeHead.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            tail.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            const uint64_t desired = (((head >> 32) + 1) << 32) | first;
+            if (m_FreeHead.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    SlabAllocator::ThreadCache* SlabAllocator::LocalCache() noexcept
+    {
+        const uint32_t slot = CurrentThreadSlot();
+        if (slot >= kMaxCachedThreads)
+        {
+            return nullptr;
+        }
+        std::unique_ptr<ThreadCache>& cache = m_Caches[slot];
+        if (!cache)
+        {
+            // 枠の持ち主は同時に1スレッドだけなので、作るのも自分だけ
+            cache = std::make_unique<ThreadCache>();
+        }
+        return cache.get();
+    }
+
+    bool SlabAllocator::ReclaimIdleCaches() noexcept
+    {
+        bool isReclaimed = false;
+        g_ThreadSlots.ForEachIdle([this, &isReclaimed](uint32_t slot)
+            {
+                ThreadCache* cache = m_Caches[slot].get();
+                if (!cache || cache->count == 0)
+                {
+                    return;
+                }
+                for (uint32_t i = 0; i + 1 < cache->count; ++i)
+                {
+                    Meta(cache->indices[i]).next.store(cache->indices[i + 1], std::memory_order_relaxed);
+                }
+                PushChain(cache->indices[0], cache->indices[cache->count - 1]);
+                cache->count = 0;
+                isReclaimed = true;
+            });
+        return isReclaimed;
+    }
+
+    SlabHandle SlabAllocator::Claim(uint32_t index, void** outBlock) const noexcept
+    {
+        const Slab* slab = m_Slabs[index >> m_SlabShift].load(std::memory_order_acquire);
+        const uint32_t local = index & (m_BlocksPerSlab - 1);
+        BlockMeta& meta = slab->meta[local];
+        const uint32_t generation = meta.state.load(std::memory_order_relaxed) >> 1;
+        meta.state.store((generation << 1) | kAlive, std::memory_order_release);
+        if (outBlock)
+        {
+            *outBlock = slab->data + local * m_Stride;
+        }
+        return SlabHandle::Make(index, generation);
+    }
+
+    SlabHandle SlabAllocator::Allocate(void** outBlock) noexcept
+    {
+        if (m_MaxSlabs == 0)
+        {
+            return {};
+        }
+        // 手元に空きがあれば共有の空きリストに触らない
+        ThreadCache* cache = LocalCache();
+        if (cache && cache->count > 0)
+        {
+            return Claim(cache->indices[--cache->count], outBlock);
+        }
+
+        uint64_t head = m_FreeHead.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const uint32_t index = static_cast<uint32_t>(head);
+            if (index == kNoIndex)
+            {
+                // スラブを足せなければ、終わったスレッドの手元に残った空きを戻してから諦める
+                if (!Grow() && !ReclaimIdleCaches())
+                {
+                    return {};
+                }
+                head = m_FreeHead.load(std::memory_order_acquire);
+                continue;
+            }
+            // 取り出す前に他のスレッドが先に取って next を書き換えていても、タグが変わっているので CAS は失敗する
+            const uint32_t next = Meta(index).next.load(std::memory_order_relaxed);
+            const uint64_t desired = (((head >> 32) + 1) << 32) | next;
+            if (m_FreeHead.compare_exchange_weak(head, desired, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return Claim(index, outBlock);
+            }
+        }
+    }
+
+    bool SlabAllocator::Free(SlabHandle handle, void (*destroy)(void*)) noexcept
+    {
+        const uint32_t index = handle.Index();
+        if (!handle.IsValid() || index >= Capacity())
+        {
+            return false;
+        }
+        // 生存→空きの遷移を CAS で取った1スレッドだけが破棄と返却を行う(二重解放は失敗する)
+        const Slab* slab = m_Slabs[index >> m_SlabShift].load(std::memory_order_acquire);
+        const uint32_t local = index & (m_BlocksPerSlab - 1);
+        BlockMeta& meta = slab->meta[local];
+        uint32_t expected = (handle.Generation() << 1) | kAlive;
+        uint32_t nextGeneration = (handle.Generation() + 1) & SlabHandle::kGenerationMask;
+        if (nextGeneration == 0)
+        {
+            nextGeneration = 1;
+        }
+        if (!meta.state.compare_exchange_strong(expected, nextGeneration << 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        if (destroy)
+        {
+            destroy(slab->data + local * m_Stride);
+        }
+
+        ThreadCache* cache = LocalCache();
+        if (!cache)
+        {
+            PushChain(index, index);
+            return true;
+        }
+        if (cache->count == ThreadCache::kCapacity)
+        {
+            // 溢れたら古い方の半分を繋いで共有の空きリストへ戻す(他のスレッドが使えるように)
+            constexpr uint32_t kKeep = ThreadCache::kCapacity / 2;
+            for (uint32_t i = 0; i + 1 < kKeep; ++i)
+            {
+                Meta(cache->indices[i]).next.store(cache->indices[i + 1], std::memory_order_relaxed);
+            }
+            PushChain(cache->indices[0], cache->indices[kKeep - 1]);
+            std::copy(cache->indices + kKeep, cache->indices + ThreadCache::kCapacity, cache->indices);
+            cache->count -= kKeep;
+        }
+        cache->indices[cache->count++] = index;
+        return true;
+    }
+
+    void* SlabAllocator::Resolve(SlabHandle handle) const noexcept
+    {
+        const uint32_t index = handle.Index();
+        if (!handle.IsValid() || index >= Capacity())
+        {
+            return nullptr;
+        }
+        const Slab* slab = m_Slabs[index >> m_SlabShift].load(std::memory_order_acquire);
+        const uint32_t local = index & (m_BlocksPerSlab - 1);
+        if (slab->meta[local].state.load(std::memory_order_acquire) != ((handle.Generation() << 1) | kAlive))
+        {
+            return nullptr;
+        }
+        return slab->data + local * m_Stride;
+    }
+}
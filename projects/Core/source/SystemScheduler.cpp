@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "include/SystemScheduler.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <utility>
+
+namespace Drama::Core::Ecs
+{
+    uint32_t SystemScheduler::AddSystem(std::string name, const ComponentAccess& access, SystemFunction fn)
+    {
+        System system{};
+        system.name = std::move(name);
+        system.access = access;
+        system.fn = std::move(fn);
+        system.commands = std::make_unique<CommandBuffer>();
+        m_Systems.push_back(std::move(system));
+        m_Dirty = true;
+        return static_cast<uint32_t>(m_Systems.size() - 1);
+    }
+
+    void SystemScheduler::BuildPhases()
+    {
+        // 前に登録した競合相手のうち、最も後ろの段の次に置く
+        m_Phases.clear();
+        for (size_t j = 0; j < m_Systems.size(); ++j)
+        {
+            uint32_t phase = 0;
+            for (size_t i = 0; i < j; ++i)
+            {
+                if (m_Systems[i].access.ConflictsWith(m_Systems[j].access))
+                {
+                    phase = std::max(phase, m_Systems[i].phase + 1);
+                }
+            }
+            m_Systems[j].phase = phase;
+            if (m_Phases.size() <= phase)
+            {
+                m_Phases.resize(phase + 1);
+            }
+            m_Phases[phase].push_back(static_cast<uint32_t>(j));
+        }
+        m_Dirty = false;
+    }
+
+    size_t SystemScheduler::PhaseCount()
+    {
+        if (m_Dirty)
+        {
+            BuildPhases();
+        }
+        return m_Phases.size();
+    }
+
+    uint32_t SystemScheduler::PhaseOf(uint32_t system)
+    {
+        if (m_Dirty)
+        {
+            BuildPhases();
+        }
+        return m_Systems[system].phase;
+    }
+
+    void SystemScheduler::Run(World& world, Job::JobSystem& jobs, double deltaSeconds)
+    {
+        if (m_Dirty)
+        {
+            BuildPhases();
+        }
+        for (const std::vector<uint32_t>& phase : m_Phases)
+        {
+            // 1つだけの段はジョブにせずそのまま呼ぶ(中で ParallelFor すればワーカーは使われる)
+            if (phase.size() == 1)
+            {
+                System& system = m_Systems[phase[0]];
+                SystemContext context{ world, *system.commands, jobs, deltaSeconds };
+                system.fn(context);
+                continue;
+            }
+            Job::JobCounter counter;
+            for (const uint32_t index : phase)
+            {
+                System* system = &m_Systems[index];
+                jobs.Run(counter, [system, &world, &jobs, deltaSeconds]()
+                    {
+                        SystemContext context{ world, *system->commands, jobs, deltaSeconds };
+                        system->fn(context);
+                    });
+            }
+            jobs.Wait(counter);
+        }
+        // 構造の変更は全システムが終わってから、登録順に反映する
+        for (System& system : m_Systems)
+        {
+            if (!system.commands->Empty())
+            {
+                world.Playback(*system.commands);
+            }
+        }
+    }
+}
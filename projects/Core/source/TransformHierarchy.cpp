@@ -0,0 +1,594 @@
+#include "pch.h"
+#include "include/TransformHierarchy.h"
+#include "include/JobSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <utility>
+
+namespace Drama::Core::Scene
+{
+    namespace
+    {
+        /// @brief 1ジョブで計算するノード数
+        constexpr uint32_t kBatchSize = 1024;
+        /// @brief 段の中でこの割合を超えて計算するなら、リストを引くより段を頭から順に舐める方が速い(飛び飛びの読み込みを避ける)
+        constexpr uint32_t kDenseDivisor = 4;
+    }
+
+    const TransformHierarchy::Slot* TransformHierarchy::Resolve(TransformNode node) const noexcept
+    {
+        if (node.index >= m_Slots.size())
+        {
+            return nullptr;
+        }
+        const Slot& slot = m_Slots[node.index];
+        return slot.index != kNone && slot.generation == node.generation ? &slot : nullptr;
+    }
+
+    bool TransformHierarchy::IsAlive(TransformNode node) const noexcept
+    {
+        return Resolve(node) != nullptr;
+    }
+
+    uint32_t TransformHierarchy::IndexOf(TransformNode node) const noexcept
+    {
+        const Slot* slot = Resolve(node);
+        return slot ? slot->index : kNone;
+    }
+
+    TransformNode TransformHierarchy::Create(TransformNode parent, const Math::Float4x4& local)
+    {
+        uint32_t parentSlot = kNone;
+        uint32_t depth = 0;
+        if (parent.IsValid())
+        {
+            const Slot* p = Resolve(parent);
+            if (!p)
+            {
+                return {};
+            }
+            parentSlot = parent.index;
+            depth = p->depth + 1;
+        }
+
+        uint32_t slot = m_FreeSlot;
+        if (slot != kNone)
+        {
+            m_FreeSlot = m_Slots[slot].nextFree;
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(m_Slots.size());
+            m_Slots.emplace_back();
+        }
+
+        // 末尾(一番深い段)に足してから目的の段へ移す
+        const uint32_t index = static_cast<uint32_t>(m_Local.size());
+        m_Local.push_back(local);
+        m_World.push_back(local);
+        m_Parent.push_back(kNone);
+        m_SlotOf.push_back(slot);
+        m_State.push_back(kClean);
+        m_Stamp.push_back(0);
+        if (m_LevelBegin.empty())
+        {
+            m_LevelBegin.push_back(0);
+        }
+        Slot& s = m_Slots[slot];
+        s.index = index;
+        s.depth = LevelCount() - 1;
+        s.parent = kNone;
+        s.firstChild = kNone;
+        s.nextFree = kNone;
+        if (parentSlot != kNone)
+        {
+            LinkChild(parentSlot, slot);
+        }
+        MoveToLevel(index, depth);
+        MarkDirty(m_Slots[slot].index);
+        return TransformNode{ slot, m_Slots[slot].generation };
+    }
+
+    bool TransformHierarchy::Destroy(TransformNode node)
+    {
+        if (!Resolve(node))
+        {
+            return false;
+        }
+        // 深い方から消せば、消すノードはいつも葉になる
+        CollectSubtree(node.index, m_Scratch);
+        for (auto it = m_Scratch.rbegin(); it != m_Scratch.rend(); ++it)
+        {
+            RemoveLeaf(*it);
+        }
+        m_Scratch.clear();
+        TrimLevels();
+        return true;
+    }
+
+    void TransformHierarchy::RemoveLeaf(uint32_t slot) noexcept
+    {
+        UnlinkChild(slot);
+        // 一番深い段へ移し、配列の末尾と入れ替えて取り除く
+        uint32_t index = MoveToLevel(m_Slots[slot].index, LevelCount() - 1);
+        const uint32_t last = NodeCount() - 1;
+        SwapNodes(index, last);
+        m_Local.pop_back();
+        m_World.pop_back();
+        m_Parent.pop_back();
+        m_SlotOf.pop_back();
+        m_State.pop_back();
+        m_Stamp.pop_back();
+        TrimLevels();
+
+        Slot& s = m_Slots[slot];
+        s.index = kNone;
+        s.parent = kNone;
+        s.firstChild = kNone;
+        s.prevSibling = kNone;
+        s.nextSibling = kNone;
+        // 世代が一周して 0(無効)にならないようにする
+        s.generation = s.generation + 1 == 0 ? 1 : s.generation + 1;
+        s.nextFree = m_FreeSlot;
+        m_FreeSlot = slot;
+    }
+
+    bool TransformHierarchy::SetParent(TransformNode node, TransformNode parent, bool keepWorld)
+    {
+        const Slot* s = Resolve(node);
+        if (!s)
+        {
+            return false;
+        }
+        uint32_t newDepth = 0;
+        if (parent.IsValid())
+        {
+            const Slot* p = Resolve(parent);
+            if (!p)
+            {
+                return false;
+            }
+            // 自分の子孫の下には付けられない(親をたどって自分に行き着くか)
+            for (uint32_t a = parent.index; a != kNone; a = m_Slots[a].parent)
+            {
+                if (a == node.index)
+                {
+                    return false;
+                }
+            }
+            newDepth = p->depth + 1;
+        }
+
+        if (keepWorld)
+        {
+            const uint32_t index = s->index;
+            m_Local[index] = parent.IsValid() ? Math::Multiply(m_World[index], Math::Inverse(m_World[m_Slots[parent.index].index])) : m_World[index];
+        }
+
+        UnlinkChild(node.index);
+        if (parent.IsValid())
+        {
+            LinkChild(parent.index, node.index);
+        }
+        else
+        {
+            m_Parent[m_Slots[node.index].index] = kNone;
+        }
+
+        // 深さが変わるなら部分木ごと段を移す。親より先に子を動かしても、最後に段がそろえば並びは正しい
+        const int64_t delta = static_cast<int64_t>(newDepth) - static_cast<int64_t>(m_Slots[node.index].depth);
+        if (delta != 0)
+        {
+            CollectSubtree(node.index, m_Scratch);
+            for (const uint32_t slot : m_Scratch)
+            {
+                MoveToLevel(m_Slots[slot].index, static_cast<uint32_t>(static_cast<int64_t>(m_Slots[slot].depth) + delta));
+            }
+            m_Scratch.clear();
+            TrimLevels();
+        }
+        MarkDirty(m_Slots[node.index].index);
+        return true;
+    }
+
+    TransformNode TransformHierarchy::Parent(TransformNode node) const noexcept
+    {
+        const Slot* s = Resolve(node);
+        if (!s || s->parent == kNone)
+        {
+            return {};
+        }
+        return TransformNode{ s->parent, m_Slots[s->parent].generation };
+    }
+
+    bool TransformHierarchy::SetLocal(TransformNode node, const Math::Float4x4& local) noexcept
+    {
+        const Slot* s = Resolve(node);
+        if (!s)
+        {
+            return false;
+        }
+        m_Local[s->index] = local;
+        MarkDirty(s->index);
+        return true;
+    }
+
+    bool TransformHierarchy::SetLocal(TransformNode node, Math::Float3 scale, Math::Quaternion rotation, Math::Float3 translation) noexcept
+    {
+        return SetLocal(node, Math::Compose(scale, rotation, translation));
+    }
+
+    const Math::Float4x4* TransformHierarchy::Local(TransformNode node) const noexcept
+    {
+        const Slot* s = Resolve(node);
+        return s ? &m_Local[s->index] : nullptr;
+    }
+
+    const Math::Float4x4* TransformHierarchy::World(TransformNode node) const noexcept
+    {
+        const Slot* s = Resolve(node);
+        return s ? &m_World[s->index] : nullptr;
+    }
+
+    void TransformHierarchy::Clear() noexcept
+    {
+        m_Local.clear();
+        m_World.clear();
+        m_Parent.clear();
+        m_SlotOf.clear();
+        m_State.clear();
+        m_Stamp.clear();
+        m_LevelBegin.clear();
+        m_Pending.clear();
+        // 番号は世代を上げて使い回す(古いハンドルを無効にする)
+        m_FreeSlot = kNone;
+        for (uint32_t i = static_cast<uint32_t>(m_Slots.size()); i-- > 0;)
+        {
+            Slot& s = m_Slots[i];
+            if (s.index != kNone)
+            {
+                s.generation = s.generation + 1 == 0 ? 1 : s.generation + 1;
+            }
+            s = Slot{ kNone, s.generation, 0, kNone, kNone, kNone, kNone, m_FreeSlot };
+            m_FreeSlot = i;
+        }
+    }
+
+    void TransformHierarchy::MarkDirty(uint32_t index)
+    {
+        if (m_State[index] == kClean)
+        {
+            m_State[index] = kPending;
+            m_Pending.push_back(m_SlotOf[index]);
+        }
+    }
+
+    void TransformHierarchy::LinkChild(uint32_t parentSlot, uint32_t slot) noexcept
+    {
+        Slot& p = m_Slots[parentSlot];
+        Slot& s = m_Slots[slot];
+        s.parent = parentSlot;
+        s.prevSibling = kNone;
+        s.nextSibling = p.firstChild;
+        if (p.firstChild != kNone)
+        {
+            m_Slots[p.firstChild].prevSibling = slot;
+        }
+        p.firstChild = slot;
+        m_Parent[s.index] = p.index;
+    }
+
+    void TransformHierarchy::UnlinkChild(uint32_t slot) noexcept
+    {
+        Slot& s = m_Slots[slot];
+        if (s.parent == kNone)
+        {
+            return;
+        }
+        if (s.prevSibling != kNone)
+        {
+            m_Slots[s.prevSibling].nextSibling = s.nextSibling;
+        }
+        else
+        {
+            m_Slots[s.parent].firstChild = s.nextSibling;
+        }
+        if (s.nextSibling != kNone)
+        {
+            m_Slots[s.nextSibling].prevSibling = s.prevSibling;
+        }
+        s.parent = kNone;
+        s.prevSibling = kNone;
+        s.nextSibling = kNone;
+    }
+
+    void TransformHierarchy::SwapNodes(uint32_t a, uint32_t b) noexcept
+    {
+        if (a == b)
+        {
+            return;
+        }
+        std::swap(m_Local[a], m_Local[b]);
+        std::swap(m_World[a], m_World[b]);
+        std::swap(m_Parent[a], m_Parent[b]);
+        std::swap(m_SlotOf[a], m_SlotOf[b]);
+        std::swap(m_State[a], m_State[b]);
+        std::swap(m_Stamp[a], m_Stamp[b]);
+        m_Slots[m_SlotOf[a]].index = a;
+        m_Slots[m_SlotOf[b]].index = b;
+        // 子が覚えている親の位置を直す(a と b が親子でも、入れ替え後の位置で上書きされる)
+        for (const uint32_t index : { a, b })
+        {
+            for (uint32_t c = m_Slots[m_SlotOf[index]].firstChild; c != kNone; c = m_Slots[c].nextSibling)
+            {
+                m_Parent[m_Slots[c].index] = index;
+            }
+        }
+    }
+
+    uint32_t TransformHierarchy::LevelEnd(uint32_t level) const noexcept
+    {
+        return level + 1 < LevelCount() ? m_LevelBegin[level + 1] : NodeCount();
+    }
+
+    uint32_t TransformHierarchy::MoveToLevel(uint32_t index, uint32_t depth) noexcept
+    {
+        const uint32_t slot = m_SlotOf[index];
+        uint32_t level = m_Slots[slot].depth;
+        while (LevelCount() <= depth)
+        {
+            m_LevelBegin.push_back(NodeCount());
+        }
+        // 深くする: 段の末尾と入れ替え、その位置を次の段の先頭に繰り入れる
+        for (; level < depth; ++level)
+        {
+            const uint32_t last = LevelEnd(level) - 1;
+            SwapNodes(index, last);
+            index = last;
+            --m_LevelBegin[level + 1];
+        }
+        // 浅くする: 段の先頭と入れ替え、その位置を前の段の末尾に繰り入れる
+        for (; level > depth; --level)
+        {
+            const uint32_t first = m_LevelBegin[level];
+            SwapNodes(index, first);
+            index = first;
+            ++m_LevelBegin[level];
+        }
+        m_Slots[slot].depth = depth;
+        return index;
+    }
+
+    void TransformHierarchy::TrimLevels() noexcept
+    {
+        while (!m_LevelBegin.empty() && m_LevelBegin.back() == NodeCount())
+        {
+            m_LevelBegin.pop_back();
+        }
+    }
+
+    void TransformHierarchy::CollectSubtree(uint32_t slot, std::vector<uint32_t>& out) const
+    {
+        out.clear();
+        out.push_back(slot);
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            for (uint32_t c = m_Slots[out[i]].firstChild; c != kNone; c = m_Slots[c].nextSibling)
+            {
+                out.push_back(c);
+            }
+        }
+    }
+
+    void TransformHierarchy::Update()
+    {
+        UpdateImpl(nullptr);
+    }
+
+    void TransformHierarchy::Update(Job::JobSystem& jobs)
+    {
+        UpdateImpl(&jobs);
+    }
+
+    void TransformHierarchy::QueueChildren(uint32_t index, std::vector<uint32_t>& out) noexcept
+    {
+        // 子は親ひとつからしか辿られないので、別のジョブと同じ子を取り合うことはない
+        for (uint32_t c = m_Slots[m_SlotOf[index]].firstChild; c != kNone; c = m_Slots[c].nextSibling)
+        {
+            const uint32_t child = m_Slots[c].index;
+            if (m_State[child] == kClean)
+            {
+                m_State[child] = kQueued;
+                out.push_back(child);
+            }
+        }
+    }
+
+    void TransformHierarchy::ProcessBatch(const uint32_t* list, uint32_t begin, uint32_t end, std::vector<uint32_t>& out) noexcept
+    {
+        const uint32_t serial = m_UpdateSerial;
+        out.clear();
+        if (!list)
+        {
+            // 段を頭から舐め、親がこの Update で計算されたかを見て引き込む(子のリストを飛び飛びにたどらない)
+            for (uint32_t index = begin; index < end; ++index)
+            {
+                const uint32_t parent = m_Parent[index];
+                if (m_State[index] != kQueued && (parent == kNone || m_Stamp[parent] != serial))
+                {
+                    continue;
+                }
+                m_World[index] = parent == kNone ? m_Local[index] : Math::Multiply(m_Local[index], m_World[parent]);
+                m_State[index] = kClean;
+                m_Stamp[index] = serial;
+                out.push_back(index);
+            }
+            return;
+        }
+        for (uint32_t n = begin; n < end; ++n)
+        {
+            const uint32_t index = list[n];
+            const uint32_t parent = m_Parent[index];
+            m_World[index] = parent == kNone ? m_Local[index] : Math::Multiply(m_Local[index], m_World[parent]);
+            m_State[index] = kClean;
+            m_Stamp[index] = serial;
+            QueueChildren(index, out);
+        }
+    }
+
+    void TransformHierarchy::UpdateImpl(Job::JobSystem* jobs)
+    {
+        m_LastUpdated = 0;
+        if (m_Pending.empty())
+        {
+            return;
+        }
+        // 番号が一周したら古い印を消す(0 は「まだ計算していない」)
+        if (++m_UpdateSerial == 0)
+        {
+            std::fill(m_Stamp.begin(), m_Stamp.end(), 0u);
+            m_UpdateSerial = 1;
+        }
+
+        // 変更のあったノードを深さごとに振り分ける(同じノードが何度積まれていても1回にする)
+        const uint32_t levels = LevelCount();
+        if (m_LevelWork.size() < levels)
+        {
+            m_LevelWork.resize(levels);
+        }
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            m_LevelWork[level].clear();
+        }
+        for (const uint32_t slot : m_Pending)
+        {
+            const Slot& s = m_Slots[slot];
+            if (s.index != kNone && m_State[s.index] == kPending)
+            {
+                m_State[s.index] = kQueued;
+                m_LevelWork[s.depth].push_back(s.index);
+            }
+        }
+        m_Pending.clear();
+
+        // 浅い段から計算する。段の中は互いに依存しないので並列にできる。
+        // 計算するノードが段の一定割合を超える間は、作業リストを使わず段を頭から舐めて親から引き込む
+        bool dense = false;
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            const std::vector<uint32_t>& work = m_LevelWork[level];
+            const uint32_t levelBegin = m_LevelBegin[level];
+            const uint32_t levelSize = LevelEnd(level) - levelBegin;
+            dense = dense || work.size() > levelSize / kDenseDivisor;
+            if (!dense && work.empty())
+            {
+                continue;
+            }
+            const uint32_t count = dense ? levelSize : static_cast<uint32_t>(work.size());
+            const uint32_t batches = (count + kBatchSize - 1) / kBatchSize;
+            if (m_BatchOut.size() < batches)
+            {
+                m_BatchOut.resize(batches);
+            }
+            const uint32_t* list = dense ? nullptr : work.data();
+            const uint32_t offset = dense ? levelBegin : 0;
+            auto run = [&](size_t batch)
+                {
+                    const uint32_t begin = offset + static_cast<uint32_t>(batch) * kBatchSize;
+                    const uint32_t end = offset + std::min(count, static_cast<uint32_t>(batch + 1) * kBatchSize);
+                    ProcessBatch(list, begin, end, m_BatchOut[batch]);
+                };
+            if (jobs && batches > 1)
+            {
+                jobs->ParallelFor(batches, [&](size_t begin, size_t end)
+                    {
+                        for (size_t batch = begin; batch < end; ++batch)
+                        {
+                            run(batch);
+                        }
+                    }, 1);
+            }
+            else
+            {
+                for (uint32_t batch = 0; batch < batches; ++batch)
+                {
+                    run(batch);
+                }
+            }
+
+            if (!dense)
+            {
+                // 次の段の作業リスト = その段で直接変更されたもの + いま計算したノードの子
+                m_LastUpdated += count;
+                if (level + 1 < levels)
+                {
+                    std::vector<uint32_t>& next = m_LevelWork[level + 1];
+                    for (uint32_t batch = 0; batch < batches; ++batch)
+                    {
+                        next.insert(next.end(), m_BatchOut[batch].begin(), m_BatchOut[batch].end());
+                    }
+                }
+                continue;
+            }
+
+            // 計算したノードが段の一定割合を下回ったら、その子を作業リストに積んでリストでの計算に戻る
+            uint32_t updated = 0;
+            for (uint32_t batch = 0; batch < batches; ++batch)
+            {
+                updated += static_cast<uint32_t>(m_BatchOut[batch].size());
+            }
+            m_LastUpdated += updated;
+            dense = updated > levelSize / kDenseDivisor;
+            if (!dense && level + 1 < levels)
+            {
+                std::vector<uint32_t>& next = m_LevelWork[level + 1];
+                for (uint32_t batch = 0; batch < batches; ++batch)
+                {
+                    for (const uint32_t index : m_BatchOut[batch])
+                    {
+                        QueueChildren(index, next);
+                    }
+                }
+            }
+        }
+    }
+
+    bool TransformHierarchy::Validate() const
+    {
+        const uint32_t count = NodeCount();
+        if (m_World.size() != count || m_Parent.size() != count || m_SlotOf.size() != count || m_State.size() != count || m_Stamp.size() != count)
+        {
+            return false;
+        }
+        if (count == 0)
+        {
+            return m_LevelBegin.empty();
+        }
+        if (m_LevelBegin.empty() || m_LevelBegin[0] != 0)
+        {
+            return false;
+        }
+        for (uint32_t level = 0; level < LevelCount(); ++level)
+        {
+            if (m_LevelBegin[level] >= LevelEnd(level))
+            {
+                return false; // 空の段があってはいけない
+            }
+            for (uint32_t index = m_LevelBegin[level]; index < LevelEnd(level); ++index)
+            {
+                const Slot& s = m_Slots[m_SlotOf[index]];
+                if (s.index != index || s.depth != level)
+                {
+                    return false;
+                }
+                if (s.parent == kNone ? (level != 0 || m_Parent[index] != kNone)
+                    : (m_Parent[index] != m_Slots[s.parent].index || m_Slots[s.parent].depth + 1 != level || m_Parent[index] >= index))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
@@ -17,6 +17,55 @@ namespace Drama::EngineConfig
         const std::string ImGui_iniPath = "config/editor/imgui.ini";    ///< ImGui設定ファイルパス
 
         const std::string EngineLogPath = "temp/log/engine_log.txt";    ///< エンジンログファイルパス
+        const std::string EngineBinaryLogPath = "temp/log/engine_log.bin";    ///< バイナリログファイルパス("engine_log.0.bin" ... に分けて書く。LogDecoderでテキスト化)
+        const std::string ProfileTracePath = "temp/profile/engine_trace.json"; ///< CPU 計測の書き出し先(Chrome Trace Event 形式の JSON)
+    }
+
+    namespace Log
+    {
+#ifdef NDEBUG
+        bool EnableBinaryLog = true;    ///< バイナリログ有効化フラグ(書式化をログ出力から外す)
+#else
+        bool EnableBinaryLog = false;   ///< バイナリログ有効化フラグ(書式化をログ出力から外す)
+#endif
+        size_t BinaryLogSegmentBytes = 1024 * 1024;     ///< バイナリログ1ファイルの上限(超える前に次のファイルへ切り替える)
+        size_t BinaryLogRetainBytes = 4 * 1024 * 1024;  ///< バイナリログを最低限残す量(これを超えた古いファイルから消える)
+        size_t BinaryLogQueueSlots = 4096;              ///< バイナリログの書き込み待ちを溜めるスロット数(1スロット256B)
+    }
+
+    namespace IO
+    {
+        uint32_t WorkerCount = 2;                       ///< 非同期I/Oスレッド数
+        size_t MaxInFlightBytes = 64 * 1024 * 1024;     ///< 非同期I/Oで同時に実行中にできるバイト数
+        size_t MaxCompletionsPerFrame = 64;             ///< 1フレームで処理するI/O完了通知の最大数
+        uint32_t FileWatchDebounceMs = 100;             ///< ファイル変更を確定させるまでの静止時間(ミリ秒)
+    }
+
+    namespace Job
+    {
+        uint32_t ThreadCount = 0;                       ///< ジョブシステムのスレッド数(メインスレッド含む。0ならコア数)
+        uint32_t FiberCount = 128;                      ///< ジョブを載せるファイバー数(0ならファイバーを使わない)
+        uint32_t FiberStackSize = 256 * 1024;           ///< ファイバー1つのスタック(バイト)
+    }
+
+    namespace Memory
+    {
+        uint32_t FrameArenaBlockSize = 256 * 1024;      ///< フレーム用一時メモリの1ブロック(スレッドごと、バイト)
+        uint64_t FrameBudgetBytes = 32ull * 1024 * 1024; ///< フレーム用一時メモリの予算(超えると警告。0なら無制限、追跡有効時のみ)
+        uint64_t PoolBudgetBytes = 0;                   ///< オブジェクトプールの予算(同上)
+    }
+
+    namespace Time
+    {
+        uint32_t FixedUpdateHz = 60;                    ///< 固定ステップ更新の回数(1秒あたり)
+        uint32_t MaxCatchUpSteps = 5;                   ///< 1フレームで実行する固定ステップの上限(処理落ち時)
+        uint32_t LimiterSpinMicroseconds = 1000;        ///< フレームリミッタが眠らずに回って待つ時間
+    }
+
+    namespace Profile
+    {
+        bool CaptureOnStart = false;                    ///< 起動時から CPU 計測を始め、終了時に ProfileTracePath へ書き出す(DRAMA_PROFILE 有効時のみ)
+        uint32_t MaxEventsPerThread = 1u << 18;         ///< 1スレッドが記録できる区間数(超えた分は捨てる)
     }
 
     namespace Graphics
@@ -25,14 +74,17 @@ namespace Drama::EngineConfig
         uint32_t ResolutionHeight = 1080;   ///< 解像度高さ
 
         uint32_t BufferingCount = 3; ///< バッファリング数
+        bool EnablePipelinedFrames = true; ///< Update と Render を別スレッドで重ねる(描画情報の枠数は BufferingCount)
         uint32_t DisplayRefreshrate = 60;          ///< 最大FPS(モニターのリフレッシュレート)
 
         const float kClearColor[4] = { 0.1f,0.25f,0.5f,1.0f }; ///< クリアカラー
+        bool EnableVSync = true;          ///< VSync有効化フラグ
+#if defined(_WIN32)
         DXGI_FORMAT DefaultDXGIFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
         DXGI_FORMAT DefaultDepthDXGIFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-        bool EnableVSync = true;          ///< VSync有効化フラグ
 
         D3D_SHADER_MODEL HighestShaderModel = D3D_SHADER_MODEL_6_8;  ///< 利用可能な最高シェーダーモデル
         D3D_SHADER_MODEL RequestedShaderModel = D3D_SHADER_MODEL_6_0;  ///< 要求するシェーダーモデル
+#endif
     }
 }
@@ -2,8 +2,10 @@
 
 #include <cstdint>
 #include <string>
+#if defined(_WIN32)
 #include <d3d12.h>
 #include <dxgiformat.h>
+#endif
 
 namespace Drama::EngineConfig
 {
@@ -21,6 +23,51 @@ namespace Drama::EngineConfig
         extern const std::string ImGui_iniPath;    ///< ImGui設定ファイルパス
 
         extern const std::string EngineLogPath;    ///< エンジンログファイルパス
+        extern const std::string EngineBinaryLogPath;    ///< バイナリログファイルパス("engine_log.0.bin" ... に分けて書く。LogDecoderでテキスト化)
+        extern const std::string ProfileTracePath;       ///< CPU 計測の書き出し先(Chrome Trace Event 形式の JSON)
+    }
+
+    namespace Log
+    {
+        extern bool EnableBinaryLog;    ///< バイナリログ有効化フラグ(書式化をログ出力から外す)
+        extern size_t BinaryLogSegmentBytes; ///< バイナリログ1ファイルの上限(超える前に次のファイルへ切り替える)
+        extern size_t BinaryLogRetainBytes;  ///< バイナリログを最低限残す量(これを超えた古いファイルから消える)
+        extern size_t BinaryLogQueueSlots;   ///< バイナリログの書き込み待ちを溜めるスロット数(1スロット256B)
+    }
+
+    namespace IO
+    {
+        extern uint32_t WorkerCount;           ///< 非同期I/Oスレッド数
+        extern size_t MaxInFlightBytes;        ///< 非同期I/Oで同時に実行中にできるバイト数
+        extern size_t MaxCompletionsPerFrame;  ///< 1フレームで処理するI/O完了通知の最大数
+        extern uint32_t FileWatchDebounceMs;   ///< ファイル変更を確定させるまでの静止時間(ミリ秒)
+    }
+
+    namespace Job
+    {
+        extern uint32_t ThreadCount;           ///< ジョブシステムのスレッド数(メインスレッド含む。0ならコア数)
+        extern uint32_t FiberCount;            ///< ジョブを載せるファイバー数(0ならファイバーを使わない)
+        extern uint32_t FiberStackSize;        ///< ファイバー1つのスタック(バイト)
+    }
+
+    namespace Memory
+    {
+        extern uint32_t FrameArenaBlockSize;   ///< フレーム用一時メモリの1ブロック(スレッドごと、バイト)
+        extern uint64_t FrameBudgetBytes;      ///< フレーム用一時メモリの予算(超えると警告。0なら無制限、追跡有効時のみ)
+        extern uint64_t PoolBudgetBytes;       ///< オブジェクトプールの予算(同上)
+    }
+
+    namespace Time
+    {
+        extern uint32_t FixedUpdateHz;             ///< 固定ステップ更新の回数(1秒あたり)
+        extern uint32_t MaxCatchUpSteps;           ///< 1フレームで実行する固定ステップの上限(処理落ち時)
+        extern uint32_t LimiterSpinMicroseconds;   ///< フレームリミッタが眠らずに回って待つ時間
+    }
+
+    namespace Profile
+    {
+        extern bool CaptureOnStart;             ///< 起動時から CPU 計測を始め、終了時に ProfileTracePath へ書き出す(DRAMA_PROFILE 有効時のみ)
+        extern uint32_t MaxEventsPerThread;     ///< 1スレッドが記録できる区間数(超えた分は捨てる)
     }
 
     namespace Graphics
@@ -31,15 +78,18 @@ namespace Drama::EngineConfig
 
         constexpr uint32_t kMaxBufferingCount = 3; ///< 最大バッファリング数
         extern uint32_t BufferingCount; ///< バッファリング数
+        extern bool EnablePipelinedFrames; ///< Update と Render を別スレッドで重ねる(描画情報の枠数は BufferingCount)
         extern uint32_t DisplayRefreshrate;          ///< 最大FPS(モニターのリフレッシュレート)
 
         extern const float kClearColor[4]; ///< クリアカラー
+        extern bool EnableVSync;          ///< VSync有効化フラグ
+#if defined(_WIN32)
         extern DXGI_FORMAT DefaultDXGIFormat;
         extern DXGI_FORMAT DefaultDepthDXGIFormat;
-        extern bool EnableVSync;          ///< VSync有効化フラグ
 
         extern D3D_SHADER_MODEL HighestShaderModel;  ///< 利用可能な最高シェーダーモデル
         extern D3D_SHADER_MODEL RequestedShaderModel;  ///< 要求するシェーダーモデル
+#endif
     }
 }
 
@@ -2,36 +2,78 @@
 // C++ standard library includes
 #include <string>
 #include <format>
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
 #include <cassert>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <deque>
 #include <string>
 #include <variant>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <system_error>
 #include <source_location>
-#ifdef _DEBUG
+#if defined(_WIN32) && defined(_DEBUG)
 #include <debugapi.h>
 #endif
 // Drama Engine includes
 #include "config/EngineConfig.h"
+#include "Core/include/LogLevel.h"
+#include "Core/include/BinaryLogFormat.h"
+#include "Core/include/AsyncLogWriter.h"
+#include "Core/include/IFileSystem.h"
+#include "Core/include/LogSegmentStore.h"
 
 namespace Drama::Core
 {
     class LogAssert final
     {
     public:
+#if defined(_WIN32)
         using EXPR = std::variant<bool, HRESULT>;
+#else
+        using EXPR = std::variant<bool>;
+#endif
 
-        enum class LogLevel : uint8_t
-        {
+        using LogLevel = Drama::Core::LogLevel;
 
+        /// @brief 出力形式
+        enum class LogMode : uint8_t
+        {
+            Text,   ///< 呼び出し側で書式化してテキストに追記
+            Binary, ///< 書式IDと生の引数だけを積み、書き込みスレッドが追記する。書式化は LogDecoder で行う
         };
 
-        static void Init()
+        /// @brief コンパイル時に残す最低レベル。これ未満の呼び出しは空の関数になる
+        /// @note DRAMA_LOG_MIN_LEVEL(LogLevelの数値)で上書きできる
+#if defined(DRAMA_LOG_MIN_LEVEL)
+        static constexpr LogLevel kMinLevel = static_cast<LogLevel>(DRAMA_LOG_MIN_LEVEL);
+#elif defined(_DEBUG)
+        static constexpr LogLevel kMinLevel = LogLevel::Trace;
+#elif defined(DEVELOP)
+        static constexpr LogLevel kMinLevel = LogLevel::Debug;
+#else
+        static constexpr LogLevel kMinLevel = LogLevel::Info;
+#endif
+
+        /// @brief 書式文字列(IDと検証はコンパイル時)
+        template <class... Args>
+        using Format = BinaryLog::Format<std::type_identity_t<Args>...>;
+
+        /// @param fs バイナリログの書き込み先(Shutdown まで生かしておくこと)
+        static void Init(IO::IFileSystem& fs, LogMode mode = LogMode::Text)
         {
+            // 再初期化に備えて前回のバイナリログを閉じておく
+            CloseBinary();
+
             std::scoped_lock lock(m_Mutex);
 
             std::string currentDir = std::filesystem::current_path().string();
@@ -55,16 +97,57 @@ namespace Drama::Core
             {
                 TrimToLastN_NoLock(m_MaxLines);
             }
+
+            if (mode == LogMode::Binary && !OpenBinary(fs))
+            {
+                mode = LogMode::Text; // 開けなければテキストで続行
+            }
+            m_Mode.store(mode, std::memory_order_release);
         }
 
-        template <class... Args>
-        static void Log(std::string_view fmt, Args&&... args)
+        /// @brief 積まれたバイナリログを書き出してから閉じる
+        static void Shutdown()
         {
-            std::string msg = std::vformat(fmt, std::make_format_args(std::forward<Args>(args)...));
-#ifdef _DEBUG
-            OutputDebugStringA(msg.c_str());
+            m_Mode.store(LogMode::Text, std::memory_order_release);
+            CloseBinary();
+        }
+
+        /// @brief レベル付きログ
+        /// @note kMinLevel 未満は何も生成しない(引数式の評価だけは残るので重い式を渡さない)
+        template <LogLevel Level, class... Args>
+        static void LogAt(Format<Args...> fmt, Args&&... args)
+        {
+            if constexpr (Level >= kMinLevel)
+            {
+                if (m_Mode.load(std::memory_order_acquire) == LogMode::Binary)
+                {
+                    WriteBinary(Level, fmt.id, fmt.str, args...);
+                    return;
+                }
+                std::string msg = std::vformat(fmt.str, std::make_format_args(args...));
+#if defined(_WIN32) && defined(_DEBUG)
+                OutputDebugStringA(msg.c_str());
 #endif
-            WriteLine(msg);
+                WriteLine(msg, Level);
+            }
+        }
+
+        template <class... Args>
+        static void Trace(Format<Args...> fmt, Args&&... args) { LogAt<LogLevel::Trace>(fmt, std::forward<Args>(args)...); }
+        template <class... Args>
+        static void Debug(Format<Args...> fmt, Args&&... args) { LogAt<LogLevel::Debug>(fmt, std::forward<Args>(args)...); }
+        template <class... Args>
+        static void Info(Format<Args...> fmt, Args&&... args) { LogAt<LogLevel::Info>(fmt, std::forward<Args>(args)...); }
+        template <class... Args>
+        static void Warning(Format<Args...> fmt, Args&&... args) { LogAt<LogLevel::Warning>(fmt, std::forward<Args>(args)...); }
+        template <class... Args>
+        static void Error(Format<Args...> fmt, Args&&... args) { LogAt<LogLevel::Error>(fmt, std::forward<Args>(args)...); }
+
+        /// @brief Info レベルのログ
+        template <class... Args>
+        static void Log(Format<Args...> fmt, Args&&... args)
+        {
+            LogAt<LogLevel::Info>(fmt, std::forward<Args>(args)...);
         }
 
         static bool Check(EXPR expr, std::string_view fmt, std::source_location loc = std::source_location::current())
@@ -75,11 +158,11 @@ namespace Drama::Core
             }
             const std::string msg = std::format("Check failed at {}:{} in {}: {}", loc.file_name(), loc.line(), loc.function_name(), fmt);
 
-            WriteLine(msg);
-#ifdef _DEBUG
+            WriteLine(msg, LogLevel::Error);
+#if defined(_WIN32) && defined(_DEBUG)
             __debugbreak();
 #endif
-#ifndef NDEBUG
+#if defined(_WIN32) && !defined(NDEBUG)
             MessageBoxA(nullptr, msg.c_str(), "Assertion Failed", MB_OK | MB_ICONERROR);
 #endif
             return false;
@@ -89,8 +172,8 @@ namespace Drama::Core
         static void Throw(std::string_view fmt, Args&&... args)
         {
             const std::string msg = std::vformat(fmt, std::make_format_args(std::forward<Args>(args)...));
-            WriteLine(msg);
-#ifdef _DEBUG
+            WriteLine(msg, LogLevel::Fatal);
+#if defined(_WIN32) && defined(_DEBUG)
             __debugbreak();
 #endif
             throw std::runtime_error(msg);
@@ -104,19 +187,27 @@ namespace Drama::Core
             }
             const std::string msg = std::format("Assert failed at {}:{} in {}: {}", loc.file_name(), loc.line(), loc.function_name(), fmt);
 
-            WriteLine(msg);
+            WriteLine(msg, LogLevel::Fatal);
 #ifdef _DEBUG
             assert(false && msg.c_str());
 #endif
-#ifdef DEVELOP
+#if defined(_WIN32) && defined(DEVELOP)
             MessageBoxA(nullptr, msg.c_str(), "Assertion Failed", MB_OK | MB_ICONERROR);
 #endif
             std::terminate();
         }
 
         // 1行追記（末尾に '\n' を付ける）
-        static bool WriteLine(std::string_view line)
+        static bool WriteLine(std::string_view line, LogLevel level = LogLevel::Info)
         {
+            // 書式化済みの行もバイナリログには "{}" の1引数として残す
+            if (m_Mode.load(std::memory_order_acquire) == LogMode::Binary)
+            {
+                constexpr Format<std::string_view> kLineFormat("{}");
+                WriteBinary(level, kLineFormat.id, kLineFormat.str, line);
+                return true;
+            }
+
             std::scoped_lock lock(m_Mutex);
 
             std::error_code ec;
@@ -129,7 +220,10 @@ namespace Drama::Core
                 std::ofstream ofs(m_LogPath, std::ios::binary | std::ios::app);
                 if (!ofs) return false;
 
-                ofs << line.data() << "\n";
+                const std::string_view name = ToString(level);
+                ofs << '[' << name << "] ";
+                ofs.write(line.data(), static_cast<std::streamsize>(line.size()));
+                ofs << "\n";
                 if (!ofs) return false;
             }
 
@@ -148,6 +242,170 @@ namespace Drama::Core
         }
     private:
 
+        template <class... Args>
+        static void WriteBinary(LogLevel level, uint64_t formatId, std::string_view fmt, const Args&... args)
+        {
+            // 呼び出し側は [u32 長さ][レコード] を組み立てて積むだけ。ロックもファイルI/Oもしない
+            thread_local std::vector<uint8_t> tls_Record;
+            thread_local std::unordered_set<uint64_t> tls_KnownFormats;
+            tls_Record.assign(sizeof(uint32_t), 0);
+
+            // このスレッドで初めての書式は定義も同じレコードに入れる。
+            // 同じスレッドの以降のレコードはリングバッファ上で必ず後ろに来るので、定義より先に書かれない
+            if (tls_KnownFormats.insert(formatId).second)
+            {
+                RegisterFormat(formatId, fmt);
+                BinaryLog::AppendFormatDef(tls_Record, formatId, fmt);
+            }
+            const uint64_t timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_BinaryStart).count());
+            BinaryLog::AppendMessage(tls_Record, formatId, level, timeNs, args...);
+            const uint32_t length = static_cast<uint32_t>(tls_Record.size() - sizeof(uint32_t));
+            std::memcpy(tls_Record.data(), &length, sizeof(length));
+
+            const LogPushResult pushed = m_BinaryAsync.PushRecord(tls_Record.data(), tls_Record.size());
+            if (pushed == LogPushResult::Stopped || pushed == LogPushResult::Rejected)
+            {
+                // 停止と競合した・リングバッファより大きいレコードはその場で書く。
+                // 積んだままの定義より先に書かれることがあるので、定義も付け直す
+                std::vector<uint8_t> frames(sizeof(uint32_t), 0);
+                BinaryLog::AppendFormatDef(frames, formatId, fmt);
+                const uint32_t defLength = static_cast<uint32_t>(frames.size() - sizeof(uint32_t));
+                std::memcpy(frames.data(), &defLength, sizeof(defLength));
+                frames.insert(frames.end(), tls_Record.begin(), tls_Record.end());
+
+                std::scoped_lock lock(m_BinaryMutex);
+                AppendBinaryFrames_NoLock(frames.data(), frames.size());
+                return;
+            }
+
+            // 落ちる直前の記録を失わないよう、重いレベルだけは書き出しを待つ
+            if (level >= LogLevel::Error)
+            {
+                m_BinaryAsync.Flush();
+            }
+        }
+
+        /// @brief ファイルを切り替えたときに先頭へ書き直せるよう、出てきた書式を覚えておく
+        /// @note 書式文字列は Format がコンパイル時に受け取った静的な文字列なので、そのまま持っていてよい
+        static void RegisterFormat(uint64_t formatId, std::string_view fmt)
+        {
+            std::scoped_lock lock(m_FormatMutex);
+            m_Formats.emplace(formatId, fmt);
+        }
+
+        /// @brief [u32 長さ][レコード] の並びを、レコードの境目でファイルを切り替えながら追記する
+        static bool AppendBinaryFrames_NoLock(const uint8_t* data, size_t size)
+        {
+            if (!m_IsBinaryOpen)
+            {
+                return false;
+            }
+
+            bool isOk = true;
+            m_BinaryPending.clear();
+            size_t at = 0;
+            while (size - at >= sizeof(uint32_t))
+            {
+                uint32_t length = 0;
+                std::memcpy(&length, data + at, sizeof(length));
+                at += sizeof(length);
+                if (size - at < length)
+                {
+                    return false; // 書き込みスレッドは揃ったレコードしか渡さないので起きない
+                }
+
+                const size_t used = m_BinaryStore.ActiveBytes() + m_BinaryPending.size();
+                if (used > 0 && used + length > m_BinarySegmentBytes)
+                {
+                    isOk = FlushPending_NoLock() && isOk;
+                    isOk = m_BinaryStore.Roll() && isOk;
+                }
+                if (m_BinaryStore.ActiveBytes() == 0 && m_BinaryPending.empty())
+                {
+                    // どのファイルも単独で復号できるよう、ヘッダとここまでの書式を先頭に置く
+                    BinaryLog::AppendFileHeader(m_BinaryPending, m_BinaryStartNs, m_BinarySegment++);
+                    std::scoped_lock lock(m_FormatMutex);
+                    for (const auto& [id, fmt] : m_Formats)
+                    {
+                        BinaryLog::AppendFormatDef(m_BinaryPending, id, fmt);
+                    }
+                }
+                m_BinaryPending.insert(m_BinaryPending.end(), data + at, data + at + length);
+                at += length;
+            }
+            return FlushPending_NoLock() && isOk;
+        }
+
+        static bool FlushPending_NoLock()
+        {
+            if (m_BinaryPending.empty())
+            {
+                return true;
+            }
+            const bool isOk = m_BinaryStore.AppendWhole(m_BinaryPending.data(), m_BinaryPending.size());
+            m_BinaryPending.clear();
+            return isOk;
+        }
+
+        static bool OpenBinary(IO::IFileSystem& fs)
+        {
+            const std::string path = fs.currentPath() + "/" + EngineConfig::FilePath::EngineBinaryLogPath;
+            const size_t slash = path.find_last_of("/\\");
+            if (!fs.CreateDirectories(path.substr(0, slash)))
+            {
+                return false;
+            }
+
+            std::scoped_lock lock(m_BinaryMutex);
+
+            // 以前の1ファイル形式("engine_log.bin" と1世代前の "engine_log.prev.bin")は使わない
+            fs.Remove(path);
+            fs.Remove(path.substr(0, path.find_last_of('.')) + ".prev.bin");
+
+            LogRotationDesc rotation{};
+            rotation.retainBytes = EngineConfig::Log::BinaryLogRetainBytes;
+            rotation.segmentBytes = EngineConfig::Log::BinaryLogSegmentBytes;
+            if (!m_BinaryStore.Open(fs, path, rotation))
+            {
+                return false;
+            }
+            // 前回の記録には続けず新しいファイルから始める(前回分は古い順に消えるまで残る)
+            if (m_BinaryStore.ActiveBytes() > 0 && !m_BinaryStore.Roll())
+            {
+                return false;
+            }
+
+            m_BinarySegmentBytes = rotation.segmentBytes;
+            m_BinarySegment = 0;
+            m_BinaryStart = std::chrono::steady_clock::now();
+            m_BinaryStartNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            m_IsBinaryOpen = true;
+
+            // 満杯でも捨てない(テキストと同じく全て残す)。待つのは書き込みが追いつかないときだけ
+            AsyncLogDesc desc{};
+            desc.slotCount = EngineConfig::Log::BinaryLogQueueSlots;
+            desc.overflow = LogOverflowPolicy::Block;
+            desc.isFramed = true;
+            const bool isStarted = m_BinaryAsync.Start(desc, [](const char* data, size_t size, size_t)
+                {
+                    std::scoped_lock sinkLock(m_BinaryMutex);
+                    return AppendBinaryFrames_NoLock(reinterpret_cast<const uint8_t*>(data), size);
+                });
+            m_IsBinaryOpen = isStarted;
+            return isStarted;
+        }
+
+        /// @brief 積まれた分を書き出して書き込みスレッドを止める。停止と競合した呼び出しは同期書き込みへ回る
+        static void CloseBinary()
+        {
+            m_BinaryAsync.Flush();
+            m_BinaryAsync.Stop();
+            std::scoped_lock lock(m_BinaryMutex);
+            m_IsBinaryOpen = false;
+        }
+
         static std::size_t CountLines_NoLock()
         {
             std::ifstream ifs(m_LogPath, std::ios::binary);
@@ -195,8 +453,10 @@ namespace Drama::Core
             return std::visit([](auto x) -> bool {
                 if constexpr (std::is_same_v<std::decay_t<decltype(x)>, bool>)
                     return x;
+#if defined(_WIN32)
                 else
                     return SUCCEEDED(x); // HRESULT → bool
+#endif
                 }, v);
         }
     private:
@@ -205,5 +465,21 @@ namespace Drama::Core
         static inline size_t m_TrimTrigger = 550;
         static inline size_t m_LineCount = 0;
         static inline std::mutex m_Mutex;
+
+        static inline std::atomic<LogMode> m_Mode{ LogMode::Text };
+
+        // バイナリログ。呼び出し側は m_BinaryAsync に積むだけで、ファイルは書き込みスレッドが触る
+        static inline AsyncLogWriter m_BinaryAsync;
+        static inline std::mutex m_BinaryMutex; ///< 以下のファイル側の状態を守る(書き込みスレッドと同期書き込みの間)
+        static inline LogSegmentStore m_BinaryStore;
+        static inline bool m_IsBinaryOpen = false;
+        static inline size_t m_BinarySegmentBytes = 0;
+        static inline uint16_t m_BinarySegment = 0; ///< 今回の記録で何番目のファイルか
+        static inline uint64_t m_BinaryStartNs = 0; ///< 記録開始時刻(system_clock)
+        static inline std::chrono::steady_clock::time_point m_BinaryStart{};
+        static inline std::vector<uint8_t> m_BinaryPending; ///< 1回の追記にまとめるバイト列(使い回す)
+
+        static inline std::mutex m_FormatMutex;
+        static inline std::unordered_map<uint64_t, std::string_view> m_Formats; ///< これまでに出てきた書式
     };
 }
@@ -1,18 +1,65 @@
 #include "pch.h"
 #include "Engine.h"
+#include "RenderSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#if defined(_WIN32)
 #include <wrl.h>
+#endif
 
 // Drama Engine include
+#include "Platform/include/HeadlessWindow.h"
+#if defined(_WIN32)
 #include "Platform/include/Platform.h"
+#include "Platform/include/WinFileSystem.h"
+#include "Platform/include/WinFileWatcher.h"
+#else
+#include "Platform/include/PosixFileSystem.h"
+#include "Platform/include/LinuxFileWatcher.h"
+#endif
+#include "Platform/include/FrameClock.h"
+#include "Platform/include/Profiler.h"
+#include "Platform/include/Timer.h"
+#include "Core/include/AsyncFileService.h"
+#include "Core/include/Ecs.h"
+#include "Core/include/FileChangeDispatcher.h"
+#include "Core/include/FrameAllocator.h"
+#include "Core/include/FramePipeline.h"
+#include "Core/include/FrustumCulling.h"
+#include "Core/include/JobSystem.h"
+#include "Core/include/MemoryTracker.h"
+#include "Core/include/SystemScheduler.h"
+#include "Core/include/TransformHierarchy.h"
 #include <core/include/LogAssert.h>
 
 using namespace Drama;
 
+namespace
+{
+#if defined(_WIN32)
+    using PlatformFileSystem = Platform::IO::WinFileSystem;
+    using PlatformFileWatcher = Platform::IO::WinFileWatcher;
+#else
+    using PlatformFileSystem = Platform::IO::PosixFileSystem;
+    using PlatformFileWatcher = Platform::IO::LinuxFileWatcher;
+#endif
+
+#if DRAMA_MEMORY_TRACKING
+    /// @brief 予算を超えたときの通知(超えたフレームの Update で1回だけ呼ばれる)
+    void OnMemoryBudgetExceeded(Core::Memory::MemoryTag tag, int64_t liveBytes, int64_t budgetBytes)
+    {
+        Core::LogAssert::Warning("メモリ予算超過: {} {} / {} バイト", Core::Memory::TagName(tag), liveBytes, budgetBytes);
+    }
+#endif
+}
+
 class Drama::Engine::Impl
 {
     friend class Engine;
 public:
     Impl()
+        : fileWatcher(Core::IO::FileWatchDesc{ EngineConfig::IO::FileWatchDebounceMs })
     {
 
     }
@@ -21,7 +68,24 @@ public:
 
     }
 private:
-    Platform::Windows windows;
+    std::unique_ptr<Platform::IWindow> window; ///< Initialize で作る(ヘッドレスなら表示先を持たない実装)
+    bool headless = false; ///< RunHeadless から起動した(リミッタは DisplayRefreshrate ではなく指定のレートに従う)
+    PlatformFileSystem fileSystem;
+    Core::IO::AsyncFileService fileService;
+    PlatformFileWatcher fileWatcher;
+    Core::IO::FileChangeDispatcher fileChanges; ///< 再読み込みする側はここへパスの前方一致で購読する
+    std::vector<Core::IO::FileChange> changeBatch;
+    Core::Job::JobSystem jobs;
+    Core::Frame::FramePipeline<RenderSnapshot> frames; ///< Update から Render への描画情報の受け渡し
+    Core::Memory::FrameAllocator frameMemory; ///< フレームの間だけ使う一時メモリ(枠数は描画情報と同じ)
+    uint64_t frameIndex = 0;
+    Core::Ecs::World world;                   ///< シーンのエンティティとコンポーネント
+    Core::Ecs::SystemScheduler systems;       ///< world を更新するシステム(触る型の読み書きで並列に動かす)
+    Core::Scene::TransformHierarchy transforms; ///< 親子付きの変換(変わった部分木だけ毎フレーム計算し直す)
+    Core::Scene::CullingSet drawBounds;         ///< drawItems と同じ番号の境界(描画要求と一緒に詰める)
+    Core::Scene::VisibilityCuller culler;       ///< 見える描画要求の番号(描画情報と同じ枠数)
+    Platform::FrameClock clock; ///< 固定ステップとフレームリミッタ(メインスレッドだけが触る)
+    std::atomic<bool> quitRequested{ false };
 };
 
 Drama::Engine::Engine() : m_Impl(std::make_unique<Impl>())
@@ -37,41 +101,332 @@ Drama::Engine::~Engine()
 void Drama::Engine::Run()
 {
     // 初期化
-    m_IsRunning = Initialize();
+    m_IsRunning = Initialize(false);
     // メインループ
+    MainLoop(HeadlessRunDesc{});
+    // 終了処理
+    Shutdown();
+}
+
+Drama::HeadlessRunResult Drama::Engine::RunHeadless(const HeadlessRunDesc& desc)
+{
+    HeadlessRunResult result;
+    m_IsRunning = Initialize(true);
+    result.initialized = m_IsRunning;
+
+    const Platform::Timer::Time_Point start = Platform::Timer::Clock::now();
+    result.frames = MainLoop(desc);
+    result.elapsedSeconds = Platform::Timer::Duration(Platform::Timer::Clock::now() - start).count();
+    result.frameTime = m_Impl->clock.Stats();
+
+    Shutdown();
+    return result;
+}
+
+void Drama::Engine::RequestQuit() noexcept
+{
+    m_Impl->quitRequested.store(true, std::memory_order_release);
+}
+
+Platform::FrameTimeStats Drama::Engine::FrameStats() const noexcept
+{
+    return m_Impl->clock.Stats();
+}
+
+uint64_t Drama::Engine::MainLoop(const HeadlessRunDesc& limits)
+{
+    using Clock = Platform::Timer::Clock;
+
+    // パイプライン動作では描画スレッドが公開済みのフレームを順に描く。
+    // メインスレッドは描画を待たずに次のフレームの Update へ進む(先行できるのは枠数 - 1 フレームまで)
+    std::thread renderThread;
+    const bool pipelined = m_IsRunning && EngineConfig::Graphics::EnablePipelinedFrames;
+    if (pipelined)
+    {
+        renderThread = std::thread([this]()
+            {
+                DRAMA_PROFILE_THREAD("Render");
+                while (const RenderSnapshot* snapshot = m_Impl->frames.BeginRender())
+                {
+                    Render(*snapshot);
+                    m_Impl->frames.EndRender();
+                }
+            });
+    }
+
+    // 固定ステップとリミッタの設定。ウィンドウ有りは DisplayRefreshrate を上限にし、
+    // ヘッドレスは指定のレート(0 なら待たずに回す)に合わせる
+    Platform::FrameClockDesc clockDesc{};
+    clockDesc.fixedStepSeconds = 1.0 / std::max(1u, EngineConfig::Time::FixedUpdateHz);
+    clockDesc.maxCatchUpSteps = EngineConfig::Time::MaxCatchUpSteps;
+    clockDesc.targetFps = m_Impl->headless ?
+        limits.fixedRateHz : static_cast<double>(EngineConfig::Graphics::DisplayRefreshrate);
+    clockDesc.spinSeconds = EngineConfig::Time::LimiterSpinMicroseconds * 1e-6;
+    m_Impl->clock.Reset(clockDesc);
+
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(Platform::Timer::Duration(limits.durationSeconds));
+    uint64_t frames = 0;
     while (m_IsRunning)
     {
         // ウィンドウメッセージ処理
-        m_IsRunning = m_Impl->windows.PumpMessages();
+        m_IsRunning = m_Impl->window->PumpMessages() && !m_Impl->quitRequested.load(std::memory_order_acquire);
+        if (!m_IsRunning)
+        {
+            break;
+        }
+
+        m_Impl->clock.BeginFrame();
+        DRAMA_PROFILE_FRAME();
+        RenderSnapshot* snapshot = nullptr;
+        {
+            // 描画が枠数分遅れていればここで待つ
+            DRAMA_PROFILE_ZONE("WaitRenderSlot");
+            snapshot = m_Impl->frames.BeginUpdate();
+        }
+        if (snapshot == nullptr)
+        {
+            break;
+        }
+        // 枠を共有する前のフレームは描画まで終わっているので、その一時メモリをまとめて戻す
+        m_Impl->frameMemory.Reset(m_Impl->frameIndex);
+        // 各スレッドのメモリ使用量をまとめ、予算を確かめる
+        Core::Memory::MemoryTracker::Update(m_Impl->frameIndex);
+        Update(*snapshot);
+        m_Impl->frames.EndUpdate();
+
+        if (!pipelined)
+        {
+            Render(*m_Impl->frames.BeginRender());
+            m_Impl->frames.EndRender();
+        }
 
-        Update();
-        Render();
+        ++frames;
+        if ((limits.frameCount != 0 && frames >= limits.frameCount) ||
+            (limits.durationSeconds > 0.0 && Clock::now() >= deadline))
+        {
+            break;
+        }
+        DRAMA_PROFILE_ZONE("WaitForNextFrame");
+        m_Impl->clock.WaitForNextFrame();
     }
-    // 終了処理
-    Shutdown();
+    // 公開済みのフレームを描き切ってから描画スレッドを止める
+    m_Impl->frames.Stop();
+    if (renderThread.joinable())
+    {
+        renderThread.join();
+    }
+    return frames;
 }
 
-bool Drama::Engine::Initialize()
+bool Drama::Engine::Initialize(bool headless)
 {
-    // ウィンドウ作成
-    if (!m_Impl->windows.Create())
+    // ログ初期化
+    Core::LogAssert::Init(m_Impl->fileSystem, EngineConfig::Log::EnableBinaryLog ?
+        Core::LogAssert::LogMode::Binary : Core::LogAssert::LogMode::Text);
+
+#if DRAMA_PROFILE
+    // CPU 計測(初期化も含めて記録する)
+    DRAMA_PROFILE_THREAD("Main");
+    if (EngineConfig::Profile::CaptureOnStart)
+    {
+        Platform::Profile::CaptureDesc profileDesc{};
+        profileDesc.maxEventsPerThread = EngineConfig::Profile::MaxEventsPerThread;
+        Platform::Profile::Profiler::Start(profileDesc);
+    }
+#endif
+    DRAMA_PROFILE_FUNCTION();
+
+#if DRAMA_MEMORY_TRACKING
+    // 用途ごとのメモリ予算
+    Core::Memory::MemoryTracker::SetBudget(Core::Memory::MemoryTag::Frame, static_cast<int64_t>(EngineConfig::Memory::FrameBudgetBytes));
+    Core::Memory::MemoryTracker::SetBudget(Core::Memory::MemoryTag::Pool, static_cast<int64_t>(EngineConfig::Memory::PoolBudgetBytes));
+    Core::Memory::MemoryTracker::SetBudgetHandler(&OnMemoryBudgetExceeded);
+#endif
+
+    // ジョブシステム開始(メインスレッドもワーカー0として参加する)
+    Core::Job::JobSystemDesc jobDesc{};
+    jobDesc.threadCount = EngineConfig::Job::ThreadCount;
+    jobDesc.fiberCount = EngineConfig::Job::FiberCount;
+    jobDesc.fiberStackSize = EngineConfig::Job::FiberStackSize;
+    if (!m_Impl->jobs.Start(jobDesc))
+    {
+        return false;
+    }
+
+    // 描画情報の枠(パイプライン動作でなくても同じ経路で受け渡す)
+    if (!m_Impl->frames.Init(EngineConfig::Graphics::BufferingCount))
+    {
+        return false;
+    }
+    // フレーム用一時メモリ(描画情報と同じ枠数。フレーム f の分は f + 枠数 の開始時に戻る)
+    Core::Memory::FrameAllocatorDesc frameMemoryDesc{};
+    frameMemoryDesc.blockSize = EngineConfig::Memory::FrameArenaBlockSize;
+    if (!m_Impl->frameMemory.Init(EngineConfig::Graphics::BufferingCount, frameMemoryDesc))
+    {
+        return false;
+    }
+    // 可視判定の結果(描画情報と同じ枠数。フレーム f の一覧は Render が読み終えるまで残る)
+    if (!m_Impl->culler.Init(EngineConfig::Graphics::BufferingCount))
+    {
+        return false;
+    }
+
+    // 非同期I/O開始
+    Core::IO::AsyncFileDesc ioDesc{};
+    ioDesc.workerCount = EngineConfig::IO::WorkerCount;
+    ioDesc.maxInFlightBytes = EngineConfig::IO::MaxInFlightBytes;
+    if (!m_Impl->fileService.Start(m_Impl->fileSystem, ioDesc))
+    {
+        return false;
+    }
+
+    // ホットリロード用の監視(ディレクトリが無い環境もあるので、失敗しても続ける)
+    Core::IO::FileWatchId watchId = Core::IO::kInvalidFileWatchId;
+    m_Impl->fileWatcher.Watch("config", true, watchId);
+    m_Impl->fileWatcher.Watch(EngineConfig::FilePath::ShaderDirectory, true, watchId);
+
+    // ウィンドウ作成(Windows 以外には表示先の実装が無いので、常にヘッドレスで動く)
+#if defined(_WIN32)
+    if (!headless)
+    {
+        m_Impl->window = std::make_unique<Platform::Windows>();
+    }
+#endif
+    if (!m_Impl->window)
+    {
+        m_Impl->window = std::make_unique<Platform::HeadlessWindow>();
+    }
+    m_Impl->headless = headless;
+    if (!m_Impl->window->Create())
     {
         return false;
     }
     // ウィンドウ表示
-    m_Impl->windows.Show();
+    m_Impl->window->Show();
 
     return true;
 }
 
 void Drama::Engine::Shutdown()
 {
+    // ウィンドウを閉じる(初期化が途中で失敗した場合は作られていない)。
+    // 次の Initialize で表示先を選び直せるように破棄まで行う
+    if (m_Impl->window)
+    {
+        m_Impl->window->Shutdown();
+        m_Impl->window.reset();
+    }
+
+    // 待機中の要求は取り消し通知になるので、それも含めて処理してから閉じる
+    m_Impl->fileService.Stop();
+    m_Impl->fileService.DispatchCompletions();
+
+    m_Impl->jobs.Stop();
+
+#if DRAMA_PROFILE
+    // 全スレッドが止まってから書き出す
+    if (Platform::Profile::Profiler::IsCapturing())
+    {
+        Platform::Profile::Profiler::Stop();
+        const Core::IO::FsResult r = Platform::Profile::Profiler::WriteChromeTrace(
+            m_Impl->fileSystem, EngineConfig::FilePath::ProfileTracePath);
+        if (!r)
+        {
+            Core::LogAssert::Log("CPU 計測の書き出しに失敗しました: {}", EngineConfig::FilePath::ProfileTracePath);
+        }
+    }
+#endif
+
+#if DRAMA_MEMORY_TRACKING
+    // 用途ごとの使用量の要約(終了時点で残っている分と、フレーム単位の最大)
+    Core::Memory::MemoryTracker::Update(m_Impl->frameIndex);
+    for (size_t t = 0; t < Core::Memory::kMemoryTagCount; ++t)
+    {
+        const auto tag = static_cast<Core::Memory::MemoryTag>(t);
+        const Core::Memory::TagStats stats = Core::Memory::MemoryTracker::Stats(tag);
+        if (stats.allocations != 0)
+        {
+            Core::LogAssert::Info("メモリ {}: 使用中 {} / 最大 {} バイト, 確保 {} 回, 解放 {} 回",
+                Core::Memory::TagName(tag), stats.liveBytes, stats.peakBytes, stats.allocations, stats.frees);
+        }
+    }
+    Core::Memory::MemoryTracker::SetBudgetHandler(nullptr);
+#endif
+
+    Core::LogAssert::Shutdown();
+}
+
+void Drama::Engine::Update(RenderSnapshot& snapshot)
+{
+    DRAMA_PROFILE_FUNCTION();
+    snapshot.frameIndex = m_Impl->frameIndex++;
+    snapshot.updateBegin = Platform::Timer::Clock::now();
+    snapshot.drawItems.clear();
+    m_Impl->drawBounds.Clear();
+
+    // 前フレームまでに終わった読み書きの完了通知(上限を超えた分は次フレームへ)
+    m_Impl->fileService.DispatchCompletions(EngineConfig::IO::MaxCompletionsPerFrame);
+
+    // 確定したファイル変更を購読者ごとに1回ずつまとめて渡す(通知の無いフレームはほぼ何もしない)
+    m_Impl->changeBatch.clear();
+    if (m_Impl->fileWatcher.Poll(m_Impl->changeBatch) > 0)
+    {
+        m_Impl->fileChanges.Dispatch(m_Impl->changeBatch);
+    }
+
+    // 貯まった実時間の分だけ固定ステップで進める(処理落ちしても上限回数で打ち切る)
+    Platform::FrameClock& clock = m_Impl->clock;
+    [[maybe_unused]] uint32_t fixedSteps = 0;
+    while (clock.StepFixed())
+    {
+        FixedUpdate(clock.FixedStepSeconds());
+        ++fixedSteps;
+    }
+    DRAMA_PROFILE_COUNTER("FixedSteps", fixedSteps);
+    DRAMA_PROFILE_COUNTER("FrameMs", clock.DeltaSeconds() * 1000.0);
+    snapshot.deltaSeconds = clock.DeltaSeconds();
+    snapshot.simulationSeconds = clock.SimulationSeconds();
+    snapshot.interpolationAlpha = static_cast<float>(clock.Alpha());
+
+    // ECS のシステムを読み書きの競合しない組ごとに並列に動かし、積まれた構造の変更を反映する
+    {
+        DRAMA_PROFILE_ZONE("Systems");
+        m_Impl->systems.Run(m_Impl->world, m_Impl->jobs, clock.DeltaSeconds());
+    }
+
+    // システムが動かした変換のワールド行列を、深さの段ごとに並列で計算し直す
+    {
+        DRAMA_PROFILE_ZONE("Transforms");
+        m_Impl->transforms.Update(m_Impl->jobs);
+    }
+
+    // システムと変換はそれぞれ自分の投入したジョブを待ってから戻るので、ここで待つものは残っていない。
+    // フレーム内で捨てる一時データは frameMemory から snapshot.frameIndex で取る(Render からも同じフレーム番号で使える)。
+    // 上の通知はメインスレッド前提のコールバックを呼ぶので、ジョブにはしない。
+    // 描画に要るものは snapshot に書き出す(戻った時点で公開される)
+
+    // 描画要求を視錐台で絞り、見えるものの番号だけを Render に渡す(一覧はこのフレームの枠に残る)
+    {
+        DRAMA_PROFILE_ZONE("Culling");
+        const Core::Scene::Frustum frustum = Core::Scene::FrustumFromMatrix(snapshot.viewProjection);
+        snapshot.visibleItems = m_Impl->culler.Cull(snapshot.frameIndex, frustum, m_Impl->drawBounds, &m_Impl->jobs);
+        DRAMA_PROFILE_COUNTER("VisibleItems", snapshot.visibleItems.size());
+    }
 }
 
-void Drama::Engine::Update()
+void Drama::Engine::FixedUpdate([[maybe_unused]] double stepSeconds)
 {
+    DRAMA_PROFILE_FUNCTION();
+    // 物理・ゲームロジックなど、決まった間隔で進めたいものをここで更新する。
+    // ジョブに広げる場合は、次のステップが同じ状態を読むので戻る前に待ち切る
 }
 
-void Drama::Engine::Render()
+void Drama::Engine::Render([[maybe_unused]] const RenderSnapshot& snapshot)
 {
+    DRAMA_PROFILE_FUNCTION();
+    // snapshot だけを読んで描画する(ゲーム側の状態は次のフレームの Update が書き換えている最中)。
+    // 描画するのは snapshot.visibleItems に載った drawItems だけ(Update の最後で視錐台の外を落としてある)。
+    // 描画コマンドの記録をジョブに広げる場合は、提出の前に待ち切る。
+    // パイプライン動作では描画スレッドはワーカーではないので、投入は共有キュー経由になり、Wait の間はジョブを手伝う
 }
@@ -1,9 +1,33 @@
 #pragma once
 // c++ standard library
+#include <cstdint>
 #include <memory>
 
+// Drama Engine include
+#include "Platform/include/FrameClock.h"
+
 namespace Drama
 {
+    struct RenderSnapshot;
+
+    /// @brief ウィンドウ無しで回すときの止め方と速さ
+    /// @note frameCount と durationSeconds は先に達した方で止まる。どちらも 0 なら RequestQuit まで回る
+    struct HeadlessRunDesc
+    {
+        uint64_t frameCount = 0;      ///< 回すフレーム数(0 なら数では止めない)
+        double durationSeconds = 0.0; ///< 回す時間(秒。0 なら時間では止めない)
+        double fixedRateHz = 0.0;     ///< 1秒あたりのフレーム数(0 なら待たずに回す)
+    };
+
+    /// @brief ウィンドウ無しで回した結果
+    struct HeadlessRunResult
+    {
+        bool initialized = false;    ///< 初期化に成功したか(失敗ならフレームは回っていない)
+        uint64_t frames = 0;         ///< 回したフレーム数
+        double elapsedSeconds = 0.0; ///< メインループにかかった時間(秒。初期化と終了処理は含まない)
+        Platform::FrameTimeStats frameTime; ///< フレーム間隔の統計
+    };
+
     class Engine
     {
     public:
@@ -13,17 +37,34 @@ namespace Drama
         ~Engine();
         /// @brief 稼働
         void Run();
+        /// @brief ウィンドウ無しで稼働(サーバー・バッチ・CI の耐久試験や性能計測用)
+        /// @return 回したフレーム数と時間
+        HeadlessRunResult RunHeadless(const HeadlessRunDesc& desc);
+        /// @brief 次のフレームの前でメインループを抜けさせる(どのスレッドから呼んでもよい)
+        void RequestQuit() noexcept;
+        /// @brief フレーム間隔の統計(メインスレッドから呼ぶ)
+        Platform::FrameTimeStats FrameStats() const noexcept;
     private:
         /// @brief 初期化
+        /// @param headless ウィンドウを作らない(Windows 以外では常にウィンドウ無し)
         /// @return 成功ならtrue
         [[nodiscard]]
-        bool Initialize();
+        bool Initialize(bool headless);
+        /// @brief メインループ
+        /// @param limits 止め方と速さ(既定値なら終了要求まで待たずに回す)
+        /// @return 回したフレーム数
+        uint64_t MainLoop(const HeadlessRunDesc& limits);
         /// @brief 終了処理
         void Shutdown();
-        /// @brief 更新処理
-        void Update();
+        /// @brief 更新処理(フレームに1回。貯まった時間の分だけ FixedUpdate を呼ぶ)
+        /// @param snapshot このフレームの描画情報の書き込み先
+        void Update(RenderSnapshot& snapshot);
+        /// @brief 固定ステップ更新(シミュレーション。フレームの速さによらず一定間隔で進める)
+        /// @param stepSeconds 1ステップで進める時間
+        void FixedUpdate(double stepSeconds);
         /// @brief 描画処理
-        void Render();
+        /// @param snapshot Update が公開した描画情報(パイプライン動作時は描画スレッドで呼ばれる)
+        void Render(const RenderSnapshot& snapshot);
 
         class Impl;
         std::unique_ptr<Impl> m_Impl;
@@ -0,0 +1,35 @@
+#pragma once
+// c++ standard library
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Drama Engine include
+#include "Platform/include/Timer.h"
+#include "Core/include/MathTypes.h"
+
+namespace Drama
+{
+    /// @brief 1件の描画要求
+    struct DrawItem
+    {
+        float world[16] = {};   ///< ワールド行列(行優先)
+        uint32_t mesh = 0;      ///< メッシュID
+        uint32_t material = 0;  ///< マテリアルID
+    };
+
+    /// @brief Update が作り Render が読む1フレーム分の描画情報
+    /// @note 公開した後は Render が読み終えるまで書き換えない(FramePipeline が保証する)。
+    ///       枠は使い回すので、Update は clear してから詰め直す(確保した容量は残る)
+    struct RenderSnapshot
+    {
+        uint64_t frameIndex = 0;                    ///< 何フレーム目か
+        double deltaSeconds = 0.0;                  ///< 前のフレームからの実時間
+        double simulationSeconds = 0.0;             ///< 固定ステップで進めたシミュレーション時間
+        float interpolationAlpha = 0.0f;            ///< 直前の固定ステップから次の固定ステップまでの位置(0〜1。描画の補間用)
+        Platform::Timer::Time_Point updateBegin{};  ///< このフレームの Update を始めた時刻(遅延の計測用)
+        std::vector<DrawItem> drawItems;            ///< 描画要求
+        Core::Math::Float4x4 viewProjection = Core::Math::Identity(); ///< カメラのビュー射影行列(カリングに使う)
+        std::span<const uint32_t> visibleItems;     ///< 視錐台にかかる drawItems の番号(昇順。Update の最後に作る)
+    };
+}
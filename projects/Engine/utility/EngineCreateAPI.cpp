@@ -32,5 +32,14 @@ namespace Drama::API
             g_Engine->Run();
         }
     }
+    // ウィンドウ無しで稼働
+    DRAMA_API Drama::HeadlessRunResult RunHeadless(const Drama::HeadlessRunDesc& desc)
+    {
+        if (g_Engine)
+        {
+            return g_Engine->RunHeadless(desc);
+        }
+        return {};
+    }
 }
 #endif
@@ -14,5 +14,7 @@ namespace Drama::API
     static Drama::Engine* g_Engine = nullptr;
     // 稼働
     DRAMA_API void RunEngine();
+    // ウィンドウ無しで稼働(desc のフレーム数・時間に達したら戻る)
+    DRAMA_API Drama::HeadlessRunResult RunHeadless(const Drama::HeadlessRunDesc& desc);
 #endif
 }
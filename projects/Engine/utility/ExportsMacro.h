@@ -1,6 +1,10 @@
 #pragma once
+#if defined(_WIN32)
 #ifdef ENGINE_EXPORTS
 #define DRAMA_API __declspec(dllexport)
 #else
 #define DRAMA_API __declspec(dllimport)
 #endif
+#else
+#define DRAMA_API __attribute__((visibility("default")))
+#endif
@@ -0,0 +1,96 @@
+// === Drama Engine includes ===
+#include "Core/include/BinaryLogFormat.h"
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct Segment
+    {
+        const char* path = nullptr;
+        std::vector<uint8_t> bytes;
+        uint64_t startTimeNs = 0;
+        uint16_t index = 0;
+    };
+}
+
+// バイナリログ(engine_log.0.bin, engine_log.1.bin ...)をテキストに復号する
+// 使い方: LogDecoder <input.bin>... [-o output.txt]   出力省略時は標準出力
+// 入力はヘッダの(記録開始時刻, セグメント番号)順に並べ直すので、順不同で渡してよい
+int main(int argc, char** argv)
+{
+    std::vector<Segment> segments;
+    const char* outputPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+            continue;
+        }
+        Segment segment;
+        segment.path = argv[i];
+        segments.push_back(std::move(segment));
+    }
+    if (segments.empty())
+    {
+        std::fprintf(stderr, "usage: LogDecoder <input.bin>... [-o output.txt]\n");
+        return 2;
+    }
+
+    bool isComplete = true;
+    for (Segment& segment : segments)
+    {
+        std::ifstream ifs(segment.path, std::ios::binary);
+        if (!ifs)
+        {
+            std::fprintf(stderr, "cannot open: %s\n", segment.path);
+            return 1;
+        }
+        segment.bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        if (!Drama::Core::BinaryLog::ReadFileHeader(segment.bytes.data(), segment.bytes.size(), segment.startTimeNs, segment.index))
+        {
+            std::fprintf(stderr, "warning: not a binary log: %s\n", segment.path);
+            isComplete = false;
+        }
+    }
+    std::stable_sort(segments.begin(), segments.end(), [](const Segment& a, const Segment& b)
+        {
+            return std::tie(a.startTimeNs, a.index) < std::tie(b.startTimeNs, b.index);
+        });
+
+    std::string text;
+    for (const Segment& segment : segments)
+    {
+        if (!Drama::Core::BinaryLog::DecodeToText(segment.bytes.data(), segment.bytes.size(), text))
+        {
+            // 書き込み途中で落ちたログは末尾が欠けるので、読めた所までは出した上で知らせる
+            std::fprintf(stderr, "warning: %s is truncated or corrupted; decoded up to the last complete record\n", segment.path);
+            isComplete = false;
+        }
+    }
+
+    if (outputPath)
+    {
+        std::ofstream ofs(outputPath, std::ios::binary | std::ios::trunc);
+        if (!ofs)
+        {
+            std::fprintf(stderr, "cannot open: %s\n", outputPath);
+            return 1;
+        }
+        ofs.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    else
+    {
+        std::fwrite(text.data(), 1, text.size(), stdout);
+    }
+    return isComplete ? 0 : 1;
+}
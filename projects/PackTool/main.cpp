@@ -0,0 +1,106 @@
+// === Drama Engine includes ===
+#include "Core/include/ArchiveFileSystem.h"
+#include "Core/include/PackBuilder.h"
+#if defined(_WIN32)
+#include "Platform/include/WinFileSystem.h"
+#else
+#include "Platform/include/PosixFileSystem.h"
+#endif
+
+// === C++ standard library includes ===
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+#if defined(_WIN32)
+    using PlatformFileSystem = Drama::Platform::IO::WinFileSystem;
+#else
+    using PlatformFileSystem = Drama::Platform::IO::PosixFileSystem;
+#endif
+
+    int Build(PlatformFileSystem& fs, const std::string& sourceDir, const std::string& outPath)
+    {
+        // 列挙はツール側だけの処理なので std::filesystem で済ませる
+        std::error_code ec;
+        const std::filesystem::path root = std::filesystem::path(sourceDir);
+        std::vector<std::filesystem::path> files;
+        for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
+            !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (it->is_regular_file(ec))
+            {
+                files.push_back(it->path());
+            }
+        }
+        if (ec)
+        {
+            std::fprintf(stderr, "cannot enumerate: %s (%s)\n", sourceDir.c_str(), ec.message().c_str());
+            return 1;
+        }
+        // 同じ入力から同じパックができるように並べておく
+        std::sort(files.begin(), files.end());
+
+        Drama::Core::IO::PackBuilder builder;
+        for (const std::filesystem::path& p : files)
+        {
+            const std::string virtualPath = p.lexically_relative(root).generic_string();
+            if (!builder.Add(virtualPath, p.string()))
+            {
+                std::fprintf(stderr, "duplicate path: %s\n", virtualPath.c_str());
+                return 1;
+            }
+        }
+
+        const Drama::Core::IO::FsResult r = builder.Build(fs, outPath);
+        if (!r)
+        {
+            std::fprintf(stderr, "pack failed: %s\n", r.message.c_str());
+            return 1;
+        }
+        std::printf("packed %zu files into %s\n", builder.Count(), outPath.c_str());
+        return 0;
+    }
+
+    int List(PlatformFileSystem& fs, const std::string& packPath)
+    {
+        Drama::Core::IO::ArchiveFileSystem archive;
+        const Drama::Core::IO::FsResult r = archive.Open(fs, packPath);
+        if (!r)
+        {
+            std::fprintf(stderr, "cannot open pack: %s\n", r.message.c_str());
+            return 1;
+        }
+        for (size_t i = 0; i < archive.EntryCount(); ++i)
+        {
+            const std::string_view path = archive.EntryPath(i);
+            std::span<const uint8_t> bytes;
+            archive.Find(path, bytes);
+            std::printf("%12zu  %.*s\n", bytes.size(), static_cast<int>(path.size()), path.data());
+        }
+        return 0;
+    }
+}
+
+// パックファイルを作る / 中身を一覧する
+// 使い方: PackTool <sourceDir> <output.pak>
+//         PackTool --list <input.pak>
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: PackTool <sourceDir> <output.pak>\n       PackTool --list <input.pak>\n");
+        return 2;
+    }
+
+    PlatformFileSystem fs;
+    if (std::string_view(argv[1]) == "--list")
+    {
+        return List(fs, argv[2]);
+    }
+    return Build(fs, argv[1], argv[2]);
+}
@@ -0,0 +1,101 @@
+#pragma once
+// === C++ Standard Library ===
+#include <cstdint>
+
+#include "Platform/include/Timer.h"
+
+namespace Drama::Platform
+{
+    /// @brief フレームクロックの設定
+    struct FrameClockDesc
+    {
+        double fixedStepSeconds = 1.0 / 60.0; ///< 固定ステップ1回で進めるシミュレーション時間
+        uint32_t maxCatchUpSteps = 5;         ///< 1フレームで実行する固定ステップの上限(超えた分の時間は捨てる)
+        double targetFps = 0.0;               ///< フレームリミッタの目標(0 なら待たない)
+        /// @brief 目標時刻のこれだけ手前まで眠り、残りは回って待つ
+        /// @note OS のスリープは起床が数十us〜1ms 遅れるので、その分を回って吸収する。大きいほど正確だが CPU を食う
+        double spinSeconds = 0.001;
+    };
+
+    /// @brief フレーム時間の統計(ResetStats からの累計)
+    struct FrameTimeStats
+    {
+        uint64_t frames = 0;         ///< 計測したフレーム間隔の数
+        double lastSeconds = 0.0;    ///< 直前のフレーム間隔
+        double averageSeconds = 0.0;
+        double minSeconds = 0.0;
+        double maxSeconds = 0.0;
+        /// @brief 目標間隔からのずれの平均・最大(リミッタ無効時は直前の間隔からの変化)
+        double jitterAverageSeconds = 0.0;
+        double jitterMaxSeconds = 0.0;
+        uint64_t droppedSteps = 0;   ///< 上限を超えて捨てた固定ステップ数
+    };
+
+    /// @brief 固定ステップのシミュレーションとフレームの速さをまとめて管理する時計
+    /// @note 1フレームの使い方:
+    ///       BeginFrame() → while (StepFixed()) { 固定ステップ更新 } → Alpha() で描画を補間 → WaitForNextFrame()。
+    ///       固定ステップは経過時間を貯めて fixedStepSeconds ごとに取り出す(フレームの速さに依存しない)。
+    ///       処理落ちで貯まりすぎた分は maxCatchUpSteps で打ち切り、追いつこうとして更に遅れる悪循環を防ぐ
+    class FrameClock final
+    {
+    public:
+        FrameClock() noexcept;
+        explicit FrameClock(const FrameClockDesc& desc) noexcept;
+        ~FrameClock() noexcept;
+        FrameClock(const FrameClock&) = delete;
+        FrameClock& operator=(const FrameClock&) = delete;
+
+        /// @brief 設定を変えて最初からやり直す
+        void Reset(const FrameClockDesc& desc) noexcept;
+
+        /// @brief フレーム開始。前回の BeginFrame からの経過時間を貯める
+        /// @return 前回からの経過時間(秒。初回は 0)
+        double BeginFrame() noexcept;
+        /// @brief 経過時間を直接貯める(BeginFrame の計測部分を除いたもの。再生やテスト用)
+        void Accumulate(double deltaSeconds) noexcept;
+        /// @brief 固定ステップを1回分取り出す
+        /// @return 実行すべきならtrue(このフレームで上限回数に達したら、残りを捨てて false)
+        bool StepFixed() noexcept;
+        /// @brief 描画の補間係数(前の固定ステップから次の固定ステップまでのどこにいるか。0〜1)
+        double Alpha() const noexcept { return m_Accumulator / m_Desc.fixedStepSeconds; }
+
+        /// @brief 目標の間隔になるまで待つ(眠ってから回る)
+        /// @note 目標時刻は前回の目標時刻から数えるので、待ちの誤差が積み重ならない。
+        ///       1間隔以上遅れた場合は今から数え直す(遅れを取り戻すために連続で待たないフレームを作らない)
+        void WaitForNextFrame() noexcept;
+
+        double FixedStepSeconds() const noexcept { return m_Desc.fixedStepSeconds; }
+        double DeltaSeconds() const noexcept { return m_Delta; }
+        /// @brief 固定ステップで進めたシミュレーション時間の合計
+        double SimulationSeconds() const noexcept { return m_SimulationSeconds; }
+        /// @brief Reset からの実時間
+        double ElapsedSeconds() const noexcept { return m_Timer.ElapsedSeconds(); }
+        uint64_t FrameIndex() const noexcept { return m_FrameIndex; }
+
+        FrameTimeStats Stats() const noexcept;
+        void ResetStats() noexcept;
+
+    private:
+        void Record(double interval) noexcept;
+
+        FrameClockDesc m_Desc{};
+        Timer m_Timer;                        ///< Reset からの実時間
+        Timer::Time_Point m_LastBegin{};      ///< 前回の BeginFrame(初回は未設定)
+        Timer::Time_Point m_NextDeadline{};   ///< リミッタの次の目標時刻
+        double m_Delta = 0.0;
+        double m_Accumulator = 0.0;
+        double m_SimulationSeconds = 0.0;
+        uint32_t m_StepsThisFrame = 0;
+        uint64_t m_FrameIndex = 0;
+
+        // 統計
+        uint64_t m_StatFrames = 0;
+        double m_StatLast = 0.0;
+        double m_StatSum = 0.0;
+        double m_StatMin = 0.0;
+        double m_StatMax = 0.0;
+        double m_StatJitterSum = 0.0;
+        double m_StatJitterMax = 0.0;
+        uint64_t m_DroppedSteps = 0;
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+//====================================
+// C++ standard library includes
+#include <atomic>
+#include <cstdint>
+//====================================
+#include "Platform/include/IWindow.h"
+
+namespace Drama::Platform
+{
+    /// @brief 表示先を持たないウィンドウ(サーバー・バッチ・CI 用)
+    /// @note OS に依存しないのでどのプラットフォームでも使える。RequestQuit されるまで PumpMessages は継続を返す
+    class HeadlessWindow final : public IWindow
+    {
+    public:
+        bool Create(uint32_t w = 1280, uint32_t h = 720) override;
+        void Show(bool isMaxSize = false) override;
+        void Shutdown() override;
+
+        [[nodiscard]] bool PumpMessages() override;
+
+        uint32_t Width() const noexcept override { return m_Width; }
+        uint32_t Height() const noexcept override { return m_Height; }
+        void* NativeHandle() const noexcept override { return nullptr; }
+
+        /// @brief 次の PumpMessages で終了を返させる(どのスレッドから呼んでもよい)
+        void RequestQuit() noexcept { m_QuitRequested.store(true, std::memory_order_release); }
+
+    private:
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        std::atomic<bool> m_QuitRequested{ false };
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+//====================================
+// C++ standard library includes
+#include <cstdint>
+//====================================
+
+namespace Drama::Platform
+{
+    /// @brief エンジンのメインループが使うウィンドウ(表示先)の抽象
+    /// @note 実装は Windows(Win32 ウィンドウ)と HeadlessWindow(表示先を持たない)
+    class IWindow
+    {
+    public:
+        virtual ~IWindow() = default;
+
+        /// @brief ウィンドウ作成
+        /// @return 成功ならtrue、失敗ならfalse
+        virtual bool Create(uint32_t w = 1280, uint32_t h = 720) = 0;
+        virtual void Show(bool isMaxSize = false) = 0;
+        virtual void Shutdown() = 0;
+
+        /// @brief ウィンドウメッセージ処理
+        /// @return 継続ならtrue、終了ならfalse
+        [[nodiscard]] virtual bool PumpMessages() = 0;
+
+        virtual uint32_t Width() const noexcept = 0;
+        virtual uint32_t Height() const noexcept = 0;
+        /// @brief OS のウィンドウハンドル(表示先が無ければ nullptr)
+        virtual void* NativeHandle() const noexcept = 0;
+    };
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <memory>
+#include "Core/include/IFileWatcher.h"
+
+#if defined(__linux__)
+namespace Drama::Platform::IO
+{
+    /// @brief inotify による IFileWatcher 実装
+    /// @note ノンブロッキングの inotify を Poll で読むだけなので監視用のスレッドは持たない。
+    ///       通知の無いフレームは read が EAGAIN を返す1回のシステムコールで終わる。
+    ///       書き換えは IN_CLOSE_WRITE で拾う(書きかけの途中では通知しない)。
+    class LinuxFileWatcher final : public Drama::Core::IO::IFileWatcher
+    {
+    public:
+        explicit LinuxFileWatcher(const Drama::Core::IO::FileWatchDesc& desc = {});
+        ~LinuxFileWatcher() override;
+
+        Drama::Core::IO::FsResult Watch(std::string_view directory, bool recursive, Drama::Core::IO::FileWatchId& out) noexcept override;
+        void Unwatch(Drama::Core::IO::FileWatchId id) noexcept override;
+        size_t Poll(std::vector<Drama::Core::IO::FileChange>& out) noexcept override;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_Impl;
+    };
+}
+#endif
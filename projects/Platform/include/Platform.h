@@ -5,10 +5,12 @@
 #include <memory>
 #include <string>
 //====================================
+#include "Platform/include/IWindow.h"
 
 namespace Drama::Platform
 {
-    class Windows final
+    /// @brief Win32 ウィンドウ
+    class Windows final : public IWindow
     {
     public:
         Windows();
@@ -16,17 +18,17 @@ namespace Drama::Platform
 
         /// @brief ウィンドウ作成
         /// @return 成功ならtrue、失敗ならfalse
-        bool Create(uint32_t w = 1280, uint32_t h = 720);
-        void Show(bool isMaxSize = false);
-        void Shutdown();
+        bool Create(uint32_t w = 1280, uint32_t h = 720) override;
+        void Show(bool isMaxSize = false) override;
+        void Shutdown() override;
 
         /// @brief ウィンドウメッセージ処理
-        /// @return 終了ならtrue、継続ならfalse
-        [[nodiscard]] bool PumpMessages();
+        /// @return 継続ならtrue、終了(WM_QUIT)ならfalse
+        [[nodiscard]] bool PumpMessages() override;
 
-        uint32_t Width() const noexcept;
-        uint32_t Height() const noexcept;
-        void* NativeHandle() const noexcept;
+        uint32_t Width() const noexcept override;
+        uint32_t Height() const noexcept override;
+        void* NativeHandle() const noexcept override;
 
         static std::string ToUTF8(const std::wstring& utf16Str);
         static std::wstring ToUTF16(const std::string& utf8Str);
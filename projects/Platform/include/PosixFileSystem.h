@@ -0,0 +1,40 @@
+#pragma once
+#include "Core/include/IFileSystem.h"
+
+#if !defined(_WIN32)
+namespace Drama::Platform::IO
+{
+    /// @brief POSIX(Linux)向けの IFileSystem 実装
+    class PosixFileSystem final : public Drama::Core::IO::IFileSystem
+    {
+    public:
+        Drama::Core::IO::FsResult Exists(std::string_view path) noexcept override;
+        Drama::Core::IO::FsResult CreateDirectories(std::string_view path) noexcept override;
+
+        /// @brief 上書き
+        Drama::Core::IO::FsResult WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        /// @brief 読み取り
+        Drama::Core::IO::FsResult ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept override;
+        /// @brief 読み取り専用マップ(mmap。マップできなければ読み込みにフォールバック)
+        Drama::Core::IO::FsResult MapReadOnly(std::string_view path, Drama::Core::IO::MappedFile& out) noexcept override;
+        /// @brief 追記
+        Drama::Core::IO::FsResult AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
+        /// @brief 安全な保存(fsync → rename → ディレクトリfsync)
+        Drama::Core::IO::FsResult WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept override;
+        /// @brief ファイルを消す
+        Drama::Core::IO::FsResult Remove(std::string_view path) noexcept override;
+        /// @brief ファイルサイズ(開かずに stat で調べる)
+        Drama::Core::IO::FsResult FileSize(std::string_view path, uint64_t& out) noexcept override;
+        /// @brief 最終更新時刻(stat の st_mtim)
+        Drama::Core::IO::FsResult LastWriteTime(std::string_view path, uint64_t& outNs) noexcept override;
+        /// @brief 読み込みストリーム
+        Drama::Core::IO::FsResult OpenRead(std::string_view path, std::unique_ptr<Drama::Core::IO::IFileReader>& out) noexcept override;
+        /// @brief 書き込みストリーム
+        Drama::Core::IO::FsResult OpenWrite(std::string_view path, Drama::Core::IO::FileWriteMode mode, std::unique_ptr<Drama::Core::IO::IFileWriter>& out) noexcept override;
+        /// @brief コピー(Linuxでは copy_file_range でユーザー空間を経由しない)
+        Drama::Core::IO::FsResult CopyAllBytes(std::string_view src, std::string_view dst) noexcept override;
+
+        std::string currentPath() noexcept override;
+    };
+}
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+// === C++ Standard Library ===
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Core/include/IFileSystem.h"
+#include "Platform/include/TscClock.h"
+
+// 計測マクロを有効にするか。Debug / Develop では有効、Release では何も生成しない。
+// プロジェクト設定で DRAMA_PROFILE=0/1 を定義すれば上書きできる
+#if !defined(DRAMA_PROFILE)
+#if defined(_DEBUG) || defined(DEVELOP)
+#define DRAMA_PROFILE 1
+#else
+#define DRAMA_PROFILE 0
+#endif
+#endif
+
+namespace Drama::Platform::Profile
+{
+    /// @brief 記録の種類
+    enum class EventKind : uint32_t
+    {
+        Zone,    ///< 区間(begin〜end)
+        Frame,   ///< フレームの区切り(value はフレーム番号)
+        Counter, ///< 数値の記録(value)
+    };
+
+    /// @brief 1件の記録(スレッドごとのバッファに積む)
+    struct Event
+    {
+        const char* name = nullptr; ///< 文字列リテラルなど、書き出しまで生きている文字列
+        uint64_t begin = 0;         ///< TscClock::Ticks()
+        uint64_t end = 0;           ///< 区間の終わり(Zone のみ)
+        double value = 0.0;         ///< Frame / Counter の値
+        EventKind kind = EventKind::Zone;
+    };
+
+    /// @brief 計測の設定
+    struct CaptureDesc
+    {
+        uint64_t maxEventsPerThread = 1u << 18; ///< 1スレッドが1回の計測で積める数(超えた分は捨てて数える)
+    };
+
+    /// @brief 直近の計測の集計
+    struct CaptureStats
+    {
+        uint32_t threads = 0;       ///< 記録のあったスレッド数
+        uint64_t events = 0;        ///< 記録した数
+        uint64_t droppedEvents = 0; ///< 上限を超えて捨てた数
+        uint64_t frames = 0;        ///< フレームの区切りの数
+    };
+
+    /// @brief CPU の区間計測
+    /// @note 記録はスレッドごとのバッファに積むだけで、ロックも他スレッドとの共有書き込みも無い
+    ///       (スレッドが最初に記録したときだけ登録のためにロックを取る)。時刻は TscClock の生のカウントのまま持ち、
+    ///       ナノ秒への変換は書き出し時にまとめて行う。
+    ///       書き出しは Chrome Trace Event 形式の JSON(chrome://tracing や Perfetto UI でそのまま開ける)。
+    ///       区間の入れ子はスレッドごとの時刻の包含関係で表れる。
+    ///       ジョブの中で Wait をまたいだ区間は、ファイバーが移った先のスレッドに記録されることがある
+    class Profiler final
+    {
+    public:
+        /// @brief 計測開始(前回の記録は捨てる)
+        static void Start(const CaptureDesc& desc = {}) noexcept;
+        /// @brief 計測停止(以後の区間は記録しない。既に開いている区間は閉じたときに記録する)
+        static void Stop() noexcept;
+        /// @brief 計測中か
+        static bool IsCapturing() noexcept
+        {
+            return s_Capturing.load(std::memory_order_relaxed);
+        }
+
+        /// @brief 区間を記録(通常は Zone / DRAMA_PROFILE_ZONE から呼ばれる)
+        static void RecordZone(const char* name, uint64_t beginTicks, uint64_t endTicks) noexcept;
+        /// @brief フレームの区切りを記録(メインループの先頭で1回呼ぶ)
+        static void FrameMark() noexcept;
+        /// @brief 数値を記録(ビューアではグラフになる)
+        static void Counter(const char* name, double value) noexcept;
+        /// @brief 呼び出しスレッドの表示名を設定(計測中でなくてもよい)
+        static void SetThreadName(std::string_view name);
+
+        /// @brief 直近の計測の集計
+        /// @note 記録中のスレッドがあっても呼べる(その時点で書き終えた分を数える)
+        static CaptureStats Stats() noexcept;
+        /// @brief 直近の計測を Chrome Trace Event 形式の JSON にする
+        /// @note Stop してから呼ぶ。記録中のスレッドがあっても壊れはしないが、次の Start とは重ねないこと
+        static void ExportChromeTrace(std::string& out);
+        /// @brief 直近の計測を JSON でファイルに書き出す(親ディレクトリが無ければ作る)
+        static Core::IO::FsResult WriteChromeTrace(Core::IO::IFileSystem& fs, std::string_view path);
+
+    private:
+        static inline std::atomic<bool> s_Capturing{ false };
+    };
+
+    /// @brief スコープの区間を記録する(作ったときに計測中でなければ何もしない)
+    class Zone final
+    {
+    public:
+        explicit Zone(const char* name) noexcept
+            : m_Name(Profiler::IsCapturing() ? name : nullptr)
+            , m_Begin(m_Name ? TscClock::Ticks() : 0)
+        {
+        }
+        ~Zone() noexcept
+        {
+            if (m_Name)
+            {
+                Profiler::RecordZone(m_Name, m_Begin, TscClock::Ticks());
+            }
+        }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* m_Name;
+        uint64_t m_Begin;
+    };
+}
+
+#if DRAMA_PROFILE
+#define DRAMA_PROFILE_CONCAT_INNER(a, b) a##b
+#define DRAMA_PROFILE_CONCAT(a, b) DRAMA_PROFILE_CONCAT_INNER(a, b)
+/// @brief スコープの終わりまでを name の区間として記録する(name は文字列リテラル)
+#define DRAMA_PROFILE_ZONE(name) ::Drama::Platform::Profile::Zone DRAMA_PROFILE_CONCAT(dramaProfileZone_, __LINE__)(name)
+/// @brief 関数全体を関数名の区間として記録する
+#define DRAMA_PROFILE_FUNCTION() DRAMA_PROFILE_ZONE(__func__)
+/// @brief フレームの区切り
+#define DRAMA_PROFILE_FRAME() ::Drama::Platform::Profile::Profiler::FrameMark()
+/// @brief 数値の記録
+#define DRAMA_PROFILE_COUNTER(name, value) ::Drama::Platform::Profile::Profiler::Counter(name, static_cast<double>(value))
+/// @brief 呼び出しスレッドの表示名
+#define DRAMA_PROFILE_THREAD(name) ::Drama::Platform::Profile::Profiler::SetThreadName(name)
+#else
+// 引数も評価しない
+#define DRAMA_PROFILE_ZONE(name) ((void)0)
+#define DRAMA_PROFILE_FUNCTION() ((void)0)
+#define DRAMA_PROFILE_FRAME() ((void)0)
+#define DRAMA_PROFILE_COUNTER(name, value) ((void)0)
+#define DRAMA_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -1,14 +1,22 @@
 #pragma once
 // === C++ Standard Library ===
 #include <chrono>
+#include <cstdint>
+
+#include "Platform/include/TscClock.h"
 
 namespace Drama::Platform
 {
-    class Timer final
+    /// @brief 経過時間の計測
+    /// @tparam ClockSource 時刻の取り方。SteadyClock(既定。std::chrono::steady_clock)か TscClock(CPU のタイムスタンプカウンタ)
+    /// @note 大量に計測する場合(プロファイラのゾーンなど)は TscTimer を使うか、ClockSource::Ticks() で生のカウントだけ取って
+    ///       後でまとめて ClockSource::TicksToNanoseconds() で変換する
+    template <class ClockSource = SteadyClock>
+    class BasicTimer final
     {
     public:
-        using Clock = std::chrono::steady_clock;///< 単調増加クロック
-        using Time_Point = Clock::time_point;///< 時間点,記録用
+        using Clock = ClockSource;///< 単調増加クロック
+        using Time_Point = typename Clock::time_point;///< 時間点,記録用
         using Duration = std::chrono::duration<double>;///< 経過時間,秒単位
         using nanos = std::chrono::nanoseconds;// ナノ秒
         using micrs = std::chrono::microseconds;// マイクロ秒
@@ -16,12 +24,12 @@ namespace Drama::Platform
         using secs = std::chrono::seconds;// 秒
 
         /// @brief コンストラクタ
-        Timer() noexcept
+        BasicTimer() noexcept
         {
             Reset();
         }
         /// @brief デストラクタ
-        ~Timer() noexcept = default;
+        ~BasicTimer() noexcept = default;
         /// @brief リセット
         void Reset() noexcept
         {
@@ -44,64 +52,42 @@ namespace Drama::Platform
         {
             if (m_Running)
             {
-                m_Elapsed += Clock::now() - m_Start;
+                // 時刻の取得は1回だけにする(経過時間と終了時刻がずれず、取得の費用も半分)
+                const Time_Point now = Clock::now();
+                m_Elapsed += now - m_Start;
                 m_Running = false;
-                m_End = Clock::now();
+                m_End = now;
             }
         }
         /// @brief 開始からの経過時間を秒単位で取得
-        /// @return 経過時間(秒) 
+        /// @return 経過時間(秒)
         double ElapsedSeconds() const noexcept
         {
-            auto total = m_Elapsed;
-            if (m_Running)
-            {
-                total += (Clock::now() - m_Start);
-            }
-            return total.count();
+            return Total().count();
         }
         secs ElapsedSecondsDuration() const noexcept
         {
-            auto total = m_Elapsed;
-            if (m_Running)
-            {
-                total += (Clock::now() - m_Start);
-            }
-            return std::chrono::duration_cast<secs>(total);
+            return std::chrono::duration_cast<secs>(Total());
         }
         /// @brief 経過時間をミリ秒単位で返します
         /// @return 経過時間をミリ秒単位で表す
         double ElapsedMilliseconds() const noexcept
         {
-            auto total = m_Elapsed;
-            if (m_Running) total += (Clock::now() - m_Start);
-            return total.count() * 1000.0;
+            return Total().count() * 1000.0;
         }
         millis ElapsedMillisecondsDuration() const noexcept
         {
-            auto total = m_Elapsed;
-            if (m_Running)
-            {
-                total += (Clock::now() - m_Start);
-            }
-            return std::chrono::duration_cast<millis>(total);
+            return std::chrono::duration_cast<millis>(Total());
         }
         /// @brief 経過時間をマイクロ秒単位で返します
         /// @return 経過時間をマイクロ秒単位で表す
         double ElapsedMicroseconds() const noexcept
         {
-            auto total = m_Elapsed;
-            if (m_Running) total += (Clock::now() - m_Start);
-            return total.count() * 1'000'000.0;
+            return Total().count() * 1'000'000.0;
         }
         micrs ElapsedMicrosecondsDuration() const noexcept
         {
-            auto total = m_Elapsed;
-            if (m_Running)
-            {
-                total += (Clock::now() - m_Start);
-            }
-            return std::chrono::duration_cast<micrs>(total);
+            return std::chrono::duration_cast<micrs>(Total());
         }
         /// @brief 動作中かどうか取得
         bool IsRunning() const noexcept { return m_Running; }
@@ -109,10 +95,25 @@ namespace Drama::Platform
         Time_Point StartTime() const noexcept { return m_Start; }
 
     private:
+        /// @brief 停止までの累計と、動作中ならその区間を足した経過時間
+        Duration Total() const noexcept
+        {
+            Duration total = m_Elapsed;
+            if (m_Running)
+            {
+                total += Clock::now() - m_Start;
+            }
+            return total;
+        }
+
         Time_Point m_Start{};///< 開始時間点
         Time_Point m_End{};///< 終了時間点
         bool m_Running = false;///< 動作中フラグ
         Duration m_Elapsed{};///< 経過時間
     };
-}
 
+    /// @brief std::chrono::steady_clock で計るタイマー(従来の Timer)
+    using Timer = BasicTimer<SteadyClock>;
+    /// @brief CPU のタイムスタンプカウンタで計るタイマー(使えない CPU では steady_clock になる)
+    using TscTimer = BasicTimer<TscClock>;
+}
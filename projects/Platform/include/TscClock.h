@@ -0,0 +1,124 @@
+#pragma once
+// === C++ Standard Library ===
+#include <chrono>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define DRAMA_HAS_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace Drama::Platform
+{
+    /// @brief std::chrono::steady_clock に生のカウント取得と変換を足したもの(TscClock と同じ使い方ができる)
+    struct SteadyClock : std::chrono::steady_clock
+    {
+        /// @brief 生のカウント(steady_clock の刻み)
+        static uint64_t Ticks() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+        /// @brief Ticks と同じ(順序付けの違いは無い)
+        static uint64_t TicksOrdered() noexcept
+        {
+            return Ticks();
+        }
+        /// @brief Ticks の値をナノ秒にする
+        static int64_t TicksToNanoseconds(uint64_t ticks) noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(duration(static_cast<rep>(ticks))).count();
+        }
+    };
+
+    /// @brief CPU のタイムスタンプカウンタ(rdtsc)を使う時計
+    /// @note steady_clock::now() は vDSO 経由でも数十ns、環境によってはシステムコールになる。
+    ///       rdtsc はユーザー空間の1命令なので、プロファイラのように1フレームに何千回も時刻を取る用途に向く。
+    ///       周波数が一定(invariant TSC)の x86-64 でだけ使い、それ以外は steady_clock のナノ秒をそのまま返す。
+    ///       周波数は最初に使ったときに steady_clock と突き合わせて求める(数ms かかる)。
+    ///       std::chrono の Clock の要件を満たすので BasicTimer<TscClock> や chrono の演算にそのまま使える
+    class TscClock final
+    {
+    public:
+        using rep = int64_t;
+        using period = std::nano;
+        using duration = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<TscClock>;
+        static constexpr bool is_steady = true;
+
+        /// @brief 較正結果
+        struct Calibration
+        {
+            bool useTsc = false;         ///< false なら Ticks は steady_clock のナノ秒
+            uint64_t baseTicks = 0;      ///< 較正時のカウント
+            int64_t baseNanoseconds = 0; ///< 較正時の steady_clock(now() の起点をそろえる)
+            double nanosecondsPerTick = 1.0;
+            double ticksPerSecond = 1e9;
+        };
+
+        /// @brief 現在時刻(カウントを読んでナノ秒に変換する)
+        static time_point now() noexcept
+        {
+            return time_point(duration(TicksToNanoseconds(Ticks())));
+        }
+
+        /// @brief 生のカウント(変換しない。計測区間の両端はこれで取り、後でまとめて変換する)
+        /// @note rdtsc は前の命令の完了を待たずに読まれることがあるので、数十命令より短い区間の計測には向かない
+        static uint64_t Ticks() noexcept
+        {
+#if defined(DRAMA_HAS_TSC)
+            if (Params().useTsc)
+            {
+                return __rdtsc();
+            }
+#endif
+            return SteadyNanoseconds();
+        }
+
+        /// @brief 先行する命令がすべて終わってから読むカウント(rdtscp。区間の終わり側に使う)
+        static uint64_t TicksOrdered() noexcept
+        {
+#if defined(DRAMA_HAS_TSC)
+            if (Params().useTsc)
+            {
+                unsigned int aux = 0;
+                return __rdtscp(&aux);
+            }
+#endif
+            return SteadyNanoseconds();
+        }
+
+        /// @brief Ticks の値をナノ秒にする(起点は steady_clock とそろえてある)
+        static int64_t TicksToNanoseconds(uint64_t ticks) noexcept
+        {
+            const Calibration& c = Params();
+            return static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(ticks - c.baseTicks)) * c.nanosecondsPerTick)
+                + c.baseNanoseconds;
+        }
+        /// @brief カウントの差(区間の長さ)をナノ秒にする
+        static double TickDeltaToNanoseconds(uint64_t delta) noexcept
+        {
+            return static_cast<double>(delta) * Params().nanosecondsPerTick;
+        }
+
+        static bool UsesTsc() noexcept { return Params().useTsc; }
+        static double TicksPerSecond() noexcept { return Params().ticksPerSecond; }
+
+        /// @brief 較正結果(初回呼び出しで較正する。以後はスレッドセーフに読むだけ)
+        static const Calibration& Params() noexcept
+        {
+            static const Calibration calibration = Calibrate();
+            return calibration;
+        }
+
+    private:
+        static Calibration Calibrate() noexcept;
+        static uint64_t SteadyNanoseconds() noexcept
+        {
+            return static_cast<uint64_t>(SteadyClock::TicksToNanoseconds(SteadyClock::Ticks()));
+        }
+    };
+}
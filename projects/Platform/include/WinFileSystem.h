@@ -8,15 +8,27 @@ namespace Drama::Platform::IO
     public:
         Drama::Core::IO::FsResult Exists(std::string_view path) noexcept override;
         Drama::Core::IO::FsResult CreateDirectories(std::string_view path) noexcept override;
+        Drama::Core::IO::FsResult Remove(std::string_view path) noexcept override;
+        Drama::Core::IO::FsResult FileSize(std::string_view path, uint64_t& out) noexcept override;
+        /// @brief 最終更新時刻(GetFileAttributesEx の ftLastWriteTime)
+        Drama::Core::IO::FsResult LastWriteTime(std::string_view path, uint64_t& outNs) noexcept override;
 
         /// @brief 上書き
         Drama::Core::IO::FsResult WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
         /// @brief 読み取り
         Drama::Core::IO::FsResult ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept override;
+        /// @brief 読み取り専用マップ(CreateFileMapping。マップできなければ読み込みにフォールバック)
+        Drama::Core::IO::FsResult MapReadOnly(std::string_view path, Drama::Core::IO::MappedFile& out) noexcept override;
         /// @brief 追記
         Drama::Core::IO::FsResult AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept override;
         /// @brief 安全な保存
         Drama::Core::IO::FsResult WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept override;
+        /// @brief 読み込みストリーム
+        Drama::Core::IO::FsResult OpenRead(std::string_view path, std::unique_ptr<Drama::Core::IO::IFileReader>& out) noexcept override;
+        /// @brief 書き込みストリーム
+        Drama::Core::IO::FsResult OpenWrite(std::string_view path, Drama::Core::IO::FileWriteMode mode, std::unique_ptr<Drama::Core::IO::IFileWriter>& out) noexcept override;
+        /// @brief コピー
+        Drama::Core::IO::FsResult CopyAllBytes(std::string_view src, std::string_view dst) noexcept override;
 
         std::string currentPath() noexcept override;
     };
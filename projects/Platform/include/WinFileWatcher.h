@@ -0,0 +1,27 @@
+#pragma once
+#include <memory>
+#include "Core/include/IFileWatcher.h"
+
+#if defined(_WIN32)
+namespace Drama::Platform::IO
+{
+    /// @brief ReadDirectoryChangesW による IFileWatcher 実装
+    /// @note 監視ディレクトリごとの非同期要求を1つのI/O完了ポートで受けるので、
+    ///       Poll は監視の数に関係なく GetQueuedCompletionStatusEx(待ち時間0) を呼ぶだけで済む。
+    ///       再帰監視は OS の bWatchSubtree に任せる。
+    class WinFileWatcher final : public Drama::Core::IO::IFileWatcher
+    {
+    public:
+        explicit WinFileWatcher(const Drama::Core::IO::FileWatchDesc& desc = {});
+        ~WinFileWatcher() override;
+
+        Drama::Core::IO::FsResult Watch(std::string_view directory, bool recursive, Drama::Core::IO::FileWatchId& out) noexcept override;
+        void Unwatch(Drama::Core::IO::FileWatchId id) noexcept override;
+        size_t Poll(std::vector<Drama::Core::IO::FileChange>& out) noexcept override;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_Impl;
+    };
+}
+#endif
@@ -0,0 +1,199 @@
+#include "pch.h"
+#include "include/FrameClock.h"
+
+// === C++ Standard Library ===
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib") // timeBeginPeriod, timeEndPeriod
+#endif
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    /// @brief 回って待つ間の一呼吸(同じコアのもう一方のハイパースレッドに実行資源を譲る)
+    inline void CpuRelax() noexcept
+    {
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+}
+
+namespace Drama::Platform
+{
+    FrameClock::FrameClock() noexcept
+        : FrameClock(FrameClockDesc{})
+    {
+    }
+
+    FrameClock::FrameClock(const FrameClockDesc& desc) noexcept
+    {
+#if defined(_WIN32)
+        // 既定のタイマー分解能(15.6ms)ではスリープの起床が遅れすぎて、回る時間の方が長くなる
+        timeBeginPeriod(1);
+#endif
+        Reset(desc);
+    }
+
+    FrameClock::~FrameClock() noexcept
+    {
+#if defined(_WIN32)
+        timeEndPeriod(1);
+#endif
+    }
+
+    void FrameClock::Reset(const FrameClockDesc& desc) noexcept
+    {
+        m_Desc = desc;
+        if (!(m_Desc.fixedStepSeconds > 0.0))
+        {
+            m_Desc.fixedStepSeconds = 1.0 / 60.0;
+        }
+        m_Desc.maxCatchUpSteps = std::max(1u, m_Desc.maxCatchUpSteps);
+        m_Desc.spinSeconds = std::max(0.0, m_Desc.spinSeconds);
+        m_Timer.Reset();
+        m_Timer.Start();
+        m_LastBegin = Timer::Time_Point{};
+        m_NextDeadline = Timer::Time_Point{};
+        m_Delta = 0.0;
+        m_Accumulator = 0.0;
+        m_SimulationSeconds = 0.0;
+        m_StepsThisFrame = 0;
+        m_FrameIndex = 0;
+        ResetStats();
+    }
+
+    double FrameClock::BeginFrame() noexcept
+    {
+        const Timer::Time_Point now = Timer::Clock::now();
+        double delta = 0.0;
+        if (m_LastBegin != Timer::Time_Point{})
+        {
+            delta = Timer::Duration(now - m_LastBegin).count();
+            Record(delta);
+        }
+        m_LastBegin = now;
+        ++m_FrameIndex;
+        Accumulate(delta);
+        return delta;
+    }
+
+    void FrameClock::Accumulate(double deltaSeconds) noexcept
+    {
+        m_Delta = std::max(0.0, deltaSeconds);
+        m_Accumulator += m_Delta;
+        m_StepsThisFrame = 0;
+    }
+
+    bool FrameClock::StepFixed() noexcept
+    {
+        const double step = m_Desc.fixedStepSeconds;
+        if (m_Accumulator < step)
+        {
+            return false;
+        }
+        if (m_StepsThisFrame >= m_Desc.maxCatchUpSteps)
+        {
+            // 追いつけない分は捨てる(ステップ未満の端数は補間に使うので残す)
+            const double dropped = std::floor(m_Accumulator / step);
+            m_DroppedSteps += static_cast<uint64_t>(dropped);
+            m_Accumulator -= dropped * step;
+            return false;
+        }
+        m_Accumulator -= step;
+        m_SimulationSeconds += step;
+        ++m_StepsThisFrame;
+        return true;
+    }
+
+    void FrameClock::WaitForNextFrame() noexcept
+    {
+        if (!(m_Desc.targetFps > 0.0))
+        {
+            return;
+        }
+        const Timer::Clock::duration period =
+            std::chrono::duration_cast<Timer::Clock::duration>(Timer::Duration(1.0 / m_Desc.targetFps));
+        Timer::Time_Point now = Timer::Clock::now();
+        if (m_NextDeadline == Timer::Time_Point{})
+        {
+            m_NextDeadline = ((m_LastBegin != Timer::Time_Point{}) ? m_LastBegin : now) + period;
+        }
+        if (now >= m_NextDeadline + period)
+        {
+            // 1間隔以上遅れた: 今を基準に数え直す
+            m_NextDeadline = now + period;
+            return;
+        }
+
+        const Timer::Clock::duration spin =
+            std::chrono::duration_cast<Timer::Clock::duration>(Timer::Duration(m_Desc.spinSeconds));
+        if (m_NextDeadline - now > spin)
+        {
+            std::this_thread::sleep_until(m_NextDeadline - spin);
+        }
+        while (Timer::Clock::now() < m_NextDeadline)
+        {
+            CpuRelax();
+        }
+        m_NextDeadline += period;
+    }
+
+    FrameTimeStats FrameClock::Stats() const noexcept
+    {
+        FrameTimeStats stats;
+        stats.frames = m_StatFrames;
+        stats.lastSeconds = m_StatLast;
+        stats.minSeconds = m_StatMin;
+        stats.maxSeconds = m_StatMax;
+        stats.jitterMaxSeconds = m_StatJitterMax;
+        stats.droppedSteps = m_DroppedSteps;
+        if (m_StatFrames > 0)
+        {
+            stats.averageSeconds = m_StatSum / static_cast<double>(m_StatFrames);
+            stats.jitterAverageSeconds = m_StatJitterSum / static_cast<double>(m_StatFrames);
+        }
+        return stats;
+    }
+
+    void FrameClock::ResetStats() noexcept
+    {
+        m_StatFrames = 0;
+        m_StatLast = 0.0;
+        m_StatSum = 0.0;
+        m_StatMin = 0.0;
+        m_StatMax = 0.0;
+        m_StatJitterSum = 0.0;
+        m_StatJitterMax = 0.0;
+        m_DroppedSteps = 0;
+    }
+
+    void FrameClock::Record(double interval) noexcept
+    {
+        double jitter = 0.0;
+        if (m_Desc.targetFps > 0.0)
+        {
+            jitter = std::abs(interval - 1.0 / m_Desc.targetFps);
+        }
+        else if (m_StatFrames > 0)
+        {
+            jitter = std::abs(interval - m_StatLast);
+        }
+        m_StatMin = (m_StatFrames == 0) ? interval : std::min(m_StatMin, interval);
+        m_StatMax = std::max(m_StatMax, interval);
+        m_StatSum += interval;
+        m_StatJitterSum += jitter;
+        m_StatJitterMax = std::max(m_StatJitterMax, jitter);
+        m_StatLast = interval;
+        ++m_StatFrames;
+    }
+}
@@ -0,0 +1,29 @@
+#include "pch.h"
+#include "include/HeadlessWindow.h"
+
+namespace Drama::Platform
+{
+    bool HeadlessWindow::Create(uint32_t w, uint32_t h)
+    {
+        // 描画先の大きさだけは持っておく(オフスクリーン描画や解像度依存の計算が参照する)
+        m_Width = w;
+        m_Height = h;
+        m_QuitRequested.store(false, std::memory_order_release);
+        return true;
+    }
+
+    void HeadlessWindow::Show(bool)
+    {
+    }
+
+    void HeadlessWindow::Shutdown()
+    {
+        m_Width = 0;
+        m_Height = 0;
+    }
+
+    bool HeadlessWindow::PumpMessages()
+    {
+        return !m_QuitRequested.load(std::memory_order_acquire);
+    }
+}
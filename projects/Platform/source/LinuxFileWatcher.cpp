@@ -0,0 +1,293 @@
+#include "pch.h"
+#include "include/LinuxFileWatcher.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "Core/include/FileChangeCoalescer.h"
+
+namespace
+{
+    using Drama::Core::IO::FileChangeKind;
+    using Drama::Core::IO::FileWatchId;
+    using Drama::Core::IO::FsError;
+    using Drama::Core::IO::FsResult;
+
+    constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+    FsResult MakeErrnoError(const char* msg) noexcept
+    {
+        const int err = errno;
+        FsResult r;
+        r.error = (err == ENOENT || err == ENOTDIR) ? FsError::NotFound
+            : (err == EACCES || err == EPERM) ? FsError::AccessDenied : FsError::IoError;
+        r.ec = std::error_code(err, std::generic_category());
+        r.message = msg;
+        return r;
+    }
+
+    uint64_t NowNs() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::string TrimTrailingSlash(std::string_view path)
+    {
+        while (path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+        {
+            path.remove_suffix(1);
+        }
+        return std::string(path);
+    }
+}
+
+namespace Drama::Platform::IO
+{
+    struct LinuxFileWatcher::Impl
+    {
+        /// @brief inotify の登録1つ(同じディレクトリを複数の Watch が含むことがある)
+        struct DirWatch
+        {
+            std::string path;
+            std::vector<FileWatchId> owners;
+        };
+        struct Root
+        {
+            std::string path;
+            bool recursive = false;
+            std::vector<int> wds;
+        };
+
+        int fd = -1;
+        uint64_t debounceNs = 0;
+        FileWatchId nextId = 1;
+        std::unordered_map<int, DirWatch> dirs;
+        std::unordered_map<FileWatchId, Root> roots;
+        Drama::Core::IO::FileChangeCoalescer coalescer;
+        alignas(inotify_event) char buffer[64 * 1024];
+
+        bool AddDirectory(FileWatchId id, const std::string& path)
+        {
+            const int wd = ::inotify_add_watch(fd, path.c_str(), kWatchMask);
+            if (wd < 0)
+            {
+                return false;
+            }
+            DirWatch& d = dirs[wd];
+            d.path = path;
+            for (FileWatchId owner : d.owners)
+            {
+                if (owner == id)
+                {
+                    return true;
+                }
+            }
+            d.owners.push_back(id);
+            roots[id].wds.push_back(wd);
+            return true;
+        }
+
+        /// @brief 配下のディレクトリを全て登録する(inotify は再帰監視を持たないため)
+        void AddTree(FileWatchId id, const std::string& path)
+        {
+            std::error_code ec;
+            for (auto it = std::filesystem::recursive_directory_iterator(path,
+                     std::filesystem::directory_options::skip_permission_denied, ec);
+                 !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+            {
+                if (it->is_directory(ec))
+                {
+                    AddDirectory(id, it->path().generic_string());
+                }
+            }
+        }
+
+        bool IsRecursive(const DirWatch& d) const noexcept
+        {
+            for (FileWatchId owner : d.owners)
+            {
+                if (auto it = roots.find(owner); it != roots.end() && it->second.recursive)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Handle(const inotify_event& ev, uint64_t now)
+        {
+            if ((ev.mask & IN_Q_OVERFLOW) != 0)
+            {
+                // 取りこぼしがあったので、監視している全体を読み直してもらう
+                for (const auto& [id, root] : roots)
+                {
+                    coalescer.Push(root.path, FileChangeKind::Rescan, now);
+                }
+                return;
+            }
+            auto it = dirs.find(ev.wd);
+            if (it == dirs.end())
+            {
+                return;
+            }
+            if ((ev.mask & IN_IGNORED) != 0)
+            {
+                // ディレクトリが消えて登録も外れた
+                for (FileWatchId owner : it->second.owners)
+                {
+                    if (auto r = roots.find(owner); r != roots.end())
+                    {
+                        std::erase(r->second.wds, ev.wd);
+                    }
+                }
+                dirs.erase(it);
+                return;
+            }
+            if (ev.len == 0)
+            {
+                return;
+            }
+
+            const std::string path = it->second.path + "/" + ev.name;
+            if ((ev.mask & IN_ISDIR) != 0)
+            {
+                if ((ev.mask & (IN_CREATE | IN_MOVED_TO)) != 0 && IsRecursive(it->second))
+                {
+                    // 登録する前に中へ置かれたファイルの通知は来ないので、まとめて読み直してもらう
+                    const std::vector<FileWatchId> owners = it->second.owners;
+                    for (FileWatchId owner : owners)
+                    {
+                        if (roots[owner].recursive)
+                        {
+                            AddDirectory(owner, path);
+                            AddTree(owner, path);
+                        }
+                    }
+                    coalescer.Push(path, FileChangeKind::Rescan, now);
+                }
+                else if ((ev.mask & IN_MOVED_FROM) != 0)
+                {
+                    coalescer.Push(path, FileChangeKind::Rescan, now);
+                }
+                return;
+            }
+
+            if ((ev.mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+            {
+                coalescer.Push(path, FileChangeKind::Added, now);
+            }
+            else if ((ev.mask & IN_CLOSE_WRITE) != 0)
+            {
+                coalescer.Push(path, FileChangeKind::Modified, now);
+            }
+            else if ((ev.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+            {
+                coalescer.Push(path, FileChangeKind::Removed, now);
+            }
+        }
+    };
+
+    LinuxFileWatcher::LinuxFileWatcher(const Drama::Core::IO::FileWatchDesc& desc)
+        : m_Impl(std::make_unique<Impl>())
+    {
+        m_Impl->fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        m_Impl->debounceNs = static_cast<uint64_t>(desc.debounceMs) * 1000000ull;
+    }
+
+    LinuxFileWatcher::~LinuxFileWatcher()
+    {
+        if (m_Impl->fd >= 0)
+        {
+            ::close(m_Impl->fd); // 登録はfdと一緒に外れる
+        }
+    }
+
+    FsResult LinuxFileWatcher::Watch(std::string_view directory, bool recursive, FileWatchId& out) noexcept
+    {
+        out = Drama::Core::IO::kInvalidFileWatchId;
+        if (directory.empty())
+        {
+            FsResult r;
+            r.error = FsError::InvalidPath;
+            r.message = "Path is empty.";
+            return r;
+        }
+        if (m_Impl->fd < 0)
+        {
+            return MakeErrnoError("inotify_init1 failed.");
+        }
+
+        const FileWatchId id = m_Impl->nextId++;
+        Impl::Root& root = m_Impl->roots[id];
+        root.path = TrimTrailingSlash(directory);
+        root.recursive = recursive;
+        if (!m_Impl->AddDirectory(id, root.path))
+        {
+            FsResult r = MakeErrnoError("inotify_add_watch failed.");
+            m_Impl->roots.erase(id);
+            return r;
+        }
+        if (recursive)
+        {
+            m_Impl->AddTree(id, root.path);
+        }
+        out = id;
+        return FsResult::Ok();
+    }
+
+    void LinuxFileWatcher::Unwatch(FileWatchId id) noexcept
+    {
+        auto it = m_Impl->roots.find(id);
+        if (it == m_Impl->roots.end())
+        {
+            return;
+        }
+        for (int wd : it->second.wds)
+        {
+            auto d = m_Impl->dirs.find(wd);
+            if (d == m_Impl->dirs.end())
+            {
+                continue;
+            }
+            std::erase(d->second.owners, id);
+            if (d->second.owners.empty())
+            {
+                ::inotify_rm_watch(m_Impl->fd, wd);
+                m_Impl->dirs.erase(d);
+            }
+        }
+        m_Impl->roots.erase(it);
+    }
+
+    size_t LinuxFileWatcher::Poll(std::vector<Drama::Core::IO::FileChange>& out) noexcept
+    {
+        if (m_Impl->fd < 0)
+        {
+            return 0;
+        }
+        const uint64_t now = NowNs();
+        while (true)
+        {
+            const ssize_t n = ::read(m_Impl->fd, m_Impl->buffer, sizeof(m_Impl->buffer));
+            if (n <= 0)
+            {
+                break; // EAGAIN: 今届いている通知は読み切った
+            }
+            for (ssize_t offset = 0; offset < n;)
+            {
+                const auto* ev = reinterpret_cast<const inotify_event*>(m_Impl->buffer + offset);
+                m_Impl->Handle(*ev, now);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+            }
+        }
+        return m_Impl->coalescer.Drain(now, m_Impl->debounceNs, out);
+    }
+}
+#endif
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "include/Platform.h"
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN             // Windows ヘッダーからほとんど使用されていない部分を除外する
 #define NOMINMAX                        // min と max マクロを無効にする
 
@@ -231,3 +232,4 @@ namespace Drama::Platform
         
     }
 }
+#endif
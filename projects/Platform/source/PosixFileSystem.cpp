@@ -0,0 +1,866 @@
+#include "pch.h"
+#include "include/PosixFileSystem.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <climits>
+#include <memory>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Drama::Core::IO::FsError;
+    using Drama::Core::IO::FsResult;
+
+    static FsError MapErrnoToFs(int e) noexcept
+    {
+        switch (e)
+        {
+        case ENOENT:
+        case ENOTDIR:      return FsError::NotFound;
+        case EACCES:
+        case EPERM:
+        case EISDIR:
+        case EROFS:        return FsError::AccessDenied;
+        case EEXIST:       return FsError::AlreadyExists;
+        case ENAMETOOLONG:
+        case ELOOP:
+        case EINVAL:       return FsError::InvalidPath;
+        default:           return FsError::IoError;
+        }
+    }
+
+    static FsResult MakeError(FsError e, int err = errno, const char* msg = nullptr) noexcept
+    {
+        FsResult r;
+        r.error = e;
+        r.ec = std::error_code(err, std::generic_category());
+        if (msg)
+        {
+            r.message = msg;
+        }
+        return r;
+    }
+
+    /// @brief errno をそのまま分類して返す
+    static FsResult MakeErrnoError(const char* msg) noexcept
+    {
+        const int e = errno;
+        return MakeError(MapErrnoToFs(e), e, msg);
+    }
+
+    struct UniqueFd
+    {
+        int fd = -1;
+        UniqueFd() = default;
+        explicit UniqueFd(int f) : fd(f) {}
+        ~UniqueFd() { if (fd >= 0) { ::close(fd); } }
+        UniqueFd(const UniqueFd&) = delete;
+        UniqueFd& operator=(const UniqueFd&) = delete;
+        UniqueFd(UniqueFd&& o) noexcept : fd(o.fd) { o.fd = -1; }
+        UniqueFd& operator=(UniqueFd&& o) noexcept
+        {
+            if (this != &o)
+            {
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+                fd = o.fd;
+                o.fd = -1;
+            }
+            return *this;
+        }
+        explicit operator bool() const noexcept { return fd >= 0; }
+        /// @brief 明示的に閉じる(closeの失敗は書き込み失敗として扱う)
+        bool Close() noexcept
+        {
+            const int f = fd;
+            fd = -1;
+            return (f < 0) || (::close(f) == 0);
+        }
+    };
+
+    static int OpenRetry(const std::string& path, int flags, mode_t mode = 0644) noexcept
+    {
+        int fd = -1;
+        do
+        {
+            fd = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+        } while (fd < 0 && errno == EINTR);
+        return fd;
+    }
+
+    static bool WriteAll(int fd, const void* data, size_t size) noexcept
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        size_t remaining = size;
+
+        while (remaining > 0)
+        {
+            const ssize_t written = ::write(fd, p, remaining);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            p += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    static void UnmapView(const uint8_t* data, size_t size) noexcept
+    {
+        ::munmap(const_cast<uint8_t*>(data), size);
+    }
+
+    /// @brief 位置指定で読めるだけ読む(EOFで止まる)
+    static bool PReadAll(int fd, uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept
+    {
+        uint8_t* p = static_cast<uint8_t*>(buffer);
+        bytesRead = 0;
+        while (bytesRead < size)
+        {
+            const ssize_t n = ::pread(fd, p + bytesRead, size - bytesRead, static_cast<off_t>(offset + bytesRead));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            bytesRead += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static bool PWriteAll(int fd, uint64_t offset, const void* data, size_t size) noexcept
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        size_t done = 0;
+        while (done < size)
+        {
+            const ssize_t n = ::pwrite(fd, p + done, size - done, static_cast<off_t>(offset + done));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static FsResult SizeOf(int fd, uint64_t& out) noexcept
+    {
+        struct stat st {};
+        if (::fstat(fd, &st) != 0)
+        {
+            return MakeErrnoError("fstat failed.");
+        }
+        out = static_cast<uint64_t>(st.st_size);
+        return FsResult::Ok();
+    }
+
+    /// @brief 位置は自前で持ち、読み込みは全て pread で行う
+    class PosixFileReader final : public Drama::Core::IO::IFileReader
+    {
+    public:
+        explicit PosixFileReader(UniqueFd&& fd) noexcept : m_Fd(std::move(fd)) {}
+
+        FsResult Read(void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            FsResult r = ReadAt(m_Position, buffer, size, bytesRead);
+            m_Position += bytesRead;
+            return r;
+        }
+
+        FsResult ReadAt(uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            if (size > 0 && buffer == nullptr)
+            {
+                bytesRead = 0;
+                return MakeError(FsError::IoError, 0, "Buffer is null.");
+            }
+            if (!PReadAll(m_Fd.fd, offset, buffer, size, bytesRead))
+            {
+                return MakeError(FsError::IoError, errno, "pread failed.");
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            m_Position = offset;
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override { return SizeOf(m_Fd.fd, out); }
+
+    private:
+        UniqueFd m_Fd;
+        uint64_t m_Position = 0;
+    };
+
+    /// @brief 位置は自前で持ち、書き込みは全て pwrite / pwritev で行う
+    /// @note 追記モードでも O_APPEND は使わない(Linux では O_APPEND だと pwrite の位置指定が無視され WriteAt が壊れる)
+    class PosixFileWriter final : public Drama::Core::IO::IFileWriter
+    {
+    public:
+        PosixFileWriter(UniqueFd&& fd, uint64_t position) noexcept : m_Fd(std::move(fd)), m_Position(position) {}
+
+        FsResult Write(const void* data, size_t size) noexcept override
+        {
+            if (FsResult r = WriteAt(m_Position, data, size); !r)
+            {
+                return r;
+            }
+            m_Position += size;
+            return FsResult::Ok();
+        }
+
+        FsResult WriteV(std::span<const Drama::Core::IO::WriteSlice> slices) noexcept override
+        {
+            // 1回の pwritev に渡せる数には上限があるので、区切って渡す
+            constexpr size_t kMaxIov = 64;
+            iovec iov[kMaxIov];
+
+            size_t index = 0;
+            size_t consumed = 0; // slices[index] のうち書き終えたバイト数
+            while (index < slices.size())
+            {
+                size_t count = 0;
+                for (size_t i = index; i < slices.size() && count < kMaxIov; ++i)
+                {
+                    const size_t skip = (i == index) ? consumed : 0;
+                    if (slices[i].size - skip == 0)
+                    {
+                        continue;
+                    }
+                    if (slices[i].data == nullptr)
+                    {
+                        return MakeError(FsError::IoError, 0, "Slice data is null.");
+                    }
+                    iov[count].iov_base = const_cast<uint8_t*>(static_cast<const uint8_t*>(slices[i].data) + skip);
+                    iov[count].iov_len = slices[i].size - skip;
+                    ++count;
+                }
+                if (count == 0)
+                {
+                    break;
+                }
+
+#if defined(__linux__)
+                const ssize_t n = ::pwritev(m_Fd.fd, iov, static_cast<int>(count), static_cast<off_t>(m_Position));
+#else
+                ssize_t n = -1;
+                if (PWriteAll(m_Fd.fd, m_Position, iov[0].iov_base, iov[0].iov_len))
+                {
+                    n = static_cast<ssize_t>(iov[0].iov_len);
+                }
+#endif
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return MakeErrnoError("pwritev failed.");
+                }
+                m_Position += static_cast<uint64_t>(n);
+
+                // 途中までしか書けなかった場合に備え、書けた分だけ進める
+                size_t advance = static_cast<size_t>(n);
+                while (index < slices.size() && advance > 0)
+                {
+                    const size_t left = slices[index].size - consumed;
+                    if (advance >= left)
+                    {
+                        advance -= left;
+                        ++index;
+                        consumed = 0;
+                    }
+                    else
+                    {
+                        consumed += advance;
+                        advance = 0;
+                    }
+                }
+                // 空の要素を読み飛ばす
+                while (index < slices.size() && slices[index].size == consumed)
+                {
+                    ++index;
+                    consumed = 0;
+                }
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult WriteAt(uint64_t offset, const void* data, size_t size) noexcept override
+        {
+            if (size > 0 && data == nullptr)
+            {
+                return MakeError(FsError::IoError, 0, "Data is null.");
+            }
+            if (!PWriteAll(m_Fd.fd, offset, data, size))
+            {
+                return MakeErrnoError("pwrite failed.");
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            m_Position = offset;
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override { return SizeOf(m_Fd.fd, out); }
+
+        FsResult Flush() noexcept override
+        {
+            if (::fsync(m_Fd.fd) != 0)
+            {
+                return MakeErrnoError("fsync failed.");
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Close() noexcept override
+        {
+            if (!m_Fd.Close())
+            {
+                return MakeErrnoError("close failed.");
+            }
+            return FsResult::Ok();
+        }
+
+    private:
+        UniqueFd m_Fd;
+        uint64_t m_Position = 0;
+    };
+
+    static std::string ParentDir(const std::string& path)
+    {
+        const size_t p = path.find_last_of('/');
+        if (p == std::string::npos)
+        {
+            return ".";
+        }
+        if (p == 0)
+        {
+            return "/";
+        }
+        return path.substr(0, p);
+    }
+}
+
+namespace Drama::Platform::IO
+{
+    FsResult PosixFileSystem::Exists(std::string_view path) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        struct stat st {};
+        if (::stat(std::string(path).c_str(), &st) == 0)
+        {
+            return FsResult::Ok();
+        }
+        const int e = errno;
+        if (MapErrnoToFs(e) == FsError::NotFound)
+        {
+            return MakeError(FsError::NotFound, e, "Path not found.");
+        }
+        return MakeError(MapErrnoToFs(e), e, "Failed to check existence due to IO error.");
+    }
+
+    FsResult PosixFileSystem::FileSize(std::string_view path, uint64_t& out) noexcept
+    {
+        out = 0;
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        struct stat st {};
+        if (::stat(std::string(path).c_str(), &st) != 0)
+        {
+            const int e = errno;
+            return MakeError(MapErrnoToFs(e), e, "stat failed.");
+        }
+        out = static_cast<uint64_t>(st.st_size);
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::LastWriteTime(std::string_view path, uint64_t& outNs) noexcept
+    {
+        outNs = 0;
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        struct stat st {};
+        if (::stat(std::string(path).c_str(), &st) != 0)
+        {
+            const int e = errno;
+            return MakeError(MapErrnoToFs(e), e, "stat failed.");
+        }
+        outNs = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::Remove(std::string_view path) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        if (::unlink(std::string(path).c_str()) == 0)
+        {
+            return FsResult::Ok();
+        }
+        const int e = errno;
+        return MakeError(MapErrnoToFs(e), e, "Failed to remove file.");
+    }
+
+    FsResult PosixFileSystem::CreateDirectories(std::string_view path) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(std::string(path)), ec);
+        if (ec)
+        {
+            return MakeError(MapErrnoToFs(ec.value()), ec.value(), "Failed to create directories due to IO error.");
+        }
+        // 既に存在していた場合も成功
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::WriteAllBytes(std::string_view path, const void* data, size_t size) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        if (size > 0 && data == nullptr)
+        {
+            return MakeError(FsError::IoError, 0, "Data is null.");
+        }
+
+        UniqueFd f(OpenRetry(std::string(path), O_WRONLY | O_CREAT | O_TRUNC));
+        if (!f)
+        {
+            return MakeErrnoError("open(write) failed.");
+        }
+        if (!WriteAll(f.fd, data, size))
+        {
+            return MakeErrnoError("write failed.");
+        }
+        if (!f.Close())
+        {
+            return MakeErrnoError("close failed.");
+        }
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::ReadAllBytes(std::string_view path, std::vector<uint8_t>& out) noexcept
+    {
+        out.clear();
+
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        UniqueFd f(OpenRetry(std::string(path), O_RDONLY));
+        if (!f)
+        {
+            return MakeErrnoError("open(read) failed.");
+        }
+
+        struct stat st {};
+        if (::fstat(f.fd, &st) != 0)
+        {
+            return MakeErrnoError("fstat failed.");
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            return MakeError(FsError::InvalidPath, EISDIR, "Path is a directory.");
+        }
+
+        const uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+        if (fileSize > static_cast<uint64_t>(out.max_size()))
+        {
+            return MakeError(FsError::IoError, EFBIG, "File too large for vector.");
+        }
+
+        // 先読みを深くしてもらう(WinFileSystem の FILE_FLAG_SEQUENTIAL_SCAN 相当)
+        ::posix_fadvise(f.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        // st_size が 0 でも中身がある特殊ファイル(procfs等)に備え、EOFまで伸ばしながら読む
+        out.resize(fileSize > 0 ? static_cast<size_t>(fileSize) : 4096);
+        size_t filled = 0;
+        while (true)
+        {
+            if (filled == out.size())
+            {
+                if (filled >= static_cast<size_t>(fileSize) && fileSize > 0)
+                {
+                    // 予定サイズを読み切った。伸びていないか1バイトだけ確かめる
+                    uint8_t probe = 0;
+                    const ssize_t n = ::read(f.fd, &probe, 1);
+                    if (n == 0)
+                    {
+                        break;
+                    }
+                    if (n < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        const int e = errno;
+                        out.clear();
+                        return MakeError(FsError::IoError, e, "read failed.");
+                    }
+                    out.push_back(probe);
+                    ++filled;
+                }
+                out.resize(out.size() * 2);
+            }
+
+            const ssize_t n = ::read(f.fd, out.data() + filled, out.size() - filled);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                const int e = errno;
+                out.clear();
+                return MakeError(FsError::IoError, e, "read failed.");
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            filled += static_cast<size_t>(n);
+        }
+        out.resize(filled);
+
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::MapReadOnly(std::string_view path, Drama::Core::IO::MappedFile& out) noexcept
+    {
+        out.Reset();
+
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        UniqueFd f(OpenRetry(std::string(path), O_RDONLY));
+        if (!f)
+        {
+            return MakeErrnoError("open(map) failed.");
+        }
+
+        struct stat st {};
+        if (::fstat(f.fd, &st) != 0)
+        {
+            return MakeErrnoError("fstat(map) failed.");
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            return MakeError(FsError::InvalidPath, EISDIR, "Path is a directory.");
+        }
+
+        // 空ファイルはマップできず、通常ファイル以外(パイプやprocfs)はサイズが当てにならない
+        if (!S_ISREG(st.st_mode) || st.st_size <= 0 ||
+            static_cast<uint64_t>(st.st_size) > static_cast<uint64_t>(SIZE_MAX))
+        {
+            return IFileSystem::MapReadOnly(path, out);
+        }
+
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, f.fd, 0);
+        if (p == MAP_FAILED)
+        {
+            return IFileSystem::MapReadOnly(path, out);
+        }
+        // 頭から舐める用途が大半なので先読みを深くしてもらう
+        ::madvise(p, size, MADV_SEQUENTIAL);
+
+        // マッピングはfdを閉じても残る
+        out = Drama::Core::IO::MappedFile::FromMapping(static_cast<const uint8_t*>(p), size, &UnmapView);
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::AppendAllBytes(std::string_view path, const void* data, size_t size) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        if (size > 0 && data == nullptr)
+        {
+            return MakeError(FsError::IoError, 0, "Data is null.");
+        }
+
+        // O_APPEND なら複数プロセスからの追記でも1回のwriteは末尾に原子的に付く
+        UniqueFd f(OpenRetry(std::string(path), O_WRONLY | O_CREAT | O_APPEND));
+        if (!f)
+        {
+            return MakeErrnoError("open(append) failed.");
+        }
+        if (!WriteAll(f.fd, data, size))
+        {
+            return MakeErrnoError("write(append) failed.");
+        }
+        if (!f.Close())
+        {
+            return MakeErrnoError("close(append) failed.");
+        }
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::WriteAllBytesAtomic(std::string_view path, const void* data, size_t size) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        if (size > 0 && data == nullptr)
+        {
+            return MakeError(FsError::IoError, 0, "Data is null.");
+        }
+
+        const std::string dst(path);
+        const std::string tmpPath = dst + ".tmp";
+
+        // tmp に書いて中身をディスクまで届ける
+        {
+            UniqueFd f(OpenRetry(tmpPath, O_WRONLY | O_CREAT | O_TRUNC));
+            if (!f)
+            {
+                return MakeErrnoError("open(tmp) failed.");
+            }
+            if (!WriteAll(f.fd, data, size))
+            {
+                const FsResult r = MakeErrnoError("write(tmp) failed.");
+                ::unlink(tmpPath.c_str());
+                return r;
+            }
+            if (::fsync(f.fd) != 0)
+            {
+                const FsResult r = MakeErrnoError("fsync(tmp) failed.");
+                ::unlink(tmpPath.c_str());
+                return r;
+            }
+            if (!f.Close())
+            {
+                const FsResult r = MakeErrnoError("close(tmp) failed.");
+                ::unlink(tmpPath.c_str());
+                return r;
+            }
+        }
+
+        // tmp を本番に置換（原子的）
+        if (::rename(tmpPath.c_str(), dst.c_str()) != 0)
+        {
+            const FsResult r = MakeErrnoError("rename(replace) failed.");
+            ::unlink(tmpPath.c_str()); // 失敗時は掃除
+            return r;
+        }
+
+        // rename 自体を永続化するにはディレクトリのfsyncが要る
+        UniqueFd dir(OpenRetry(ParentDir(dst), O_RDONLY | O_DIRECTORY));
+        if (!dir)
+        {
+            return MakeErrnoError("open(parent dir) failed.");
+        }
+        if (::fsync(dir.fd) != 0)
+        {
+            return MakeErrnoError("fsync(parent dir) failed.");
+        }
+
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::OpenRead(std::string_view path, std::unique_ptr<Drama::Core::IO::IFileReader>& out) noexcept
+    {
+        out.reset();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        UniqueFd f(OpenRetry(std::string(path), O_RDONLY));
+        if (!f)
+        {
+            return MakeErrnoError("open(stream read) failed.");
+        }
+        struct stat st {};
+        if (::fstat(f.fd, &st) == 0 && S_ISDIR(st.st_mode))
+        {
+            return MakeError(FsError::InvalidPath, EISDIR, "Path is a directory.");
+        }
+        ::posix_fadvise(f.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        out = std::make_unique<PosixFileReader>(std::move(f));
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::OpenWrite(std::string_view path, Drama::Core::IO::FileWriteMode mode, std::unique_ptr<Drama::Core::IO::IFileWriter>& out) noexcept
+    {
+        out.reset();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        const bool isAppend = (mode == Drama::Core::IO::FileWriteMode::Append);
+        UniqueFd f(OpenRetry(std::string(path), O_WRONLY | O_CREAT | (isAppend ? 0 : O_TRUNC)));
+        if (!f)
+        {
+            return MakeErrnoError("open(stream write) failed.");
+        }
+
+        uint64_t position = 0;
+        if (isAppend)
+        {
+            if (FsResult r = SizeOf(f.fd, position); !r)
+            {
+                return r;
+            }
+        }
+
+        out = std::make_unique<PosixFileWriter>(std::move(f), position);
+        return FsResult::Ok();
+    }
+
+    FsResult PosixFileSystem::CopyAllBytes(std::string_view src, std::string_view dst) noexcept
+    {
+        if (src.empty() || dst.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        UniqueFd in(OpenRetry(std::string(src), O_RDONLY));
+        if (!in)
+        {
+            return MakeErrnoError("open(copy src) failed.");
+        }
+        struct stat st {};
+        if (::fstat(in.fd, &st) != 0)
+        {
+            return MakeErrnoError("fstat(copy src) failed.");
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            return MakeError(FsError::InvalidPath, EISDIR, "Source is a directory.");
+        }
+
+        UniqueFd out(OpenRetry(std::string(dst), O_WRONLY | O_CREAT | O_TRUNC));
+        if (!out)
+        {
+            return MakeErrnoError("open(copy dst) failed.");
+        }
+
+        bool isKernelCopy = false;
+#if defined(__linux__)
+        // 同一FSならページキャッシュ間(reflink対応FSならブロック共有)で済む
+        isKernelCopy = true;
+        while (true)
+        {
+            const ssize_t n = ::copy_file_range(in.fd, nullptr, out.fd, nullptr, 1u << 30, 0);
+            if (n > 0)
+            {
+                continue;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)
+            {
+                // 古いカーネルやFS跨ぎは通常のコピーへ(オフセットは進んだ分から続ける)
+                isKernelCopy = false;
+                break;
+            }
+            return MakeErrnoError("copy_file_range failed.");
+        }
+#endif
+
+        if (!isKernelCopy)
+        {
+            ::posix_fadvise(in.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+            std::vector<uint8_t> buffer(1u << 20);
+            while (true)
+            {
+                const ssize_t n = ::read(in.fd, buffer.data(), buffer.size());
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return MakeError(FsError::IoError, errno, "read(copy) failed.");
+                }
+                if (n == 0)
+                {
+                    break;
+                }
+                if (!WriteAll(out.fd, buffer.data(), static_cast<size_t>(n)))
+                {
+                    return MakeErrnoError("write(copy) failed.");
+                }
+            }
+        }
+
+        if (!out.Close())
+        {
+            return MakeErrnoError("close(copy dst) failed.");
+        }
+        return FsResult::Ok();
+    }
+
+    std::string PosixFileSystem::currentPath() noexcept
+    {
+        std::error_code ec;
+        return std::filesystem::current_path(ec).string();
+    }
+}
+#endif
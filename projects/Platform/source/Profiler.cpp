@@ -0,0 +1,403 @@
+#include "pch.h"
+#include "include/Profiler.h"
+#include "Core/include/ThreadLocalAccess.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    using Drama::Platform::TscClock;
+    using Drama::Platform::Profile::Event;
+    using Drama::Platform::Profile::EventKind;
+
+    constexpr uint32_t kChunkEvents = 4096; ///< 1回の確保で増やす記録数
+
+    /// @brief 記録の塊。スレッドのバッファはこれを繋いで伸ばし、計測をやり直しても解放せずに使い回す
+    struct Chunk
+    {
+        Event events[kChunkEvents];
+        std::atomic<Chunk*> next{ nullptr };
+    };
+
+    /// @brief 1スレッド分の記録
+    /// @note 書くのは持ち主のスレッドだけ。読む側は published まで(release/acquire で書き終えた分)しか見ない
+    struct ThreadBuffer
+    {
+        ThreadBuffer() = default;
+        ThreadBuffer(const ThreadBuffer&) = delete;
+        ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+
+        uint32_t tid = 0;
+        std::string name;                      ///< 表示名(登録簿のロックで守る)
+        std::vector<std::unique_ptr<Chunk>> chunks; ///< 塊の持ち主(持ち主のスレッドだけが足す。読む側は next で辿る)
+        Chunk* head = nullptr;
+        Chunk* tail = nullptr;                 ///< 書き込み中の塊(持ち主だけが触る)
+        uint32_t tailCount = 0;
+        // 以下3つは持ち主だけが触る写し。記録のたびに atomic や登録簿の上限を読み直さずに済ませる
+        uint64_t ownerEpoch = 0; ///< captureEpoch と同じ値
+        uint64_t count = 0;      ///< published と同じ値
+        uint64_t limit = 0;      ///< この計測の maxEvents
+        std::atomic<uint64_t> captureEpoch{ 0 }; ///< 記録がどの計測のものか
+        std::atomic<uint64_t> published{ 0 };    ///< 書き終えた数
+        std::atomic<uint64_t> dropped{ 0 };      ///< 上限を超えて捨てた数
+    };
+
+    /// @brief 全スレッドのバッファの登録簿
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> threads; ///< スレッドが終わっても記録を書き出せるよう残す
+        std::atomic<uint64_t> epoch{ 0 };      ///< Start のたびに進める。古い記録は各スレッドが次に書くときに捨てる
+        std::atomic<uint64_t> maxEvents{ 0 };
+        std::atomic<uint64_t> frameNumber{ 0 };
+        uint64_t startTicks = 0;               ///< 書き出す時刻の起点
+    };
+    Registry g_Registry;
+
+    thread_local ThreadBuffer* t_Buffer = nullptr;
+
+    ThreadBuffer* Register() noexcept
+    {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->chunks.push_back(std::make_unique<Chunk>());
+        buffer->head = buffer->chunks.back().get();
+        buffer->tail = buffer->head;
+
+        std::scoped_lock lock(g_Registry.mutex);
+        buffer->tid = static_cast<uint32_t>(g_Registry.threads.size()) + 1; // 0 はフレームの列に使う
+        buffer->name = "Thread " + std::to_string(buffer->tid);
+        ThreadBuffer* raw = buffer.get();
+        g_Registry.threads.push_back(std::move(buffer));
+        return raw;
+    }
+
+    // 区間の途中の Wait でファイバーごと移ることがあるので毎回引き直す(理由は ThreadLocalAccess.h)
+    DRAMA_NOINLINE ThreadBuffer* Current() noexcept
+    {
+        DRAMA_OPAQUE_BARRIER();
+        ThreadBuffer*& buffer = t_Buffer;
+        if (!buffer)
+        {
+            buffer = Register();
+        }
+        return buffer;
+    }
+
+    void Push(const Event& e) noexcept
+    {
+        ThreadBuffer* b = Current();
+        if (!b)
+        {
+            return;
+        }
+        // 新しい計測が始まっていれば、自分の古い記録を捨てて先頭から書き直す(持ち主だけが書くのでロック不要)。
+        // 登録簿から読むのは epoch だけで、上限はここで写しておく(Start は上限を書いてから epoch を進める)
+        const uint64_t epoch = g_Registry.epoch.load(std::memory_order_acquire);
+        if (b->ownerEpoch != epoch)
+        {
+            b->tail = b->head;
+            b->tailCount = 0;
+            b->count = 0;
+            b->limit = g_Registry.maxEvents.load(std::memory_order_relaxed);
+            b->ownerEpoch = epoch;
+            b->published.store(0, std::memory_order_relaxed);
+            b->dropped.store(0, std::memory_order_relaxed);
+            b->captureEpoch.store(epoch, std::memory_order_release);
+        }
+
+        if (b->count >= b->limit)
+        {
+            b->dropped.store(b->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        if (b->tailCount == kChunkEvents)
+        {
+            Chunk* next = b->tail->next.load(std::memory_order_relaxed);
+            if (!next)
+            {
+                b->chunks.push_back(std::make_unique<Chunk>());
+                next = b->chunks.back().get();
+                b->tail->next.store(next, std::memory_order_release);
+            }
+            b->tail = next;
+            b->tailCount = 0;
+        }
+        b->tail->events[b->tailCount++] = e;
+        b->published.store(++b->count, std::memory_order_release);
+    }
+
+    /// @brief 今回の計測の記録を書き終えた分だけ取り出す
+    void Collect(const ThreadBuffer& b, uint64_t epoch, std::vector<Event>& out)
+    {
+        if (b.captureEpoch.load(std::memory_order_acquire) != epoch)
+        {
+            return;
+        }
+        uint64_t remaining = b.published.load(std::memory_order_acquire);
+        const Chunk* chunk = b.head;
+        while (chunk && remaining > 0)
+        {
+            const uint64_t n = std::min<uint64_t>(remaining, kChunkEvents);
+            out.insert(out.end(), chunk->events, chunk->events + n);
+            remaining -= n;
+            chunk = chunk->next.load(std::memory_order_acquire);
+        }
+    }
+
+    void AppendEscaped(std::string& out, std::string_view text)
+    {
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(c);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+                out += buf;
+            }
+            else
+            {
+                out.push_back(c);
+            }
+        }
+    }
+
+    /// @brief カウントを起点からのマイクロ秒(Chrome Trace の ts/dur の単位)にする
+    double ToMicroseconds(uint64_t ticks, int64_t baseNs) noexcept
+    {
+        return static_cast<double>(TscClock::TicksToNanoseconds(ticks) - baseNs) * 1e-3;
+    }
+
+    /// @brief 1件分の JSON を書く(先頭以外は区切りのカンマを付ける)
+    class TraceWriter final
+    {
+    public:
+        explicit TraceWriter(std::string& out) : m_Out(out) {}
+
+        void Metadata(uint32_t tid, std::string_view threadName)
+        {
+            Begin();
+            m_Out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+            m_Out += std::to_string(tid);
+            m_Out += ",\"args\":{\"name\":\"";
+            AppendEscaped(m_Out, threadName);
+            m_Out += "\"}}";
+        }
+        void Complete(uint32_t tid, std::string_view name, double ts, double dur)
+        {
+            Begin();
+            m_Out += "{\"name\":\"";
+            AppendEscaped(m_Out, name);
+            Printf("\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", tid, ts, dur);
+        }
+        void Instant(uint32_t tid, std::string_view name, double ts)
+        {
+            Begin();
+            m_Out += "{\"name\":\"";
+            AppendEscaped(m_Out, name);
+            Printf("\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", tid, ts);
+        }
+        void Counter(uint32_t tid, std::string_view name, double ts, double value)
+        {
+            Begin();
+            m_Out += "{\"name\":\"";
+            AppendEscaped(m_Out, name);
+            Printf("\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.17g}}", tid, ts, value);
+        }
+
+    private:
+        void Begin()
+        {
+            if (!m_First)
+            {
+                m_Out += ",\n";
+            }
+            m_First = false;
+        }
+        template <class... Args>
+        void Printf(const char* format, Args... args)
+        {
+            char buf[192];
+            const int n = std::snprintf(buf, sizeof(buf), format, args...);
+            if (n > 0)
+            {
+                m_Out.append(buf, std::min<size_t>(static_cast<size_t>(n), sizeof(buf) - 1));
+            }
+        }
+
+        std::string& m_Out;
+        bool m_First = true;
+    };
+}
+
+namespace Drama::Platform::Profile
+{
+    void Profiler::Start(const CaptureDesc& desc) noexcept
+    {
+        std::scoped_lock lock(g_Registry.mutex);
+        g_Registry.maxEvents.store(std::max<uint64_t>(1, desc.maxEventsPerThread), std::memory_order_relaxed);
+        g_Registry.frameNumber.store(0, std::memory_order_relaxed);
+        g_Registry.startTicks = TscClock::Ticks();
+        g_Registry.epoch.fetch_add(1, std::memory_order_release);
+        s_Capturing.store(true, std::memory_order_release);
+    }
+
+    void Profiler::Stop() noexcept
+    {
+        s_Capturing.store(false, std::memory_order_release);
+    }
+
+    void Profiler::RecordZone(const char* name, uint64_t beginTicks, uint64_t endTicks) noexcept
+    {
+        Event e;
+        e.name = name;
+        e.begin = beginTicks;
+        e.end = endTicks;
+        e.kind = EventKind::Zone;
+        Push(e);
+    }
+
+    void Profiler::FrameMark() noexcept
+    {
+        if (!IsCapturing())
+        {
+            return;
+        }
+        Event e;
+        e.name = "Frame";
+        e.begin = TscClock::Ticks();
+        e.value = static_cast<double>(g_Registry.frameNumber.fetch_add(1, std::memory_order_relaxed));
+        e.kind = EventKind::Frame;
+        Push(e);
+    }
+
+    void Profiler::Counter(const char* name, double value) noexcept
+    {
+        if (!IsCapturing())
+        {
+            return;
+        }
+        Event e;
+        e.name = name;
+        e.begin = TscClock::Ticks();
+        e.value = value;
+        e.kind = EventKind::Counter;
+        Push(e);
+    }
+
+    void Profiler::SetThreadName(std::string_view name)
+    {
+        ThreadBuffer* b = Current();
+        if (!b)
+        {
+            return;
+        }
+        std::scoped_lock lock(g_Registry.mutex);
+        b->name.assign(name.data(), name.size());
+    }
+
+    CaptureStats Profiler::Stats() noexcept
+    {
+        CaptureStats stats;
+        std::scoped_lock lock(g_Registry.mutex);
+        const uint64_t epoch = g_Registry.epoch.load(std::memory_order_acquire);
+        for (const auto& b : g_Registry.threads)
+        {
+            if (b->captureEpoch.load(std::memory_order_acquire) != epoch)
+            {
+                continue;
+            }
+            ++stats.threads;
+            stats.events += b->published.load(std::memory_order_acquire);
+            stats.droppedEvents += b->dropped.load(std::memory_order_relaxed);
+        }
+        stats.frames = g_Registry.frameNumber.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void Profiler::ExportChromeTrace(std::string& out)
+    {
+        out.clear();
+        out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        TraceWriter writer(out);
+
+        std::scoped_lock lock(g_Registry.mutex);
+        const uint64_t epoch = g_Registry.epoch.load(std::memory_order_acquire);
+        const int64_t baseNs = TscClock::TicksToNanoseconds(g_Registry.startTicks);
+
+        std::vector<Event> events;
+        std::vector<uint64_t> frameTicks;
+        for (const auto& b : g_Registry.threads)
+        {
+            events.clear();
+            Collect(*b, epoch, events);
+            if (events.empty())
+            {
+                continue;
+            }
+            writer.Metadata(b->tid, b->name);
+
+            // 区間は閉じた順に積まれている(子が親より先)。ビューアが入れ子を組みやすいよう開始順・外側が先に並べる
+            std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& c)
+                {
+                    return a.begin != c.begin ? a.begin < c.begin : a.end > c.end;
+                });
+            for (const Event& e : events)
+            {
+                const double ts = ToMicroseconds(e.begin, baseNs);
+                switch (e.kind)
+                {
+                case EventKind::Zone:
+                    writer.Complete(b->tid, e.name, ts, TscClock::TickDeltaToNanoseconds(e.end - e.begin) * 1e-3);
+                    break;
+                case EventKind::Frame:
+                    writer.Instant(b->tid, "Frame " + std::to_string(static_cast<uint64_t>(e.value)), ts);
+                    frameTicks.push_back(e.begin);
+                    break;
+                case EventKind::Counter:
+                    writer.Counter(b->tid, e.name, ts, e.value);
+                    break;
+                }
+            }
+        }
+
+        // フレームの区切りの間を1本の列(tid 0)に並べ、フレームの長さが一目で分かるようにする
+        std::sort(frameTicks.begin(), frameTicks.end());
+        if (frameTicks.size() > 1)
+        {
+            writer.Metadata(0, "Frames");
+            for (size_t i = 0; i + 1 < frameTicks.size(); ++i)
+            {
+                writer.Complete(0, "Frame " + std::to_string(i), ToMicroseconds(frameTicks[i], baseNs),
+                    TscClock::TickDeltaToNanoseconds(frameTicks[i + 1] - frameTicks[i]) * 1e-3);
+            }
+        }
+        out += "\n]}\n";
+    }
+
+    Core::IO::FsResult Profiler::WriteChromeTrace(Core::IO::IFileSystem& fs, std::string_view path)
+    {
+        std::string json;
+        ExportChromeTrace(json);
+
+        const size_t slash = path.find_last_of("/\\");
+        if (slash != std::string_view::npos && slash > 0)
+        {
+            Core::IO::FsResult r = fs.CreateDirectories(path.substr(0, slash));
+            if (!r)
+            {
+                return r;
+            }
+        }
+        return fs.WriteAllBytes(path, json.data(), json.size());
+    }
+}
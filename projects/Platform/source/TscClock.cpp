@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "include/TscClock.h"
+
+#if defined(DRAMA_HAS_TSC) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    /// @brief 周波数が電源状態によらず一定の TSC か(CPUID 0x80000007 EDX bit 8)
+    bool HasInvariantTsc() noexcept
+    {
+#if defined(DRAMA_HAS_TSC)
+#if defined(_MSC_VER)
+        int regs[4] = {};
+        __cpuid(regs, 0x80000000);
+        if (static_cast<unsigned int>(regs[0]) < 0x80000007u)
+        {
+            return false;
+        }
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u)
+        {
+            return false;
+        }
+        __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+        return (edx & (1u << 8)) != 0;
+#endif
+#else
+        return false;
+#endif
+    }
+}
+
+namespace Drama::Platform
+{
+    TscClock::Calibration TscClock::Calibrate() noexcept
+    {
+        // 使えなければ Ticks は steady_clock のナノ秒なので、変換は恒等(起点 0、倍率 1)のままにする
+        Calibration c;
+#if defined(DRAMA_HAS_TSC)
+        if (HasInvariantTsc())
+        {
+            // steady_clock の読み取りを TSC で挟み、その中点を同じ時刻とみなす。
+            // 数ms 離れた2点で比をとれば、読み取りの揺れ(数十ns)は 1e-5 程度の誤差に収まる
+            constexpr int64_t kWindowNs = 5'000'000;
+            const uint64_t t0a = __rdtsc();
+            const int64_t n0 = static_cast<int64_t>(SteadyNanoseconds());
+            const uint64_t t0b = __rdtsc();
+            int64_t n1 = n0;
+            uint64_t t1a = 0;
+            uint64_t t1b = 0;
+            do
+            {
+                t1a = __rdtsc();
+                n1 = static_cast<int64_t>(SteadyNanoseconds());
+                t1b = __rdtsc();
+            } while (n1 - n0 < kWindowNs);
+            const double ticks = static_cast<double>((t1a / 2 + t1b / 2) - (t0a / 2 + t0b / 2));
+            const double ns = static_cast<double>(n1 - n0);
+            if (ticks > 0.0)
+            {
+                c.useTsc = true;
+                c.nanosecondsPerTick = ns / ticks;
+                c.ticksPerSecond = ticks * 1e9 / ns;
+                c.baseTicks = t1a / 2 + t1b / 2;
+                c.baseNanoseconds = n1;
+            }
+        }
+#endif
+        return c;
+    }
+}
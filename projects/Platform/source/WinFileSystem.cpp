@@ -8,6 +8,7 @@
 #include <string>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include "include/Platform.h"
 
 namespace
@@ -73,6 +74,11 @@ namespace
         explicit operator bool() const noexcept { return h != INVALID_HANDLE_VALUE; }
     };
 
+    static void UnmapView(const uint8_t* data, size_t) noexcept
+    {
+        ::UnmapViewOfFile(data);
+    }
+
     static bool WriteAll(HANDLE h, const void* data, size_t size) noexcept
     {
         const uint8_t* p = static_cast<const uint8_t*>(data);
@@ -96,6 +102,196 @@ namespace
         }
         return true;
     }
+
+    static OVERLAPPED OffsetOf(uint64_t offset) noexcept
+    {
+        OVERLAPPED ov{};
+        ov.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        return ov;
+    }
+
+    /// @brief 位置指定で読めるだけ読む(EOFで止まる)
+    static bool ReadAtOffset(HANDLE h, uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept
+    {
+        uint8_t* p = static_cast<uint8_t*>(buffer);
+        bytesRead = 0;
+        while (bytesRead < size)
+        {
+            const size_t remaining = size - bytesRead;
+            const DWORD chunk = (remaining > 0x7FFFFFFF) ? 0x7FFFFFFF : static_cast<DWORD>(remaining);
+            OVERLAPPED ov = OffsetOf(offset + bytesRead);
+            DWORD n = 0;
+            if (!::ReadFile(h, p + bytesRead, chunk, &n, &ov))
+            {
+                if (::GetLastError() == ERROR_HANDLE_EOF)
+                {
+                    break;
+                }
+                return false;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            bytesRead += n;
+        }
+        return true;
+    }
+
+    static bool WriteAtOffset(HANDLE h, uint64_t offset, const void* data, size_t size) noexcept
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        size_t done = 0;
+        while (done < size)
+        {
+            const size_t remaining = size - done;
+            const DWORD chunk = (remaining > 0x7FFFFFFF) ? 0x7FFFFFFF : static_cast<DWORD>(remaining);
+            OVERLAPPED ov = OffsetOf(offset + done);
+            DWORD n = 0;
+            if (!::WriteFile(h, p + done, chunk, &n, &ov) || n != chunk)
+            {
+                return false;
+            }
+            done += chunk;
+        }
+        return true;
+    }
+
+    static FsResult SizeOf(HANDLE h, uint64_t& out) noexcept
+    {
+        LARGE_INTEGER sz{};
+        if (!::GetFileSizeEx(h, &sz))
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(FsError::IoError, e, "GetFileSizeEx failed.");
+        }
+        out = static_cast<uint64_t>(sz.QuadPart);
+        return FsResult::Ok();
+    }
+
+    /// @brief 位置は自前で持ち、読み込みは全て OVERLAPPED の位置指定で行う
+    class WinFileReader final : public Drama::Core::IO::IFileReader
+    {
+    public:
+        explicit WinFileReader(UniqueHandle&& h) noexcept : m_Handle(std::move(h)) {}
+
+        FsResult Read(void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            FsResult r = ReadAt(m_Position, buffer, size, bytesRead);
+            m_Position += bytesRead;
+            return r;
+        }
+
+        FsResult ReadAt(uint64_t offset, void* buffer, size_t size, size_t& bytesRead) noexcept override
+        {
+            if (size > 0 && buffer == nullptr)
+            {
+                bytesRead = 0;
+                return MakeError(FsError::IoError, 0, "Buffer is null.");
+            }
+            if (!ReadAtOffset(m_Handle.h, offset, buffer, size, bytesRead))
+            {
+                return MakeError(FsError::IoError, ::GetLastError(), "ReadFile(stream) failed.");
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            m_Position = offset;
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override { return SizeOf(m_Handle.h, out); }
+
+    private:
+        UniqueHandle m_Handle;
+        uint64_t m_Position = 0;
+    };
+
+    /// @brief 位置は自前で持ち、書き込みは全て OVERLAPPED の位置指定で行う
+    class WinFileWriter final : public Drama::Core::IO::IFileWriter
+    {
+    public:
+        WinFileWriter(UniqueHandle&& h, uint64_t position) noexcept : m_Handle(std::move(h)), m_Position(position) {}
+
+        FsResult Write(const void* data, size_t size) noexcept override
+        {
+            if (FsResult r = WriteAt(m_Position, data, size); !r)
+            {
+                return r;
+            }
+            m_Position += size;
+            return FsResult::Ok();
+        }
+
+        FsResult WriteV(std::span<const Drama::Core::IO::WriteSlice> slices) noexcept override
+        {
+            // WriteFileGather はバッファなし・ページ境界揃えが条件で汎用には使えないので、要素ごとに書く
+            for (const Drama::Core::IO::WriteSlice& slice : slices)
+            {
+                if (FsResult r = Write(slice.data, slice.size); !r)
+                {
+                    return r;
+                }
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult WriteAt(uint64_t offset, const void* data, size_t size) noexcept override
+        {
+            if (size > 0 && data == nullptr)
+            {
+                return MakeError(FsError::IoError, 0, "Data is null.");
+            }
+            if (!WriteAtOffset(m_Handle.h, offset, data, size))
+            {
+                return MakeError(FsError::IoError, ::GetLastError(), "WriteFile(stream) failed.");
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Seek(uint64_t offset) noexcept override
+        {
+            m_Position = offset;
+            return FsResult::Ok();
+        }
+
+        uint64_t Tell() const noexcept override { return m_Position; }
+
+        FsResult Size(uint64_t& out) noexcept override { return SizeOf(m_Handle.h, out); }
+
+        FsResult Flush() noexcept override
+        {
+            if (!::FlushFileBuffers(m_Handle.h))
+            {
+                return MakeError(FsError::IoError, ::GetLastError(), "FlushFileBuffers failed.");
+            }
+            return FsResult::Ok();
+        }
+
+        FsResult Close() noexcept override
+        {
+            if (m_Handle.h == INVALID_HANDLE_VALUE)
+            {
+                return FsResult::Ok();
+            }
+            const HANDLE h = m_Handle.h;
+            m_Handle.h = INVALID_HANDLE_VALUE;
+            if (!::CloseHandle(h))
+            {
+                return MakeError(FsError::IoError, ::GetLastError(), "CloseHandle failed.");
+            }
+            return FsResult::Ok();
+        }
+
+    private:
+        UniqueHandle m_Handle;
+        uint64_t m_Position = 0;
+    };
 }
 
 namespace Drama::Platform::IO
@@ -149,6 +345,66 @@ namespace Drama::Platform::IO
         }
     }
 
+    FsResult WinFileSystem::Remove(std::string_view path) noexcept
+    {
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        std::wstring w = Windows::ToUTF16(std::string(path));
+        NormalizeSlashes(w);
+        // Posix の unlink と同じくファイルだけを消す(ディレクトリは DeleteFileW が ERROR_ACCESS_DENIED で拒む)
+        if (::DeleteFileW(w.c_str()))
+        {
+            return FsResult::Ok();
+        }
+        const DWORD e = ::GetLastError();
+        return MakeError(MapWinErrorToFs(e), e, "Failed to remove file.");
+    }
+
+    FsResult WinFileSystem::FileSize(std::string_view path, uint64_t& out) noexcept
+    {
+        out = 0;
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        std::filesystem::path p = std::filesystem::path(Windows::ToUTF16(std::string(path)));
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(p, ec);
+        if (ec)
+        {
+            if (ec == std::errc::no_such_file_or_directory)
+            {
+                return MakeError(FsError::NotFound, 0, "Path not found.");
+            }
+            return MakeError(FsError::IoError, 0, "Failed to get file size due to IO error.");
+        }
+        out = static_cast<uint64_t>(size);
+        return FsResult::Ok();
+    }
+
+    FsResult WinFileSystem::LastWriteTime(std::string_view path, uint64_t& outNs) noexcept
+    {
+        outNs = 0;
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+        std::wstring w = Windows::ToUTF16(std::string(path));
+        NormalizeSlashes(w);
+        WIN32_FILE_ATTRIBUTE_DATA data{};
+        if (!::GetFileAttributesExW(w.c_str(), GetFileExInfoStandard, &data))
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(MapWinErrorToFs(e), e, "GetFileAttributesEx failed.");
+        }
+        // FILETIME は 100ns 単位
+        const uint64_t ticks = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        outNs = ticks * 100;
+        return FsResult::Ok();
+    }
+
     /// @brief 上書き
     /// @param path 
     /// @param data 
@@ -234,7 +490,7 @@ namespace Drama::Platform::IO
         if (sz.QuadPart < 0)
             return MakeError(FsError::IoError, 0, "Invalid file size.");
 
-        // vectorサイズに入らないレベルはこのAPIの責務外。必要ならストリーム読みを別途作れ。
+        // vectorサイズに入らないレベルはこのAPIの責務外。OpenRead のストリーム読みを使う。
         const uint64_t fileSize = (uint64_t)sz.QuadPart;
         if (fileSize > (uint64_t)std::vector<uint8_t>().max_size())
             return MakeError(FsError::IoError, 0, "File too large for vector.");
@@ -271,6 +527,73 @@ namespace Drama::Platform::IO
         return FsResult::Ok();
     }
 
+    /// @brief 読み取り専用マップ
+    /// @param path 
+    /// @param out 
+    /// @return 
+    Drama::Core::IO::FsResult WinFileSystem::MapReadOnly(std::string_view path, Drama::Core::IO::MappedFile& out) noexcept
+    {
+        out.Reset();
+
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        std::wstring w = Windows::ToUTF16(std::string(path));
+        NormalizeSlashes(w);
+        if (w.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Utf8ToWide failed.");
+        }
+
+        UniqueHandle h(::CreateFileW(
+            w.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr));
+
+        if (!h)
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(MapWinErrorToFs(e), e, "CreateFileW(map) failed.");
+        }
+
+        LARGE_INTEGER sz{};
+        if (!::GetFileSizeEx(h.h, &sz))
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(FsError::IoError, e, "GetFileSizeEx failed.");
+        }
+
+        // 空ファイルはマップできないので読み込み側に任せる
+        if (sz.QuadPart <= 0 || static_cast<uint64_t>(sz.QuadPart) > static_cast<uint64_t>(SIZE_MAX))
+        {
+            return IFileSystem::MapReadOnly(path, out);
+        }
+
+        // マッピングオブジェクトとファイルハンドルはビューが参照を持つので閉じてよい
+        HANDLE rawMapping = ::CreateFileMappingW(h.h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (rawMapping == nullptr)
+        {
+            return IFileSystem::MapReadOnly(path, out);
+        }
+        UniqueHandle mapping(rawMapping);
+
+        const void* view = ::MapViewOfFile(mapping.h, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            return IFileSystem::MapReadOnly(path, out);
+        }
+
+        out = Drama::Core::IO::MappedFile::FromMapping(
+            static_cast<const uint8_t*>(view), static_cast<size_t>(sz.QuadPart), &UnmapView);
+        return FsResult::Ok();
+    }
+
     /// @brief 追記
     /// @param path 
     /// @param data 
@@ -386,6 +709,108 @@ namespace Drama::Platform::IO
 
         return FsResult::Ok();
     }
+    Drama::Core::IO::FsResult WinFileSystem::OpenRead(std::string_view path, std::unique_ptr<Drama::Core::IO::IFileReader>& out) noexcept
+    {
+        out.reset();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        std::wstring w = Windows::ToUTF16(std::string(path));
+        NormalizeSlashes(w);
+        if (w.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Utf8ToWide failed.");
+        }
+
+        UniqueHandle h(::CreateFileW(
+            w.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr));
+        if (!h)
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(MapWinErrorToFs(e), e, "CreateFileW(stream read) failed.");
+        }
+
+        out = std::make_unique<WinFileReader>(std::move(h));
+        return FsResult::Ok();
+    }
+
+    Drama::Core::IO::FsResult WinFileSystem::OpenWrite(std::string_view path, Drama::Core::IO::FileWriteMode mode, std::unique_ptr<Drama::Core::IO::IFileWriter>& out) noexcept
+    {
+        out.reset();
+        if (path.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        std::wstring w = Windows::ToUTF16(std::string(path));
+        NormalizeSlashes(w);
+        if (w.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Utf8ToWide failed.");
+        }
+
+        // 追記でも FILE_APPEND_DATA は使わない(位置指定の WriteAt を許すため、末尾位置から書き始める)
+        const bool isAppend = (mode == Drama::Core::IO::FileWriteMode::Append);
+        UniqueHandle h(::CreateFileW(
+            w.c_str(),
+            GENERIC_WRITE,
+            FILE_SHARE_READ,
+            nullptr,
+            isAppend ? OPEN_ALWAYS : CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr));
+        if (!h)
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(MapWinErrorToFs(e), e, "CreateFileW(stream write) failed.");
+        }
+
+        uint64_t position = 0;
+        if (isAppend)
+        {
+            if (FsResult r = SizeOf(h.h, position); !r)
+            {
+                return r;
+            }
+        }
+
+        out = std::make_unique<WinFileWriter>(std::move(h), position);
+        return FsResult::Ok();
+    }
+
+    Drama::Core::IO::FsResult WinFileSystem::CopyAllBytes(std::string_view src, std::string_view dst) noexcept
+    {
+        if (src.empty() || dst.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Path is empty.");
+        }
+
+        std::wstring wSrc = Windows::ToUTF16(std::string(src));
+        std::wstring wDst = Windows::ToUTF16(std::string(dst));
+        NormalizeSlashes(wSrc);
+        NormalizeSlashes(wDst);
+        if (wSrc.empty() || wDst.empty())
+        {
+            return MakeError(FsError::InvalidPath, 0, "Utf8ToWide failed.");
+        }
+
+        // CopyFileW はカーネル側でコピーする(ReFSならブロック共有になる)
+        if (!::CopyFileW(wSrc.c_str(), wDst.c_str(), FALSE))
+        {
+            const DWORD e = ::GetLastError();
+            return MakeError(MapWinErrorToFs(e), e, "CopyFileW failed.");
+        }
+        return FsResult::Ok();
+    }
+
     std::string WinFileSystem::currentPath() noexcept
     {
         return std::filesystem::current_path().string();
@@ -0,0 +1,265 @@
+#include "pch.h"
+#include "include/WinFileWatcher.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Core/include/FileChangeCoalescer.h"
+#include "include/Platform.h"
+
+namespace
+{
+    using Drama::Core::IO::FileChangeKind;
+    using Drama::Core::IO::FileWatchId;
+    using Drama::Core::IO::FsError;
+    using Drama::Core::IO::FsResult;
+
+    constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+    constexpr DWORD kBufferSize = 64 * 1024; ///< ネットワークドライブでは64KBを超えると失敗する
+
+    FsResult MakeError(const char* msg, DWORD lastErr = ::GetLastError()) noexcept
+    {
+        FsResult r;
+        r.error = (lastErr == ERROR_FILE_NOT_FOUND || lastErr == ERROR_PATH_NOT_FOUND) ? FsError::NotFound
+            : (lastErr == ERROR_ACCESS_DENIED) ? FsError::AccessDenied : FsError::IoError;
+        r.ec = std::error_code(static_cast<int>(lastErr), std::system_category());
+        r.message = msg;
+        return r;
+    }
+
+    uint64_t NowNs() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::string TrimTrailingSlash(std::string_view path)
+    {
+        while (path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+        {
+            path.remove_suffix(1);
+        }
+        std::string s(path);
+        for (char& c : s)
+        {
+            if (c == '\\') c = '/';
+        }
+        return s;
+    }
+}
+
+namespace Drama::Platform::IO
+{
+    struct WinFileWatcher::Impl
+    {
+        struct DirWatch
+        {
+            std::string path;
+            std::wstring pathW;
+            bool recursive = false;
+            HANDLE dir = INVALID_HANDLE_VALUE;
+            OVERLAPPED ov{};
+            alignas(DWORD) BYTE buffer[kBufferSize];
+        };
+
+        HANDLE port = nullptr;
+        uint64_t debounceNs = 0;
+        FileWatchId nextId = 1;
+        std::unordered_map<FileWatchId, std::unique_ptr<DirWatch>> watches;
+        Drama::Core::IO::FileChangeCoalescer coalescer;
+        std::string name;
+
+        static bool Issue(DirWatch& w) noexcept
+        {
+            w.ov = OVERLAPPED{};
+            return ::ReadDirectoryChangesW(w.dir, w.buffer, kBufferSize, w.recursive ? TRUE : FALSE,
+                kNotifyFilter, nullptr, &w.ov, nullptr) != FALSE;
+        }
+
+        /// @brief 要求を取り消して、完了を待ってから閉じる(バッファを解放する前にOSが触らなくなるように)
+        static void Close(DirWatch& w) noexcept
+        {
+            if (w.dir == INVALID_HANDLE_VALUE)
+            {
+                return;
+            }
+            ::CancelIoEx(w.dir, &w.ov);
+            DWORD bytes = 0;
+            ::GetOverlappedResult(w.dir, &w.ov, &bytes, TRUE);
+            ::CloseHandle(w.dir);
+            w.dir = INVALID_HANDLE_VALUE;
+        }
+
+        void Handle(DirWatch& w, DWORD bytes, uint64_t now)
+        {
+            if (bytes == 0)
+            {
+                // バッファがあふれて通知が捨てられた
+                coalescer.Push(w.path, FileChangeKind::Rescan, now);
+                return;
+            }
+            const BYTE* p = w.buffer;
+            while (true)
+            {
+                const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p);
+                const std::wstring relW(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                name = w.path + "/" + Windows::ToUTF8(relW);
+                for (char& c : name)
+                {
+                    if (c == '\\') c = '/';
+                }
+
+                switch (info->Action)
+                {
+                case FILE_ACTION_ADDED:
+                case FILE_ACTION_RENAMED_NEW_NAME:
+                    coalescer.Push(name, FileChangeKind::Added, now);
+                    break;
+                case FILE_ACTION_REMOVED:
+                case FILE_ACTION_RENAMED_OLD_NAME:
+                    coalescer.Push(name, FileChangeKind::Removed, now);
+                    break;
+                case FILE_ACTION_MODIFIED:
+                {
+                    // 子が変わるとディレクトリ自体の更新も届くので、ディレクトリは外す
+                    const std::wstring fullW = w.pathW + L"\\" + relW;
+                    const DWORD attr = ::GetFileAttributesW(fullW.c_str());
+                    if (attr == INVALID_FILE_ATTRIBUTES || (attr & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                    {
+                        coalescer.Push(name, FileChangeKind::Modified, now);
+                    }
+                    break;
+                }
+                default:
+                    break;
+                }
+
+                if (info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                p += info->NextEntryOffset;
+            }
+        }
+    };
+
+    WinFileWatcher::WinFileWatcher(const Drama::Core::IO::FileWatchDesc& desc)
+        : m_Impl(std::make_unique<Impl>())
+    {
+        m_Impl->port = ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+        m_Impl->debounceNs = static_cast<uint64_t>(desc.debounceMs) * 1000000ull;
+    }
+
+    WinFileWatcher::~WinFileWatcher()
+    {
+        for (auto& [id, w] : m_Impl->watches)
+        {
+            Impl::Close(*w);
+        }
+        m_Impl->watches.clear();
+        if (m_Impl->port != nullptr)
+        {
+            ::CloseHandle(m_Impl->port);
+        }
+    }
+
+    FsResult WinFileWatcher::Watch(std::string_view directory, bool recursive, FileWatchId& out) noexcept
+    {
+        out = Drama::Core::IO::kInvalidFileWatchId;
+        if (directory.empty())
+        {
+            FsResult r;
+            r.error = FsError::InvalidPath;
+            r.message = "Path is empty.";
+            return r;
+        }
+        if (m_Impl->port == nullptr)
+        {
+            return MakeError("CreateIoCompletionPort failed.");
+        }
+
+        auto w = std::make_unique<Impl::DirWatch>();
+        w->path = TrimTrailingSlash(directory);
+        w->pathW = Windows::ToUTF16(w->path);
+        w->recursive = recursive;
+        w->dir = ::CreateFileW(w->pathW.c_str(), FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (w->dir == INVALID_HANDLE_VALUE)
+        {
+            return MakeError("CreateFileW(directory) failed.");
+        }
+
+        const FileWatchId id = m_Impl->nextId++;
+        if (::CreateIoCompletionPort(w->dir, m_Impl->port, static_cast<ULONG_PTR>(id), 0) == nullptr ||
+            !Impl::Issue(*w))
+        {
+            FsResult r = MakeError("ReadDirectoryChangesW failed.");
+            ::CloseHandle(w->dir);
+            return r;
+        }
+        m_Impl->watches.emplace(id, std::move(w));
+        out = id;
+        return FsResult::Ok();
+    }
+
+    void WinFileWatcher::Unwatch(FileWatchId id) noexcept
+    {
+        auto it = m_Impl->watches.find(id);
+        if (it == m_Impl->watches.end())
+        {
+            return;
+        }
+        // 取り消しの完了もポートに届くが、Poll はキーで引くので外した監視のものは無視される
+        Impl::Close(*it->second);
+        m_Impl->watches.erase(it);
+    }
+
+    size_t WinFileWatcher::Poll(std::vector<Drama::Core::IO::FileChange>& out) noexcept
+    {
+        if (m_Impl->port == nullptr)
+        {
+            return 0;
+        }
+        const uint64_t now = NowNs();
+        OVERLAPPED_ENTRY entries[16];
+        ULONG count = 0;
+        while (::GetQueuedCompletionStatusEx(m_Impl->port, entries, static_cast<ULONG>(std::size(entries)), &count, 0, FALSE) &&
+            count > 0)
+        {
+            for (ULONG i = 0; i < count; ++i)
+            {
+                auto it = m_Impl->watches.find(static_cast<FileWatchId>(entries[i].lpCompletionKey));
+                if (it == m_Impl->watches.end() || entries[i].lpOverlapped != &it->second->ov)
+                {
+                    continue;
+                }
+                Impl::DirWatch& w = *it->second;
+                DWORD bytes = 0;
+                if (!::GetOverlappedResult(w.dir, &w.ov, &bytes, FALSE))
+                {
+                    // ディレクトリが消えたなど。監視は止まるので読み直しを促す
+                    m_Impl->coalescer.Push(w.path, FileChangeKind::Rescan, now);
+                    continue;
+                }
+                m_Impl->Handle(w, bytes, now);
+                if (!Impl::Issue(w))
+                {
+                    m_Impl->coalescer.Push(w.path, FileChangeKind::Rescan, now);
+                }
+            }
+            if (count < std::size(entries))
+            {
+                break;
+            }
+        }
+        return m_Impl->coalescer.Drain(now, m_Impl->debounceNs, out);
+    }
+}
+#endif
@@ -0,0 +1,145 @@
+#include "TestCommon.h"
+
+#include "Core/include/ArchiveFileSystem.h"
+#include "Core/include/OverlayFileSystem.h"
+#include "Core/include/PackBuilder.h"
+
+// C++ standard library includes
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::IO;
+
+    std::vector<uint8_t> Bytes(std::string_view s)
+    {
+        return std::vector<uint8_t>(s.begin(), s.end());
+    }
+
+    /// @brief src/ 以下に素材を置き、パックを作る
+    std::string BuildPack(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string src = root + "src/";
+        fs.CreateDirectories(src + "textures");
+        fs.WriteAllBytes(src + "textures/a.txt", "texture a", 9);
+        fs.WriteAllBytes(src + "b.txt", "bee", 3);
+        fs.WriteAllBytes(src + "empty.txt", nullptr, 0);
+        std::vector<uint8_t> big(200000);
+        for (size_t i = 0; i < big.size(); ++i)
+        {
+            big[i] = static_cast<uint8_t>(i * 13);
+        }
+        fs.WriteAllBytes(src + "big.bin", big.data(), big.size());
+
+        PackBuilder builder;
+        Test::Expect(builder.Add("textures/a.txt", src + "textures/a.txt"), "Add");
+        Test::Expect(builder.Add("./b.txt", src + "b.txt"), "Add(./)");
+        Test::Expect(builder.Add("empty.txt", src + "empty.txt"), "Add(empty)");
+        Test::Expect(builder.Add("big.bin", src + "big.bin"), "Add(big)");
+        Test::Expect(!builder.Add("b.txt", src + "b.txt"), "Add(duplicate)");
+
+        const std::string pack = root + "test.pak";
+        Test::Expect(static_cast<bool>(builder.Build(fs, pack)), "Build");
+        return pack;
+    }
+
+    void TestArchive(IFileSystem& fs, const std::string& pack)
+    {
+        using namespace Drama;
+
+        ArchiveFileSystem archive;
+        Test::Expect(static_cast<bool>(archive.Open(fs, pack)), "Open");
+        Test::Expect(archive.EntryCount() == 4, "EntryCount");
+
+        std::vector<uint8_t> out;
+        Test::Expect(static_cast<bool>(archive.ReadAllBytes("textures/a.txt", out)) && out == Bytes("texture a"), "ReadAllBytes");
+        Test::Expect(static_cast<bool>(archive.ReadAllBytes("textures\\a.txt", out)) && out == Bytes("texture a"), "ReadAllBytes(backslash)");
+        Test::Expect(static_cast<bool>(archive.ReadAllBytes("/b.txt", out)) && out == Bytes("bee"), "ReadAllBytes(leading slash)");
+        Test::Expect(static_cast<bool>(archive.ReadAllBytes("empty.txt", out)) && out.empty(), "ReadAllBytes(empty)");
+        Test::Expect(archive.ReadAllBytes("missing.txt", out).error == FsError::NotFound, "ReadAllBytes(missing)");
+
+        MappedFile view;
+        Test::Expect(static_cast<bool>(archive.MapReadOnly("big.bin", view)) && view.Size() == 200000, "MapReadOnly");
+        Test::Expect(reinterpret_cast<uintptr_t>(view.Data()) % Pack::kAlignment == 0 || !view.IsMapped(), "blob alignment");
+        Test::Expect(view.Bytes()[12345] == static_cast<uint8_t>(12345 * 13), "MapReadOnly content");
+
+        std::unique_ptr<IFileReader> reader;
+        uint8_t buf[3] = {};
+        size_t n = 0;
+        Test::Expect(static_cast<bool>(archive.OpenRead("b.txt", reader)) && reader->ReadAt(1, buf, 3, n) && n == 2, "OpenRead");
+
+        Test::Expect(static_cast<bool>(archive.Exists("textures")), "Exists(dir)");
+        Test::Expect(archive.Exists("texture").error == FsError::NotFound, "Exists(partial dir name)");
+        Test::Expect(archive.WriteAllBytes("b.txt", "x", 1).error == FsError::AccessDenied, "read-only");
+    }
+
+    void TestCorruptArchive(IFileSystem& fs, const std::string& root, const std::string& pack)
+    {
+        using namespace Drama;
+
+        std::vector<uint8_t> bytes;
+        fs.ReadAllBytes(pack, bytes);
+        // 先頭エントリのサイズを壊す
+        bytes[sizeof(Pack::PackHeader) + 16] = 0xFF;
+        bytes[sizeof(Pack::PackHeader) + 23] = 0x7F;
+        const std::string bad = root + "bad.pak";
+        fs.WriteAllBytes(bad, bytes.data(), bytes.size());
+
+        ArchiveFileSystem archive;
+        Test::Expect(!archive.Open(fs, bad) && !archive.IsOpen(), "corrupt archive rejected");
+        Test::Expect(!archive.Open(fs, root + "src/b.txt"), "non-pack rejected");
+    }
+
+    void TestOverlay(IFileSystem& fs, const std::string& root, const std::string& pack)
+    {
+        using namespace Drama;
+
+        ArchiveFileSystem archive;
+        archive.Open(fs, pack);
+
+        // 実ファイル側の同名ファイルより、パックが優先される
+        const std::string looseRoot = fs.currentPath();
+        const std::string shadowed = looseRoot + "/b.txt";
+        OverlayFileSystem overlay(fs);
+        overlay.Mount(archive);
+
+        std::vector<uint8_t> out;
+        Test::Expect(static_cast<bool>(overlay.ReadAllBytes(shadowed, out)) && out == Bytes("bee"), "overlay prefers archive");
+        Test::Expect(static_cast<bool>(overlay.ReadAllBytes("textures/a.txt", out)) && out == Bytes("texture a"), "overlay relative path");
+
+        // パックに無ければ実ファイル
+        const std::string loosePath = root + "loose_only.txt";
+        fs.WriteAllBytes(loosePath, "loose", 5);
+        Test::Expect(static_cast<bool>(overlay.ReadAllBytes(loosePath, out)) && out == Bytes("loose"), "overlay falls back to loose");
+        Test::Expect(overlay.ReadAllBytes(root + "nowhere.txt", out).error == FsError::NotFound, "overlay missing");
+
+        // 書き込みは実ファイルへ
+        const std::string written = root + "overlay_written.txt";
+        Test::Expect(static_cast<bool>(overlay.WriteAllBytes(written, "w", 1)) && static_cast<bool>(fs.Exists(written)), "overlay writes to loose");
+
+        overlay.Unmount(archive);
+        Test::Expect(overlay.ReadAllBytes("textures/a.txt", out).error == FsError::NotFound, "Unmount");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunArchiveFileSystemTests(Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        const std::string dir = root + "archive/";
+        fs.CreateDirectories(dir);
+
+        const std::string pack = BuildPack(fs, dir);
+        TestArchive(fs, pack);
+        TestCorruptArchive(fs, dir, pack);
+        TestOverlay(fs, dir, pack);
+
+        // パックを積んでいない重ね合わせは、実ファイルと同じ振る舞いであること
+        Core::IO::OverlayFileSystem overlay(fs);
+        RunFileSystemConformanceTests(overlay, dir + "overlay_");
+    }
+}
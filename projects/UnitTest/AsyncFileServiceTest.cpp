@@ -0,0 +1,262 @@
+#include "TestCommon.h"
+
+#include "Core/include/AsyncFileService.h"
+#include "Core/include/MemoryTracker.h"
+
+// C++ standard library includes
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::IO;
+
+    std::vector<uint8_t> Bytes(std::string_view s)
+    {
+        return std::vector<uint8_t>(s.begin(), s.end());
+    }
+
+    IoRequest MakeWrite(const std::string& path, std::string_view text, IoPriority priority = IoPriority::Normal)
+    {
+        IoRequest r{};
+        r.op = IoOp::Write;
+        r.path = path;
+        r.data = Bytes(text);
+        r.priority = priority;
+        return r;
+    }
+
+    void TestRoundTrip(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        AsyncFileService io;
+        Test::Expect(io.Start(fs), "Start");
+
+        const std::string path = root + "async_io.bin";
+        int writes = 0;
+        IoRequest w = MakeWrite(path, "async payload");
+        w.onComplete = [&writes](IoCompletion& c) { writes += (c.status == IoStatus::Completed) ? 1 : 0; };
+        Test::Expect(io.Submit(std::move(w)) != 0, "Submit(write)");
+        io.WaitIdle();
+        Test::Expect(io.DispatchCompletions() == 1 && writes == 1, "write completion");
+
+        std::vector<uint8_t> read;
+        IoRequest r{};
+        r.op = IoOp::Read;
+        r.path = path;
+        r.userData = 42;
+        r.onComplete = [&read](IoCompletion& c)
+            {
+                if (c.status == IoStatus::Completed && c.userData == 42)
+                {
+                    read = std::move(c.data);
+                }
+            };
+        io.Submit(std::move(r));
+        io.WaitIdle();
+        io.DispatchCompletions();
+        Test::Expect(read == Bytes("async payload"), "read completion content");
+
+        IoStatus missing = IoStatus::Completed;
+        IoRequest m{};
+        m.path = root + "async_missing.bin";
+        m.onComplete = [&missing](IoCompletion& c) { missing = c.status; };
+        io.Submit(std::move(m));
+        io.WaitIdle();
+        io.DispatchCompletions();
+        Test::Expect(missing == IoStatus::Failed, "read missing fails");
+
+        io.Stop();
+        Test::Expect(io.Submit(MakeWrite(path, "late")) == 0, "Submit after Stop");
+    }
+
+    void TestPriorityOrder(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        // 1スレッドならバッチ内は優先度順、同じ優先度は受付順に処理される
+        AsyncFileDesc desc{};
+        desc.workerCount = 1;
+        AsyncFileService io;
+        io.Start(fs, desc);
+
+        std::vector<int> order;
+        std::vector<IoRequest> batch;
+        const IoPriority priorities[] = { IoPriority::Low, IoPriority::Normal, IoPriority::High, IoPriority::Normal };
+        for (int i = 0; i < 4; ++i)
+        {
+            IoRequest r = MakeWrite(root + "prio_" + std::to_string(i) + ".txt", "x", priorities[i]);
+            r.onComplete = [&order, i](IoCompletion&) { order.push_back(i); };
+            batch.push_back(std::move(r));
+        }
+        io.SubmitBatch(std::move(batch));
+        io.WaitIdle();
+        io.DispatchCompletions();
+        Test::Expect(order == std::vector<int>{ 2, 1, 3, 0 }, "priority order");
+    }
+
+    void TestCancel(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        AsyncFileDesc desc{};
+        desc.workerCount = 1;
+        AsyncFileService io;
+        io.Start(fs, desc);
+
+        std::vector<IoRequest> batch;
+        for (int i = 0; i < 64; ++i)
+        {
+            batch.push_back(MakeWrite(root + "cancel_" + std::to_string(i) + ".txt", "payload"));
+        }
+        const std::string lastPath = root + "cancel_63.txt";
+        fs.WriteAllBytes(lastPath, "old", 3);
+
+        IoStatus lastStatus = IoStatus::Failed;
+        batch.back().onComplete = [&lastStatus](IoCompletion& c) { lastStatus = c.status; };
+        const IoRequestId first = io.SubmitBatch(std::move(batch));
+
+        // 実行済みなら取り消せない。どちらの場合も結果と整合していること
+        const bool isCancelled = io.Cancel(first + 63);
+        io.WaitIdle();
+        io.DispatchCompletions();
+        Test::Expect(io.Stats().completed == 64, "every request completes once");
+
+        std::vector<uint8_t> content;
+        fs.ReadAllBytes(lastPath, content);
+        if (isCancelled)
+        {
+            Test::Expect(lastStatus == IoStatus::Cancelled, "cancelled status");
+            Test::Expect(content == Bytes("old"), "cancelled write did not run");
+        }
+        else
+        {
+            Test::Expect(lastStatus == IoStatus::Completed, "not cancelled status");
+        }
+        Test::Expect(!io.Cancel(first + 63), "cancel after completion");
+        Test::Expect(!io.Cancel(123456789), "cancel unknown id");
+    }
+
+    void TestInFlightCap(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        AsyncFileDesc desc{};
+        desc.workerCount = 4;
+        desc.maxInFlightBytes = 64 * 1024;
+        AsyncFileService io;
+        io.Start(fs, desc);
+
+        std::vector<IoRequest> batch;
+        for (int i = 0; i < 32; ++i)
+        {
+            IoRequest r{};
+            r.op = IoOp::Write;
+            r.path = root + "cap_" + std::to_string(i) + ".bin";
+            r.data.assign(40 * 1024, static_cast<uint8_t>(i));
+            batch.push_back(std::move(r));
+        }
+        io.SubmitBatch(std::move(batch));
+        io.WaitIdle();
+
+        const AsyncFileStats s = io.Stats();
+        Test::Expect(s.peakInFlightBytes <= desc.maxInFlightBytes, "in-flight cap respected");
+        Test::Expect(s.peakQueued >= 1 && s.queued == 0 && s.running == 0, "queue drained");
+        Test::Expect(io.DispatchCompletions() == 32, "all completions delivered");
+    }
+
+    /// @brief 予想サイズを渡さない読み込みも実際のサイズで上限に数える
+    void TestReadCapWithoutHint(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            const std::vector<uint8_t> bytes(40 * 1024, static_cast<uint8_t>(i));
+            fs.WriteAllBytes(root + "cap_read_" + std::to_string(i) + ".bin", bytes.data(), bytes.size());
+        }
+
+        AsyncFileDesc desc{};
+        desc.workerCount = 4;
+        desc.maxInFlightBytes = 64 * 1024;
+        AsyncFileService io;
+        io.Start(fs, desc);
+
+        std::vector<IoRequest> batch;
+        for (int i = 0; i < 16; ++i)
+        {
+            IoRequest r{};
+            r.op = IoOp::Read;
+            r.path = root + "cap_read_" + std::to_string(i) + ".bin";
+            batch.push_back(std::move(r));
+        }
+        io.SubmitBatch(std::move(batch));
+        io.WaitIdle();
+
+        const AsyncFileStats s = io.Stats();
+        Test::Expect(s.peakInFlightBytes >= 40 * 1024, "read without sizeHint charges the file size");
+        Test::Expect(s.peakInFlightBytes <= desc.maxInFlightBytes, "read without sizeHint respects the cap");
+        Test::Expect(s.inFlightBytes == 0, "charged bytes are released");
+        Test::Expect(io.DispatchCompletions() == 16, "all read completions delivered");
+    }
+
+#if DRAMA_MEMORY_TRACKING
+    /// @brief 預かっている間の書き込み内容と読み込み結果は IO として数えられ、手放すと戻る
+    void TestMemoryTag(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+        using Core::Memory::MemoryTag;
+        using Core::Memory::MemoryTracker;
+
+        const std::string path = root + "async_tag.bin";
+        MemoryTracker::Update(0);
+        const int64_t base = MemoryTracker::Stats(MemoryTag::IO).liveBytes;
+        {
+            AsyncFileService io;
+            Test::Expect(io.Start(fs), "Start");
+            io.Submit(MakeWrite(path, std::string(4096, 'x')));
+            io.WaitIdle();
+            io.DispatchCompletions();
+            MemoryTracker::Update(1);
+            Test::Expect(MemoryTracker::Stats(MemoryTag::IO).liveBytes == base, "written data is released");
+
+            IoRequest r{};
+            r.path = path;
+            io.Submit(std::move(r));
+            io.WaitIdle();
+            MemoryTracker::Update(2);
+            Test::Expect(MemoryTracker::Stats(MemoryTag::IO).liveBytes - base >= 4096, "undelivered read is tagged IO");
+            io.DispatchCompletions();
+            MemoryTracker::Update(3);
+            Test::Expect(MemoryTracker::Stats(MemoryTag::IO).liveBytes == base, "delivered read is released");
+
+            // 配らずに壊しても戻る
+            IoRequest again{};
+            again.path = path;
+            io.Submit(std::move(again));
+            io.WaitIdle();
+        }
+        MemoryTracker::Update(4);
+        Test::Expect(MemoryTracker::Stats(MemoryTag::IO).liveBytes == base, "undelivered read is released on destruction");
+    }
+#endif
+}
+
+namespace Drama::Test
+{
+    void RunAsyncFileServiceTests(Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        const std::string dir = root + "async_io/";
+        fs.CreateDirectories(dir);
+
+        TestRoundTrip(fs, dir);
+        TestPriorityOrder(fs, dir);
+        TestCancel(fs, dir);
+        TestInFlightCap(fs, dir);
+        TestReadCapWithoutHint(fs, dir);
+#if DRAMA_MEMORY_TRACKING
+        TestMemoryTag(fs, dir);
+#endif
+    }
+}
@@ -0,0 +1,68 @@
+#include "TestCommon.h"
+
+#include "Core/include/BinaryLogFormat.h"
+
+// C++ standard library includes
+#include <string>
+#include <vector>
+
+namespace
+{
+    void TestRoundTrip()
+    {
+        using namespace Drama::Core;
+
+        constexpr BinaryLog::Format<int, const char*, double> kFmt("frame {} [{}] dt={:.3f}");
+        constexpr BinaryLog::Format<unsigned, bool, char> kFmt2("{{hex}} {0:#x} {1} {2} {0}");
+        static_assert(kFmt.id == BinaryLog::HashFormat("frame {} [{}] dt={:.3f}"));
+
+        std::vector<uint8_t> bytes;
+        BinaryLog::AppendFileHeader(bytes, 0);
+        BinaryLog::AppendFormatDef(bytes, kFmt.id, kFmt.str);
+        BinaryLog::AppendMessage(bytes, kFmt.id, LogLevel::Info, 1'500'000'000, 42, "render", 0.0166);
+        BinaryLog::AppendFormatDef(bytes, kFmt2.id, kFmt2.str);
+        BinaryLog::AppendMessage(bytes, kFmt2.id, LogLevel::Warning, 2'000'000'000, 255u, true, 'z');
+
+        std::string text;
+        Drama::Test::Expect(BinaryLog::DecodeToText(bytes.data(), bytes.size(), text), "decode complete log");
+        Drama::Test::Expect(text ==
+            "[+1.500000s][Info] frame 42 [render] dt=0.017\n"
+            "[+2.000000s][Warning] {hex} 0xff true z 255\n", "decoded text matches std::format");
+
+        // 末尾が欠けたログは読めた所まで出して false
+        std::string partial;
+        Drama::Test::Expect(!BinaryLog::DecodeToText(bytes.data(), bytes.size() - 3, partial), "truncated log reports failure");
+        Drama::Test::Expect(partial == "[+1.500000s][Info] frame 42 [render] dt=0.017\n", "truncated log keeps complete records");
+    }
+
+    /// @brief 記録時と型が合わない書式指定は例外を出さずに "{?}" にする
+    void TestMismatchedSpec()
+    {
+        using namespace Drama::Core;
+
+        const std::string_view fmt = "{:.2f}|{:x}|{:*^7}|{:c}|{:c}|{:+}|{:p}|{:99999999}";
+        const uint64_t id = BinaryLog::HashFormat(fmt);
+        std::vector<uint8_t> bytes;
+        BinaryLog::AppendFileHeader(bytes, 7, 3);
+        BinaryLog::AppendFormatDef(bytes, id, fmt);
+        BinaryLog::AppendMessage(bytes, id, LogLevel::Info, 0, "s", 255.5, "mid", 1000, 65, "t", 5, 1);
+
+        std::string text;
+        Drama::Test::Expect(BinaryLog::DecodeToText(bytes.data(), bytes.size(), text), "decode mismatched spec");
+        Drama::Test::Expect(text == "[+0.000000s][Info] {?}|{?}|**mid**|{?}|A|{?}|{?}|{?}\n", "invalid specs become {?}");
+
+        uint64_t startTimeNs = 0;
+        uint16_t segment = 0;
+        Drama::Test::Expect(BinaryLog::ReadFileHeader(bytes.data(), bytes.size(), startTimeNs, segment) &&
+            startTimeNs == 7 && segment == 3, "file header keeps start time and segment");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunBinaryLogTests()
+    {
+        TestRoundTrip();
+        TestMismatchedSpec();
+    }
+}
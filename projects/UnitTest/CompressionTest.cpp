@@ -0,0 +1,268 @@
+#include "TestCommon.h"
+
+#include "Core/include/CompressedBlob.h"
+#include "Core/include/CompressedFileSystem.h"
+#include "Core/include/JobSystem.h"
+#include "Core/include/LzCodec.h"
+
+// C++ standard library includes
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::IO;
+    namespace Compression = Drama::Core::Compression;
+
+    /// @brief 圧縮の効く内容(ログ風の行)か、効かない内容(乱数)を作る
+    std::vector<uint8_t> MakeData(size_t size, bool compressible)
+    {
+        std::vector<uint8_t> data;
+        data.reserve(size);
+        uint32_t x = 12345;
+        char line[96];
+        while (data.size() < size)
+        {
+            x = x * 1664525u + 1013904223u;
+            if (compressible)
+            {
+                const int n = std::snprintf(line, sizeof(line), "frame=%06u entity=%u pos=(%u.0, 2.5) state=idle\n",
+                    static_cast<unsigned>(data.size() / 64), x >> 26, (x >> 8) & 0xFF);
+                data.insert(data.end(), line, line + n);
+            }
+            else
+            {
+                data.push_back(static_cast<uint8_t>(x >> 24));
+            }
+        }
+        data.resize(size);
+        return data;
+    }
+
+    bool RoundTrip(const std::vector<uint8_t>& raw, size_t* compressedSize = nullptr)
+    {
+        auto scratch = std::make_unique<Compression::CompressScratch>();
+        std::vector<uint8_t> packed(Compression::CompressBound(raw.size()));
+        const size_t n = Compression::Compress(raw.data(), raw.size(), packed.data(), packed.size(), *scratch);
+        if (compressedSize != nullptr)
+        {
+            *compressedSize = n;
+        }
+        std::vector<uint8_t> back(raw.size());
+        return n > 0 && Compression::Decompress(packed.data(), n, back.data(), back.size()) && back == raw;
+    }
+
+    void TestCodec()
+    {
+        using namespace Drama;
+
+        Test::Expect(RoundTrip({}), "codec empty");
+        Test::Expect(RoundTrip({ 'a', 'b', 'c' }), "codec short");
+        Test::Expect(RoundTrip(std::vector<uint8_t>(100000, 7)), "codec run");
+        Test::Expect(RoundTrip(MakeData(300000, false)), "codec random");
+
+        size_t packed = 0;
+        const std::vector<uint8_t> text = MakeData(128 * 1024, true);
+        Test::Expect(RoundTrip(text, &packed) && packed < text.size() / 2, "codec compresses text");
+
+        // 壊れた入力は範囲外を触らずに失敗する
+        auto scratch = std::make_unique<Compression::CompressScratch>();
+        std::vector<uint8_t> buf(Compression::CompressBound(text.size()));
+        const size_t n = Compression::Compress(text.data(), text.size(), buf.data(), buf.size(), *scratch);
+        std::vector<uint8_t> out(text.size());
+        Test::Expect(!Compression::Decompress(buf.data(), n / 2, out.data(), out.size()), "codec truncated input");
+        Test::Expect(!Compression::Decompress(buf.data(), n, out.data(), out.size() - 1), "codec wrong raw size");
+        Test::Expect(Compression::Compress(text.data(), text.size(), buf.data(), 16, *scratch) == 0, "codec small capacity");
+    }
+
+    void TestBlob(Drama::Core::Job::JobSystem& jobs)
+    {
+        using namespace Drama;
+
+        std::vector<uint8_t> raw = MakeData(700000, true);
+        const std::vector<uint8_t> noise = MakeData(100000, false);
+        raw.insert(raw.end(), noise.begin(), noise.end());
+
+        std::vector<uint8_t> blob;
+        Blob::Encode(raw, Blob::kMinBlockSize, &jobs, blob);
+        Blob::BlobIndex index;
+        Test::Expect(Blob::IsBlob(blob) && Blob::ReadIndex(blob, index), "blob index");
+        Test::Expect(index.blocks.size() == (raw.size() + Blob::kMinBlockSize - 1) / Blob::kMinBlockSize, "blob block count");
+        Test::Expect(blob.size() < raw.size(), "blob compresses");
+        Test::Expect((index.blocks.back().flags & Blob::kBlockStored) != 0, "incompressible block is stored");
+        Test::Expect(Blob::FindBlock(index, Blob::kMinBlockSize) == 1 && Blob::FindBlock(index, raw.size()) == index.blocks.size(), "FindBlock");
+
+        std::vector<uint8_t> back(raw.size());
+        Test::Expect(Blob::Decode(blob, index, back.data(), &jobs) && back == raw, "blob parallel decode");
+        Test::Expect(Blob::Decode(blob, index, back.data(), nullptr) && back == raw, "blob serial decode");
+        std::vector<uint8_t> serial;
+        Blob::Encode(raw, Blob::kMinBlockSize, nullptr, serial);
+        Test::Expect(serial == blob, "blob serial encode matches parallel");
+
+        // 索引が本体の外を指していたら読まない
+        std::vector<uint8_t> broken = blob;
+        Blob::BlobHeader header{};
+        std::memcpy(&header, broken.data(), sizeof(header));
+        Blob::BlockEntry entry{};
+        std::memcpy(&entry, broken.data() + header.indexOffset, sizeof(entry));
+        entry.storedSize = 0x7FFFFFFF;
+        std::memcpy(broken.data() + header.indexOffset, &entry, sizeof(entry));
+        Test::Expect(!Blob::ReadIndex(broken, index), "blob corrupt index");
+    }
+
+    /// @brief 下の IFileSystem に置かれた圧縮ファイルを展開する(追記途中の状態を確かめる用)
+    bool DecodeStored(const std::vector<uint8_t>& stored, std::vector<uint8_t>& out)
+    {
+        Blob::BlobIndex index;
+        if (!Blob::ReadIndex(stored, index))
+        {
+            return false;
+        }
+        out.resize(static_cast<size_t>(index.header.rawSize));
+        return Blob::Decode(stored, index, out.data(), nullptr);
+    }
+
+    void TestDecorator(IFileSystem& fs, const std::string& dir, Drama::Core::Job::JobSystem& jobs)
+    {
+        using namespace Drama;
+
+        CompressionDesc desc;
+        desc.blockSize = Blob::kMinBlockSize;
+        desc.jobSystem = &jobs;
+        desc.parallelThreshold = 256 * 1024;
+        desc.filter = [](std::string_view path) { return !path.ends_with(".log"); };
+        CompressedFileSystem cfs(fs, desc);
+
+        const std::vector<uint8_t> data = MakeData(600000, true);
+        const std::string path = dir + "data.bin";
+        Test::Expect(static_cast<bool>(cfs.WriteAllBytesAtomic(path, data.data(), data.size())), "compressed WriteAllBytesAtomic");
+
+        std::vector<uint8_t> stored;
+        fs.ReadAllBytes(path + std::string(Blob::kFileExtension), stored);
+        Test::Expect(Blob::IsBlob(stored) && stored.size() < data.size() / 2, "stored compressed");
+        Test::Expect(fs.Exists(path).error == FsError::NotFound && static_cast<bool>(cfs.Exists(path)), "compressed Exists");
+
+        std::vector<uint8_t> out;
+        Test::Expect(static_cast<bool>(cfs.ReadAllBytes(path, out)) && out == data, "compressed ReadAllBytes");
+        MappedFile mapped;
+        Test::Expect(static_cast<bool>(cfs.MapReadOnly(path, mapped)) &&
+            std::vector<uint8_t>(mapped.Bytes().begin(), mapped.Bytes().end()) == data, "compressed MapReadOnly");
+
+        // ブロック境界をまたぐ範囲読み
+        std::unique_ptr<IFileReader> r;
+        if (Test::Expect(static_cast<bool>(cfs.OpenRead(path, r)), "compressed OpenRead"))
+        {
+            uint8_t buf[64] = {};
+            size_t n = 0;
+            const uint64_t offset = Blob::kMinBlockSize * 3 - 20;
+            Test::Expect(static_cast<bool>(r->ReadAt(offset, buf, sizeof(buf), n)) && n == sizeof(buf) &&
+                std::memcmp(buf, data.data() + offset, sizeof(buf)) == 0, "compressed ReadAt across blocks");
+            std::vector<uint8_t> all(data.size() + 10);
+            Test::Expect(static_cast<bool>(r->Read(all.data(), all.size(), n)) && n == data.size() &&
+                std::memcmp(all.data(), data.data(), n) == 0, "compressed Read whole");
+        }
+
+        // filter で外したパスと、圧縮前に書かれたファイルはそのまま読める
+        const std::string logPath = dir + "raw.log";
+        Test::Expect(static_cast<bool>(cfs.WriteAllBytes(logPath, "plain", 5)), "filtered write");
+        fs.ReadAllBytes(logPath, stored);
+        Test::Expect(stored == std::vector<uint8_t>({ 'p', 'l', 'a', 'i', 'n' }), "filtered stays raw");
+        const std::string loose = dir + "loose.bin";
+        fs.WriteAllBytes(loose, "loose", 5);
+        Test::Expect(static_cast<bool>(cfs.ReadAllBytes(loose, out)) && out.size() == 5, "raw passthrough");
+
+        // 生のファイルが圧縮ファイルと同じ先頭を持っていても展開しない
+        const std::string lookalike = dir + "lookalike.bin";
+        std::vector<uint8_t> fake(stored.begin(), stored.begin() + sizeof(Blob::BlobHeader));
+        fs.WriteAllBytes(lookalike, fake.data(), fake.size());
+        Test::Expect(static_cast<bool>(cfs.ReadAllBytes(lookalike, out)) && out == fake, "raw file with blob magic");
+        std::unique_ptr<IFileReader> rawReader;
+        uint64_t rawSize = 0;
+        Test::Expect(static_cast<bool>(cfs.OpenRead(lookalike, rawReader)) && rawReader->Size(rawSize) && rawSize == fake.size(),
+            "raw file with blob magic (OpenRead)");
+
+        // 書き直すと古い形式の方は消える
+        Test::Expect(static_cast<bool>(cfs.WriteAllBytes(lookalike, data.data(), 1000)) &&
+            fs.Exists(lookalike).error == FsError::NotFound, "compressed write replaces raw");
+        Test::Expect(static_cast<bool>(cfs.Remove(lookalike)) && cfs.Exists(lookalike).error == FsError::NotFound, "compressed Remove");
+
+        // 細かい追記で半端なブロックが増えていかないこと
+        const std::string appended = dir + "appended.bin";
+        const std::vector<uint8_t> chunk = MakeData(1000, true);
+        std::vector<uint8_t> expected;
+        cfs.WriteAllBytes(appended, nullptr, 0);
+        for (int i = 0; i < 100; ++i)
+        {
+            cfs.AppendAllBytes(appended, chunk.data(), chunk.size());
+            expected.insert(expected.end(), chunk.begin(), chunk.end());
+        }
+        Test::Expect(static_cast<bool>(cfs.ReadAllBytes(appended, out)) && out == expected, "compressed append content");
+        Blob::BlobIndex index;
+        const std::string appendedStored = appended + std::string(Blob::kFileExtension);
+        fs.ReadAllBytes(appendedStored, stored);
+        Test::Expect(Blob::ReadIndex(stored, index) && index.blocks.size() == 2, "append merges tail block");
+
+        // 作り直した末尾ブロックの残骸は詰め直されて溜まり続けない(圧縮の効かない内容で残骸を大きくする)
+        const std::string noisy = dir + "noisy.bin";
+        const std::vector<uint8_t> noise = MakeData(100 * chunk.size(), false);
+        cfs.Remove(noisy);
+        for (size_t i = 0; i < noise.size(); i += chunk.size())
+        {
+            cfs.AppendAllBytes(noisy, noise.data() + i, chunk.size());
+        }
+        std::vector<uint8_t> noisyStored;
+        fs.ReadAllBytes(noisy + std::string(Blob::kFileExtension), noisyStored);
+        Test::Expect(static_cast<bool>(cfs.ReadAllBytes(noisy, out)) && out == noise, "noisy append content");
+        Test::Expect(noisyStored.size() < noise.size() * 4, "append garbage is compacted");
+
+        // 追記の途中(ヘッダを書き換える前)で落ちても、前回確定した内容が読める
+        {
+            std::unique_ptr<IFileWriter> w;
+            if (Test::Expect(static_cast<bool>(cfs.OpenWrite(appended, FileWriteMode::Append, w)), "compressed OpenWrite(Append)"))
+            {
+                const std::vector<uint8_t> more = MakeData(Blob::kMinBlockSize * 2, true);
+                w->Write(more.data(), more.size());
+                std::vector<uint8_t> snapshot;
+                fs.ReadAllBytes(appendedStored, snapshot);
+                Test::Expect(DecodeStored(snapshot, out) && out == expected, "append in progress keeps committed content");
+                Test::Expect(static_cast<bool>(w->Flush()), "compressed Flush");
+                expected.insert(expected.end(), more.begin(), more.end());
+                fs.ReadAllBytes(appendedStored, snapshot);
+                Test::Expect(DecodeStored(snapshot, out) && out == expected, "flushed append is committed");
+            }
+        }
+
+        // 壊れた圧縮ファイルはエラーになる
+        stored = std::vector<uint8_t>(stored.begin(), stored.begin() + stored.size() / 2);
+        fs.WriteAllBytes(appendedStored, stored.data(), stored.size());
+        Test::Expect(cfs.ReadAllBytes(appended, out).error == FsError::IoError && out.empty(), "corrupt compressed file");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunCompressionTests(Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        const std::string dir = root + "compression/";
+        fs.CreateDirectories(dir);
+
+        TestCodec();
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc jobDesc;
+        jobDesc.threadCount = 4;
+        if (Expect(jobs.Start(jobDesc), "compression JobSystem::Start"))
+        {
+            TestBlob(jobs);
+            TestDecorator(fs, dir, jobs);
+            jobs.Stop();
+        }
+
+        // 圧縮を挟んでも IFileSystem としての振る舞いは変わらないこと
+        Core::IO::CompressedFileSystem compressed(fs);
+        RunFileSystemConformanceTests(compressed, dir + "conformance_");
+    }
+}
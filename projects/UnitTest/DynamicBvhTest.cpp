@@ -0,0 +1,326 @@
+#include "TestCommon.h"
+
+#include "Core/include/DynamicBvh.h"
+#include "Core/include/JobSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::Math;
+    using namespace Drama::Core::Scene;
+
+    Aabb Box(Float3 center, Float3 extent) noexcept
+    {
+        return Aabb{ center - extent, center + extent };
+    }
+
+    /// @brief 総当たりの光線判定(当たらなければ負)
+    float RayBox(const Ray& ray, const Aabb& box) noexcept
+    {
+        float tEnter = 0.0f;
+        float tExit = ray.maxT;
+        const float o[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+        const float d[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+        const float lo[3] = { box.min.x, box.min.y, box.min.z };
+        const float hi[3] = { box.max.x, box.max.y, box.max.z };
+        for (int a = 0; a < 3; ++a)
+        {
+            const float t0 = (lo[a] - o[a]) / d[a];
+            const float t1 = (hi[a] - o[a]) / d[a];
+            tEnter = std::max(tEnter, std::min(t0, t1));
+            tExit = std::min(tExit, std::max(t0, t1));
+        }
+        return tEnter <= tExit ? tEnter : -1.0f;
+    }
+
+    float DistanceSq(Float3 p, const Aabb& box) noexcept
+    {
+        const float dx = std::max({ box.min.x - p.x, p.x - box.max.x, 0.0f });
+        const float dy = std::max({ box.min.y - p.y, p.y - box.max.y, 0.0f });
+        const float dz = std::max({ box.min.z - p.z, p.z - box.max.z, 0.0f });
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    bool Near(float a, float b) noexcept
+    {
+        return std::fabs(a - b) <= 1e-3f * std::max(1.0f, std::fabs(b));
+    }
+
+    /// @brief userData i の物の箱を boxes[i] に持つ場面
+    struct World
+    {
+        DynamicAabbTree tree;
+        std::vector<BvhProxy> proxies;
+        std::vector<Aabb> boxes;
+        std::vector<bool> alive;
+    };
+
+    std::vector<uint32_t> QueryTree(const DynamicAabbTree& tree, const Aabb& box)
+    {
+        std::vector<uint32_t> found;
+        tree.QueryOverlap(box, [&](uint32_t userData, BvhProxy) { found.push_back(userData); return true; });
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    /// @brief 太らせた箱で判定するので、実際の箱で重なるものは必ず含み、太らせた箱で重ならないものは含まない
+    bool QueryMatches(const World& s, const Aabb& query)
+    {
+        const std::vector<uint32_t> found = QueryTree(s.tree, query);
+        for (uint32_t i = 0; i < s.boxes.size(); ++i)
+        {
+            if (!s.alive[i])
+            {
+                if (std::binary_search(found.begin(), found.end(), i))
+                {
+                    return false;
+                }
+                continue;
+            }
+            const bool inFound = std::binary_search(found.begin(), found.end(), i);
+            if (Overlaps(s.boxes[i], query) && !inFound)
+            {
+                return false;
+            }
+            if (inFound && !Overlaps(*s.tree.FatBounds(s.proxies[i]), query))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestBasics()
+    {
+        using namespace Drama;
+
+        DynamicAabbTree tree(DynamicAabbTreeDesc{ 0.5f });
+        Test::Expect(tree.Validate() && tree.Height() == 0 && tree.LeafCount() == 0, "empty tree");
+        const BvhProxy a = tree.Create(Box(Float3{ 0, 0, 0 }, Float3{ 1, 1, 1 }), 10);
+        const BvhProxy b = tree.Create(Box(Float3{ 5, 0, 0 }, Float3{ 1, 1, 1 }), 11);
+        const BvhProxy c = tree.Create(Box(Float3{ 0, 5, 0 }, Float3{ 1, 1, 1 }), 12);
+        Test::Expect(a.IsValid() && tree.LeafCount() == 3 && tree.Height() == 2 && tree.Validate(), "three leaves");
+        Test::Expect(tree.UserData(b) == 11 && tree.Bounds(c)->min.y == 4.0f && tree.FatBounds(c)->min.y == 3.5f, "bounds and fat bounds");
+
+        // 太らせた箱の中なら入れ直さない
+        Test::Expect(!tree.Move(a, Box(Float3{ 0.3f, 0, 0 }, Float3{ 1, 1, 1 })) && tree.Bounds(a)->min.x == -0.7f, "move within margin keeps the leaf");
+        Test::Expect(tree.Move(a, Box(Float3{ 3, 3, 0 }, Float3{ 1, 1, 1 })) && tree.Validate(), "move outside margin reinserts");
+        Test::Expect(QueryTree(tree, Box(Float3{ 3, 3, 0 }, Float3{ 0.1f, 0.1f, 0.1f })) == std::vector<uint32_t>{ 10 }, "query finds the moved leaf");
+
+        Test::Expect(tree.Destroy(b) && !tree.IsAlive(b) && !tree.Destroy(b) && tree.Validate(), "destroy");
+        Test::Expect(tree.Bounds(b) == nullptr && tree.UserData(b) == UINT32_MAX && !tree.Move(b, {}) && !tree.SetBounds(b, {}), "stale handle is rejected");
+        // 空いた番号を使い回しても古いハンドルは無効のまま
+        const BvhProxy d = tree.Create(Box(Float3{ 9, 9, 9 }, Float3{ 1, 1, 1 }), 13);
+        Test::Expect(tree.IsAlive(d) && !tree.IsAlive(b) && !tree.IsAlive(BvhProxy{}), "recycled index has a new generation");
+
+        tree.Clear();
+        Test::Expect(tree.LeafCount() == 0 && !tree.IsAlive(a) && !tree.IsAlive(d) && tree.Validate(), "clear");
+        Test::Expect(tree.Destroy(tree.Create(Box(Float3{}, Float3{ 1, 1, 1 }), 0)) && tree.Validate(), "last leaf removes the root");
+    }
+
+    /// @brief 出し入れ、移動、まとめた箱の変更を繰り返し、形と問い合わせを総当たりと比べる
+    void TestRandomEdits()
+    {
+        using namespace Drama;
+
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.2f, 3.0f);
+        std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+        World s;
+        auto randomBox = [&]() { return Box(Float3{ pos(rng), pos(rng), pos(rng) }, Float3{ size(rng), size(rng), size(rng) }); };
+        for (uint32_t i = 0; i < 2000; ++i)
+        {
+            s.boxes.push_back(randomBox());
+            s.proxies.push_back(s.tree.Create(s.boxes.back(), i));
+            s.alive.push_back(true);
+        }
+        bool valid = s.tree.Validate();
+        bool queries = true;
+        for (int round = 0; round < 20; ++round)
+        {
+            for (uint32_t i = 0; i < s.boxes.size(); ++i)
+            {
+                const uint32_t r = rng() % 10;
+                if (!s.alive[i])
+                {
+                    if (r == 0)
+                    {
+                        s.boxes[i] = randomBox();
+                        s.proxies[i] = s.tree.Create(s.boxes[i], i);
+                        s.alive[i] = true;
+                    }
+                    continue;
+                }
+                if (r == 0)
+                {
+                    s.tree.Destroy(s.proxies[i]);
+                    s.alive[i] = false;
+                }
+                else if (r < 6)
+                {
+                    const Float3 delta{ step(rng), step(rng), step(rng) };
+                    s.boxes[i] = Aabb{ s.boxes[i].min + delta, s.boxes[i].max + delta };
+                    s.tree.Move(s.proxies[i], s.boxes[i]);
+                }
+            }
+            valid = valid && s.tree.Validate();
+
+            // 半分ほどをまとめて動かし、Refit で直す(奇数回は回転なし)
+            for (uint32_t i = 0; i < s.boxes.size(); i += 2)
+            {
+                if (s.alive[i])
+                {
+                    const Float3 delta{ step(rng), step(rng), step(rng) };
+                    s.boxes[i] = Aabb{ s.boxes[i].min + delta, s.boxes[i].max + delta };
+                    s.tree.SetBounds(s.proxies[i], s.boxes[i]);
+                }
+            }
+            s.tree.Refit(round % 2 == 0);
+            valid = valid && s.tree.Validate();
+            for (int q = 0; q < 20; ++q)
+            {
+                queries = queries && QueryMatches(s, Box(Float3{ pos(rng), pos(rng), pos(rng) }, Float3{ 10, 10, 10 }));
+            }
+        }
+        Test::Expect(valid, "tree stays valid through random edits");
+        Test::Expect(queries, "overlap queries match brute force");
+        Test::Expect(s.tree.LeafCount() == static_cast<uint32_t>(std::count(s.alive.begin(), s.alive.end(), true)), "leaf count");
+
+        // 作り直しても形は正しく、ハンドルもそのまま使える
+        const float ratio = s.tree.AreaRatio();
+        s.tree.Rebuild();
+        bool handles = true;
+        for (uint32_t i = 0; i < s.boxes.size(); ++i)
+        {
+            handles = handles && s.tree.IsAlive(s.proxies[i]) == s.alive[i] && (!s.alive[i] || s.tree.UserData(s.proxies[i]) == i);
+        }
+        Test::Expect(s.tree.Validate() && handles, "rebuild keeps handles");
+        Test::Expect(s.tree.AreaRatio() > 0.0f && s.tree.AreaRatio() < ratio * 1.5f, "rebuilt tree is not worse than the incremental one");
+        Test::Expect(QueryMatches(s, Box(Float3{}, Float3{ 50, 50, 50 })), "query after rebuild");
+        const uint32_t i = static_cast<uint32_t>(std::find(s.alive.begin(), s.alive.end(), true) - s.alive.begin());
+        Test::Expect(s.tree.Destroy(s.proxies[i]) && s.tree.Validate(), "edit after rebuild");
+    }
+
+    void TestWideQueries()
+    {
+        using namespace Drama;
+
+        std::mt19937 rng(34);
+        std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.2f, 4.0f);
+        std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+        DynamicAabbTree tree;
+        std::vector<Aabb> boxes;
+        for (uint32_t i = 0; i < 3000; ++i)
+        {
+            boxes.push_back(Box(Float3{ pos(rng), pos(rng), pos(rng) }, Float3{ size(rng), size(rng), size(rng) }));
+            tree.Create(boxes.back(), i);
+        }
+        WideBvh bvh;
+        bvh.Build(tree);
+        Test::Expect(bvh.LeafCount() == 3000 && bvh.NodeCount() < 3000 && bvh.Depth() > 1, "wide bvh has four-wide nodes");
+
+        std::vector<Ray> rays;
+        std::vector<Float3> points;
+        std::vector<Aabb> queries;
+        for (int q = 0; q < 500; ++q)
+        {
+            Ray ray{};
+            ray.origin = Float3{ pos(rng), pos(rng), pos(rng) };
+            ray.direction = Float3{ dir(rng), dir(rng), dir(rng) };
+            ray.maxT = q % 4 == 0 ? 20.0f : 3.4e38f;
+            rays.push_back(ray);
+            points.push_back(Float3{ pos(rng) * 1.5f, pos(rng), pos(rng) });
+            queries.push_back(Box(Float3{ pos(rng), pos(rng), pos(rng) }, Float3{ 8, 8, 8 }));
+        }
+
+        bool raysOk = true;
+        bool nearestOk = true;
+        bool overlapOk = true;
+        uint32_t rayHits = 0;
+        for (size_t q = 0; q < rays.size(); ++q)
+        {
+            float bestT = -1.0f;
+            float bestD = INFINITY;
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < boxes.size(); ++i)
+            {
+                const float t = RayBox(rays[q], boxes[i]);
+                bestT = t >= 0.0f && (bestT < 0.0f || t < bestT) ? t : bestT;
+                bestD = std::min(bestD, DistanceSq(points[q], boxes[i]));
+                if (Overlaps(boxes[i], queries[q]))
+                {
+                    expected.push_back(i);
+                }
+            }
+            const RayHit hit = bvh.Raycast(rays[q]);
+            raysOk = raysOk && hit.IsHit() == (bestT >= 0.0f) && (!hit.IsHit() || (Near(hit.t, bestT) && Near(RayBox(rays[q], boxes[hit.item]), bestT)));
+            rayHits += hit.IsHit() ? 1 : 0;
+
+            const NearestHit nearest = bvh.Nearest(points[q]);
+            nearestOk = nearestOk && nearest.IsHit() && Near(nearest.distanceSq, bestD) && Near(DistanceSq(points[q], boxes[nearest.item]), bestD);
+            const NearestHit limited = bvh.Nearest(points[q], std::sqrt(bestD) * 0.5f);
+            nearestOk = nearestOk && (bestD == 0.0f || !limited.IsHit());
+
+            std::vector<uint32_t> got;
+            Test::Expect(bvh.Overlap(queries[q], got) == got.size(), "overlap returns the added count");
+            std::sort(got.begin(), got.end());
+            overlapOk = overlapOk && got == expected;
+        }
+        Test::Expect(raysOk && rayHits > 0 && rayHits < rays.size(), "raycast matches brute force");
+        Test::Expect(nearestOk, "nearest matches brute force");
+        Test::Expect(overlapOk, "overlap matches brute force");
+
+        // まとめた問い合わせは1つずつの結果と同じ
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc desc{};
+        desc.threadCount = 4;
+        Test::Expect(jobs.Start(desc), "job system starts");
+        std::vector<RayHit> rayHitsBatch(rays.size());
+        std::vector<NearestHit> nearestBatch(points.size());
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> items;
+        bvh.RaycastBatch(rays, rayHitsBatch, &jobs);
+        bvh.NearestBatch(points, 30.0f, nearestBatch, &jobs);
+        bvh.OverlapBatch(queries, offsets, items, &jobs);
+        jobs.Stop();
+        bool batchOk = offsets.size() == queries.size() + 1 && offsets.back() == items.size();
+        for (size_t q = 0; batchOk && q < rays.size(); ++q)
+        {
+            const RayHit r = bvh.Raycast(rays[q]);
+            const NearestHit n = bvh.Nearest(points[q], 30.0f);
+            std::vector<uint32_t> o;
+            bvh.Overlap(queries[q], o);
+            batchOk = r.item == rayHitsBatch[q].item && r.t == rayHitsBatch[q].t && n.item == nearestBatch[q].item &&
+                std::equal(o.begin(), o.end(), items.begin() + offsets[q], items.begin() + offsets[q + 1]);
+        }
+        Test::Expect(batchOk, "batch queries match single queries");
+
+        // 1つだけ / 空
+        DynamicAabbTree single;
+        single.Create(Box(Float3{ 0, 0, 5 }, Float3{ 1, 1, 1 }), 7);
+        bvh.Build(single);
+        const RayHit one = bvh.Raycast(Ray{ Float3{}, Float3{ 0.01f, 0.01f, 1.0f } });
+        Test::Expect(bvh.NodeCount() == 1 && one.item == 7 && Near(one.t, 4.0f), "single leaf tree");
+        bvh.Build(DynamicAabbTree{});
+        std::vector<uint32_t> none;
+        Test::Expect(!bvh.Raycast(Ray{ Float3{}, Float3{ 0, 0, 1 } }).IsHit() && !bvh.Nearest(Float3{}).IsHit() && bvh.Overlap(Aabb{}, none) == 0,
+            "empty wide bvh");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunDynamicBvhTests()
+    {
+        TestBasics();
+        TestRandomEdits();
+        TestWideQueries();
+    }
+}
@@ -0,0 +1,243 @@
+#include "TestCommon.h"
+
+#include "Core/include/Ecs.h"
+#include "Core/include/SystemScheduler.h"
+
+// C++ standard library includes
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Drama::Core::Ecs::CommandBuffer;
+    using Drama::Core::Ecs::ComponentAccess;
+    using Drama::Core::Ecs::Entity;
+    using Drama::Core::Ecs::SystemContext;
+    using Drama::Core::Ecs::SystemScheduler;
+    using Drama::Core::Ecs::World;
+
+    struct Position
+    {
+        float x, y, z;
+    };
+    struct Velocity
+    {
+        float x, y, z;
+    };
+    struct Health
+    {
+        int value;
+    };
+    /// @brief 破棄が要るコンポーネント(移動と破棄の回数を確かめる)
+    struct Name
+    {
+        static inline std::atomic<int> s_Alive{ 0 };
+        explicit Name(std::string v) : value(std::move(v)) { s_Alive.fetch_add(1); }
+        Name(Name&& other) noexcept : value(std::move(other.value)) { s_Alive.fetch_add(1); }
+        Name& operator=(Name&& other) noexcept
+        {
+            value = std::move(other.value);
+            return *this;
+        }
+        ~Name() { s_Alive.fetch_sub(1); }
+        std::string value;
+    };
+
+    void TestCreateAndQuery()
+    {
+        using namespace Drama;
+
+        World world;
+        std::vector<Entity> moving;
+        for (int i = 0; i < 1000; ++i)
+        {
+            moving.push_back(world.Create(Position{ float(i), 0, 0 }, Velocity{ 1, 2, 3 }));
+        }
+        const Entity still = world.Create(Position{ -1, -1, -1 });
+        Test::Expect(world.EntityCount() == 1001 && world.ArchetypeCount() == 2, "create places entities by archetype");
+
+        // チャンクごとに連続した span が渡る
+        size_t visited = 0;
+        bool contiguous = true;
+        world.ForEachChunk<Position, const Velocity>([&](std::span<const Entity> entities, std::span<Position> p, std::span<const Velocity> v)
+            {
+                contiguous = contiguous && entities.size() == p.size() && p.size() == v.size() &&
+                    (reinterpret_cast<uintptr_t>(p.data()) & 63) == 0;
+                for (size_t i = 0; i < p.size(); ++i)
+                {
+                    p[i].x += v[i].x;
+                }
+                visited += p.size();
+            });
+        Test::Expect(visited == 1000 && contiguous, "query visits matching chunks as aligned spans");
+        Test::Expect(world.Get<Position>(moving[10])->x == 11.0f && world.Get<Position>(still)->x == -1.0f, "query writes land");
+
+        size_t all = 0;
+        world.ForEach<const Position>([&](Entity e, const Position&) { all += world.IsAlive(e) ? 1 : 0; });
+        Test::Expect(all == 1001, "ForEach passes the entity when asked");
+        Test::Expect(!world.Has<Velocity>(still) && world.Get<Health>(still) == nullptr, "missing components are null");
+    }
+
+    void TestStructuralChanges()
+    {
+        using namespace Drama;
+
+        World world;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 2000; ++i)
+        {
+            entities.push_back(world.Create(Position{ float(i), 0, 0 }, Name{ std::to_string(i) }));
+        }
+        Test::Expect(Name::s_Alive.load() == 2000, "components constructed in place");
+
+        // 途中を破棄しても、詰め替えられた他のエンティティは値を保つ
+        for (int i = 0; i < 2000; i += 2)
+        {
+            world.Destroy(entities[i]);
+        }
+        Test::Expect(world.EntityCount() == 1000 && Name::s_Alive.load() == 1000, "destroy releases components");
+        Test::Expect(!world.IsAlive(entities[0]) && !world.Destroy(entities[0]), "stale handle is rejected");
+        bool intact = true;
+        for (int i = 1; i < 2000; i += 2)
+        {
+            intact = intact && world.Get<Position>(entities[i])->x == float(i) && world.Get<Name>(entities[i])->value == std::to_string(i);
+        }
+        Test::Expect(intact, "swap-remove keeps records in sync");
+
+        // 型の追加と削除でアーキタイプを移っても値は残る
+        const Entity e = entities[1];
+        Test::Expect(world.Add(e, Health{ 5 }) && world.Get<Health>(e)->value == 5 && world.Get<Name>(e)->value == "1", "add moves the entity");
+        Test::Expect(world.Add(e, Health{ 7 }) && world.Get<Health>(e)->value == 7, "add replaces an existing value");
+        const Health lvalue{ 9 };
+        Test::Expect(world.Add(e, lvalue) && world.Get<Health>(e)->value == 9, "lvalues map to the same component type");
+        Test::Expect(world.Remove<Name>(e) && !world.Has<Name>(e) && world.Get<Position>(e)->x == 1.0f, "remove drops only that type");
+        Test::Expect(Name::s_Alive.load() == 999 && !world.Remove<Name>(e), "removed component is destroyed");
+
+        // 番号は使い回しても世代で区別される
+        const Entity reused = world.Create(Position{});
+        Test::Expect(reused.index == entities[1998].index && reused.generation == entities[1998].generation + 1, "indices are recycled with a new generation");
+
+        world.Clear();
+        Test::Expect(world.EntityCount() == 0 && Name::s_Alive.load() == 0 && world.ChunkCount() == 0, "clear destroys everything");
+    }
+
+    void TestCommandBuffer()
+    {
+        using namespace Drama;
+
+        World world;
+        CommandBuffer commands;
+        const Entity a = world.Create(Position{ 1, 0, 0 });
+        const Entity b = world.Create(Position{ 2, 0, 0 });
+        // 回している最中の変更はバッファに積む
+        world.ForEach<Position>([&](Entity e, Position& p)
+            {
+                if (p.x == 1.0f)
+                {
+                    commands.Add(e, Name{ "a" });
+                }
+                else
+                {
+                    commands.Destroy(e);
+                }
+                commands.Create(Position{ p.x * 10, 0, 0 }, Velocity{});
+            });
+        Test::Expect(world.EntityCount() == 2 && commands.Size() == 4, "commands are deferred");
+        world.Playback(commands);
+        Test::Expect(commands.Empty() && world.EntityCount() == 3, "playback applies in order");
+        Test::Expect(world.Get<Name>(a)->value == "a" && !world.IsAlive(b), "add and destroy applied");
+        size_t created = 0;
+        world.ForEach<const Position, const Velocity>([&](const Position& p, const Velocity&) { created += (p.x == 10.0f || p.x == 20.0f) ? 1 : 0; });
+        Test::Expect(created == 2, "deferred create carries components");
+
+        // 破棄済みへの変更は捨て、積んだ値は破棄される
+        commands.Add(b, Name{ "dead" });
+        commands.Remove<Name>(a);
+        world.Playback(commands);
+        Test::Expect(Name::s_Alive.load() == 0 && !world.Has<Name>(a), "commands on dead entities are dropped");
+
+        commands.Create(Name{ "never" });
+        commands.Clear();
+        Test::Expect(Name::s_Alive.load() == 0, "clear destroys pending values");
+    }
+
+    void TestParallel()
+    {
+        using namespace Drama;
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc desc{};
+        desc.threadCount = 4;
+        Test::Expect(jobs.Start(desc), "job system starts");
+
+        World world;
+        for (int i = 0; i < 50000; ++i)
+        {
+            world.Create(Position{ 0, 0, 0 }, Velocity{ 1, 0, 0 }, Health{ 100 });
+        }
+        world.ParallelForEachChunk<Position, const Velocity>(jobs, [](std::span<const Entity>, std::span<Position> p, std::span<const Velocity> v)
+            {
+                for (size_t i = 0; i < p.size(); ++i)
+                {
+                    p[i].x += v[i].x;
+                }
+            });
+        float sum = 0.0f;
+        world.ForEach<const Position>([&](const Position& p) { sum += p.x; });
+        Test::Expect(sum == 50000.0f, "parallel chunk query");
+
+        // 読み書きが重ならないシステムは同じ段、重なるものは後ろの段へ
+        SystemScheduler scheduler;
+        std::atomic<int> order{ 0 };
+        int moveOrder = -1;
+        int readOrder = -1;
+        const uint32_t move = scheduler.AddSystem("Move", ComponentAccess::Of<Position, const Velocity>(), [&](SystemContext& ctx)
+            {
+                ctx.world.ParallelForEachChunk<Position, const Velocity>(ctx.jobs, [&](std::span<const Entity>, std::span<Position> p, std::span<const Velocity> v)
+                    {
+                        for (size_t i = 0; i < p.size(); ++i)
+                        {
+                            p[i].x += v[i].x * static_cast<float>(ctx.deltaSeconds);
+                        }
+                    });
+                moveOrder = order.fetch_add(1);
+            });
+        const uint32_t damage = scheduler.AddSystem("Damage", ComponentAccess::Of<Health>(), [&](SystemContext& ctx)
+            {
+                ctx.world.ForEach<Health>([&](Entity e, Health& h)
+                    {
+                        if (--h.value < 100 && e.index % 1000 == 0)
+                        {
+                            ctx.commands.Destroy(e);
+                        }
+                    });
+            });
+        const uint32_t read = scheduler.AddSystem("Read", ComponentAccess::Of<const Position>(), [&](SystemContext& ctx)
+            {
+                size_t n = 0;
+                ctx.world.ForEach<const Position>([&](const Position&) { ++n; });
+                readOrder = order.fetch_add(1);
+            });
+        Test::Expect(scheduler.PhaseOf(move) == 0 && scheduler.PhaseOf(damage) == 0 && scheduler.PhaseOf(read) == 1, "phases follow access");
+        scheduler.Run(world, jobs, 2.0);
+        Test::Expect(moveOrder == 0 && readOrder == 1, "conflicting systems keep registration order");
+        Test::Expect(world.EntityCount() == 50000 - 50, "system commands are played back");
+        sum = 0.0f;
+        world.ForEach<const Position>([&](const Position& p) { sum += p.x; });
+        Test::Expect(sum == 49950.0f * 3.0f, "systems ran once");
+
+        jobs.Stop();
+    }
+}
+
+namespace Drama::Test
+{
+    void RunEcsTests()
+    {
+        TestCreateAndQuery();
+        TestStructuralChanges();
+        TestCommandBuffer();
+        TestParallel();
+    }
+}
@@ -0,0 +1,361 @@
+#include "TestCommon.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// どの IFileSystem 実装でも同じ結果になるべき振る舞いだけを検査する。
+// エラーの細かい分類(IoError か AccessDenied か等)は実装差があるので、
+// 呼び出し側が分岐に使う NotFound / InvalidPath だけを固定する。
+namespace
+{
+    using Drama::Core::IO::FsError;
+    using Drama::Core::IO::FsResult;
+    using Drama::Core::IO::IFileSystem;
+
+    std::vector<uint8_t> Bytes(std::string_view s)
+    {
+        return std::vector<uint8_t>(s.begin(), s.end());
+    }
+
+    std::vector<uint8_t> Read(IFileSystem& fs, const std::string& path)
+    {
+        std::vector<uint8_t> out;
+        fs.ReadAllBytes(path, out);
+        return out;
+    }
+
+    void TestEmptyPath(IFileSystem& fs)
+    {
+        using namespace Drama;
+
+        std::vector<uint8_t> out;
+        Test::Expect(fs.Exists("").error == FsError::InvalidPath, "Exists(empty)");
+        Test::Expect(fs.CreateDirectories("").error == FsError::InvalidPath, "CreateDirectories(empty)");
+        Test::Expect(fs.WriteAllBytes("", "x", 1).error == FsError::InvalidPath, "WriteAllBytes(empty)");
+        Test::Expect(fs.ReadAllBytes("", out).error == FsError::InvalidPath, "ReadAllBytes(empty)");
+        Test::Expect(fs.AppendAllBytes("", "x", 1).error == FsError::InvalidPath, "AppendAllBytes(empty)");
+        Test::Expect(fs.WriteAllBytesAtomic("", "x", 1).error == FsError::InvalidPath, "WriteAllBytesAtomic(empty)");
+        Test::Expect(fs.Remove("").error == FsError::InvalidPath, "Remove(empty)");
+        uint64_t size = 0;
+        Test::Expect(fs.FileSize("", size).error == FsError::InvalidPath, "FileSize(empty)");
+    }
+
+    void TestDirectories(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string dir = root + "nested/a/b/";
+        Test::Expect(static_cast<bool>(fs.CreateDirectories(dir)), "CreateDirectories(nested)");
+        Test::Expect(static_cast<bool>(fs.Exists(dir)), "Exists(created dir)");
+        // 既にあっても成功
+        Test::Expect(static_cast<bool>(fs.CreateDirectories(dir)), "CreateDirectories(again)");
+
+        Test::Expect(fs.Exists(root + "nested/missing").error == FsError::NotFound, "Exists(missing)");
+    }
+
+    void TestWriteRead(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "write.bin";
+        Test::Expect(static_cast<bool>(fs.WriteAllBytes(path, "hello world", 11)), "WriteAllBytes");
+        Test::Expect(static_cast<bool>(fs.Exists(path)), "Exists(written)");
+        Test::Expect(Read(fs, path) == Bytes("hello world"), "ReadAllBytes content");
+
+        // 短い内容で上書きすると切り詰められる
+        Test::Expect(static_cast<bool>(fs.WriteAllBytes(path, "bye", 3)), "WriteAllBytes(overwrite)");
+        Test::Expect(Read(fs, path) == Bytes("bye"), "overwrite truncates");
+
+        Test::Expect(static_cast<bool>(fs.WriteAllBytes(path, nullptr, 0)), "WriteAllBytes(zero)");
+        std::vector<uint8_t> out(4, 0xCC);
+        Test::Expect(static_cast<bool>(fs.ReadAllBytes(path, out)) && out.empty(), "ReadAllBytes(zero)");
+
+        Test::Expect(!fs.WriteAllBytes(path, nullptr, 4), "WriteAllBytes(null data)");
+
+        std::vector<uint8_t> missing(4, 0xCC);
+        Test::Expect(fs.ReadAllBytes(root + "missing.bin", missing).error == FsError::NotFound, "ReadAllBytes(missing)");
+        Test::Expect(missing.empty(), "ReadAllBytes(missing) clears out");
+
+        Test::Expect(!fs.WriteAllBytes(root + "no_such_dir/file.bin", "x", 1), "WriteAllBytes(missing dir)");
+    }
+
+    void TestLargeFile(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        // 1回のread/writeで終わらない可能性がある大きさ
+        std::vector<uint8_t> data(3 * 1024 * 1024 + 17);
+        uint32_t x = 2463534242u;
+        for (uint8_t& b : data)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            b = static_cast<uint8_t>(x);
+        }
+
+        const std::string path = root + "large.bin";
+        Test::Expect(static_cast<bool>(fs.WriteAllBytes(path, data.data(), data.size())), "WriteAllBytes(large)");
+        Test::Expect(Read(fs, path) == data, "ReadAllBytes(large)");
+
+        Core::IO::MappedFile mapped;
+        Test::Expect(static_cast<bool>(fs.MapReadOnly(path, mapped)), "MapReadOnly(large)");
+        Test::Expect(mapped.Size() == data.size() &&
+            std::equal(data.begin(), data.end(), mapped.Bytes().begin()), "MapReadOnly(large) content");
+
+        const std::string copy = root + "large_copy.bin";
+        Test::Expect(static_cast<bool>(fs.CopyAllBytes(path, copy)), "CopyAllBytes(large)");
+        Test::Expect(Read(fs, copy) == data, "CopyAllBytes content");
+    }
+
+    void TestMap(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "map.bin";
+        fs.WriteAllBytes(path, "mapped bytes", 12);
+
+        Core::IO::MappedFile a;
+        Test::Expect(static_cast<bool>(fs.MapReadOnly(path, a)), "MapReadOnly");
+        Test::Expect(std::vector<uint8_t>(a.Bytes().begin(), a.Bytes().end()) == Bytes("mapped bytes"), "MapReadOnly content");
+
+        // ムーブしても同じ内容を指し、元は空になる
+        const uint8_t* data = a.Data();
+        Core::IO::MappedFile b = std::move(a);
+        Test::Expect(b.Data() == data && b.Size() == 12, "MappedFile move keeps view");
+        Test::Expect(a.IsEmpty() && a.Data() == nullptr, "MappedFile moved-from is empty");
+
+        // 空ファイルはマップできない実装でも空の結果で成功する
+        const std::string empty = root + "map_empty.bin";
+        fs.WriteAllBytes(empty, nullptr, 0);
+        Test::Expect(static_cast<bool>(fs.MapReadOnly(empty, b)) && b.IsEmpty(), "MapReadOnly(empty)");
+
+        Core::IO::MappedFile missing;
+        Test::Expect(fs.MapReadOnly(root + "missing.bin", missing).error == FsError::NotFound, "MapReadOnly(missing)");
+        Test::Expect(missing.IsEmpty(), "MapReadOnly(missing) leaves empty");
+    }
+
+    void TestAppend(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "append.txt";
+        fs.WriteAllBytes(path, nullptr, 0);
+        Test::Expect(static_cast<bool>(fs.AppendAllBytes(path, "ab", 2)), "AppendAllBytes(1)");
+        Test::Expect(static_cast<bool>(fs.AppendAllBytes(path, "cd", 2)), "AppendAllBytes(2)");
+        Test::Expect(static_cast<bool>(fs.AppendAllBytes(path, nullptr, 0)), "AppendAllBytes(zero)");
+        Test::Expect(Read(fs, path) == Bytes("abcd"), "AppendAllBytes content");
+
+        // 無ければ作る
+        const std::string created = root + "append_new.txt";
+        fs.WriteAllBytes(created, nullptr, 0);
+        Test::Expect(static_cast<bool>(fs.AppendAllBytes(created, "z", 1)), "AppendAllBytes(create)");
+        Test::Expect(Read(fs, created) == Bytes("z"), "AppendAllBytes(create) content");
+    }
+
+    void TestAtomic(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "atomic.cfg";
+        Test::Expect(static_cast<bool>(fs.WriteAllBytesAtomic(path, "first", 5)), "WriteAllBytesAtomic(new)");
+        Test::Expect(static_cast<bool>(fs.WriteAllBytesAtomic(path, "2nd", 3)), "WriteAllBytesAtomic(replace)");
+        Test::Expect(Read(fs, path) == Bytes("2nd"), "WriteAllBytesAtomic content");
+        Test::Expect(fs.Exists(path + ".tmp").error == FsError::NotFound, "WriteAllBytesAtomic leaves no tmp");
+
+        Test::Expect(!fs.WriteAllBytesAtomic(root + "no_such_dir/atomic.cfg", "x", 1), "WriteAllBytesAtomic(missing dir)");
+    }
+
+    void TestStreams(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+        using Core::IO::FileWriteMode;
+        using Core::IO::IFileReader;
+        using Core::IO::IFileWriter;
+        using Core::IO::WriteSlice;
+
+        const std::string path = root + "stream.bin";
+        {
+            std::unique_ptr<IFileWriter> w;
+            Test::Expect(static_cast<bool>(fs.OpenWrite(path, FileWriteMode::Truncate, w)) && w, "OpenWrite");
+            Test::Expect(static_cast<bool>(w->Write("HDR?", 4)), "Write");
+            const WriteSlice slices[] = { { "abc", 3 }, { nullptr, 0 }, { "defg", 4 } };
+            Test::Expect(static_cast<bool>(w->WriteV(slices)), "WriteV");
+            Test::Expect(w->Tell() == 11, "Tell after writes");
+            // ヘッダの後書きは現在位置を変えない
+            Test::Expect(static_cast<bool>(w->WriteAt(3, "!", 1)) && w->Tell() == 11, "WriteAt");
+            uint64_t size = 0;
+            Test::Expect(static_cast<bool>(w->Size(size)) && size == 11, "writer Size");
+            Test::Expect(static_cast<bool>(w->Flush()), "Flush");
+        }
+        Test::Expect(Read(fs, path) == Bytes("HDR!abcdefg"), "stream content");
+
+        {
+            std::unique_ptr<IFileWriter> w;
+            Test::Expect(static_cast<bool>(fs.OpenWrite(path, FileWriteMode::Append, w)) && w->Tell() == 11, "OpenWrite(append)");
+            w->Write("XY", 2);
+            // 閉じた時点で書き終わっている。閉じた後は書けず、もう一度閉じても何もしない
+            Test::Expect(static_cast<bool>(w->Close()), "Close");
+            Test::Expect(Read(fs, path) == Bytes("HDR!abcdefgXY"), "Close finishes the file");
+            Test::Expect(!w->Write("Z", 1), "Write after Close fails");
+            Test::Expect(static_cast<bool>(w->Close()), "second Close is a no-op");
+        }
+        Test::Expect(Read(fs, path) == Bytes("HDR!abcdefgXY"), "stream append content");
+
+        std::unique_ptr<IFileReader> r;
+        Test::Expect(static_cast<bool>(fs.OpenRead(path, r)) && r, "OpenRead");
+        uint64_t size = 0;
+        Test::Expect(static_cast<bool>(r->Size(size)) && size == 13, "reader Size");
+
+        char buf[8] = {};
+        size_t n = 0;
+        Test::Expect(static_cast<bool>(r->Read(buf, 4, n)) && n == 4 && std::string_view(buf, 4) == "HDR!", "Read");
+        Test::Expect(static_cast<bool>(r->ReadAt(8, buf, 3, n)) && n == 3 && std::string_view(buf, 3) == "efg", "ReadAt");
+        Test::Expect(r->Tell() == 4, "ReadAt keeps position");
+        Test::Expect(static_cast<bool>(r->Read(buf, 8, n)) && n == 8 && std::string_view(buf, 8) == "abcdefgX", "Read continues");
+        Test::Expect(static_cast<bool>(r->Read(buf, 8, n)) && n == 1, "short read at EOF");
+        Test::Expect(static_cast<bool>(r->Read(buf, 8, n)) && n == 0, "read past EOF");
+        Test::Expect(static_cast<bool>(r->Seek(2)) && static_cast<bool>(r->Read(buf, 2, n)) && std::string_view(buf, n) == "R!", "Seek");
+
+        // 実装が1回の呼び出しに渡せる数より多い要素
+        {
+            const std::string many = root + "stream_many.bin";
+            std::string expected;
+            std::vector<WriteSlice> slices;
+            static const char kDigits[] = "0123456789";
+            for (int i = 0; i < 200; ++i)
+            {
+                slices.push_back({ kDigits + (i % 10), 1 });
+                expected += kDigits[i % 10];
+            }
+            std::unique_ptr<IFileWriter> w;
+            fs.OpenWrite(many, FileWriteMode::Truncate, w);
+            Test::Expect(w && static_cast<bool>(w->WriteV(slices)) && w->Tell() == 200, "WriteV(many)");
+            w.reset();
+            Test::Expect(Read(fs, many) == Bytes(expected), "WriteV(many) content");
+        }
+
+        std::unique_ptr<IFileReader> missing;
+        Test::Expect(fs.OpenRead(root + "missing.bin", missing).error == FsError::NotFound && !missing, "OpenRead(missing)");
+        std::unique_ptr<IFileWriter> noDir;
+        Test::Expect(!fs.OpenWrite(root + "no_such_dir/x.bin", FileWriteMode::Truncate, noDir) && !noDir, "OpenWrite(missing dir)");
+    }
+
+    void TestStreamConstantMemory(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        // 固定の64KBバッファだけで32MBを書いて読み戻す
+        constexpr size_t kChunk = 64 * 1024;
+        constexpr size_t kChunks = 512;
+        std::vector<uint8_t> buffer(kChunk);
+        const std::string path = root + "stream_large.bin";
+
+        uint64_t written = 0;
+        {
+            std::unique_ptr<Core::IO::IFileWriter> w;
+            fs.OpenWrite(path, Core::IO::FileWriteMode::Truncate, w);
+            for (size_t c = 0; c < kChunks && w; ++c)
+            {
+                for (size_t i = 0; i < kChunk; ++i)
+                {
+                    buffer[i] = static_cast<uint8_t>(c * 7 + i);
+                    written += buffer[i];
+                }
+                w->Write(buffer.data(), buffer.size());
+            }
+        }
+
+        uint64_t read = 0;
+        uint64_t total = 0;
+        std::unique_ptr<Core::IO::IFileReader> r;
+        if (Test::Expect(static_cast<bool>(fs.OpenRead(path, r)), "OpenRead(large)"))
+        {
+            size_t n = 0;
+            while (r->Read(buffer.data(), buffer.size(), n) && n > 0)
+            {
+                total += n;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    read += buffer[i];
+                }
+            }
+        }
+        Test::Expect(total == kChunk * kChunks && read == written, "stream large round trip");
+    }
+
+    void TestCopy(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string src = root + "copy_src.txt";
+        const std::string dst = root + "copy_dst.txt";
+        fs.WriteAllBytes(src, "source", 6);
+        fs.WriteAllBytes(dst, "longer old content", 18);
+        Test::Expect(static_cast<bool>(fs.CopyAllBytes(src, dst)), "CopyAllBytes");
+        Test::Expect(Read(fs, dst) == Bytes("source"), "CopyAllBytes overwrites");
+
+        fs.WriteAllBytes(src, nullptr, 0);
+        Test::Expect(static_cast<bool>(fs.CopyAllBytes(src, dst)) && Read(fs, dst).empty(), "CopyAllBytes(zero)");
+
+        Test::Expect(fs.CopyAllBytes(root + "missing.txt", dst).error == FsError::NotFound, "CopyAllBytes(missing)");
+    }
+
+    void TestRemove(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "remove.txt";
+        fs.WriteAllBytes(path, "gone", 4);
+        Test::Expect(static_cast<bool>(fs.Remove(path)), "Remove");
+        Test::Expect(fs.Exists(path).error == FsError::NotFound, "Remove deletes file");
+        const FsResult missing = fs.Remove(path);
+        Test::Expect(missing.error == FsError::NotFound && missing.ec.value() != 0, "Remove(missing) reports the native code");
+
+        // ファイルだけを消す。空のディレクトリも消さない
+        const std::string dir = root + "remove_dir";
+        fs.CreateDirectories(dir);
+        Test::Expect(fs.Remove(dir).error == FsError::AccessDenied, "Remove refuses directories");
+        Test::Expect(static_cast<bool>(fs.Exists(dir)), "directory is kept");
+    }
+
+    void TestFileSize(IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "size.bin";
+        fs.WriteAllBytes(path, "0123456789", 10);
+        uint64_t size = 0;
+        Test::Expect(static_cast<bool>(fs.FileSize(path, size)) && size == 10, "FileSize");
+        fs.WriteAllBytes(path, nullptr, 0);
+        Test::Expect(static_cast<bool>(fs.FileSize(path, size)) && size == 0, "FileSize(zero)");
+        Test::Expect(fs.FileSize(root + "missing.bin", size).error == FsError::NotFound, "FileSize(missing)");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunFileSystemConformanceTests(Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        const std::string dir = root + "fs_conformance/";
+        fs.CreateDirectories(dir);
+
+        TestEmptyPath(fs);
+        TestDirectories(fs, dir);
+        TestWriteRead(fs, dir);
+        TestLargeFile(fs, dir);
+        TestMap(fs, dir);
+        TestAppend(fs, dir);
+        TestAtomic(fs, dir);
+        TestStreams(fs, dir);
+        TestStreamConstantMemory(fs, dir);
+        TestCopy(fs, dir);
+        TestRemove(fs, dir);
+        TestFileSize(fs, dir);
+
+        Test::Expect(!fs.currentPath().empty(), "currentPath");
+    }
+}
@@ -0,0 +1,161 @@
+#include "TestCommon.h"
+
+#include "Core/include/FileChangeCoalescer.h"
+#include "Core/include/FileChangeDispatcher.h"
+
+// C++ standard library includes
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::IO;
+
+    constexpr uint64_t kMs = 1000000;
+
+    void TestCoalescer()
+    {
+        using namespace Drama;
+
+        FileChangeCoalescer c;
+        std::vector<FileChange> out;
+
+        // 同じパスへの通知は1件に畳み、静かになるまで出さない
+        c.Push("a.txt", FileChangeKind::Modified, 0);
+        c.Push("a.txt", FileChangeKind::Modified, 50 * kMs);
+        Test::Expect(c.Drain(120 * kMs, 100 * kMs, out) == 0, "debounce waits for quiet");
+        Test::Expect(c.Drain(150 * kMs, 100 * kMs, out) == 1 && out[0].path == "a.txt" &&
+            out[0].kind == FileChangeKind::Modified, "debounce fires once");
+
+        // 作ってすぐ消えた一時ファイルは出さない。消してから作り直したら書き換え
+        out.clear();
+        c.Push("tmp~", FileChangeKind::Added, 0);
+        c.Push("tmp~", FileChangeKind::Modified, 1);
+        c.Push("tmp~", FileChangeKind::Removed, 2);
+        c.Push("b.txt", FileChangeKind::Removed, 3);
+        c.Push("b.txt", FileChangeKind::Added, 4);
+        c.Push("c.txt", FileChangeKind::Added, 5);
+        c.Push("c.txt", FileChangeKind::Modified, 6);
+        Test::Expect(c.Drain(1000 * kMs, 100 * kMs, out) == 2, "coalesce count");
+        Test::Expect(out.size() == 2 && out[0].path == "b.txt" && out[0].kind == FileChangeKind::Modified &&
+            out[1].path == "c.txt" && out[1].kind == FileChangeKind::Added, "coalesce kinds");
+
+        // Rescan は他の種類を上書きする
+        out.clear();
+        c.Push("dir", FileChangeKind::Removed, 0);
+        c.Push("dir", FileChangeKind::Rescan, 1);
+        c.Push("dir", FileChangeKind::Added, 2);
+        Test::Expect(c.Drain(1000 * kMs, 0, out) == 1 && out[0].kind == FileChangeKind::Rescan, "rescan sticks");
+        Test::Expect(c.PendingCount() == 0, "drained");
+    }
+
+    void TestDispatcher()
+    {
+        using namespace Drama;
+
+        FileChangeDispatcher d;
+        int shaderCalls = 0;
+        size_t shaderCount = 0;
+        int iniCalls = 0;
+        const uint32_t shaderId = d.Subscribe("root/shader/", [&](std::span<const FileChange> changes)
+            {
+                ++shaderCalls;
+                shaderCount += changes.size();
+            });
+        d.Subscribe("root/config/pipelines.ini", [&](std::span<const FileChange>) { ++iniCalls; });
+
+        const std::vector<FileChange> frame = {
+            { "root/shader/a.hlsl", FileChangeKind::Modified },
+            { "root/shader/b.hlsl", FileChangeKind::Added },
+            { "root/config/other.ini", FileChangeKind::Modified },
+        };
+        d.Dispatch(frame);
+        Test::Expect(shaderCalls == 1 && shaderCount == 2, "dispatch batches per subscriber");
+        Test::Expect(iniCalls == 0, "dispatch filters by prefix");
+
+        d.Dispatch(std::vector<FileChange>{ { "root/config", FileChangeKind::Rescan } });
+        Test::Expect(iniCalls == 1 && shaderCalls == 1, "rescan reaches subscribers below it");
+
+        d.Unsubscribe(shaderId);
+        d.Dispatch(frame);
+        Test::Expect(shaderCalls == 1 && d.SubscriberCount() == 1, "Unsubscribe");
+    }
+
+    /// @brief 条件がそろうまで Poll する(OSの通知は非同期なので少し待つ)
+    bool PollUntil(IFileWatcher& watcher, std::vector<FileChange>& out, const std::string& path, FileChangeKind kind)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            watcher.Poll(out);
+            for (const FileChange& c : out)
+            {
+                if (c.path == path && c.kind == kind)
+                {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+
+    void TestPlatformWatcher(IFileWatcher& watcher, IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string dir = root + "watched";
+        fs.CreateDirectories(dir + "/existing");
+        std::remove((dir + "/a.txt").c_str());
+
+        FileWatchId id = kInvalidFileWatchId;
+        if (!Test::Expect(static_cast<bool>(watcher.Watch(dir + "/", true, id)) && id != kInvalidFileWatchId, "Watch"))
+        {
+            return;
+        }
+        FileWatchId missing = kInvalidFileWatchId;
+        Test::Expect(watcher.Watch(root + "no_such_dir", false, missing).error == FsError::NotFound, "Watch(missing)");
+
+        std::vector<FileChange> out;
+        fs.WriteAllBytes(dir + "/a.txt", "v1", 2);
+        Test::Expect(PollUntil(watcher, out, dir + "/a.txt", FileChangeKind::Added), "watch add");
+
+        out.clear();
+        fs.WriteAllBytes(dir + "/a.txt", "v2", 2);
+        Test::Expect(PollUntil(watcher, out, dir + "/a.txt", FileChangeKind::Modified), "watch modify");
+
+        // 監視開始時からあるサブディレクトリ
+        out.clear();
+        fs.WriteAllBytes(dir + "/existing/b.txt", "b", 1);
+        Test::Expect(PollUntil(watcher, out, dir + "/existing/b.txt", FileChangeKind::Added), "watch recursive");
+
+        out.clear();
+        std::remove((dir + "/a.txt").c_str());
+        Test::Expect(PollUntil(watcher, out, dir + "/a.txt", FileChangeKind::Removed), "watch remove");
+
+        // 外した後は届かない
+        watcher.Unwatch(id);
+        out.clear();
+        fs.WriteAllBytes(dir + "/after.txt", "x", 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        watcher.Poll(out);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        watcher.Poll(out);
+        Test::Expect(out.empty(), "Unwatch");
+        std::remove((dir + "/after.txt").c_str());
+        std::remove((dir + "/existing/b.txt").c_str());
+    }
+}
+
+namespace Drama::Test
+{
+    void RunFileWatcherTests(Core::IO::IFileWatcher& watcher, Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        TestCoalescer();
+        TestDispatcher();
+        TestPlatformWatcher(watcher, fs, root);
+    }
+}
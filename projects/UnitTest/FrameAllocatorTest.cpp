@@ -0,0 +1,162 @@
+#include "TestCommon.h"
+
+#include "Core/include/FrameAllocator.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    using Drama::Core::Memory::FrameAllocator;
+    using Drama::Core::Memory::FrameAllocatorDesc;
+    using Drama::Core::Memory::FrameMemoryResource;
+    using Drama::Core::Memory::LinearArena;
+
+    bool Aligned(const void* p, size_t align) noexcept
+    {
+        return (reinterpret_cast<uintptr_t>(p) & (align - 1)) == 0;
+    }
+
+    void TestLinearArena()
+    {
+        using namespace Drama;
+
+        LinearArena arena(1024);
+        Test::Expect(arena.UsedBytes() == 0 && arena.ReservedBytes() == 0, "empty arena holds no memory");
+
+        void* a = arena.Allocate(10, 8);
+        void* b = arena.Allocate(1, 64);
+        void* c = arena.Allocate(0, 1);
+        Test::Expect(a && b && c && a != b && b != c, "distinct allocations");
+        Test::Expect(Aligned(a, 8) && Aligned(b, 64), "alignment");
+
+        // ブロックより大きい要求は専用のブロックになる
+        void* big = arena.Allocate(5000, 16);
+        Test::Expect(big != nullptr && arena.ReservedBytes() > 5000, "oversized allocation");
+        const size_t used = arena.UsedBytes();
+
+        // Reset 後は同じメモリを使い回し、ヒープを触らない
+        const uint64_t blocks = arena.BlockAllocations();
+        arena.Reset();
+        Test::Expect(arena.UsedBytes() == 0 && arena.PeakBytes() >= used, "reset keeps the peak");
+        Test::Expect(arena.Allocate(10, 8) == a, "reset rewinds to the first block");
+        Test::Expect(arena.Allocate(1, 64) == b, "same layout after reset");
+        for (int i = 0; i < 100; ++i)
+        {
+            arena.Allocate(40, 8);
+        }
+        Test::Expect(arena.BlockAllocations() == blocks, "second pass reuses the blocks");
+
+        arena.Release();
+        Test::Expect(arena.ReservedBytes() == 0 && arena.UsedBytes() == 0, "release");
+    }
+
+    void TestFrameSlots()
+    {
+        using namespace Drama;
+
+        FrameAllocator frames;
+        Test::Expect(frames.Allocate(0, 16) == nullptr, "allocate before Init fails");
+        Test::Expect(!frames.Init(0), "zero slots rejected");
+        Test::Expect(frames.Init(3) && frames.SlotCount() == 3, "Init");
+
+        // フレームごとに別の枠。Reset は同じ枠を使うフレームの分だけ戻す
+        int* f0 = frames.AllocateArray<int>(0, 4);
+        int* f1 = frames.AllocateArray<int>(1, 4);
+        f0[0] = 10;
+        f1[0] = 11;
+        frames.Reset(4); // 枠 1(フレーム 1 の分)
+        Test::Expect(f0[0] == 10, "other slots survive a reset");
+        Test::Expect(frames.Stats(1).usedBytes == 0 && frames.Stats(0).usedBytes >= sizeof(int) * 4, "per-slot stats");
+        Test::Expect(frames.AllocateArray<int>(4, 4) == f1, "retired slot is reused");
+    }
+
+    void TestThreads()
+    {
+        using namespace Drama;
+
+        // スレッドごとの区画から確保するので、同時に確保しても重ならない
+        FrameAllocatorDesc desc;
+        desc.blockSize = 4096;
+        desc.maxThreads = 2; // 3つ目以降のスレッドは共有の区画へ回る
+        FrameAllocator frames;
+        frames.Init(2, desc);
+
+        constexpr uint32_t kThreads = 4;
+        constexpr uint32_t kCount = 2000;
+        std::vector<std::vector<uint32_t*>> ptrs(kThreads);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([&frames, &ptrs, t]()
+                {
+                    for (uint32_t i = 0; i < kCount; ++i)
+                    {
+                        uint32_t* p = frames.AllocateArray<uint32_t>(7, 3);
+                        if (p)
+                        {
+                            p[0] = t;
+                            p[1] = i;
+                            p[2] = t ^ i;
+                        }
+                        ptrs[t].push_back(p);
+                    }
+                });
+        }
+        for (std::thread& th : threads)
+        {
+            th.join();
+        }
+
+        bool intact = true;
+        for (uint32_t t = 0; t < kThreads; ++t)
+        {
+            for (uint32_t i = 0; i < kCount; ++i)
+            {
+                const uint32_t* p = ptrs[t][i];
+                intact = intact && p && p[0] == t && p[1] == i && p[2] == (t ^ i);
+            }
+        }
+        Test::Expect(intact, "concurrent allocations do not overlap");
+        const auto stats = frames.Stats(7);
+        Test::Expect(stats.threads == 3, "two private arenas and the shared one");
+        Test::Expect(stats.usedBytes >= kThreads * kCount * 12, "usage is counted");
+    }
+
+    void TestMemoryResource()
+    {
+        using namespace Drama;
+
+        FrameAllocator frames;
+        frames.Init(2);
+        {
+            FrameMemoryResource resource(frames, 5);
+            std::pmr::vector<uint64_t> v(&resource);
+            for (uint64_t i = 0; i < 10000; ++i)
+            {
+                v.push_back(i * i);
+            }
+            std::pmr::string s("frame scratch text that is longer than the small buffer", &resource);
+            Test::Expect(v.size() == 10000 && v[9999] == 9999ull * 9999ull && s.size() > 40, "pmr containers");
+            Test::Expect(frames.Stats(5).usedBytes >= 10000 * sizeof(uint64_t), "containers allocate from the frame");
+
+            FrameMemoryResource same(frames, 7);
+            FrameMemoryResource other(frames, 6);
+            Test::Expect(resource.is_equal(same) && !resource.is_equal(other), "is_equal compares the slot");
+        }
+        frames.Reset(5);
+        Test::Expect(frames.Stats(5).usedBytes == 0, "reset returns container memory");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunFrameAllocatorTests()
+    {
+        TestLinearArena();
+        TestFrameSlots();
+        TestThreads();
+        TestMemoryResource();
+    }
+}
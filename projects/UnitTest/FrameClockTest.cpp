@@ -0,0 +1,90 @@
+#include "TestCommon.h"
+
+#include "Platform/include/FrameClock.h"
+
+// C++ standard library includes
+#include <cmath>
+
+namespace
+{
+    using Drama::Platform::FrameClock;
+    using Drama::Platform::FrameClockDesc;
+
+    bool Near(double a, double b, double eps = 1e-9) noexcept
+    {
+        return std::abs(a - b) <= eps;
+    }
+
+    /// @brief 貯まった分を全部取り出してステップ数を返す
+    int Drain(FrameClock& clock) noexcept
+    {
+        int steps = 0;
+        while (clock.StepFixed())
+        {
+            ++steps;
+        }
+        return steps;
+    }
+
+    void TestAccumulator()
+    {
+        using namespace Drama;
+
+        FrameClockDesc desc;
+        desc.fixedStepSeconds = 0.01;
+        desc.maxCatchUpSteps = 4;
+        FrameClock clock(desc);
+
+        // ステップ未満の時間は次のフレームへ持ち越す
+        clock.Accumulate(0.004);
+        Test::Expect(Drain(clock) == 0 && Near(clock.Alpha(), 0.4), "partial step carries over");
+        clock.Accumulate(0.007);
+        Test::Expect(Drain(clock) == 1 && Near(clock.Alpha(), 0.1), "carried time completes a step");
+        clock.Accumulate(0.025);
+        Test::Expect(Drain(clock) == 2 && Near(clock.Alpha(), 0.6), "multiple steps in one frame");
+        Test::Expect(Near(clock.SimulationSeconds(), 0.03), "simulation time advances by whole steps");
+
+        // 処理落ち: 上限を超えた分は捨て、端数は補間用に残す
+        clock.Accumulate(0.1);
+        Test::Expect(Drain(clock) == 4, "catch-up is capped");
+        Test::Expect(clock.Stats().droppedSteps == 6 && Near(clock.Alpha(), 0.6), "excess whole steps are dropped");
+        clock.Accumulate(0.0);
+        Test::Expect(Drain(clock) == 0, "dropped time does not come back next frame");
+
+        // 負の経過時間(時計の巻き戻り)は 0 として扱う
+        clock.Accumulate(-1.0);
+        Test::Expect(Drain(clock) == 0 && clock.DeltaSeconds() == 0.0, "negative delta is ignored");
+    }
+
+    void TestLimiter()
+    {
+        using namespace Drama;
+
+        // 200Hz で回し、平均間隔が目標に合うこと(実時間を使うので余裕を持って判定する)
+        FrameClockDesc desc;
+        desc.targetFps = 200.0;
+        FrameClock clock(desc);
+        for (int i = 0; i < 41; ++i)
+        {
+            clock.BeginFrame();
+            clock.WaitForNextFrame();
+        }
+        const Platform::FrameTimeStats stats = clock.Stats();
+        Test::Expect(stats.frames == 40, "one interval per frame after the first");
+        Test::Expect(stats.averageSeconds > 0.0045 && stats.averageSeconds < 0.006, "limiter holds the target interval");
+        Test::Expect(stats.minSeconds <= stats.averageSeconds && stats.averageSeconds <= stats.maxSeconds, "min <= avg <= max");
+        Test::Expect(clock.FrameIndex() == 41, "FrameIndex counts BeginFrame calls");
+
+        clock.ResetStats();
+        Test::Expect(clock.Stats().frames == 0, "ResetStats");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunFrameClockTests()
+    {
+        TestAccumulator();
+        TestLimiter();
+    }
+}
@@ -0,0 +1,207 @@
+#include "TestCommon.h"
+
+#include "Core/include/FramePipeline.h"
+
+// C++ standard library includes
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::Frame;
+
+    /// @brief テスト用のスナップショット(中身からフレーム番号を検算できるようにする)
+    struct TestSnapshot
+    {
+        uint64_t frame = 0;
+        std::vector<uint64_t> values;
+    };
+
+    void TestFence()
+    {
+        using namespace Drama;
+
+        FrameFence fence;
+        Test::Expect(fence.Completed() == 0 && fence.Wait(0), "fence starts at 0");
+        fence.Signal(3);
+        Test::Expect(fence.Completed() == 3 && fence.Wait(2) && fence.Wait(3), "Wait on reached value");
+
+        std::atomic<bool> woke{ false };
+        std::thread waiter([&]()
+            {
+                woke.store(fence.Wait(10), std::memory_order_release);
+            });
+        fence.Signal(10);
+        waiter.join();
+        Test::Expect(woke.load(), "Signal wakes Wait");
+
+        std::atomic<int> result{ -1 };
+        std::thread cancelled([&]()
+            {
+                result.store(fence.Wait(100) ? 1 : 0, std::memory_order_release);
+            });
+        fence.Cancel();
+        cancelled.join();
+        Test::Expect(result.load() == 0 && fence.IsCancelled(), "Cancel releases Wait with false");
+        Test::Expect(fence.Wait(10), "reached value still succeeds after Cancel");
+        fence.Signal(11);
+        Test::Expect(fence.Completed() == 11 && fence.IsCancelled(), "Signal keeps the cancel state");
+    }
+
+    void TestSerial()
+    {
+        using namespace Drama;
+
+        FramePipeline<TestSnapshot> pipeline;
+        Test::Expect(!pipeline.Init(0) && !pipeline.Init(kMaxFrameSlots + 1), "Init rejects bad slot counts");
+        Test::Expect(pipeline.Init(1), "Init(1)");
+        // 1枠なら同じスレッドで交互に呼んでも止まらない
+        for (uint64_t f = 0; f < 10; ++f)
+        {
+            TestSnapshot* w = pipeline.BeginUpdate();
+            if (!Test::Expect(w != nullptr, "BeginUpdate"))
+            {
+                return;
+            }
+            w->frame = f;
+            pipeline.EndUpdate();
+            const TestSnapshot* r = pipeline.BeginRender();
+            Test::Expect(r != nullptr && r->frame == f, "BeginRender gets the frame just published");
+            pipeline.EndRender();
+        }
+        Test::Expect(pipeline.UpdatedFrames() == 10 && pipeline.RenderedFrames() == 10, "frame counts");
+
+        // 3枠なら描画を待たずに3フレーム先まで書ける
+        Test::Expect(pipeline.Init(3), "Init(3)");
+        for (uint64_t f = 0; f < 3; ++f)
+        {
+            TestSnapshot* w = pipeline.BeginUpdate();
+            Test::Expect(w != nullptr, "BeginUpdate ahead of render");
+            pipeline.EndUpdate();
+        }
+        Test::Expect(pipeline.UpdatedFrames() == 3 && pipeline.RenderedFrames() == 0, "three frames in flight");
+    }
+
+    void TestThreaded(uint32_t slots)
+    {
+        using namespace Drama;
+
+        constexpr uint64_t kFrames = 2000;
+        constexpr size_t kValues = 64;
+        FramePipeline<TestSnapshot> pipeline;
+        pipeline.Init(slots);
+
+        std::atomic<uint64_t> maxLag{ 0 };
+        std::atomic<uint64_t> rendered{ 0 };
+        std::atomic<bool> ordered{ true };
+        std::atomic<bool> intact{ true };
+        std::thread render([&]()
+            {
+                uint64_t expect = 0;
+                while (const TestSnapshot* s = pipeline.BeginRender())
+                {
+                    if (s->frame != expect)
+                    {
+                        ordered.store(false, std::memory_order_relaxed);
+                    }
+                    // 描画中に Update が同じ枠を書き換えていないこと
+                    for (size_t i = 0; i < s->values.size(); ++i)
+                    {
+                        if (s->values[i] != s->frame * kValues + i)
+                        {
+                            intact.store(false, std::memory_order_relaxed);
+                        }
+                    }
+                    if ((expect & 7) == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    ++expect;
+                    pipeline.EndRender();
+                }
+                rendered.store(expect, std::memory_order_release);
+            });
+
+        for (uint64_t f = 0; f < kFrames; ++f)
+        {
+            TestSnapshot* s = pipeline.BeginUpdate();
+            if (s == nullptr)
+            {
+                break;
+            }
+            const uint64_t lag = f - pipeline.RenderedFrames();
+            if (lag > maxLag.load(std::memory_order_relaxed))
+            {
+                maxLag.store(lag, std::memory_order_relaxed);
+            }
+            s->frame = f;
+            s->values.resize(kValues);
+            for (size_t i = 0; i < kValues; ++i)
+            {
+                s->values[i] = f * kValues + i;
+            }
+            pipeline.EndUpdate();
+        }
+        // 公開済みの分は描画し切ってから BeginRender が nullptr を返す
+        pipeline.Stop();
+        render.join();
+
+        Test::Expect(ordered.load(), "frames are rendered in order");
+        Test::Expect(intact.load(), "snapshot is not overwritten while rendering");
+        Test::Expect(rendered.load() == kFrames, "Stop drains published frames");
+        Test::Expect(maxLag.load() < slots, "update runs at most slots-1 frames ahead");
+    }
+
+    void TestStop()
+    {
+        using namespace Drama;
+
+        // 描画が進まないまま枠を使い切った Update は、Stop で nullptr を受け取って抜ける
+        FramePipeline<TestSnapshot> pipeline;
+        pipeline.Init(2);
+        std::atomic<int> published{ 0 };
+        std::thread update([&]()
+            {
+                while (pipeline.BeginUpdate() != nullptr)
+                {
+                    pipeline.EndUpdate();
+                    published.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        while (published.load(std::memory_order_relaxed) < 2)
+        {
+            std::this_thread::yield();
+        }
+        pipeline.Stop();
+        update.join();
+        Test::Expect(published.load() == 2, "blocked BeginUpdate returns nullptr on Stop");
+
+        // 公開を待っている Render も同様に抜ける
+        FramePipeline<TestSnapshot> idle;
+        idle.Init(2);
+        std::atomic<bool> gotNull{ false };
+        std::thread render([&]()
+            {
+                gotNull.store(idle.BeginRender() == nullptr, std::memory_order_release);
+            });
+        idle.Stop();
+        render.join();
+        Test::Expect(gotNull.load(), "waiting BeginRender returns nullptr on Stop");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunFramePipelineTests()
+    {
+        TestFence();
+        TestSerial();
+        for (uint32_t slots = 1; slots <= Core::Frame::kMaxFrameSlots; ++slots)
+        {
+            TestThreaded(slots);
+        }
+        TestStop();
+    }
+}
@@ -0,0 +1,193 @@
+#include "TestCommon.h"
+
+#include "Core/include/FrustumCulling.h"
+#include "Core/include/JobSystem.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::Math;
+    using namespace Drama::Core::Scene;
+
+    /// @brief 左手系の透視射影(行ベクトル。z は near で 0、far で 1)
+    Float4x4 Perspective(float fovY, float aspect, float nearZ, float farZ) noexcept
+    {
+        const float ys = 1.0f / std::tan(fovY * 0.5f);
+        const float q = farZ / (farZ - nearZ);
+        Float4x4 m{};
+        m.r[0] = Float4{ ys / aspect, 0, 0, 0 };
+        m.r[1] = Float4{ 0, ys, 0, 0 };
+        m.r[2] = Float4{ 0, 0, q, 1 };
+        m.r[3] = Float4{ 0, 0, -nearZ * q, 0 };
+        return m;
+    }
+
+    std::vector<uint32_t> Run(CullFunction cull, const Frustum& frustum, const CullingSet& set)
+    {
+        std::vector<uint32_t> out(set.PaddedSize());
+        out.resize(cull(frustum, set, 0, set.PaddedSize(), out.data()));
+        return out;
+    }
+
+    /// @brief 平面から一番近い判定の余裕(0 に近いと、実装による丸めの違いで結果が分かれてよい)
+    float Margin(const Frustum& frustum, const BoundingSphere& sphere, const Aabb& box) noexcept
+    {
+        const Float3 center = (box.min + box.max) * 0.5f;
+        const Float3 extent = (box.max - box.min) * 0.5f;
+        float margin = INFINITY;
+        for (const Float4& p : frustum.planes)
+        {
+            const Float3 n{ p.x, p.y, p.z };
+            margin = std::fmin(margin, std::fabs(Dot(n, sphere.center) + p.w + sphere.radius));
+            margin = std::fmin(margin, std::fabs(Dot(n, center) + p.w + Dot(Float3{ std::fabs(n.x), std::fabs(n.y), std::fabs(n.z) }, extent)));
+        }
+        return margin;
+    }
+
+    void TestFrustum()
+    {
+        using namespace Drama;
+
+        // 単位行列なら -1<=x<=1, -1<=y<=1, 0<=z<=1 の箱
+        const Frustum box = FrustumFromMatrix(Identity());
+        CullingSet set;
+        const uint32_t inside = set.Add(Aabb{ Float3{ -0.1f, -0.1f, 0.4f }, Float3{ 0.1f, 0.1f, 0.6f } });
+        set.Add(Aabb{ Float3{ 2.5f, -0.1f, 0.4f }, Float3{ 3.0f, 0.1f, 0.6f } });
+        const uint32_t straddling = set.Add(Aabb{ Float3{ 0.9f, -0.1f, 0.4f }, Float3{ 1.5f, 0.1f, 0.6f } });
+        // 球はどの平面にもかかるが、箱は角の外にある(AABB の判定で落ちる)
+        set.Add(BoundingSphere{ Float3{ 1.5f, 1.5f, 0.5f }, 1.0f }, Aabb{ Float3{ 1.2f, 1.2f, 0.2f }, Float3{ 1.8f, 1.8f, 0.8f } });
+        set.Add(Aabb{ Float3{ -0.1f, -0.1f, -0.6f }, Float3{ 0.1f, 0.1f, -0.4f } });
+        Test::Expect(set.Size() == 5 && set.PaddedSize() == CullingSet::kPadding, "set pads to 8");
+
+        const std::vector<uint32_t> visible = Run(CullFunctionFor(SimdLevel::Scalar), box, set);
+        Test::Expect(visible.size() == 2 && visible[0] == inside && visible[1] == straddling, "identity frustum keeps inside and straddling objects");
+
+        // 透視: カメラの前は見え、後ろは見えない
+        const Frustum perspective = FrustumFromMatrix(Perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+        CullingSet depth;
+        depth.Add(BoundingSphere{ Float3{ 0, 0, 10 }, 1.0f }, Aabb{ Float3{ -1, -1, 9 }, Float3{ 1, 1, 11 } });
+        depth.Add(BoundingSphere{ Float3{ 0, 0, -10 }, 1.0f }, Aabb{ Float3{ -1, -1, -11 }, Float3{ 1, 1, -9 } });
+        depth.Add(BoundingSphere{ Float3{ 0, 0, 150 }, 1.0f }, Aabb{ Float3{ -1, -1, 149 }, Float3{ 1, 1, 151 } });
+        depth.Add(BoundingSphere{ Float3{ 40, 0, 10 }, 1.0f }, Aabb{ Float3{ 39, -1, 9 }, Float3{ 41, 1, 11 } });
+        const std::vector<uint32_t> seen = Run(CullFunctionFor(SimdLevel::Scalar), perspective, depth);
+        Test::Expect(seen.size() == 1 && seen[0] == 0, "perspective frustum rejects behind, beyond far and outside");
+
+        Test::Expect(depth.Set(1, BoundingSphere{ Float3{ 0, 0, 20 }, 1.0f }, Aabb{ Float3{ -1, -1, 19 }, Float3{ 1, 1, 21 } }) && !depth.Set(4, {}, {}),
+            "set updates in range only");
+        Test::Expect(Run(CullFunctionFor(SimdLevel::Scalar), perspective, depth).size() == 2, "updated bounds are used");
+    }
+
+    /// @brief 使える全実装の結果を Scalar 実装と比べる
+    void TestKernelsMatchScalar()
+    {
+        using namespace Drama;
+
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> d(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> size(0.1f, 10.0f);
+        // 端数も通るよう 8 の倍数にしない
+        CullingSet set;
+        std::vector<BoundingSphere> spheres;
+        std::vector<Aabb> boxes;
+        for (int i = 0; i < 10003; ++i)
+        {
+            const Float3 c{ d(rng), d(rng) * 0.5f, d(rng) };
+            const Float3 e{ size(rng), size(rng), size(rng) };
+            boxes.push_back(Aabb{ c - e, c + e });
+            spheres.push_back(BoundingSphere{ c, Length(e) });
+            set.Add(spheres.back(), boxes.back());
+        }
+        const Frustum frustum = FrustumFromMatrix(Translation(Float3{ 10, -5, 30 }) * Perspective(1.2f, 1.5f, 0.5f, 150.0f));
+        const std::vector<uint32_t> expected = Run(CullFunctionFor(SimdLevel::Scalar), frustum, set);
+        Test::Expect(!expected.empty() && expected.size() < set.Size() && std::is_sorted(expected.begin(), expected.end()), "scalar culls some but not all");
+
+        for (uint8_t l = 1; l < static_cast<uint8_t>(SimdLevel::Count); ++l)
+        {
+            const CullFunction cull = CullFunctionFor(static_cast<SimdLevel>(l));
+            if (!cull)
+            {
+                continue;
+            }
+            const std::string name = SimdLevelName(static_cast<SimdLevel>(l));
+            const std::vector<uint32_t> got = Run(cull, frustum, set);
+            std::vector<uint32_t> diff;
+            std::set_symmetric_difference(expected.begin(), expected.end(), got.begin(), got.end(), std::back_inserter(diff));
+            bool ok = std::is_sorted(got.begin(), got.end());
+            for (const uint32_t i : diff)
+            {
+                ok = ok && Margin(frustum, spheres[i], boxes[i]) < 1e-3f;
+            }
+            Test::Expect(ok, name + ": cull matches scalar");
+
+            // 途中から途中まで(端数の処理)
+            std::vector<uint32_t> part(100);
+            part.resize(cull(frustum, set, 13, 113, part.data()));
+            std::vector<uint32_t> partExpected;
+            std::copy_if(expected.begin(), expected.end(), std::back_inserter(partExpected), [](uint32_t i) { return i >= 13 && i < 113; });
+            Test::Expect(part == partExpected, name + ": cull of an unaligned range");
+        }
+        Test::Expect(CullFunctionFor(BestCullLevel()) != nullptr, "best level is available");
+    }
+
+    void TestCuller()
+    {
+        using namespace Drama;
+
+        VisibilityCuller culler;
+        Test::Expect(!culler.Init(0), "zero slots are rejected");
+        Test::Expect(culler.Init(3) && culler.SlotCount() == 3 && culler.Visible(0).empty(), "culler init");
+
+        std::mt19937 rng(8);
+        std::uniform_real_distribution<float> d(-300.0f, 300.0f);
+        CullingSet set;
+        for (int i = 0; i < 50001; ++i)
+        {
+            const Float3 c{ d(rng), d(rng), d(rng) };
+            set.Add(Aabb{ c - Float3{ 1, 1, 1 }, c + Float3{ 1, 1, 1 } });
+        }
+        const Frustum front = FrustumFromMatrix(Perspective(1.0f, 1.0f, 0.1f, 500.0f));
+        const Frustum back = FrustumFromMatrix(Scaling(Float3{ 1, 1, -1 }) * Perspective(1.0f, 1.0f, 0.1f, 500.0f));
+        const std::vector<uint32_t> expectedFront = Run(CullFunctionFor(SimdLevel::Scalar), front, set);
+        const std::vector<uint32_t> expectedBack = Run(CullFunctionFor(SimdLevel::Scalar), back, set);
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc desc{};
+        desc.threadCount = 4;
+        Test::Expect(jobs.Start(desc), "job system starts");
+
+        // 枠ごとに別の結果を持つ
+        const std::span<const uint32_t> f0 = culler.Cull(0, front, set, &jobs);
+        const std::span<const uint32_t> f1 = culler.Cull(1, back, set);
+        Test::Expect(std::equal(f0.begin(), f0.end(), expectedFront.begin(), expectedFront.end()), "parallel cull matches scalar");
+        Test::Expect(std::equal(f1.begin(), f1.end(), expectedBack.begin(), expectedBack.end()), "serial cull matches scalar");
+        const std::span<const uint32_t> v0 = culler.Visible(0);
+        Test::Expect(v0.data() == f0.data() && v0.size() == f0.size() && culler.Visible(4).size() == f1.size(), "frame slots keep their own lists");
+        Test::Expect(culler.Cull(3, back, set, &jobs).size() == expectedBack.size() && culler.Visible(0).size() == expectedBack.size(), "slot is reused after the buffering count");
+        jobs.Stop();
+
+        // Scalar でも同じ
+        VisibilityCuller scalar;
+        Test::Expect(scalar.Init(1, SimdLevel::Scalar) && scalar.Level() == SimdLevel::Scalar, "scalar culler init");
+        const std::span<const uint32_t> s = scalar.Cull(0, front, set);
+        Test::Expect(std::equal(s.begin(), s.end(), expectedFront.begin(), expectedFront.end()), "scalar culler");
+
+        set.Clear();
+        Test::Expect(set.Size() == 0 && culler.Cull(2, front, set).empty(), "empty set");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunFrustumCullingTests()
+    {
+        TestFrustum();
+        TestKernelsMatchScalar();
+        TestCuller();
+    }
+}
@@ -0,0 +1,274 @@
+#include "TestCommon.h"
+
+#include "Core/include/HandlePool.h"
+#include "Core/include/SlabAllocator.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+    using Drama::Core::Memory::HandlePool;
+    using Drama::Core::Memory::HandlePoolDesc;
+    using Drama::Core::Memory::SlabAllocator;
+    using Drama::Core::Memory::SlabDesc;
+    using Drama::Core::Memory::SlabHandle;
+
+    /// @brief コンストラクタとデストラクタの回数を数える
+    struct Tracked
+    {
+        static inline std::atomic<int> s_Alive{ 0 };
+        explicit Tracked(int v) : value(v), name(std::to_string(v)) { s_Alive.fetch_add(1); }
+        ~Tracked() { s_Alive.fetch_sub(1); }
+        int value;
+        std::string name; // 破棄が要る型でも動くこと
+    };
+
+    void TestSlab()
+    {
+        using namespace Drama;
+
+        SlabAllocator slab;
+        SlabDesc desc;
+        desc.blockSize = 24;
+        desc.blockAlign = 32;
+        desc.blocksPerSlab = 3; // 4 に切り上がる
+        desc.maxBlocks = 8;
+        Test::Expect(slab.Init(desc) && slab.Capacity() == 4 && slab.Stride() == 32, "Init rounds the slab size");
+
+        // 1スラブの中は番号順・等間隔に並ぶ
+        SlabHandle h[8];
+        for (SlabHandle& x : h)
+        {
+            x = slab.Allocate();
+        }
+        Test::Expect(slab.SlabCount() == 2 && slab.LiveCount() == 8, "grows by whole slabs");
+        bool contiguous = true;
+        for (int i = 0; i < 4; ++i)
+        {
+            contiguous = contiguous && h[i].Index() == static_cast<uint32_t>(i) &&
+                static_cast<std::byte*>(slab.Resolve(h[i])) == static_cast<std::byte*>(slab.Resolve(h[0])) + i * 32;
+        }
+        Test::Expect(contiguous, "blocks in a slab are contiguous");
+        Test::Expect((reinterpret_cast<uintptr_t>(slab.Resolve(h[5])) & 31) == 0, "alignment");
+        Test::Expect(!slab.Allocate().IsValid(), "maxBlocks is a hard limit");
+
+        // 解放すると世代が進み、古いハンドルは届かない
+        void* p2 = slab.Resolve(h[2]);
+        Test::Expect(slab.Free(h[2]) && slab.Resolve(h[2]) == nullptr, "stale handle resolves to null");
+        Test::Expect(!slab.Free(h[2]), "double free is rejected");
+        const SlabHandle again = slab.Allocate();
+        Test::Expect(again.Index() == 2 && again.Generation() == h[2].Generation() + 1, "slot is reused with a new generation");
+        Test::Expect(slab.Resolve(again) == p2 && slab.Resolve(h[2]) == nullptr, "old handle stays dead after reuse");
+        Test::Expect(!slab.Free(SlabHandle{}) && slab.Resolve(SlabHandle{}) == nullptr, "null handle");
+        Test::Expect(slab.Resolve(SlabHandle::Make(100, 1)) == nullptr, "out of range handle");
+
+        // 世代は 4096 回使い回しても一周せず、最初のハンドルは届かないまま
+        SlabHandle cur = again;
+        for (uint32_t i = 0; i < 5000; ++i)
+        {
+            slab.Free(cur);
+            cur = slab.Allocate();
+        }
+        Test::Expect(cur.IsValid() && cur.Index() == 2 && cur.Generation() == again.Generation() + 5000, "generation keeps counting past 4096 reuses");
+        Test::Expect(slab.Resolve(h[2]) == nullptr && slab.Resolve(again) == nullptr, "old handles stay dead after many reuses");
+
+        // Shutdown 前のハンドルは作り直した後の同じ番号にも届かない
+        const SlabHandle beforeShutdown = h[0];
+        slab.Shutdown();
+        Test::Expect(slab.Init(desc), "Init after Shutdown");
+        const SlabHandle afterInit = slab.Allocate();
+        Test::Expect(afterInit.Index() == beforeShutdown.Index() && afterInit.Generation() > cur.Generation(), "generations continue after Shutdown");
+        Test::Expect(slab.Resolve(beforeShutdown) == nullptr && !slab.Free(beforeShutdown), "handles from before Shutdown are dead");
+        Test::Expect(slab.Resolve(afterInit) != nullptr, "new handle resolves");
+
+        // 2 の累乗でない上限はスラブの切り上げで超えない
+        SlabAllocator odd;
+        SlabDesc oddDesc;
+        oddDesc.blocksPerSlab = 4;
+        oddDesc.maxBlocks = 6;
+        Test::Expect(odd.Init(oddDesc), "Init with a non power of two limit");
+        uint32_t allocated = 0;
+        while (odd.Allocate().IsValid())
+        {
+            ++allocated;
+        }
+        Test::Expect(allocated == 6 && odd.Capacity() == 6 && odd.LiveCount() == 6, "maxBlocks is exact across slabs");
+
+        SlabAllocator small;
+        SlabDesc smallDesc;
+        smallDesc.blocksPerSlab = 1024;
+        smallDesc.maxBlocks = 5; // 1スラブは 8 に切り上がるが、配るのは 5 まで
+        Test::Expect(small.Init(smallDesc) && small.Capacity() == 5, "a single slab is clamped to maxBlocks");
+        allocated = 0;
+        while (small.Allocate().IsValid())
+        {
+            ++allocated;
+        }
+        Test::Expect(allocated == 5, "maxBlocks is exact within a slab");
+        Test::Expect(small.Resolve(SlabHandle::Make(6, 1)) == nullptr && !small.Free(SlabHandle::Make(6, 1)), "blocks past maxBlocks do not exist");
+    }
+
+    void TestPool()
+    {
+        using namespace Drama;
+
+        {
+            HandlePool<Tracked> pool;
+            HandlePoolDesc desc;
+            desc.objectsPerSlab = 16;
+            desc.maxObjects = 64;
+            Test::Expect(pool.Init(desc), "pool Init");
+
+            std::vector<HandlePool<Tracked>::Handle> handles;
+            for (int i = 0; i < 40; ++i)
+            {
+                handles.push_back(pool.Create(i));
+            }
+            Test::Expect(pool.Size() == 40 && Tracked::s_Alive.load() == 40, "Create constructs");
+            Test::Expect(pool.Get(handles[7])->value == 7 && pool.Get(handles[7])->name == "7", "Get");
+
+            for (int i = 0; i < 40; i += 2)
+            {
+                pool.Destroy(handles[i]);
+            }
+            Test::Expect(Tracked::s_Alive.load() == 20 && !pool.IsAlive(handles[0]) && pool.IsAlive(handles[1]), "Destroy destructs");
+            Test::Expect(!pool.Destroy(handles[0]), "double destroy is rejected");
+
+            int sum = 0;
+            int visited = 0;
+            pool.ForEach([&](HandlePool<Tracked>::Handle h, Tracked& t)
+                {
+                    sum += t.value;
+                    visited += pool.Get(h) == &t ? 1 : 0;
+                });
+            Test::Expect(visited == 20 && sum == 400, "ForEach visits live objects");
+        }
+        Test::Expect(Tracked::s_Alive.load() == 0, "pool destructor destroys the rest");
+    }
+
+    void TestConcurrent()
+    {
+        using namespace Drama;
+
+        // 複数スレッドで作って壊すのを繰り返す。同時に生きているハンドルが重ならず、最後に全部空くこと
+        HandlePool<uint64_t> pool;
+        HandlePoolDesc desc;
+        desc.objectsPerSlab = 64;
+        desc.maxObjects = 4096;
+        pool.Init(desc);
+
+        constexpr uint32_t kThreads = 4;
+        constexpr uint32_t kRounds = 2000;
+        std::atomic<bool> ok{ true };
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([&pool, &ok, t]()
+                {
+                    std::vector<HandlePool<uint64_t>::Handle> mine;
+                    for (uint32_t r = 0; r < kRounds; ++r)
+                    {
+                        const uint64_t tag = (static_cast<uint64_t>(t) << 32) | r;
+                        const auto h = pool.Create(tag);
+                        if (!h.IsValid())
+                        {
+                            ok = false;
+                            return;
+                        }
+                        mine.push_back(h);
+                        // 他スレッドに書き換えられていないこと
+                        if ((r & 3) == 3)
+                        {
+                            for (const auto& m : mine)
+                            {
+                                const uint64_t* v = pool.Get(m);
+                                if (!v || (*v >> 32) != t)
+                                {
+                                    ok = false;
+                                }
+                                pool.Destroy(m);
+                            }
+                            mine.clear();
+                        }
+                    }
+                    for (const auto& m : mine)
+                    {
+                        pool.Destroy(m);
+                    }
+                });
+        }
+        for (std::thread& th : threads)
+        {
+            th.join();
+        }
+        Test::Expect(ok.load(), "concurrent create/destroy keeps objects private");
+        Test::Expect(pool.Size() == 0, "all objects returned");
+        Test::Expect(pool.Capacity() <= kThreads * 64 * 2, "free list is reused instead of growing");
+    }
+
+    void TestExitedThreadCaches()
+    {
+        using namespace Drama;
+
+        // 作って壊すを繰り返したスレッドが終わっても、手元に残した空きは取り残されず上限まで作れる
+        constexpr uint32_t kMax = 1000;
+        HandlePool<uint64_t> pool;
+        HandlePoolDesc desc;
+        desc.objectsPerSlab = 64;
+        desc.maxObjects = kMax;
+        pool.Init(desc);
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&pool]()
+                {
+                    std::vector<HandlePool<uint64_t>::Handle> mine;
+                    for (uint32_t r = 0; r < 500; ++r)
+                    {
+                        mine.push_back(pool.Create(r));
+                        if (mine.size() == 40)
+                        {
+                            for (const auto& h : mine)
+                            {
+                                pool.Destroy(h);
+                            }
+                            mine.clear();
+                        }
+                    }
+                    for (const auto& h : mine)
+                    {
+                        pool.Destroy(h);
+                    }
+                });
+        }
+        for (std::thread& th : threads)
+        {
+            th.join();
+        }
+
+        uint32_t created = 0;
+        while (pool.Create(created).IsValid())
+        {
+            ++created;
+        }
+        Test::Expect(created == kMax, "pool fills to maxObjects after churning threads exit");
+        Test::Expect(pool.Size() == kMax, "every block is live");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunHandlePoolTests()
+    {
+        TestSlab();
+        TestPool();
+        TestConcurrent();
+        TestExitedThreadCaches();
+    }
+}
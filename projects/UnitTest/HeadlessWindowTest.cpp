@@ -0,0 +1,57 @@
+#include "TestCommon.h"
+
+#include "Platform/include/HeadlessWindow.h"
+#ifdef ENGINE_CREATE_FUN
+#include "Engine/utility/EngineCreateAPI.h"
+#endif
+
+// C++ standard library includes
+#include <memory>
+#include <thread>
+
+namespace Drama::Test
+{
+    void RunHeadlessWindowTests()
+    {
+        Platform::HeadlessWindow window;
+        Platform::IWindow& base = window;
+        Expect(base.Create(640, 360), "Create");
+        Expect(base.Width() == 640 && base.Height() == 360, "size is kept");
+        Expect(base.NativeHandle() == nullptr, "no native handle");
+        base.Show();
+        Expect(base.PumpMessages() && base.PumpMessages(), "keeps running until quit is requested");
+
+        // 別スレッド(監視役やテストの制御側)からの終了要求で止まる
+        std::thread quitter([&window]() { window.RequestQuit(); });
+        quitter.join();
+        Expect(!base.PumpMessages(), "RequestQuit stops the loop");
+
+        // 作り直せば再び回る
+        Expect(base.Create(320, 180) && base.PumpMessages(), "Create resets the quit request");
+        base.Shutdown();
+        Expect(base.Width() == 0 && base.Height() == 0, "Shutdown clears the size");
+
+#ifdef ENGINE_CREATE_FUN
+        // エンジンのメインループをヘッドレスで回し、指定のフレーム数で抜けることを確かめる
+        {
+            std::unique_ptr<Drama::Engine, decltype(&API::DestroyEngine)> engine(API::CreateEngine(), API::DestroyEngine);
+            API::SetEngine(engine.get());
+
+            HeadlessRunDesc desc{};
+            desc.frameCount = 8;
+            const HeadlessRunResult result = API::RunHeadless(desc);
+            Expect(result.initialized, "engine initializes without a window");
+            Expect(result.frames == desc.frameCount, "main loop stops after frameCount frames");
+
+            // 時間指定でも抜ける(Shutdown 後に作り直せることも兼ねる)
+            HeadlessRunDesc timed{};
+            timed.durationSeconds = 0.05;
+            timed.fixedRateHz = 200.0;
+            const HeadlessRunResult timedResult = API::RunHeadless(timed);
+            Expect(timedResult.initialized && timedResult.frames > 0, "main loop stops after durationSeconds");
+            Expect(timedResult.elapsedSeconds < 5.0, "duration limit is honoured");
+            API::SetEngine(nullptr);
+        }
+#endif
+    }
+}
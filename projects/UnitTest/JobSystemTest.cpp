@@ -0,0 +1,414 @@
+#include "TestCommon.h"
+
+#include "Core/include/Fiber.h"
+#include "Core/include/JobSystem.h"
+#include "Core/include/WorkStealingDeque.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::Job;
+
+    void TestDeque()
+    {
+        using namespace Drama;
+
+        WorkStealingDeque<int*> dq;
+        dq.Init(4);
+        int values[5] = {};
+        int* out = nullptr;
+        Test::Expect(!dq.Pop(out) && !dq.Steal(out), "empty deque");
+        for (int i = 0; i < 4; ++i)
+        {
+            Test::Expect(dq.Push(&values[i]), "Push");
+        }
+        Test::Expect(!dq.Push(&values[4]), "Push(full)");
+        Test::Expect(dq.Pop(out) && out == &values[3], "Pop is LIFO");
+        Test::Expect(dq.Steal(out) && out == &values[0], "Steal is FIFO");
+        Test::Expect(dq.ApproxSize() == 2, "ApproxSize");
+
+        // 持ち主が積んで取る間に他のスレッドが盗んでも、各要素はちょうど1回ずつ取り出される
+        constexpr int kItems = 200000;
+        std::vector<int> items(kItems);
+        std::vector<std::atomic<int>> seen(kItems);
+        WorkStealingDeque<int*> shared;
+        shared.Init(256);
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> thieves;
+        for (int t = 0; t < 3; ++t)
+        {
+            thieves.emplace_back([&]()
+                {
+                    int* p = nullptr;
+                    while (!done.load(std::memory_order_acquire) || shared.ApproxSize() > 0)
+                    {
+                        if (shared.Steal(p))
+                        {
+                            seen[p - items.data()].fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                });
+        }
+        int* p = nullptr;
+        for (int i = 0; i < kItems; ++i)
+        {
+            while (!shared.Push(&items[i]))
+            {
+                if (shared.Pop(p))
+                {
+                    seen[p - items.data()].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if ((i & 3) == 0 && shared.Pop(p))
+            {
+                seen[p - items.data()].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        while (shared.Pop(p))
+        {
+            seen[p - items.data()].fetch_add(1, std::memory_order_relaxed);
+        }
+        done.store(true, std::memory_order_release);
+        for (std::thread& t : thieves)
+        {
+            t.join();
+        }
+        bool exactlyOnce = true;
+        for (const auto& s : seen)
+        {
+            exactlyOnce = exactlyOnce && s.load() == 1;
+        }
+        Test::Expect(exactlyOnce, "deque delivers every item exactly once");
+    }
+
+    struct PingPong
+    {
+        Fiber* self = nullptr;
+        Fiber* main = nullptr;
+        int value = 0;
+        double fp = 1.0;
+    };
+
+    void TestFiberSwitch()
+    {
+        using namespace Drama;
+
+        // スレッドとファイバーの間を行き来し、切り替えをまたいで値と浮動小数点の状態が保たれる
+        FiberPool pool;
+        PingPong pp;
+        if (!Test::Expect(pool.Init(2, 64 * 1024, [](void* arg)
+            {
+                auto* p = static_cast<PingPong*>(arg);
+                double local = 0.5;
+                while (true)
+                {
+                    p->value += 1;
+                    p->fp *= 2.0;
+                    local += p->fp;
+                    Fiber::Switch(*p->self, *p->main);
+                }
+            }, &pp), "FiberPool::Init"))
+        {
+            return;
+        }
+        Test::Expect(pool.Capacity() == 2 && pool.Available() == 2, "FiberPool capacity");
+        Fiber main;
+        Test::Expect(main.InitFromThread(), "Fiber::InitFromThread");
+        pp.main = &main;
+        pp.self = pool.Acquire();
+        Test::Expect(pool.Available() == 1, "FiberPool::Acquire");
+        for (int i = 0; i < 10; ++i)
+        {
+            Fiber::Switch(main, *pp.self);
+        }
+        Test::Expect(pp.value == 10 && pp.fp == 1024.0, "Fiber::Switch round trips");
+        pool.Release(pp.self);
+        Test::Expect(pool.Available() == 2, "FiberPool::Release");
+        main.ReleaseFromThread();
+    }
+
+    void TestRunAndWait(JobSystem& jobs)
+    {
+        using namespace Drama;
+
+        JobCounter counter;
+        std::atomic<int> sum{ 0 };
+        for (int i = 1; i <= 1000; ++i)
+        {
+            jobs.Run(counter, [&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); });
+        }
+        jobs.Wait(counter);
+        Test::Expect(counter.IsDone() && sum.load() == 500500, "Run/Wait");
+
+        // ジョブの中からさらにジョブを積む(置き場とキューの容量を超える数)
+        std::atomic<int> leaves{ 0 };
+        for (int i = 0; i < 64; ++i)
+        {
+            jobs.Run(counter, [&jobs, &counter, &leaves]()
+                {
+                    for (int k = 0; k < 200; ++k)
+                    {
+                        jobs.Run(counter, [&leaves]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                });
+        }
+        jobs.Wait(counter);
+        Test::Expect(leaves.load() == 64 * 200, "nested Run");
+
+        // ワーカー以外のスレッドから積んで待つ(ジョブは共有のスラブから取る)
+        const uint64_t overflowBefore = jobs.Stats().heapJobs;
+        std::atomic<int> external{ 0 };
+        std::thread outsider([&]()
+            {
+                JobCounter c;
+                for (int i = 0; i < 100; ++i)
+                {
+                    jobs.Run(c, [&external]() { external.fetch_add(1, std::memory_order_relaxed); });
+                }
+                jobs.Wait(c);
+            });
+        outsider.join();
+        Test::Expect(external.load() == 100, "Run from outside thread");
+        Test::Expect(jobs.Stats().heapJobs - overflowBefore >= 100, "outside jobs use the overflow slab");
+    }
+
+    void TestDependencies(JobSystem& jobs)
+    {
+        using namespace Drama;
+
+        // a -> b -> c の順に実行される(b, c は前段の結果を読む)
+        JobCounter a;
+        JobCounter b;
+        JobCounter c;
+        std::vector<int> stage(64, 0);
+        std::atomic<bool> ordered{ true };
+        for (int i = 0; i < 64; ++i)
+        {
+            jobs.Run(a, [&stage, i]() { stage[i] = 1; });
+        }
+        for (int i = 0; i < 64; ++i)
+        {
+            jobs.RunAfter(a, b, [&stage, &ordered, i]()
+                {
+                    if (stage[i] != 1) ordered = false;
+                    stage[i] = 2;
+                });
+        }
+        jobs.RunAfter(b, c, [&stage, &ordered]()
+            {
+                for (int s : stage)
+                {
+                    if (s != 2) ordered = false;
+                }
+            });
+        jobs.Wait(c);
+        Test::Expect(ordered.load() && a.IsDone() && b.IsDone(), "RunAfter ordering");
+
+        // 依存先が既に終わっていれば、すぐ投入される
+        JobCounter d;
+        int ran = 0;
+        jobs.RunAfter(a, d, [&ran]() { ran = 1; });
+        jobs.Wait(d);
+        Test::Expect(ran == 1, "RunAfter(done dependency)");
+    }
+
+    /// @brief ジョブの中から子を積んで Wait する、を depth 段くり返す
+    uint32_t Chain(JobSystem& jobs, uint32_t depth)
+    {
+        if (depth == 0)
+        {
+            return 0;
+        }
+        JobCounter counter;
+        uint32_t below = 0;
+        jobs.Run(counter, [&jobs, &below, depth]() { below = Chain(jobs, depth - 1); });
+        jobs.Wait(counter);
+        return below + 1;
+    }
+
+    void TestDeepChains(JobSystem& jobs, uint32_t depth, bool fibers)
+    {
+        using namespace Drama;
+
+        // 子を待つジョブが深く重なる(ファイバーなら1段ごとに退避し、置き場が尽きたら待つ間に実行する)
+        const JobSystemStats before = jobs.Stats();
+        Test::Expect(Chain(jobs, depth) == depth, "deep Wait chain");
+        if (fibers)
+        {
+            Test::Expect(jobs.Stats().parks > before.parks, "Wait parks fibers");
+        }
+
+        // RunAfter だけでつないだ長い鎖は、各段が前段の完了を見てから動く
+        constexpr int kLinks = 2000;
+        std::vector<JobCounter> links(kLinks);
+        std::atomic<int> last{ -1 };
+        std::atomic<bool> ordered{ true };
+        for (int i = 0; i < kLinks; ++i)
+        {
+            auto body = [&last, &ordered, i]()
+                {
+                    if (last.exchange(i, std::memory_order_acq_rel) != i - 1) ordered = false;
+                };
+            if (i == 0)
+            {
+                jobs.Run(links[0], body);
+            }
+            else
+            {
+                jobs.RunAfter(links[i - 1], links[i], body);
+            }
+        }
+        jobs.Wait(links[kLinks - 1]);
+        Test::Expect(ordered.load() && last.load() == kLinks - 1, "RunAfter chain");
+
+        // 待っているジョブが多数あっても、後から積んだジョブで全部ほどける(扇状の依存)
+        JobCounter gate;
+        JobCounter waiters;
+        std::atomic<int> released{ 0 };
+        std::atomic<bool> open{ false };
+        jobs.Run(gate, [&open]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                open = true;
+            });
+        for (int i = 0; i < 32; ++i)
+        {
+            jobs.Run(waiters, [&jobs, &gate, &released, &open]()
+                {
+                    jobs.Wait(gate);
+                    if (open.load()) released.fetch_add(1);
+                });
+        }
+        jobs.Wait(waiters);
+        Test::Expect(released.load() == 32, "fan-in Wait");
+    }
+
+    void TestParallelFor(JobSystem& jobs)
+    {
+        using namespace Drama;
+
+        std::vector<uint32_t> data(100003);
+        std::iota(data.begin(), data.end(), 0u);
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<uint32_t> calls{ 0 };
+        jobs.ParallelFor(data.size(), [&](size_t begin, size_t end)
+            {
+                uint64_t local = 0;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    local += data[i];
+                }
+                sum.fetch_add(local, std::memory_order_relaxed);
+                calls.fetch_add(1, std::memory_order_relaxed);
+            });
+        const uint64_t n = data.size();
+        Test::Expect(sum.load() == n * (n - 1) / 2, "ParallelFor sum");
+        Test::Expect(calls.load() > 1, "ParallelFor splits");
+
+        // 粒度を指定すると、その件数以下の塊に分かれる
+        std::atomic<bool> withinGrain{ true };
+        std::vector<uint8_t> touched(1000, 0);
+        jobs.ParallelFor(touched.size(), [&](size_t begin, size_t end)
+            {
+                if (end - begin > 16) withinGrain = false;
+                for (size_t i = begin; i < end; ++i) ++touched[i];
+            }, 16);
+        Test::Expect(withinGrain.load(), "ParallelFor grain");
+        Test::Expect(std::all_of(touched.begin(), touched.end(), [](uint8_t t) { return t == 1; }), "ParallelFor covers range once");
+
+        int single = 0;
+        jobs.ParallelFor(0, [&](size_t, size_t) { ++single; });
+        jobs.ParallelFor(1, [&](size_t b, size_t e) { single += static_cast<int>(e - b); });
+        Test::Expect(single == 1, "ParallelFor(0/1)");
+        Test::Expect(jobs.AutoGrain(8) >= 1, "AutoGrain");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunJobSystemTests()
+    {
+        TestDeque();
+        TestFiberSwitch();
+
+        JobSystem jobs;
+        JobSystemDesc desc;
+        desc.threadCount = 4; // 1コアの環境でも盗み合いが起きるように固定
+        if (!Expect(jobs.Start(desc), "JobSystem::Start"))
+        {
+            return;
+        }
+        Expect(jobs.ThreadCount() == 4 && !jobs.Start(desc), "Start twice");
+        TestRunAndWait(jobs);
+        TestDependencies(jobs);
+        TestParallelFor(jobs);
+        TestDeepChains(jobs, 500, false);
+        jobs.Stop();
+        Expect(!jobs.IsRunning(), "Stop");
+
+        // ファイバーで実行する。退避は1段ごとにファイバーを1つ使うので、深い鎖の分だけ用意する
+        JobSystemDesc fiberDesc = desc;
+        fiberDesc.fiberCount = 600;
+        fiberDesc.fiberStackSize = 128 * 1024;
+        if (Expect(jobs.Start(fiberDesc), "Start(fibers)"))
+        {
+            TestRunAndWait(jobs);
+            TestDependencies(jobs);
+            TestParallelFor(jobs);
+            TestDeepChains(jobs, 500, true);
+            jobs.Stop();
+        }
+
+        // 置き場が尽きたら、尽きた段から先は待つ間に実行する方法に切り替わる
+        fiberDesc.fiberCount = 16;
+        if (Expect(jobs.Start(fiberDesc), "Start(few fibers)"))
+        {
+            TestDeepChains(jobs, 40, true);
+            jobs.Stop();
+        }
+
+        // 1スレッドでも、Wait で止まったジョブの先を同じワーカーが進められる
+        JobSystemDesc single;
+        single.threadCount = 1;
+        single.fiberCount = 16;
+        if (Expect(jobs.Start(single), "Start(single, fibers)"))
+        {
+            std::vector<int> order;
+            JobCounter outer;
+            jobs.Run(outer, [&jobs, &order]()
+                {
+                    JobCounter inner;
+                    jobs.Run(inner, [&order]() { order.push_back(2); });
+                    order.push_back(1);
+                    jobs.Wait(inner);
+                    order.push_back(3);
+                });
+            jobs.Wait(outer);
+            Expect(order == std::vector<int>{ 1, 2, 3 } && jobs.Stats().parks >= 2, "single-thread park/resume");
+            jobs.Stop();
+        }
+
+        // 止めた後も再開できる。Wait しなかったジョブは Stop で片付く
+        Expect(jobs.Start(desc), "restart");
+        JobCounter counter;
+        std::atomic<int> ran{ 0 };
+        for (int i = 0; i < 32; ++i)
+        {
+            jobs.Run(counter, [&ran]() { ran.fetch_add(1); });
+        }
+        jobs.Stop();
+        Expect(ran.load() == 32 && counter.IsDone(), "Stop drains");
+
+        // 止めた後はジョブを置く場所が無いので、積まずにその場で実行する
+        bool late = false;
+        jobs.Run(counter, [&late]() { late = true; });
+        Expect(late && counter.IsDone(), "Run after Stop runs inline");
+    }
+}
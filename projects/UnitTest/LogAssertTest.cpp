@@ -0,0 +1,370 @@
+#include "TestCommon.h"
+
+#include "Core/include/LogAssert.h"
+#include "Core/include/MemoryTracker.h"
+
+// C++ standard library includes
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /// @brief 全セグメントを古い順に連結して読む
+    std::string ReadLog(Drama::Core::IO::IFileSystem& fs)
+    {
+        std::string text;
+        for (const std::string& path : Drama::Core::LogAssert::SegmentPaths())
+        {
+            std::vector<uint8_t> bytes;
+            if (fs.ReadAllBytes(path, bytes))
+            {
+                text.append(bytes.begin(), bytes.end());
+            }
+        }
+        return text;
+    }
+
+    size_t CountLines(Drama::Core::IO::IFileSystem& fs)
+    {
+        const std::string text = ReadLog(fs);
+        size_t lines = 0;
+        for (char c : text)
+        {
+            if (c == '\n')
+            {
+                ++lines;
+            }
+        }
+        return lines;
+    }
+
+    /// @brief 前回の実行で残ったセグメントを消す
+    void RemoveSegments(Drama::Core::IO::IFileSystem& fs, const std::string& stem)
+    {
+        for (int slot = 0; slot < 64; ++slot)
+        {
+            fs.Remove(stem + "." + std::to_string(slot) + ".txt");
+        }
+    }
+
+    void TestAsyncWritesEveryLine(Drama::Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "async_log.txt";
+        RemoveSegments(fs, root + "async_log"); // 前回分を捨てる
+        Core::LogRotationDesc rotation{};
+        rotation.retainBytes = 64 * 1024 * 1024;
+        rotation.segmentBytes = 64 * 1024 * 1024;
+        Test::Expect(Core::LogAssert::Init(fs, path, rotation), "Init");
+
+        Core::AsyncLogDesc desc{};
+        desc.slotCount = 64; // 小さくして満杯時の待機も通す
+        desc.overflow = Core::LogOverflowPolicy::Block;
+        Test::Expect(Core::LogAssert::EnableAsync(desc), "EnableAsync");
+
+        constexpr int kThreads = 4;
+        constexpr int kLines = 500;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([t]()
+                {
+                    for (int i = 0; i < kLines; ++i)
+                    {
+                        Core::LogAssert::WriteLine("async " + std::to_string(t) + ":" + std::to_string(i));
+                    }
+                });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        // 1スロットに収まらない行も1行として書かれること
+        Core::LogAssert::WriteLine(std::string(1000, 'x'));
+
+        Test::Expect(Core::LogAssert::Flush(), "Flush");
+        Test::Expect(CountLines(fs) == kThreads * kLines + 1, "all async lines written");
+        Test::Expect(Core::LogAssert::DroppedLines() == 0, "Block policy never drops");
+        Core::LogAssert::Shutdown();
+
+        // 終了後は同期経路に戻る
+        Test::Expect(Core::LogAssert::WriteLine("sync again"), "sync WriteLine after Shutdown");
+        Test::Expect(CountLines(fs) == kThreads * kLines + 2, "sync line appended");
+    }
+
+    /// @brief 書き込み中に非同期モードを止めたり再開したりしても行を失わない
+    void TestStopWhileWriting(Drama::Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "restart_log.txt";
+        RemoveSegments(fs, root + "restart_log");
+        Core::LogRotationDesc rotation{};
+        rotation.retainBytes = 64 * 1024 * 1024;
+        rotation.segmentBytes = 64 * 1024 * 1024;
+        Test::Expect(Core::LogAssert::Init(fs, path, rotation), "Init restart");
+
+        Core::AsyncLogDesc desc{};
+        desc.slotCount = 64;
+        desc.overflow = Core::LogOverflowPolicy::Block;
+        constexpr int kThreads = 3;
+        constexpr int kLines = 2000;
+        std::atomic<int> failed{ 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([t, &failed]()
+                {
+                    for (int i = 0; i < kLines; ++i)
+                    {
+                        if (!Core::LogAssert::WriteLine("restart " + std::to_string(t) + ":" + std::to_string(i)))
+                        {
+                            failed.fetch_add(1);
+                        }
+                    }
+                });
+        }
+        // 生産者が積んでいる最中に止めて再開する(止めている間は同期書き込みになる)
+        for (int round = 0; round < 20; ++round)
+        {
+            Test::Expect(Core::LogAssert::EnableAsync(desc), "EnableAsync restart");
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            Core::LogAssert::Shutdown();
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        Test::Expect(failed.load() == 0, "every WriteLine succeeds across restarts");
+        Test::Expect(CountLines(fs) == kThreads * kLines, "no line is lost when async mode stops");
+    }
+
+    /// @brief 長さ付きレコードはスロットをまたいでもレコードの境目でしかバッチが切れない
+    void TestFramedRecords()
+    {
+        using namespace Drama;
+
+        std::atomic<size_t> records{ 0 };
+        std::atomic<bool> isIntact{ true };
+        Core::AsyncLogWriter writer;
+        Core::AsyncLogDesc desc{};
+        desc.slotCount = 8; // 小さくして途中までしか公開されていないレコードを作りやすくする
+        desc.overflow = Core::LogOverflowPolicy::Block;
+        desc.idleWaitMs = 1;
+        desc.isFramed = true;
+        Test::Expect(writer.Start(desc, [&](const char* data, size_t size, size_t count)
+            {
+                size_t at = 0;
+                size_t seen = 0;
+                while (at < size)
+                {
+                    uint32_t length = 0;
+                    std::memcpy(&length, data + at, sizeof(length));
+                    at += sizeof(length);
+                    // レコードは全て同じバイトで埋めてある
+                    const bool isWhole = length > 0 && size - at >= length &&
+                        std::string_view(data + at, length).find_first_not_of(data[at]) == std::string_view::npos;
+                    if (!isWhole)
+                    {
+                        isIntact.store(false);
+                        return false;
+                    }
+                    at += length;
+                    ++seen;
+                }
+                if (seen != count)
+                {
+                    isIntact.store(false);
+                }
+                records.fetch_add(seen);
+                return true;
+            }), "Start framed");
+
+        constexpr int kThreads = 3;
+        constexpr int kRecords = 300;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([t, &writer]()
+                {
+                    std::string frame;
+                    for (int i = 0; i < kRecords; ++i)
+                    {
+                        // 1スロット(240B)未満から3スロット分までの大きさ
+                        const uint32_t length = 1 + static_cast<uint32_t>((i * 37 + t * 11) % 700);
+                        frame.assign(sizeof(length), '\0');
+                        std::memcpy(frame.data(), &length, sizeof(length));
+                        frame.append(length, static_cast<char>('a' + t));
+                        writer.PushRecord(frame.data(), frame.size());
+                    }
+                });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        Test::Expect(writer.Flush(), "Flush framed");
+        Test::Expect(isIntact.load(), "batches end on record boundaries");
+        Test::Expect(records.load() == kThreads * kRecords, "every framed record written");
+
+        std::string huge(sizeof(uint32_t) + 8 * Core::MpscRingBuffer::kSlotPayload, 'h');
+        Test::Expect(writer.PushRecord(huge.data(), huge.size()) == Core::LogPushResult::Rejected, "record larger than ring is rejected");
+        writer.Stop();
+        Test::Expect(writer.PushRecord(huge.data(), 8) == Core::LogPushResult::Stopped, "PushRecord after Stop");
+    }
+
+#if DRAMA_MEMORY_TRACKING
+    /// @brief リングとバッチバッファは Log として数えられ、壊すと戻る
+    void TestMemoryTag()
+    {
+        using namespace Drama;
+        using Core::Memory::MemoryTag;
+        using Core::Memory::MemoryTracker;
+
+        MemoryTracker::Update(0);
+        const int64_t base = MemoryTracker::Stats(MemoryTag::Log).liveBytes;
+        {
+            Core::AsyncLogWriter writer;
+            Core::AsyncLogDesc desc{};
+            desc.slotCount = 16;
+            Test::Expect(writer.Start(desc, [](const char*, size_t, size_t) { return true; }), "Start tagged");
+            MemoryTracker::Update(1);
+            const int64_t ring = static_cast<int64_t>(16 * Core::MpscRingBuffer::kSlotSize);
+            const int64_t batch = static_cast<int64_t>(16 * Core::MpscRingBuffer::kSlotPayload);
+            Test::Expect(MemoryTracker::Stats(MemoryTag::Log).liveBytes - base >= ring + batch, "ring and batch are tagged Log");
+            writer.Stop();
+        }
+        MemoryTracker::Update(2);
+        Test::Expect(MemoryTracker::Stats(MemoryTag::Log).liveBytes == base, "log buffers are released");
+    }
+#endif
+
+    void TestSegmentRotation(Drama::Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "rotate_log.txt";
+        RemoveSegments(fs, root + "rotate_log");
+        Core::LogRotationDesc rotation{};
+        rotation.retainBytes = 128;
+        rotation.segmentBytes = 64;
+        Test::Expect(Core::LogAssert::Init(fs, path, rotation), "Init rotation");
+
+        for (int i = 0; i < 100; ++i)
+        {
+            Core::LogAssert::WriteLine("line " + std::to_string(i));
+        }
+
+        // 行の途中で分けないので、1セグメントは segmentBytes を超えない
+        bool withinSegment = true;
+        for (const std::string& segment : Core::LogAssert::SegmentPaths())
+        {
+            std::vector<uint8_t> bytes;
+            fs.ReadAllBytes(segment, bytes);
+            withinSegment = withinSegment && bytes.size() <= rotation.segmentBytes && bytes.back() == '\n';
+        }
+        Test::Expect(withinSegment, "segments split at line ends within segmentBytes");
+
+        const std::string text = ReadLog(fs);
+        const size_t maxLine = 8; // "line 99\n"
+        Test::Expect(text.size() + 2 * maxLine >= rotation.retainBytes, "keeps about retainBytes");
+        Test::Expect(text.size() <= rotation.retainBytes + 2 * rotation.segmentBytes, "drops whole old segments");
+        const size_t retained = Core::LogAssert::RetainedLines();
+        Test::Expect(CountLines(fs) == retained, "line count matches segment contents");
+        Test::Expect(text.size() >= 8 && text.substr(text.size() - 8) == "line 99\n", "newest line is last");
+
+        // 再初期化してもセグメントから行数と現在位置を作り直し、続きから書ける
+        Test::Expect(Core::LogAssert::Init(fs, path, rotation), "re-Init rotation");
+        Test::Expect(Core::LogAssert::RetainedLines() == retained, "line count rebuilt from segments");
+        Core::LogAssert::WriteLine("after reopen");
+        const std::string text2 = ReadLog(fs);
+        Test::Expect(text2.find("line 99\nafter reopen\n") != std::string::npos, "append continues after reopen");
+
+        // 切り替えで最古を消した直後に落ちた状態(空きが2つ続く)からも続けられる
+        const std::vector<std::string> before = Core::LogAssert::SegmentPaths();
+        fs.Remove(before.front());
+        Test::Expect(Core::LogAssert::Init(fs, path, rotation), "re-Init after interrupted roll");
+        Core::LogAssert::WriteLine("after crash");
+        const std::string text3 = ReadLog(fs);
+        Test::Expect(text3.size() > 25 && text3.substr(text3.size() - 25) == "after reopen\nafter crash\n",
+            "append continues after interrupted roll");
+
+        // セグメントより長い1行は分けずに丸ごと書く
+        const std::string longLine(200, 'L');
+        Core::LogAssert::WriteLine(longLine);
+        Core::LogAssert::WriteLine("tail");
+        const std::string text4 = ReadLog(fs);
+        Test::Expect(text4.find(longLine + "\ntail\n") != std::string::npos, "long line written whole");
+    }
+
+    /// @brief 旧形式の単一ファイルと索引は取り込んで消す
+    /// @brief 現在のセグメントが1つに決まらない状態からも、ログを消さずに最後に書かれたものの続きを書く
+    void TestAmbiguousSegments(Drama::Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string stem = root + "ambiguous_log";
+        RemoveSegments(fs, stem);
+        Core::LogRotationDesc rotation{};
+        rotation.retainBytes = 128;
+        rotation.segmentBytes = 64; // 4 セグメント
+
+        // 0 と 2 が「空でなく直後が空」。更新時刻で 2 の方が新しい
+        fs.WriteAllBytes(stem + ".0.txt", "old\n", 4);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        fs.WriteAllBytes(stem + ".2.txt", "new\n", 4);
+        Test::Expect(Core::LogAssert::Init(fs, stem + ".txt", rotation), "Init with two candidates");
+        Core::LogAssert::WriteLine("next");
+        Test::Expect(ReadLog(fs) == "old\nnew\nnext\n", "ambiguous segments are kept and the newest continues");
+        Test::Expect(Core::LogAssert::RetainedLines() == 3, "kept segments are counted");
+
+        // 全部埋まっている(セグメント数を減らした)なら、最後に書かれたものの次(最古)だけを空ける
+        RemoveSegments(fs, stem);
+        for (int slot : { 1, 2, 3, 0 })
+        {
+            const std::string line = "s" + std::to_string(slot) + "\n";
+            fs.WriteAllBytes(stem + "." + std::to_string(slot) + ".txt", line.data(), line.size());
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        Test::Expect(Core::LogAssert::Init(fs, stem + ".txt", rotation), "Init with every segment full");
+        Test::Expect(ReadLog(fs) == "s2\ns3\ns0\n", "only the oldest segment is dropped");
+    }
+
+    void TestLegacyMigration(Drama::Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        using namespace Drama;
+
+        const std::string path = root + "legacy_log.txt";
+        RemoveSegments(fs, root + "legacy_log");
+        fs.WriteAllBytes(path, "old 1\nold 2", 11);
+        fs.WriteAllBytes(root + "legacy_log.index", "stale", 5);
+
+        Test::Expect(Core::LogAssert::Init(fs, path), "Init legacy");
+        Test::Expect(fs.Exists(path).error == Core::IO::FsError::NotFound, "legacy log removed");
+        Test::Expect(fs.Exists(root + "legacy_log.index").error == Core::IO::FsError::NotFound, "legacy index removed");
+        Core::LogAssert::WriteLine("new 1");
+        Test::Expect(ReadLog(fs) == "old 1\nold 2\nnew 1\n", "legacy lines kept before new ones");
+        Test::Expect(Core::LogAssert::RetainedLines() == 3, "legacy lines counted");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunLogAssertTests(Core::IO::IFileSystem& fs, const std::string& root)
+    {
+        TestAsyncWritesEveryLine(fs, root);
+        TestStopWhileWriting(fs, root);
+        TestFramedRecords();
+#if DRAMA_MEMORY_TRACKING
+        TestMemoryTag();
+#endif
+        TestSegmentRotation(fs, root);
+        TestAmbiguousSegments(fs, root);
+        TestLegacyMigration(fs, root);
+    }
+}
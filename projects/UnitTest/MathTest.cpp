@@ -0,0 +1,206 @@
+#include "TestCommon.h"
+
+#include "Core/include/MathBatch.h"
+
+// C++ standard library includes
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::Math;
+
+    constexpr float kPi = 3.14159265358979f;
+
+    /// @brief 大きい値は相対、scale 以下は絶対で比べる
+    /// @param scale 途中の項の大きさ(打ち消し合って結果が小さくなっても誤差は項の大きさに比例する)
+    bool Near(float a, float b, float tolerance = 1e-5f, float scale = 1.0f) noexcept
+    {
+        return std::fabs(a - b) <= tolerance * std::fmax(scale, std::fmax(std::fabs(a), std::fabs(b)));
+    }
+    bool Near(Float3 a, Float3 b, float tolerance = 1e-5f, float scale = 1.0f) noexcept
+    {
+        return Near(a.x, b.x, tolerance, scale) && Near(a.y, b.y, tolerance, scale) && Near(a.z, b.z, tolerance, scale);
+    }
+    bool Near(const Float4x4& a, const Float4x4& b, float tolerance = 1e-5f, float scale = 1.0f) noexcept
+    {
+        const float* pa = &a.r[0].x;
+        const float* pb = &b.r[0].x;
+        for (int i = 0; i < 16; ++i)
+        {
+            if (!Near(pa[i], pb[i], tolerance, scale))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Quaternion RandomRotation(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+        return FromAxisAngle(Normalize(Float3{ d(rng), d(rng), d(rng) + 2.0f }), d(rng) * kPi);
+    }
+
+    Float4x4 RandomTransform(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+        return Compose(Float3{ 1.0f + 0.5f * d(rng), 1.0f + 0.5f * d(rng), 1.0f + 0.5f * d(rng) }, RandomRotation(rng),
+            Float3{ 100.0f * d(rng), 100.0f * d(rng), 100.0f * d(rng) });
+    }
+
+    void TestLayout()
+    {
+        using namespace Drama;
+
+        // HLSL 側の row_major float4x4 と同じ並び(平行移動は 12..14 番目)
+        const Float4x4 t = Translation(Float3{ 1, 2, 3 });
+        const float* raw = &t.r[0].x;
+        Test::Expect(raw[12] == 1.0f && raw[13] == 2.0f && raw[14] == 3.0f && raw[15] == 1.0f, "translation lives in the last row");
+        Test::Expect(alignof(Float4x4) == 16 && alignof(Quaternion) == 16 && alignof(Float3) == 4, "upload alignment");
+    }
+
+    void TestScalar()
+    {
+        using namespace Drama;
+
+        // 行ベクトル: p * (S * R * T) は拡縮 → 回転 → 平行移動
+        const Quaternion rot = FromAxisAngle(Float3{ 0, 0, 1 }, kPi * 0.5f);
+        const Float4x4 m = Scaling(Float3{ 2, 2, 2 }) * RotationMatrix(rot) * Translation(Float3{ 10, 0, 0 });
+        Test::Expect(Near(TransformPoint(Float3{ 1, 0, 0 }, m), Float3{ 10, 2, 0 }), "matrix order follows row vectors");
+        Test::Expect(Near(m, Compose(Float3{ 2, 2, 2 }, rot, Float3{ 10, 0, 0 })), "compose matches the product");
+        Test::Expect(Near(TransformVector(Float3{ 1, 0, 0 }, m), Float3{ 0, 2, 0 }), "vectors ignore translation");
+
+        std::mt19937 rng(7);
+        bool inverseOk = true;
+        bool rotateOk = true;
+        bool multiplyOk = true;
+        for (int i = 0; i < 100; ++i)
+        {
+            const Float4x4 a = RandomTransform(rng);
+            inverseOk = inverseOk && Near(a * Inverse(a), Identity(), 1e-4f);
+
+            const Quaternion q1 = RandomRotation(rng);
+            const Quaternion q2 = RandomRotation(rng);
+            const Float3 v{ 1, -2, 3 };
+            rotateOk = rotateOk && Near(Rotate(v, q1), TransformVector(v, RotationMatrix(q1)));
+            multiplyOk = multiplyOk && Near(RotationMatrix(q1 * q2), RotationMatrix(q1) * RotationMatrix(q2));
+        }
+        Test::Expect(inverseOk, "inverse of an affine transform");
+        Test::Expect(rotateOk, "quaternion rotation matches the matrix");
+        Test::Expect(multiplyOk, "quaternion product order matches matrices");
+
+        float det = 1.0f;
+        Test::Expect(Near(Inverse(Scaling(Float3{ 0, 1, 1 }), &det), Identity()) && det == 0.0f, "singular matrix reports zero determinant");
+
+        const Quaternion a = IdentityQuaternion();
+        const Quaternion b = FromAxisAngle(Float3{ 0, 1, 0 }, kPi * 0.5f);
+        const Quaternion mid = Slerp(a, b, 0.5f);
+        Test::Expect(Near(Rotate(Float3{ 1, 0, 0 }, mid), Float3{ std::cos(kPi * 0.25f), 0, -std::sin(kPi * 0.25f) }), "slerp halfway");
+        const Quaternion flipped{ -b.x, -b.y, -b.z, -b.w };
+        Test::Expect(Near(Rotate(Float3{ 1, 0, 0 }, Slerp(a, flipped, 0.5f)), Rotate(Float3{ 1, 0, 0 }, mid)), "slerp takes the short path");
+    }
+
+    /// @brief 使える全実装の結果を Scalar 実装と比べる
+    void TestBatchAccuracy()
+    {
+        using namespace Drama;
+
+        const BatchKernels* scalar = KernelsFor(SimdLevel::Scalar);
+        Test::Expect(scalar != nullptr && KernelsFor(CompiledSimdLevel()) != nullptr, "compiled level is available");
+
+        // 端数の処理も通るよう 8 の倍数にしない
+        constexpr size_t kCount = 1003;
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> d(-1000.0f, 1000.0f);
+        std::vector<float> px(kCount), py(kCount), pz(kCount);
+        std::vector<float> qx(kCount), qy(kCount), qz(kCount), qw(kCount);
+        std::vector<Float4x4> ma(kCount), mb(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+        {
+            px[i] = d(rng);
+            py[i] = d(rng);
+            pz[i] = d(rng);
+            qx[i] = d(rng);
+            qy[i] = d(rng);
+            qz[i] = d(rng);
+            qw[i] = d(rng);
+            ma[i] = RandomTransform(rng);
+            mb[i] = RandomTransform(rng);
+        }
+        // 長さ0の四元数は回転なしになる
+        qx[5] = qy[5] = qz[5] = qw[5] = 0.0f;
+        const Float4x4 m = RandomTransform(rng);
+
+        std::vector<float> ex(kCount), ey(kCount), ez(kCount);
+        scalar->transformPoints(m, ConstFloat3Stream(px.data(), py.data(), pz.data()), Float3Stream{ ex.data(), ey.data(), ez.data() }, kCount);
+        std::vector<Float4x4> em(kCount);
+        scalar->multiplyMatrices(ma.data(), mb.data(), em.data(), kCount);
+        std::vector<float> eqx = qx, eqy = qy, eqz = qz, eqw = qw;
+        scalar->normalizeQuaternions(QuaternionStream{ eqx.data(), eqy.data(), eqz.data(), eqw.data() }, kCount);
+        Test::Expect(eqx[5] == 0.0f && eqw[5] == 1.0f, "zero quaternion becomes identity");
+        Test::Expect(Near(TransformPoint(Float3{ px[3], py[3], pz[3] }, m), Float3{ ex[3], ey[3], ez[3] }, 1e-5f, 4000.0f) && Near(em[3], ma[3] * mb[3], 1e-5f, 200.0f),
+            "scalar kernels match single-value math");
+
+        for (uint8_t l = 0; l < static_cast<uint8_t>(SimdLevel::Count); ++l)
+        {
+            const BatchKernels* k = KernelsFor(static_cast<SimdLevel>(l));
+            if (!k)
+            {
+                continue;
+            }
+            const std::string name = SimdLevelName(k->level);
+
+            std::vector<float> ox(kCount), oy(kCount), oz(kCount);
+            k->transformPoints(m, ConstFloat3Stream(px.data(), py.data(), pz.data()), Float3Stream{ ox.data(), oy.data(), oz.data() }, kCount);
+            bool pointsOk = true;
+            for (size_t i = 0; i < kCount; ++i)
+            {
+                const float scale = 2.0f * (std::fabs(px[i]) + std::fabs(py[i]) + std::fabs(pz[i])) + 100.0f;
+                pointsOk = pointsOk && Near(Float3{ ox[i], oy[i], oz[i] }, Float3{ ex[i], ey[i], ez[i] }, 1e-5f, scale);
+            }
+            Test::Expect(pointsOk, name + ": transform points matches scalar");
+
+            std::vector<Float4x4> om(kCount);
+            k->multiplyMatrices(ma.data(), mb.data(), om.data(), kCount);
+            bool matricesOk = true;
+            for (size_t i = 0; i < kCount; ++i)
+            {
+                matricesOk = matricesOk && Near(om[i], em[i], 1e-5f, 200.0f);
+            }
+            Test::Expect(matricesOk, name + ": multiply matrices matches scalar");
+
+            // 出力を入力に重ねてもよい
+            std::vector<Float4x4> inPlace = ma;
+            k->multiplyMatrices(inPlace.data(), mb.data(), inPlace.data(), kCount);
+            Test::Expect(Near(inPlace[kCount - 1], em[kCount - 1], 1e-5f, 200.0f), name + ": multiply matrices in place");
+
+            std::vector<float> nx = qx, ny = qy, nz = qz, nw = qw;
+            k->normalizeQuaternions(QuaternionStream{ nx.data(), ny.data(), nz.data(), nw.data() }, kCount);
+            bool quatOk = true;
+            for (size_t i = 0; i < kCount; ++i)
+            {
+                quatOk = quatOk && Near(nx[i], eqx[i]) && Near(ny[i], eqy[i]) && Near(nz[i], eqz[i]) && Near(nw[i], eqw[i]);
+            }
+            Test::Expect(quatOk && nx[5] == 0.0f && nw[5] == 1.0f, name + ": normalize quaternions matches scalar");
+        }
+
+        // 既定の関数はコンパイル時に選んだ実装
+        std::vector<float> ox(kCount), oy(kCount), oz(kCount);
+        Batch::TransformPoints(m, ConstFloat3Stream(px.data(), py.data(), pz.data()), Float3Stream{ ox.data(), oy.data(), oz.data() }, kCount);
+        Test::Expect(Near(Float3{ ox[kCount - 1], oy[kCount - 1], oz[kCount - 1] }, Float3{ ex[kCount - 1], ey[kCount - 1], ez[kCount - 1] }, 1e-5f, 4000.0f),
+            "batch entry points");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunMathTests()
+    {
+        TestLayout();
+        TestScalar();
+        TestBatchAccuracy();
+    }
+}
@@ -0,0 +1,273 @@
+#include "TestCommon.h"
+
+#include "Core/include/FrameAllocator.h"
+#include "Core/include/MemoryTracker.h"
+
+// C++ standard library includes
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Drama::Core::Memory::MemorySnapshot;
+    using Drama::Core::Memory::MemoryTag;
+    using Drama::Core::Memory::MemoryTracker;
+    using Drama::Core::Memory::TagStats;
+
+    void TestDiffOnly()
+    {
+        using namespace Drama;
+
+        // Diff は追跡の有無に関わらず、渡したスナップショットだけで計算する
+        MemorySnapshot before{};
+        MemorySnapshot after{};
+        before.sequence = 2;
+        before.tags[static_cast<size_t>(MemoryTag::IO)].liveBytes = 100;
+        before.tags[static_cast<size_t>(MemoryTag::IO)].allocations = 3;
+        before.tags[static_cast<size_t>(MemoryTag::IO)].frees = 1;
+        after.tags[static_cast<size_t>(MemoryTag::IO)].liveBytes = 40;
+        after.tags[static_cast<size_t>(MemoryTag::IO)].allocations = 5;
+        after.tags[static_cast<size_t>(MemoryTag::IO)].frees = 5;
+        after.records = { { nullptr, 8, MemoryTag::IO, 1, 0 }, { nullptr, 16, MemoryTag::IO, 3, 0 }, { nullptr, 32, MemoryTag::Log, 4, 0 } };
+
+        const auto diff = MemoryTracker::Diff(before, after);
+        Test::Expect(diff.liveBytesDelta[static_cast<size_t>(MemoryTag::IO)] == -60, "diff live bytes");
+        Test::Expect(diff.allocationDelta[static_cast<size_t>(MemoryTag::IO)] == -2, "diff outstanding allocations");
+        Test::Expect(diff.leaked.size() == 2 && diff.leaked[0].size == 16 && diff.leaked[1].tag == MemoryTag::Log,
+            "records after the first snapshot are leak candidates");
+    }
+
+#if DRAMA_MEMORY_TRACKING
+    struct BudgetCall
+    {
+        static inline int s_Count = 0;
+        static inline MemoryTag s_Tag = MemoryTag::Unknown;
+        static inline int64_t s_Live = 0;
+        static void Handler(MemoryTag tag, int64_t live, int64_t)
+        {
+            ++s_Count;
+            s_Tag = tag;
+            s_Live = live;
+        }
+        /// @brief 通知の中から集計を読む(通知をロックの外で送っていなければ止まる)
+        static void ReadingHandler(MemoryTag tag, int64_t live, int64_t budget)
+        {
+            Handler(tag, live, budget);
+            s_Live = MemoryTracker::Stats(tag).liveBytes;
+        }
+    };
+
+    void TestCounters()
+    {
+        using namespace Drama;
+
+        // 他のテストの分が残っていてもよいよう、差で確かめる
+        MemoryTracker::Update(0);
+        const TagStats base = MemoryTracker::Stats(MemoryTag::Assets);
+
+        void* a = Core::Memory::TrackedAllocate(MemoryTag::Assets, 1000);
+        void* b = Core::Memory::TrackedAllocate(MemoryTag::Assets, 24, 64);
+        Test::Expect(a && b && (reinterpret_cast<uintptr_t>(b) & 63) == 0, "tracked allocate");
+        // Update するまで集計は変わらない
+        Test::Expect(MemoryTracker::Stats(MemoryTag::Assets).liveBytes == base.liveBytes, "stats change only on Update");
+        MemoryTracker::Update(1);
+        TagStats s = MemoryTracker::Stats(MemoryTag::Assets);
+        Test::Expect(s.liveBytes - base.liveBytes == 1024 && s.allocations - base.allocations == 2, "live bytes and count");
+
+        Core::Memory::TrackedFree(MemoryTag::Assets, a, 1000);
+        Core::Memory::TrackedFree(MemoryTag::Assets, b, 24, 64);
+        MemoryTracker::Update(2);
+        s = MemoryTracker::Stats(MemoryTag::Assets);
+        Test::Expect(s.liveBytes == base.liveBytes && s.frees - base.frees == 2, "free returns the bytes");
+        Test::Expect(s.peakBytes >= base.liveBytes + 1024, "peak is kept after free");
+
+        // 別スレッドで確保してこちらで解放しても合計は合う
+        void* p = nullptr;
+        std::thread([&p] { p = Core::Memory::TrackedAllocate(MemoryTag::Assets, 4096); }).join();
+        MemoryTracker::Update(3);
+        Test::Expect(MemoryTracker::Stats(MemoryTag::Assets).liveBytes - base.liveBytes == 4096, "counters of exited threads stay");
+        Core::Memory::TrackedFree(MemoryTag::Assets, p, 4096);
+        MemoryTracker::Update(4);
+        Test::Expect(MemoryTracker::Stats(MemoryTag::Assets).liveBytes == base.liveBytes, "cross-thread free");
+    }
+
+    void TestConcurrent()
+    {
+        using namespace Drama;
+
+        MemoryTracker::Update(0);
+        const TagStats base = MemoryTracker::Stats(MemoryTag::Job);
+        constexpr int kThreads = 4;
+        constexpr int kIterations = 20000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([] {
+                for (int i = 0; i < kIterations; ++i)
+                {
+                    MemoryTracker::RecordAllocation(MemoryTag::Job, nullptr, 16);
+                    MemoryTracker::RecordFree(MemoryTag::Job, nullptr, 16);
+                }
+                MemoryTracker::RecordAllocation(MemoryTag::Job, nullptr, 100);
+            });
+        }
+        // 書き込み中に合計を取っても壊れない
+        for (int i = 0; i < 100; ++i)
+        {
+            MemoryTracker::Update(static_cast<uint64_t>(i));
+        }
+        for (std::thread& th : threads)
+        {
+            th.join();
+        }
+        MemoryTracker::Update(0);
+        const TagStats s = MemoryTracker::Stats(MemoryTag::Job);
+        Test::Expect(s.liveBytes - base.liveBytes == kThreads * 100, "concurrent live bytes");
+        Test::Expect(s.allocations - base.allocations == static_cast<uint64_t>(kThreads) * (kIterations + 1), "concurrent allocation count");
+        for (int t = 0; t < kThreads; ++t)
+        {
+            MemoryTracker::RecordFree(MemoryTag::Job, nullptr, 100);
+        }
+    }
+
+    void TestBudget()
+    {
+        using namespace Drama;
+
+        MemoryTracker::Update(0);
+        const int64_t base = MemoryTracker::Stats(MemoryTag::Render).liveBytes;
+        MemoryTracker::SetBudgetHandler(&BudgetCall::Handler);
+        MemoryTracker::SetBudget(MemoryTag::Render, base + 1000);
+
+        MemoryTracker::RecordAllocation(MemoryTag::Render, nullptr, 800);
+        MemoryTracker::Update(1);
+        Test::Expect(BudgetCall::s_Count == 0, "under budget is silent");
+
+        MemoryTracker::RecordAllocation(MemoryTag::Render, nullptr, 800);
+        MemoryTracker::Update(2);
+        MemoryTracker::Update(3);
+        Test::Expect(BudgetCall::s_Count == 1 && BudgetCall::s_Tag == MemoryTag::Render && BudgetCall::s_Live == base + 1600,
+            "over budget warns once");
+        Test::Expect(MemoryTracker::Stats(MemoryTag::Render).budgetBytes == base + 1000, "budget is reported");
+
+        // 下回ってから再び超えると、もう一度通知する
+        MemoryTracker::RecordFree(MemoryTag::Render, nullptr, 800);
+        MemoryTracker::Update(4);
+        MemoryTracker::RecordAllocation(MemoryTag::Render, nullptr, 800);
+        MemoryTracker::Update(5);
+        Test::Expect(BudgetCall::s_Count == 2, "re-armed after dropping below budget");
+
+        // 通知先から Stats や Capture を呼んでも止まらない
+        MemoryTracker::RecordFree(MemoryTag::Render, nullptr, 800);
+        MemoryTracker::Update(6);
+        MemoryTracker::SetBudgetHandler(&BudgetCall::ReadingHandler);
+        MemoryTracker::RecordAllocation(MemoryTag::Render, nullptr, 800);
+        MemoryTracker::Update(7);
+        Test::Expect(BudgetCall::s_Count == 3 && BudgetCall::s_Live == base + 1600, "handler may read the stats");
+
+        MemoryTracker::RecordFree(MemoryTag::Render, nullptr, 1600);
+        MemoryTracker::SetBudget(MemoryTag::Render, 0);
+        MemoryTracker::SetBudgetHandler(nullptr);
+        MemoryTracker::Update(8);
+    }
+
+    void TestSnapshotLeaks()
+    {
+        using namespace Drama;
+
+        MemoryTracker::EnableAllocationRecords(true);
+        void* kept = Core::Memory::TrackedAllocate(MemoryTag::IO, 64);
+        const MemorySnapshot before = MemoryTracker::Capture();
+
+        void* freed = Core::Memory::TrackedAllocate(MemoryTag::IO, 128);
+        void* leaked = Core::Memory::TrackedAllocate(MemoryTag::IO, 256);
+        Core::Memory::TrackedFree(MemoryTag::IO, freed, 128);
+        const MemorySnapshot after = MemoryTracker::Capture();
+        MemoryTracker::EnableAllocationRecords(false);
+
+        const auto diff = MemoryTracker::Diff(before, after);
+        Test::Expect(diff.liveBytesDelta[static_cast<size_t>(MemoryTag::IO)] == 256, "snapshot diff bytes");
+        Test::Expect(diff.leaked.size() == 1 && diff.leaked[0].address == leaked && diff.leaked[0].size == 256,
+            "only the allocation that outlived the range is reported");
+
+        // 記録を止めた後の解放でも記録は消える
+        Core::Memory::TrackedFree(MemoryTag::IO, leaked, 256);
+        Core::Memory::TrackedFree(MemoryTag::IO, kept, 64);
+        Test::Expect(MemoryTracker::Capture().records.empty(), "records are dropped on free");
+
+        // 表を何度か広げ、ばらばらの順に消しても残りを正しく引ける
+        MemoryTracker::EnableAllocationRecords(true);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 5000; ++i)
+        {
+            blocks.push_back(Core::Memory::TrackedAllocate(MemoryTag::IO, 16));
+        }
+        for (size_t i = 0; i < blocks.size(); i += 2)
+        {
+            Core::Memory::TrackedFree(MemoryTag::IO, blocks[i], 16);
+        }
+        const MemorySnapshot half = MemoryTracker::Capture();
+        MemoryTracker::EnableAllocationRecords(false);
+        bool oddOnly = half.records.size() == blocks.size() / 2 && half.droppedRecords == 0;
+        for (const auto& record : half.records)
+        {
+            oddOnly = oddOnly && (std::find(blocks.begin(), blocks.end(), record.address) - blocks.begin()) % 2 == 1;
+        }
+        Test::Expect(oddOnly, "records survive table growth and erase");
+        for (size_t i = 1; i < blocks.size(); i += 2)
+        {
+            Core::Memory::TrackedFree(MemoryTag::IO, blocks[i], 16);
+        }
+        Test::Expect(MemoryTracker::Capture().records.empty(), "all records are erased");
+    }
+
+    void TestAllocatorTags()
+    {
+        using namespace Drama;
+
+        // FrameAllocator のブロックは Frame として数えられ、Release で戻る
+        MemoryTracker::Update(0);
+        const int64_t base = MemoryTracker::Stats(MemoryTag::Frame).liveBytes;
+        {
+            Core::Memory::LinearArena arena(4096);
+            arena.Allocate(100);
+            arena.Allocate(10000);
+            MemoryTracker::Update(1);
+            Test::Expect(MemoryTracker::Stats(MemoryTag::Frame).liveBytes - base == static_cast<int64_t>(arena.ReservedBytes()),
+                "arena blocks are tagged");
+        }
+        MemoryTracker::Update(2);
+        Test::Expect(MemoryTracker::Stats(MemoryTag::Frame).liveBytes == base, "arena release is tracked");
+    }
+#else
+    void TestDisabled()
+    {
+        using namespace Drama;
+
+        // 無効時は記録しても何も残らない
+        void* p = Core::Memory::TrackedAllocate(MemoryTag::Assets, 64);
+        MemoryTracker::Update(1);
+        Test::Expect(p != nullptr && MemoryTracker::Stats(MemoryTag::Assets).liveBytes == 0, "tracking compiles out");
+        Core::Memory::TrackedFree(MemoryTag::Assets, p, 64);
+    }
+#endif
+}
+
+namespace Drama::Test
+{
+    void RunMemoryTrackerTests()
+    {
+        TestDiffOnly();
+#if DRAMA_MEMORY_TRACKING
+        TestCounters();
+        TestConcurrent();
+        TestBudget();
+        TestSnapshotLeaks();
+        TestAllocatorTags();
+#else
+        TestDisabled();
+#endif
+    }
+}
@@ -0,0 +1,130 @@
+#include "TestCommon.h"
+
+#include "Platform/include/Profiler.h"
+
+// C++ standard library includes
+#include <string>
+#include <thread>
+
+namespace
+{
+    using Drama::Platform::Profile::CaptureDesc;
+    using Drama::Platform::Profile::Profiler;
+    using Drama::Platform::Profile::Zone;
+
+    size_t CountOf(const std::string& text, const std::string& needle)
+    {
+        size_t n = 0;
+        for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size()))
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    void TestCapture()
+    {
+        using namespace Drama;
+
+        // 計測していない間の区間は記録しない
+        Profiler::Stop();
+        {
+            Zone ignored("Ignored");
+        }
+
+        Profiler::Start();
+        Profiler::SetThreadName("TestMain");
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            Profiler::FrameMark();
+            Zone outer("Outer");
+            {
+                Zone inner("Inner \"quoted\"");
+                Profiler::Counter("Value", frame * 1.5);
+            }
+        }
+        Profiler::FrameMark();
+        std::thread worker([]()
+            {
+                Profiler::SetThreadName("TestWorker");
+                Zone zone("Worker");
+            });
+        worker.join();
+        Profiler::Stop();
+
+        const Platform::Profile::CaptureStats stats = Profiler::Stats();
+        Test::Expect(stats.threads == 2, "two threads recorded");
+        Test::Expect(stats.events == 4 + 3 * 3 + 1 && stats.droppedEvents == 0, "event count");
+        Test::Expect(stats.frames == 4, "frame count");
+
+        std::string json;
+        Profiler::ExportChromeTrace(json);
+        Test::Expect(json.rfind("{\"displayTimeUnit\"", 0) == 0 && json.find("]}") != std::string::npos, "trace is a JSON object");
+        Test::Expect(json.find("Ignored") == std::string::npos, "zones outside a capture are not recorded");
+        Test::Expect(CountOf(json, "\"name\":\"Outer\",\"ph\":\"X\"") == 3, "outer zones");
+        Test::Expect(CountOf(json, "Inner \\\"quoted\\\"") == 3, "names are escaped");
+        Test::Expect(CountOf(json, "\"ph\":\"C\"") == 3 && json.find("\"value\":3}") != std::string::npos, "counters");
+        Test::Expect(json.find("\"name\":\"TestMain\"") != std::string::npos &&
+            json.find("\"name\":\"TestWorker\"") != std::string::npos, "thread names");
+        Test::Expect(CountOf(json, "\"s\":\"g\"") == 4 && json.find("\"name\":\"Frames\"") != std::string::npos, "frame markers");
+
+        // 入れ子は外側が先に並ぶ(Inner は Outer の後ろ)
+        Test::Expect(json.find("\"Outer\"") < json.find("Inner"), "outer zone comes before its child");
+    }
+
+    void TestRestartAndLimit()
+    {
+        using namespace Drama;
+
+        // やり直すと前回の記録は消える。上限を超えた分は捨てて数える
+        CaptureDesc desc;
+        desc.maxEventsPerThread = 5000;
+        Profiler::Start(desc);
+        for (int i = 0; i < 6000; ++i)
+        {
+            Zone zone("Many");
+        }
+        Profiler::Stop();
+        const Platform::Profile::CaptureStats stats = Profiler::Stats();
+        Test::Expect(stats.threads == 1 && stats.events == 5000 && stats.droppedEvents == 1000, "per-thread limit");
+        Test::Expect(stats.frames == 0, "frame count restarts");
+
+        std::string json;
+        Profiler::ExportChromeTrace(json);
+        Test::Expect(json.find("Outer") == std::string::npos && CountOf(json, "\"Many\"") == 5000, "previous capture is discarded");
+    }
+
+#if DRAMA_PROFILE
+    void TestMacros()
+    {
+        using namespace Drama;
+
+        Profiler::Start();
+        {
+            DRAMA_PROFILE_ZONE("Macro");
+            DRAMA_PROFILE_ZONE("Macro2");
+            DRAMA_PROFILE_COUNTER("MacroCounter", 7);
+        }
+        Profiler::Stop();
+        Test::Expect(Profiler::Stats().events == 3, "macros record");
+    }
+#else
+    void TestMacros()
+    {
+        // 無効時は引数も評価されない
+        int evaluated = 0;
+        DRAMA_PROFILE_COUNTER("Unused", ++evaluated);
+        Drama::Test::Expect(evaluated == 0, "disabled macros compile out");
+    }
+#endif
+}
+
+namespace Drama::Test
+{
+    void RunProfilerTests()
+    {
+        TestCapture();
+        TestRestartAndLimit();
+        TestMacros();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+// C++ standard library includes
+#include <cstdio>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include "Core/include/IFileSystem.h"
+#include "Core/include/IFileWatcher.h"
+
+namespace Drama::Test
+{
+    /// @brief 失敗件数(mainで集計する)
+    inline int& FailureCount() noexcept
+    {
+        static int count = 0;
+        return count;
+    }
+
+    /// @brief 条件を検査し、失敗なら場所を出力する
+    inline bool Expect(bool condition, std::string_view what,
+        std::source_location loc = std::source_location::current())
+    {
+        if (!condition)
+        {
+            ++FailureCount();
+            std::printf("[FAIL] %s:%u %.*s\n", loc.file_name(), static_cast<unsigned>(loc.line()),
+                static_cast<int>(what.size()), what.data());
+        }
+        return condition;
+    }
+
+    // 各テスト群。rootは末尾'/'付きの作業ディレクトリ。
+    void RunLogAssertTests(Core::IO::IFileSystem& fs, const std::string& root);
+    void RunBinaryLogTests();
+    /// @brief IFileSystem 実装の共通仕様テスト。どの実装を渡しても通ること
+    void RunFileSystemConformanceTests(Core::IO::IFileSystem& fs, const std::string& root);
+    void RunAsyncFileServiceTests(Core::IO::IFileSystem& fs, const std::string& root);
+    void RunArchiveFileSystemTests(Core::IO::IFileSystem& fs, const std::string& root);
+    void RunCompressionTests(Core::IO::IFileSystem& fs, const std::string& root);
+    /// @brief watcher は debounce を短く(数十ms)して渡すこと
+    void RunFileWatcherTests(Core::IO::IFileWatcher& watcher, Core::IO::IFileSystem& fs, const std::string& root);
+    void RunJobSystemTests();
+    void RunFramePipelineTests();
+    void RunHeadlessWindowTests();
+    void RunFrameClockTests();
+    void RunTscClockTests();
+    void RunProfilerTests();
+    void RunFrameAllocatorTests();
+    void RunHandlePoolTests();
+    void RunMemoryTrackerTests();
+    void RunEcsTests();
+    void RunMathTests();
+    void RunTransformHierarchyTests();
+    void RunFrustumCullingTests();
+    void RunDynamicBvhTests();
+}
@@ -0,0 +1,170 @@
+#include "TestCommon.h"
+
+#include "Core/include/JobSystem.h"
+#include "Core/include/TransformHierarchy.h"
+
+// C++ standard library includes
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace Drama::Core::Math;
+    using Drama::Core::Scene::TransformHierarchy;
+    using Drama::Core::Scene::TransformNode;
+
+    bool Near(const Float4x4& a, const Float4x4& b) noexcept
+    {
+        const float* pa = &a.r[0].x;
+        const float* pb = &b.r[0].x;
+        for (int i = 0; i < 16; ++i)
+        {
+            if (std::fabs(pa[i] - pb[i]) > 1e-3f * std::fmax(1.0f, std::fabs(pb[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief 親を再帰でたどって計算したワールド行列(比較用)
+    Float4x4 ReferenceWorld(const TransformHierarchy& h, TransformNode node)
+    {
+        const TransformNode parent = h.Parent(node);
+        return parent.IsValid() ? Multiply(*h.Local(node), ReferenceWorld(h, parent)) : *h.Local(node);
+    }
+
+    void TestBasics()
+    {
+        using namespace Drama;
+
+        TransformHierarchy h;
+        const TransformNode root = h.Create({}, Translation(Float3{ 10, 0, 0 }));
+        const TransformNode child = h.Create(root, Translation(Float3{ 0, 5, 0 }));
+        const TransformNode grandchild = h.Create(child, Scaling(Float3{ 2, 2, 2 }));
+        const TransformNode other = h.Create();
+        h.Update();
+        Test::Expect(h.NodeCount() == 4 && h.LevelCount() == 3 && h.Validate() && h.LastUpdatedCount() == 4, "create builds levels");
+        Test::Expect(Near(*h.World(grandchild), Compose(Float3{ 2, 2, 2 }, IdentityQuaternion(), Float3{ 10, 5, 0 })), "world composes parents");
+        Test::Expect(h.IndexOf(root) < h.IndexOf(child) && h.IndexOf(child) < h.IndexOf(grandchild), "parents come before children");
+
+        // 変えた部分木だけを計算し直す
+        h.Update();
+        Test::Expect(h.LastUpdatedCount() == 0, "clean update does nothing");
+        h.SetLocal(grandchild, Translation(Float3{ 1, 1, 1 }));
+        h.SetLocal(grandchild, Translation(Float3{ 0, 0, 1 }));
+        h.Update();
+        Test::Expect(h.LastUpdatedCount() == 1 && Near(*h.World(grandchild), Translation(Float3{ 10, 5, 1 })), "leaf change recomputes only the leaf");
+        h.SetLocal(root, Float3{ 1, 1, 1 }, IdentityQuaternion(), Float3{ 0, 0, 0 });
+        h.SetLocal(child, Translation(Float3{ 0, 6, 0 }));
+        h.Update();
+        Test::Expect(h.LastUpdatedCount() == 3 && Near(*h.World(grandchild), Translation(Float3{ 0, 6, 1 })), "root change recomputes the subtree once");
+        Test::Expect(Near(*h.World(other), Identity()), "unrelated roots are untouched");
+
+        // 付け替え: 見た目の位置を保つ / 循環は拒む
+        const Float4x4 before = *h.World(grandchild);
+        Test::Expect(h.SetParent(grandchild, other, true), "reparent");
+        h.SetLocal(other, Translation(Float3{ -3, 0, 0 }));
+        h.Update();
+        Test::Expect(h.Parent(grandchild) == other && h.LevelCount() == 2 && h.Validate(), "reparent moves the node to its new level");
+        Test::Expect(Near(*h.World(grandchild), Multiply(before, Translation(Float3{ -3, 0, 0 }))), "keepWorld preserves the old world transform");
+        Test::Expect(!h.SetParent(root, child) && !h.SetParent(root, root), "cycles are rejected");
+
+        // 部分木ごと破棄
+        Test::Expect(h.Destroy(root) && !h.IsAlive(child) && h.IsAlive(grandchild) && h.NodeCount() == 2 && h.Validate(), "destroy removes the subtree");
+        Test::Expect(!h.Destroy(root) && h.World(child) == nullptr && !h.Create(child).IsValid(), "stale handles are rejected");
+        const TransformNode reused = h.Create();
+        Test::Expect(reused.index == child.index || reused.index == root.index, "slots are recycled");
+        h.Clear();
+        Test::Expect(h.NodeCount() == 0 && !h.IsAlive(reused) && h.Validate(), "clear");
+    }
+
+    /// @brief 作成・破棄・付け替え・変更を混ぜて、毎回すべてのノードを再帰計算と比べる
+    void TestRandomEdits(Drama::Core::Job::JobSystem* jobs)
+    {
+        using namespace Drama;
+
+        TransformHierarchy h;
+        std::mt19937 rng(jobs ? 5 : 9);
+        std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+        auto randomLocal = [&]()
+            {
+                return Compose(Float3{ 1.0f + 0.01f * d(rng), 1.0f + 0.01f * d(rng), 1.0f + 0.01f * d(rng) },
+                    FromAxisAngle(Normalize(Float3{ d(rng), d(rng), 1.0f }), d(rng)), Float3{ d(rng), d(rng), d(rng) });
+            };
+        std::vector<TransformNode> nodes;
+        for (int i = 0; i < 20000; ++i)
+        {
+            // 幅の広い段(並列に分かれる)と深い鎖が混ざるよう、半分は全体から、半分は最近作ったものから親を選ぶ
+            TransformNode parent{};
+            if (!nodes.empty() && i % 50 != 0)
+            {
+                parent = i % 2 == 0 ? nodes[rng() % nodes.size()] : nodes[nodes.size() - 1 - rng() % std::min<size_t>(nodes.size(), 8)];
+            }
+            nodes.push_back(h.Create(parent, randomLocal()));
+        }
+
+        bool valid = true;
+        bool matches = true;
+        for (int round = 0; round < 20; ++round)
+        {
+            for (int op = 0; op < 200; ++op)
+            {
+                const TransformNode n = nodes[rng() % nodes.size()];
+                switch (rng() % 8)
+                {
+                case 0:
+                    h.SetParent(n, rng() % 4 == 0 ? TransformNode{} : nodes[rng() % nodes.size()], rng() % 2 == 0);
+                    break;
+                case 1:
+                    if (rng() % 16 == 0)
+                    {
+                        h.Destroy(n);
+                    }
+                    break;
+                case 2:
+                    nodes.push_back(h.Create(h.IsAlive(n) ? n : TransformNode{}, randomLocal()));
+                    break;
+                default:
+                    h.SetLocal(n, randomLocal());
+                    break;
+                }
+            }
+            if (jobs)
+            {
+                h.Update(*jobs);
+            }
+            else
+            {
+                h.Update();
+            }
+            valid = valid && h.Validate();
+            for (const TransformNode n : nodes)
+            {
+                if (h.IsAlive(n))
+                {
+                    matches = matches && Near(*h.World(n), ReferenceWorld(h, n));
+                }
+            }
+        }
+        Test::Expect(valid, jobs ? "random edits keep the order valid (parallel)" : "random edits keep the order valid");
+        Test::Expect(matches, jobs ? "random edits match recursive reference (parallel)" : "random edits match recursive reference");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunTransformHierarchyTests()
+    {
+        TestBasics();
+        TestRandomEdits(nullptr);
+
+        Core::Job::JobSystem jobs;
+        Core::Job::JobSystemDesc desc{};
+        desc.threadCount = 4;
+        Test::Expect(jobs.Start(desc), "job system starts");
+        TestRandomEdits(&jobs);
+        jobs.Stop();
+    }
+}
@@ -0,0 +1,100 @@
+#include "TestCommon.h"
+
+#include "Platform/include/Timer.h"
+#include "Platform/include/TscClock.h"
+
+// C++ standard library includes
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    using Drama::Platform::SteadyClock;
+    using Drama::Platform::TscClock;
+
+    int64_t SteadyNs() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count();
+    }
+
+    void TestCalibration()
+    {
+        using namespace Drama;
+
+        const TscClock::Calibration& c = TscClock::Params();
+        Test::Expect(c.nanosecondsPerTick > 0.0 && c.ticksPerSecond > 0.0, "calibration is positive");
+        Test::Expect(std::abs(c.nanosecondsPerTick * c.ticksPerSecond - 1e9) < 1.0, "ns/tick and ticks/s agree");
+        if (!c.useTsc)
+        {
+            Test::Expect(c.nanosecondsPerTick == 1.0 && c.baseTicks == 0 && c.baseNanoseconds == 0, "fallback is identity");
+        }
+
+        // 同じスレッドで読む限り戻らない
+        uint64_t prev = TscClock::Ticks();
+        bool monotonic = true;
+        for (int i = 0; i < 100000; ++i)
+        {
+            const uint64_t t = (i & 1) ? TscClock::Ticks() : TscClock::TicksOrdered();
+            monotonic = monotonic && (t >= prev);
+            prev = t;
+        }
+        Test::Expect(monotonic, "Ticks is monotonic");
+    }
+
+    void TestAgainstSteady()
+    {
+        using namespace Drama;
+
+        // 起点は steady_clock とそろえてある
+        const int64_t offset = TscClock::now().time_since_epoch().count() - SteadyNs();
+        Test::Expect(std::abs(offset) < 1'000'000, "now() is aligned with steady_clock");
+
+        // 生のカウントで区間を取り、後で変換しても steady_clock と同じ長さになる
+        const uint64_t t0 = TscClock::Ticks();
+        const int64_t s0 = SteadyNs();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const uint64_t t1 = TscClock::TicksOrdered();
+        const int64_t s1 = SteadyNs();
+        const double tsc = static_cast<double>(TscClock::TicksToNanoseconds(t1) - TscClock::TicksToNanoseconds(t0));
+        const double steady = static_cast<double>(s1 - s0);
+        Test::Expect(std::abs(tsc - steady) < steady * 0.02 + 50'000.0, "deferred conversion matches steady_clock");
+        Test::Expect(std::abs(TscClock::TickDeltaToNanoseconds(t1 - t0) - tsc) < 1000.0, "TickDeltaToNanoseconds");
+    }
+
+    void TestTimers()
+    {
+        using namespace Drama;
+
+        Platform::TscTimer tsc;
+        Platform::Timer steady;
+        tsc.Start();
+        steady.Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        tsc.Stop();
+        steady.Stop();
+        Test::Expect(!tsc.IsRunning() && !steady.IsRunning(), "Stop");
+        const double a = tsc.ElapsedMilliseconds();
+        const double b = steady.ElapsedMilliseconds();
+        Test::Expect(a >= 9.0 && std::abs(a - b) < 1.0, "TscTimer agrees with Timer");
+        // 停止後は進まない
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        Test::Expect(tsc.ElapsedMilliseconds() == a && steady.ElapsedMilliseconds() == b, "stopped timer does not advance");
+        // 再開すると累計に足される
+        tsc.Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        Test::Expect(tsc.ElapsedMilliseconds() >= a + 4.0, "restart accumulates");
+        tsc.Reset();
+        Test::Expect(tsc.ElapsedSeconds() == 0.0 && !tsc.IsRunning(), "Reset");
+    }
+}
+
+namespace Drama::Test
+{
+    void RunTscClockTests()
+    {
+        TestCalibration();
+        TestAgainstSteady();
+        TestTimers();
+    }
+}
@@ -1,7 +1,22 @@
 #include <iostream>
 
+#if defined(_WIN32)
 #include "Platform/include/WinFileSystem.h"
+#include "Platform/include/WinFileWatcher.h"
+#else
+#include "Platform/include/PosixFileSystem.h"
+#include "Platform/include/LinuxFileWatcher.h"
+#endif
 #include "Core/include/LogAssert.h"
+#include "TestCommon.h"
+
+#if defined(_WIN32)
+using PlatformFileSystem = Drama::Platform::IO::WinFileSystem;
+using PlatformFileWatcher = Drama::Platform::IO::WinFileWatcher;
+#else
+using PlatformFileSystem = Drama::Platform::IO::PosixFileSystem;
+using PlatformFileWatcher = Drama::Platform::IO::LinuxFileWatcher;
+#endif
 
 class EngineContext
 {
@@ -15,13 +30,45 @@ private:
 
 int main()
 {
-    Drama::Platform::IO::WinFileSystem winFs;
+    PlatformFileSystem platformFs;
 
     EngineContext ctx;
-    ctx.SetFileSystem(winFs);
+    ctx.SetFileSystem(platformFs);
 
     std::string logPath = ctx.Fs().currentPath() + "/temp/log.txt";
 
     Drama::Core::LogAssert::Init(ctx.Fs(), logPath);
     Drama::Core::LogAssert::WriteLine("This is a test log entry.");
+
+    const std::string testRoot = ctx.Fs().currentPath() + "/temp/unittest/";
+    ctx.Fs().CreateDirectories(testRoot);
+
+    Drama::Test::RunFileSystemConformanceTests(ctx.Fs(), testRoot);
+    Drama::Test::RunAsyncFileServiceTests(ctx.Fs(), testRoot);
+    Drama::Test::RunArchiveFileSystemTests(ctx.Fs(), testRoot);
+    Drama::Test::RunCompressionTests(ctx.Fs(), testRoot);
+    PlatformFileWatcher watcher(Drama::Core::IO::FileWatchDesc{ 20 });
+    Drama::Test::RunFileWatcherTests(watcher, ctx.Fs(), testRoot);
+    Drama::Test::RunJobSystemTests();
+    Drama::Test::RunFramePipelineTests();
+    Drama::Test::RunHeadlessWindowTests();
+    Drama::Test::RunFrameClockTests();
+    Drama::Test::RunTscClockTests();
+    Drama::Test::RunProfilerTests();
+    Drama::Test::RunFrameAllocatorTests();
+    Drama::Test::RunHandlePoolTests();
+    Drama::Test::RunMemoryTrackerTests();
+    Drama::Test::RunEcsTests();
+    Drama::Test::RunMathTests();
+    Drama::Test::RunTransformHierarchyTests();
+    Drama::Test::RunFrustumCullingTests();
+    Drama::Test::RunDynamicBvhTests();
+    Drama::Test::RunLogAssertTests(ctx.Fs(), testRoot);
+    Drama::Test::RunBinaryLogTests();
+
+    Drama::Core::LogAssert::Shutdown();
+
+    const int failures = Drama::Test::FailureCount();
+    std::cout << (failures == 0 ? "All tests passed." : "Some tests failed.") << " failures=" << failures << std::endl;
+    return failures == 0 ? 0 : 1;
 }